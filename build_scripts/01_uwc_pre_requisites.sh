@@ -54,6 +54,14 @@ create_docker_volume_dir()
                 echo "${RED}Failed to create docker volume directory${NC}"
                 exit 1;
         fi
+        # outbox of mqtt-bridge is kept across re-installation so that stored messages are not lost
+        mkdir -p /opt/intel/eii/uwc_data/mqtt-bridge/outbox && chown -R 1999:1999 /opt/intel/eii/uwc_data/mqtt-bridge
+        if [ "$?" -eq "0" ]; then
+                echo "${GREEN}/opt/intel/eii/uwc_data/mqtt-bridge/outbox is sucessfully created. ${NC}"
+        else
+                echo "${RED}Failed to create docker volume directory${NC}"
+                exit 1;
+        fi
 
 	echo "${GREEN}Deleting old /opt/intel/eii/container_logs directory.${NC}"
 	rm -rf  /opt/intel/eii/container_logs
@@ -23,6 +23,8 @@
 #include "Common.hpp"
 #include <cjson/cJSON.h>
 #include "CommonDataShare.hpp"
+#include "TimeFormatter.hpp"
+#include "TimestampCarrier.hpp"
 
 /**
  * Get current time in micro seconds
@@ -45,7 +47,7 @@ void commonUtilKPI::getCurrentTimestampsInString(std::string &strCurTime)
 	{
 		struct timespec tsMsgReceived;
 		timespec_get(&tsMsgReceived, TIME_UTC);
-		strCurTime = std::to_string(commonUtilKPI::get_micros(tsMsgReceived));
+		strCurTime = CTimeFormatter::microsToString(tsMsgReceived);
 	}
 	catch(std::exception &e)
 	{
@@ -227,10 +229,13 @@ std::string commonUtilKPI::createAnalysisMsg(struct stPollWrData &a_stPollWrData
 
 	try
 	{
-		cJSON *pRootPollMsg = cJSON_Parse(a_stPollWrData.m_oPollData.getStrMsg().c_str());
+		// timestamps may be sent by mqtt-bridge as user properties
+		std::string sPollMsg{a_stPollWrData.m_oPollData.getStrMsg()};
+		CTimestampCarrier::appendProperties(sPollMsg, a_stPollWrData.m_oPollData.getMqttMsg());
+		cJSON *pRootPollMsg = cJSON_Parse(sPollMsg.c_str());
 		if (NULL == pRootPollMsg)
 		{
-			DO_LOG_ERROR(a_stPollWrData.m_oPollData.getStrMsg() + ": Message could not be parsed in json format");
+			DO_LOG_ERROR(sPollMsg + ": Message could not be parsed in json format");
 			return "";
 		}
 
@@ -253,13 +258,15 @@ std::string commonUtilKPI::createAnalysisMsg(struct stPollWrData &a_stPollWrData
 		cJSON_Delete(pRootPollMsg);
 		pRootPollMsg = NULL;
 		
-		addFieldToMsg(sMsg, "pollDataRcvdInApp", (std::to_string(commonUtilKPI::get_micros(a_stPollWrData.m_oPollData.getTimestamp()))).c_str(), false);
-		addFieldToMsg(sMsg, "wrReqCreation", (std::to_string(commonUtilKPI::get_micros(a_stPollWrData.m_tsStartWrReqCreate))).c_str(), false);
+		addFieldToMsg(sMsg, "pollDataRcvdInApp", CTimeFormatter::microsToString(a_stPollWrData.m_oPollData.getTimestamp()), false);
+		addFieldToMsg(sMsg, "wrReqCreation", CTimeFormatter::microsToString(a_stPollWrData.m_tsStartWrReqCreate), false);
 
-		cJSON *pRootWrRspMsg = cJSON_Parse(a_msgWrResp.getStrMsg().c_str());
+		std::string sWrRspMsg{a_msgWrResp.getStrMsg()};
+		CTimestampCarrier::appendProperties(sWrRspMsg, a_msgWrResp.getMqttMsg());
+		cJSON *pRootWrRspMsg = cJSON_Parse(sWrRspMsg.c_str());
 		if (NULL == pRootWrRspMsg)
 		{
-			DO_LOG_ERROR(a_msgWrResp.getStrMsg() + ": Message could not be parsed in json format");
+			DO_LOG_ERROR(sWrRspMsg + ": Message could not be parsed in json format");
 			return "";
 		}
 		
@@ -284,7 +291,7 @@ std::string commonUtilKPI::createAnalysisMsg(struct stPollWrData &a_stPollWrData
 		pRootWrRspMsg = NULL;
 
 		// Add last timestamp
-		addFieldToMsg(sMsg, "wrRespRcvdInApp", (std::to_string(commonUtilKPI::get_micros(a_msgWrResp.getTimestamp()))).c_str(), true);
+		addFieldToMsg(sMsg, "wrRespRcvdInApp", CTimeFormatter::microsToString(a_msgWrResp.getTimestamp()), true);
 	}
 	catch(const std::exception& e)
 	{
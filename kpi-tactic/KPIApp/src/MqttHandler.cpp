@@ -41,7 +41,7 @@ CMqttHandler::CMqttHandler(const std::string &strPlBusUrl, int iQOS):
 	CMQTTBaseHandler(strPlBusUrl, EnvironmentInfo::getInstance().getDataFromEnvMap("AppName")+SUBSCRIBER_ID, 
 	iQOS, (false == CcommonEnvManager::Instance().getDevMode()),
 	"/run/secrets/rootca/cacert.pem", "/run/secrets/mymqttcerts/mymqttcerts_client_certificate.pem", 
-	"/run/secrets/mymqttcerts/mymqttcerts_client_key.pem", "MQTTSubListener")
+	"/run/secrets/mymqttcerts/mymqttcerts_client_key.pem", "MQTTSubListener", CMQTTPubSubClient::readV5Config())
 {
 	try
 	{
@@ -132,7 +132,8 @@ unsigned char GetFunctionCode(uint8_t u8ReadWrite,
   * POINT_IS_NOT_WRITABLE: code 108
   * INTERNAL_ERORR: code 109
   * INVALID_CTX: code 110
-  * CODE_MAX: code 111
+  * REQUEST_EXPIRED: code 111
+  * CODE_MAX: code 112
  */
 typedef enum MbusAppErrorCode
 {
@@ -148,6 +149,7 @@ typedef enum MbusAppErrorCode
 	APP_ERROR_POINT_IS_NOT_WRITABLE,
 	APP_INTERNAL_ERORR,
 	APP_ERROR_INVALID_CTX,
+	APP_ERROR_REQUEST_EXPIRED,
 	APP_ERROR_CODE_MAX
 }eMbusAppErrorCode;
 
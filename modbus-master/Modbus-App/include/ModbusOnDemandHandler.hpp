@@ -111,6 +111,10 @@ public:
 			bool isRT,
 			bool isWrite);
 
+	bool isRequestExpired(const MbusAPI_t &a_stMbusApiPram);
+
+	void expiredRequestHandler(MbusAPI_t *a_pstMbusApiPram, bool a_IsWriteReq);
+
 	bool compareString(const std::string stBaseString, const std::string strToCompare);
 
 	bool getScaledValueElement(msg_envelope_t *a_Msg,
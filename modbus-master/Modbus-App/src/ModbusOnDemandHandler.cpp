@@ -33,6 +33,8 @@
 #include <stdio.h>
 #include "eii/utils/json_config.h"
 #include "ModbusOnDemandHandler.hpp"
+#include "RequestTTL.hpp"
+#include "TimeFormatter.hpp"
 #include <string>
 #include <fenv.h>
 /// stop thread flag
@@ -126,6 +128,72 @@ void onDemandHandler::createErrorResponse(eMbusAppErrorCode errorCode,
 															isRT);
 }
 
+/**
+* Checks if on-demand request is older than TTL configured for its topic.
+* Age is measured from earlier of application timestamp and time at which
+* mqtt-bridge received request from MQTT, till request is received here;
+* MQTT receive time alone is used if the two differ by more than TTL.
+* @param a_stMbusApiPram	:[in] request data received from ZMQ
+* @return 	true if request has expired, false otherwise
+*/
+bool onDemandHandler::isRequestExpired(const MbusAPI_t &a_stMbusApiPram)
+{
+	const stOnDemandRequest &stReq = a_stMbusApiPram.m_stOnDemandReqData;
+	CRequestTTL &oTTL = CRequestTTL::getInstance();
+	uint64_t ui64AgeUs = 0;
+	uint64_t ui64OriginUs = CRequestTTL::getOriginUs(stReq.m_sUsec,
+			strtoull(stReq.m_strMqttTime.c_str(), NULL, 10), oTTL.getTTLMs(stReq.m_strTopic));
+	if(false == oTTL.isExpired(stReq.m_strTopic, ui64OriginUs,
+			CTimeFormatter::toMicros(stReq.m_obtReqRcvdTS), ui64AgeUs))
+	{
+		return false;
+	}
+
+	uint64_t ui64Count = oTTL.recordExpired(enREQ_TTL_AT_EXECUTION);
+	DO_LOG_WARN_RATELIMITED("Expired on-demand request", 5, 1000, stReq.m_strTopic +
+			" : request expired before execution, app_seq: " + stReq.m_strAppSeq +
+			", age in us: " + std::to_string(ui64AgeUs) +
+			", expired requests: " + std::to_string(ui64Count));
+	return true;
+}
+
+/**
+* Sends error response for an expired on-demand request without sending it to device.
+* @param a_pstMbusApiPram	:[in] request data received from ZMQ
+* @param a_IsWriteReq		:[in] flag used to distinguish read/write request
+* @return 	None
+*/
+void onDemandHandler::expiredRequestHandler(MbusAPI_t *a_pstMbusApiPram, bool a_IsWriteReq)
+{
+	if(NULL == a_pstMbusApiPram)
+	{
+		DO_LOG_ERROR("NULL pointer received..discarding the request");
+		return;
+	}
+
+	try
+	{
+		/// Transaction ID
+		a_pstMbusApiPram->m_u16TxId = PublishJsonHandler::instance().getTxId();
+
+		/// request data is needed in map to create response JSON
+		if(false == common_Handler::insertReqData(a_pstMbusApiPram->m_u16TxId, *a_pstMbusApiPram))
+		{
+			DO_LOG_ERROR("Failed to add MbusAPI_t data to map.");
+		}
+
+		createErrorResponse(APP_ERROR_REQUEST_EXPIRED,
+				MBUS_MIN_FUN_CODE,
+				a_pstMbusApiPram->m_u16TxId,
+				a_pstMbusApiPram->m_stOnDemandReqData.m_isRT,
+				a_IsWriteReq);
+	}
+	catch(const std::exception &e)
+	{
+		DO_LOG_FATAL(e.what());
+	}
+}
+
 /**
 * Handler function to start the processing of on-demand requests.
 * @param a_pstMbusApiPram	:[in] Structure to read data received from ZMQ
@@ -1250,8 +1318,16 @@ bool onDemandHandler::processMsg(msg_envelope_t *msg,
 	// fill retry and priority used for further processing
 	stMbusApiPram.m_nRetry = a_iRetry;
 	stMbusApiPram.m_lPriority = a_lPriority;
-	
-	onDemandInfoHandler(&stMbusApiPram, stTopic, vpCallback, a_bIsWriteReq);
+
+	// request which waited longer than its TTL is answered with error instead of using bus time
+	if(true == isRequestExpired(stMbusApiPram))
+	{
+		expiredRequestHandler(&stMbusApiPram, a_bIsWriteReq);
+	}
+	else
+	{
+		onDemandInfoHandler(&stMbusApiPram, stTopic, vpCallback, a_bIsWriteReq);
+	}
 
 	if(msg != NULL)
 	{
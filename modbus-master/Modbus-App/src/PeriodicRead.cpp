@@ -35,6 +35,7 @@
 #include <unistd.h>
 #include <time.h>
 #include "CommonDataShare.hpp"
+#include "TimeFormatter.hpp"
 #include <stdlib.h>
 #include <fenv.h>
 /// flag to check thread stop condition
@@ -73,21 +74,13 @@ void getTimeBasedParams(const CRefDataForPolling& a_objReqData, std::string &a_s
 		unsigned long long int u64{
 			(unsigned long long int)(std::chrono::duration_cast<std::chrono::milliseconds>(p1.time_since_epoch()).count())
 		};
-		std::stringstream ss;
-		ss << (unsigned long long)(((unsigned long long)(a_objReqData.getDataPoint().getMyRollID()) << 48) | u64);
-		a_sTxID.insert(0, ss.str());
+		char acTxID[TIME_FMT_BUFFER_SIZE];
+		size_t uiLen = CTimeFormatter::formatUint(
+				(((unsigned long long)(a_objReqData.getDataPoint().getMyRollID()) << 48) | u64), acTxID);
+		a_sTxID.assign(acTxID, uiLen);
 	}
 }
 
-/**
- * Gets timestmp in micro-seconds from given timepsec structure
- * @param ts	:[in] time to convert to nano-seconds
- * @return	time in micro-seconds
- */
-static unsigned long get_micros(struct timespec ts) {
-	return (unsigned long)ts.tv_sec * 1000000L + ts.tv_nsec/1000;
-}
-
 /**
  * Prepare response json using EII APIs
  * @param a_pMsg		:[out] pointer to message envelope to fill up
@@ -110,6 +103,7 @@ bool CPeriodicReponseProcessor::prepareResponseJson(std::string &a_rtOrNrt, std:
 	bool bIsByteSwap = false;
 	bool bIsWordSwap = false;
 	msg_envelope_t *msg = NULL;
+	char acTsBuf[TIME_FMT_BUFFER_SIZE];
 	std::string aDataType;
 	double aScaleFactor;
 	int aWidth;
@@ -141,13 +135,13 @@ bool CPeriodicReponseProcessor::prepareResponseJson(std::string &a_rtOrNrt, std:
 			// Polling time is explicitly given, use that
 			if(NULL != a_pstTsPolling)
 			{
-				msg_envelope_elem_body_t* ptPollingTS = msgbus_msg_envelope_new_string( (std::to_string(get_micros(*a_pstTsPolling))).c_str() );
+				msg_envelope_elem_body_t* ptPollingTS = msgbus_msg_envelope_new_string( CTimeFormatter::microsToStr(*a_pstTsPolling, acTsBuf) );
 				msgbus_msg_envelope_put(msg, "tsPollingTime", ptPollingTS);
 			}
 			else
 			{
 				// Polling time is not given, use one from reference polling point
-				msg_envelope_elem_body_t* ptPollingTS = msgbus_msg_envelope_new_string( (std::to_string(get_micros(a_objReqData->getTimestampOfPollReq()))).c_str() );
+				msg_envelope_elem_body_t* ptPollingTS = msgbus_msg_envelope_new_string( CTimeFormatter::microsToStr(a_objReqData->getTimestampOfPollReq(), acTsBuf) );
 				msgbus_msg_envelope_put(msg, "tsPollingTime", ptPollingTS);
 			}
 
@@ -205,7 +199,7 @@ bool CPeriodicReponseProcessor::prepareResponseJson(std::string &a_rtOrNrt, std:
 			ptRealTime =  msgbus_msg_envelope_new_string(std::to_string(stMbusApiPram.m_stOnDemandReqData.m_isRT).c_str());
 			rtOrNrt = std::to_string(stMbusApiPram.m_stOnDemandReqData.m_isRT);
 			/// add timestamps for req recvd by app
-			msg_envelope_elem_body_t* ptAppTSReqRcvd = msgbus_msg_envelope_new_string( (std::to_string(get_micros(stMbusApiPram.m_stOnDemandReqData.m_obtReqRcvdTS))).c_str() );
+			msg_envelope_elem_body_t* ptAppTSReqRcvd = msgbus_msg_envelope_new_string( CTimeFormatter::microsToStr(stMbusApiPram.m_stOnDemandReqData.m_obtReqRcvdTS, acTsBuf) );
 			/// message received from MQTT Time
 			msg_envelope_elem_body_t* ptMqttTime = msgbus_msg_envelope_new_string(stMbusApiPram.m_stOnDemandReqData.m_strMqttTime.c_str());
 			/// message received from MQTT Time
@@ -247,10 +241,10 @@ bool CPeriodicReponseProcessor::prepareResponseJson(std::string &a_rtOrNrt, std:
 		msg_envelope_elem_body_t* ptVersion = msgbus_msg_envelope_new_string("2.0");
 
 		// add timestamps from stack
-		msg_envelope_elem_body_t* ptStackTSReqRcvd = msgbus_msg_envelope_new_string( (std::to_string(get_micros(a_stResp.m_objStackTimestamps.tsReqRcvd))).c_str() );
-		msg_envelope_elem_body_t* ptStackTSReqSent = msgbus_msg_envelope_new_string( (std::to_string(get_micros(a_stResp.m_objStackTimestamps.tsReqSent))).c_str() );
-		msg_envelope_elem_body_t* ptStackTSRespRcvd = msgbus_msg_envelope_new_string( (std::to_string(get_micros(a_stResp.m_objStackTimestamps.tsRespRcvd))).c_str() );
-		msg_envelope_elem_body_t* ptStackTSRespPosted = msgbus_msg_envelope_new_string( (std::to_string(get_micros(a_stResp.m_objStackTimestamps.tsRespSent))).c_str() );
+		msg_envelope_elem_body_t* ptStackTSReqRcvd = msgbus_msg_envelope_new_string( CTimeFormatter::microsToStr(a_stResp.m_objStackTimestamps.tsReqRcvd, acTsBuf) );
+		msg_envelope_elem_body_t* ptStackTSReqSent = msgbus_msg_envelope_new_string( CTimeFormatter::microsToStr(a_stResp.m_objStackTimestamps.tsReqSent, acTsBuf) );
+		msg_envelope_elem_body_t* ptStackTSRespRcvd = msgbus_msg_envelope_new_string( CTimeFormatter::microsToStr(a_stResp.m_objStackTimestamps.tsRespRcvd, acTsBuf) );
+		msg_envelope_elem_body_t* ptStackTSRespPosted = msgbus_msg_envelope_new_string( CTimeFormatter::microsToStr(a_stResp.m_objStackTimestamps.tsRespSent, acTsBuf) );
 
 		msgbus_msg_envelope_put(msg, "version", ptVersion);
 		msgbus_msg_envelope_put(msg, "data_topic", ptTopic);
@@ -1646,13 +1640,14 @@ void CRequestInitiator::initiateRequest(struct timespec &a_stPollTimestamp, std:
 			m_stException.m_u8ExcCode = APP_ERROR_DUMMY_RESPONSE;
 			m_stException.m_u8ExcStatus = 0;
 			uint16_t lastTxID = objReqData.getReqTxID();
-			DO_LOG_INFO("Post dummy response as response not received for - Point: " + objReqData.getDataPoint().getID()
+			DO_LOG_INFO_RATELIMITED("Post dummy response", 10, 1000,
+						"Post dummy response as response not received for - Point: " + objReqData.getDataPoint().getID()
 						+ ", LastTxID: " + std::to_string(lastTxID));
 			CPeriodicReponseProcessor::Instance().postDummyBADResponse(objReqData, m_stException, &a_stPollTimestamp);
 
 			if(false == CRequestInitiator::instance().isTxIDPresent(lastTxID, isRTRequest))
 			{
-				DO_LOG_INFO("TxID is not present in map.Resetting the response status");
+				DO_LOG_INFO_RATELIMITED("TxID not present", 10, 1000, "TxID is not present in map.Resetting the response status");
 				objReqData.getDataPoint().setIsAwaitResp(false);
 			}
 			continue;
@@ -1688,7 +1683,8 @@ void CRequestInitiator::initiateRequest(struct timespec &a_stPollTimestamp, std:
 				CRequestInitiator::instance().removeTxIDReqData(m_u16TxId, isRTRequest);
 				// reset txid
 				objReqData.setReqTxID(0);
-				DO_LOG_ERROR("sendRequest failed");
+				DO_LOG_ERROR_RATELIMITED("sendRequest failed", 10, 1000, "sendRequest failed for - Point: " +
+						objReqData.getDataPoint().getID());
 			}
 		}
 	}
@@ -20,21 +20,36 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../Test/src/BridgeBenchmark_ut.cpp \
 ../Test/src/Common_ut.cpp \
+../Test/src/EIIListenerPool_ut.cpp \
+../Test/src/EMBWorkerPool_ut.cpp \
+../Test/src/JsonEnvelopeTranscoder_ut.cpp \
 ../Test/src/MQTTPublishHandler_ut.cpp \
 ../Test/src/MQTTSubscribeHandler_ut.cpp \
+../Test/src/RequestScheduler_ut.cpp \
 ../Test/src/Main_ut.cpp 
 
 OBJS += \
+./Test/src/BridgeBenchmark_ut.o \
 ./Test/src/Common_ut.o \
+./Test/src/EIIListenerPool_ut.o \
+./Test/src/EMBWorkerPool_ut.o \
+./Test/src/JsonEnvelopeTranscoder_ut.o \
 ./Test/src/MQTTPublishHandler_ut.o \
 ./Test/src/MQTTSubscribeHandler_ut.o \
+./Test/src/RequestScheduler_ut.o \
 ./Test/src/Main_ut.o 
 
 CPP_DEPS += \
+./Test/src/BridgeBenchmark_ut.d \
 ./Test/src/Common_ut.d \
+./Test/src/EIIListenerPool_ut.d \
+./Test/src/EMBWorkerPool_ut.d \
+./Test/src/JsonEnvelopeTranscoder_ut.d \
 ./Test/src/MQTTPublishHandler_ut.d \
 ./Test/src/MQTTSubscribeHandler_ut.d \
+./Test/src/RequestScheduler_ut.d \
 ./Test/src/Main_ut.d 
 
 
@@ -24,4 +24,4 @@ env
 ./MQTT_Bridge_test > /reports/mqtt-bridge/mqtt-bridge_test_status.log 2>&1
 
 # Run GCovr command
-gcovr --html -f "../src/Common.cpp" -f "../src/Main.cpp" -f "../src/MQTTPublishHandler.cpp" -f "../src/MQTTSubscribeHandler.cpp" -f "../src/QueueMgr.cpp" -f "../include/Common.hpp" -f "../include/MQTTPublishHandler.hpp" -f "../include/MQTTSubscribeHandler.hpp" -f "../include/QueueMgr.hpp" --exclude-throw-branches -o /reports/mqtt-bridge/MQTT-Bridge_Report.html -r .. .
+gcovr --html -f "../src/Common.cpp" -f "../src/Main.cpp" -f "../src/MQTTPublishHandler.cpp" -f "../src/MQTTSubscribeHandler.cpp" -f "../src/RequestScheduler.cpp" -f "../include/Common.hpp" -f "../include/MQTTPublishHandler.hpp" -f "../include/MQTTSubscribeHandler.hpp" -f "../include/RequestScheduler.hpp" --exclude-throw-branches -o /reports/mqtt-bridge/MQTT-Bridge_Report.html -r .. .
@@ -21,24 +21,33 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../src/Common.cpp \
+../src/EIIListenerPool.cpp \
+../src/EMBWorkerPool.cpp \
+../src/JsonEnvelopeTranscoder.cpp \
 ../src/MQTTPublishHandler.cpp \
 ../src/MQTTSubscribeHandler.cpp \
 ../src/Main.cpp \
-../src/QueueMgr.cpp 
+../src/RequestScheduler.cpp 
 
 OBJS += \
 ./src/Common.o \
+./src/EIIListenerPool.o \
+./src/EMBWorkerPool.o \
+./src/JsonEnvelopeTranscoder.o \
 ./src/MQTTPublishHandler.o \
 ./src/MQTTSubscribeHandler.o \
 ./src/Main.o \
-./src/QueueMgr.o 
+./src/RequestScheduler.o 
 
 CPP_DEPS += \
 ./src/Common.d \
+./src/EIIListenerPool.d \
+./src/EMBWorkerPool.d \
+./src/JsonEnvelopeTranscoder.d \
 ./src/MQTTPublishHandler.d \
 ./src/MQTTSubscribeHandler.d \
 ./src/Main.d \
-./src/QueueMgr.d 
+./src/RequestScheduler.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
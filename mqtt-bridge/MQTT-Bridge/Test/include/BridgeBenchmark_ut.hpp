@@ -0,0 +1,128 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#ifndef BRIDGEBENCHMARK_UT_HPP_
+#define BRIDGEBENCHMARK_UT_HPP_
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ZmqHandler.hpp"
+#include "MQTTSubscribeHandler.hpp"
+#include "EMBWorkerPool.hpp"
+#include "EIIListenerPool.hpp"
+
+extern void postMsgsToEII(CEMBWorker &a_worker);
+extern bool processMsg(msg_envelope_t *msg, CMQTTPublishHandler &mqttPublisher);
+extern void getOperation(std::string topic, globalConfig::COperation& operation);
+extern std::string mapMqttToEMBTopic(std::string mqttTopic, bool isRealTime);
+extern std::atomic<bool> g_shouldStop;
+
+/** Kinds of traffic replayed by benchmark */
+enum eBenchTraffic
+{
+	BENCH_RT_READ = 0,
+	BENCH_RT_WRITE,
+	BENCH_NRT_READ,
+	BENCH_NRT_WRITE,
+	BENCH_RT_POLL,
+	BENCH_NRT_POLL,
+	BENCH_TRAFFIC_MAX
+};
+
+/** Benchmark configuration, read from environment variables BENCH_* */
+struct stBenchConfig
+{
+	uint32_t m_uiMsgCount = 10000; /** number of messages sent*/
+	uint32_t m_uiRate = 0; /** offered load in msgs/s for all kinds, 0 means as fast as possible*/
+	uint32_t m_uiDevices = 16; /** number of devices messages are spread on*/
+	uint32_t m_uiTimeoutSec = 30; /** max time to wait for messages after last one is sent*/
+	uint32_t m_auiWeights[BENCH_TRAFFIC_MAX] = {1, 1, 1, 1, 2, 2}; /** share of each traffic kind*/
+	bool m_bInjectViaBroker = false; /** requests are published on MQTT broker instead of given to MQTT callback*/
+	std::string m_sSocketDir = "/tmp/mqtt_bridge_bench"; /** directory of IPC sockets of in-process EMB*/
+	std::string m_sReportFile; /** JSON report is written to this file, empty means standard output*/
+};
+
+/**
+ * Records latency of messages received in one direction
+ */
+class CLatencyRecorder
+{
+	std::mutex m_mutex; /** protects latencies*/
+	std::vector<uint64_t> m_vLatencyUs; /** latency of each received message*/
+	std::atomic<uint64_t> m_ui64Sent; /** number of messages sent*/
+	std::atomic<uint64_t> m_ui64Received; /** number of messages received*/
+	std::atomic<uint64_t> m_ui64FirstSentUs; /** time first message was sent*/
+	std::atomic<uint64_t> m_ui64LastRcvdUs; /** time last message was received*/
+
+public:
+	CLatencyRecorder() : m_ui64Sent{0}, m_ui64Received{0}, m_ui64FirstSentUs{0}, m_ui64LastRcvdUs{0} {}
+
+	void onSent(uint64_t a_ui64NowUs);
+	void onReceived(const std::string &a_sUsec, uint64_t a_ui64NowUs);
+
+	uint64_t getSent() const
+	{
+		return m_ui64Sent.load();
+	}
+
+	uint64_t getReceived() const
+	{
+		return m_ui64Received.load();
+	}
+
+	std::string toJson();
+};
+
+class BridgeBenchmark_ut : public ::testing::Test {
+
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+public:
+	stBenchConfig m_stConfig;
+	void *m_pMsgbusCtx = NULL; /** in-process EMB context*/
+	config_t *m_pMsgbusCfg = NULL; /** configuration of in-process EMB*/
+	std::vector<recv_ctx_t*> m_vRequestSubs; /** subscribers of requests sent on EMB by bridge*/
+	std::vector<publisher_ctx_t*> m_vPollPubs; /** publishers of polled data, indexed by RT*/
+	std::vector<recv_ctx_t*> m_vPollSubs; /** subscribers of polled data given to listener pool*/
+	CLatencyRecorder m_oMqttToEii; /** requests from MQTT to EII*/
+	CLatencyRecorder m_oEiiToMqtt; /** polled data from EII to MQTT*/
+
+	static bool isEnabled();
+	static stBenchConfig readConfig();
+	static std::string getEMBTopicName(eBenchTraffic a_eTraffic);
+	static std::string getMqttTopic(eBenchTraffic a_eTraffic, uint32_t a_uiDevice);
+	static std::vector<eBenchTraffic> createSchedule(const stBenchConfig &a_stConfig);
+
+	bool initMsgbus(const std::vector<std::string> &a_vTopics);
+	std::string createRequest(eBenchTraffic a_eTraffic, uint32_t a_uiSeq);
+	msg_envelope_t* createPolledData(eBenchTraffic a_eTraffic, uint32_t a_uiDevice, uint32_t a_uiSeq);
+	void receiveRequests(const std::atomic<bool> &a_bStop);
+	std::string createReport(double a_dElapsedSec);
+};
+
+#endif /* BRIDGEBENCHMARK_UT_HPP_ */
@@ -0,0 +1,92 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#ifndef EIILISTENERPOOL_UT_HPP_
+#define EIILISTENERPOOL_UT_HPP_
+
+#include <gtest/gtest.h>
+#include <map>
+#include "EIIListenerPool.hpp"
+
+/** Number of fake EII topics used by tests */
+#define UT_POOL_TOPICS 6
+
+class EIIListenerPool_ut : public ::testing::Test {
+
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+public:
+	globalConfig::COperation m_objOperation;
+	std::atomic<bool> m_bStop{false};
+
+	/** fake EII topics; a topic gives m_iMsgsPerTopic messages carrying topic index and sequence number*/
+	recv_ctx_t m_aSubCtx[UT_POOL_TOPICS];
+	int m_aSent[UT_POOL_TOPICS];
+	int m_iMsgsPerTopic = 0;
+
+	/** messages handled per topic, in handling order*/
+	std::mutex m_mutexHandled;
+	std::map<int64_t, std::vector<int64_t>> m_mapHandled;
+	std::atomic<int> m_iHandled{0};
+
+	msgbus_ret_t fakeRecv(recv_ctx_t *a_pSubCtx, msg_envelope_t **a_ppMsg);
+	bool recordMsg(msg_envelope_t *a_pMsg);
+	void addTopics(CEIIListenerPool &a_oPool);
+
+	/** functions to reach internals of pool*/
+	void _setRecv(CEIIListenerPool &a_oPool)
+	{
+		a_oPool.m_fcbRecv = [this](void *a_pMsgbusCtx, recv_ctx_t *a_pSubCtx, msg_envelope_t **a_ppMsg)
+		{
+			return fakeRecv(a_pSubCtx, a_ppMsg);
+		};
+	}
+	void _startWorkers(CEIIListenerPool &a_oPool)
+	{
+		a_oPool.startWorkers();
+	}
+	void _stopWorkers(CEIIListenerPool &a_oPool)
+	{
+		a_oPool.stopWorkers();
+	}
+	bool _pollOnce(CEIIListenerPool &a_oPool)
+	{
+		return a_oPool.pollOnce();
+	}
+	size_t _getWorkerOfTopic(CEIIListenerPool &a_oPool, size_t a_uiTopic)
+	{
+		return a_oPool.m_vTopics.at(a_uiTopic).m_uiWorker;
+	}
+	size_t _getWorkerCount(CEIIListenerPool &a_oPool)
+	{
+		return a_oPool.m_vWorkers.size();
+	}
+	size_t _getQueuedCount(CEIIListenerPool &a_oPool, size_t a_uiWorker)
+	{
+		std::lock_guard<std::mutex> lck(a_oPool.m_vWorkers.at(a_uiWorker)->m_mutexQ);
+		return a_oPool.m_vWorkers.at(a_uiWorker)->m_dqMsgs.size();
+	}
+};
+
+#endif /* EIILISTENERPOOL_UT_HPP_ */
@@ -0,0 +1,60 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#ifndef JSONENVELOPETRANSCODER_UT_HPP_
+#define JSONENVELOPETRANSCODER_UT_HPP_
+
+#include <gtest/gtest.h>
+#include "JsonEnvelopeTranscoder.hpp"
+
+/** Records events reported by tokenizer as text */
+class CSaxRecorder : public CJsonSaxHandler
+{
+public:
+	std::string m_sEvents;
+
+	bool onStartObject() override { m_sEvents += "{"; return true; }
+	bool onEndObject() override { m_sEvents += "}"; return true; }
+	bool onStartArray() override { m_sEvents += "["; return true; }
+	bool onEndArray() override { m_sEvents += "]"; return true; }
+	bool onKey(const char *a_pcKey, size_t a_uiLen) override { m_sEvents += "k:" + std::string(a_pcKey, a_uiLen) + " "; return true; }
+	bool onString(const char *a_pcValue, size_t a_uiLen) override { m_sEvents += "s:" + std::string(a_pcValue, a_uiLen) + " "; return true; }
+	bool onInteger(int64_t a_i64Value) override { m_sEvents += "i:" + std::to_string(a_i64Value) + " "; return true; }
+	bool onDouble(double a_dValue) override { m_sEvents += "d "; return true; }
+	bool onBool(bool a_bValue) override { m_sEvents += a_bValue ? "true " : "false "; return true; }
+	bool onNull() override { m_sEvents += "null "; return true; }
+};
+
+class JsonEnvelopeTranscoder_ut : public ::testing::Test {
+
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+public:
+	/** Write request payload as sent by MQTT clients */
+	std::string m_sWriteReq = "{\"wellhead\": \"PL0\",\"command\": \"D1\",\"value\": \"0x00\",\"timestamp\": \"2019-09-20 12:34:56\","
+			"\"usec\": \"1571887474111145\",\"version\": \"2.0\",\"app_seq\": \"1234\",\"realtime\":\"1\",\"scale\": 10,\"offset\": 1.5}";
+	std::vector<std::pair<std::string, std::string>> m_vExtra{{"tsMsgRcvdFromMQTT", "1571887474111200"}, {"sourcetopic", "/flowmeter/PL0/D1/write"}};
+};
+
+#endif /* JSONENVELOPETRANSCODER_UT_HPP_ */
@@ -25,6 +25,7 @@
 
 #include <gtest/gtest.h>
 #include "MQTTSubscribeHandler.hpp"
+#include "EMBWorkerPool.hpp"
 
 class MQTTSubscribeHandler_ut : public ::testing::Test {
 
@@ -46,7 +46,7 @@
 #include "ZmqHandler.hpp"
 #include "EnvironmentVarHandler.hpp"
 
-#include "QueueMgr.hpp"
+#include "EMBWorkerPool.hpp"
 
 
 std::string parse_msg(const char *json);
@@ -54,9 +54,9 @@ extern bool initEIIContext();
 extern void postMsgstoMQTT();
 extern void signalHandler(int signal);
 extern bool addSrTopic(std::string &json, std::string& topic);
-extern void postMsgsToEII(QMgr::CQueueMgr& qMgr);
+extern void postMsgsToEII(CEMBWorker &a_worker);
 extern bool processMsg(msg_envelope_t *msg, CMQTTPublishHandler &mqttPublisher);
-extern void processMsgToSendOnEII(CMessageObject &recvdMsg, const bool isRealtime);
+extern void processMsgToSendOnEII(CMessageObject &recvdMsg, const bool isRealtime, CEMBWorker &a_worker);
 extern void getOperation(std::string topic, globalConfig::COperation& operation);
 
 extern std::vector<std::thread> g_vThreads;;
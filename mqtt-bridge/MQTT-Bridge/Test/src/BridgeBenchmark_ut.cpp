@@ -0,0 +1,678 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/BridgeBenchmark_ut.hpp"
+#include "JsonEnvelopeTranscoder.hpp"
+#include "TimeFormatter.hpp"
+#include "EnvironmentVarHandler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+/** Names of traffic kinds, used in BENCH_MIX and in report */
+static const char *g_pcTrafficNames[BENCH_TRAFFIC_MAX] =
+	{"rt_read", "rt_write", "nrt_read", "nrt_write", "rt_poll", "nrt_poll"};
+
+/** Time in seconds to wait for MQTT connections and ZMQ subscriptions to be ready */
+#define BENCH_SETUP_WAIT_SEC 10
+
+void BridgeBenchmark_ut::SetUp()
+{
+	// Setup code
+}
+
+void BridgeBenchmark_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**
+ * Records that a message is sent
+ * @param a_ui64NowUs :[in] current time in micro seconds
+ * @return None
+ */
+void CLatencyRecorder::onSent(uint64_t a_ui64NowUs)
+{
+	uint64_t ui64Zero = 0;
+	m_ui64FirstSentUs.compare_exchange_strong(ui64Zero, a_ui64NowUs);
+	m_ui64Sent.fetch_add(1);
+}
+
+/**
+ * Records latency of a received message
+ * @param a_sUsec :[in] time at which message was sent, as set in "usec" of message
+ * @param a_ui64NowUs :[in] current time in micro seconds
+ * @return None
+ */
+void CLatencyRecorder::onReceived(const std::string &a_sUsec, uint64_t a_ui64NowUs)
+{
+	uint64_t ui64SentUs = strtoull(a_sUsec.c_str(), NULL, 10);
+	if(0 == ui64SentUs)
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_vLatencyUs.push_back((a_ui64NowUs > ui64SentUs) ? (a_ui64NowUs - ui64SentUs) : 0);
+	}
+	m_ui64LastRcvdUs.store(a_ui64NowUs);
+	m_ui64Received.fetch_add(1);
+}
+
+/**
+ * Creates JSON object with throughput and latency percentiles of recorded messages
+ * @return JSON object
+ */
+std::string CLatencyRecorder::toJson()
+{
+	std::vector<uint64_t> vLatencyUs;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		vLatencyUs = m_vLatencyUs;
+	}
+	std::sort(vLatencyUs.begin(), vLatencyUs.end());
+	auto percentile = [&vLatencyUs](double a_dQuantile) -> uint64_t
+	{
+		if(vLatencyUs.empty())
+		{
+			return 0;
+		}
+		size_t uiIndex = std::min(vLatencyUs.size() - 1, (size_t)(a_dQuantile * vLatencyUs.size()));
+		return vLatencyUs[uiIndex];
+	};
+
+	double dRate = 0;
+	uint64_t ui64FirstUs = m_ui64FirstSentUs.load();
+	uint64_t ui64LastUs = m_ui64LastRcvdUs.load();
+	if(ui64LastUs > ui64FirstUs)
+	{
+		dRate = (double)getReceived() * 1000000 / (ui64LastUs - ui64FirstUs);
+	}
+
+	std::ostringstream oss;
+	oss << "{\"sent\":" << getSent()
+		<< ",\"received\":" << getReceived()
+		<< ",\"msgs_per_sec\":" << (uint64_t)dRate
+		<< ",\"latency_us\":{\"p50\":" << percentile(0.5)
+		<< ",\"p99\":" << percentile(0.99)
+		<< ",\"p999\":" << percentile(0.999)
+		<< ",\"max\":" << (vLatencyUs.empty() ? 0 : vLatencyUs.back()) << "}}";
+	return oss.str();
+}
+
+/**
+ * Benchmark runs only when MQTT_BRIDGE_BENCHMARK is "true", as it needs some seconds
+ * @return true if benchmark is to be run
+ */
+bool BridgeBenchmark_ut::isEnabled()
+{
+	const char *pcEnabled = std::getenv("MQTT_BRIDGE_BENCHMARK");
+	return (NULL != pcEnabled) && (std::string(pcEnabled) == "true");
+}
+
+/**
+ * Reads benchmark configuration from environment variables
+ * BENCH_MSG_COUNT, BENCH_RATE, BENCH_DEVICES, BENCH_TIMEOUT_SEC, BENCH_MQTT_INJECT ("direct"/"broker"),
+ * BENCH_SOCKET_DIR, BENCH_REPORT_FILE and BENCH_MIX (e.g. "rt_read=1,nrt_write=2,rt_poll=4")
+ * @return configuration
+ */
+stBenchConfig BridgeBenchmark_ut::readConfig()
+{
+	stBenchConfig stConfig;
+	auto readUint = [](const char *a_pcName, uint32_t &a_uiValue)
+	{
+		const char *pcValue = std::getenv(a_pcName);
+		if((NULL != pcValue) && ('\0' != *pcValue))
+		{
+			a_uiValue = (uint32_t)strtoul(pcValue, NULL, 10);
+		}
+	};
+	readUint("BENCH_MSG_COUNT", stConfig.m_uiMsgCount);
+	readUint("BENCH_RATE", stConfig.m_uiRate);
+	readUint("BENCH_DEVICES", stConfig.m_uiDevices);
+	readUint("BENCH_TIMEOUT_SEC", stConfig.m_uiTimeoutSec);
+	stConfig.m_uiDevices = std::max(stConfig.m_uiDevices, (uint32_t)1);
+
+	const char *pcValue = std::getenv("BENCH_MQTT_INJECT");
+	stConfig.m_bInjectViaBroker = (NULL != pcValue) && (std::string(pcValue) == "broker");
+	pcValue = std::getenv("BENCH_SOCKET_DIR");
+	if((NULL != pcValue) && ('\0' != *pcValue))
+	{
+		stConfig.m_sSocketDir = pcValue;
+	}
+	pcValue = std::getenv("BENCH_REPORT_FILE");
+	if(NULL != pcValue)
+	{
+		stConfig.m_sReportFile = pcValue;
+	}
+
+	// kinds not listed in mix are not sent
+	pcValue = std::getenv("BENCH_MIX");
+	if((NULL != pcValue) && ('\0' != *pcValue))
+	{
+		std::fill(std::begin(stConfig.m_auiWeights), std::end(stConfig.m_auiWeights), 0);
+		std::stringstream ss(pcValue);
+		std::string sEntry;
+		while(std::getline(ss, sEntry, ','))
+		{
+			size_t uiPos = sEntry.find('=');
+			std::string sName = sEntry.substr(0, uiPos);
+			sName.erase(std::remove(sName.begin(), sName.end(), ' '), sName.end());
+			for(int i = 0; i < BENCH_TRAFFIC_MAX; ++i)
+			{
+				if(sName == g_pcTrafficNames[i])
+				{
+					stConfig.m_auiWeights[i] = (std::string::npos == uiPos) ? 1 :
+							(uint32_t)strtoul(sEntry.c_str() + uiPos + 1, NULL, 10);
+				}
+			}
+		}
+	}
+	return stConfig;
+}
+
+/**
+ * Gets EII topic on which polled data of given kind is published
+ * @param a_eTraffic :[in] BENCH_RT_POLL or BENCH_NRT_POLL
+ * @return EII topic
+ */
+std::string BridgeBenchmark_ut::getEMBTopicName(eBenchTraffic a_eTraffic)
+{
+	return (BENCH_RT_POLL == a_eTraffic) ? "BENCH/RT/update" : "BENCH/NRT/update";
+}
+
+/**
+ * Gets MQTT topic of a message of given kind for given device
+ * @param a_eTraffic :[in] kind of traffic
+ * @param a_uiDevice :[in] device index
+ * @return MQTT topic e.g. /benchflow/PL0/D3/read
+ */
+std::string BridgeBenchmark_ut::getMqttTopic(eBenchTraffic a_eTraffic, uint32_t a_uiDevice)
+{
+	std::string sTopic = "/benchflow/PL0/D" + std::to_string(a_uiDevice);
+	switch(a_eTraffic)
+	{
+		case BENCH_RT_READ:
+		case BENCH_NRT_READ:
+			return sTopic + "/read";
+		case BENCH_RT_WRITE:
+		case BENCH_NRT_WRITE:
+			return sTopic + "/write";
+		default:
+			return sTopic + "/update";
+	}
+}
+
+/**
+ * Creates order in which kinds of traffic are sent. Kinds are interleaved as per their
+ * weights using smooth weighted round robin, so mix is same in every part of run.
+ * @param a_stConfig :[in] benchmark configuration
+ * @return kind of each message to be sent
+ */
+std::vector<eBenchTraffic> BridgeBenchmark_ut::createSchedule(const stBenchConfig &a_stConfig)
+{
+	std::vector<eBenchTraffic> vSchedule;
+	int64_t i64Total = 0;
+	for(int i = 0; i < BENCH_TRAFFIC_MAX; ++i)
+	{
+		i64Total += a_stConfig.m_auiWeights[i];
+	}
+	if(0 == i64Total)
+	{
+		return vSchedule;
+	}
+
+	int64_t ai64Current[BENCH_TRAFFIC_MAX] = {0};
+	vSchedule.reserve(a_stConfig.m_uiMsgCount);
+	for(uint32_t uiMsg = 0; uiMsg < a_stConfig.m_uiMsgCount; ++uiMsg)
+	{
+		int iBest = 0;
+		for(int i = 0; i < BENCH_TRAFFIC_MAX; ++i)
+		{
+			ai64Current[i] += a_stConfig.m_auiWeights[i];
+			if(ai64Current[i] > ai64Current[iBest])
+			{
+				iBest = i;
+			}
+		}
+		ai64Current[iBest] -= i64Total;
+		vSchedule.push_back((eBenchTraffic)iBest);
+	}
+	return vSchedule;
+}
+
+/**
+ * Creates in-process EMB using ZMQ IPC. Each topic gets its own socket file in BENCH_SOCKET_DIR.
+ * @param a_vTopics :[in] all topics published on EMB during benchmark
+ * @return true/false based on success/failure
+ */
+bool BridgeBenchmark_ut::initMsgbus(const std::vector<std::string> &a_vTopics)
+{
+	if((0 != mkdir(m_stConfig.m_sSocketDir.c_str(), 0700)) && (EEXIST != errno))
+	{
+		std::cout << "Could not create socket directory " << m_stConfig.m_sSocketDir << std::endl;
+		return false;
+	}
+
+	std::string sConfig = "{\"type\":\"zmq_ipc\",\"socket_dir\":";
+	CJsonEnvelopeTranscoder::appendJsonString(sConfig, m_stConfig.m_sSocketDir);
+	for(const auto &sTopic : a_vTopics)
+	{
+		std::string sFile = "bench_" + sTopic;
+		std::replace(sFile.begin(), sFile.end(), '/', '_');
+		sConfig += ',';
+		CJsonEnvelopeTranscoder::appendJsonString(sConfig, sTopic);
+		sConfig += ":{\"socket_file\":";
+		CJsonEnvelopeTranscoder::appendJsonString(sConfig, sFile);
+		sConfig += '}';
+	}
+	sConfig += '}';
+
+	m_pMsgbusCfg = json_config_new_from_buffer(sConfig.c_str());
+	if(NULL == m_pMsgbusCfg)
+	{
+		std::cout << "Invalid EMB configuration: " << sConfig << std::endl;
+		return false;
+	}
+	m_pMsgbusCtx = msgbus_initialize(m_pMsgbusCfg);
+	return (NULL != m_pMsgbusCtx);
+}
+
+/**
+ * Creates on-demand request payload as sent by MQTT clients, with send time in "usec"
+ * @param a_eTraffic :[in] kind of request
+ * @param a_uiSeq :[in] sequence number of request
+ * @return request payload
+ */
+std::string BridgeBenchmark_ut::createRequest(eBenchTraffic a_eTraffic, uint32_t a_uiSeq)
+{
+	bool bIsRT = ((BENCH_RT_READ == a_eTraffic) || (BENCH_RT_WRITE == a_eTraffic));
+	bool bIsWrite = ((BENCH_RT_WRITE == a_eTraffic) || (BENCH_NRT_WRITE == a_eTraffic));
+	return std::string("{\"wellhead\":\"PL0\",\"command\":\"Flow\",") +
+			(bIsWrite ? "\"value\":\"0x00\"," : "") +
+			"\"timestamp\":\"2019-09-20 12:34:56\",\"usec\":\"" +
+			std::to_string(CTimeFormatter::getInstance().nowMicros()) +
+			"\",\"version\":\"2.0\",\"app_seq\":\"" + std::to_string(a_uiSeq) +
+			"\",\"realtime\":\"" + (bIsRT ? "1" : "0") + "\"}";
+}
+
+/**
+ * Creates polled data message as published by Modbus container, with send time in "usec"
+ * @param a_eTraffic :[in] BENCH_RT_POLL or BENCH_NRT_POLL
+ * @param a_uiDevice :[in] device index
+ * @param a_uiSeq :[in] sequence number of message
+ * @return message; to be destroyed by caller
+ */
+msg_envelope_t* BridgeBenchmark_ut::createPolledData(eBenchTraffic a_eTraffic, uint32_t a_uiDevice, uint32_t a_uiSeq)
+{
+	msg_envelope_t *pMsg = msgbus_msg_envelope_new(CT_JSON);
+	if(NULL == pMsg)
+	{
+		return NULL;
+	}
+	const std::vector<std::pair<const char*, std::string>> vFields{
+		{"data_topic", getMqttTopic(a_eTraffic, a_uiDevice)},
+		{"wellhead", "PL0"},
+		{"metric", "Flow"},
+		{"value", "0x00"},
+		{"status", "Good"},
+		{"version", "2.0"},
+		{"realtime", (BENCH_RT_POLL == a_eTraffic) ? "1" : "0"},
+		{"driver_seq", std::to_string(a_uiSeq)},
+		{"timestamp", "2019-09-20 12:34:56"},
+		{"usec", std::to_string(CTimeFormatter::getInstance().nowMicros())}};
+	for(const auto &stField : vFields)
+	{
+		msgbus_msg_envelope_put(pMsg, stField.first, msgbus_msg_envelope_new_string(stField.second.c_str()));
+	}
+	return pMsg;
+}
+
+/**
+ * Receives requests published on EMB by bridge and records their latency
+ * @param a_bStop :[in] stop flag
+ * @return None
+ */
+void BridgeBenchmark_ut::receiveRequests(const std::atomic<bool> &a_bStop)
+{
+	while(false == a_bStop.load())
+	{
+		bool bIsReceived = false;
+		for(auto pSubCtx : m_vRequestSubs)
+		{
+			msg_envelope_t *pMsg = NULL;
+			if((MSG_SUCCESS != msgbus_recv_nowait(m_pMsgbusCtx, pSubCtx, &pMsg)) || (NULL == pMsg))
+			{
+				continue;
+			}
+			bIsReceived = true;
+			uint64_t ui64NowUs = CTimeFormatter::getInstance().nowMicros();
+			msg_envelope_elem_body_t *pData = NULL;
+			if((MSG_SUCCESS == msgbus_msg_envelope_get(pMsg, "usec", &pData)) && (MSG_ENV_DT_STRING == pData->type))
+			{
+				m_oMqttToEii.onReceived(pData->body.string, ui64NowUs);
+			}
+			msgbus_msg_envelope_destroy(pMsg);
+		}
+		if(false == bIsReceived)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(EII_LISTENER_MIN_IDLE_US));
+		}
+	}
+}
+
+/**
+ * Creates JSON report of benchmark
+ * @param a_dElapsedSec :[in] duration of run
+ * @return JSON report
+ */
+std::string BridgeBenchmark_ut::createReport(double a_dElapsedSec)
+{
+	std::ostringstream oss;
+	oss << "{\"config\":{\"msg_count\":" << m_stConfig.m_uiMsgCount
+		<< ",\"rate\":" << m_stConfig.m_uiRate
+		<< ",\"devices\":" << m_stConfig.m_uiDevices
+		<< ",\"inject\":\"" << (m_stConfig.m_bInjectViaBroker ? "broker" : "direct") << "\",\"mix\":{";
+	for(int i = 0; i < BENCH_TRAFFIC_MAX; ++i)
+	{
+		oss << ((0 == i) ? "" : ",") << "\"" << g_pcTrafficNames[i] << "\":" << m_stConfig.m_auiWeights[i];
+	}
+	oss << "}},\"elapsed_sec\":" << a_dElapsedSec
+		<< ",\"mqtt_to_eii\":" << m_oMqttToEii.toJson()
+		<< ",\"eii_to_mqtt\":" << m_oEiiToMqtt.toJson() << "}";
+	return oss.str();
+}
+
+/**
+ * Test case to check if traffic kinds are interleaved as per weights
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(BridgeBenchmark_ut, createSchedule_Mix)
+{
+	stBenchConfig stConfig;
+	stConfig.m_uiMsgCount = 80;
+	std::vector<eBenchTraffic> vSchedule = createSchedule(stConfig);
+	ASSERT_EQ((size_t)80, vSchedule.size());
+
+	size_t auiCount[BENCH_TRAFFIC_MAX] = {0};
+	for(auto eTraffic : vSchedule)
+	{
+		++auiCount[eTraffic];
+	}
+	EXPECT_EQ((size_t)10, auiCount[BENCH_RT_READ]);
+	EXPECT_EQ((size_t)10, auiCount[BENCH_NRT_WRITE]);
+	EXPECT_EQ((size_t)20, auiCount[BENCH_RT_POLL]);
+	EXPECT_EQ((size_t)20, auiCount[BENCH_NRT_POLL]);
+
+	// first full round contains every kind
+	std::vector<eBenchTraffic> vRound(vSchedule.begin(), vSchedule.begin() + 8);
+	for(int i = 0; i < BENCH_TRAFFIC_MAX; ++i)
+	{
+		EXPECT_NE(vRound.end(), std::find(vRound.begin(), vRound.end(), (eBenchTraffic)i));
+	}
+}
+
+/**
+ * Test case to check if CLatencyRecorder reports percentiles and ignores messages without send time
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(BridgeBenchmark_ut, latencyRecorder_Percentiles)
+{
+	CLatencyRecorder oRecorder;
+	for(uint64_t i = 1; i <= 1000; ++i)
+	{
+		oRecorder.onSent(1000);
+		oRecorder.onReceived("1000", 1000 + i);
+	}
+	oRecorder.onReceived("InvMsg", 5000);
+
+	EXPECT_EQ((uint64_t)1000, oRecorder.getSent());
+	EXPECT_EQ((uint64_t)1000, oRecorder.getReceived());
+	EXPECT_EQ("{\"sent\":1000,\"received\":1000,\"msgs_per_sec\":1000000,"
+			"\"latency_us\":{\"p50\":501,\"p99\":991,\"p999\":1000,\"max\":1000}}", oRecorder.toJson());
+}
+
+/**
+ * Load and latency benchmark of both directions of bridge. Requests are given to MQTT
+ * subscriber (or published on broker with BENCH_MQTT_INJECT=broker) and received on
+ * in-process EMB after passing scheduler and postMsgsToEII(). Polled data is published
+ * on in-process EMB and received from MQTT broker after passing listener pool and processMsg().
+ * Report with msgs/s and p50/p99/p999 latency per direction is written as JSON.
+ * Runs only when MQTT_BRIDGE_BENCHMARK=true.
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(BridgeBenchmark_ut, benchmark_EndToEnd)
+{
+	if(false == isEnabled())
+	{
+		std::cout << "Set MQTT_BRIDGE_BENCHMARK=true to run bridge benchmark" << std::endl;
+		return;
+	}
+	m_stConfig = readConfig();
+	std::vector<eBenchTraffic> vSchedule = createSchedule(m_stConfig);
+	ASSERT_FALSE(vSchedule.empty());
+
+	const std::string sMqttUrl = EnvironmentInfo::getInstance().getDataFromEnvMap("MQTT_URL_FOR_EXPORT");
+	auto waitFor = [](const std::function<bool()> &a_fcbIsDone, uint32_t a_uiTimeoutSec)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(a_uiTimeoutSec);
+		while((false == a_fcbIsDone()) && (std::chrono::steady_clock::now() < deadline))
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return a_fcbIsDone();
+	};
+
+	// MQTT client receiving polled data published by bridge; without broker only requests are measured
+	CMQTTPubSubClient oMqttSub(sMqttUrl, "MQTT_Bridge_bench_sub", 0, false, "", "", "", "BenchSubscription");
+	oMqttSub.setNotificationMsgRcvd([this](mqtt::const_message_ptr a_pMsg)
+	{
+		uint64_t ui64NowUs = CTimeFormatter::getInstance().nowMicros();
+		const std::string &sPayload = a_pMsg->get_payload();
+		const char *pcValue = NULL;
+		size_t uiLen = 0;
+		if(JSON_KEY_FOUND == CJsonKeyScanner::find(sPayload.data(), sPayload.size(), "usec",
+				pcValue, uiLen, sPayload.size()))
+		{
+			m_oEiiToMqtt.onReceived(std::string(pcValue, uiLen), ui64NowUs);
+		}
+	});
+	oMqttSub.connect();
+	if(true == waitFor([&oMqttSub]() { return oMqttSub.isConnected(); }, BENCH_SETUP_WAIT_SEC))
+	{
+		oMqttSub.subscribe("/benchflow/+/+/update");
+	}
+	else
+	{
+		std::cout << "MQTT broker " << sMqttUrl << " is not reachable, EII to MQTT is not measured" << std::endl;
+		m_stConfig.m_auiWeights[BENCH_RT_POLL] = 0;
+		m_stConfig.m_auiWeights[BENCH_NRT_POLL] = 0;
+		vSchedule = createSchedule(m_stConfig);
+		ASSERT_FALSE(vSchedule.empty());
+	}
+
+	// EMB topics on which bridge publishes requests and on which polled data is received
+	std::vector<std::string> vRequestTopics;
+	for(uint32_t uiDev = 0; uiDev < m_stConfig.m_uiDevices; ++uiDev)
+	{
+		for(int i = BENCH_RT_READ; i <= BENCH_NRT_WRITE; ++i)
+		{
+			vRequestTopics.push_back(mapMqttToEMBTopic(getMqttTopic((eBenchTraffic)i, uiDev),
+					((BENCH_RT_READ == i) || (BENCH_RT_WRITE == i))));
+		}
+	}
+	std::vector<std::string> vAllTopics = vRequestTopics;
+	vAllTopics.push_back(getEMBTopicName(BENCH_RT_POLL));
+	vAllTopics.push_back(getEMBTopicName(BENCH_NRT_POLL));
+	ASSERT_TRUE(initMsgbus(vAllTopics));
+
+	// bridge finds these contexts already prepared and publishes on in-process EMB
+	for(const auto &sTopic : vRequestTopics)
+	{
+		ASSERT_TRUE(zmq_handler::prepareContext(true, m_pMsgbusCtx, sTopic, m_pMsgbusCfg));
+		recv_ctx_t *pSubCtx = NULL;
+		ASSERT_EQ(MSG_SUCCESS, msgbus_subscriber_new(m_pMsgbusCtx, sTopic.c_str(), NULL, &pSubCtx));
+		m_vRequestSubs.push_back(pSubCtx);
+	}
+
+	std::vector<std::unique_ptr<CEIIListenerPool>> vPools;
+	for(eBenchTraffic eTraffic : {BENCH_RT_POLL, BENCH_NRT_POLL})
+	{
+		std::string sTopic = getEMBTopicName(eTraffic);
+		publisher_ctx_t *pPubCtx = NULL;
+		recv_ctx_t *pSubCtx = NULL;
+		ASSERT_EQ(MSG_SUCCESS, msgbus_publisher_new(m_pMsgbusCtx, sTopic.c_str(), &pPubCtx));
+		m_vPollPubs.push_back(pPubCtx);
+		ASSERT_EQ(MSG_SUCCESS, msgbus_subscriber_new(m_pMsgbusCtx, sTopic.c_str(), NULL, &pSubCtx));
+		m_vPollSubs.push_back(pSubCtx);
+
+		globalConfig::COperation objOperation;
+		getOperation(sTopic, objOperation);
+		vPools.push_back(std::unique_ptr<CEIIListenerPool>(new CEIIListenerPool("Bench_" + sTopic,
+				objOperation, CEIIListenerPool::readConfig(), processMsg)));
+		vPools.back()->addTopic(sTopic, m_pMsgbusCtx, pSubCtx);
+	}
+
+	// client publishing requests on broker, used with BENCH_MQTT_INJECT=broker
+	CMQTTPubSubClient oMqttPub(sMqttUrl, "MQTT_Bridge_bench_pub", 0, false, "", "", "", "BenchPublish");
+	if(true == m_stConfig.m_bInjectViaBroker)
+	{
+		oMqttPub.connect();
+		ASSERT_TRUE(waitFor([&oMqttPub]() { return oMqttPub.isConnected(); }, BENCH_SETUP_WAIT_SEC));
+		ASSERT_TRUE(waitFor([]() { return CMQTTHandler::instance().isConnected(); }, BENCH_SETUP_WAIT_SEC));
+	}
+
+	// start bridge threads of both directions
+	std::atomic<bool> bStopBench(false);
+	g_shouldStop = false;
+	std::vector<std::thread> vThreads;
+	for(size_t i = 0; i < CEMBWorkerPool::getInstance().getWorkerCount(); ++i)
+	{
+		vThreads.push_back(std::thread(postMsgsToEII, std::ref(CEMBWorkerPool::getInstance().getWorker(i))));
+	}
+	for(auto &pPool : vPools)
+	{
+		vThreads.push_back(std::thread(&CEIIListenerPool::run, pPool.get(), std::cref(g_shouldStop)));
+	}
+	std::thread thReceiver(&BridgeBenchmark_ut::receiveRequests, this, std::cref(bStopBench));
+
+	// let ZMQ subscribers and MQTT connections of listener pools settle
+	std::this_thread::sleep_for(std::chrono::seconds(2));
+
+	auto start = std::chrono::steady_clock::now();
+	for(uint32_t uiSeq = 0; uiSeq < vSchedule.size(); ++uiSeq)
+	{
+		if(0 != m_stConfig.m_uiRate)
+		{
+			std::this_thread::sleep_until(start +
+					std::chrono::microseconds((uint64_t)uiSeq * 1000000 / m_stConfig.m_uiRate));
+		}
+		eBenchTraffic eTraffic = vSchedule[uiSeq];
+		uint32_t uiDev = uiSeq % m_stConfig.m_uiDevices;
+		if((BENCH_RT_POLL == eTraffic) || (BENCH_NRT_POLL == eTraffic))
+		{
+			msg_envelope_t *pMsg = createPolledData(eTraffic, uiDev, uiSeq);
+			m_oEiiToMqtt.onSent(CTimeFormatter::getInstance().nowMicros());
+			msgbus_publisher_publish(m_pMsgbusCtx, m_vPollPubs[(BENCH_RT_POLL == eTraffic) ? 0 : 1], pMsg);
+			msgbus_msg_envelope_destroy(pMsg);
+			continue;
+		}
+
+		mqtt::message_ptr pReq = mqtt::make_message(getMqttTopic(eTraffic, uiDev), createRequest(eTraffic, uiSeq));
+		m_oMqttToEii.onSent(CTimeFormatter::getInstance().nowMicros());
+		if(true == m_stConfig.m_bInjectViaBroker)
+		{
+			oMqttPub.publishMsg(pReq);
+		}
+		else
+		{
+			CMQTTHandler::instance().msgRcvd(pReq);
+		}
+	}
+
+	waitFor([this]()
+	{
+		return (m_oMqttToEii.getReceived() >= m_oMqttToEii.getSent()) &&
+			(m_oEiiToMqtt.getReceived() >= m_oEiiToMqtt.getSent());
+	}, m_stConfig.m_uiTimeoutSec);
+	double dElapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// stop threads and release in-process EMB
+	g_shouldStop = true;
+	bStopBench = true;
+	thReceiver.join();
+	for(auto &th : vThreads)
+	{
+		th.join();
+	}
+	vPools.clear();
+	oMqttSub.disconnect();
+	oMqttPub.disconnect();
+	for(const auto &sTopic : vRequestTopics)
+	{
+		msgbus_publisher_destroy(m_pMsgbusCtx, (publisher_ctx_t*)zmq_handler::getPubCTX(sTopic).m_pContext);
+		zmq_handler::removePubCTX(sTopic);
+		zmq_handler::removeCTX(sTopic);
+	}
+	for(auto pPubCtx : m_vPollPubs)
+	{
+		msgbus_publisher_destroy(m_pMsgbusCtx, pPubCtx);
+	}
+	for(auto pSubCtx : m_vRequestSubs)
+	{
+		msgbus_recv_ctx_destroy(m_pMsgbusCtx, pSubCtx);
+	}
+	for(auto pSubCtx : m_vPollSubs)
+	{
+		msgbus_recv_ctx_destroy(m_pMsgbusCtx, pSubCtx);
+	}
+	msgbus_destroy(m_pMsgbusCtx);
+	m_pMsgbusCtx = NULL;
+
+	std::string sReport = createReport(dElapsedSec);
+	if(m_stConfig.m_sReportFile.empty())
+	{
+		std::cout << sReport << std::endl;
+	}
+	else
+	{
+		std::ofstream ofs(m_stConfig.m_sReportFile);
+		ofs << sReport << std::endl;
+	}
+
+	EXPECT_EQ(m_oMqttToEii.getSent(), m_oMqttToEii.getReceived());
+	EXPECT_EQ(m_oEiiToMqtt.getSent(), m_oEiiToMqtt.getReceived());
+}
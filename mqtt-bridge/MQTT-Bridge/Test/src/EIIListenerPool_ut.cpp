@@ -0,0 +1,274 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/EIIListenerPool_ut.hpp"
+#include <stdlib.h>
+#include <unistd.h>
+
+void EIIListenerPool_ut::SetUp()
+{
+	unsetenv("EII_LISTENER_WORKERS");
+	unsetenv("MQTT_PUBLISHER_CONNECTIONS");
+	unsetenv("EII_LISTENER_QUEUE_DEPTH");
+	unsetenv("EII_POLL_MAX_IDLE_US");
+	m_bStop = false;
+	for(int i = 0; i < UT_POOL_TOPICS; ++i)
+	{
+		m_aSubCtx[i].ctx = NULL;
+		m_aSent[i] = 0;
+	}
+	m_iMsgsPerTopic = 0;
+	m_mapHandled.clear();
+	m_iHandled = 0;
+}
+
+void EIIListenerPool_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**
+ * Fake of msgbus_recv_nowait(); gives messages of a topic in sequence
+ * @param a_pSubCtx :[in] subscriber context of topic
+ * @param a_ppMsg :[out] received message
+ * @return MSG_SUCCESS if message is given, MSG_RECV_NO_MESSAGE otherwise
+ */
+msgbus_ret_t EIIListenerPool_ut::fakeRecv(recv_ctx_t *a_pSubCtx, msg_envelope_t **a_ppMsg)
+{
+	int iTopic = (int)(a_pSubCtx - m_aSubCtx);
+	if(m_aSent[iTopic] >= m_iMsgsPerTopic)
+	{
+		return MSG_RECV_NO_MESSAGE;
+	}
+	msg_envelope_t *pMsg = msgbus_msg_envelope_new(CT_JSON);
+	msgbus_msg_envelope_put(pMsg, "topic", msgbus_msg_envelope_new_integer(iTopic));
+	msgbus_msg_envelope_put(pMsg, "seq", msgbus_msg_envelope_new_integer(m_aSent[iTopic]++));
+	*a_ppMsg = pMsg;
+	return MSG_SUCCESS;
+}
+
+/**
+ * Handler of pool which records topic and sequence number of message
+ * @param a_pMsg :[in] message; destroyed
+ * @return true
+ */
+bool EIIListenerPool_ut::recordMsg(msg_envelope_t *a_pMsg)
+{
+	msg_envelope_elem_body_t *pTopic = NULL;
+	msg_envelope_elem_body_t *pSeq = NULL;
+	msgbus_msg_envelope_get(a_pMsg, "topic", &pTopic);
+	msgbus_msg_envelope_get(a_pMsg, "seq", &pSeq);
+	{
+		std::lock_guard<std::mutex> lck(m_mutexHandled);
+		m_mapHandled[pTopic->body.integer].push_back(pSeq->body.integer);
+	}
+	msgbus_msg_envelope_destroy(a_pMsg);
+	++m_iHandled;
+	return true;
+}
+
+/**
+ * Adds fake topics to pool and makes pool receive from them
+ * @param a_oPool :[in] pool
+ * @return None
+ */
+void EIIListenerPool_ut::addTopics(CEIIListenerPool &a_oPool)
+{
+	_setRecv(a_oPool);
+	for(int i = 0; i < UT_POOL_TOPICS; ++i)
+	{
+		ASSERT_EQ(true, a_oPool.addTopic("NRT/topic" + std::to_string(i), &m_aSubCtx[i], &m_aSubCtx[i]));
+	}
+}
+
+/**
+ * Test case to check if readConfig() returns default values when environment variables are not set
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EIIListenerPool_ut, readConfig_Default)
+{
+	stListenerPoolConfig stConfig = CEIIListenerPool::readConfig();
+	EXPECT_EQ((size_t)EII_LISTENER_DEFAULT_WORKERS, stConfig.m_uiWorkers);
+	EXPECT_EQ((size_t)EII_LISTENER_DEFAULT_PUBLISHERS, stConfig.m_uiPublishers);
+	EXPECT_EQ((size_t)EII_LISTENER_DEFAULT_QUEUE_DEPTH, stConfig.m_uiQueueDepth);
+	EXPECT_EQ((uint32_t)EII_LISTENER_DEFAULT_MAX_IDLE_US, stConfig.m_uiMaxIdleUs);
+}
+
+/**
+ * Test case to check if readConfig() reads environment variables and ignores invalid values
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EIIListenerPool_ut, readConfig_Env)
+{
+	setenv("EII_LISTENER_WORKERS", "8", 1);
+	setenv("MQTT_PUBLISHER_CONNECTIONS", "3", 1);
+	setenv("EII_LISTENER_QUEUE_DEPTH", "abc", 1);
+	stListenerPoolConfig stConfig = CEIIListenerPool::readConfig();
+	EXPECT_EQ(8u, stConfig.m_uiWorkers);
+	EXPECT_EQ(3u, stConfig.m_uiPublishers);
+	EXPECT_EQ((size_t)EII_LISTENER_DEFAULT_QUEUE_DEPTH, stConfig.m_uiQueueDepth);
+}
+
+/**
+ * Test case to check if addTopic() rejects a topic without context and run() returns when there is no topic
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EIIListenerPool_ut, addTopic_NullContext)
+{
+	CEIIListenerPool oPool("UT_Pool", m_objOperation, CEIIListenerPool::readConfig(),
+			[](msg_envelope_t *a_pMsg, CMQTTPublishHandler &a_mqttPublisher) { return true; });
+	EXPECT_EQ(false, oPool.addTopic("NRT/update", NULL, NULL));
+	EXPECT_EQ(0u, oPool.getTopicCount());
+	oPool.run(m_bStop);
+}
+
+/**
+ * Test case to check that each topic is given to a fixed worker, same after workers are started again
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EIIListenerPool_ut, startWorkers_StableAssignment)
+{
+	stListenerPoolConfig stConfig;
+	stConfig.m_uiWorkers = 4;
+	CEIIListenerPool oPool("UT_Pool", m_objOperation, stConfig,
+			[this](msg_envelope_t *a_pMsg, CMQTTPublishHandler &a_mqttPublisher) { return recordMsg(a_pMsg); });
+	addTopics(oPool);
+
+	_startWorkers(oPool);
+	ASSERT_EQ(4u, _getWorkerCount(oPool));
+	std::vector<size_t> vecWorkers;
+	for(size_t i = 0; i < UT_POOL_TOPICS; ++i)
+	{
+		vecWorkers.push_back(_getWorkerOfTopic(oPool, i));
+		EXPECT_EQ(i % 4, vecWorkers.back());
+	}
+	_stopWorkers(oPool);
+
+	_startWorkers(oPool);
+	for(size_t i = 0; i < UT_POOL_TOPICS; ++i)
+	{
+		EXPECT_EQ(vecWorkers[i], _getWorkerOfTopic(oPool, i));
+	}
+	_stopWorkers(oPool);
+}
+
+/**
+ * Test case to check that messages of each topic are handled in order they are received,
+ * while topics share workers
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EIIListenerPool_ut, pollOnce_OrderPerTopic)
+{
+	stListenerPoolConfig stConfig;
+	stConfig.m_uiWorkers = 3;
+	stConfig.m_uiQueueDepth = 4;
+	CEIIListenerPool oPool("UT_Pool", m_objOperation, stConfig,
+			[this](msg_envelope_t *a_pMsg, CMQTTPublishHandler &a_mqttPublisher) { return recordMsg(a_pMsg); });
+	addTopics(oPool);
+	m_iMsgsPerTopic = 200;
+
+	_startWorkers(oPool);
+	for(int iLoop = 0; (iLoop < 100000) && (m_iHandled.load() < UT_POOL_TOPICS * m_iMsgsPerTopic); ++iLoop)
+	{
+		if(false == _pollOnce(oPool))
+		{
+			usleep(100);
+		}
+	}
+	_stopWorkers(oPool);
+
+	ASSERT_EQ(UT_POOL_TOPICS * m_iMsgsPerTopic, m_iHandled.load());
+	for(int64_t i = 0; i < UT_POOL_TOPICS; ++i)
+	{
+		const std::vector<int64_t> &vecSeq = m_mapHandled[i];
+		ASSERT_EQ((size_t)m_iMsgsPerTopic, vecSeq.size());
+		for(size_t uiSeq = 0; uiSeq < vecSeq.size(); ++uiSeq)
+		{
+			EXPECT_EQ((int64_t)uiSeq, vecSeq[uiSeq]) << "topic " << i;
+		}
+	}
+}
+
+/**
+ * Test case to check that a topic whose worker queue is full is skipped, so that its messages
+ * stay in EII and none is dropped, while topics of other workers are still received
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EIIListenerPool_ut, pollOnce_FullQueueSkipped)
+{
+	stListenerPoolConfig stConfig;
+	stConfig.m_uiWorkers = 2;
+	stConfig.m_uiQueueDepth = 2;
+	std::mutex mutexBlock;
+	std::unique_lock<std::mutex> lckBlock(mutexBlock);
+	// worker 0 is blocked in handler; worker 1 handles messages right away
+	CEIIListenerPool oPool("UT_Pool", m_objOperation, stConfig,
+			[&](msg_envelope_t *a_pMsg, CMQTTPublishHandler &a_mqttPublisher)
+			{
+				msg_envelope_elem_body_t *pTopic = NULL;
+				msgbus_msg_envelope_get(a_pMsg, "topic", &pTopic);
+				if(0 == (pTopic->body.integer % 2))
+				{
+					std::lock_guard<std::mutex> lck(mutexBlock);
+				}
+				return recordMsg(a_pMsg);
+			});
+	addTopics(oPool);
+	m_iMsgsPerTopic = 20;
+
+	_startWorkers(oPool);
+	for(int iLoop = 0; iLoop < 200; ++iLoop)
+	{
+		_pollOnce(oPool);
+		usleep(100);
+	}
+	// one message of worker 0 is in handler, queue is full and rest stay in EII
+	EXPECT_EQ(2u, _getQueuedCount(oPool, 0));
+	int iReceived0 = m_aSent[0] + m_aSent[2] + m_aSent[4];
+	EXPECT_EQ(3, iReceived0);
+	EXPECT_EQ(m_iMsgsPerTopic, m_aSent[1]);
+	EXPECT_EQ(m_iMsgsPerTopic, m_aSent[3]);
+	EXPECT_EQ(m_iMsgsPerTopic, m_aSent[5]);
+
+	lckBlock.unlock();
+	for(int iLoop = 0; (iLoop < 100000) && (m_iHandled.load() < UT_POOL_TOPICS * m_iMsgsPerTopic); ++iLoop)
+	{
+		if(false == _pollOnce(oPool))
+		{
+			usleep(100);
+		}
+	}
+	_stopWorkers(oPool);
+	EXPECT_EQ(UT_POOL_TOPICS * m_iMsgsPerTopic, m_iHandled.load());
+}
@@ -0,0 +1,127 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/EMBWorkerPool_ut.hpp"
+
+void EMBWorkerPool_ut::SetUp()
+{
+	m_stConfig.m_uiBatchSize = 8;
+	m_stConfig.m_uiWorkers = 4;
+	m_stConfig.m_uiStatsIntervalSec = 0;
+	m_stConfig.m_uiNonRTDeadlineMs = 0;
+	m_bStop = false;
+}
+
+void EMBWorkerPool_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**
+ * Test case to check device part of request topics
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EMBWorkerPool_ut, getDeviceKey)
+{
+	EXPECT_EQ("/flowmeter/PL0", CEMBWorkerPool::getDeviceKey("/flowmeter/PL0/D1/write"));
+	EXPECT_EQ("/flowmeter/PL0", CEMBWorkerPool::getDeviceKey("/flowmeter/PL0/D2/read"));
+	EXPECT_EQ("/iou/PL1", CEMBWorkerPool::getDeviceKey("/iou/PL1/DO1/read"));
+	EXPECT_EQ("MQTT_Export_WrReq/write", CEMBWorkerPool::getDeviceKey("MQTT_Export_WrReq/write"));
+	EXPECT_EQ("/D1/read", CEMBWorkerPool::getDeviceKey("/D1/read"));
+	EXPECT_EQ("", CEMBWorkerPool::getDeviceKey(""));
+}
+
+/**
+ * Test case to check if all requests of a device go to one worker, in order of arrival
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EMBWorkerPool_ut, submit_SameDeviceSameWorker)
+{
+	CEMBWorkerPool oPool(m_stConfig);
+	ASSERT_EQ((size_t)4, oPool.getWorkerCount());
+
+	size_t uiWorker = oPool.getWorkerIndex("/flowmeter/PL0/D1/write");
+	EXPECT_EQ(uiWorker, oPool.getWorkerIndex("/flowmeter/PL0/D2/read"));
+	EXPECT_EQ(uiWorker, oPool.getWorkerIndex("/flowmeter/PL0/D3/write"));
+
+	for(int i = 0; i < 6; ++i)
+	{
+		CMessageObject oMsg("/flowmeter/PL0/D" + std::to_string(i) + "/write", "{\"app_seq\":\"" + std::to_string(i) + "\"}");
+		EXPECT_EQ(true, oPool.submit(oMsg, false, true));
+	}
+	EXPECT_EQ((size_t)6, oPool.getPendingCount());
+	EXPECT_EQ((size_t)6, oPool.getWorker(uiWorker).getScheduler().getPendingCount());
+
+	std::vector<CMessageObject> vBatch;
+	eReqClass eClass = REQ_CLASS_MAX;
+	EXPECT_EQ((size_t)6, oPool.getWorker(uiWorker).getScheduler().nextBatch(vBatch, eClass, m_bStop));
+	EXPECT_EQ(REQ_CLASS_NON_RT_WRITE, eClass);
+	for(size_t i = 0; i < vBatch.size(); ++i)
+	{
+		EXPECT_EQ("/flowmeter/PL0/D" + std::to_string(i) + "/write", vBatch[i].getTopic());
+	}
+}
+
+/**
+ * Test case to check if requests of many devices are spread over all workers
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EMBWorkerPool_ut, submit_SpreadOverWorkers)
+{
+	CEMBWorkerPool oPool(m_stConfig);
+	for(int i = 0; i < 64; ++i)
+	{
+		CMessageObject oMsg("/flowmeter/PL" + std::to_string(i) + "/D1/read", "{}");
+		EXPECT_EQ(true, oPool.submit(oMsg, false, false));
+	}
+	EXPECT_EQ((size_t)64, oPool.getPendingCount());
+	for(size_t i = 0; i < oPool.getWorkerCount(); ++i)
+	{
+		EXPECT_LT((size_t)0, oPool.getWorker(i).getScheduler().getPendingCount());
+		EXPECT_EQ(i, oPool.getWorker(i).getIndex());
+		EXPECT_EQ((size_t)0, oPool.getWorker(i).getPublisherCount());
+	}
+
+	oPool.stop();
+	CMessageObject oMsg("/flowmeter/PL0/D1/read", "{}");
+	EXPECT_EQ(false, oPool.submit(oMsg, false, false));
+}
+
+/**
+ * Test case to check if a pool configured with no workers still has one worker
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(EMBWorkerPool_ut, ctor_MinOneWorker)
+{
+	m_stConfig.m_uiWorkers = 0;
+	CEMBWorkerPool oPool(m_stConfig);
+	EXPECT_EQ((size_t)1, oPool.getWorkerCount());
+	EXPECT_EQ((size_t)0, oPool.getWorkerIndex("/flowmeter/PL0/D1/read"));
+}
@@ -0,0 +1,283 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/JsonEnvelopeTranscoder_ut.hpp"
+#include "cjson/cJSON.h"
+#include <chrono>
+#include <functional>
+#include <string.h>
+#include <iostream>
+
+void JsonEnvelopeTranscoder_ut::SetUp()
+{
+	// Setup code
+}
+
+void JsonEnvelopeTranscoder_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**
+ * Converts JSON to envelope the way publishEIIMsg() did before single pass transcoder,
+ * used as baseline in benchmark
+ * @param a_sJson :[in] JSON object
+ * @return envelope, NULL on error
+ */
+static msg_envelope_t* transcodeUsingCJSON(const std::string &a_sJson,
+		const std::vector<std::pair<std::string, std::string>> &a_vExtraFields)
+{
+	msg_envelope_t *msg = msgbus_msg_envelope_new(CT_JSON);
+	cJSON *root = cJSON_Parse(a_sJson.c_str());
+	if(NULL == root)
+	{
+		msgbus_msg_envelope_destroy(msg);
+		return NULL;
+	}
+	for(cJSON *device = root->child; NULL != device; device = device->next)
+	{
+		if(cJSON_IsString(device))
+		{
+			msgbus_msg_envelope_put(msg, device->string, msgbus_msg_envelope_new_string(device->valuestring));
+		}
+		else if(cJSON_IsBool(device))
+		{
+			msgbus_msg_envelope_put(msg, device->string, msgbus_msg_envelope_new_bool(cJSON_IsTrue(device)));
+		}
+		else if(cJSON_IsNumber(device))
+		{
+			msgbus_msg_envelope_put(msg, device->string, msgbus_msg_envelope_new_floating(device->valuedouble));
+		}
+	}
+	cJSON_Delete(root);
+	for(const auto &field : a_vExtraFields)
+	{
+		msgbus_msg_envelope_put(msg, field.first.c_str(), msgbus_msg_envelope_new_string(field.second.c_str()));
+	}
+	return msg;
+}
+
+/**
+ * Test case to check if tokenizer reports events of a document in order
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(JsonEnvelopeTranscoder_ut, tokenizer_Events)
+{
+	CSaxRecorder oRecorder;
+	CJsonTokenizer oTokenizer(oRecorder);
+	std::string sJson = " {\"a\": [1, -2.5e3, true, null], \"b\\n\": \"x\\u00e9\\ud83d\\ude00\", \"c\": {}} ";
+	EXPECT_EQ(true, oTokenizer.parse(sJson.data(), sJson.size()));
+	EXPECT_EQ("{k:a [i:1 d true null ]k:b\n s:x\xc3\xa9\xf0\x9f\x98\x80 k:c {}}", oRecorder.m_sEvents);
+}
+
+/**
+ * Test case to check if tokenizer rejects invalid documents
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(JsonEnvelopeTranscoder_ut, tokenizer_Invalid)
+{
+	const char *apcInvalid[] = {"", "{", "{\"a\" 1}", "{\"a\":1,}", "[1 2]", "{\"a\":01}", "{\"a\":\"x}",
+			"{\"a\":tru}", "{} x", "{\"a\":1.}", "\"\\q\""};
+	for(const char *pcJson : apcInvalid)
+	{
+		CSaxRecorder oRecorder;
+		CJsonTokenizer oTokenizer(oRecorder);
+		EXPECT_EQ(false, oTokenizer.parse(pcJson, strlen(pcJson))) << pcJson;
+		EXPECT_EQ(false, oTokenizer.getError().empty());
+	}
+}
+
+/**
+ * Test case to check if transcode() keeps integer and string types and adds extra fields
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(JsonEnvelopeTranscoder_ut, transcode_Types)
+{
+	std::string sError;
+	msg_envelope_t *pMsg = CJsonEnvelopeTranscoder::transcode(m_sWriteReq, m_vExtra, sError);
+	ASSERT_NE(nullptr, pMsg);
+
+	msg_envelope_elem_body_t *pData = NULL;
+	ASSERT_EQ(MSG_SUCCESS, msgbus_msg_envelope_get(pMsg, "scale", &pData));
+	EXPECT_EQ(MSG_ENV_DT_INT, pData->type);
+	EXPECT_EQ(10, pData->body.integer);
+	ASSERT_EQ(MSG_SUCCESS, msgbus_msg_envelope_get(pMsg, "offset", &pData));
+	EXPECT_EQ(MSG_ENV_DT_FLOATING, pData->type);
+	ASSERT_EQ(MSG_SUCCESS, msgbus_msg_envelope_get(pMsg, "value", &pData));
+	EXPECT_EQ(MSG_ENV_DT_STRING, pData->type);
+	EXPECT_STREQ("0x00", pData->body.string);
+	ASSERT_EQ(MSG_SUCCESS, msgbus_msg_envelope_get(pMsg, "sourcetopic", &pData));
+	EXPECT_STREQ("/flowmeter/PL0/D1/write", pData->body.string);
+	msgbus_msg_envelope_destroy(pMsg);
+}
+
+/**
+ * Test case to check if transcode() rejects JSON which is not a flat object
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(JsonEnvelopeTranscoder_ut, transcode_Invalid)
+{
+	std::string sError;
+	EXPECT_EQ(nullptr, CJsonEnvelopeTranscoder::transcode("[1]", m_vExtra, sError));
+	EXPECT_EQ(nullptr, CJsonEnvelopeTranscoder::transcode("{\"a\":{\"b\":1}}", m_vExtra, sError));
+	EXPECT_EQ(nullptr, CJsonEnvelopeTranscoder::transcode("{\"a\":null}", m_vExtra, sError));
+	EXPECT_EQ(nullptr, CJsonEnvelopeTranscoder::transcode("InvMsg", m_vExtra, sError));
+	EXPECT_EQ(false, sError.empty());
+}
+
+/**
+ * Test case to check if transcode() fails when a value cannot be added to envelope
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(JsonEnvelopeTranscoder_ut, transcode_DuplicateKey)
+{
+	std::string sError;
+	EXPECT_EQ(nullptr, CJsonEnvelopeTranscoder::transcode("{\"a\":1,\"a\":2}", m_vExtra, sError));
+	EXPECT_EQ("Could not add key to message: a", sError);
+
+	// extra field which is also present in JSON
+	EXPECT_EQ(nullptr, CJsonEnvelopeTranscoder::transcode("{\"sourcetopic\":\"t\"}", m_vExtra, sError));
+}
+
+/**
+ * Test case to check if appendStringField() adds field to object and rejects invalid JSON
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(JsonEnvelopeTranscoder_ut, appendStringField)
+{
+	std::string sJson = "{\"a\":1} ";
+	EXPECT_EQ(true, CJsonEnvelopeTranscoder::appendStringField(sJson, "ts", "12\"3"));
+	EXPECT_EQ("{\"a\":1,\"ts\":\"12\\\"3\"} ", sJson);
+
+	sJson = "{ }";
+	EXPECT_EQ(true, CJsonEnvelopeTranscoder::appendStringField(sJson, "ts", "1"));
+	EXPECT_EQ("{ \"ts\":\"1\"}", sJson);
+
+	sJson = "[{}]";
+	EXPECT_EQ(false, CJsonEnvelopeTranscoder::appendStringField(sJson, "ts", "1"));
+}
+
+/**
+ * Microbenchmark comparing single pass transcoder with cJSON based conversion on write
+ * request payloads. Prints time per message for both.
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(JsonEnvelopeTranscoder_ut, benchmark_WriteRequest)
+{
+	const int iIterations = 20000;
+	std::string sError;
+
+	int iFailed = 0;
+
+	auto measure = [&](const std::function<msg_envelope_t*()> &a_fcbTranscode) -> double
+	{
+		auto start = std::chrono::steady_clock::now();
+		for(int i = 0; i < iIterations; ++i)
+		{
+			msg_envelope_t *pMsg = a_fcbTranscode();
+			if(NULL == pMsg)
+			{
+				++iFailed;
+				continue;
+			}
+			msgbus_msg_envelope_destroy(pMsg);
+		}
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iIterations;
+	};
+	double dCJSON = measure([&]() { return transcodeUsingCJSON(m_sWriteReq, m_vExtra); });
+	double dSinglePass = measure([&]() { return CJsonEnvelopeTranscoder::transcode(m_sWriteReq, m_vExtra, sError); });
+	EXPECT_EQ(0, iFailed);
+
+	std::string sMsg = m_sWriteReq;
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < iIterations; ++i)
+	{
+		sMsg = m_sWriteReq;
+		CJsonEnvelopeTranscoder::appendStringField(sMsg, "tsMsgReadyForPublish", "1571887474111200");
+	}
+	double dAppend = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iIterations;
+
+	std::cout << "JSON to envelope, ns/msg: cJSON " << dCJSON << ", single pass " << dSinglePass
+			<< "; add timestamp, ns/msg: " << dAppend << std::endl;
+}
+
+/**
+ * Test case to check if CJsonKeyScanner::find() returns value of top level key only
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(JsonEnvelopeTranscoder_ut, keyScanner_Found)
+{
+	const char *pcValue = NULL;
+	size_t uiLen = 0;
+	std::string sJson = "{\"a\":{\"realtime\":\"0\"},\"b\":[1,\"}\"], \"realtime\" : \"1\" }";
+	ASSERT_EQ(JSON_KEY_FOUND, CJsonKeyScanner::find(sJson.data(), sJson.size(), "realtime", pcValue, uiLen, 4096));
+	EXPECT_EQ("1", std::string(pcValue, uiLen));
+
+	sJson = "{\"x\\\"\":1,\"realtime\": true }";
+	ASSERT_EQ(JSON_KEY_FOUND, CJsonKeyScanner::find(sJson.data(), sJson.size(), "realtime", pcValue, uiLen, 4096));
+	EXPECT_EQ("true", std::string(pcValue, uiLen));
+
+	ASSERT_EQ(JSON_KEY_FOUND, CJsonKeyScanner::find(m_sWriteReq.data(), m_sWriteReq.size(), "offset", pcValue, uiLen, 4096));
+	EXPECT_EQ("1.5", std::string(pcValue, uiLen));
+}
+
+/**
+ * Test case to check if CJsonKeyScanner::find() reports missing key, scan limit and malformed JSON
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(JsonEnvelopeTranscoder_ut, keyScanner_NotFoundOrMalformed)
+{
+	const char *pcValue = NULL;
+	size_t uiLen = 0;
+	auto find = [&](const std::string &a_sJson, size_t a_uiMaxScan)
+	{
+		return CJsonKeyScanner::find(a_sJson.data(), a_sJson.size(), "realtime", pcValue, uiLen, a_uiMaxScan);
+	};
+	EXPECT_EQ(JSON_KEY_NOT_FOUND, find("{}", 4096));
+	EXPECT_EQ(JSON_KEY_NOT_FOUND, find("{\"a\":{\"realtime\":\"1\"}}", 4096));
+	EXPECT_EQ(JSON_KEY_NOT_FOUND, find("{\"a\":\"xxxxxxxx\",\"realtime\":\"1\"}", 10));
+
+	EXPECT_EQ(JSON_KEY_MALFORMED, find("InvMsg", 4096));
+	EXPECT_EQ(JSON_KEY_MALFORMED, find("[{\"realtime\":\"1\"}]", 4096));
+	EXPECT_EQ(JSON_KEY_MALFORMED, find("{\"a\":\"1\"", 4096));
+	EXPECT_EQ(JSON_KEY_MALFORMED, find("{\"a\" \"1\"}", 4096));
+	EXPECT_EQ(JSON_KEY_MALFORMED, find("{\"realtime\":\"1", 4096));
+	EXPECT_EQ(JSON_KEY_MALFORMED, find("{\"a\":,\"realtime\":\"1\"}", 4096));
+}
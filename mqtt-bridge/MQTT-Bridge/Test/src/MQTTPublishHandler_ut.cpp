@@ -65,3 +65,21 @@ TEST_F(MQTTPublishHandler_ut, createNPubMsg_ValidTopic_ValidMsg)
 	CMQTTPublishHandler mqttPublisher_ut("tcp://mqtt_test_container:11883", ValidTopic, 1);
 	EXPECT_EQ( true, mqttPublisher_ut.createNPubMsg(ValidMsg, ValidTopic) );
 }
+
+/**
+ * Test case to check that createNPubMsg() fills reserved timestamp slot in place
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(MQTTPublishHandler_ut, createNPubMsg_TimestampSlot)
+{
+	CMQTTPublishHandler mqttPublisher_ut("tcp://mqtt_test_container:11883", ValidTopic, 1);
+	std::string sMsg = "{\"value\": \"0x00\",\"tsMsgReadyForPublish\":\"" TS_SLOT_PLACEHOLDER "\"}";
+	size_t uiSize = sMsg.size();
+
+	EXPECT_EQ( enTS_CARRIER_SLOT, mqttPublisher_ut.getTsMode() );
+	EXPECT_EQ( true, mqttPublisher_ut.createNPubMsg(sMsg, ValidTopic) );
+	EXPECT_EQ( uiSize, sMsg.size() );
+	EXPECT_EQ( std::string::npos, sMsg.find(TS_SLOT_PLACEHOLDER) );
+}
@@ -116,3 +116,88 @@ TEST_F(MQTTSubscribeHandler_ut, recvdMsg_NonRTPayLoad_read)
 	CMQTTHandler::instance().msgRcvd(recvdMsg);
 
 }
+
+/**
+ * Test case to check if parseMQTTMsg() reads "realtime" flag and uses default value otherwise
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(MQTTSubscribeHandler_ut, parseMQTTMsg_RealtimeFlag)
+{
+	bool isRealtime = false;
+	EXPECT_EQ(true, CMQTTHandler::parseMQTTMsg("{\"value\": \"0x00\",\"realtime\":\"1\"}", isRealtime, false));
+	EXPECT_EQ(true, isRealtime);
+	EXPECT_EQ(true, CMQTTHandler::parseMQTTMsg("{\"value\": \"0x00\",\"realtime\":\"0\"}", isRealtime, true));
+	EXPECT_EQ(false, isRealtime);
+	EXPECT_EQ(true, CMQTTHandler::parseMQTTMsg("{\"value\": \"0x00\",\"realtime\":1}", isRealtime, true));
+	EXPECT_EQ(true, isRealtime);
+	EXPECT_EQ(true, CMQTTHandler::parseMQTTMsg("{\"value\": \"0x00\"}", isRealtime, false));
+	EXPECT_EQ(false, isRealtime);
+}
+
+/**
+ * Test case to check if parseMQTTMsg() returns false with default value for payload which is not JSON object
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(MQTTSubscribeHandler_ut, parseMQTTMsg_InvMsg)
+{
+	bool isRealtime = false;
+	EXPECT_EQ(false, CMQTTHandler::parseMQTTMsg("InvMsg", isRealtime, true));
+	EXPECT_EQ(true, isRealtime);
+}
+
+/**
+ * Test case to check if CTopicRouteTable finds configured topics
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(MQTTSubscribeHandler_ut, topicRouteTable_lookup)
+{
+	CTopicRouteTable oTable;
+	oTable.addTopics("/flowmeter/PL0/D1/write, /flowmeter/PL0/D2/read,", true);
+	oTable.addTopics("/flowmeter/PL0/D3/read,/flowmeter/PL0/D1/write", false);
+	EXPECT_EQ((size_t)3, oTable.size());
+
+	bool isRealtime = false;
+	EXPECT_EQ(true, oTable.lookup("/flowmeter/PL0/D1/write", isRealtime));
+	EXPECT_EQ(true, isRealtime);
+	EXPECT_EQ(true, oTable.lookup("/flowmeter/PL0/D3/read", isRealtime));
+	EXPECT_EQ(false, isRealtime);
+	EXPECT_EQ(false, oTable.lookup("/flowmeter/PL0/D4/read", isRealtime));
+}
+
+/**
+ * Test case to check if message whose payload is not JSON is pushed in queue to be rejected by worker thread
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(MQTTSubscribeHandler_ut, recvdMsg_InvPayload_Deferred)
+{
+	size_t uiPending = CEMBWorkerPool::getInstance().getPendingCount();
+
+	mqtt::const_message_ptr recvdMsg = mqtt::make_message("MQTT_Export_WrReq/write", "InvMsg");
+	CMQTTHandler::instance().msgRcvd(recvdMsg);
+
+	EXPECT_EQ(uiPending + 1, CEMBWorkerPool::getInstance().getPendingCount());
+}
+
+/**
+ * Test case to check if checkRequestTTL() lets an old request through when TTL is not configured
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(MQTTSubscribeHandler_ut, checkRequestTTL_Disabled)
+{
+	CMessageObject oMsg{"MQTT_Export_RdReq/read",
+		"{\"wellhead\": \"PL0\",\"command\": \"Flow\",\"app_seq\": \"1\",\"usec\": \"1\"}"};
+	uint64_t ui64Expired = CRequestTTL::getInstance().getExpiredCount(enREQ_TTL_AT_ADMISSION);
+
+	EXPECT_EQ(true, CMQTTHandler::checkRequestTTL(oMsg, false, enREQ_TTL_AT_ADMISSION));
+	EXPECT_EQ(ui64Expired, CRequestTTL::getInstance().getExpiredCount(enREQ_TTL_AT_ADMISSION));
+}
@@ -70,7 +70,7 @@ TEST_F(Main_ut, processMsgToSendOnEII_ValidTopic)
 
 	CMessageObject Temp(recvdMsg);
 	const bool isRealtime = false;
-	processMsgToSendOnEII(Temp, isRealtime);
+	processMsgToSendOnEII(Temp, isRealtime, CEMBWorkerPool::getInstance().getWorker(0));
 
 }
 
@@ -177,51 +177,15 @@ TEST_F(Main_ut, set_thread_priority_for_eii_NonRTWrite)
 }
 
 /**
- * Test case to check code doesnt hang in getRTRead() function
+ * Test case to check code doesnt hang in postMsgsToEII() function
  * @param :[in] None
  * @param :[out] None
  * @return None
  */
-TEST_F(Main_ut, postMsgsToEII_RTRead)
+TEST_F(Main_ut, postMsgsToEII_Stop)
 {
 	g_shouldStop = true;
-	postMsgsToEII(QMgr::getRTRead());
-}
-
-/**
- * Test case to check code doesnt hang in getRTWrite() function
- * @param :[in] None
- * @param :[out] None
- * @return None
- */
-TEST_F(Main_ut, postMsgsToEII_RTWrite)
-{
-	g_shouldStop = true;
-	postMsgsToEII(QMgr::getRTWrite());
-}
-
-/**
- * Test case to check if getRead()function return reference of on-demand read operation instance successfully
- * @param :[in] None
- * @param :[out] None
- * @return None
- */
-TEST_F(Main_ut, postMsgsToEII_Read)
-{
-	g_shouldStop = true;
-	postMsgsToEII(QMgr::getRead());
-}
-
-/**
- * Test case to check if getWrite()function return reference of on-demand write operation instance successfully
- * @param :[in] None
- * @param :[out] None
- * @return None
- */
-TEST_F(Main_ut, postMsgsToEII_Write)
-{
-	g_shouldStop = true;
-	postMsgsToEII(QMgr::getWrite());
+	postMsgsToEII(CEMBWorkerPool::getInstance().getWorker(0));
 }
 
 /**
@@ -0,0 +1,168 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/RequestScheduler_ut.hpp"
+#include <thread>
+
+void RequestScheduler_ut::SetUp()
+{
+	m_stConfig.m_uiBatchSize = 2;
+	m_stConfig.m_uiStatsIntervalSec = 0;
+	m_bStop = false;
+}
+
+void RequestScheduler_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**
+ * Test case to check if real-time requests are given before non-real-time requests, in batches of a class
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(RequestScheduler_ut, nextBatch_StrictPriority)
+{
+	CRequestScheduler oScheduler(m_stConfig);
+	CMessageObject oRead("/flowmeter/PL0/D1/read", "{}");
+	CMessageObject oWrite("/flowmeter/PL0/D1/write", "{}");
+
+	EXPECT_EQ(true, oScheduler.submit(oRead, false, false));
+	EXPECT_EQ(true, oScheduler.submit(oWrite, false, true));
+	EXPECT_EQ(true, oScheduler.submit(oRead, true, false));
+	EXPECT_EQ(true, oScheduler.submit(oRead, true, false));
+	EXPECT_EQ(true, oScheduler.submit(oRead, true, false));
+	EXPECT_EQ(true, oScheduler.submit(oWrite, true, true));
+	EXPECT_EQ((size_t)6, oScheduler.getPendingCount());
+
+	std::vector<CMessageObject> vBatch;
+	eReqClass eClass = REQ_CLASS_MAX;
+	EXPECT_EQ((size_t)1, oScheduler.nextBatch(vBatch, eClass, m_bStop));
+	EXPECT_EQ(REQ_CLASS_RT_WRITE, eClass);
+	EXPECT_EQ((size_t)2, oScheduler.nextBatch(vBatch, eClass, m_bStop));
+	EXPECT_EQ(REQ_CLASS_RT_READ, eClass);
+
+	// real-time request arriving later is given before pending non-real-time requests
+	EXPECT_EQ(true, oScheduler.submit(oWrite, true, true));
+	EXPECT_EQ((size_t)1, oScheduler.nextBatch(vBatch, eClass, m_bStop));
+	EXPECT_EQ(REQ_CLASS_RT_WRITE, eClass);
+
+	EXPECT_EQ((size_t)1, oScheduler.nextBatch(vBatch, eClass, m_bStop));
+	EXPECT_EQ(REQ_CLASS_RT_READ, eClass);
+	EXPECT_EQ((size_t)1, oScheduler.nextBatch(vBatch, eClass, m_bStop));
+	EXPECT_EQ(REQ_CLASS_NON_RT_WRITE, eClass);
+	EXPECT_EQ("/flowmeter/PL0/D1/write", vBatch[0].getTopic());
+	EXPECT_EQ((size_t)1, oScheduler.nextBatch(vBatch, eClass, m_bStop));
+	EXPECT_EQ(REQ_CLASS_NON_RT_READ, eClass);
+	EXPECT_EQ((size_t)0, oScheduler.getPendingCount());
+
+	EXPECT_EQ((uint64_t)2, oScheduler.getStats(REQ_CLASS_RT_WRITE).m_ui64Dispatched);
+	EXPECT_EQ((uint64_t)3, oScheduler.getStats(REQ_CLASS_RT_READ).m_ui64Queued);
+}
+
+/**
+ * Test case to check if non-real-time requests are dropped once deadline has passed and real-time requests are not
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(RequestScheduler_ut, nextBatch_DropExpiredNonRT)
+{
+	m_stConfig.m_uiRTDeadlineMs = 1;
+	m_stConfig.m_uiNonRTDeadlineMs = 1;
+	CRequestScheduler oScheduler(m_stConfig);
+	std::vector<std::string> vExpiredTopics;
+	oScheduler.setExpiredHandler([&vExpiredTopics](CMessageObject &a_oMsg)
+	{
+		vExpiredTopics.push_back(a_oMsg.getTopic());
+	});
+	CMessageObject oRead("/flowmeter/PL0/D1/read", "{}");
+
+	EXPECT_EQ(true, oScheduler.submit(oRead, false, false));
+	EXPECT_EQ(true, oScheduler.submit(oRead, false, false));
+	EXPECT_EQ(true, oScheduler.submit(oRead, true, false));
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	CMessageObject oFreshRead("/flowmeter/PL0/D2/read", "{}");
+	EXPECT_EQ(true, oScheduler.submit(oFreshRead, false, false));
+
+	std::vector<CMessageObject> vBatch;
+	eReqClass eClass = REQ_CLASS_MAX;
+	EXPECT_EQ((size_t)1, oScheduler.nextBatch(vBatch, eClass, m_bStop));
+	EXPECT_EQ(REQ_CLASS_RT_READ, eClass);
+	EXPECT_EQ((size_t)1, oScheduler.nextBatch(vBatch, eClass, m_bStop));
+	EXPECT_EQ(REQ_CLASS_NON_RT_READ, eClass);
+	EXPECT_EQ("/flowmeter/PL0/D2/read", vBatch[0].getTopic());
+
+	stReqClassStats stRTStats = oScheduler.getStats(REQ_CLASS_RT_READ);
+	EXPECT_EQ((uint64_t)1, stRTStats.m_ui64DeadlineMissed);
+	EXPECT_EQ((uint64_t)0, stRTStats.m_ui64Expired);
+	stReqClassStats stStats = oScheduler.getStats(REQ_CLASS_NON_RT_READ);
+	EXPECT_EQ((uint64_t)2, stStats.m_ui64Expired);
+	EXPECT_EQ((uint64_t)1, stStats.m_ui64Dispatched);
+	// dropped requests are given to handler so that requester is answered
+	ASSERT_EQ((size_t)2, vExpiredTopics.size());
+	EXPECT_EQ("/flowmeter/PL0/D1/read", vExpiredTopics[0]);
+}
+
+/**
+ * Test case to check if waiting thread returns when scheduler is stopped and new requests are rejected
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(RequestScheduler_ut, stop_WakesWaitingThread)
+{
+	CRequestScheduler oScheduler(m_stConfig);
+	size_t uiCount = 1;
+	std::thread thWaiter([&]()
+	{
+		std::vector<CMessageObject> vBatch;
+		eReqClass eClass = REQ_CLASS_MAX;
+		uiCount = oScheduler.nextBatch(vBatch, eClass, m_bStop);
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	oScheduler.stop();
+	thWaiter.join();
+	EXPECT_EQ((size_t)0, uiCount);
+
+	CMessageObject oRead("/flowmeter/PL0/D1/read", "{}");
+	EXPECT_EQ(false, oScheduler.submit(oRead, true, false));
+}
+
+/**
+ * Test case to check percentile of queueing delay histogram
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(RequestScheduler_ut, stats_DelayPercentile)
+{
+	stReqClassStats stStats;
+	EXPECT_EQ((uint64_t)0, stStats.getDelayPercentileUs(99));
+
+	stStats.m_aui64DelayHist[4] = 99; // delays below 16 us
+	stStats.m_aui64DelayHist[11] = 1; // delays below 2048 us
+	stStats.m_ui64MaxDelayUs = 1500;
+	EXPECT_EQ((uint64_t)16, stStats.getDelayPercentileUs(50));
+	EXPECT_EQ((uint64_t)1500, stStats.getDelayPercentileUs(99.9));
+}
@@ -0,0 +1,133 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/**
+ * File contains the class CEIIListenerPool which receives messages from a group of EII topics
+ * in one poller thread and hands them over to a small pool of workers publishing on MQTT
+ */
+
+#ifndef EII_LISTENER_POOL_HPP_
+#define EII_LISTENER_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ZmqHandler.hpp"
+#include "ConfigManager.hpp"
+#include "MQTTPublishHandler.hpp"
+
+/** Default number of worker threads of a listener pool */
+#define EII_LISTENER_DEFAULT_WORKERS 4
+/** Default number of MQTT connections shared by workers of a listener pool */
+#define EII_LISTENER_DEFAULT_PUBLISHERS 2
+/** Default number of messages queued per worker */
+#define EII_LISTENER_DEFAULT_QUEUE_DEPTH 1000
+/** Default max time in micro seconds poller sleeps when no message is available */
+#define EII_LISTENER_DEFAULT_MAX_IDLE_US 500
+/** Time in micro seconds poller sleeps first when no message is available; doubled up to max */
+#define EII_LISTENER_MIN_IDLE_US 10
+
+/** Callback to process a message received from EII and publish it on MQTT */
+typedef std::function<bool(msg_envelope_t *a_pMsg, CMQTTPublishHandler &a_mqttPublisher)> eii_msg_handler;
+/** Function receiving a message from EII without blocking, as msgbus_recv_nowait() */
+typedef std::function<msgbus_ret_t(void *a_pMsgbusCtx, recv_ctx_t *a_pSubCtx, msg_envelope_t **a_ppMsg)> eii_recv_fn;
+
+/** Pool configuration */
+struct stListenerPoolConfig
+{
+	size_t m_uiWorkers = EII_LISTENER_DEFAULT_WORKERS; /** number of worker threads*/
+	size_t m_uiPublishers = EII_LISTENER_DEFAULT_PUBLISHERS; /** number of MQTT connections*/
+	size_t m_uiQueueDepth = EII_LISTENER_DEFAULT_QUEUE_DEPTH; /** max messages queued per worker*/
+	uint32_t m_uiMaxIdleUs = EII_LISTENER_DEFAULT_MAX_IDLE_US; /** max sleep of poller when idle*/
+};
+
+/**
+ * CEIIListenerPool receives messages from all EII topics having same operation settings.
+ * A single poller thread checks all subscriber contexts in turn and queues messages to
+ * workers. Each topic is always given to same worker, so messages of a topic are published
+ * in order. Workers share a bounded number of MQTT publisher connections.
+ */
+class CEIIListenerPool
+{
+	/** EII topic handled by pool */
+	struct stListenerTopic
+	{
+		std::string m_sTopic; /** EII topic*/
+		void *m_pMsgbusCtx; /** msg bus context*/
+		recv_ctx_t *m_pSubCtx; /** subscriber context*/
+		size_t m_uiWorker; /** index of worker handling this topic*/
+	};
+
+	/** Worker thread and its queue */
+	struct stWorker
+	{
+		std::mutex m_mutexQ; /** protects queue*/
+		std::condition_variable m_cvQ; /** signalled when a message is queued*/
+		std::deque<msg_envelope_t*> m_dqMsgs; /** received messages*/
+		size_t m_uiPublisher; /** index of MQTT publisher used by worker*/
+		std::thread m_thWorker; /** worker thread*/
+	};
+
+	std::string m_sName; /** pool name, used in logs and MQTT client ids*/
+	globalConfig::COperation m_objOperation; /** operation settings of all topics of pool*/
+	stListenerPoolConfig m_stConfig; /** pool configuration*/
+	eii_msg_handler m_fcbHandler; /** processes a received message*/
+	eii_recv_fn m_fcbRecv; /** receives a message from EII*/
+	std::vector<stListenerTopic> m_vTopics; /** topics handled by pool*/
+	std::vector<std::unique_ptr<stWorker>> m_vWorkers; /** workers*/
+	std::vector<std::unique_ptr<CMQTTPublishHandler>> m_vPublishers; /** MQTT publishers*/
+	std::atomic<bool> m_bStopWorkers; /** signals workers to stop*/
+
+	CEIIListenerPool(const CEIIListenerPool&) = delete;
+	CEIIListenerPool& operator=(const CEIIListenerPool&) = delete;
+
+	void startWorkers();
+	void stopWorkers();
+	void workerThread(stWorker &a_stWorker);
+	bool pollOnce();
+
+	friend class EIIListenerPool_ut;
+
+public:
+	CEIIListenerPool(const std::string &a_sName, const globalConfig::COperation &a_objOperation,
+			const stListenerPoolConfig &a_stConfig, const eii_msg_handler &a_fcbHandler);
+	~CEIIListenerPool();
+
+	bool addTopic(const std::string &a_sTopic, void *a_pMsgbusCtx, recv_ctx_t *a_pSubCtx);
+	void run(const std::atomic<bool> &a_bStop);
+
+	/** Returns number of topics handled by pool */
+	size_t getTopicCount() const
+	{
+		return m_vTopics.size();
+	}
+
+	static stListenerPoolConfig readConfig();
+};
+
+#endif
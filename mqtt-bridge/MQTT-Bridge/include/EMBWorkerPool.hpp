@@ -0,0 +1,126 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/**
+ * File contains the class CEMBWorkerPool which spreads on-demand requests received from MQTT
+ * over workers sending them on EII. Requests of a device always go to the same worker.
+ */
+
+#ifndef EMB_WORKER_POOL_HPP_
+#define EMB_WORKER_POOL_HPP_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RequestScheduler.hpp"
+
+namespace zmq_handler
+{
+	struct stZmqContext;
+}
+
+/** Number of trailing topic levels (point and operation) not used to find device of a request */
+#define EMB_WORKER_KEY_SKIP_LEVELS 2
+
+/** Handles of an EMB publisher, looked up once by a worker */
+struct stEMBPublisher
+{
+	zmq_handler::stZmqContext *m_pMsgbusCtx; /** msgbus context of EMB topic*/
+	void *m_pPubCtx; /** publisher context of EMB topic*/
+};
+
+/**
+ * CEMBWorker holds queue of requests of devices assigned to a worker thread and
+ * EMB publishers used by that thread. Publishers are used only by owning thread,
+ * so lock of a publisher is never contended.
+ */
+class CEMBWorker
+{
+	size_t m_uiIndex; /** index of worker in pool*/
+	CRequestScheduler m_scheduler; /** requests of devices of this worker*/
+	std::unordered_map<std::string, stEMBPublisher> m_mapPublishers; /** EMB publishers by EMB topic*/
+
+	CEMBWorker(const CEMBWorker&) = delete;
+	CEMBWorker& operator=(const CEMBWorker&) = delete;
+
+public:
+	CEMBWorker(size_t a_uiIndex, const stReqSchedulerConfig &a_stConfig);
+
+	bool getPublisher(const std::string &a_sEMBTopic, stEMBPublisher &a_stPublisher);
+
+	/** Returns index of worker in pool */
+	size_t getIndex() const
+	{
+		return m_uiIndex;
+	}
+
+	/** Returns scheduler having requests of this worker */
+	CRequestScheduler& getScheduler()
+	{
+		return m_scheduler;
+	}
+
+	/** Returns number of EMB publishers looked up by this worker */
+	size_t getPublisherCount() const
+	{
+		return m_mapPublishers.size();
+	}
+};
+
+/**
+ * CEMBWorkerPool routes a request to worker selected by hash of device part of its topic,
+ * e.g. "/flowmeter/PL0" of "/flowmeter/PL0/D1/write". Order of requests of a device, within
+ * a request class, is kept and a slow device holds up only devices of its own worker.
+ */
+class CEMBWorkerPool
+{
+	std::vector<std::unique_ptr<CEMBWorker>> m_vWorkers; /** workers*/
+
+	CEMBWorkerPool(const CEMBWorkerPool&) = delete;
+	CEMBWorkerPool& operator=(const CEMBWorkerPool&) = delete;
+
+public:
+	explicit CEMBWorkerPool(const stReqSchedulerConfig &a_stConfig);
+
+	static CEMBWorkerPool& getInstance();
+	static std::string getDeviceKey(const std::string &a_sTopic);
+
+	size_t getWorkerIndex(const std::string &a_sTopic) const;
+	bool submit(CMessageObject &a_oMsg, bool a_bIsRealtime, bool a_bIsWrite);
+	void stop();
+	size_t getPendingCount();
+
+	/** Returns number of workers */
+	size_t getWorkerCount() const
+	{
+		return m_vWorkers.size();
+	}
+
+	/** Returns worker at given index */
+	CEMBWorker& getWorker(size_t a_uiIndex)
+	{
+		return *m_vWorkers.at(a_uiIndex);
+	}
+};
+
+#endif
@@ -0,0 +1,137 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/**
+ * File contains a SAX style JSON tokenizer, the class CJsonEnvelopeTranscoder which converts
+ * JSON received from MQTT into EII message envelope in a single pass and the class
+ * CJsonKeyScanner which looks up a top level key without parsing whole JSON
+ */
+
+#ifndef JSON_ENVELOPE_TRANSCODER_HPP_
+#define JSON_ENVELOPE_TRANSCODER_HPP_
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include "ZmqHandler.hpp"
+
+/** Max nesting depth accepted by tokenizer */
+#define JSON_TOKENIZER_MAX_DEPTH 64
+
+/**
+ * Receiver of events generated by CJsonTokenizer. Returning false from a
+ * function stops tokenizing. Strings are not NUL terminated.
+ */
+class CJsonSaxHandler
+{
+public:
+	virtual ~CJsonSaxHandler() {}
+
+	virtual bool onStartObject() { return true; }
+	virtual bool onEndObject() { return true; }
+	virtual bool onStartArray() { return true; }
+	virtual bool onEndArray() { return true; }
+	virtual bool onKey(const char *a_pcKey, size_t a_uiLen) { return true; }
+	virtual bool onString(const char *a_pcValue, size_t a_uiLen) { return true; }
+	virtual bool onInteger(int64_t a_i64Value) { return true; }
+	virtual bool onDouble(double a_dValue) { return true; }
+	virtual bool onBool(bool a_bValue) { return true; }
+	virtual bool onNull() { return true; }
+};
+
+/**
+ * Single pass JSON tokenizer. Input is validated while events are reported to handler;
+ * no document tree is built. Numbers without fraction and exponent which fit in
+ * 64 bits are reported as integers.
+ */
+class CJsonTokenizer
+{
+	const char *m_pcBegin; /** start of input*/
+	const char *m_pcCur; /** current position*/
+	const char *m_pcEnd; /** end of input*/
+	CJsonSaxHandler &m_handler; /** receiver of events*/
+	std::string m_sScratch; /** unescaped string*/
+	std::string m_sError; /** description of error*/
+
+	void skipWhitespace();
+	bool parseValue(int a_iDepth);
+	bool parseObject(int a_iDepth);
+	bool parseArray(int a_iDepth);
+	bool parseString(const char *&a_pcStr, size_t &a_uiLen);
+	bool parseNumber();
+	bool parseLiteral(const char *a_pcLiteral, size_t a_uiLen);
+	bool setError(const char *a_pcError);
+
+public:
+	explicit CJsonTokenizer(CJsonSaxHandler &a_handler) : m_pcBegin{NULL}, m_pcCur{NULL}, m_pcEnd{NULL}, m_handler(a_handler) {}
+
+	bool parse(const char *a_pcJson, size_t a_uiLen);
+
+	/** Returns description of last error */
+	const std::string& getError() const
+	{
+		return m_sError;
+	}
+};
+
+/**
+ * Converts a flat JSON object into EII message envelope in a single pass.
+ * Strings and booleans keep their type, integral numbers become integers and
+ * other numbers floating values. Additional string fields, e.g. timestamps,
+ * are added in the same pass.
+ */
+class CJsonEnvelopeTranscoder
+{
+public:
+	static msg_envelope_t* transcode(const std::string &a_sJson,
+			const std::vector<std::pair<std::string, std::string>> &a_vExtraFields,
+			std::string &a_sError);
+	static bool appendStringField(std::string &a_sJson, const std::string &a_sKey, const std::string &a_sValue);
+	static void appendJsonString(std::string &a_sOut, const std::string &a_sValue);
+};
+
+/** Result of looking up a key with CJsonKeyScanner */
+enum eJsonKeyScanResult
+{
+	JSON_KEY_FOUND,
+	JSON_KEY_NOT_FOUND,
+	JSON_KEY_MALFORMED
+};
+
+/**
+ * Looks up a top level key of a JSON object without allocating memory or building a
+ * document tree. Values of other keys are skipped without being validated; scanning
+ * stops at the key, at end of object or after a bounded number of bytes.
+ */
+class CJsonKeyScanner
+{
+	static const char* skipWhitespace(const char *a_pcCur, const char *a_pcEnd);
+	static const char* skipString(const char *a_pcCur, const char *a_pcEnd, bool &a_bHasEscape);
+	static const char* skipValue(const char *a_pcCur, const char *a_pcEnd);
+
+public:
+	static eJsonKeyScanResult find(const char *a_pcJson, size_t a_uiLen, const char *a_pcKey,
+			const char *&a_pcValue, size_t &a_uiValueLen, size_t a_uiMaxScan);
+};
+
+#endif
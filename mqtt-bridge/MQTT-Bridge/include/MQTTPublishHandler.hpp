@@ -28,17 +28,30 @@
 #define MQTT_PUBLISH_HANDLER_HPP_
 
 #include "MQTTPubSubClient.hpp"
+#include "TimestampCarrier.hpp"
 
 /**
  * CMQTTPublishHandler class manages instance that handles Publish message on MQTT broker
  */
 class CMQTTPublishHandler : public CMQTTBaseHandler
 {
+	eTsCarrierMode m_eTsMode; /** how latency timestamps are carried with message*/
+
+	void initOutbox(const std::string &a_sClientID);
+	static stMQTTv5Config getV5Config();
+	static eTsCarrierMode getTsCarrierMode();
+
 public:
 	CMQTTPublishHandler(std::string strPlBusUrl, std::string strClientID, int iQOS);
 	~CMQTTPublishHandler();
 
-	bool createNPubMsg(std::string &a_sMsg, std::string &a_sTopic);
+	bool createNPubMsg(std::string &a_sMsg, std::string &a_sTopic, uint64_t a_ui64RcvdUs = 0);
+
+	/** Returns how latency timestamps are carried with message */
+	eTsCarrierMode getTsMode() const
+	{
+		return m_eTsMode;
+	}
 };
 
 #endif
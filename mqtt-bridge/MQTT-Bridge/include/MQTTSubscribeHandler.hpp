@@ -31,8 +31,33 @@
 #include "Common.hpp"
 #include <semaphore.h>
 #include <string>
+#include <unordered_map>
 #include "mqtt/async_client.h"
 #include "MQTTPubSubClient.hpp"
+#include "QueueHandler.hpp"
+#include "RequestTTL.hpp"
+
+/** Max number of payload bytes scanned for key "realtime" */
+#define REALTIME_KEY_SCAN_LIMIT 4096
+
+/**
+ * Table of MQTT topics whose requests are routed to RT or non-RT queue without
+ * inspecting payload. Table is built once at start-up and is read-only afterwards.
+ */
+class CTopicRouteTable
+{
+	std::unordered_map<std::string, bool> m_mapTopicToRT; /*!< topic to real-time flag*/
+
+public:
+	void addTopics(const std::string &a_sTopicList, bool a_bIsRealtime);
+	bool lookup(const std::string &a_sTopic, bool &a_bIsRealtime) const;
+
+	/** Returns number of topics in table */
+	size_t size() const
+	{
+		return m_mapTopicToRT.size();
+	}
+};
 
 /**
  * MQTT Handler class to manage instance of MQTT connection
@@ -40,6 +65,7 @@
 class CMQTTHandler : public CMQTTBaseHandler
 {
 	sem_t m_semConnSuccess; /*!< an instance of semaphore */
+	CTopicRouteTable m_oRouteTable; /*!< topics routed without inspecting payload */
 
 	CMQTTHandler(const std::string &strPlBusUrl, int iQOS);
 
@@ -53,10 +79,12 @@ class CMQTTHandler : public CMQTTBaseHandler
 	void handleConnSuccessThread();
 	void signalIntMQTTConnDoneThread();
 
-	bool parseMQTTMsg(const std::string &sJson, bool &isRealtime, const bool bIsDefault);
-
 	bool pushMsgInQ(mqtt::const_message_ptr& msg);
 
+	static stMQTTv5Config getV5Config();
+	static std::string getStringField(const std::string &a_sJson, const char *a_pcKey);
+	static std::string createExpiredResponse(CMessageObject &a_oMsg, bool a_bIsRealtime);
+
 public:
 	~CMQTTHandler();
 	static CMQTTHandler& instance(); //function to get single instance of this class
@@ -65,6 +93,10 @@ public:
 	void msgRcvd(mqtt::const_message_ptr a_pMsg) override;
 
 	void cleanup();
+
+	static bool parseMQTTMsg(const std::string &sJson, bool &isRealtime, const bool bIsDefault);
+	static bool checkRequestTTL(CMessageObject &a_oMsg, bool a_bIsRealtime, eReqTTLStage a_eStage);
+	static void publishExpiredResponse(CMessageObject &a_oMsg, bool a_bIsRealtime);
 };
 
 #endif
@@ -0,0 +1,159 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/**
+ * File contains the class CRequestScheduler which queues on-demand requests received from MQTT
+ * in per-class queues and hands them over to threads sending them on EII in strict priority order
+ */
+
+#ifndef REQUEST_SCHEDULER_HPP_
+#define REQUEST_SCHEDULER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "QueueHandler.hpp"
+
+/** Default max number of requests of a class given to a thread at a time */
+#define REQ_SCHED_DEFAULT_BATCH_SIZE 8
+/** Default number of threads sending requests on EII; requests of a device are sent by one thread */
+#define REQ_SCHED_DEFAULT_WORKERS 2
+/** Default time in milliseconds within which a real-time request should be sent on EII */
+#define REQ_SCHED_DEFAULT_RT_DEADLINE_MS 100
+/** Default time in milliseconds after which a non-real-time request is dropped, 0 for none */
+#define REQ_SCHED_DEFAULT_NON_RT_DEADLINE_MS 0
+/** Default interval in seconds at which statistics are logged */
+#define REQ_SCHED_DEFAULT_STATS_INTERVAL_SEC 60
+/** Number of buckets of queueing delay histogram; bucket i counts delays below 2^i micro seconds */
+#define REQ_SCHED_DELAY_BUCKETS 32
+
+/** Request classes, in order of priority */
+enum eReqClass
+{
+	REQ_CLASS_RT_WRITE = 0,
+	REQ_CLASS_RT_READ,
+	REQ_CLASS_NON_RT_WRITE,
+	REQ_CLASS_NON_RT_READ,
+	REQ_CLASS_MAX
+};
+
+/** Scheduler configuration */
+struct stReqSchedulerConfig
+{
+	size_t m_uiBatchSize = REQ_SCHED_DEFAULT_BATCH_SIZE; /** max requests given to a thread at a time*/
+	size_t m_uiWorkers = REQ_SCHED_DEFAULT_WORKERS; /** number of threads sending requests on EII, each having own scheduler*/
+	uint32_t m_uiRTDeadlineMs = REQ_SCHED_DEFAULT_RT_DEADLINE_MS; /** deadline of RT requests, 0 for none*/
+	uint32_t m_uiNonRTDeadlineMs = REQ_SCHED_DEFAULT_NON_RT_DEADLINE_MS; /** deadline of non-RT requests, 0 for none*/
+	uint32_t m_uiStatsIntervalSec = REQ_SCHED_DEFAULT_STATS_INTERVAL_SEC; /** interval of statistics log, 0 for none*/
+};
+
+/** Statistics of a request class */
+struct stReqClassStats
+{
+	uint64_t m_ui64Queued = 0; /** requests queued*/
+	uint64_t m_ui64Dispatched = 0; /** requests given to threads*/
+	uint64_t m_ui64Expired = 0; /** non-RT requests dropped as deadline passed*/
+	uint64_t m_ui64DeadlineMissed = 0; /** RT requests dispatched after deadline*/
+	uint64_t m_ui64TotalDelayUs = 0; /** sum of queueing delay of dispatched requests*/
+	uint64_t m_ui64MaxDelayUs = 0; /** max queueing delay*/
+	uint64_t m_aui64DelayHist[REQ_SCHED_DELAY_BUCKETS] = {}; /** queueing delay histogram*/
+
+	uint64_t getDelayPercentileUs(double a_dPercentile) const;
+};
+
+/** Handler called for a non-real-time request dropped as its deadline has passed */
+typedef std::function<void(CMessageObject &a_oMsg)> req_expired_handler_t;
+
+/**
+ * CRequestScheduler holds on-demand requests in a queue per class. Threads take a batch
+ * of requests of highest priority class which has requests, so real-time requests wait
+ * at most for batches already given out. Each request gets a deadline from time at which
+ * it was received; non-real-time requests are dropped once their deadline has passed
+ * and given to expired request handler, so that requester can be answered.
+ */
+class CRequestScheduler
+{
+	/** Queued request */
+	struct stRequest
+	{
+		CMessageObject m_oMsg; /** request received from MQTT*/
+		uint64_t m_ui64RcvdUs; /** monotonic time at which request was received*/
+		uint64_t m_ui64DeadlineUs; /** monotonic time by which request should be sent, 0 for none*/
+	};
+
+	stReqSchedulerConfig m_stConfig; /** scheduler configuration*/
+	std::string m_sName; /** name used in logs*/
+	std::mutex m_mutexQ; /** protects queues and statistics*/
+	std::condition_variable m_cvQ; /** signalled when a request is queued*/
+	std::deque<stRequest> m_adqRequests[REQ_CLASS_MAX]; /** queue per class*/
+	stReqClassStats m_astStats[REQ_CLASS_MAX]; /** statistics per class*/
+	uint64_t m_ui64LastStatsLogUs; /** time at which statistics were last logged*/
+	bool m_bIsStopped; /** true once stop() is called*/
+	req_expired_handler_t m_fcbExpired; /** handler of dropped requests*/
+
+	CRequestScheduler(const CRequestScheduler&) = delete;
+	CRequestScheduler& operator=(const CRequestScheduler&) = delete;
+
+	void dropExpired(eReqClass a_eClass, uint64_t a_ui64NowUs, std::vector<CMessageObject> &a_vExpired);
+	void recordDelay(eReqClass a_eClass, const stRequest &a_stReq, uint64_t a_ui64NowUs);
+	void logStats(uint64_t a_ui64NowUs);
+
+public:
+	explicit CRequestScheduler(const stReqSchedulerConfig &a_stConfig, const std::string &a_sName = "");
+
+	static stReqSchedulerConfig readConfig();
+	static eReqClass getClass(bool a_bIsRealtime, bool a_bIsWrite);
+	static uint64_t getTimeUs(const struct timespec &a_stTs);
+
+	/** Returns true if requests of this class are real-time */
+	static bool isRealtimeClass(eReqClass a_eClass)
+	{
+		return (REQ_CLASS_RT_WRITE == a_eClass) || (REQ_CLASS_RT_READ == a_eClass);
+	}
+
+	/** Returns true if requests of this class are read requests */
+	static bool isReadClass(eReqClass a_eClass)
+	{
+		return (REQ_CLASS_RT_READ == a_eClass) || (REQ_CLASS_NON_RT_READ == a_eClass);
+	}
+
+	/** Returns scheduler configuration */
+	const stReqSchedulerConfig& getConfig() const
+	{
+		return m_stConfig;
+	}
+
+	void setExpiredHandler(const req_expired_handler_t &a_fcbExpired);
+	bool submit(CMessageObject &a_oMsg, bool a_bIsRealtime, bool a_bIsWrite);
+	size_t nextBatch(std::vector<CMessageObject> &a_vBatch, eReqClass &a_eClass,
+			const std::atomic<bool> &a_bStop);
+	void stop();
+	size_t getPendingCount();
+	stReqClassStats getStats(eReqClass a_eClass);
+};
+
+#endif
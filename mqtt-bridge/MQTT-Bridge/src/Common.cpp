@@ -25,6 +25,8 @@
 #include <cjson/cJSON.h>
 #include <algorithm>
 #include "EnvironmentVarHandler.hpp"
+#include "TimeFormatter.hpp"
+#include "JsonEnvelopeTranscoder.hpp"
 
 /**
  * Constructor initializes CCommon instance and retrieves common environment variables
@@ -93,7 +95,7 @@ void CCommon::getCurrentTimestampsInString(std::string &strCurTime)
 	{
 		struct timespec tsMsgReceived;
 		timespec_get(&tsMsgReceived, TIME_UTC);
-		strCurTime = std::to_string(get_micros(tsMsgReceived));
+		strCurTime = CTimeFormatter::microsToString(tsMsgReceived);
 	}
 	catch(std::exception &e)
 	{
@@ -111,53 +113,21 @@ void CCommon::getCurrentTimestampsInString(std::string &strCurTime)
  */
 bool CCommon::addTimestampsToMsg(std::string &a_sMsg, std::string tsKey, std::string strTimestamp)
 {
-	cJSON *root = NULL;
 	try
 	{
-		root = cJSON_Parse(a_sMsg.c_str());
-		if (NULL == root)
+		// field is inserted while JSON is validated in a single pass; no document tree is built
+		if(false == CJsonEnvelopeTranscoder::appendStringField(a_sMsg, tsKey, strTimestamp))
 		{
 			DO_LOG_ERROR("ZMQ Message could not be parsed in json format");
 			return false;
 		}
 
-		if(NULL == cJSON_AddStringToObject(root, tsKey.c_str(), strTimestamp.c_str()))
-		{
-			DO_LOG_ERROR("Could not add timestamp in message");
-			if(root != NULL)
-			{
-				cJSON_Delete(root);
-			}
-			return false;
-		}
-
-		a_sMsg.clear();
-		char *psNewJson = cJSON_Print(root);
-		if(NULL != psNewJson)
-		{
-			a_sMsg.assign(psNewJson);
-			free(psNewJson);
-			psNewJson = NULL;
-		}
-
-		if(root != NULL)
-		{
-			cJSON_Delete(root);
-		}
-
 		DO_LOG_DEBUG("Added timestamp in payload for MQTT");
 		return true;
-
 	}
 	catch (std::exception &ex)
 	{
 		DO_LOG_DEBUG("Failed to add timestamp in payload for MQTT" + std::string(ex.what()));
-
-		if(root != NULL)
-		{
-			cJSON_Delete(root);
-		}
-
 		return false;
 	}
 }
@@ -0,0 +1,269 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "EIIListenerPool.hpp"
+#include "EnvironmentVarHandler.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * Constructor
+ * @param a_sName :[in] pool name
+ * @param a_objOperation :[in] operation settings of topics of this pool
+ * @param a_stConfig :[in] pool configuration
+ * @param a_fcbHandler :[in] function to process a received message
+ */
+CEIIListenerPool::CEIIListenerPool(const std::string &a_sName, const globalConfig::COperation &a_objOperation,
+		const stListenerPoolConfig &a_stConfig, const eii_msg_handler &a_fcbHandler)
+	: m_sName{a_sName}, m_objOperation(a_objOperation), m_stConfig(a_stConfig), m_fcbHandler{a_fcbHandler},
+	  m_fcbRecv{msgbus_recv_nowait}, m_bStopWorkers{false}
+{
+	m_stConfig.m_uiWorkers = std::max(m_stConfig.m_uiWorkers, (size_t)1);
+	m_stConfig.m_uiPublishers = std::max(m_stConfig.m_uiPublishers, (size_t)1);
+	m_stConfig.m_uiQueueDepth = std::max(m_stConfig.m_uiQueueDepth, (size_t)1);
+	m_stConfig.m_uiMaxIdleUs = std::max(m_stConfig.m_uiMaxIdleUs, (uint32_t)EII_LISTENER_MIN_IDLE_US);
+}
+
+/**
+ * Destructor
+ */
+CEIIListenerPool::~CEIIListenerPool()
+{
+	stopWorkers();
+}
+
+/**
+ * Reads pool configuration from environment variables EII_LISTENER_WORKERS,
+ * MQTT_PUBLISHER_CONNECTIONS, EII_LISTENER_QUEUE_DEPTH and EII_POLL_MAX_IDLE_US
+ * @param None
+ * @return pool configuration; default value is used for a variable which is not set
+ */
+stListenerPoolConfig CEIIListenerPool::readConfig()
+{
+	stListenerPoolConfig stConfig;
+	stConfig.m_uiWorkers = EnvironmentInfo::getEnvNum("EII_LISTENER_WORKERS", EII_LISTENER_DEFAULT_WORKERS, 1);
+	stConfig.m_uiPublishers = EnvironmentInfo::getEnvNum("MQTT_PUBLISHER_CONNECTIONS", EII_LISTENER_DEFAULT_PUBLISHERS, 1);
+	stConfig.m_uiQueueDepth = EnvironmentInfo::getEnvNum("EII_LISTENER_QUEUE_DEPTH", EII_LISTENER_DEFAULT_QUEUE_DEPTH, 1);
+	stConfig.m_uiMaxIdleUs = (uint32_t)EnvironmentInfo::getEnvNum("EII_POLL_MAX_IDLE_US",
+			EII_LISTENER_DEFAULT_MAX_IDLE_US, 1, UINT32_MAX);
+	return stConfig;
+}
+
+/**
+ * Adds an EII topic to pool. To be called before run().
+ * @param a_sTopic :[in] EII topic
+ * @param a_pMsgbusCtx :[in] msg bus context
+ * @param a_pSubCtx :[in] subscriber context of topic
+ * @return true if topic is added
+ */
+bool CEIIListenerPool::addTopic(const std::string &a_sTopic, void *a_pMsgbusCtx, recv_ctx_t *a_pSubCtx)
+{
+	if((NULL == a_pMsgbusCtx) || (NULL == a_pSubCtx))
+	{
+		DO_LOG_ERROR("Cannot start listening on EII for topic : " + a_sTopic);
+		return false;
+	}
+	m_vTopics.push_back(stListenerTopic{a_sTopic, a_pMsgbusCtx, a_pSubCtx, 0});
+	return true;
+}
+
+/**
+ * Creates MQTT publishers and worker threads. Topics are given to workers in turn,
+ * so that each worker handles a fixed set of topics.
+ * @param None
+ * @return None
+ */
+void CEIIListenerPool::startWorkers()
+{
+	size_t uiWorkers = std::min(m_stConfig.m_uiWorkers, m_vTopics.size());
+	size_t uiPublishers = std::min(m_stConfig.m_uiPublishers, uiWorkers);
+	std::string sMqttUrl = EnvironmentInfo::getInstance().getDataFromEnvMap("MQTT_URL_FOR_EXPORT");
+
+	for(size_t i = 0; i < uiPublishers; ++i)
+	{
+		m_vPublishers.push_back(std::unique_ptr<CMQTTPublishHandler>(new CMQTTPublishHandler(
+				sMqttUrl, m_sName + "_pub" + std::to_string(i), m_objOperation.getQos())));
+	}
+	for(size_t i = 0; i < m_vTopics.size(); ++i)
+	{
+		m_vTopics[i].m_uiWorker = i % uiWorkers;
+	}
+
+	m_bStopWorkers.store(false);
+	for(size_t i = 0; i < uiWorkers; ++i)
+	{
+		m_vWorkers.push_back(std::unique_ptr<stWorker>(new stWorker()));
+		stWorker &stW = *m_vWorkers.back();
+		stW.m_uiPublisher = i % uiPublishers;
+		stW.m_thWorker = std::thread(&CEIIListenerPool::workerThread, this, std::ref(stW));
+	}
+	DO_LOG_INFO(m_sName + ": listening on " + std::to_string(m_vTopics.size()) + " EII topics using " +
+			std::to_string(uiWorkers) + " workers and " + std::to_string(uiPublishers) + " MQTT connections");
+}
+
+/**
+ * Stops worker threads. Messages still queued are discarded.
+ * @param None
+ * @return None
+ */
+void CEIIListenerPool::stopWorkers()
+{
+	m_bStopWorkers.store(true);
+	for(auto &pWorker : m_vWorkers)
+	{
+		{
+			std::lock_guard<std::mutex> lck(pWorker->m_mutexQ);
+		}
+		pWorker->m_cvQ.notify_all();
+		if(pWorker->m_thWorker.joinable())
+		{
+			pWorker->m_thWorker.join();
+		}
+		for(auto pMsg : pWorker->m_dqMsgs)
+		{
+			msgbus_msg_envelope_destroy(pMsg);
+		}
+		pWorker->m_dqMsgs.clear();
+	}
+	m_vWorkers.clear();
+	m_vPublishers.clear();
+}
+
+/**
+ * Worker thread function. Publishes queued messages in order on MQTT.
+ * @param a_stWorker :[in] worker
+ * @return None
+ */
+void CEIIListenerPool::workerThread(stWorker &a_stWorker)
+{
+	globalConfig::set_thread_sched_param(m_objOperation);
+	globalConfig::display_thread_sched_attr(m_sName + " EII worker");
+	CMQTTPublishHandler &mqttPublisher = *m_vPublishers[a_stWorker.m_uiPublisher];
+
+	while(false == m_bStopWorkers.load())
+	{
+		msg_envelope_t *pMsg = NULL;
+		{
+			std::unique_lock<std::mutex> lck(a_stWorker.m_mutexQ);
+			a_stWorker.m_cvQ.wait(lck, [this, &a_stWorker]() {
+				return m_bStopWorkers.load() || (false == a_stWorker.m_dqMsgs.empty());
+			});
+			if(a_stWorker.m_dqMsgs.empty())
+			{
+				continue;
+			}
+			pMsg = a_stWorker.m_dqMsgs.front();
+			a_stWorker.m_dqMsgs.pop_front();
+		}
+		try
+		{
+			// handler takes ownership of message
+			m_fcbHandler(pMsg, mqttPublisher);
+		}
+		catch(std::exception &ex)
+		{
+			DO_LOG_FATAL(std::string(ex.what()) + " for pool : " + m_sName);
+		}
+	}
+}
+
+/**
+ * Checks each topic once for a message without blocking and queues received messages
+ * to workers. A topic whose worker queue is full is skipped, so that its messages
+ * stay in EII socket and slow publishing of one topic does not hold up other topics.
+ * @param None
+ * @return true if any message is received
+ */
+bool CEIIListenerPool::pollOnce()
+{
+	bool bIsReceived = false;
+	for(auto &stTopic : m_vTopics)
+	{
+		stWorker &stW = *m_vWorkers[stTopic.m_uiWorker];
+		{
+			std::lock_guard<std::mutex> lck(stW.m_mutexQ);
+			if(stW.m_dqMsgs.size() >= m_stConfig.m_uiQueueDepth)
+			{
+				continue;
+			}
+		}
+
+		msg_envelope_t *pMsg = NULL;
+		msgbus_ret_t ret = m_fcbRecv(stTopic.m_pMsgbusCtx, stTopic.m_pSubCtx, &pMsg);
+		if(MSG_SUCCESS == ret)
+		{
+			{
+				std::lock_guard<std::mutex> lck(stW.m_mutexQ);
+				stW.m_dqMsgs.push_back(pMsg);
+			}
+			stW.m_cvQ.notify_one();
+			bIsReceived = true;
+		}
+		else if(MSG_RECV_NO_MESSAGE != ret)
+		{
+			DO_LOG_ERROR_RATELIMITED("EII receive failed", 10, 1000,
+					"Failed to receive message on " + stTopic.m_sTopic + ", errno: " + std::to_string(ret));
+		}
+	}
+	return bIsReceived;
+}
+
+/**
+ * Poller loop. Starts workers and receives messages from all topics of pool until
+ * stop is signalled. When no message is available poller sleeps, doubling sleep
+ * time up to configured max while idle.
+ * @param a_bStop :[in] signals poller to stop
+ * @return None
+ */
+void CEIIListenerPool::run(const std::atomic<bool> &a_bStop)
+{
+	if(m_vTopics.empty())
+	{
+		return;
+	}
+	try
+	{
+		globalConfig::set_thread_sched_param(m_objOperation);
+		globalConfig::display_thread_sched_attr(m_sName + " EII poller");
+		startWorkers();
+
+		uint32_t uiIdleUs = 0;
+		while(false == a_bStop.load())
+		{
+			if(pollOnce())
+			{
+				uiIdleUs = 0;
+				continue;
+			}
+			uiIdleUs = (0 == uiIdleUs) ? EII_LISTENER_MIN_IDLE_US : std::min(2 * uiIdleUs, m_stConfig.m_uiMaxIdleUs);
+			usleep(uiIdleUs);
+		}
+	}
+	catch(std::exception &ex)
+	{
+		DO_LOG_FATAL(std::string(ex.what()) + " for pool : " + m_sName);
+	}
+	stopWorkers();
+	DO_LOG_DEBUG(m_sName + " exited !!");
+}
@@ -0,0 +1,169 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "EMBWorkerPool.hpp"
+#include "ZmqHandler.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <functional>
+
+/**
+ * Constructor
+ * @param a_uiIndex :[in] index of worker in pool
+ * @param a_stConfig :[in] configuration of scheduler of worker
+ */
+CEMBWorker::CEMBWorker(size_t a_uiIndex, const stReqSchedulerConfig &a_stConfig)
+	: m_uiIndex{a_uiIndex}, m_scheduler(a_stConfig, "Worker " + std::to_string(a_uiIndex) + ": "), m_mapPublishers{}
+{
+}
+
+/**
+ * Gets EMB publisher of a topic. Context of topic is created if needed and is looked up
+ * in context maps only once; afterwards handles kept by worker are used.
+ * To be called only from thread of this worker.
+ * @param a_sEMBTopic :[in] EMB topic
+ * @param a_stPublisher :[out] publisher handles
+ * @return true if publisher is available, false otherwise
+ */
+bool CEMBWorker::getPublisher(const std::string &a_sEMBTopic, stEMBPublisher &a_stPublisher)
+{
+	auto itr = m_mapPublishers.find(a_sEMBTopic);
+	if(m_mapPublishers.end() != itr)
+	{
+		a_stPublisher = itr->second;
+		return true;
+	}
+
+	try
+	{
+		zmq_handler::prepareContext(true, (zmq_handler::getPubCtxCfg()).m_pub_msgbus_ctx, a_sEMBTopic, (zmq_handler::getPubCtxCfg()).m_pub_config);
+		if(false == zmq_handler::isPubTopicPresentInMap(a_sEMBTopic))
+		{
+			DO_LOG_ERROR("EMB publisher could not be created for topic: " + a_sEMBTopic);
+			return false;
+		}
+		stEMBPublisher stPublisher{&zmq_handler::getCTX(a_sEMBTopic), zmq_handler::getPubCTX(a_sEMBTopic).m_pContext};
+		m_mapPublishers.emplace(a_sEMBTopic, stPublisher);
+		a_stPublisher = stPublisher;
+		return true;
+	}
+	catch(const std::exception &e)
+	{
+		DO_LOG_ERROR(a_sEMBTopic + ": " + e.what());
+	}
+	return false;
+}
+
+/**
+ * Constructor. Creates MQTT_SCHED_WORKERS workers, each having its own scheduler.
+ * @param a_stConfig :[in] scheduler configuration
+ */
+CEMBWorkerPool::CEMBWorkerPool(const stReqSchedulerConfig &a_stConfig)
+{
+	size_t uiWorkers = std::max(a_stConfig.m_uiWorkers, (size_t)1);
+	for(size_t i = 0; i < uiWorkers; ++i)
+	{
+		m_vWorkers.push_back(std::unique_ptr<CEMBWorker>(new CEMBWorker(i, a_stConfig)));
+	}
+}
+
+/**
+ * Maintain single instance of this class
+ * @param None
+ * @return Reference of this instance of this class
+ */
+CEMBWorkerPool& CEMBWorkerPool::getInstance()
+{
+	static CEMBWorkerPool _self(CRequestScheduler::readConfig());
+	return _self;
+}
+
+/**
+ * Gets device part of a request topic i.e. topic without point and operation levels,
+ * e.g. "/flowmeter/PL0" for "/flowmeter/PL0/D1/write"
+ * @param a_sTopic :[in] request topic
+ * @return device part, whole topic if it has fewer levels
+ */
+std::string CEMBWorkerPool::getDeviceKey(const std::string &a_sTopic)
+{
+	size_t uiEnd = a_sTopic.size();
+	for(int i = 0; i < EMB_WORKER_KEY_SKIP_LEVELS; ++i)
+	{
+		size_t uiPos = (0 == uiEnd) ? std::string::npos : a_sTopic.find_last_of('/', uiEnd - 1);
+		if((std::string::npos == uiPos) || (0 == uiPos))
+		{
+			return a_sTopic;
+		}
+		uiEnd = uiPos;
+	}
+	return a_sTopic.substr(0, uiEnd);
+}
+
+/**
+ * Gets index of worker handling requests of topic
+ * @param a_sTopic :[in] request topic
+ * @return worker index
+ */
+size_t CEMBWorkerPool::getWorkerIndex(const std::string &a_sTopic) const
+{
+	return std::hash<std::string>()(getDeviceKey(a_sTopic)) % m_vWorkers.size();
+}
+
+/**
+ * Queues a request with worker of its device
+ * @param a_oMsg :[in] request received from MQTT
+ * @param a_bIsRealtime :[in] true for real-time request
+ * @param a_bIsWrite :[in] true for write request, false for read request
+ * @return true if request is queued, false if pool is stopped
+ */
+bool CEMBWorkerPool::submit(CMessageObject &a_oMsg, bool a_bIsRealtime, bool a_bIsWrite)
+{
+	return m_vWorkers[getWorkerIndex(a_oMsg.getTopic())]->getScheduler().submit(a_oMsg, a_bIsRealtime, a_bIsWrite);
+}
+
+/**
+ * Stops scheduler of all workers
+ * @param None
+ * @return None
+ */
+void CEMBWorkerPool::stop()
+{
+	for(auto &pWorker : m_vWorkers)
+	{
+		pWorker->getScheduler().stop();
+	}
+}
+
+/**
+ * Returns number of requests waiting with all workers
+ * @param None
+ * @return number of pending requests
+ */
+size_t CEMBWorkerPool::getPendingCount()
+{
+	size_t uiCount = 0;
+	for(auto &pWorker : m_vWorkers)
+	{
+		uiCount += pWorker->getScheduler().getPendingCount();
+	}
+	return uiCount;
+}
@@ -0,0 +1,918 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "JsonEnvelopeTranscoder.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Records an error
+ * @param a_pcError :[in] description of error
+ * @return false always, to be returned by caller
+ */
+bool CJsonTokenizer::setError(const char *a_pcError)
+{
+	if(m_sError.empty())
+	{
+		m_sError = std::string(a_pcError) + " at offset " + std::to_string(m_pcCur - m_pcBegin);
+	}
+	return false;
+}
+
+/**
+ * Moves current position over whitespace
+ * @param None
+ * @return None
+ */
+void CJsonTokenizer::skipWhitespace()
+{
+	while((m_pcCur < m_pcEnd) &&
+			((' ' == *m_pcCur) || ('\t' == *m_pcCur) || ('\n' == *m_pcCur) || ('\r' == *m_pcCur)))
+	{
+		++m_pcCur;
+	}
+}
+
+/**
+ * Tokenizes a JSON document and reports its content to handler
+ * @param a_pcJson :[in] JSON text
+ * @param a_uiLen :[in] length of JSON text
+ * @return true if document is valid and handler accepted all events
+ */
+bool CJsonTokenizer::parse(const char *a_pcJson, size_t a_uiLen)
+{
+	m_pcBegin = a_pcJson;
+	m_pcCur = a_pcJson;
+	m_pcEnd = a_pcJson + a_uiLen;
+	m_sError.clear();
+	if(NULL == a_pcJson)
+	{
+		return setError("No input");
+	}
+	skipWhitespace();
+	if(false == parseValue(0))
+	{
+		return setError("Invalid value");
+	}
+	skipWhitespace();
+	if(m_pcCur != m_pcEnd)
+	{
+		return setError("Unexpected data after value");
+	}
+	return true;
+}
+
+/**
+ * Parses a value
+ * @param a_iDepth :[in] nesting depth
+ * @return true on success
+ */
+bool CJsonTokenizer::parseValue(int a_iDepth)
+{
+	if(m_pcCur >= m_pcEnd)
+	{
+		return setError("Unexpected end");
+	}
+	switch(*m_pcCur)
+	{
+		case '{':
+			return parseObject(a_iDepth + 1);
+		case '[':
+			return parseArray(a_iDepth + 1);
+		case '"':
+		{
+			const char *pcStr = NULL;
+			size_t uiLen = 0;
+			return parseString(pcStr, uiLen) && m_handler.onString(pcStr, uiLen);
+		}
+		case 't':
+			return parseLiteral("true", 4) && m_handler.onBool(true);
+		case 'f':
+			return parseLiteral("false", 5) && m_handler.onBool(false);
+		case 'n':
+			return parseLiteral("null", 4) && m_handler.onNull();
+		default:
+			return parseNumber();
+	}
+}
+
+/**
+ * Parses an object
+ * @param a_iDepth :[in] nesting depth
+ * @return true on success
+ */
+bool CJsonTokenizer::parseObject(int a_iDepth)
+{
+	if(a_iDepth > JSON_TOKENIZER_MAX_DEPTH)
+	{
+		return setError("Nesting too deep");
+	}
+	++m_pcCur;
+	if(false == m_handler.onStartObject())
+	{
+		return false;
+	}
+	skipWhitespace();
+	if((m_pcCur < m_pcEnd) && ('}' == *m_pcCur))
+	{
+		++m_pcCur;
+		return m_handler.onEndObject();
+	}
+	while(m_pcCur < m_pcEnd)
+	{
+		const char *pcKey = NULL;
+		size_t uiLen = 0;
+		if(('"' != *m_pcCur) || (false == parseString(pcKey, uiLen)))
+		{
+			return setError("Expected key");
+		}
+		if(false == m_handler.onKey(pcKey, uiLen))
+		{
+			return false;
+		}
+		skipWhitespace();
+		if((m_pcCur >= m_pcEnd) || (':' != *m_pcCur))
+		{
+			return setError("Expected ':'");
+		}
+		++m_pcCur;
+		skipWhitespace();
+		if(false == parseValue(a_iDepth))
+		{
+			return false;
+		}
+		skipWhitespace();
+		if(m_pcCur >= m_pcEnd)
+		{
+			break;
+		}
+		if('}' == *m_pcCur)
+		{
+			++m_pcCur;
+			return m_handler.onEndObject();
+		}
+		if(',' != *m_pcCur)
+		{
+			return setError("Expected ',' or '}'");
+		}
+		++m_pcCur;
+		skipWhitespace();
+	}
+	return setError("Unterminated object");
+}
+
+/**
+ * Parses an array
+ * @param a_iDepth :[in] nesting depth
+ * @return true on success
+ */
+bool CJsonTokenizer::parseArray(int a_iDepth)
+{
+	if(a_iDepth > JSON_TOKENIZER_MAX_DEPTH)
+	{
+		return setError("Nesting too deep");
+	}
+	++m_pcCur;
+	if(false == m_handler.onStartArray())
+	{
+		return false;
+	}
+	skipWhitespace();
+	if((m_pcCur < m_pcEnd) && (']' == *m_pcCur))
+	{
+		++m_pcCur;
+		return m_handler.onEndArray();
+	}
+	while(m_pcCur < m_pcEnd)
+	{
+		if(false == parseValue(a_iDepth))
+		{
+			return false;
+		}
+		skipWhitespace();
+		if(m_pcCur >= m_pcEnd)
+		{
+			break;
+		}
+		if(']' == *m_pcCur)
+		{
+			++m_pcCur;
+			return m_handler.onEndArray();
+		}
+		if(',' != *m_pcCur)
+		{
+			return setError("Expected ',' or ']'");
+		}
+		++m_pcCur;
+		skipWhitespace();
+	}
+	return setError("Unterminated array");
+}
+
+/**
+ * Parses a string. String without escape sequences is returned in place,
+ * otherwise it is unescaped into scratch buffer.
+ * @param a_pcStr :[out] start of string
+ * @param a_uiLen :[out] length of string
+ * @return true on success
+ */
+bool CJsonTokenizer::parseString(const char *&a_pcStr, size_t &a_uiLen)
+{
+	const char *pcStart = ++m_pcCur;
+	// fast path: no escape sequence
+	while((m_pcCur < m_pcEnd) && ('"' != *m_pcCur) && ('\\' != *m_pcCur))
+	{
+		if((unsigned char)*m_pcCur < 0x20)
+		{
+			return setError("Control character in string");
+		}
+		++m_pcCur;
+	}
+	if(m_pcCur >= m_pcEnd)
+	{
+		return setError("Unterminated string");
+	}
+	if('"' == *m_pcCur)
+	{
+		a_pcStr = pcStart;
+		a_uiLen = m_pcCur - pcStart;
+		++m_pcCur;
+		return true;
+	}
+
+	m_sScratch.assign(pcStart, m_pcCur - pcStart);
+	while(m_pcCur < m_pcEnd)
+	{
+		char c = *m_pcCur++;
+		if('"' == c)
+		{
+			a_pcStr = m_sScratch.data();
+			a_uiLen = m_sScratch.size();
+			return true;
+		}
+		if((unsigned char)c < 0x20)
+		{
+			return setError("Control character in string");
+		}
+		if('\\' != c)
+		{
+			m_sScratch.push_back(c);
+			continue;
+		}
+		if(m_pcCur >= m_pcEnd)
+		{
+			break;
+		}
+		c = *m_pcCur++;
+		switch(c)
+		{
+			case '"': m_sScratch.push_back('"'); break;
+			case '\\': m_sScratch.push_back('\\'); break;
+			case '/': m_sScratch.push_back('/'); break;
+			case 'b': m_sScratch.push_back('\b'); break;
+			case 'f': m_sScratch.push_back('\f'); break;
+			case 'n': m_sScratch.push_back('\n'); break;
+			case 'r': m_sScratch.push_back('\r'); break;
+			case 't': m_sScratch.push_back('\t'); break;
+			case 'u':
+			{
+				auto readHex4 = [this](uint32_t &a_uiCode) -> bool
+				{
+					if(m_pcEnd - m_pcCur < 4)
+					{
+						return false;
+					}
+					a_uiCode = 0;
+					for(int i = 0; i < 4; ++i)
+					{
+						char h = *m_pcCur++;
+						a_uiCode <<= 4;
+						if((h >= '0') && (h <= '9')) a_uiCode |= (uint32_t)(h - '0');
+						else if((h >= 'a') && (h <= 'f')) a_uiCode |= (uint32_t)(h - 'a' + 10);
+						else if((h >= 'A') && (h <= 'F')) a_uiCode |= (uint32_t)(h - 'A' + 10);
+						else return false;
+					}
+					return true;
+				};
+				uint32_t uiCode = 0;
+				if(false == readHex4(uiCode))
+				{
+					return setError("Invalid unicode escape");
+				}
+				if((uiCode >= 0xD800) && (uiCode <= 0xDBFF))
+				{
+					uint32_t uiLow = 0;
+					if((m_pcEnd - m_pcCur < 2) || ('\\' != m_pcCur[0]) || ('u' != m_pcCur[1]))
+					{
+						return setError("Invalid surrogate pair");
+					}
+					m_pcCur += 2;
+					if((false == readHex4(uiLow)) || (uiLow < 0xDC00) || (uiLow > 0xDFFF))
+					{
+						return setError("Invalid surrogate pair");
+					}
+					uiCode = 0x10000 + ((uiCode - 0xD800) << 10) + (uiLow - 0xDC00);
+				}
+				// encode as UTF-8
+				if(uiCode < 0x80)
+				{
+					m_sScratch.push_back((char)uiCode);
+				}
+				else if(uiCode < 0x800)
+				{
+					m_sScratch.push_back((char)(0xC0 | (uiCode >> 6)));
+					m_sScratch.push_back((char)(0x80 | (uiCode & 0x3F)));
+				}
+				else if(uiCode < 0x10000)
+				{
+					m_sScratch.push_back((char)(0xE0 | (uiCode >> 12)));
+					m_sScratch.push_back((char)(0x80 | ((uiCode >> 6) & 0x3F)));
+					m_sScratch.push_back((char)(0x80 | (uiCode & 0x3F)));
+				}
+				else
+				{
+					m_sScratch.push_back((char)(0xF0 | (uiCode >> 18)));
+					m_sScratch.push_back((char)(0x80 | ((uiCode >> 12) & 0x3F)));
+					m_sScratch.push_back((char)(0x80 | ((uiCode >> 6) & 0x3F)));
+					m_sScratch.push_back((char)(0x80 | (uiCode & 0x3F)));
+				}
+				break;
+			}
+			default:
+				return setError("Invalid escape sequence");
+		}
+	}
+	return setError("Unterminated string");
+}
+
+/**
+ * Parses a number. Integral number which fits in 64 bits is reported as integer.
+ * @param None
+ * @return true on success
+ */
+bool CJsonTokenizer::parseNumber()
+{
+	const char *pcStart = m_pcCur;
+	bool bIsIntegral = true;
+	if((m_pcCur < m_pcEnd) && ('-' == *m_pcCur))
+	{
+		++m_pcCur;
+	}
+	if((m_pcCur >= m_pcEnd) || (*m_pcCur < '0') || (*m_pcCur > '9'))
+	{
+		return setError("Invalid number");
+	}
+	if('0' == *m_pcCur)
+	{
+		++m_pcCur;
+	}
+	else
+	{
+		while((m_pcCur < m_pcEnd) && (*m_pcCur >= '0') && (*m_pcCur <= '9')) ++m_pcCur;
+	}
+	if((m_pcCur < m_pcEnd) && ('.' == *m_pcCur))
+	{
+		bIsIntegral = false;
+		++m_pcCur;
+		if((m_pcCur >= m_pcEnd) || (*m_pcCur < '0') || (*m_pcCur > '9'))
+		{
+			return setError("Invalid number");
+		}
+		while((m_pcCur < m_pcEnd) && (*m_pcCur >= '0') && (*m_pcCur <= '9')) ++m_pcCur;
+	}
+	if((m_pcCur < m_pcEnd) && (('e' == *m_pcCur) || ('E' == *m_pcCur)))
+	{
+		bIsIntegral = false;
+		++m_pcCur;
+		if((m_pcCur < m_pcEnd) && (('+' == *m_pcCur) || ('-' == *m_pcCur))) ++m_pcCur;
+		if((m_pcCur >= m_pcEnd) || (*m_pcCur < '0') || (*m_pcCur > '9'))
+		{
+			return setError("Invalid number");
+		}
+		while((m_pcCur < m_pcEnd) && (*m_pcCur >= '0') && (*m_pcCur <= '9')) ++m_pcCur;
+	}
+
+	// number is copied as input need not be NUL terminated after it
+	char acNum[64];
+	size_t uiLen = m_pcCur - pcStart;
+	if(uiLen >= sizeof(acNum))
+	{
+		std::string sNum(pcStart, uiLen);
+		return m_handler.onDouble(strtod(sNum.c_str(), NULL));
+	}
+	memcpy(acNum, pcStart, uiLen);
+	acNum[uiLen] = '\0';
+	if(bIsIntegral)
+	{
+		errno = 0;
+		long long llVal = strtoll(acNum, NULL, 10);
+		if(ERANGE != errno)
+		{
+			return m_handler.onInteger((int64_t)llVal);
+		}
+	}
+	return m_handler.onDouble(strtod(acNum, NULL));
+}
+
+/**
+ * Parses literal true, false or null
+ * @param a_pcLiteral :[in] expected literal
+ * @param a_uiLen :[in] length of literal
+ * @return true on success
+ */
+bool CJsonTokenizer::parseLiteral(const char *a_pcLiteral, size_t a_uiLen)
+{
+	if(((size_t)(m_pcEnd - m_pcCur) < a_uiLen) || (0 != memcmp(m_pcCur, a_pcLiteral, a_uiLen)))
+	{
+		return setError("Invalid literal");
+	}
+	m_pcCur += a_uiLen;
+	return true;
+}
+
+namespace
+{
+	/** Handler building message envelope from a flat JSON object */
+	class CEnvelopeBuilder : public CJsonSaxHandler
+	{
+		msg_envelope_t *m_pMsg; /** envelope being built*/
+		int m_iDepth; /** nesting depth*/
+		std::string m_sKey; /** key of current value*/
+		std::string m_sValue; /** string value, NUL terminated copy*/
+
+		/** Adds value to envelope under current key */
+		bool put(msg_envelope_elem_body_t *a_pValue)
+		{
+			if(NULL == a_pValue)
+			{
+				m_sError = "Could not create value for key: " + m_sKey;
+				return false;
+			}
+			if(MSG_SUCCESS != msgbus_msg_envelope_put(m_pMsg, m_sKey.c_str(), a_pValue))
+			{
+				// e.g. duplicate key
+				m_sError = "Could not add key to message: " + m_sKey;
+				msgbus_msg_envelope_elem_destroy(a_pValue);
+				return false;
+			}
+			return true;
+		}
+
+	public:
+		std::string m_sError; /** description of error*/
+
+		explicit CEnvelopeBuilder(msg_envelope_t *a_pMsg) : m_pMsg{a_pMsg}, m_iDepth{0} {}
+
+		/** Adds a string field to envelope */
+		bool addString(const std::string &a_sKey, const std::string &a_sValue)
+		{
+			m_sKey = a_sKey;
+			return put(msgbus_msg_envelope_new_string(a_sValue.c_str()));
+		}
+
+		bool onStartObject() override
+		{
+			if(0 != m_iDepth++)
+			{
+				m_sError = "Nested object for key: " + m_sKey;
+				return false;
+			}
+			return true;
+		}
+		bool onEndObject() override
+		{
+			--m_iDepth;
+			return true;
+		}
+		bool onStartArray() override
+		{
+			m_sError = (0 == m_iDepth) ? "JSON is not an object" : "Array for key: " + m_sKey;
+			return false;
+		}
+		bool onKey(const char *a_pcKey, size_t a_uiLen) override
+		{
+			m_sKey.assign(a_pcKey, a_uiLen);
+			return true;
+		}
+		bool onString(const char *a_pcValue, size_t a_uiLen) override
+		{
+			if(0 == m_iDepth)
+			{
+				m_sError = "JSON is not an object";
+				return false;
+			}
+			DO_LOG_DEBUG(m_sKey + " : " + std::string(a_pcValue, a_uiLen));
+			m_sValue.assign(a_pcValue, a_uiLen);
+			return put(msgbus_msg_envelope_new_string(m_sValue.c_str()));
+		}
+		bool onInteger(int64_t a_i64Value) override
+		{
+			if(0 == m_iDepth)
+			{
+				m_sError = "JSON is not an object";
+				return false;
+			}
+			return put(msgbus_msg_envelope_new_integer(a_i64Value));
+		}
+		bool onDouble(double a_dValue) override
+		{
+			if(0 == m_iDepth)
+			{
+				m_sError = "JSON is not an object";
+				return false;
+			}
+			return put(msgbus_msg_envelope_new_floating(a_dValue));
+		}
+		bool onBool(bool a_bValue) override
+		{
+			if(0 == m_iDepth)
+			{
+				m_sError = "JSON is not an object";
+				return false;
+			}
+			return put(msgbus_msg_envelope_new_bool(a_bValue));
+		}
+		bool onNull() override
+		{
+			m_sError = "Null value for key: " + m_sKey;
+			return false;
+		}
+	};
+
+	/** Handler checking that JSON is an object and counting its keys */
+	class CObjectChecker : public CJsonSaxHandler
+	{
+	public:
+		int m_iDepth = 0; /** nesting depth*/
+		bool m_bIsObject = false; /** true if top level value is an object*/
+		size_t m_uiKeys = 0; /** number of top level keys*/
+
+		bool onStartObject() override
+		{
+			if(0 == m_iDepth++)
+			{
+				m_bIsObject = true;
+			}
+			return true;
+		}
+		bool onEndObject() override
+		{
+			--m_iDepth;
+			return true;
+		}
+		bool onStartArray() override
+		{
+			++m_iDepth;
+			return true;
+		}
+		bool onEndArray() override
+		{
+			--m_iDepth;
+			return true;
+		}
+		bool onKey(const char *a_pcKey, size_t a_uiLen) override
+		{
+			if(1 == m_iDepth)
+			{
+				++m_uiKeys;
+			}
+			return true;
+		}
+	};
+}
+
+/**
+ * Converts a flat JSON object into EII message envelope in a single pass
+ * @param a_sJson :[in] JSON object
+ * @param a_vExtraFields :[in] string fields to be added to envelope
+ * @param a_sError :[out] description of error
+ * @return envelope to be destroyed by caller, NULL on error
+ */
+msg_envelope_t* CJsonEnvelopeTranscoder::transcode(const std::string &a_sJson,
+		const std::vector<std::pair<std::string, std::string>> &a_vExtraFields,
+		std::string &a_sError)
+{
+	msg_envelope_t *pMsg = msgbus_msg_envelope_new(CT_JSON);
+	if(NULL == pMsg)
+	{
+		a_sError = "could not create new msg envelope";
+		return NULL;
+	}
+
+	CEnvelopeBuilder oBuilder(pMsg);
+	CJsonTokenizer oTokenizer(oBuilder);
+	if(false == oTokenizer.parse(a_sJson.data(), a_sJson.size()))
+	{
+		a_sError = oBuilder.m_sError.empty() ? oTokenizer.getError() : oBuilder.m_sError;
+		msgbus_msg_envelope_destroy(pMsg);
+		return NULL;
+	}
+
+	for(const auto &field : a_vExtraFields)
+	{
+		if(false == oBuilder.addString(field.first, field.second))
+		{
+			a_sError = "Could not add field: " + field.first;
+			msgbus_msg_envelope_destroy(pMsg);
+			return NULL;
+		}
+	}
+	return pMsg;
+}
+
+/**
+ * Appends a string as JSON string literal, escaping characters as needed
+ * @param a_sOut :[in,out] output
+ * @param a_sValue :[in] string
+ * @return None
+ */
+void CJsonEnvelopeTranscoder::appendJsonString(std::string &a_sOut, const std::string &a_sValue)
+{
+	static const char acHex[] = "0123456789abcdef";
+	a_sOut.push_back('"');
+	for(char c : a_sValue)
+	{
+		switch(c)
+		{
+			case '"': a_sOut.append("\\\""); break;
+			case '\\': a_sOut.append("\\\\"); break;
+			case '\n': a_sOut.append("\\n"); break;
+			case '\r': a_sOut.append("\\r"); break;
+			case '\t': a_sOut.append("\\t"); break;
+			default:
+				if((unsigned char)c < 0x20)
+				{
+					a_sOut.append("\\u00");
+					a_sOut.push_back(acHex[(c >> 4) & 0xF]);
+					a_sOut.push_back(acHex[c & 0xF]);
+				}
+				else
+				{
+					a_sOut.push_back(c);
+				}
+		}
+	}
+	a_sOut.push_back('"');
+}
+
+/**
+ * Adds a string field to a JSON object without building a document tree.
+ * JSON is validated in a single pass and field is inserted before closing brace.
+ * @param a_sJson :[in,out] JSON object
+ * @param a_sKey :[in] key
+ * @param a_sValue :[in] value
+ * @return true on success, false if JSON is not a valid object
+ */
+bool CJsonEnvelopeTranscoder::appendStringField(std::string &a_sJson, const std::string &a_sKey, const std::string &a_sValue)
+{
+	CObjectChecker oChecker;
+	CJsonTokenizer oTokenizer(oChecker);
+	if((false == oTokenizer.parse(a_sJson.data(), a_sJson.size())) || (false == oChecker.m_bIsObject))
+	{
+		return false;
+	}
+	size_t uiPos = a_sJson.find_last_of('}');
+	if(std::string::npos == uiPos)
+	{
+		return false;
+	}
+
+	std::string sField;
+	sField.reserve(a_sKey.size() + a_sValue.size() + 8);
+	if(0 != oChecker.m_uiKeys)
+	{
+		sField.push_back(',');
+	}
+	appendJsonString(sField, a_sKey);
+	sField.push_back(':');
+	appendJsonString(sField, a_sValue);
+	a_sJson.insert(uiPos, sField);
+	return true;
+}
+
+/**
+ * Moves over whitespace
+ * @param a_pcCur :[in] current position
+ * @param a_pcEnd :[in] end of input
+ * @return position of first non-whitespace character
+ */
+const char* CJsonKeyScanner::skipWhitespace(const char *a_pcCur, const char *a_pcEnd)
+{
+	while((a_pcCur < a_pcEnd) &&
+			((' ' == *a_pcCur) || ('\t' == *a_pcCur) || ('\n' == *a_pcCur) || ('\r' == *a_pcCur)))
+	{
+		++a_pcCur;
+	}
+	return a_pcCur;
+}
+
+/**
+ * Moves over a string. Escape sequences are skipped, not decoded.
+ * @param a_pcCur :[in] position of opening quote
+ * @param a_pcEnd :[in] end of input
+ * @param a_bHasEscape :[out] true if string contains an escape sequence
+ * @return position after closing quote, NULL if string is not terminated
+ */
+const char* CJsonKeyScanner::skipString(const char *a_pcCur, const char *a_pcEnd, bool &a_bHasEscape)
+{
+	a_bHasEscape = false;
+	for(++a_pcCur; a_pcCur < a_pcEnd; ++a_pcCur)
+	{
+		if('"' == *a_pcCur)
+		{
+			return a_pcCur + 1;
+		}
+		if('\\' == *a_pcCur)
+		{
+			a_bHasEscape = true;
+			++a_pcCur;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Moves over a value. Brackets are matched, content is not validated.
+ * @param a_pcCur :[in] start of value
+ * @param a_pcEnd :[in] end of input
+ * @return position after value, NULL if value is not terminated
+ */
+const char* CJsonKeyScanner::skipValue(const char *a_pcCur, const char *a_pcEnd)
+{
+	int iDepth = 0;
+	bool bHasEscape = false;
+	while(a_pcCur < a_pcEnd)
+	{
+		switch(*a_pcCur)
+		{
+			case '"':
+				a_pcCur = skipString(a_pcCur, a_pcEnd, bHasEscape);
+				if(NULL == a_pcCur)
+				{
+					return NULL;
+				}
+				if(0 == iDepth)
+				{
+					return a_pcCur;
+				}
+				continue;
+			case '{':
+			case '[':
+				if(++iDepth > JSON_TOKENIZER_MAX_DEPTH)
+				{
+					return NULL;
+				}
+				break;
+			case '}':
+			case ']':
+				if(0 == iDepth)
+				{
+					// end of enclosing object
+					return a_pcCur;
+				}
+				if(0 == --iDepth)
+				{
+					return a_pcCur + 1;
+				}
+				break;
+			case ',':
+				if(0 == iDepth)
+				{
+					return a_pcCur;
+				}
+				break;
+			default:
+				break;
+		}
+		++a_pcCur;
+	}
+	return (0 == iDepth) ? a_pcCur : NULL;
+}
+
+/**
+ * Looks up a top level key of JSON object
+ * @param a_pcJson :[in] JSON text
+ * @param a_uiLen :[in] length of JSON text
+ * @param a_pcKey :[in] key to look up; key with escape sequences in JSON is not matched
+ * @param a_pcValue :[out] start of value; for string value, content between the quotes
+ * @param a_uiValueLen :[out] length of value
+ * @param a_uiMaxScan :[in] max number of bytes to scan
+ * @return JSON_KEY_FOUND if key is found,
+ * 			JSON_KEY_NOT_FOUND if object does not have key or key is not within scan limit,
+ * 			JSON_KEY_MALFORMED if JSON is not an object or is not well formed
+ */
+eJsonKeyScanResult CJsonKeyScanner::find(const char *a_pcJson, size_t a_uiLen, const char *a_pcKey,
+		const char *&a_pcValue, size_t &a_uiValueLen, size_t a_uiMaxScan)
+{
+	if((NULL == a_pcJson) || (NULL == a_pcKey))
+	{
+		return JSON_KEY_MALFORMED;
+	}
+	const char *pcEnd = a_pcJson + a_uiLen;
+	const char *pcLimit = a_pcJson + std::min(a_uiLen, a_uiMaxScan);
+	size_t uiKeyLen = strlen(a_pcKey);
+	bool bHasEscape = false;
+
+	const char *pcCur = skipWhitespace(a_pcJson, pcEnd);
+	if((pcCur >= pcEnd) || ('{' != *pcCur))
+	{
+		return JSON_KEY_MALFORMED;
+	}
+	pcCur = skipWhitespace(pcCur + 1, pcEnd);
+	if((pcCur < pcEnd) && ('}' == *pcCur))
+	{
+		return JSON_KEY_NOT_FOUND;
+	}
+	while(pcCur < pcLimit)
+	{
+		if('"' != *pcCur)
+		{
+			return JSON_KEY_MALFORMED;
+		}
+		const char *pcKeyStart = pcCur + 1;
+		pcCur = skipString(pcCur, pcEnd, bHasEscape);
+		if(NULL == pcCur)
+		{
+			return JSON_KEY_MALFORMED;
+		}
+		bool bIsMatch = (false == bHasEscape) && ((size_t)(pcCur - 1 - pcKeyStart) == uiKeyLen) &&
+				(0 == memcmp(pcKeyStart, a_pcKey, uiKeyLen));
+
+		pcCur = skipWhitespace(pcCur, pcEnd);
+		if((pcCur >= pcEnd) || (':' != *pcCur))
+		{
+			return JSON_KEY_MALFORMED;
+		}
+		pcCur = skipWhitespace(pcCur + 1, pcEnd);
+		if((pcCur >= pcEnd) || (',' == *pcCur) || ('}' == *pcCur) || (']' == *pcCur))
+		{
+			return JSON_KEY_MALFORMED;
+		}
+
+		const char *pcValueStart = pcCur;
+		pcCur = skipValue(pcCur, pcEnd);
+		if(NULL == pcCur)
+		{
+			return JSON_KEY_MALFORMED;
+		}
+		if(true == bIsMatch)
+		{
+			if('"' == *pcValueStart)
+			{
+				a_pcValue = pcValueStart + 1;
+				a_uiValueLen = pcCur - pcValueStart - 2;
+			}
+			else
+			{
+				// literal or number; trailing whitespace is not part of value
+				const char *pcValueEnd = pcCur;
+				while((pcValueEnd > pcValueStart) &&
+						((' ' == pcValueEnd[-1]) || ('\t' == pcValueEnd[-1]) || ('\n' == pcValueEnd[-1]) || ('\r' == pcValueEnd[-1])))
+				{
+					--pcValueEnd;
+				}
+				a_pcValue = pcValueStart;
+				a_uiValueLen = pcValueEnd - pcValueStart;
+			}
+			return JSON_KEY_FOUND;
+		}
+
+		pcCur = skipWhitespace(pcCur, pcEnd);
+		if(pcCur >= pcEnd)
+		{
+			return JSON_KEY_MALFORMED;
+		}
+		if('}' == *pcCur)
+		{
+			return JSON_KEY_NOT_FOUND;
+		}
+		if(',' != *pcCur)
+		{
+			return JSON_KEY_MALFORMED;
+		}
+		pcCur = skipWhitespace(pcCur + 1, pcEnd);
+	}
+	return (pcCur < pcEnd) ? JSON_KEY_NOT_FOUND : JSON_KEY_MALFORMED;
+}
@@ -24,6 +24,10 @@
 #include "cjson/cJSON.h"
 #include "Common.hpp"
 #include "ConfigManager.hpp"
+#include "EnvironmentVarHandler.hpp"
+#include "TimeFormatter.hpp"
+#include <algorithm>
+#include <stdlib.h>
 
 /**
  * Constructor Initializes MQTT publisher
@@ -34,10 +38,12 @@
  */
 CMQTTPublishHandler::CMQTTPublishHandler(std::string strPlBusUrl, std::string strClientID, int iQOS):
 	CMQTTBaseHandler(strPlBusUrl, strClientID, iQOS, (false == CcommonEnvManager::Instance().getDevMode()),
-        "/run/secrets/rootca/cacert.pem", "/run/secrets/mymqttcerts/mymqttcerts_client_certificate.pem", "/run/secrets/mymqttcerts/mymqttcerts_client_key.pem", "MQTTSubListener")
+        "/run/secrets/rootca/cacert.pem", "/run/secrets/mymqttcerts/mymqttcerts_client_certificate.pem", "/run/secrets/mymqttcerts/mymqttcerts_client_key.pem", "MQTTSubListener",
+        getV5Config()), m_eTsMode{getTsCarrierMode()}
 {
 	try
 	{
+		initOutbox(strClientID);
 		connect();
 		DO_LOG_DEBUG("MQTT initialized successfully. QOS to be used: " + std::to_string(m_QOS));
 	}
@@ -48,13 +54,77 @@ CMQTTPublishHandler::CMQTTPublishHandler(std::string strPlBusUrl, std::string st
 }
 
 /**
- * Publish message on MQTT broker
+ * Gets MQTT v5 settings of publisher. Publisher does not resume its session, so that
+ * topic aliases can be used; messages not delivered are kept in outbox instead.
+ * @param None
+ * @return MQTT v5 settings
+ */
+stMQTTv5Config CMQTTPublishHandler::getV5Config()
+{
+	stMQTTv5Config stConfig = CMQTTPubSubClient::readV5Config();
+	stConfig.m_uiSessionExpirySec = 0;
+	return stConfig;
+}
+
+/**
+ * Gets how latency timestamps are carried with message. User properties need
+ * MQTT v5 connection, otherwise timestamps are carried in payload.
+ * @param None
+ * @return carrier mode
+ */
+eTsCarrierMode CMQTTPublishHandler::getTsCarrierMode()
+{
+	eTsCarrierMode eMode = CTimestampCarrier::readMode();
+	if((enTS_CARRIER_PROPERTY == eMode) && (false == CMQTTPubSubClient::readV5Config().m_bIsEnabled))
+	{
+		DO_LOG_WARN("MQTT_TIMESTAMP_MODE property needs MQTT_V5, timestamps are carried in payload");
+		eMode = enTS_CARRIER_SLOT;
+	}
+	return eMode;
+}
+
+/**
+ * Enables outbox of MQTT client if MQTT_OUTBOX_DIR is set. Messages received while
+ * broker is not reachable are then stored on disk and forwarded after reconnection.
+ * Each publisher uses its own sub-directory.
+ * @param a_sClientID :[in] client ID of publisher
+ * @return None
+ */
+void CMQTTPublishHandler::initOutbox(const std::string &a_sClientID)
+{
+	const char *pcDir = std::getenv("MQTT_OUTBOX_DIR");
+	if((NULL == pcDir) || ('\0' == pcDir[0]))
+	{
+		DO_LOG_DEBUG("MQTT_OUTBOX_DIR is not set, outbox is disabled for " + a_sClientID);
+		return;
+	}
+	std::string sSubDir(a_sClientID);
+	std::replace(sSubDir.begin(), sSubDir.end(), '/', '_');
+
+	stOutboxConfig stConfig;
+	stConfig.m_sDir = std::string(pcDir) + "/" + sSubDir;
+	stConfig.m_uiMaxBytes = (size_t)EnvironmentInfo::getEnvNum("MQTT_OUTBOX_MAX_MB",
+			OUTBOX_DEFAULT_MAX_BYTES / (1024 * 1024), 1, SIZE_MAX / (1024 * 1024)) * 1024 * 1024;
+	stConfig.m_uiMaxAgeSec = (uint32_t)EnvironmentInfo::getEnvNum("MQTT_OUTBOX_MAX_AGE_SEC", 0, 0, UINT32_MAX);
+	stConfig.m_uiDrainRate = (uint32_t)EnvironmentInfo::getEnvNum("MQTT_OUTBOX_DRAIN_RATE",
+			OUTBOX_DEFAULT_DRAIN_RATE, 0, UINT32_MAX);
+	if(false == m_MQTTClient.enableOutbox(stConfig))
+	{
+		DO_LOG_ERROR("Outbox could not be enabled for " + a_sClientID + ", messages are not stored during outage");
+	}
+}
+
+/**
+ * Publish message on MQTT broker along with latency timestamps.
+ * In slot mode, timestamp is written in tsMsgReadyForPublish slot reserved in message,
+ * so that message is not copied; if there is no slot, field is appended to message.
+ * In property mode, message is published as is and timestamps are sent as user properties.
  * @param a_sMsg :[in] message to publish
  * @param a_sTopic :[in] topic on which to publish message
- * @param a_tsMsgRcvd :[in] time stamp to add while publishing
+ * @param a_ui64RcvdUs :[in] time at which message was received for processing, used in property mode
  * @return true/false based on success/failure
  */
-bool CMQTTPublishHandler::createNPubMsg(std::string &a_sMsg, std::string &a_sTopic)
+bool CMQTTPublishHandler::createNPubMsg(std::string &a_sMsg, std::string &a_sTopic, uint64_t a_ui64RcvdUs)
 {
 	try
 	{
@@ -74,21 +144,32 @@ bool CMQTTPublishHandler::createNPubMsg(std::string &a_sMsg, std::string &a_sTop
 		// Add timestamp to message
 		struct timespec tsMsgPublish;
 		timespec_get(&tsMsgPublish, TIME_UTC);
-		std::string strTsPublish = std::to_string(CCommon::getInstance().get_micros(tsMsgPublish));
+		uint64_t ui64PublishUs = CTimeFormatter::toMicros(tsMsgPublish);
 
-		// remove } bracket to add new key value pair to existing json
-		a_sMsg.pop_back();
-
-		std::string msgWithTimeStamp =  a_sMsg + ","+ "\"tsMsgReadyForPublish\"" + ":" + "\"" + strTsPublish + "\"" + "}";
+		mqtt::properties props;
+		if(enTS_CARRIER_PROPERTY == m_eTsMode)
+		{
+			if(0 != a_ui64RcvdUs)
+			{
+				CTimestampCarrier::addProperty(props, "tsMsgRcvdForProcessing", a_ui64RcvdUs);
+			}
+			CTimestampCarrier::addProperty(props, "tsMsgReadyForPublish", ui64PublishUs);
+		}
+		else if(false == CTimestampCarrier::patchSlot(a_sMsg, "tsMsgReadyForPublish", ui64PublishUs))
+		{
+			// remove } bracket to add new key value pair to existing json
+			a_sMsg.pop_back();
+			a_sMsg += ",\"tsMsgReadyForPublish\":\"" + std::to_string(ui64PublishUs) + "\"}";
+		}
 
 		//publish data to MQTT
 #ifdef INSTRUMENTATION_LOG
 		DO_LOG_DEBUG("ZMQ Message: Time: "
 				+ std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count())
-		+ ", Msg: " + msgWithTimeStamp);
+		+ ", Msg: " + a_sMsg);
 #endif
 
-		publishMsg(msgWithTimeStamp, a_sTopic);
+		publishMsg(a_sMsg, a_sTopic, props);
 		return true;
 	}
 	catch (const std::exception &exc)
@@ -23,12 +23,13 @@
 #include "MQTTSubscribeHandler.hpp"
 #include "Logger.hpp"
 #include "Common.hpp"
-#include "cjson/cJSON.h"
+#include "JsonEnvelopeTranscoder.hpp"
 #include "CommonDataShare.hpp"
 #include "EnvironmentVarHandler.hpp"
 #include "ConfigManager.hpp"
 #include <functional>
-#include "QueueMgr.hpp"
+#include "EMBWorkerPool.hpp"
+#include "TimeFormatter.hpp"
 #include <error.h>
 
 #define SUBSCRIBER_ID "MQTT_EXPORT_SUBSCRIBER"
@@ -45,11 +46,83 @@ extern std::atomic<bool> g_shouldStop;
 CMQTTHandler::CMQTTHandler(const std::string &strPlBusUrl, int iQOS):
 	CMQTTBaseHandler(strPlBusUrl, SUBSCRIBER_ID, iQOS, (false == CcommonEnvManager::Instance().getDevMode()),
 	"/run/secrets/rootca/cacert.pem", "/run/secrets/mymqttcerts/mymqttcerts_client_certificate.pem", 
-	"/run/secrets/mymqttcerts/mymqttcerts_client_key.pem", "MQTTSubListener")
+	"/run/secrets/mymqttcerts/mymqttcerts_client_key.pem", "MQTTSubListener", getV5Config())
 {
+	auto addRoutes = [this](const char *a_pcEnv, bool a_bIsRealtime)
+	{
+		const char *pcTopics = std::getenv(a_pcEnv);
+		if(NULL != pcTopics)
+		{
+			m_oRouteTable.addTopics(pcTopics, a_bIsRealtime);
+		}
+	};
+	addRoutes("MQTT_RT_ROUTE_TOPICS", true);
+	addRoutes("MQTT_NON_RT_ROUTE_TOPICS", false);
+	DO_LOG_INFO("Number of topics routed without inspecting payload: " + std::to_string(m_oRouteTable.size()));
+
 	DO_LOG_DEBUG("MQTT handler initialized successfully");
 }
 
+/**
+ * Gets MQTT v5 settings of subscriber. Requests are published by other clients,
+ * so subscriber does not need topic aliases.
+ * @param None
+ * @return MQTT v5 settings
+ */
+stMQTTv5Config CMQTTHandler::getV5Config()
+{
+	stMQTTv5Config stConfig = CMQTTPubSubClient::readV5Config();
+	stConfig.m_uiTopicAliasMax = 0;
+	return stConfig;
+}
+
+/**
+ * Adds topics to routing table
+ * @param a_sTopicList :[in] comma separated list of MQTT topics
+ * @param a_bIsRealtime :[in] true if requests on these topics are real-time
+ * @return None
+ */
+void CTopicRouteTable::addTopics(const std::string &a_sTopicList, bool a_bIsRealtime)
+{
+	size_t uiStart = 0;
+	while(uiStart <= a_sTopicList.size())
+	{
+		size_t uiEnd = a_sTopicList.find(',', uiStart);
+		if(std::string::npos == uiEnd)
+		{
+			uiEnd = a_sTopicList.size();
+		}
+		std::string sTopic = a_sTopicList.substr(uiStart, uiEnd - uiStart);
+		sTopic.erase(0, sTopic.find_first_not_of(" \t"));
+		sTopic.erase(sTopic.find_last_not_of(" \t") + 1);
+		if(false == sTopic.empty())
+		{
+			if(false == m_mapTopicToRT.emplace(sTopic, a_bIsRealtime).second)
+			{
+				DO_LOG_ERROR(sTopic + " : topic is configured more than once for routing. First entry is used.");
+			}
+		}
+		uiStart = uiEnd + 1;
+	}
+}
+
+/**
+ * Looks up real-time flag of a topic
+ * @param a_sTopic :[in] MQTT topic
+ * @param a_bIsRealtime :[out] true if requests on this topic are real-time
+ * @return true if topic is in table, false otherwise
+ */
+bool CTopicRouteTable::lookup(const std::string &a_sTopic, bool &a_bIsRealtime) const
+{
+	auto itr = m_mapTopicToRT.find(a_sTopic);
+	if(m_mapTopicToRT.end() == itr)
+	{
+		return false;
+	}
+	a_bIsRealtime = itr->second;
+	return true;
+}
+
 /**
  * Maintain single instance of this class
  * @param None
@@ -215,69 +288,178 @@ void CMQTTHandler::handleConnSuccessThread()
 }
 
 /**
-* parse message to retrieve QOS and topic names
+* Finds value of top level key "realtime" in message without parsing whole message.
+* Payload is not validated here; invalid message is rejected by thread which sends it on EII.
 * @param json :[in] message from which to retrieve real-time
-* @param isRealtime :[in] is it a message for real-time operation
+* @param isRealtime :[out] is it a message for real-time operation
 * @param bIsDefault :[in] default RT value
-* @return true/false based on success/failure
+* @return false if message is not a JSON object, true otherwise
 */
 bool CMQTTHandler::parseMQTTMsg(const std::string &sJson, bool &isRealtime, const bool bIsDefault)
 {
-	bool bRetVal = false;
+	isRealtime = bIsDefault;
 
-	try
+	const char *pcValue = NULL;
+	size_t uiLen = 0;
+	switch(CJsonKeyScanner::find(sJson.data(), sJson.size(), "realtime", pcValue, uiLen, REALTIME_KEY_SCAN_LIMIT))
 	{
-		isRealtime = bIsDefault;
-		cJSON *root = cJSON_Parse(sJson.c_str());
-		if (NULL == root)
+		case JSON_KEY_FOUND:
+			break;
+		case JSON_KEY_NOT_FOUND:
+			DO_LOG_DEBUG("Message received from MQTT does not have key \"realtime\", request will be sent with default setting");
+			return true;
+		default:
+			return false;
+	}
+
+	// only string values "0" and "1" are considered, for any other value default is used
+	if((1 == uiLen) && (pcValue > sJson.data()) && ('"' == pcValue[-1]))
+	{
+		if('0' == *pcValue)
 		{
-			DO_LOG_ERROR("Message received from MQTT could not be parsed in json format");
-			return bRetVal;
+			isRealtime = false;
 		}
-
-		if(! cJSON_HasObjectItem(root, "realtime"))
+		else if('1' == *pcValue)
 		{
-			DO_LOG_DEBUG("Message received from MQTT does not have key \"realtime\", request will be sent as non-RT");
-			if (NULL != root)
-				cJSON_Delete(root);
+			isRealtime = true;
+		}
+	}
+	return true;
+}
 
-			return true;
+/**
+ * Get value of a top-level string field of a JSON object without parsing the object
+ * @param a_sJson :[in] JSON object
+ * @param a_pcKey :[in] key to look for
+ * @return value of key; empty string if key is not present or value is not a string
+ */
+std::string CMQTTHandler::getStringField(const std::string &a_sJson, const char *a_pcKey)
+{
+	const char *pcValue = NULL;
+	size_t uiLen = 0;
+	if((JSON_KEY_FOUND == CJsonKeyScanner::find(a_sJson.data(), a_sJson.size(), a_pcKey,
+			pcValue, uiLen, REALTIME_KEY_SCAN_LIMIT))
+		&& (pcValue > a_sJson.data()) && ('"' == pcValue[-1]))
+	{
+		return std::string(pcValue, uiLen);
+	}
+	return "";
+}
+
+/**
+ * Create error response for an expired request. Response has same format as
+ * response sent by Modbus container for a failed request.
+ * @param a_oMsg :[in] expired request
+ * @param a_bIsRealtime :[in] is request real-time
+ * @return response JSON
+ */
+std::string CMQTTHandler::createExpiredResponse(CMessageObject &a_oMsg, bool a_bIsRealtime)
+{
+	const std::string sTopic = a_oMsg.getTopic();
+	const std::string sMsg = a_oMsg.getStrMsg();
+	char cTimestamp[TIME_FMT_BUFFER_SIZE] = {0};
+	char cUsec[TIME_FMT_BUFFER_SIZE] = {0};
+	CTimeFormatter::getInstance().getTimeParams(cTimestamp, cUsec);
+
+	const std::vector<std::pair<std::string, std::string>> vFields{
+		{"app_seq", getStringField(sMsg, "app_seq")},
+		{"wellhead", getStringField(sMsg, "wellhead")},
+		{"metric", getStringField(sMsg, "command")},
+		{"realtime", (true == a_bIsRealtime) ? "1" : "0"},
+		{"version", "2.0"},
+		{"status", "Bad"},
+		{"error_code", std::to_string(REQUEST_TTL_ERROR_CODE)},
+		{"value", ""},
+		{"data_topic", sTopic + "Response"},
+		{"timestamp", cTimestamp},
+		{"usec", cUsec},
+		{"tsMsgRcvdFromMQTT", CTimeFormatter::microsToString(a_oMsg.getTimestamp())}};
+
+	std::string sResponse{"{"};
+	for(const auto &stField : vFields)
+	{
+		if(sResponse.size() > 1)
+		{
+			sResponse += ',';
 		}
+		CJsonEnvelopeTranscoder::appendJsonString(sResponse, stField.first);
+		sResponse += ':';
+		CJsonEnvelopeTranscoder::appendJsonString(sResponse, stField.second);
+	}
+	sResponse += '}';
+	return sResponse;
+}
 
-		char *crealtime = cJSON_GetObjectItem(root, "realtime")->valuestring;
-		if (NULL == crealtime)
+/**
+ * Check if request is older than TTL configured for its topic. Age is measured from
+ * earlier of application timestamp (usec) and time at which request was received from MQTT;
+ * receive time alone is used if the two differ by more than TTL.
+ * Expired request is counted and answered with an error response on MQTT.
+ * @param a_oMsg :[in] request received from MQTT
+ * @param a_bIsRealtime :[in] is request real-time
+ * @param a_eStage :[in] stage at which request is checked
+ * @return true if request can be processed, false if request has expired
+ */
+bool CMQTTHandler::checkRequestTTL(CMessageObject &a_oMsg, bool a_bIsRealtime, eReqTTLStage a_eStage)
+{
+	try
+	{
+		CRequestTTL &oTTL = CRequestTTL::getInstance();
+		const std::string sTopic = a_oMsg.getTopic();
+		// TTL is disabled by default, avoid looking in payload in that case
+		uint32_t uiTTLMs = oTTL.getTTLMs(sTopic);
+		if(0 == uiTTLMs)
 		{
-			DO_LOG_ERROR("Key 'realtime' could not be found in message received from ZMQ");
-			if (NULL != root)
-			{
-				cJSON_Delete(root);
-			}
 			return true;
 		}
-		else
+
+		uint64_t ui64AgeUs = 0;
+		uint64_t ui64OriginUs = CRequestTTL::getOriginUs(getStringField(a_oMsg.getStrMsg(), "usec"),
+				CTimeFormatter::toMicros(a_oMsg.getTimestamp()), uiTTLMs);
+		if(false == oTTL.isExpired(sTopic, ui64OriginUs,
+				CTimeFormatter::getInstance().nowMicros(), ui64AgeUs))
 		{
-			if(strcmp(crealtime, "0") == 0)
-			{
-				isRealtime = false;
-			}
-			else if(strcmp(crealtime, "1") == 0)
-			{
-				isRealtime = true;
-			}
+			return true;
 		}
 
-		if (NULL != root)
-			cJSON_Delete(root);
+		uint64_t ui64Count = oTTL.recordExpired(a_eStage);
+		DO_LOG_WARN_RATELIMITED("Expired MQTT request", 5, 1000, sTopic +
+				" : request expired at " + CRequestTTL::getStageName(a_eStage) +
+				", age in us: " + std::to_string(ui64AgeUs) +
+				", expired requests: " + std::to_string(ui64Count));
 
-		bRetVal = true;
+		publishExpiredResponse(a_oMsg, a_bIsRealtime);
 	}
-	catch (std::exception &ex)
+	catch (const std::exception &e)
 	{
-		DO_LOG_ERROR(ex.what());
-		bRetVal = false;
+		DO_LOG_ERROR(e.what());
+		// request is processed as usual when TTL could not be checked
+		return true;
 	}
+	return false;
+}
 
-	return bRetVal;
+/**
+ * Publish error response for a request which has expired before it could be sent on EII
+ * @param a_oMsg :[in] expired request
+ * @param a_bIsRealtime :[in] is request real-time
+ * @return None
+ */
+void CMQTTHandler::publishExpiredResponse(CMessageObject &a_oMsg, bool a_bIsRealtime)
+{
+	try
+	{
+		const std::string sTopic = a_oMsg.getTopic();
+		if(false == CMQTTHandler::instance().publishMsg(createExpiredResponse(a_oMsg, a_bIsRealtime),
+				sTopic + "Response"))
+		{
+			DO_LOG_ERROR(sTopic + " : could not publish response for expired request");
+		}
+	}
+	catch (const std::exception &e)
+	{
+		DO_LOG_ERROR(e.what());
+	}
 }
 
 /**
@@ -302,8 +484,8 @@ bool CMQTTHandler::pushMsgInQ(mqtt::const_message_ptr& a_msgMQTT)
 				return false;
 			}
 		};
-		std::string sTopic{a_msgMQTT->get_topic()};
-		std::string payload{a_msgMQTT->get_payload()};
+		const std::string &sTopic = a_msgMQTT->get_topic();
+		const std::string &payload = a_msgMQTT->get_payload();
 		CMessageObject oTemp{a_msgMQTT};
 		bool bDefRT = false;
 		bool isWrite = false;
@@ -334,36 +516,28 @@ bool CMQTTHandler::pushMsgInQ(mqtt::const_message_ptr& a_msgMQTT)
 			return false;
 		}
 		
-		//parse payload to check if realtime is true or false
+		//routing table decides realtime for configured topics, otherwise payload is checked
 		bool isRealTime = false;
-		if( ! parseMQTTMsg(payload.c_str(), isRealTime, bDefRT))
+		if(false == m_oRouteTable.lookup(sTopic, isRealTime))
 		{
-			DO_LOG_DEBUG("Could not parse MQTT msg");
-			return false;
+			if(false == parseMQTTMsg(payload, isRealTime, bDefRT))
+			{
+				// message is validated and rejected by worker thread, not in MQTT callback
+				DO_LOG_DEBUG("MQTT msg is not a JSON object, pushing it with default setting");
+			}
 		}
 
-		//if payload contains realtime flag, push message to real time queue
-		if(isRealTime)
+		//request which is already older than its TTL is answered here and not queued
+		if(false == checkRequestTTL(oTemp, isRealTime, enREQ_TTL_AT_ADMISSION))
 		{
-			if(isWrite)
-			{
-				QMgr::getRTWrite().pushMsg(oTemp);
-			}
-			else
-			{
-				QMgr::getRTRead().pushMsg(oTemp);
-			}
+			return false;
 		}
-		else //non-RT
+
+		//worker of device queues message as per its class and gives real-time messages first to its thread
+		if(false == CEMBWorkerPool::getInstance().submit(oTemp, isRealTime, isWrite))
 		{
-			if(isWrite)
-			{
-				QMgr::getWrite().pushMsg(oTemp);
-			}
-			else
-			{
-				QMgr::getRead().pushMsg(oTemp);
-			}
+			DO_LOG_ERROR("Could not queue MQTT message, scheduler is stopped");
+			return false;
 		}
 
 		DO_LOG_DEBUG("Pushed MQTT message in queue");
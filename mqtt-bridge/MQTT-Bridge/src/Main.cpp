@@ -22,14 +22,17 @@
 
 #include "ZmqHandler.hpp"
 #include "Common.hpp"
-#include "QueueMgr.hpp"
+#include "EMBWorkerPool.hpp"
 #include "MQTTSubscribeHandler.hpp"
 #include "ConfigManager.hpp"
 #include "Logger.hpp"
 #include "MQTTPublishHandler.hpp"
+#include "TimeFormatter.hpp"
 #include "ConfigManager.hpp"
 #include "EnvironmentVarHandler.hpp"
 #include "ZmqHandler.hpp"
+#include "EIIListenerPool.hpp"
+#include "JsonEnvelopeTranscoder.hpp"
 
 #ifdef UNIT_TEST
 #include <gtest/gtest.h>
@@ -39,6 +42,9 @@ using namespace zmq_handler;
 
 std::vector<std::thread> g_vThreads;
 
+/** Pools listening on EII topics; one pool per distinct operation setting */
+std::vector<std::unique_ptr<CEIIListenerPool>> g_vListenerPools;
+
 std::atomic<bool> g_shouldStop(false);
 
 #define APP_VERSION "0.0.6.6"
@@ -87,9 +93,17 @@ bool processMsg(msg_envelope_t *msg, CMQTTPublishHandler &mqttPublisher)
 	{
 		revdTopic = data->body.string; // has the topic /flowmeter/PL0/D18/update
 
-		std::string strTsRcvd = std::to_string(CCommon::getInstance().get_micros(tsMsgRcvd));
-		msg_envelope_elem_body_t* tsMsgRcvdPut = msgbus_msg_envelope_new_string(strTsRcvd.c_str());
-		msgbus_msg_envelope_put(msg, "tsMsgRcvdForProcessing", tsMsgRcvdPut);
+		uint64_t ui64RcvdUs = CTimeFormatter::toMicros(tsMsgRcvd);
+		if(enTS_CARRIER_SLOT == mqttPublisher.getTsMode())
+		{
+			std::string strTsRcvd = CTimeFormatter::microsToString(tsMsgRcvd);
+			msg_envelope_elem_body_t* tsMsgRcvdPut = msgbus_msg_envelope_new_string(strTsRcvd.c_str());
+			msgbus_msg_envelope_put(msg, "tsMsgRcvdForProcessing", tsMsgRcvdPut);
+
+			// slot is reserved here and is filled by publisher without copying serialized message
+			msg_envelope_elem_body_t* tsMsgPublishPut = msgbus_msg_envelope_new_string(TS_SLOT_PLACEHOLDER);
+			msgbus_msg_envelope_put(msg, "tsMsgReadyForPublish", tsMsgPublishPut);
+		}
 
 		num_parts = msgbus_msg_envelope_serialize(msg, &parts);
 		if (num_parts <= 0)
@@ -101,7 +115,7 @@ bool processMsg(msg_envelope_t *msg, CMQTTPublishHandler &mqttPublisher)
 			if(NULL != parts[0].bytes)
 			{
 				std::string mqttMsg(parts[0].bytes);
-				mqttPublisher.createNPubMsg(mqttMsg, revdTopic);
+				mqttPublisher.createNPubMsg(mqttMsg, revdTopic, ui64RcvdUs);
 
 				bRetVal = true;
 			}
@@ -173,165 +187,36 @@ void getOperation(std::string topic, globalConfig::COperation& operation)
 	}
 }
 
-/**
- * Thread function to listen on EII and send data to MQTT
- * @param topic :[in] topic prefix to listen onto
- * @param context :[in] msg bus context
- * @param subContext :[in] sub context
- * @param operation :[in] operation type this thread needs to perform
- * @return None
- */
-void listenOnEII(std::string topicPrefix, zmq_handler::stZmqContext context, zmq_handler::stZmqSubContext subContext, globalConfig::COperation operation)
-{
-	globalConfig::set_thread_sched_param(operation);
-	globalConfig::display_thread_sched_attr(topicPrefix + " listenOnEII");
-	int qos = operation.getQos();
-
-	if(context.m_pContext == NULL || subContext.sub_ctx == NULL)
-	{
-		DO_LOG_ERROR("Cannot start listening on EII for topicPrefix : " + topicPrefix);
-		return;
-	}
-
-	void *msgbus_ctx = context.m_pContext; // this is per subscriber
-	recv_ctx_t *sub_ctx = subContext.sub_ctx; // this is per SUB topic
-
-	//consider topic name as distinguishing factor for publisher
-	CMQTTPublishHandler mqttPublisher(EnvironmentInfo::getInstance().getDataFromEnvMap("MQTT_URL_FOR_EXPORT").c_str(),
-					topicPrefix, qos);
-	mqttPublisher.connect();
-	
-	DO_LOG_INFO("ZMQ listening for topic : " + topicPrefix);
-
-	while ((false == g_shouldStop.load()) && (msgbus_ctx != NULL) && (sub_ctx != NULL))
-	{
-		try
-		{
-			msg_envelope_t *msg = NULL;
-			msgbus_ret_t ret;
-
-			ret = msgbus_recv_wait(msgbus_ctx, sub_ctx, &msg);
-			if (ret != MSG_SUCCESS)
-			{
-				// Interrupt is an acceptable error
-				if (ret == MSG_ERR_EINTR)
-				{
-					DO_LOG_ERROR("received MSG_ERR_EINT");
-				}
-				DO_LOG_ERROR("Failed to receive message errno: " + std::to_string(ret));
-				continue;
-			}
-			
-			// process ZMQ message and publish to MQTT
-			processMsg(msg, mqttPublisher);
-
-		}
-		catch (std::exception &ex)
-		{
-			DO_LOG_FATAL((std::string)ex.what()+" for topic : "+topicPrefix);
-		}
-	}//while ends
-
-	DO_LOG_DEBUG("exited !!");
-}
-
 /**
  * publish message to EII
  * @param a_oRcvdMsg  :[in] message to publish on EII
  * @param embTopic :[in] EII topic
+ * @param a_stPublisher :[in] EMB publisher of topic owned by calling worker
  * @return true/false based on success/failure
  */
-bool publishEIIMsg(CMessageObject &a_oRcvdMsg, const std::string &embTopic)
+bool publishEIIMsg(CMessageObject &a_oRcvdMsg, const std::string &embTopic, const stEMBPublisher &a_stPublisher)
 {
-	bool retVal = false;
-
-	// Creating message to be published
 	msg_envelope_t *msg = NULL;
-	cJSON *root = NULL;
 
 	try
 	{
-		msg = msgbus_msg_envelope_new(CT_JSON);
-		if(msg == NULL)
-		{
-			DO_LOG_ERROR("could not create new msg envelope");
-			return retVal;
-		}
 		std::string eiiMsg = a_oRcvdMsg.getStrMsg();
 		//TODO: Remove the realtime flag in JSON body before publishing to EMB.
-		//parse from root element
-		root = cJSON_Parse(eiiMsg.c_str());
-		if (NULL == root)
-		{
-			DO_LOG_ERROR("Could not parse value received from MQTT");
-
-			if(msg != NULL)
-			{
-				msgbus_msg_envelope_destroy(msg);
-			}
-
-			return retVal;
-		}
-
-		auto addField = [&msg](const std::string &a_sFieldName, const std::string &a_sValue) {
-			DO_LOG_DEBUG(a_sFieldName + " : " + a_sValue);
-			msg_envelope_elem_body_t *value = msgbus_msg_envelope_new_string(a_sValue.c_str());
-			if((NULL != value) && (NULL != msg))
-			{
-				msgbus_msg_envelope_put(msg, a_sFieldName.c_str(), value);
-			}
-		};
-
-		cJSON *device = root->child;
-		while (device)
-		{
-			if(cJSON_IsString(device))
-			{        
-				addField(device->string, device->valuestring);
-			}
-			else if (cJSON_IsBool(device))
-			{
-				bool val = false;
-				// Add bool in msg envelope
-				if (cJSON_IsTrue(device))
-				{
-					val = true;
-				}
-				msg_envelope_elem_body_t *value = msgbus_msg_envelope_new_bool(val);
-				if (NULL != msg && NULL != value)
-				{
-					msgbus_msg_envelope_put(msg, device->string, value);					
-				}
-			}
-			else if (cJSON_IsNumber(device))
-			{
-				// Add number in msg envelope
-				msg_envelope_elem_body_t *value = msgbus_msg_envelope_new_floating(device->valuedouble);
-				if (NULL != msg && NULL != value)
-				{
-					msgbus_msg_envelope_put(msg, device->string, value);
-				}
-			}
-			else
-			{
-				throw std::string("Invalid JSON");
-			}
-			// get and print key
-			device = device->next;
-		}
-
-		if (root)
+		// JSON is converted to envelope in a single pass, timestamp and source topic are added in same pass
+		std::string sError;
+		msg = CJsonEnvelopeTranscoder::transcode(eiiMsg,
+				{{"tsMsgRcvdFromMQTT", CTimeFormatter::microsToString(a_oRcvdMsg.getTimestamp())},
+				{"sourcetopic", a_oRcvdMsg.getTopic()}}, sError);
+		if(NULL == msg)
 		{
-			cJSON_Delete(root);
+			DO_LOG_ERROR("Could not parse value received from MQTT: " + sError);
+			return false;
 		}
-		root = NULL;
 
-		addField("tsMsgRcvdFromMQTT", (std::to_string(CCommon::getInstance().get_micros(a_oRcvdMsg.getTimestamp()))).c_str());
-		addField("sourcetopic", a_oRcvdMsg.getTopic());
-		
 		std::string strTsReceived{""};
 		bool bRet = true;
-		if(true == zmq_handler::publishJson(strTsReceived, msg, embTopic, "tsMsgPublishOnEII"))
+		if(true == zmq_handler::publishJson(strTsReceived, msg, *a_stPublisher.m_pMsgbusCtx, a_stPublisher.m_pPubCtx,
+				embTopic, "tsMsgPublishOnEII"))
 		{
 			bRet = true;
 		}
@@ -346,10 +231,6 @@ bool publishEIIMsg(CMessageObject &a_oRcvdMsg, const std::string &embTopic)
 
 		return bRet;
 	}
-	catch(std::string& strException)
-	{
-		DO_LOG_ERROR(strException);
-	}
 	catch(std::exception &ex)
 	{
 		DO_LOG_ERROR(ex.what());
@@ -359,10 +240,6 @@ bool publishEIIMsg(CMessageObject &a_oRcvdMsg, const std::string &embTopic)
 	{
 		msgbus_msg_envelope_destroy(msg);
 	}
-	if (root)
-	{
-		cJSON_Delete(root);
-	}
 
 	return false;
 }
@@ -404,9 +281,10 @@ std::string mapMqttToEMBTopic(std::string mqttTopic, bool isRealTime) {
  * Process message received from MQTT and send it on EII
  * @param recvdMsg :[in] message received from MQTT client to publish on EII
  * @param isRealtime :[in] RT or Non RT.
+ * @param a_worker :[in] worker sending the message, owning EMB publishers
  * @return true/false based on success/failure
  */
-void processMsgToSendOnEII(CMessageObject &recvdMsg, const bool isRealtime)
+void processMsgToSendOnEII(CMessageObject &recvdMsg, const bool isRealtime, CEMBWorker &a_worker)
 {
 	try
 	{
@@ -423,24 +301,34 @@ void processMsgToSendOnEII(CMessageObject &recvdMsg, const bool isRealtime)
 
 		DO_LOG_DEBUG("Request received from MQTT for topic "+ rcvdTopic);
 
+		// request may have expired while waiting in scheduler queue
+		if(false == CMQTTHandler::checkRequestTTL(recvdMsg, isRealtime, enREQ_TTL_AT_DISPATCH))
+		{
+			return;
+		}
+
 		// To add the mapping logic from MQTT topic format to NEW mapped EII topic format
 		// /flowmeter/PL0/D13/read to RT|NRT/read/flowmeter/PL0/D13
 		std::string embTopic = mapMqttToEMBTopic(rcvdTopic, isRealtime);
 
-		//Get the context for this EMB PUB topic
-		zmq_handler::prepareContext(true, (zmq_handler::getPubCtxCfg()).m_pub_msgbus_ctx, embTopic, (zmq_handler::getPubCtxCfg()).m_pub_config);
-
+		//Get the publisher for this EMB PUB topic; context is created on first use
+		stEMBPublisher stPublisher{NULL, NULL};
 		if (embTopic.empty())
 		{
 			DO_LOG_ERROR("EMB topic is not set to publish on EMB"+ rcvdTopic);
 			return;
 		}
+		else if(false == a_worker.getPublisher(embTopic, stPublisher))
+		{
+			DO_LOG_ERROR("Failed to get EMB publisher for topic : " + embTopic);
+			return;
+		}
 		else
 		{
 			//publish data to EII
 			DO_LOG_DEBUG("MQTT topic is Mapped to new EMB topic format : " + embTopic);
 
-			if(publishEIIMsg(recvdMsg, embTopic))
+			if(publishEIIMsg(recvdMsg, embTopic, stPublisher))
 			{
 				DO_LOG_DEBUG("Published EII message : "	+ strMsg + " on topic :" + embTopic);
 			}
@@ -503,54 +391,51 @@ void set_thread_priority_for_eii(bool& isRealtime, bool& isRead)
 }
 
 /**
- * Thread function to read requests from queue filled up by MQTT and send data to EII
- * @param qMgr 	:[in] pointer to respective queue manager
+ * Thread function of a worker to take requests of its devices from its scheduler and send data to EII.
+ * Requests are taken in batches of a single class; real-time requests are given first,
+ * so they are picked up by this thread at latest after current batch is sent.
+ * Thread priority is changed as per class of batch being sent.
+ * @param a_worker :[in] reference of worker
  * @return None
  */
-void postMsgsToEII(QMgr::CQueueMgr& qMgr)
+void postMsgsToEII(CEMBWorker &a_worker)
 {
+	CRequestScheduler &scheduler = a_worker.getScheduler();
 	DO_LOG_DEBUG("Starting thread to send messages on EII");
 
-	bool isRealtime = qMgr.isRealTime(); // RT is extracted from JSON body sent from mqtt client. for backward compatibility will keep this. 
-	bool isRead = qMgr.isRead();
-
-	//set priority to send msgs on EII from MQTT-export (on-demand)
-	set_thread_priority_for_eii(isRealtime, isRead);
-
-	globalConfig::display_thread_sched_attr("postMsgsToEII");
-
-	// std::string eiiTopic = "";
-	// if(! isRead)//write request
-	// {
-	// 	if(isRealtime)
-	// 	{
-	// 		eiiTopic.assign(EnvironmentInfo::getInstance().getDataFromEnvMap("WriteRequest_RT"));
-	// 	}
-	// 	else
-	// 	{
-	// 		eiiTopic.assign(EnvironmentInfo::getInstance().getDataFromEnvMap("WriteRequest"));
-	// 	}
-	// }
-	// else//read request
-	// {
-	// 	if(isRealtime)
-	// 	{
-	// 		eiiTopic.assign(EnvironmentInfo::getInstance().getDataFromEnvMap("ReadRequest_RT"));
-	// 	}
-	// 	else
-	// 	{
-	// 		eiiTopic.assign(EnvironmentInfo::getInstance().getDataFromEnvMap("ReadRequest"));
-	// 	}
-	// }
+	int iCurClass = REQ_CLASS_MAX;
+	std::vector<CMessageObject> vBatch;
+	vBatch.reserve(scheduler.getConfig().m_uiBatchSize);
+	// requester is answered when non-real-time request is dropped by scheduler
+	scheduler.setExpiredHandler([](CMessageObject &a_oMsg)
+	{
+		CMQTTHandler::publishExpiredResponse(a_oMsg, false);
+	});
 
 	try
 	{
 		while (false == g_shouldStop.load())
 		{
-			CMessageObject oTemp;
-			if(true == qMgr.isMsgArrived(oTemp))
+			eReqClass eClass = REQ_CLASS_MAX;
+			if(0 == scheduler.nextBatch(vBatch, eClass, g_shouldStop))
+			{
+				continue;
+			}
+
+			// RT is extracted from JSON body sent from mqtt client
+			bool isRealtime = CRequestScheduler::isRealtimeClass(eClass);
+			bool isRead = CRequestScheduler::isReadClass(eClass);
+			if(iCurClass != eClass)
 			{
-				processMsgToSendOnEII(oTemp, isRealtime);
+				//set priority to send msgs on EII from MQTT-export (on-demand)
+				set_thread_priority_for_eii(isRealtime, isRead);
+				globalConfig::display_thread_sched_attr("postMsgsToEII");
+				iCurClass = eClass;
+			}
+
+			for(auto &oTemp : vBatch)
+			{
+				processMsgToSendOnEII(oTemp, isRealtime, a_worker);
 			}
 		}
 	}
@@ -562,7 +447,9 @@ void postMsgsToEII(QMgr::CQueueMgr& qMgr)
 
 /**
  * Get EII topic list, get corresponding message bus and topic contexts.
- * Spawn threads to listen to EII messages, receive messages from EII and publish them to MQTT
+ * Topics having same operation settings are grouped in a listener pool. Each pool
+ * polls its topics in one thread and publishes to MQTT using a small set of workers
+ * and MQTT connections, instead of a thread and a connection per topic.
  * @param None
  * @return None
  */
@@ -577,6 +464,10 @@ void postMsgstoMQTT()
 		return;
 	} 
 
+	stListenerPoolConfig stPoolConfig = CEIIListenerPool::readConfig();
+	std::string sAppName = EnvironmentInfo::getInstance().getDataFromEnvMap("AppName");
+	std::map<std::string, CEIIListenerPool*> mapPools;
+
 	for (auto &topic : vFullTopics)
 	{
 		if(topic.empty())
@@ -594,8 +485,26 @@ void postMsgstoMQTT()
 		globalConfig::COperation objOperation;
 		getOperation(topic, objOperation);
 
+		// topics with same thread priority and QoS share a pool
+		std::string sPoolName = sAppName + (objOperation.isRT() ? "_RT" : "_NRT") +
+				"_P" + std::to_string(objOperation.getOperationPriority()) +
+				"_Q" + std::to_string(objOperation.getQos());
+		auto itr = mapPools.find(sPoolName);
+		if(itr == mapPools.end())
+		{
+			g_vListenerPools.push_back(std::unique_ptr<CEIIListenerPool>(
+					new CEIIListenerPool(sPoolName, objOperation, stPoolConfig, processMsg)));
+			itr = mapPools.insert(std::make_pair(sPoolName, g_vListenerPools.back().get())).first;
+		}
+		itr->second->addTopic(topic, context.m_pContext, subContext.sub_ctx);
+	}
+
+	for (auto &itr : mapPools)
+	{
+		DO_LOG_INFO("ZMQ listening for " + std::to_string(itr.second->getTopicCount()) +
+				" topics in pool : " + itr.first);
 		g_vThreads.push_back(
-				std::thread(listenOnEII, topic, context, subContext, objOperation));
+				std::thread(&CEIIListenerPool::run, itr.second, std::cref(g_shouldStop)));
 	}
 }
 
@@ -688,12 +597,22 @@ int main(int argc, char *argv[])
 #endif
 
 		//Start listening on EII & publishing to MQTT
-		postMsgstoMQTT();
-		//threads to send on-demand requests on EII
-		g_vThreads.push_back(std::thread(postMsgsToEII, std::ref(QMgr::getRTRead())));
-		g_vThreads.push_back(std::thread(postMsgsToEII, std::ref(QMgr::getRTWrite())));
-		g_vThreads.push_back(std::thread(postMsgsToEII, std::ref(QMgr::getRead())));
-		g_vThreads.push_back(std::thread(postMsgsToEII, std::ref(QMgr::getWrite())));
+		//an instance sharing on-demand requests with other instances leaves it to the first instance
+		const char *pcInboundOnly = std::getenv("MQTT_BRIDGE_INBOUND_ONLY");
+		if((NULL != pcInboundOnly) && (std::string("true") == pcInboundOnly))
+		{
+			DO_LOG_INFO("MQTT_BRIDGE_INBOUND_ONLY is set, EII messages are not published on MQTT by this instance");
+		}
+		else
+		{
+			postMsgstoMQTT();
+		}
+		//threads to send on-demand requests on EII, one per worker
+		CEMBWorkerPool &workerPool = CEMBWorkerPool::getInstance();
+		for(size_t i = 0; i < workerPool.getWorkerCount(); ++i)
+		{
+			g_vThreads.push_back(std::thread(postMsgsToEII, std::ref(workerPool.getWorker(i))));
+		}
 
 
 		for (auto &th : g_vThreads)
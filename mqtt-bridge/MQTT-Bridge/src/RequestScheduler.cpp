@@ -0,0 +1,366 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "RequestScheduler.hpp"
+#include "EnvironmentVarHandler.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdlib.h>
+
+namespace
+{
+	/** Names of request classes used in logs */
+	const char *g_apcClassNames[REQ_CLASS_MAX] = {"RT write", "RT read", "Non-RT write", "Non-RT read"};
+
+	/** Returns monotonic time in micro seconds, not affected by changes of system time */
+	uint64_t getNowUs()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+/**
+ * Returns percentile of queueing delay from histogram
+ * @param a_dPercentile :[in] percentile, between 0 and 100
+ * @return upper bound of histogram bucket containing the percentile, in micro seconds
+ */
+uint64_t stReqClassStats::getDelayPercentileUs(double a_dPercentile) const
+{
+	uint64_t ui64Total = 0;
+	for(int i = 0; i < REQ_SCHED_DELAY_BUCKETS; ++i)
+	{
+		ui64Total += m_aui64DelayHist[i];
+	}
+	if(0 == ui64Total)
+	{
+		return 0;
+	}
+	uint64_t ui64Rank = (uint64_t)(a_dPercentile * ui64Total / 100.0);
+	uint64_t ui64Count = 0;
+	for(int i = 0; i < REQ_SCHED_DELAY_BUCKETS; ++i)
+	{
+		ui64Count += m_aui64DelayHist[i];
+		if(ui64Count > ui64Rank)
+		{
+			return std::min((uint64_t)1 << i, m_ui64MaxDelayUs);
+		}
+	}
+	return m_ui64MaxDelayUs;
+}
+
+/**
+ * Constructor
+ * @param a_stConfig :[in] scheduler configuration
+ * @param a_sName :[in] name used in logs, to tell schedulers of workers apart
+ */
+CRequestScheduler::CRequestScheduler(const stReqSchedulerConfig &a_stConfig, const std::string &a_sName)
+	: m_stConfig{a_stConfig}, m_sName{a_sName}, m_ui64LastStatsLogUs{getNowUs()}, m_bIsStopped{false}
+{
+	m_stConfig.m_uiBatchSize = std::max(m_stConfig.m_uiBatchSize, (size_t)1);
+	m_stConfig.m_uiWorkers = std::max(m_stConfig.m_uiWorkers, (size_t)1);
+}
+
+/**
+ * Reads scheduler configuration from environment variables MQTT_SCHED_BATCH_SIZE,
+ * MQTT_SCHED_WORKERS, MQTT_RT_DEADLINE_MS, MQTT_NON_RT_DEADLINE_MS and MQTT_SCHED_STATS_INTERVAL_SEC
+ * @param None
+ * @return scheduler configuration; default value is used for a variable which is not set
+ */
+stReqSchedulerConfig CRequestScheduler::readConfig()
+{
+	stReqSchedulerConfig stConfig;
+	stConfig.m_uiBatchSize = EnvironmentInfo::getEnvNum("MQTT_SCHED_BATCH_SIZE", REQ_SCHED_DEFAULT_BATCH_SIZE, 1);
+	stConfig.m_uiWorkers = EnvironmentInfo::getEnvNum("MQTT_SCHED_WORKERS", REQ_SCHED_DEFAULT_WORKERS, 1);
+	stConfig.m_uiRTDeadlineMs = (uint32_t)EnvironmentInfo::getEnvNum("MQTT_RT_DEADLINE_MS",
+			REQ_SCHED_DEFAULT_RT_DEADLINE_MS, 0, UINT32_MAX);
+	stConfig.m_uiNonRTDeadlineMs = (uint32_t)EnvironmentInfo::getEnvNum("MQTT_NON_RT_DEADLINE_MS",
+			REQ_SCHED_DEFAULT_NON_RT_DEADLINE_MS, 0, UINT32_MAX);
+	stConfig.m_uiStatsIntervalSec = (uint32_t)EnvironmentInfo::getEnvNum("MQTT_SCHED_STATS_INTERVAL_SEC",
+			REQ_SCHED_DEFAULT_STATS_INTERVAL_SEC, 0, UINT32_MAX);
+	return stConfig;
+}
+
+/**
+ * Returns class of a request
+ * @param a_bIsRealtime :[in] true for real-time request
+ * @param a_bIsWrite :[in] true for write request, false for read request
+ * @return request class
+ */
+eReqClass CRequestScheduler::getClass(bool a_bIsRealtime, bool a_bIsWrite)
+{
+	if(a_bIsRealtime)
+	{
+		return a_bIsWrite ? REQ_CLASS_RT_WRITE : REQ_CLASS_RT_READ;
+	}
+	return a_bIsWrite ? REQ_CLASS_NON_RT_WRITE : REQ_CLASS_NON_RT_READ;
+}
+
+/**
+ * Converts timespec to micro seconds
+ * @param a_stTs :[in] time
+ * @return time in micro seconds
+ */
+uint64_t CRequestScheduler::getTimeUs(const struct timespec &a_stTs)
+{
+	return ((uint64_t)a_stTs.tv_sec * 1000000) + ((uint64_t)a_stTs.tv_nsec / 1000);
+}
+
+/**
+ * Sets handler to be called for each non-real-time request dropped as its deadline has passed.
+ * Handler is called from thread waiting in nextBatch(), without queue mutex locked.
+ * To be called before threads start taking requests.
+ * @param a_fcbExpired :[in] handler
+ * @return None
+ */
+void CRequestScheduler::setExpiredHandler(const req_expired_handler_t &a_fcbExpired)
+{
+	std::lock_guard<std::mutex> lock(m_mutexQ);
+	m_fcbExpired = a_fcbExpired;
+}
+
+/**
+ * Queues a request. Deadline of request is computed from time at which it was received from MQTT.
+ * @param a_oMsg :[in] request received from MQTT
+ * @param a_bIsRealtime :[in] true for real-time request
+ * @param a_bIsWrite :[in] true for write request, false for read request
+ * @return true if request is queued, false if scheduler is stopped
+ */
+bool CRequestScheduler::submit(CMessageObject &a_oMsg, bool a_bIsRealtime, bool a_bIsWrite)
+{
+	eReqClass eClass = getClass(a_bIsRealtime, a_bIsWrite);
+	uint32_t uiDeadlineMs = a_bIsRealtime ? m_stConfig.m_uiRTDeadlineMs : m_stConfig.m_uiNonRTDeadlineMs;
+
+	// time spent since request was received is taken from system time once; afterwards
+	// monotonic time is used, so that change of system time does not expire requests
+	struct timespec stWallNow;
+	timespec_get(&stWallNow, TIME_UTC);
+	uint64_t ui64WallNowUs = getTimeUs(stWallNow);
+	uint64_t ui64WallRcvdUs = getTimeUs(a_oMsg.getTimestamp());
+	uint64_t ui64NowUs = getNowUs();
+	uint64_t ui64WaitedUs = (ui64WallNowUs > ui64WallRcvdUs) ? std::min(ui64WallNowUs - ui64WallRcvdUs, ui64NowUs) : 0;
+
+	stRequest stReq{a_oMsg, ui64NowUs - ui64WaitedUs, 0};
+	if(0 != uiDeadlineMs)
+	{
+		stReq.m_ui64DeadlineUs = stReq.m_ui64RcvdUs + ((uint64_t)uiDeadlineMs * 1000);
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutexQ);
+		if(m_bIsStopped)
+		{
+			return false;
+		}
+		m_adqRequests[eClass].push_back(stReq);
+		++m_astStats[eClass].m_ui64Queued;
+	}
+	m_cvQ.notify_one();
+	return true;
+}
+
+/**
+ * Drops non-real-time requests whose deadline has passed. Requests of a class are
+ * queued in order of deadline, so only head of queue needs to be checked.
+ * To be called with queue mutex locked.
+ * @param a_eClass :[in] request class
+ * @param a_ui64NowUs :[in] current time
+ * @param a_vExpired :[out] dropped requests are appended to this
+ * @return None
+ */
+void CRequestScheduler::dropExpired(eReqClass a_eClass, uint64_t a_ui64NowUs, std::vector<CMessageObject> &a_vExpired)
+{
+	std::deque<stRequest> &dqRequests = m_adqRequests[a_eClass];
+	size_t uiDropped = 0;
+	while((false == dqRequests.empty()) && (0 != dqRequests.front().m_ui64DeadlineUs) &&
+			(dqRequests.front().m_ui64DeadlineUs < a_ui64NowUs))
+	{
+		a_vExpired.push_back(dqRequests.front().m_oMsg);
+		dqRequests.pop_front();
+		++uiDropped;
+	}
+	if(0 != uiDropped)
+	{
+		m_astStats[a_eClass].m_ui64Expired += uiDropped;
+		DO_LOG_WARN(m_sName + std::string(g_apcClassNames[a_eClass]) + ": " + std::to_string(uiDropped) +
+				" request(s) dropped as deadline has passed");
+	}
+}
+
+/**
+ * Updates queueing delay statistics of a dispatched request.
+ * To be called with queue mutex locked.
+ * @param a_eClass :[in] request class
+ * @param a_stReq :[in] dispatched request
+ * @param a_ui64NowUs :[in] current time
+ * @return None
+ */
+void CRequestScheduler::recordDelay(eReqClass a_eClass, const stRequest &a_stReq, uint64_t a_ui64NowUs)
+{
+	stReqClassStats &stStats = m_astStats[a_eClass];
+	uint64_t ui64DelayUs = (a_ui64NowUs > a_stReq.m_ui64RcvdUs) ? (a_ui64NowUs - a_stReq.m_ui64RcvdUs) : 0;
+	++stStats.m_ui64Dispatched;
+	stStats.m_ui64TotalDelayUs += ui64DelayUs;
+	stStats.m_ui64MaxDelayUs = std::max(stStats.m_ui64MaxDelayUs, ui64DelayUs);
+	if((0 != a_stReq.m_ui64DeadlineUs) && (a_stReq.m_ui64DeadlineUs < a_ui64NowUs))
+	{
+		++stStats.m_ui64DeadlineMissed;
+	}
+
+	int iBucket = 0;
+	while((iBucket < REQ_SCHED_DELAY_BUCKETS - 1) && (((uint64_t)1 << iBucket) <= ui64DelayUs))
+	{
+		++iBucket;
+	}
+	++stStats.m_aui64DelayHist[iBucket];
+}
+
+/**
+ * Logs statistics of all classes if logging interval has elapsed.
+ * To be called with queue mutex locked.
+ * @param a_ui64NowUs :[in] current time
+ * @return None
+ */
+void CRequestScheduler::logStats(uint64_t a_ui64NowUs)
+{
+	if((0 == m_stConfig.m_uiStatsIntervalSec) ||
+			(a_ui64NowUs < m_ui64LastStatsLogUs + ((uint64_t)m_stConfig.m_uiStatsIntervalSec * 1000000)))
+	{
+		return;
+	}
+	m_ui64LastStatsLogUs = a_ui64NowUs;
+	for(int i = 0; i < REQ_CLASS_MAX; ++i)
+	{
+		const stReqClassStats &stStats = m_astStats[i];
+		uint64_t ui64AvgUs = (0 == stStats.m_ui64Dispatched) ? 0 : (stStats.m_ui64TotalDelayUs / stStats.m_ui64Dispatched);
+		DO_LOG_INFO(m_sName + std::string(g_apcClassNames[i]) + " requests: queued: " + std::to_string(stStats.m_ui64Queued) +
+				", dispatched: " + std::to_string(stStats.m_ui64Dispatched) +
+				", expired: " + std::to_string(stStats.m_ui64Expired) +
+				", deadline missed: " + std::to_string(stStats.m_ui64DeadlineMissed) +
+				", pending: " + std::to_string(m_adqRequests[i].size()) +
+				", queueing delay us: avg " + std::to_string(ui64AvgUs) +
+				", p99 " + std::to_string(stStats.getDelayPercentileUs(99)) +
+				", max " + std::to_string(stStats.m_ui64MaxDelayUs));
+	}
+}
+
+/**
+ * Waits for requests and returns a batch of requests of highest priority class having requests.
+ * Expired non-real-time requests are dropped, given to expired request handler and not returned.
+ * @param a_vBatch :[out] requests to be sent on EII, in order of arrival
+ * @param a_eClass :[out] class of requests
+ * @param a_bStop :[in] wait is stopped when this flag is set
+ * @return number of requests in batch, 0 if wait is stopped
+ */
+size_t CRequestScheduler::nextBatch(std::vector<CMessageObject> &a_vBatch, eReqClass &a_eClass,
+		const std::atomic<bool> &a_bStop)
+{
+	a_vBatch.clear();
+	std::unique_lock<std::mutex> lock(m_mutexQ);
+	while((false == m_bIsStopped) && (false == a_bStop.load()))
+	{
+		uint64_t ui64NowUs = getNowUs();
+		logStats(ui64NowUs);
+		std::vector<CMessageObject> vExpired;
+		for(int i = 0; i < REQ_CLASS_MAX; ++i)
+		{
+			if(false == isRealtimeClass((eReqClass)i))
+			{
+				dropExpired((eReqClass)i, ui64NowUs, vExpired);
+			}
+		}
+		if((false == vExpired.empty()) && m_fcbExpired)
+		{
+			// handler publishes responses, so queue is not kept locked meanwhile
+			req_expired_handler_t fcbExpired = m_fcbExpired;
+			lock.unlock();
+			for(auto &oMsg : vExpired)
+			{
+				fcbExpired(oMsg);
+			}
+			lock.lock();
+			continue;
+		}
+
+		for(int i = 0; i < REQ_CLASS_MAX; ++i)
+		{
+			eReqClass eClass = (eReqClass)i;
+			std::deque<stRequest> &dqRequests = m_adqRequests[i];
+			if(dqRequests.empty())
+			{
+				continue;
+			}
+			while((false == dqRequests.empty()) && (a_vBatch.size() < m_stConfig.m_uiBatchSize))
+			{
+				recordDelay(eClass, dqRequests.front(), ui64NowUs);
+				a_vBatch.push_back(dqRequests.front().m_oMsg);
+				dqRequests.pop_front();
+			}
+			a_eClass = eClass;
+			return a_vBatch.size();
+		}
+		// timed wait so that stop flag and statistics interval are checked when idle
+		m_cvQ.wait_for(lock, std::chrono::milliseconds(100));
+	}
+	return 0;
+}
+
+/**
+ * Stops scheduler. Threads waiting for requests return and new requests are not accepted.
+ * @param None
+ * @return None
+ */
+void CRequestScheduler::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutexQ);
+		m_bIsStopped = true;
+	}
+	m_cvQ.notify_all();
+}
+
+/**
+ * Returns number of requests waiting in all queues
+ * @param None
+ * @return number of pending requests
+ */
+size_t CRequestScheduler::getPendingCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutexQ);
+	size_t uiCount = 0;
+	for(int i = 0; i < REQ_CLASS_MAX; ++i)
+	{
+		uiCount += m_adqRequests[i].size();
+	}
+	return uiCount;
+}
+
+/**
+ * Returns statistics of a request class
+ * @param a_eClass :[in] request class
+ * @return copy of statistics
+ */
+stReqClassStats CRequestScheduler::getStats(eReqClass a_eClass)
+{
+	std::lock_guard<std::mutex> lock(m_mutexQ);
+	return m_astStats[a_eClass];
+}
@@ -21,32 +21,56 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../Test/Src/Common_ut.cpp \
+../Test/Src/DDataAggregator_ut.cpp \
+../Test/Src/FlapDamper_ut.cpp \
 ../Test/Src/InternalMQTTSubscriber_ut.cpp \
 ../Test/Src/Main_ut.cpp \
 ../Test/Src/Metric_ut.cpp \
+../Test/Src/RealDevMetricTable_ut.cpp \
 ../Test/Src/SCADAHandler_ut.cpp \
 ../Test/Src/SparkPlugDevices_ut.cpp \
+../Test/Src/SparkPlugDevicesBenchmark_ut.cpp \
+../Test/Src/SparkplugCodecBenchmark_ut.cpp \
+../Test/Src/SparkPlugDevRegistry_ut.cpp \
 ../Test/Src/SparkPlugUDTMgr_ut.cpp \
+../Test/Src/SparkplugEncodeArena_ut.cpp \
+../Test/Src/SparkplugPublisher_ut.cpp \
 ../Test/Src/SparklugDevMgr_ut.cpp 
 
 OBJS += \
 ./Test/Src/Common_ut.o \
+./Test/Src/DDataAggregator_ut.o \
+./Test/Src/FlapDamper_ut.o \
 ./Test/Src/InternalMQTTSubscriber_ut.o \
 ./Test/Src/Main_ut.o \
 ./Test/Src/Metric_ut.o \
+./Test/Src/RealDevMetricTable_ut.o \
 ./Test/Src/SCADAHandler_ut.o \
 ./Test/Src/SparkPlugDevices_ut.o \
+./Test/Src/SparkPlugDevicesBenchmark_ut.o \
+./Test/Src/SparkplugCodecBenchmark_ut.o \
+./Test/Src/SparkPlugDevRegistry_ut.o \
 ./Test/Src/SparkPlugUDTMgr_ut.o \
+./Test/Src/SparkplugEncodeArena_ut.o \
+./Test/Src/SparkplugPublisher_ut.o \
 ./Test/Src/SparklugDevMgr_ut.o 
 
 CPP_DEPS += \
 ./Test/Src/Common_ut.d \
+./Test/Src/DDataAggregator_ut.d \
+./Test/Src/FlapDamper_ut.d \
 ./Test/Src/InternalMQTTSubscriber_ut.d \
 ./Test/Src/Main_ut.d \
 ./Test/Src/Metric_ut.d \
+./Test/Src/RealDevMetricTable_ut.d \
 ./Test/Src/SCADAHandler_ut.d \
 ./Test/Src/SparkPlugDevices_ut.d \
+./Test/Src/SparkPlugDevicesBenchmark_ut.d \
+./Test/Src/SparkplugCodecBenchmark_ut.d \
+./Test/Src/SparkPlugDevRegistry_ut.d \
 ./Test/Src/SparkPlugUDTMgr_ut.d \
+./Test/Src/SparkplugEncodeArena_ut.d \
+./Test/Src/SparkplugPublisher_ut.d \
 ./Test/Src/SparklugDevMgr_ut.d 
 
 
@@ -54,7 +78,7 @@ CPP_DEPS += \
 Test/Src/%.o: ../Test/Src/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: GCC C++ Compiler'
-	g++ -std=c++1z -DSCADA_RTU -DUNIT_TEST -I../$(PROJECT_DIR)/include -I../$(PROJECT_DIR)/include/yaml-cpp -I../$(PROJECT_DIR)/include/tahu -I/usr/local/include -O0 -g3 -ftest-coverage -fprofile-arcs -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
+	g++ -std=c++1z -DSCADA_RTU -DUNIT_TEST $(BENCH_CFLAGS) -I../$(PROJECT_DIR)/include -I../$(PROJECT_DIR)/include/yaml-cpp -I../$(PROJECT_DIR)/include/tahu -I/usr/local/include -O0 -g3 -ftest-coverage -fprofile-arcs -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
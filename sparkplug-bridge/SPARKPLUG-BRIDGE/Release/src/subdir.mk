@@ -21,35 +21,53 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../src/Common.cpp \
+../src/DDataAggregator.cpp \
+../src/FlapDamper.cpp \
 ../src/InternalMQTTSubscriber.cpp \
 ../src/Main.cpp \
 ../src/Metric.cpp \
 ../src/QueueMgr.cpp \
+../src/RealDevMetricTable.cpp \
 ../src/SCADAHandler.cpp \
 ../src/SparkPlugDevMgr.cpp \
+../src/SparkPlugDevRegistry.cpp \
 ../src/SparkPlugUDTMgr.cpp \
+../src/SparkplugEncodeArena.cpp \
+../src/SparkplugPublisher.cpp \
 ../src/SparkPlugDevices.cpp 
 
 OBJS += \
 ./src/Common.o \
+./src/DDataAggregator.o \
+./src/FlapDamper.o \
 ./src/InternalMQTTSubscriber.o \
 ./src/Main.o \
 ./src/Metric.o \
 ./src/QueueMgr.o \
+./src/RealDevMetricTable.o \
 ./src/SCADAHandler.o \
 ./src/SparkPlugDevMgr.o \
+./src/SparkPlugDevRegistry.o \
 ./src/SparkPlugUDTMgr.o \
+./src/SparkplugEncodeArena.o \
+./src/SparkplugPublisher.o \
 ./src/SparkPlugDevices.o 
 
 CPP_DEPS += \
 ./src/Common.d \
+./src/DDataAggregator.d \
+./src/FlapDamper.d \
 ./src/InternalMQTTSubscriber.d \
 ./src/Main.d \
 ./src/Metric.d \
 ./src/QueueMgr.d \
+./src/RealDevMetricTable.d \
 ./src/SCADAHandler.d \
 ./src/SparkPlugDevMgr.d \
+./src/SparkPlugDevRegistry.d \
 ./src/SparkPlugUDTMgr.d \
+./src/SparkplugEncodeArena.d \
+./src/SparkplugPublisher.d \
 ./src/SparkPlugDevices.d 
 
 
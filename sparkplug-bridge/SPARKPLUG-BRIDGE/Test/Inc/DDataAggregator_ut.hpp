@@ -0,0 +1,89 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#ifndef TEST_INCLUDE_DDATAAGGREGATOR_UT_H_
+#define TEST_INCLUDE_DDATAAGGREGATOR_UT_H_
+
+#include "DDataAggregator.hpp"
+#include "Metric.hpp"
+
+#ifdef UNIT_TEST
+#include <gtest/gtest.h>
+#endif
+
+/** Metric reporting itself as real-time point */
+class CRTMetric_ut : public CMetric
+{
+public:
+	CRTMetric_ut(std::string a_sName, const CValObj &a_objVal, const uint64_t a_timestamp) :
+		CMetric(a_sName, a_objVal, a_timestamp)
+	{
+	}
+
+	bool isRealTime() const override
+	{
+		return true;
+	}
+};
+
+class DDataAggregator_ut : public::testing::Test
+{
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+	/** Creates DDATA action for one metric of given device */
+	stRefForSparkPlugAction createAction(CSparkPlugDev &a_oDev, const std::string &a_sMetric,
+			int32_t a_iValue, uint64_t a_ui64Timestamp, bool a_bIsRealTime = false)
+	{
+		CValObj oVal(METRIC_DATA_TYPE_INT32, a_iValue);
+		std::shared_ptr<CIfMetric> pMetric;
+		if(true == a_bIsRealTime)
+		{
+			pMetric = std::make_shared<CRTMetric_ut>(a_sMetric, oVal, a_ui64Timestamp);
+		}
+		else
+		{
+			pMetric = std::make_shared<CMetric>(a_sMetric, oVal, a_ui64Timestamp);
+		}
+		pMetric->setTimestamp(a_ui64Timestamp);
+		metricMapIf_t mapMetrics;
+		mapMetrics.emplace(a_sMetric, pMetric);
+		return stRefForSparkPlugAction{std::ref(a_oDev), enMSG_DATA, mapMetrics};
+	}
+
+	/** Creates DDATA action for one metric of real device given by its index in metric table */
+	stRefForSparkPlugAction createSampleAction(CSparkPlugDev &a_oDev, uint32_t a_uiIndex,
+			int32_t a_iValue, uint64_t a_ui64Timestamp)
+	{
+		std::vector<stRealDevMetricSample> vecSamples{
+			stRealDevMetricSample{a_uiIndex, a_ui64Timestamp, CValObj(METRIC_DATA_TYPE_INT32, a_iValue)}};
+		return stRefForSparkPlugAction{std::ref(a_oDev), enMSG_DATA, metricMapIf_t{}, vecSamples};
+	}
+
+public:
+	CSparkPlugDev m_oDev1{"D1", "App1-D1", true};
+	CSparkPlugDev m_oDev2{"D2", "App1-D2", true};
+	std::vector<stRefForSparkPlugAction> m_vecReady;
+};
+
+#endif /* TEST_INCLUDE_DDATAAGGREGATOR_UT_H_ */
@@ -53,6 +53,11 @@ public:
 	org_eclipse_tahu_protobuf_Payload dbirth_payload;
 	std::vector<stRefForSparkPlugAction> stRefActionVec;
 
+	bool _resolveDCMDMetricAlias(CSparkPlugDev& a_SPDev, org_eclipse_tahu_protobuf_Payload_Metric& a_sparkplugMetric)
+	{
+		return CSparkPlugDevManager::getInstance().resolveDCMDMetricAlias(a_SPDev, a_sparkplugMetric);
+	}
+
 };
 
 
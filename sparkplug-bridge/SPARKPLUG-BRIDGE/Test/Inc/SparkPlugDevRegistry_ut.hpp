@@ -0,0 +1,52 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#ifndef TEST_INCLUDE_SPARKPLUGDEVREGISTRY_UT_H_
+#define TEST_INCLUDE_SPARKPLUGDEVREGISTRY_UT_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "SparkPlugDevRegistry.hpp"
+
+#ifdef UNIT_TEST
+#include <gtest/gtest.h>
+#endif
+
+/** Number of devices used by contention tests */
+#define REGISTRY_DEVICE_COUNT 1000
+
+class SparkPlugDevRegistry_ut : public::testing::Test
+{
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+public:
+	std::vector<std::string> m_vecNames;
+	std::atomic<uint32_t> m_uiCreated{0};
+
+	CSparkPlugDev& addDevice(CSparkPlugDevRegistry &a_oRegistry, const std::string &a_sName);
+	double runContention(uint32_t a_uiStripes, uint32_t a_uiThreads, uint32_t a_uiRounds);
+};
+
+#endif /* TEST_INCLUDE_SPARKPLUGDEVREGISTRY_UT_H_ */
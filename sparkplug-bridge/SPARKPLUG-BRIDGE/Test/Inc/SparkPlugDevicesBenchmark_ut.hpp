@@ -0,0 +1,58 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#ifndef TEST_INCLUDE_SPARKPLUGDEVICESBENCHMARK_UT_H_
+#define TEST_INCLUDE_SPARKPLUGDEVICESBENCHMARK_UT_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "SparkPlugDevices.hpp"
+
+#ifdef UNIT_TEST
+#include <gtest/gtest.h>
+#endif
+
+/** Number of devices used by update path benchmark */
+#define BENCH_DEVICE_COUNT 1000
+/** Metric updated in each device */
+#define BENCH_METRIC_NAME "Flow"
+
+/** Benchmark of update path of real devices, i.e. CSparkPlugDev::processRealDeviceUpdateMsg() */
+class SparkPlugDevicesBenchmark_ut : public::testing::Test
+{
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+public:
+	std::vector<std::unique_ptr<CSparkPlugDev>> m_vecDevices;
+
+	static bool isEnabled();
+	static uint32_t readUint(const char *a_pcName, uint32_t a_uiDefault);
+	static std::string createUpdateMsg(uint32_t a_uiDevice, uint32_t a_uiValue);
+
+	void createDevices(uint32_t a_uiCount);
+	uint64_t processUpdates(uint32_t a_uiFirstDev, uint32_t a_uiLastDev, uint32_t a_uiRounds, uint32_t a_uiBase);
+};
+
+#endif /* TEST_INCLUDE_SPARKPLUGDEVICESBENCHMARK_UT_H_ */
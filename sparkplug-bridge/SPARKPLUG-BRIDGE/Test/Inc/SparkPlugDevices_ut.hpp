@@ -99,6 +99,20 @@ public:
 
 		CSparkPlugDev CSparkPlugDev_obj{a_sSubDev, a_sSparkPlugName, a_bIsVendorApp};
 
+		bool _parseRealDeviceUpdateMsg(const std::string &a_sPayLoad, stRealDevUpdate &a_stUpdate)
+		{
+			return CSparkPlugDev::parseRealDeviceUpdateMsg(a_sPayLoad, a_stUpdate);
+		}
+
+		bool _validateRealDeviceUpdateData(const stRealDevUpdate &a_stUpdate, bool &a_bIsGood, bool &a_bIsDeathCode)
+		{
+			return CSparkPlugDev::validateRealDeviceUpdateData(a_stUpdate, a_bIsGood, a_bIsDeathCode);
+		}
+
+		uint64_t _assignAlias(CSparkPlugDev &a_oDev, const std::string &a_sName)
+		{
+			return a_oDev.assignAlias(a_sName);
+		}
 
 
 };
@@ -0,0 +1,118 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#ifndef TEST_INCLUDE_SPARKPLUGCODECBENCHMARK_UT_H_
+#define TEST_INCLUDE_SPARKPLUGCODECBENCHMARK_UT_H_
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "SparkPlugDevMgr.hpp"
+#include "SparkPlugUDTMgr.hpp"
+#include "SparkplugEncodeArena.hpp"
+
+#ifdef UNIT_TEST
+#include <gtest/gtest.h>
+#endif
+
+/** Vendor app whose devices are used by codec benchmark */
+#define BENCH_CODEC_APP "BenchApp"
+/** Default number of metrics in a message */
+#define BENCH_CODEC_DEFAULT_METRICS 1000
+/** Default number of messages measured per case */
+#define BENCH_CODEC_DEFAULT_ITERATIONS 200
+
+/** Allocations made by calling thread, counted by malloc() of test binary built with SPARKPLUG_BENCH_ALLOC_COUNT */
+struct stAllocCount
+{
+	uint64_t m_ui64Count; /** number of allocations*/
+	uint64_t m_ui64Bytes; /** bytes requested by allocations*/
+};
+
+/** Result of a benchmark case */
+struct stCodecBenchResult
+{
+	std::string m_sName; /** name of case*/
+	uint32_t m_uiMetrics; /** metrics in a message*/
+	uint64_t m_ui64Iterations; /** number of messages measured*/
+	uint64_t m_ui64ElapsedNs; /** time taken by all messages*/
+	stAllocCount m_stAllocs; /** allocations made by all messages*/
+	size_t m_uiMsgBytes; /** size of encoded message, 0 if case does not encode*/
+};
+
+/** Microbenchmark of Sparkplug encode and decode paths: DDATA of each datatype, DBIRTH with
+ * nested UDTs, DCMD decode and dispatch, and parsing of vendor app birth message */
+class SparkplugCodecBenchmark_ut : public::testing::Test
+{
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+public:
+	std::vector<stCodecBenchResult> m_vecResults;
+
+	static stAllocCount getAllocCount();
+	static bool isAllocCounted();
+	static const std::vector<std::string>& getDataTypes();
+	static std::string createMetricJson(const std::string &a_sName, const std::string &a_sDataType, uint32_t a_uiValue);
+	static std::string createVendorAppMsg(const std::string &a_sDataType, uint32_t a_uiCount, uint32_t a_uiValue);
+	static std::string createUDTInstanceJson(const std::string &a_sName, uint32_t a_uiValue);
+	static void defineBenchUDTs();
+
+	bool addVendorDev(const std::string &a_sSubDev, const std::string &a_sBirthMsg);
+	bool getChangedMetrics(const std::string &a_sSubDev, const std::string &a_sDataMsg,
+			CSparkPlugDev *&a_pDev, metricMapIf_t &a_mapChanged);
+	bool encodeDDATA(CSparkPlugDev &a_oDev, const metricMapIf_t &a_mapChanged, std::string &a_sEncoded);
+	bool encodeDBIRTH(const std::string &a_sDevName, std::string &a_sEncoded);
+	bool encodeDCMD(uint32_t a_uiCount, std::string &a_sEncoded);
+	bool processDCMD(const std::string &a_sTopic, const std::string &a_sEncoded, size_t &a_uiActions);
+	void report() const;
+
+	/**
+	 * Measures given operation; allocations are counted for calling thread
+	 * @param a_sName :[in] name of case
+	 * @param a_uiMetrics :[in] metrics in a message
+	 * @param a_ui64Iterations :[in] number of times operation is called
+	 * @param a_fnOp :[in] operation, gives size of encoded message or 0
+	 * @return None
+	 */
+	template<typename Op>
+	void measure(const std::string &a_sName, uint32_t a_uiMetrics, uint64_t a_ui64Iterations, Op a_fnOp)
+	{
+		size_t uiMsgBytes = 0;
+		stAllocCount stStart = getAllocCount();
+		auto start = std::chrono::steady_clock::now();
+		for(uint64_t ui64Iter = 0; ui64Iter < a_ui64Iterations; ++ui64Iter)
+		{
+			uiMsgBytes = a_fnOp();
+		}
+		auto end = std::chrono::steady_clock::now();
+		stAllocCount stEnd = getAllocCount();
+
+		m_vecResults.push_back({a_sName, a_uiMetrics, a_ui64Iterations,
+			(uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+			{stEnd.m_ui64Count - stStart.m_ui64Count, stEnd.m_ui64Bytes - stStart.m_ui64Bytes},
+			uiMsgBytes});
+	}
+};
+
+#endif /* TEST_INCLUDE_SPARKPLUGCODECBENCHMARK_UT_H_ */
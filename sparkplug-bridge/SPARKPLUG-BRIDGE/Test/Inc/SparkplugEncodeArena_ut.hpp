@@ -20,39 +20,36 @@
 * SOFTWARE.
 *********************************************************************************/
 
-/**
- * Queue manager file contains class to manage instances of on-demand operations for msg handling
- */
+#ifndef TEST_INCLUDE_SPARKPLUGENCODEARENA_UT_H_
+#define TEST_INCLUDE_SPARKPLUGENCODEARENA_UT_H_
 
-#ifndef QMGR_HPP_
-#define QMGR_HPP_
+#include "SparkplugEncodeArena.hpp"
+extern "C"
+{
+#include <tahu.h>
+}
 
-#include "QueueHandler.hpp"
+#ifdef UNIT_TEST
+#include <gtest/gtest.h>
+#endif
 
-/**
- * namespace for Queue manager
- */
-namespace QMgr
-{
-/**
- * Queue manager class to manage instances of on-demand operations for msg handling
- */
-class CQueueMgr : public CQueueHandler
+class SparkplugEncodeArena_ut : public::testing::Test
 {
-	bool m_bIsRead;		/*!< a bool value for on-demand read/write operation*/
-	bool m_bIsRealTime; /*!< a bool value for on-demand real-time read/write operation*/
-public:
-	CQueueMgr(bool isRead, bool isRealTime);
-	~CQueueMgr();
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+	/** Adds a string metric with given value length to payload */
+	void addStringMetric(size_t a_uiLength)
+	{
+		std::string sValue(a_uiLength, 'a');
+		add_simple_metric(&m_payload, "Properties/Value", false, 0,
+				METRIC_DATA_TYPE_STRING, false, false, sValue.c_str(), sValue.length() + 1);
+	}
 
-	bool isRead() {return m_bIsRead;};
-	bool isRealTime() {return m_bIsRealTime;};
+public:
+	org_eclipse_tahu_protobuf_Payload m_payload;
+	std::string m_sBuffer;
 };
 
-//functions to get on-demand operation instances
-CQueueMgr& getRead();
-CQueueMgr& getWrite();
-CQueueMgr& getRTRead();
-CQueueMgr& getRTWrite();
-}
-#endif
+#endif /* TEST_INCLUDE_SPARKPLUGENCODEARENA_UT_H_ */
@@ -0,0 +1,72 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#ifndef TEST_INCLUDE_SPARKPLUGPUBLISHER_UT_H_
+#define TEST_INCLUDE_SPARKPLUGPUBLISHER_UT_H_
+
+#include <vector>
+#include "SparkplugPublisher.hpp"
+extern "C"
+{
+#include <tahu.h>
+}
+
+#ifdef UNIT_TEST
+#include <gtest/gtest.h>
+#endif
+
+class SparkplugPublisher_ut : public::testing::Test
+{
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+	/** Fake MQTT client; refuses first m_iFailCount messages and records topics and payloads of others */
+	bool publish(mqtt::message_ptr &a_pMsg)
+	{
+		std::lock_guard<std::mutex> lck(m_mutexTopics);
+		if(m_iFailCount > 0)
+		{
+			--m_iFailCount;
+			return false;
+		}
+		m_vecTopics.push_back(a_pMsg->get_topic());
+		m_vecPayloads.push_back(a_pMsg->get_payload_str());
+		return true;
+	}
+
+	/** Creates publisher using fake MQTT client */
+	CSparkplugPublisher* createPublisher(size_t a_uiMaxQueued)
+	{
+		return new CSparkplugPublisher([this](mqtt::message_ptr &a_pMsg) { return publish(a_pMsg); },
+				a_uiMaxQueued, 1);
+	}
+
+public:
+	org_eclipse_tahu_protobuf_Payload m_payload;
+	std::mutex m_mutexTopics;
+	std::vector<std::string> m_vecTopics;
+	std::vector<std::string> m_vecPayloads;
+	int m_iFailCount = 0;
+};
+
+#endif /* TEST_INCLUDE_SPARKPLUGPUBLISHER_UT_H_ */
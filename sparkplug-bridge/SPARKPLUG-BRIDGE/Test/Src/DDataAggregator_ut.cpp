@@ -0,0 +1,224 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../Inc/DDataAggregator_ut.hpp"
+
+void DDataAggregator_ut::SetUp()
+{
+	// Setup code
+}
+
+void DDataAggregator_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**
+ * Test case to check that updates of 200 metrics of a device within a window
+ * are published as a single DDATA carrying timestamp of each metric
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(DDataAggregator_ut, add_MergesDeviceWindow)
+{
+	CDDataAggregator oWindow(1000, 500, true);
+	for(int32_t iLoop = 0; iLoop < 200; ++iLoop)
+	{
+		EXPECT_TRUE(oWindow.add(createAction(m_oDev1, "M" + std::to_string(iLoop), iLoop, 1000 + iLoop),
+				10 + iLoop, m_vecReady));
+	}
+	EXPECT_TRUE(m_vecReady.empty());
+	EXPECT_EQ(200u, oWindow.getPendingMetricCount());
+
+	// window is open till 1010
+	oWindow.takeExpired(1009, m_vecReady);
+	EXPECT_TRUE(m_vecReady.empty());
+
+	oWindow.takeExpired(1010, m_vecReady);
+	ASSERT_EQ(1u, m_vecReady.size());
+	EXPECT_EQ(enMSG_DATA, m_vecReady[0].m_enAction);
+	EXPECT_EQ("App1-D1", m_vecReady[0].m_refSparkPlugDev.get().getSparkPlugName());
+	ASSERT_EQ(200u, m_vecReady[0].m_mapChangedMetrics.size());
+	EXPECT_EQ(1005u, m_vecReady[0].m_mapChangedMetrics["M5"]->getTimestamp());
+	EXPECT_EQ(1199u, m_vecReady[0].m_mapChangedMetrics["M199"]->getTimestamp());
+	EXPECT_EQ(0u, oWindow.getPendingMetricCount());
+}
+
+/**
+ * Test case to check that a later value of a metric replaces the pending value
+ * and windows of different devices are kept apart
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(DDataAggregator_ut, add_LaterValueReplaces)
+{
+	CDDataAggregator oWindow(100, 500, true);
+	oWindow.add(createAction(m_oDev1, "M1", 1, 1000), 0, m_vecReady);
+	oWindow.add(createAction(m_oDev1, "M1", 2, 2000), 10, m_vecReady);
+	oWindow.add(createAction(m_oDev2, "M1", 3, 3000), 50, m_vecReady);
+	EXPECT_EQ(2u, oWindow.getPendingMetricCount());
+
+	// only first device window has elapsed
+	oWindow.takeExpired(120, m_vecReady);
+	ASSERT_EQ(1u, m_vecReady.size());
+	ASSERT_EQ(1u, m_vecReady[0].m_mapChangedMetrics.size());
+	EXPECT_EQ(2000u, m_vecReady[0].m_mapChangedMetrics["M1"]->getTimestamp());
+	EXPECT_EQ(1u, oWindow.getPendingMetricCount());
+}
+
+/**
+ * Test case to check that changed metrics of a real device are merged by their index
+ * in metric table and keep value and timestamp of latest update
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(DDataAggregator_ut, add_MergesRealDevSamples)
+{
+	CDDataAggregator oWindow(100, 3, true);
+	oWindow.add(createSampleAction(m_oDev1, 0, 1, 1000), 0, m_vecReady);
+	oWindow.add(createSampleAction(m_oDev1, 1, 2, 1000), 0, m_vecReady);
+	oWindow.add(createSampleAction(m_oDev1, 0, 3, 2000), 10, m_vecReady);
+	EXPECT_EQ(2u, oWindow.getPendingMetricCount());
+
+	oWindow.takeExpired(100, m_vecReady);
+	ASSERT_EQ(1u, m_vecReady.size());
+	EXPECT_TRUE(m_vecReady[0].m_mapChangedMetrics.empty());
+	ASSERT_EQ(2u, m_vecReady[0].m_vecChangedSamples.size());
+	EXPECT_EQ(0u, m_vecReady[0].m_vecChangedSamples[0].m_uiIndex);
+	EXPECT_EQ(2000u, m_vecReady[0].m_vecChangedSamples[0].m_ui64Timestamp);
+	EXPECT_EQ(3, std::get<int32_t>(m_vecReady[0].m_vecChangedSamples[0].m_oValue.getValue()));
+	EXPECT_EQ(1u, m_vecReady[0].m_vecChangedSamples[1].m_uiIndex);
+}
+
+/**
+ * Test case to check that window is closed once max metrics are pending
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(DDataAggregator_ut, add_SizeBound)
+{
+	CDDataAggregator oWindow(60000, 3, true);
+	oWindow.add(createAction(m_oDev1, "M1", 1, 1000), 0, m_vecReady);
+	oWindow.add(createAction(m_oDev1, "M2", 2, 1000), 0, m_vecReady);
+	EXPECT_TRUE(m_vecReady.empty());
+	oWindow.add(createAction(m_oDev1, "M3", 3, 1000), 0, m_vecReady);
+	ASSERT_EQ(1u, m_vecReady.size());
+	EXPECT_EQ(3u, m_vecReady[0].m_mapChangedMetrics.size());
+	EXPECT_EQ(0u, oWindow.getPendingMetricCount());
+}
+
+/**
+ * Test case to check that pending value is a copy which is not changed by later
+ * updates of device metric
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(DDataAggregator_ut, add_KeepsValueOfUpdate)
+{
+	CDDataAggregator oWindow(100, 500, true);
+	stRefForSparkPlugAction stAction = createAction(m_oDev1, "M1", 1, 1000);
+	oWindow.add(stAction, 0, m_vecReady);
+
+	stAction.m_mapChangedMetrics["M1"]->setTimestamp(5000);
+	oWindow.takeAll(m_vecReady);
+	ASSERT_EQ(1u, m_vecReady.size());
+	EXPECT_EQ(1000u, m_vecReady[0].m_mapChangedMetrics["M1"]->getTimestamp());
+}
+
+/**
+ * Test case to check that DDATA is returned as is when window is disabled
+ * or when it has real-time metric and RT bypass is enabled
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(DDataAggregator_ut, add_Bypass)
+{
+	CDDataAggregator oDisabled(0, 500, true);
+	EXPECT_FALSE(oDisabled.isEnabled());
+	EXPECT_FALSE(oDisabled.add(createAction(m_oDev1, "M1", 1, 1000), 0, m_vecReady));
+	EXPECT_EQ(1u, m_vecReady.size());
+	m_vecReady.clear();
+
+	CDDataAggregator oWindow(100, 500, true);
+	oWindow.add(createAction(m_oDev1, "M1", 1, 1000), 0, m_vecReady);
+	EXPECT_FALSE(oWindow.add(createAction(m_oDev1, "M1", 2, 2000, true), 0, m_vecReady));
+	ASSERT_EQ(1u, m_vecReady.size());
+	EXPECT_EQ(2000u, m_vecReady[0].m_mapChangedMetrics["M1"]->getTimestamp());
+	// pending older value of bypassed metric is dropped
+	EXPECT_EQ(0u, oWindow.getPendingMetricCount());
+	m_vecReady.clear();
+
+	CDDataAggregator oNoBypass(100, 500, false);
+	EXPECT_TRUE(oNoBypass.add(createAction(m_oDev1, "M1", 1, 1000, true), 0, m_vecReady));
+	EXPECT_TRUE(m_vecReady.empty());
+}
+
+/**
+ * Test case to check that pending DDATA of a device can be taken before its
+ * DBIRTH or DDEATH and discarded when SCADA session is down
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(DDataAggregator_ut, take_Discard)
+{
+	CDDataAggregator oWindow(100, 500, true);
+	oWindow.add(createAction(m_oDev1, "M1", 1, 1000), 0, m_vecReady);
+	oWindow.add(createAction(m_oDev2, "M1", 1, 1000), 0, m_vecReady);
+
+	EXPECT_FALSE(oWindow.take("App1-D3", m_vecReady));
+	EXPECT_TRUE(oWindow.take("App1-D2", m_vecReady));
+	ASSERT_EQ(1u, m_vecReady.size());
+	EXPECT_EQ("App1-D2", m_vecReady[0].m_refSparkPlugDev.get().getSparkPlugName());
+
+	EXPECT_EQ(1u, oWindow.discardAll());
+	EXPECT_EQ(0u, oWindow.getPendingMetricCount());
+}
+
+/**
+ * Test case to check packets per second and bytes per metric statistics
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(DDataAggregator_ut, getStats)
+{
+	CDDataAggregator oWindow(100, 500, true);
+	double dPacketsPerSec = 0, dBytesPerMetric = 0;
+	uint64_t ui64StartMs = CDDataAggregator::getMonotonicMs();
+	oWindow.getStats(ui64StartMs, dPacketsPerSec, dBytesPerMetric);
+
+	oWindow.recordPacket(200, 4000);
+	oWindow.recordPacket(100, 2000);
+	EXPECT_TRUE(oWindow.getStats(ui64StartMs + 2000, dPacketsPerSec, dBytesPerMetric));
+	EXPECT_DOUBLE_EQ(1.0, dPacketsPerSec);
+	EXPECT_DOUBLE_EQ(20.0, dBytesPerMetric);
+
+	// counters are reset for next interval
+	EXPECT_FALSE(oWindow.getStats(ui64StartMs + 3000, dPacketsPerSec, dBytesPerMetric));
+}
@@ -0,0 +1,154 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../Inc/FlapDamper_ut.hpp"
+
+void FlapDamper_ut::SetUp()
+{
+	// Setup code
+}
+
+void FlapDamper_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**
+ * Test case to check that first up and up after a stable period are announced at once
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(FlapDamper_ut, takeAnnouncement_StableLink)
+{
+	EXPECT_FALSE(m_oDamper.takeAnnouncement(0));
+	m_oDamper.linkUp(100);
+	EXPECT_TRUE(m_oDamper.takeAnnouncement(100));
+	EXPECT_EQ(enFLAP_ANNOUNCED, m_oDamper.getState());
+	// announced only once per up
+	EXPECT_FALSE(m_oDamper.takeAnnouncement(200));
+
+	m_oDamper.linkDown(100 + 30000);
+	EXPECT_EQ(0u, m_oDamper.getHoldDownMs());
+	m_oDamper.linkUp(100 + 31000);
+	EXPECT_TRUE(m_oDamper.takeAnnouncement(100 + 31000));
+	EXPECT_EQ(0u, m_oDamper.getSuppressedCount());
+}
+
+/**
+ * Test case to check that hold-down doubles with each flap up to max and
+ * ups which go down during hold-down are not announced
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(FlapDamper_ut, takeAnnouncement_FlappingLink)
+{
+	uint64_t ui64NowMs = 0;
+	m_oDamper.linkUp(ui64NowMs);
+	EXPECT_TRUE(m_oDamper.takeAnnouncement(ui64NowMs));
+
+	uint32_t auiHoldDownMs[] = {1000, 2000, 4000, 8000, 8000};
+	for(uint32_t uiHoldDownMs : auiHoldDownMs)
+	{
+		ui64NowMs += 500;
+		m_oDamper.linkDown(ui64NowMs);
+		EXPECT_EQ(uiHoldDownMs, m_oDamper.getHoldDownMs());
+		ui64NowMs += 100;
+		m_oDamper.linkUp(ui64NowMs);
+		EXPECT_EQ(enFLAP_HOLD, m_oDamper.getState());
+		EXPECT_EQ(ui64NowMs + uiHoldDownMs, m_oDamper.getAnnounceAtMs());
+		EXPECT_FALSE(m_oDamper.takeAnnouncement(ui64NowMs + uiHoldDownMs - 1));
+	}
+	// none of the flaps is announced
+	EXPECT_EQ(4u, m_oDamper.getSuppressedCount());
+
+	// link which stays up through hold-down is announced once
+	EXPECT_TRUE(m_oDamper.takeAnnouncement(m_oDamper.getAnnounceAtMs()));
+	EXPECT_FALSE(m_oDamper.takeAnnouncement(m_oDamper.getAnnounceAtMs() + 1));
+}
+
+/**
+ * Test case to check that repeated up or down events are coalesced
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(FlapDamper_ut, linkUp_Coalesced)
+{
+	m_oDamper.linkUp(0);
+	m_oDamper.linkDown(10);
+	m_oDamper.linkDown(20);
+	EXPECT_EQ(1000u, m_oDamper.getHoldDownMs());
+
+	m_oDamper.linkUp(30);
+	m_oDamper.linkUp(900);
+	// second up does not move end of hold-down
+	EXPECT_EQ(1030u, m_oDamper.getAnnounceAtMs());
+	EXPECT_TRUE(m_oDamper.takeAnnouncement(1030));
+}
+
+/**
+ * Test case to check that hold-down of 0 announces each up at once
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(FlapDamper_ut, takeAnnouncement_Disabled)
+{
+	CFlapDamper oDamper(0, 0, 30000);
+	for(uint64_t ui64NowMs = 0; ui64NowMs < 1000; ui64NowMs += 100)
+	{
+		oDamper.linkUp(ui64NowMs);
+		EXPECT_TRUE(oDamper.takeAnnouncement(ui64NowMs));
+		oDamper.linkDown(ui64NowMs + 50);
+		EXPECT_EQ(0u, oDamper.getHoldDownMs());
+	}
+}
+
+/**
+ * Test case to check that announced link is announced again on request
+ * and that request does not cut short a hold-down
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(FlapDamper_ut, reannounce_AnnouncedLink)
+{
+	m_oDamper.reannounce(0);
+	EXPECT_EQ(enFLAP_DOWN, m_oDamper.getState());
+
+	m_oDamper.linkUp(0);
+	EXPECT_TRUE(m_oDamper.takeAnnouncement(0));
+	m_oDamper.reannounce(50000);
+	EXPECT_TRUE(m_oDamper.takeAnnouncement(50000));
+	EXPECT_FALSE(m_oDamper.takeAnnouncement(50001));
+
+	// flap starts hold-down
+	m_oDamper.linkDown(50100);
+	m_oDamper.linkUp(50200);
+	m_oDamper.linkDown(50300);
+	m_oDamper.linkUp(50400);
+	m_oDamper.reannounce(50500);
+	EXPECT_EQ(50400u + 1000u, m_oDamper.getAnnounceAtMs());
+	EXPECT_FALSE(m_oDamper.takeAnnouncement(50500));
+}
@@ -399,6 +399,34 @@ TEST_F(Metric_ut, Add_MetricFor_Birth)
 	EXPECT_EQ(true, result);
 }
 
+/**
+ * Test case to check that metric given an alias is added with name and alias for birth
+ * and only with alias otherwise
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(Metric_ut, addMetricNameValue_Alias)
+{
+	CMetric oMetric{"Flow", CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)5), 1486144502122};
+	oMetric.setAlias(7);
+
+	org_eclipse_tahu_protobuf_Payload_Metric oBirth = org_eclipse_tahu_protobuf_Payload_Metric_init_default;
+	EXPECT_TRUE(oMetric.addMetricForBirth(oBirth));
+	ASSERT_TRUE(NULL != oBirth.name);
+	EXPECT_STREQ("Flow", oBirth.name);
+	EXPECT_TRUE(oBirth.has_alias);
+	EXPECT_EQ(7u, oBirth.alias);
+	free(oBirth.name);
+
+	org_eclipse_tahu_protobuf_Payload_Metric oData = org_eclipse_tahu_protobuf_Payload_Metric_init_default;
+	EXPECT_TRUE(oMetric.addMetricNameValue(oData));
+	EXPECT_TRUE(NULL == oData.name);
+	EXPECT_TRUE(oData.has_alias);
+	EXPECT_EQ(7u, oData.alias);
+	EXPECT_EQ(5u, oData.value.long_value);
+}
+
 
 /**
  * Test case to check addMetricForBirth() behavior
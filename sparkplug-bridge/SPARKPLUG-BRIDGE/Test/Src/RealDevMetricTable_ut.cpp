@@ -0,0 +1,136 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../Inc/RealDevMetricTable_ut.hpp"
+
+void RealDevMetricTable_ut::SetUp()
+{
+	// Setup code
+}
+
+void RealDevMetricTable_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**
+ * Test case to check that metrics get dense indexes in order of addition and
+ * a metric name is added only once
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(RealDevMetricTable_ut, add_DenseIndex)
+{
+	EXPECT_EQ(0u, m_oTable.add("Flow", CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)0), NULL));
+	EXPECT_EQ(1u, m_oTable.add("Pressure", CValObj(METRIC_DATA_TYPE_FLOAT, (float)0), NULL));
+	EXPECT_EQ(REAL_DEV_METRIC_INVALID_INDEX, m_oTable.add("Flow", CValObj(METRIC_DATA_TYPE_INT16, (int16_t)0), NULL));
+	EXPECT_EQ(2u, m_oTable.size());
+
+	EXPECT_EQ(1u, m_oTable.findIndex("Pressure"));
+	EXPECT_EQ(REAL_DEV_METRIC_INVALID_INDEX, m_oTable.findIndex("Level"));
+	EXPECT_EQ("Flow", m_oTable.getName(0));
+	EXPECT_EQ(METRIC_DATA_TYPE_FLOAT, m_oTable.getDataType(1));
+	EXPECT_FALSE(m_oTable.isRealTime(0));
+}
+
+/**
+ * Test case to check that value of each datatype reads back as it was set
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(RealDevMetricTable_ut, setValue_AllDataTypes)
+{
+	std::vector<CValObj> vecValues{
+		CValObj(METRIC_DATA_TYPE_BOOLEAN, true),
+		CValObj(METRIC_DATA_TYPE_UINT16, (uint16_t)65535),
+		CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)4000000000u),
+		CValObj(METRIC_DATA_TYPE_UINT64, (uint64_t)18000000000000000000u),
+		CValObj(METRIC_DATA_TYPE_INT16, (int16_t)-2),
+		CValObj(METRIC_DATA_TYPE_INT32, (int32_t)-70000),
+		CValObj(METRIC_DATA_TYPE_INT64, (int64_t)-5000000000),
+		CValObj(METRIC_DATA_TYPE_FLOAT, (float)-1.5),
+		CValObj(METRIC_DATA_TYPE_DOUBLE, (double)3.25e100),
+		CValObj(METRIC_DATA_TYPE_STRING, std::string("a value longer than small string buffer"))
+	};
+	for(size_t iLoop = 0; iLoop < vecValues.size(); ++iLoop)
+	{
+		uint32_t uiIndex = m_oTable.add("M" + std::to_string(iLoop),
+				CValObj(vecValues[iLoop].getDataType(), var_t{}), NULL);
+		ASSERT_EQ(iLoop, uiIndex);
+		EXPECT_EQ(VALUES_DIFFERENT, m_oTable.compareValue(uiIndex, vecValues[iLoop]));
+		EXPECT_TRUE(m_oTable.setValue(uiIndex, vecValues[iLoop]));
+		EXPECT_EQ(SAMEVALUE_OR_DTATYPE, m_oTable.compareValue(uiIndex, vecValues[iLoop]));
+		EXPECT_TRUE(m_oTable.getValue(uiIndex).getValue() == vecValues[iLoop].getValue());
+	}
+}
+
+/**
+ * Test case to check that value of other datatype is not set and timestamp is kept per metric
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(RealDevMetricTable_ut, setValue_DataTypeMismatch)
+{
+	m_oTable.add("Flow", CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)7), NULL);
+	m_oTable.add("Level", CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)8), NULL);
+	CValObj oInt16(METRIC_DATA_TYPE_INT16, (int16_t)7);
+	EXPECT_EQ(DATATYPE_DIFFERENT, m_oTable.compareValue(0, oInt16));
+	EXPECT_FALSE(m_oTable.setValue(0, oInt16));
+	EXPECT_FALSE(m_oTable.setValue(5, oInt16));
+	EXPECT_TRUE(std::get<uint32_t>(m_oTable.getValue(0).getValue()) == 7);
+
+	m_oTable.setTimestamp(0, 1000);
+	m_oTable.setTimestamp(1, 2000);
+	EXPECT_EQ(1000u, m_oTable.getTimestamp(0));
+	EXPECT_EQ(2000u, m_oTable.getTimestamp(1));
+}
+
+/**
+ * Test case to check that version of table changes when a metric is added or a value
+ * changes, and not when same value or only timestamp is set
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(RealDevMetricTable_ut, getVersion_ChangesWithValue)
+{
+	uint64_t ui64Version = m_oTable.getVersion();
+	m_oTable.add("Flow", CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)7), NULL);
+	m_oTable.add("Name", CValObj(METRIC_DATA_TYPE_STRING, std::string("pump")), NULL);
+	EXPECT_NE(ui64Version, m_oTable.getVersion());
+
+	ui64Version = m_oTable.getVersion();
+	EXPECT_TRUE(m_oTable.setValue(0, CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)7)));
+	EXPECT_TRUE(m_oTable.setValue(1, CValObj(METRIC_DATA_TYPE_STRING, std::string("pump"))));
+	m_oTable.setTimestamp(0, 1000);
+	EXPECT_EQ(ui64Version, m_oTable.getVersion());
+
+	EXPECT_TRUE(m_oTable.setValue(0, CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)8)));
+	EXPECT_NE(ui64Version, m_oTable.getVersion());
+
+	ui64Version = m_oTable.getVersion();
+	EXPECT_TRUE(m_oTable.setValue(1, CValObj(METRIC_DATA_TYPE_STRING, std::string("valve"))));
+	EXPECT_NE(ui64Version, m_oTable.getVersion());
+}
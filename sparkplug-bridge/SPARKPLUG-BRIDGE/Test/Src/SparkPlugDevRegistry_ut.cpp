@@ -0,0 +1,233 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <stdlib.h>
+#include "../Inc/SparkPlugDevRegistry_ut.hpp"
+#include "../Inc/SparkPlugDevicesBenchmark_ut.hpp"
+
+void SparkPlugDevRegistry_ut::SetUp()
+{
+	m_vecNames.clear();
+	for(uint32_t uiDev = 0; uiDev < REGISTRY_DEVICE_COUNT; ++uiDev)
+	{
+		m_vecNames.push_back("App" + std::to_string(uiDev % 10) + "-D" + std::to_string(uiDev));
+	}
+	m_uiCreated = 0;
+}
+
+void SparkPlugDevRegistry_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**
+ * Adds a vendor app device to registry, counting devices actually created
+ * @param a_oRegistry :[in] registry
+ * @param a_sName :[in] sparkplug name of device
+ * @return reference of device
+ */
+CSparkPlugDev& SparkPlugDevRegistry_ut::addDevice(CSparkPlugDevRegistry &a_oRegistry, const std::string &a_sName)
+{
+	bool bIsNew = false;
+	CSparkPlugDev &oDev = a_oRegistry.findOrAdd(a_sName,
+		[&]() { return CSparkPlugDev{"D", a_sName, true}; },
+		[&](CSparkPlugDev &a_oNewDev) { ++m_uiCreated; }, bIsNew);
+	return oDev;
+}
+
+/**
+ * Runs threads which look up devices for updates while one more thread keeps
+ * adding new devices as births do
+ * @param a_uiStripes :[in] number of stripes of registry
+ * @param a_uiThreads :[in] number of update threads
+ * @param a_uiRounds :[in] lookups of all devices per update thread
+ * @return time taken in seconds
+ */
+double SparkPlugDevRegistry_ut::runContention(uint32_t a_uiStripes, uint32_t a_uiThreads, uint32_t a_uiRounds)
+{
+	CSparkPlugDevRegistry oRegistry(a_uiStripes);
+	for(auto &sName : m_vecNames)
+	{
+		addDevice(oRegistry, sName);
+	}
+
+	std::atomic<bool> bStop{false};
+	std::thread oBirthThread([&]() {
+		uint32_t uiNew = 0;
+		while(false == bStop)
+		{
+			addDevice(oRegistry, "Birth-D" + std::to_string(uiNew++));
+		}
+	});
+
+	std::vector<std::thread> vecThreads;
+	auto start = std::chrono::steady_clock::now();
+	for(uint32_t uiThread = 0; uiThread < a_uiThreads; ++uiThread)
+	{
+		vecThreads.emplace_back([&]() {
+			for(uint32_t uiRound = 0; uiRound < a_uiRounds; ++uiRound)
+			{
+				for(auto &sName : m_vecNames)
+				{
+					CSparkPlugDev *pDev = oRegistry.find(sName);
+					if(NULL != pDev)
+					{
+						pDev->setKnownDevStatus(enDEVSTATUS_UP);
+					}
+				}
+			}
+		});
+	}
+	for(auto &oThread : vecThreads)
+	{
+		oThread.join();
+	}
+	double dElapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	bStop = true;
+	oBirthThread.join();
+	return dElapsedSec;
+}
+
+/**
+ * Test case to check that a device is created only once when it is added by
+ * several threads at the same time and that names are listed in sorted order
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevRegistry_ut, findOrAdd_Concurrent)
+{
+	CSparkPlugDevRegistry oRegistry;
+	std::vector<std::thread> vecThreads;
+	for(uint32_t uiThread = 0; uiThread < 8; ++uiThread)
+	{
+		vecThreads.emplace_back([&]() {
+			for(auto &sName : m_vecNames)
+			{
+				CSparkPlugDev &oDev = addDevice(oRegistry, sName);
+				EXPECT_EQ(&oDev, oRegistry.find(sName));
+			}
+		});
+	}
+	for(auto &oThread : vecThreads)
+	{
+		oThread.join();
+	}
+	EXPECT_EQ((uint32_t)REGISTRY_DEVICE_COUNT, m_uiCreated.load());
+	EXPECT_EQ((size_t)REGISTRY_DEVICE_COUNT, oRegistry.size());
+	EXPECT_EQ(nullptr, oRegistry.find("App1-D2"));
+
+	std::vector<std::string> vecNames = oRegistry.getNames();
+	ASSERT_EQ((size_t)REGISTRY_DEVICE_COUNT, vecNames.size());
+	EXPECT_TRUE(std::is_sorted(vecNames.begin(), vecNames.end()));
+}
+
+/**
+ * Test case to check that lookup of a device is not blocked while a device
+ * of another stripe is being added
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevRegistry_ut, find_NotBlockedByAdd)
+{
+	CSparkPlugDevRegistry oRegistry;
+	std::string sOther;
+	for(auto &sName : m_vecNames)
+	{
+		if(oRegistry.getStripe(sName) != oRegistry.getStripe("App1-Birth"))
+		{
+			sOther = sName;
+			break;
+		}
+	}
+	ASSERT_FALSE(sOther.empty());
+	addDevice(oRegistry, sOther);
+
+	std::mutex mutexAdd;
+	std::condition_variable cvAdd;
+	bool bInAdd = false, bRelease = false;
+	std::thread oBirthThread([&]() {
+		bool bIsNew = false;
+		oRegistry.findOrAdd("App1-Birth",
+			[&]() { return CSparkPlugDev{"Birth", "App1-Birth", true}; },
+			[&](CSparkPlugDev &a_oNewDev)
+			{
+				std::unique_lock<std::mutex> lck(mutexAdd);
+				bInAdd = true;
+				cvAdd.notify_all();
+				cvAdd.wait(lck, [&]() { return bRelease; });
+			}, bIsNew);
+	});
+	{
+		std::unique_lock<std::mutex> lck(mutexAdd);
+		cvAdd.wait(lck, [&]() { return bInAdd; });
+	}
+
+	// birth is in progress while other device is looked up
+	EXPECT_NE(nullptr, oRegistry.find(sOther));
+	{
+		std::lock_guard<std::mutex> lck(mutexAdd);
+		bRelease = true;
+	}
+	cvAdd.notify_all();
+	oBirthThread.join();
+	EXPECT_NE(nullptr, oRegistry.find("App1-Birth"));
+}
+
+/**
+ * Benchmark of device lookups by update threads while births add devices, with a single
+ * lock (1 stripe) and with default number of stripes. Configured by environment variables
+ * BENCH_THREADS (default 4) and BENCH_ROUNDS (default 200). Result is written as JSON
+ * on standard output.
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevRegistry_ut, benchmark_Contention)
+{
+	if(false == SparkPlugDevicesBenchmark_ut::isEnabled())
+	{
+		std::cout << "Set SPARKPLUG_BENCHMARK=true to run device registry contention benchmark" << std::endl;
+		return;
+	}
+	uint32_t uiThreads = SparkPlugDevicesBenchmark_ut::readUint("BENCH_THREADS", 4);
+	uint32_t uiRounds = SparkPlugDevicesBenchmark_ut::readUint("BENCH_ROUNDS", 200);
+	uint64_t ui64Lookups = (uint64_t)uiThreads * uiRounds * REGISTRY_DEVICE_COUNT;
+
+	double dSingleSec = runContention(1, uiThreads, uiRounds);
+	double dStripedSec = runContention(SPARKPLUG_DEV_REGISTRY_STRIPES, uiThreads, uiRounds);
+
+	std::ostringstream oss;
+	oss << "{\"devices\":" << REGISTRY_DEVICE_COUNT
+		<< ",\"threads\":" << uiThreads
+		<< ",\"rounds\":" << uiRounds
+		<< ",\"single_lock_lookups_per_sec\":" << (uint64_t)(ui64Lookups / std::max(dSingleSec, 1e-9))
+		<< ",\"striped_lookups_per_sec\":" << (uint64_t)(ui64Lookups / std::max(dStripedSec, 1e-9))
+		<< ",\"stripes\":" << SPARKPLUG_DEV_REGISTRY_STRIPES << "}";
+	std::cout << oss.str() << std::endl;
+}
@@ -0,0 +1,198 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <stdlib.h>
+#include "../Inc/SparkPlugDevicesBenchmark_ut.hpp"
+
+void SparkPlugDevicesBenchmark_ut::SetUp()
+{
+	createDevices(BENCH_DEVICE_COUNT);
+}
+
+void SparkPlugDevicesBenchmark_ut::TearDown()
+{
+	m_vecDevices.clear();
+}
+
+/**
+ * Benchmark runs only when SPARKPLUG_BENCHMARK is "true", as it needs some seconds
+ * @return true if benchmark is to be run
+ */
+bool SparkPlugDevicesBenchmark_ut::isEnabled()
+{
+	const char *pcEnabled = std::getenv("SPARKPLUG_BENCHMARK");
+	return (NULL != pcEnabled) && (std::string(pcEnabled) == "true");
+}
+
+/**
+ * Reads a number from environment variable
+ * @param a_pcName :[in] name of environment variable
+ * @param a_uiDefault :[in] value if variable is not set or is 0
+ * @return value
+ */
+uint32_t SparkPlugDevicesBenchmark_ut::readUint(const char *a_pcName, uint32_t a_uiDefault)
+{
+	const char *pcValue = std::getenv(a_pcName);
+	uint32_t uiValue = (NULL == pcValue) ? 0 : (uint32_t)strtoul(pcValue, NULL, 10);
+	return (0 == uiValue) ? a_uiDefault : uiValue;
+}
+
+/**
+ * Creates update message as published by Modbus container for a polled point
+ * @param a_uiDevice :[in] device index
+ * @param a_uiValue :[in] value of point
+ * @return update message
+ */
+std::string SparkPlugDevicesBenchmark_ut::createUpdateMsg(uint32_t a_uiDevice, uint32_t a_uiValue)
+{
+	char acHex[16] = {0};
+	snprintf(acHex, sizeof(acHex), "0x%04X", a_uiValue & 0xFFFF);
+	std::string sUsec = std::to_string(1614063600000000ULL + a_uiValue);
+	return std::string("{\"driver_seq\":\"") + std::to_string(a_uiValue) +
+			"\",\"data_topic\":\"/flowmeter/PL" + std::to_string(a_uiDevice) + "/" BENCH_METRIC_NAME "/update\"" +
+			",\"metric\":\"" BENCH_METRIC_NAME "\",\"wellhead\":\"PL" + std::to_string(a_uiDevice) +
+			"\",\"value\":\"" + acHex + "\",\"scaledValue\":" + std::to_string(a_uiValue) +
+			",\"status\":\"Good\",\"realtime\":\"0\",\"timestamp\":\"2021-02-23 07:00:00\"" +
+			",\"usec\":\"" + sUsec + "\",\"lastGoodUsec\":\"" + sUsec + "\",\"version\":\"2.0\"}";
+}
+
+/**
+ * Creates real devices, each having one uint32 metric, which are known to SCADA master as up
+ * @param a_uiCount :[in] number of devices
+ * @return None
+ */
+void SparkPlugDevicesBenchmark_ut::createDevices(uint32_t a_uiCount)
+{
+	m_vecDevices.clear();
+	m_vecDevices.reserve(a_uiCount);
+	for(uint32_t uiDev = 0; uiDev < a_uiCount; ++uiDev)
+	{
+		std::unique_ptr<CSparkPlugDev> pDev(new CSparkPlugDev("flowmeter", "flowmeter-PL" + std::to_string(uiDev)));
+		pDev->addRealDevMetric(BENCH_METRIC_NAME, CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)0), NULL);
+		pDev->setPublishedStatus(enDEVSTATUS_UP);
+		m_vecDevices.push_back(std::move(pDev));
+	}
+}
+
+/**
+ * Gives update messages to a range of devices; every message changes value of metric
+ * @param a_uiFirstDev :[in] first device index
+ * @param a_uiLastDev :[in] device index after last device
+ * @param a_uiRounds :[in] number of messages per device
+ * @param a_uiBase :[in] value of first message; following messages increment it
+ * @return number of DDATA actions produced
+ */
+uint64_t SparkPlugDevicesBenchmark_ut::processUpdates(uint32_t a_uiFirstDev, uint32_t a_uiLastDev,
+		uint32_t a_uiRounds, uint32_t a_uiBase)
+{
+	// messages are created before timing starts
+	std::vector<std::string> vecMsgs;
+	vecMsgs.reserve(a_uiRounds);
+	for(uint32_t uiRound = 0; uiRound < a_uiRounds; ++uiRound)
+	{
+		vecMsgs.push_back(createUpdateMsg(a_uiFirstDev, a_uiBase + uiRound));
+	}
+
+	uint64_t ui64Actions = 0;
+	std::vector<stRefForSparkPlugAction> vecActions;
+	for(const auto &sMsg : vecMsgs)
+	{
+		for(uint32_t uiDev = a_uiFirstDev; uiDev < a_uiLastDev; ++uiDev)
+		{
+			vecActions.clear();
+			m_vecDevices[uiDev]->processRealDeviceUpdateMsg(sMsg, vecActions);
+			ui64Actions += vecActions.size();
+		}
+	}
+	return ui64Actions;
+}
+
+/**
+ * Test case to check that an update of each of 1k devices produces one DDATA
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevicesBenchmark_ut, processUpdates_1kDevices)
+{
+	EXPECT_EQ((uint64_t)BENCH_DEVICE_COUNT, processUpdates(0, BENCH_DEVICE_COUNT, 1, 1));
+	// same value again is not a change
+	EXPECT_EQ(0u, processUpdates(0, BENCH_DEVICE_COUNT, 1, 1));
+}
+
+/**
+ * Benchmark of update path for 1k devices. Configured by environment variables
+ * BENCH_UPDATES_PER_DEVICE (default 100) and BENCH_THREADS (default 1); each thread
+ * updates its own share of devices. Result is written as JSON on standard output.
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevicesBenchmark_ut, benchmark_1kDevices)
+{
+	if(false == isEnabled())
+	{
+		std::cout << "Set SPARKPLUG_BENCHMARK=true to run update path benchmark" << std::endl;
+		return;
+	}
+	uint32_t uiRounds = readUint("BENCH_UPDATES_PER_DEVICE", 100);
+	uint32_t uiThreads = std::min(readUint("BENCH_THREADS", 1), (uint32_t)BENCH_DEVICE_COUNT);
+	uint32_t uiDevsPerThread = BENCH_DEVICE_COUNT / uiThreads;
+
+	std::vector<uint64_t> vecActions(uiThreads, 0);
+	std::vector<std::thread> vecThreads;
+	auto start = std::chrono::steady_clock::now();
+	for(uint32_t uiThread = 0; uiThread < uiThreads; ++uiThread)
+	{
+		uint32_t uiFirst = uiThread * uiDevsPerThread;
+		uint32_t uiLast = (uiThread + 1 == uiThreads) ? BENCH_DEVICE_COUNT : uiFirst + uiDevsPerThread;
+		vecThreads.emplace_back([this, &vecActions, uiThread, uiFirst, uiLast, uiRounds]() {
+			vecActions[uiThread] = processUpdates(uiFirst, uiLast, uiRounds, 1);
+		});
+	}
+	for(auto &oThread : vecThreads)
+	{
+		oThread.join();
+	}
+	double dElapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t ui64Updates = (uint64_t)BENCH_DEVICE_COUNT * uiRounds;
+	uint64_t ui64Actions = 0;
+	for(auto ui64Count : vecActions)
+	{
+		ui64Actions += ui64Count;
+	}
+	EXPECT_EQ(ui64Updates, ui64Actions);
+
+	std::ostringstream oss;
+	oss << "{\"devices\":" << BENCH_DEVICE_COUNT
+		<< ",\"updates_per_device\":" << uiRounds
+		<< ",\"threads\":" << uiThreads
+		<< ",\"elapsed_ms\":" << (uint64_t)(dElapsedSec * 1000)
+		<< ",\"updates_per_sec\":" << (uint64_t)(ui64Updates / std::max(dElapsedSec, 1e-9))
+		<< ",\"ns_per_update\":" << (uint64_t)(dElapsedSec * 1e9 / ui64Updates) << "}";
+	std::cout << oss.str() << std::endl;
+}
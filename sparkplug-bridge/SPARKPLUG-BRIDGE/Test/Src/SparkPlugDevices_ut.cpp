@@ -96,6 +96,52 @@ TEST_F(SparkPlugDevices_ut, processRealDeviceUpdateMsg_DeviceMapEmpty)
 
 }
 
+/**
+ * Test case to check parseRealDeviceUpdateMsg() reads all fields of message including scaled value
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevices_ut, parseRealDeviceUpdateMsg_AllFields)
+{
+	std::string sPayLoad = "{\"metric\": \"UtData02\", \"status\": \"Bad\", \"value\": \"0x00\", \"scaledValue\": -1.5, \"usec\": \"1571887474111145\", \"lastGoodUsec\": \"1571887474000000\", \"error_code\": \"2002\"}";
+	stRealDevUpdate stUpdate;
+	ASSERT_TRUE(_parseRealDeviceUpdateMsg(sPayLoad, stUpdate));
+	EXPECT_EQ("UtData02", stUpdate.m_sMetric);
+	EXPECT_EQ("Bad", stUpdate.m_sStatus);
+	EXPECT_EQ("0x00", stUpdate.m_sValue);
+	EXPECT_EQ(1571887474111u, stUpdate.m_usec);
+	EXPECT_EQ(1571887474000u, stUpdate.m_lastGoodUsec);
+	EXPECT_EQ(2002u, stUpdate.m_error_code);
+	EXPECT_EQ(cJSON_Number, stUpdate.m_iScaledType);
+	EXPECT_DOUBLE_EQ(-1.5, stUpdate.m_dScaledValue);
+
+	bool bIsGood = true, bIsDeathCode = false;
+	EXPECT_TRUE(_validateRealDeviceUpdateData(stUpdate, bIsGood, bIsDeathCode));
+	EXPECT_FALSE(bIsGood);
+	EXPECT_TRUE(bIsDeathCode);
+}
+
+/**
+ * Test case to check that message having invalid timestamp or no scaled value is rejected
+ * before metric list is accessed
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevices_ut, parseRealDeviceUpdateMsg_InvalidFields)
+{
+	stRealDevUpdate stUpdate;
+	EXPECT_FALSE(_parseRealDeviceUpdateMsg("{\"metric\": \"UtData02\", \"status\": \"good\", \"value\": \"0x00\", \"usec\": \"val1\"}", stUpdate));
+	EXPECT_FALSE(_parseRealDeviceUpdateMsg("{\"metric\": \"UtData02\", \"value\": \"0x00\"}", stUpdate));
+	EXPECT_FALSE(_parseRealDeviceUpdateMsg("{\"metric\": ", stUpdate));
+
+	ASSERT_TRUE(_parseRealDeviceUpdateMsg("{\"metric\": \"UtData02\", \"status\": \"good\", \"value\": \"0x00\"}", stUpdate));
+	EXPECT_NE(0u, stUpdate.m_usec);
+	bool bIsGood = true, bIsDeathCode = false;
+	EXPECT_FALSE(_validateRealDeviceUpdateData(stUpdate, bIsGood, bIsDeathCode));
+}
+
 /**
  * Test case to check processRealDeviceUpdateMsg() when metric list is empty
  * @param :[in] None
@@ -161,3 +207,109 @@ TEST_F(SparkPlugDevices_ut, PrepDBorthMsg_NBIRTH_false)
 	EXPECT_EQ(true, result);
 }
 
+
+/**
+ * Test case to check that alias of metric does not change across rebirths and is unique across devices
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevices_ut, assignAlias_StableAcrossRebirth)
+{
+	CSparkPlugDev oDev1{"Dev01", "App-Dev01", true};
+	CSparkPlugDev oDev2{"Dev02", "App-Dev02", true};
+
+	EXPECT_EQ(0u, oDev1.findAlias("Flow"));
+	uint64_t ui64Flow = _assignAlias(oDev1, "Flow");
+	uint64_t ui64Level = _assignAlias(oDev1, "Level");
+	EXPECT_NE(0u, ui64Flow);
+	EXPECT_NE(ui64Flow, ui64Level);
+
+	// Rebirth keeps aliases of known metrics
+	EXPECT_EQ(ui64Flow, _assignAlias(oDev1, "Flow"));
+	EXPECT_EQ(ui64Level, _assignAlias(oDev1, "Level"));
+	EXPECT_EQ(ui64Flow, oDev1.findAlias("Flow"));
+
+	// Same metric name in another device gets another alias
+	uint64_t ui64Flow2 = _assignAlias(oDev2, "Flow");
+	EXPECT_NE(ui64Flow, ui64Flow2);
+	EXPECT_NE(ui64Level, ui64Flow2);
+
+	std::string sName{""};
+	EXPECT_TRUE(oDev1.resolveAlias(ui64Level, sName));
+	EXPECT_EQ("Level", sName);
+	EXPECT_FALSE(oDev1.resolveAlias(ui64Flow2, sName));
+}
+
+/**
+ * Test case to check that DDATA of vendor app metric carries alias given in DBIRTH
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevices_ut, prepareDdataMsg_AliasOnly)
+{
+	CCommon::getInstance().setMetricAliases(true);
+	CSparkPlugDev oDev{"Dev01", "App-Dev01", true};
+	metricMapIf_t mapBirth;
+	mapBirth.emplace("Flow", std::make_shared<CMetric>("Flow", CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)1), get_current_timestamp()));
+	bool bIsOnlyValChange = false;
+	oDev.processNewBirthData(mapBirth, bIsOnlyValChange);
+
+	org_eclipse_tahu_protobuf_Payload oPayload = org_eclipse_tahu_protobuf_Payload_init_default;
+	EXPECT_TRUE(oDev.prepareDBirthMessage(oPayload, true));
+	free_payload(&oPayload);
+	uint64_t ui64Alias = oDev.findAlias("Flow");
+	ASSERT_NE(0u, ui64Alias);
+	EXPECT_EQ(ui64Alias, mapBirth["Flow"]->getAlias());
+
+	metricMapIf_t mapData;
+	mapData.emplace("Flow", std::make_shared<CMetric>("Flow", CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)2), get_current_timestamp()));
+	metricMapIf_t mapChanged = oDev.processNewData(mapData);
+	ASSERT_EQ(1u, mapChanged.size());
+
+	oPayload = org_eclipse_tahu_protobuf_Payload_init_default;
+	EXPECT_TRUE(oDev.prepareDdataMsg(oPayload, mapChanged));
+	EXPECT_EQ(ui64Alias, mapChanged["Flow"]->getAlias());
+	free_payload(&oPayload);
+
+	// Rebirth keeps alias
+	oPayload = org_eclipse_tahu_protobuf_Payload_init_default;
+	EXPECT_TRUE(oDev.prepareDBirthMessage(oPayload, true));
+	free_payload(&oPayload);
+	EXPECT_EQ(ui64Alias, oDev.findAlias("Flow"));
+	CCommon::getInstance().setMetricAliases(false);
+}
+
+/**
+ * Test case to check that encoded DBIRTH is reused till a metric value changes
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevices_ut, encodeDBirthMessage_CachedTillChange)
+{
+	CSparkPlugDev oDev{"Dev01", "App-Dev01", true};
+	metricMapIf_t mapBirth;
+	mapBirth.emplace("Mode", std::make_shared<CMetric>("Mode", CValObj(METRIC_DATA_TYPE_STRING, std::string("auto")), get_current_timestamp()));
+	bool bIsOnlyValChange = false;
+	oDev.processNewBirthData(mapBirth, bIsOnlyValChange);
+
+	std::string sBirth1, sBirth2;
+	EXPECT_TRUE(oDev.encodeDBirthMessage(sBirth1, true));
+	EXPECT_FALSE(sBirth1.empty());
+
+	// same value does not change DBIRTH
+	metricMapIf_t mapData;
+	mapData.emplace("Mode", std::make_shared<CMetric>("Mode", CValObj(METRIC_DATA_TYPE_STRING, std::string("auto")), get_current_timestamp()));
+	EXPECT_EQ(0u, oDev.processNewData(mapData).size());
+	EXPECT_TRUE(oDev.encodeDBirthMessage(sBirth2, true));
+	EXPECT_EQ(sBirth1, sBirth2);
+
+	// DBIRTH carries changed value
+	mapData.clear();
+	mapData.emplace("Mode", std::make_shared<CMetric>("Mode", CValObj(METRIC_DATA_TYPE_STRING, std::string("manual")), get_current_timestamp()));
+	EXPECT_EQ(1u, oDev.processNewData(mapData).size());
+	EXPECT_TRUE(oDev.encodeDBirthMessage(sBirth2, true));
+	EXPECT_NE(sBirth1, sBirth2);
+}
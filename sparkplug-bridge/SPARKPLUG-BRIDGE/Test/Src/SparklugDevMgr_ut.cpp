@@ -79,4 +79,38 @@ TEST_F(SparkPlugDevMgr_ut, SetMsgPubStatus)
 	EXPECT_EQ(true, result);
 }
 
+/**
+ * Test case to check that DCMD metric sent only with alias gets name of metric given the alias in DBIRTH
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkPlugDevMgr_ut, resolveDCMDMetricAlias)
+{
+	CSparkPlugDev oDev{"Dev01", "App-Dev01", true};
+	metricMapIf_t mapMetrics;
+	mapMetrics.emplace("Flow", std::make_shared<CMetric>("Flow", CValObj(METRIC_DATA_TYPE_UINT32, (uint32_t)1), get_current_timestamp()));
+	bool bIsOnlyValChange = false;
+	oDev.processNewBirthData(mapMetrics, bIsOnlyValChange);
+
+	org_eclipse_tahu_protobuf_Payload oPayload = org_eclipse_tahu_protobuf_Payload_init_default;
+	EXPECT_TRUE(oDev.prepareDBirthMessage(oPayload, true));
+	free_payload(&oPayload);
+	uint64_t ui64Alias = oDev.findAlias("Flow");
+	ASSERT_NE(0u, ui64Alias);
+
+	// Metric without name and alias is not resolved
+	org_eclipse_tahu_protobuf_Payload_Metric oMetric = a_metric;
+	EXPECT_FALSE(_resolveDCMDMetricAlias(oDev, oMetric));
 
+	oMetric.has_alias = true;
+	oMetric.alias = ui64Alias + 1;
+	EXPECT_FALSE(_resolveDCMDMetricAlias(oDev, oMetric));
+	EXPECT_TRUE(NULL == oMetric.name);
+
+	oMetric.alias = ui64Alias;
+	EXPECT_TRUE(_resolveDCMDMetricAlias(oDev, oMetric));
+	ASSERT_TRUE(NULL != oMetric.name);
+	EXPECT_STREQ("Flow", oMetric.name);
+	free(oMetric.name);
+}
@@ -0,0 +1,577 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <errno.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include "../Inc/SparkplugCodecBenchmark_ut.hpp"
+#include "../Inc/SparkPlugDevicesBenchmark_ut.hpp"
+#include "Logger.hpp"
+
+extern "C"
+{
+#include <tahu.h>
+}
+
+#ifdef SPARKPLUG_BENCH_ALLOC_COUNT
+// Allocator of whole test binary is replaced only when built with this flag, e.g.
+// make BENCH_CFLAGS=-DSPARKPLUG_BENCH_ALLOC_COUNT, so that other tests run with allocator of glibc.
+extern "C"
+{
+/** allocator of glibc, used by malloc() of test binary */
+void *__libc_malloc(size_t a_uiSize);
+void *__libc_calloc(size_t a_uiCount, size_t a_uiSize);
+void *__libc_realloc(void *a_pPtr, size_t a_uiSize);
+void *__libc_memalign(size_t a_uiAlignment, size_t a_uiSize);
+void __libc_free(void *a_pPtr);
+}
+
+/** allocations made by each thread; counted for C allocations of tahu and nanopb as well as for new */
+static __thread uint64_t g_ui64AllocCount = 0;
+static __thread uint64_t g_ui64AllocBytes = 0;
+
+extern "C"
+{
+void *malloc(size_t a_uiSize) noexcept
+{
+	++g_ui64AllocCount;
+	g_ui64AllocBytes += a_uiSize;
+	return __libc_malloc(a_uiSize);
+}
+
+void *calloc(size_t a_uiCount, size_t a_uiSize) noexcept
+{
+	++g_ui64AllocCount;
+	g_ui64AllocBytes += a_uiCount * a_uiSize;
+	return __libc_calloc(a_uiCount, a_uiSize);
+}
+
+void *realloc(void *a_pPtr, size_t a_uiSize) noexcept
+{
+	++g_ui64AllocCount;
+	g_ui64AllocBytes += a_uiSize;
+	return __libc_realloc(a_pPtr, a_uiSize);
+}
+
+void *memalign(size_t a_uiAlignment, size_t a_uiSize) noexcept
+{
+	++g_ui64AllocCount;
+	g_ui64AllocBytes += a_uiSize;
+	return __libc_memalign(a_uiAlignment, a_uiSize);
+}
+
+void *aligned_alloc(size_t a_uiAlignment, size_t a_uiSize) noexcept
+{
+	++g_ui64AllocCount;
+	g_ui64AllocBytes += a_uiSize;
+	return __libc_memalign(a_uiAlignment, a_uiSize);
+}
+
+int posix_memalign(void **a_ppPtr, size_t a_uiAlignment, size_t a_uiSize) noexcept
+{
+	if((0 == a_uiAlignment) || (0 != (a_uiAlignment % sizeof(void *)))
+			|| (0 != (a_uiAlignment & (a_uiAlignment - 1))))
+	{
+		return EINVAL;
+	}
+	++g_ui64AllocCount;
+	g_ui64AllocBytes += a_uiSize;
+	void *pPtr = __libc_memalign(a_uiAlignment, a_uiSize);
+	if(NULL == pPtr)
+	{
+		return ENOMEM;
+	}
+	*a_ppPtr = pPtr;
+	return 0;
+}
+
+void free(void *a_pPtr) noexcept
+{
+	__libc_free(a_pPtr);
+}
+}
+#endif
+
+void SparkplugCodecBenchmark_ut::SetUp()
+{
+	m_vecResults.clear();
+}
+
+void SparkplugCodecBenchmark_ut::TearDown()
+{
+	m_vecResults.clear();
+}
+
+/**
+ * Gives allocations made so far by calling thread
+ * @return allocation count and bytes; 0 if allocations are not counted
+ */
+stAllocCount SparkplugCodecBenchmark_ut::getAllocCount()
+{
+#ifdef SPARKPLUG_BENCH_ALLOC_COUNT
+	return {g_ui64AllocCount, g_ui64AllocBytes};
+#else
+	return {0, 0};
+#endif
+}
+
+/**
+ * Tells whether allocations are counted, i.e. test binary is built with SPARKPLUG_BENCH_ALLOC_COUNT
+ * @return true if allocations are counted
+ */
+bool SparkplugCodecBenchmark_ut::isAllocCounted()
+{
+#ifdef SPARKPLUG_BENCH_ALLOC_COUNT
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * Gives datatypes of metrics, as named in messages of vendor app
+ * @return datatypes
+ */
+const std::vector<std::string>& SparkplugCodecBenchmark_ut::getDataTypes()
+{
+	static const std::vector<std::string> vecDataTypes{"Boolean", "UInt8", "UInt16", "UInt32", "UInt64",
+		"Int8", "Int16", "Int32", "Int64", "Float", "Double", "String"};
+	return vecDataTypes;
+}
+
+/**
+ * Creates metric as given in message of vendor app
+ * @param a_sName :[in] name of metric
+ * @param a_sDataType :[in] datatype of metric
+ * @param a_uiValue :[in] value of metric; it is kept within range of all integer datatypes
+ * @return metric in JSON
+ */
+std::string SparkplugCodecBenchmark_ut::createMetricJson(const std::string &a_sName,
+		const std::string &a_sDataType, uint32_t a_uiValue)
+{
+	std::string sValue;
+	if("Boolean" == a_sDataType)
+	{
+		sValue = (0 == (a_uiValue % 2)) ? "false" : "true";
+	}
+	else if("String" == a_sDataType)
+	{
+		sValue = "\"value-" + std::to_string(a_uiValue) + "\"";
+	}
+	else if(("Float" == a_sDataType) || ("Double" == a_sDataType))
+	{
+		sValue = std::to_string(a_uiValue % 100) + ".5";
+	}
+	else
+	{
+		sValue = std::to_string(a_uiValue % 100);
+	}
+	return "{\"name\":\"" + a_sName + "\",\"dataType\":\"" + a_sDataType + "\",\"value\":" + sValue + "}";
+}
+
+/**
+ * Creates birth or data message of vendor app with metrics of one datatype
+ * @param a_sDataType :[in] datatype of metrics
+ * @param a_uiCount :[in] number of metrics
+ * @param a_uiValue :[in] value of metrics
+ * @return message
+ */
+std::string SparkplugCodecBenchmark_ut::createVendorAppMsg(const std::string &a_sDataType,
+		uint32_t a_uiCount, uint32_t a_uiValue)
+{
+	std::string sMsg{"{\"metrics\":["};
+	for(uint32_t uiMetric = 0; uiMetric < a_uiCount; ++uiMetric)
+	{
+		if(0 != uiMetric)
+		{
+			sMsg += ",";
+		}
+		sMsg += createMetricJson("Metric" + std::to_string(uiMetric), a_sDataType, a_uiValue);
+	}
+	return sMsg + "],\"timestamp\":\"2019-09-20 12:34:56\",\"usec\":\"1571887474111145\","
+			"\"version\":\"2.0\",\"app_seq\":\"1234\",\"realtime\":\"0\"}";
+}
+
+/**
+ * Creates value of an instance of UDT BenchInner, which has 4 metrics
+ * @param a_uiValue :[in] value of metrics
+ * @return value in JSON
+ */
+static std::string createInnerUDTValue(uint32_t a_uiValue)
+{
+	return "{\"udt_ref\":{\"name\":\"BenchInner\",\"version\":\"1.0\"},\"metrics\":[" +
+			SparkplugCodecBenchmark_ut::createMetricJson("Flow", "Float", a_uiValue) + "," +
+			SparkplugCodecBenchmark_ut::createMetricJson("Pressure", "Double", a_uiValue) + "," +
+			SparkplugCodecBenchmark_ut::createMetricJson("Status", "String", a_uiValue) + "," +
+			SparkplugCodecBenchmark_ut::createMetricJson("Count", "UInt32", a_uiValue) + "]," +
+			"\"parameters\":[" + SparkplugCodecBenchmark_ut::createMetricJson("Unit", "String", 0) + "]}";
+}
+
+/**
+ * Creates value of an instance of UDT BenchOuter, which has a metric and 2 instances of BenchInner
+ * @param a_uiValue :[in] value of metrics
+ * @return value in JSON
+ */
+static std::string createOuterUDTValue(uint32_t a_uiValue)
+{
+	return "{\"udt_ref\":{\"name\":\"BenchOuter\",\"version\":\"1.0\"},\"metrics\":[" +
+			SparkplugCodecBenchmark_ut::createMetricJson("Id", "UInt32", a_uiValue) + "," +
+			"{\"name\":\"Inlet\",\"dataType\":\"UDT\",\"value\":" + createInnerUDTValue(a_uiValue) + "}," +
+			"{\"name\":\"Outlet\",\"dataType\":\"UDT\",\"value\":" + createInnerUDTValue(a_uiValue) + "}]," +
+			"\"parameters\":[" + SparkplugCodecBenchmark_ut::createMetricJson("Site", "String", 0) + "]}";
+}
+
+/**
+ * Creates metric which is an instance of UDT BenchOuter; it has 9 metrics in nested UDTs
+ * @param a_sName :[in] name of metric
+ * @param a_uiValue :[in] value of metrics
+ * @return metric in JSON
+ */
+std::string SparkplugCodecBenchmark_ut::createUDTInstanceJson(const std::string &a_sName, uint32_t a_uiValue)
+{
+	return "{\"name\":\"" + a_sName + "\",\"dataType\":\"UDT\",\"value\":" + createOuterUDTValue(a_uiValue) + "}";
+}
+
+/**
+ * Defines UDTs BenchInner and BenchOuter, which has members of type BenchInner
+ * @return None
+ */
+void SparkplugCodecBenchmark_ut::defineBenchUDTs()
+{
+	std::vector<stRefForSparkPlugAction> vecActions;
+	std::string sInner = createInnerUDTValue(0);
+	std::string sOuter = createOuterUDTValue(0);
+	// definition has name and version in place of reference to a definition
+	CSparkPlugUDTManager::getInstance().processTemplateDef("{\"udt_name\":\"BenchInner\",\"version\":\"1.0\"," +
+			sInner.substr(sInner.find("\"metrics\"")), vecActions);
+	CSparkPlugUDTManager::getInstance().processTemplateDef("{\"udt_name\":\"BenchOuter\",\"version\":\"1.0\"," +
+			sOuter.substr(sOuter.find("\"metrics\"")), vecActions);
+}
+
+/**
+ * Adds device of vendor app BENCH_CODEC_APP by a birth message
+ * @param a_sSubDev :[in] name of device in vendor app
+ * @param a_sBirthMsg :[in] birth message
+ * @return true if device has metrics of birth message
+ */
+bool SparkplugCodecBenchmark_ut::addVendorDev(const std::string &a_sSubDev, const std::string &a_sBirthMsg)
+{
+	std::vector<stRefForSparkPlugAction> vecActions;
+	return CSparkPlugDevManager::getInstance().processInternalMQTTMsg(
+			"Birth/" BENCH_CODEC_APP "/" + a_sSubDev, a_sBirthMsg, vecActions);
+}
+
+/**
+ * Gives metrics changed by data message of a device of vendor app BENCH_CODEC_APP
+ * @param a_sSubDev :[in] name of device in vendor app
+ * @param a_sDataMsg :[in] data message
+ * @param a_pDev :[out] device
+ * @param a_mapChanged :[out] changed metrics, as used for DDATA
+ * @return true if data message gives a DDATA
+ */
+bool SparkplugCodecBenchmark_ut::getChangedMetrics(const std::string &a_sSubDev, const std::string &a_sDataMsg,
+		CSparkPlugDev *&a_pDev, metricMapIf_t &a_mapChanged)
+{
+	std::vector<stRefForSparkPlugAction> vecActions;
+	CSparkPlugDevManager::getInstance().processInternalMQTTMsg(
+			"Data/" BENCH_CODEC_APP "/" + a_sSubDev, a_sDataMsg, vecActions);
+	for(auto &stAction : vecActions)
+	{
+		if(enMSG_DATA == stAction.m_enAction)
+		{
+			a_pDev = &stAction.m_refSparkPlugDev.get();
+			a_mapChanged = stAction.m_mapChangedMetrics;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Prepares and encodes DDATA of changed metrics of a device, as done for publishing
+ * @param a_oDev :[in] device
+ * @param a_mapChanged :[in] changed metrics
+ * @param a_sEncoded :[out] encoded message
+ * @return true/false based on success/failure
+ */
+bool SparkplugCodecBenchmark_ut::encodeDDATA(CSparkPlugDev &a_oDev, const metricMapIf_t &a_mapChanged,
+		std::string &a_sEncoded)
+{
+	org_eclipse_tahu_protobuf_Payload oPayload = org_eclipse_tahu_protobuf_Payload_init_default;
+	bool bRet = a_oDev.prepareDdataMsg(oPayload, a_mapChanged) &&
+			CSparkplugEncodeArena::getThreadArena().encode(oPayload, a_sEncoded);
+	free_payload(&oPayload);
+	return bRet;
+}
+
+/**
+ * Prepares and encodes DBIRTH of a device as a part of node birth. Cache of encoded DBIRTH
+ * is not used, so that preparation of metrics is measured.
+ * @param a_sDevName :[in] device name
+ * @param a_sEncoded :[out] encoded message
+ * @return true/false based on success/failure
+ */
+bool SparkplugCodecBenchmark_ut::encodeDBIRTH(const std::string &a_sDevName, std::string &a_sEncoded)
+{
+	org_eclipse_tahu_protobuf_Payload oPayload = org_eclipse_tahu_protobuf_Payload_init_default;
+	bool bRet = CSparkPlugDevManager::getInstance().prepareDBirthMessage(oPayload, a_sDevName, true) &&
+			CSparkplugEncodeArena::getThreadArena().encode(oPayload, a_sEncoded);
+	free_payload(&oPayload);
+	return bRet;
+}
+
+/**
+ * Encodes DCMD as sent by SCADA master, writing uint32 metrics Metric0, Metric1...
+ * @param a_uiCount :[in] number of metrics
+ * @param a_sEncoded :[out] encoded message
+ * @return true/false based on success/failure
+ */
+bool SparkplugCodecBenchmark_ut::encodeDCMD(uint32_t a_uiCount, std::string &a_sEncoded)
+{
+	org_eclipse_tahu_protobuf_Payload oPayload = org_eclipse_tahu_protobuf_Payload_init_default;
+	for(uint32_t uiMetric = 0; uiMetric < a_uiCount; ++uiMetric)
+	{
+		uint32_t uiValue = uiMetric % 100;
+		add_simple_metric(&oPayload, ("Metric" + std::to_string(uiMetric)).c_str(), false, 0,
+				METRIC_DATA_TYPE_UINT32, false, false, &uiValue, sizeof(uiValue));
+	}
+	bool bRet = CSparkplugEncodeArena::getThreadArena().encode(oPayload, a_sEncoded);
+	free_payload(&oPayload);
+	return bRet;
+}
+
+/**
+ * Decodes DCMD and dispatches it as done for a vendor app: DCMD is checked against
+ * metrics of device and is converted to command message for internal MQTT
+ * @param a_sTopic :[in] DCMD topic
+ * @param a_sEncoded :[in] encoded DCMD
+ * @param a_uiMsgBytes :[out] size of command messages
+ * @return true/false based on success/failure
+ */
+bool SparkplugCodecBenchmark_ut::processDCMD(const std::string &a_sTopic, const std::string &a_sEncoded,
+		size_t &a_uiMsgBytes)
+{
+	org_eclipse_tahu_protobuf_Payload oPayload = org_eclipse_tahu_protobuf_Payload_init_zero;
+	std::vector<stRefForSparkPlugAction> vecActions;
+	bool bRet = (decode_payload(&oPayload, (uint8_t *)a_sEncoded.data(), a_sEncoded.length()) >= 0) &&
+			CSparkPlugDevManager::getInstance().processExternalMQTTMsg(a_sTopic, oPayload, vecActions);
+	free_payload(&oPayload);
+
+	a_uiMsgBytes = 0;
+	for(auto &stAction : vecActions)
+	{
+		cJSON *cjRoot = cJSON_CreateObject();
+		cJSON *cjMetrics = cJSON_CreateArray();
+		std::string sCmdTopic;
+		if(false == stAction.m_refSparkPlugDev.get().getCMDMsg(sCmdTopic, stAction.m_mapChangedMetrics, cjMetrics))
+		{
+			bRet = false;
+		}
+		cJSON_AddItemToObject(cjRoot, "metrics", cjMetrics);
+		char *pcMsg = cJSON_Print(cjRoot);
+		if(NULL != pcMsg)
+		{
+			a_uiMsgBytes += strlen(pcMsg);
+			free(pcMsg);
+		}
+		cJSON_Delete(cjRoot);
+	}
+	return bRet && (0 != vecActions.size());
+}
+
+/**
+ * Writes results as JSON in log and, if BENCH_REPORT_FILE names a file, appends them
+ * to that file as one line for tracking over builds. Allocations are reported only if
+ * they are counted.
+ * @return None
+ */
+void SparkplugCodecBenchmark_ut::report() const
+{
+	std::ostringstream oss;
+	oss << "{\"benchmarks\":[";
+	for(size_t uiRes = 0; uiRes < m_vecResults.size(); ++uiRes)
+	{
+		const stCodecBenchResult &stRes = m_vecResults[uiRes];
+		uint64_t ui64Iter = std::max(stRes.m_ui64Iterations, (uint64_t)1);
+		oss << ((0 == uiRes) ? "" : ",")
+			<< "{\"name\":\"" << stRes.m_sName << "\""
+			<< ",\"metrics\":" << stRes.m_uiMetrics
+			<< ",\"iterations\":" << stRes.m_ui64Iterations
+			<< ",\"ns_per_msg\":" << stRes.m_ui64ElapsedNs / ui64Iter
+			<< ",\"ns_per_metric\":" << stRes.m_ui64ElapsedNs / ui64Iter / std::max(stRes.m_uiMetrics, 1u);
+		if(true == isAllocCounted())
+		{
+			oss << ",\"allocs_per_msg\":" << stRes.m_stAllocs.m_ui64Count / ui64Iter
+				<< ",\"alloc_bytes_per_msg\":" << stRes.m_stAllocs.m_ui64Bytes / ui64Iter;
+		}
+		oss << ",\"msg_bytes\":" << stRes.m_uiMsgBytes << "}";
+	}
+	oss << "]}";
+	DO_LOG_INFO("Sparkplug codec benchmark: " + oss.str());
+
+	const char *pcOutFile = std::getenv("BENCH_REPORT_FILE");
+	if((NULL != pcOutFile) && ('\0' != pcOutFile[0]))
+	{
+		std::ofstream oOut(pcOutFile, std::ios::app);
+		oOut << oss.str() << std::endl;
+	}
+}
+
+/**
+ * Test case to check that allocations of calling thread are counted, by new, malloc() and
+ * aligned allocation functions
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugCodecBenchmark_ut, getAllocCount)
+{
+	if(false == isAllocCounted())
+	{
+		std::cout << "Build with SPARKPLUG_BENCH_ALLOC_COUNT to count allocations" << std::endl;
+		return;
+	}
+	stAllocCount stStart = getAllocCount();
+	std::unique_ptr<std::vector<uint8_t>> pVec(new std::vector<uint8_t>(100));
+	void *pMem = malloc(50);
+	void *pAligned = NULL;
+	EXPECT_EQ(0, posix_memalign(&pAligned, 64, 32));
+	void *pAligned2 = aligned_alloc(64, 64);
+	stAllocCount stEnd = getAllocCount();
+	free(pMem);
+	free(pAligned);
+	free(pAligned2);
+
+	EXPECT_EQ(5u, stEnd.m_ui64Count - stStart.m_ui64Count);
+	EXPECT_LE(246u, stEnd.m_ui64Bytes - stStart.m_ui64Bytes);
+}
+
+/**
+ * Test case to check that messages used by benchmark give a DDATA of all metrics for each datatype
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugCodecBenchmark_ut, getChangedMetrics_AllDataTypes)
+{
+	for(const auto &sDataType : getDataTypes())
+	{
+		std::string sSubDev = "Check" + sDataType;
+		ASSERT_TRUE(addVendorDev(sSubDev, createVendorAppMsg(sDataType, 10, 0)));
+
+		CSparkPlugDev *pDev = NULL;
+		metricMapIf_t mapChanged;
+		ASSERT_TRUE(getChangedMetrics(sSubDev, createVendorAppMsg(sDataType, 10, 1), pDev, mapChanged));
+		EXPECT_EQ(10u, mapChanged.size());
+		EXPECT_EQ(std::string(BENCH_CODEC_APP "-") + sSubDev, pDev->getSparkPlugName());
+	}
+}
+
+/**
+ * Benchmark of Sparkplug encode and decode paths. Configured by environment variables
+ * BENCH_CODEC_METRICS (metrics in a message, default 1000) and BENCH_CODEC_ITERATIONS
+ * (messages per case, default 200). Result is written as JSON in log.
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugCodecBenchmark_ut, benchmark_Codec)
+{
+	if(false == SparkPlugDevicesBenchmark_ut::isEnabled())
+	{
+		std::cout << "Set SPARKPLUG_BENCHMARK=true to run Sparkplug codec benchmark" << std::endl;
+		return;
+	}
+	uint32_t uiMetrics = SparkPlugDevicesBenchmark_ut::readUint("BENCH_CODEC_METRICS", BENCH_CODEC_DEFAULT_METRICS);
+	uint32_t uiIterations = SparkPlugDevicesBenchmark_ut::readUint("BENCH_CODEC_ITERATIONS", BENCH_CODEC_DEFAULT_ITERATIONS);
+	std::string sEncoded;
+
+	// DDATA of changed metrics, per datatype
+	for(const auto &sDataType : getDataTypes())
+	{
+		std::string sSubDev = "DDATA" + sDataType;
+		ASSERT_TRUE(addVendorDev(sSubDev, createVendorAppMsg(sDataType, uiMetrics, 0)));
+		CSparkPlugDev *pDev = NULL;
+		metricMapIf_t mapChanged;
+		ASSERT_TRUE(getChangedMetrics(sSubDev, createVendorAppMsg(sDataType, uiMetrics, 1), pDev, mapChanged));
+
+		bool bRet = true;
+		measure("ddata_encode/" + sDataType, uiMetrics, uiIterations, [&]() {
+			bRet = encodeDDATA(*pDev, mapChanged, sEncoded) && bRet;
+			return sEncoded.length();
+		});
+		EXPECT_TRUE(bRet) << sDataType;
+	}
+
+	// DBIRTH of a device having instances of UDT with nested UDTs; each instance has 9 metrics
+	{
+		defineBenchUDTs();
+		uint32_t uiInstances = std::max(uiMetrics / 9, 1u);
+		std::string sBirth{"{\"metrics\":["};
+		for(uint32_t uiInst = 0; uiInst < uiInstances; ++uiInst)
+		{
+			sBirth += ((0 == uiInst) ? "" : ",") + createUDTInstanceJson("Pump" + std::to_string(uiInst), uiInst);
+		}
+		sBirth += "],\"timestamp\":\"2019-09-20 12:34:56\",\"usec\":\"1571887474111145\","
+				"\"version\":\"2.0\",\"app_seq\":\"1234\",\"realtime\":\"0\"}";
+		ASSERT_TRUE(addVendorDev("DBIRTHUDT", sBirth));
+
+		bool bRet = true;
+		measure("dbirth_encode/nested_udt", uiInstances * 9, uiIterations, [&]() {
+			bRet = encodeDBIRTH(BENCH_CODEC_APP "-DBIRTHUDT", sEncoded) && bRet;
+			return sEncoded.length();
+		});
+		EXPECT_TRUE(bRet);
+	}
+
+	// DCMD decode and dispatch to vendor app
+	{
+		ASSERT_TRUE(addVendorDev("DCMD", createVendorAppMsg("UInt32", uiMetrics, 0)));
+		std::string sDCMD;
+		ASSERT_TRUE(encodeDCMD(uiMetrics, sDCMD));
+
+		bool bRet = true;
+		measure("dcmd_decode_dispatch", uiMetrics, uiIterations, [&]() {
+			size_t uiMsgBytes = 0;
+			bRet = processDCMD("spBv1.0/UWC nodes/DCMD/RBOX510/" BENCH_CODEC_APP "-DCMD", sDCMD, uiMsgBytes) && bRet;
+			return uiMsgBytes;
+		});
+		EXPECT_TRUE(bRet);
+	}
+
+	// parsing of birth message of vendor app; value alternates so that each message is a change
+	{
+		std::vector<std::string> vecBirths{createVendorAppMsg("Float", uiMetrics, 0),
+			createVendorAppMsg("Float", uiMetrics, 1)};
+		uint64_t ui64Msg = 0;
+		bool bRet = true;
+		measure("vendor_birth_parse", uiMetrics, uiIterations, [&]() {
+			bRet = addVendorDev("BIRTHPARSE", vecBirths[(ui64Msg++) % 2]) && bRet;
+			return (size_t)0;
+		});
+		EXPECT_TRUE(bRet);
+	}
+
+	report();
+}
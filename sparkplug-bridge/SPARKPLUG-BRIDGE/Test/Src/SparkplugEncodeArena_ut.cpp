@@ -0,0 +1,172 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <thread>
+#include "../Inc/SparkplugEncodeArena_ut.hpp"
+
+void SparkplugEncodeArena_ut::SetUp()
+{
+	memset(&m_payload, 0, sizeof(org_eclipse_tahu_protobuf_Payload));
+	m_payload.has_timestamp = true;
+	m_payload.timestamp = get_current_timestamp();
+	m_payload.has_seq = true;
+	m_payload.seq = 1;
+}
+
+void SparkplugEncodeArena_ut::TearDown()
+{
+	free_payload(&m_payload);
+}
+
+/**
+ * Test case to check that payload fitting in buffer is encoded in a single pass
+ * with same result as sizing pass
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugEncodeArena_ut, encode_SinglePass)
+{
+	CSparkplugEncodeArena oArena;
+	addStringMetric(10);
+
+	size_t uiEncodedSize = 0;
+	ASSERT_TRUE(pb_get_encoded_size(&uiEncodedSize, org_eclipse_tahu_protobuf_Payload_fields, &m_payload));
+	EXPECT_TRUE(oArena.encode(m_payload, m_sBuffer));
+	EXPECT_EQ(uiEncodedSize, m_sBuffer.size());
+	EXPECT_EQ(0u, oArena.getGrowCount());
+	EXPECT_EQ((size_t)SPARKPLUG_ENCODE_INITIAL_SIZE, oArena.getHighWaterMark());
+}
+
+/**
+ * Test case to check that payload larger than high water mark is encoded and
+ * high water mark is raised for next payloads
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugEncodeArena_ut, encode_Grows)
+{
+	CSparkplugEncodeArena oArena(16);
+	addStringMetric(100);
+
+	EXPECT_TRUE(oArena.encode(m_payload, m_sBuffer));
+	EXPECT_EQ(1u, oArena.getGrowCount());
+	EXPECT_EQ(m_sBuffer.size(), oArena.getHighWaterMark());
+
+	std::string sSecond;
+	EXPECT_TRUE(oArena.encode(m_payload, sSecond));
+	EXPECT_EQ(1u, oArena.getGrowCount());
+	EXPECT_EQ(m_sBuffer, sSecond);
+}
+
+/**
+ * Test case to check that payload using most of high water mark is handed over in
+ * string it is encoded into, without being copied to an exact sized string
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugEncodeArena_ut, encode_KeepsReservedString)
+{
+	CSparkplugEncodeArena oArena(128);
+	addStringMetric(60);
+
+	EXPECT_TRUE(oArena.encode(m_payload, m_sBuffer));
+	EXPECT_LT(32u, m_sBuffer.size());
+	EXPECT_GE(128u, m_sBuffer.size());
+	EXPECT_LE(128u, m_sBuffer.capacity());
+	EXPECT_EQ(0u, oArena.getGrowCount());
+}
+
+/**
+ * Test case to check that high water mark decays to initial size once
+ * payloads get much smaller
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugEncodeArena_ut, encode_Decays)
+{
+	CSparkplugEncodeArena oArena(64);
+	addStringMetric(4000);
+	EXPECT_TRUE(oArena.encode(m_payload, m_sBuffer));
+	size_t uiLargeSize = oArena.getHighWaterMark();
+	EXPECT_LT(4000u, uiLargeSize);
+
+	org_eclipse_tahu_protobuf_Payload smallPayload;
+	memset(&smallPayload, 0, sizeof(org_eclipse_tahu_protobuf_Payload));
+	smallPayload.has_seq = true;
+	smallPayload.seq = 2;
+	EXPECT_TRUE(oArena.encode(smallPayload, m_sBuffer));
+	EXPECT_EQ(uiLargeSize / 2, oArena.getHighWaterMark());
+
+	for(int iLoop = 0; iLoop < 10; ++iLoop)
+	{
+		EXPECT_TRUE(oArena.encode(smallPayload, m_sBuffer));
+	}
+	EXPECT_EQ(64u, oArena.getHighWaterMark());
+	EXPECT_EQ(1u, oArena.getGrowCount());
+}
+
+/**
+ * Test case to check that encoded payload does not keep capacity of high
+ * water mark after a large payload
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugEncodeArena_ut, encode_ExactSizeAfterLarge)
+{
+	CSparkplugEncodeArena oArena(64);
+	addStringMetric(4000);
+	EXPECT_TRUE(oArena.encode(m_payload, m_sBuffer));
+
+	org_eclipse_tahu_protobuf_Payload smallPayload;
+	memset(&smallPayload, 0, sizeof(org_eclipse_tahu_protobuf_Payload));
+	smallPayload.has_seq = true;
+	smallPayload.seq = 2;
+	std::string sSmall;
+	EXPECT_TRUE(oArena.encode(smallPayload, sSmall));
+	EXPECT_GT(64u, sSmall.capacity());
+
+	// buffer reused by caller is not kept at large capacity
+	EXPECT_TRUE(oArena.encode(smallPayload, m_sBuffer));
+	EXPECT_GT(64u, m_sBuffer.capacity());
+}
+
+/**
+ * Test case to check that each thread gets its own arena
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugEncodeArena_ut, getThreadArena)
+{
+	CSparkplugEncodeArena *pMain = &CSparkplugEncodeArena::getThreadArena();
+	CSparkplugEncodeArena *pOther = nullptr;
+	std::thread oThread([&pOther]() { pOther = &CSparkplugEncodeArena::getThreadArena(); });
+	oThread.join();
+
+	EXPECT_EQ(pMain, &CSparkplugEncodeArena::getThreadArena());
+	EXPECT_NE(pMain, pOther);
+}
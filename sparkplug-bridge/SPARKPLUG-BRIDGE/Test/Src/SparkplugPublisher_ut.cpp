@@ -0,0 +1,327 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "../Inc/SparkplugPublisher_ut.hpp"
+
+void SparkplugPublisher_ut::SetUp()
+{
+	memset(&m_payload, 0, sizeof(org_eclipse_tahu_protobuf_Payload));
+	m_payload.has_timestamp = true;
+	m_payload.timestamp = get_current_timestamp();
+	m_vecTopics.clear();
+	m_vecPayloads.clear();
+	m_iFailCount = 0;
+}
+
+void SparkplugPublisher_ut::TearDown()
+{
+	free_payload(&m_payload);
+}
+
+/**
+ * Test case to check that sequence numbers are assigned in queue order, NBIRTH
+ * restarts them from 0 and messages are published in same order
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, enqueue_SeqOrder)
+{
+	std::unique_ptr<CSparkplugPublisher> pPublisher(createPublisher(10));
+	size_t uiEncodedLen = 0;
+
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true, &uiEncodedLen));
+	EXPECT_EQ(0u, m_payload.seq);
+	EXPECT_NE(0u, uiEncodedLen);
+	for(uint32_t uiSeq = 1; uiSeq <= 3; ++uiSeq)
+	{
+		EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA" + std::to_string(uiSeq), false));
+		EXPECT_EQ(uiSeq, m_payload.seq);
+	}
+	EXPECT_EQ(3u, pPublisher->getLastSeq());
+	EXPECT_EQ(4u, pPublisher->getQueuedCount());
+
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	EXPECT_EQ(0u, m_payload.seq);
+	EXPECT_EQ(0u, pPublisher->getLastSeq());
+
+	uint32_t uiRetryMs = 0;
+	while(true == pPublisher->publishNext(uiRetryMs));
+	std::vector<std::string> vecExpected{"NBIRTH", "DDATA1", "DDATA2", "DDATA3", "NBIRTH"};
+	EXPECT_EQ(vecExpected, m_vecTopics);
+	EXPECT_EQ(5u, pPublisher->getPublishedCount());
+}
+
+/**
+ * Test case to check that sequence number wraps from 255 to 0
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, enqueue_SeqWraps)
+{
+	std::unique_ptr<CSparkplugPublisher> pPublisher(createPublisher(300));
+
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	for(int i = 0; i < 256; ++i)
+	{
+		EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA", false));
+	}
+	EXPECT_EQ(0u, m_payload.seq);
+}
+
+/**
+ * Test case to check that a refused message is retried with growing wait and
+ * later messages are not published ahead of it
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, publishNext_RetryKeepsOrder)
+{
+	std::unique_ptr<CSparkplugPublisher> pPublisher(createPublisher(10));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA", false));
+
+	m_iFailCount = 2;
+	uint32_t uiRetryMs = 0;
+	EXPECT_FALSE(pPublisher->publishNext(uiRetryMs));
+	EXPECT_EQ((uint32_t)SPARKPLUG_PUBLISH_RETRY_MIN_MS, uiRetryMs);
+	EXPECT_FALSE(pPublisher->publishNext(uiRetryMs));
+	EXPECT_EQ((uint32_t)SPARKPLUG_PUBLISH_RETRY_MIN_MS * 2, uiRetryMs);
+	EXPECT_EQ(2u, pPublisher->getQueuedCount());
+
+	EXPECT_TRUE(pPublisher->publishNext(uiRetryMs));
+	EXPECT_EQ(0u, uiRetryMs);
+	EXPECT_TRUE(pPublisher->publishNext(uiRetryMs));
+	std::vector<std::string> vecExpected{"NBIRTH", "DDATA"};
+	EXPECT_EQ(vecExpected, m_vecTopics);
+	EXPECT_EQ(2u, pPublisher->getRetryCount());
+
+	// empty queue
+	EXPECT_FALSE(pPublisher->publishNext(uiRetryMs));
+	EXPECT_EQ(0u, uiRetryMs);
+}
+
+/**
+ * Test case to check that producer is blocked while queue is full
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, enqueue_BlocksWhenFull)
+{
+	std::unique_ptr<CSparkplugPublisher> pPublisher(createPublisher(2));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA1", false));
+
+	std::atomic<bool> bIsQueued{false};
+	std::thread producer([&]() {
+		org_eclipse_tahu_protobuf_Payload payload;
+		memset(&payload, 0, sizeof(org_eclipse_tahu_protobuf_Payload));
+		pPublisher->enqueue(payload, "DDATA2", false);
+		bIsQueued.store(true);
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_FALSE(bIsQueued.load());
+
+	uint32_t uiRetryMs = 0;
+	EXPECT_TRUE(pPublisher->publishNext(uiRetryMs));
+	producer.join();
+	EXPECT_TRUE(bIsQueued.load());
+	EXPECT_EQ(2u, pPublisher->getQueuedCount());
+	EXPECT_EQ(2u, pPublisher->getLastSeq());
+}
+
+/**
+ * Test case to check that session loss drops queued messages and only NBIRTH
+ * is accepted till session is established again
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, reset_DropsTillNBirth)
+{
+	std::unique_ptr<CSparkplugPublisher> pPublisher(createPublisher(10));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA", false));
+
+	pPublisher->reset();
+	EXPECT_EQ(0u, pPublisher->getQueuedCount());
+	EXPECT_EQ(2u, pPublisher->getDroppedCount());
+
+	EXPECT_FALSE(pPublisher->enqueue(m_payload, "DDATA", false));
+	EXPECT_EQ(3u, pPublisher->getDroppedCount());
+
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA", false));
+	EXPECT_EQ(1u, m_payload.seq);
+	EXPECT_EQ(2u, pPublisher->getQueuedCount());
+}
+
+/**
+ * Test case to check that reset() waits for a message being handed to client,
+ * so that no message of lost session is handed after it, and that new session
+ * starts with next generation
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, reset_WaitsForHandOver)
+{
+	std::atomic<bool> bIsHanding{false};
+	std::atomic<bool> bIsHanded{false};
+	std::unique_ptr<CSparkplugPublisher> pPublisher(new CSparkplugPublisher(
+		[&](mqtt::message_ptr &a_pMsg)
+		{
+			bIsHanding.store(true);
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			bool bRet = publish(a_pMsg);
+			bIsHanded.store(true);
+			return bRet;
+		}, 10, 1));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA", false));
+	EXPECT_EQ(0u, pPublisher->getSession());
+
+	std::thread publisher([&pPublisher]() { uint32_t uiRetryMs = 0; pPublisher->publishNext(uiRetryMs); });
+	while(false == bIsHanding.load())
+	{
+		std::this_thread::yield();
+	}
+	pPublisher->reset();
+	EXPECT_TRUE(bIsHanded.load());
+	publisher.join();
+
+	EXPECT_EQ(1u, pPublisher->getSession());
+	EXPECT_EQ(0u, pPublisher->getQueuedCount());
+	EXPECT_EQ(1u, pPublisher->getDroppedCount());
+
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	uint32_t uiRetryMs = 0;
+	EXPECT_TRUE(pPublisher->publishNext(uiRetryMs));
+	std::vector<std::string> vecExpected{"NBIRTH", "NBIRTH"};
+	EXPECT_EQ(vecExpected, m_vecTopics);
+	EXPECT_EQ(0u, pPublisher->getQueuedCount());
+}
+
+/**
+ * Test case to check that publisher thread publishes queued messages in order
+ * and stops on request
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, run_PublishesInOrder)
+{
+	std::unique_ptr<CSparkplugPublisher> pPublisher(createPublisher(10));
+	m_iFailCount = 1;
+	std::thread publisher(&CSparkplugPublisher::run, pPublisher.get());
+
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA1", false));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA2", false));
+	for(int i = 0; (i < 100) && (pPublisher->getPublishedCount() < 3); ++i)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	pPublisher->stop();
+	publisher.join();
+
+	std::vector<std::string> vecExpected{"NBIRTH", "DDATA1", "DDATA2"};
+	EXPECT_EQ(vecExpected, m_vecTopics);
+	EXPECT_EQ(1u, pPublisher->getRetryCount());
+}
+
+/**
+ * Test case to check that timestamp and sequence number are appended to an
+ * encoded payload as protobuf varint fields
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, appendTimestampAndSeq)
+{
+	std::string sEncoded("\x12\x00", 2);
+	EXPECT_TRUE(CSparkplugPublisher::appendTimestampAndSeq(sEncoded, 1, 2));
+	EXPECT_EQ(std::string("\x12\x00\x08\x01\x18\x02", 6), sEncoded);
+
+	// timestamp of more than 7 bits takes more than one byte
+	sEncoded.clear();
+	EXPECT_TRUE(CSparkplugPublisher::appendTimestampAndSeq(sEncoded, 300, 255));
+	EXPECT_EQ(std::string("\x08\xAC\x02\x18\xFF\x01", 6), sEncoded);
+}
+
+/**
+ * Test case to check that already encoded payloads get next sequence numbers
+ * and are published in order with other messages
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, enqueueEncoded_SeqOrder)
+{
+	std::unique_ptr<CSparkplugPublisher> pPublisher(createPublisher(10));
+	std::thread publisher(&CSparkplugPublisher::run, pPublisher.get());
+
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "NBIRTH", true));
+	std::string sDBirth1("DBIRTH1"), sDBirth2("DBIRTH2");
+	size_t uiEncodedLen = 0;
+	EXPECT_TRUE(pPublisher->enqueueEncoded(sDBirth1, "DBIRTH1", &uiEncodedLen));
+	EXPECT_LT(std::string("DBIRTH1").size(), uiEncodedLen);
+	EXPECT_TRUE(pPublisher->enqueueEncoded(sDBirth2, "DBIRTH2"));
+	EXPECT_TRUE(pPublisher->enqueue(m_payload, "DDATA", false));
+	EXPECT_EQ(3u, m_payload.seq);
+	for(int i = 0; (i < 100) && (pPublisher->getPublishedCount() < 4); ++i)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	pPublisher->stop();
+	publisher.join();
+
+	std::vector<std::string> vecExpected{"NBIRTH", "DBIRTH1", "DBIRTH2", "DDATA"};
+	ASSERT_EQ(vecExpected, m_vecTopics);
+	// payload is kept as it is and ends with sequence number field
+	EXPECT_EQ(0u, m_vecPayloads[1].find("DBIRTH1"));
+	EXPECT_EQ(std::string("\x18\x01", 2), m_vecPayloads[1].substr(m_vecPayloads[1].size() - 2));
+	EXPECT_EQ(std::string("\x18\x02", 2), m_vecPayloads[2].substr(m_vecPayloads[2].size() - 2));
+}
+
+/**
+ * Test case to check that already encoded payloads are dropped after session loss
+ * @param :[in] None
+ * @param :[out] None
+ * @return None
+ */
+TEST_F(SparkplugPublisher_ut, enqueueEncoded_DroppedTillNBirth)
+{
+	std::unique_ptr<CSparkplugPublisher> pPublisher(createPublisher(10));
+	pPublisher->reset();
+	std::string sDBirth("DBIRTH");
+	EXPECT_FALSE(pPublisher->enqueueEncoded(sDBirth, "DBIRTH"));
+	EXPECT_EQ(1u, pPublisher->getDroppedCount());
+	EXPECT_EQ(0u, pPublisher->getQueuedCount());
+}
@@ -56,6 +56,7 @@ private:
 	std::string m_strGroupId; /** value of group ID*/
 	std::string m_strNodeName; /** node name*/
 	bool m_bIsScadaTLS; /** scada TLS(true or false)*/
+	bool m_bIsMetricAliases; /** metrics are given aliases in birth messages(true or false)*/
 
 	void setScadaRTUIds();
 
@@ -254,6 +255,28 @@ public:
 		m_bIsScadaTLS = a_bIsTLS;
 	}
 
+	/**
+	 * Check if metrics are given aliases in birth messages. DDATA messages then
+	 * carry only alias of metric instead of its name.
+	 * @param None
+	 * @return true if aliases are used
+	 * 			false if metrics are sent with names
+	 */
+	bool isMetricAliases() const
+	{
+		return m_bIsMetricAliases;
+	}
+
+	/**
+	 * Set use of metric aliases
+	 * @param a_bIsMetricAliases :[in] value to set for using aliases
+	 * @return None
+	 */
+	void setMetricAliases(bool a_bIsMetricAliases)
+	{
+		m_bIsMetricAliases = a_bIsMetricAliases;
+	}
+
 	bool getTopicParts(std::string a_sTopic, std::vector<std::string> &a_vsTopicParts, const std::string& a_delimeter);
 	std::string get_timestamp();
 	void set_timestamp();
@@ -0,0 +1,106 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/** DDataAggregator.hpp merges DDATA of a device over a time and size bounded window*/
+
+#ifndef DDATAAGGREGATOR_HPP_
+#define DDATAAGGREGATOR_HPP_
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "SparkPlugDevices.hpp"
+
+/** interval after which DDATA publish statistics are logged */
+#define DDATA_STATS_LOG_INTERVAL_MS		60000
+
+/** Structure holding changed metrics of a device waiting for window to close*/
+struct stPendingDData
+{
+	std::reference_wrapper<CSparkPlugDev> m_refSparkPlugDev; /** device for which DDATA is pending*/
+	metricMapIf_t m_mapMetrics; /** latest value of each changed metric*/
+	std::vector<stRealDevMetricSample> m_vecSamples; /** latest value of each changed metric of real device*/
+	uint64_t m_ui64WindowStartMs; /** time at which first metric entered the window*/
+};
+
+/** Class to merge changed metrics of a device into a single DDATA*/
+class CDDataAggregator
+{
+	uint32_t m_uiWindowMs; /** window length in msec; 0 disables aggregation*/
+	uint32_t m_uiMaxMetrics; /** window is closed once these many metrics are pending*/
+	bool m_bRTBypass; /** publish updates of real-time metrics without waiting*/
+
+	std::mutex m_mutexPending; /** mutex for pending map*/
+	std::map<std::string, stPendingDData> m_mapPending; /** pending DDATA per device name*/
+
+	std::atomic<uint64_t> m_ui64Packets{0}; /** DDATA packets published in current stats interval*/
+	std::atomic<uint64_t> m_ui64Metrics{0}; /** metrics published in current stats interval*/
+	std::atomic<uint64_t> m_ui64Bytes{0}; /** encoded bytes published in current stats interval*/
+	std::atomic<uint64_t> m_ui64StatsStartMs{0}; /** start of current stats interval*/
+
+	void moveToReady(std::map<std::string, stPendingDData>::iterator a_itr,
+			std::vector<stRefForSparkPlugAction> &a_vecReady);
+
+	/** delete copy and move constructors and assign operators*/
+	CDDataAggregator(const CDDataAggregator&) = delete;
+	CDDataAggregator& operator=(const CDDataAggregator&) = delete;
+
+public:
+	CDDataAggregator(uint32_t a_uiWindowMs, uint32_t a_uiMaxMetrics, bool a_bRTBypass);
+
+	/** function tells whether aggregation is enabled*/
+	bool isEnabled() const
+	{
+		return (0 != m_uiWindowMs);
+	}
+
+	/** function to get window length in msec*/
+	uint32_t getWindowMs() const
+	{
+		return m_uiWindowMs;
+	}
+
+	/** function to get max metrics in a window*/
+	uint32_t getMaxMetrics() const
+	{
+		return m_uiMaxMetrics;
+	}
+
+	bool add(const stRefForSparkPlugAction &a_stRefAction, uint64_t a_ui64NowMs,
+			std::vector<stRefForSparkPlugAction> &a_vecReady);
+	void takeExpired(uint64_t a_ui64NowMs, std::vector<stRefForSparkPlugAction> &a_vecReady);
+	bool take(const std::string &a_sDevName, std::vector<stRefForSparkPlugAction> &a_vecReady);
+	void takeAll(std::vector<stRefForSparkPlugAction> &a_vecReady);
+	size_t discardAll();
+	size_t getPendingMetricCount();
+
+	void recordPacket(size_t a_uiMetrics, size_t a_uiBytes);
+	bool getStats(uint64_t a_ui64NowMs, double &a_dPacketsPerSec, double &a_dBytesPerMetric);
+
+	static bool hasRealTimeMetric(const metricMapIf_t &a_mapMetrics);
+	static bool hasRealTimeMetric(const CSparkPlugDev &a_oDev, const std::vector<stRealDevMetricSample> &a_vecSamples);
+	static uint64_t getMonotonicMs();
+};
+
+#endif
@@ -0,0 +1,87 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/** FlapDamper.hpp holds back announcement of a link which goes up and down repeatedly*/
+
+#ifndef FLAPDAMPER_HPP_
+#define FLAPDAMPER_HPP_
+
+#include <cstdint>
+
+/** State of a damped link*/
+enum eFlapState
+{
+	enFLAP_DOWN = 0,	/** link is down*/
+	enFLAP_HOLD,		/** link is up; announcement is held back till hold-down ends*/
+	enFLAP_ANNOUNCED	/** link is up and is announced*/
+};
+
+/** Class to suppress announcements of a flapping link. A link which goes down before it has
+ * stayed up for stable period is flapping; its next announcement is held back for hold-down,
+ * which doubles with each such flap up to max. A link which goes down again during hold-down
+ * is never announced, so only latest state of link is announced. Caller serializes access.*/
+class CFlapDamper
+{
+	uint32_t m_uiHoldDownMs; /** hold-down after first flap; 0 disables damping*/
+	uint32_t m_uiMaxHoldDownMs; /** max hold-down*/
+	uint32_t m_uiStableMs; /** link which stays up this long is not flapping*/
+
+	eFlapState m_enState = enFLAP_DOWN; /** current state*/
+	uint32_t m_uiCurHoldDownMs = 0; /** hold-down applied on next up*/
+	uint64_t m_ui64UpAtMs = 0; /** time at which link went up*/
+	uint64_t m_ui64AnnounceAtMs = 0; /** time at which hold-down ends*/
+	uint64_t m_ui64Suppressed = 0; /** ups which went down before being announced*/
+
+public:
+	CFlapDamper(uint32_t a_uiHoldDownMs, uint32_t a_uiMaxHoldDownMs, uint32_t a_uiStableMs);
+
+	void linkUp(uint64_t a_ui64NowMs);
+	void linkDown(uint64_t a_ui64NowMs);
+	bool takeAnnouncement(uint64_t a_ui64NowMs);
+	void reannounce(uint64_t a_ui64NowMs);
+
+	/** function to get current state*/
+	eFlapState getState() const
+	{
+		return m_enState;
+	}
+
+	/** function to get time at which held back announcement is due*/
+	uint64_t getAnnounceAtMs() const
+	{
+		return m_ui64AnnounceAtMs;
+	}
+
+	/** function to get hold-down applied on next up*/
+	uint32_t getHoldDownMs() const
+	{
+		return m_uiCurHoldDownMs;
+	}
+
+	/** function to get number of suppressed announcements*/
+	uint64_t getSuppressedCount() const
+	{
+		return m_ui64Suppressed;
+	}
+};
+
+#endif
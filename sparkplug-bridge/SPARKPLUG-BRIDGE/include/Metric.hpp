@@ -162,6 +162,12 @@ public:
 		return m_objVal;
 	}
 
+	/*Function to read value */
+	const var_t& getValue() const
+	{
+		return m_objVal;
+	}
+
 	/*Function to add value data to a Sparkplug metric */
 	bool assignToSparkPlug(org_eclipse_tahu_protobuf_Payload_Metric &a_metric) const;
 	/*Function to add value data to a Sparkplug parameter */
@@ -239,6 +245,7 @@ protected:
 	uint32_t m_uiDataType = METRIC_DATA_TYPE_UNKNOWN;
 	std::string m_sName; /** site name*/
 	std::string m_sSparkPlugName; /** spark plug name*/
+	uint64_t m_ui64Alias = 0; /** sparkplug alias assigned at birth; 0 if not assigned*/
 	
 public:
 	/* Constructor **/
@@ -286,6 +293,18 @@ public:
 		m_sSparkPlugName = a_sVal;
 	}
 
+	/** function to get sparkplug alias*/
+	uint64_t getAlias() const
+	{
+		return m_ui64Alias;
+	}
+
+	/** function to set sparkplug alias*/
+	void setAlias(const uint64_t a_ui64Alias)
+	{
+		m_ui64Alias = a_ui64Alias;
+	}
+
 	/** function to set time stamp value*/
 	void setTimestamp(const uint64_t a_timestamp)
 	{
@@ -344,6 +363,12 @@ public:
 	/** function to add metric information into Sparkplug object for Birth msg for Modbus metric*/
 	virtual bool addModbusMetric(org_eclipse_tahu_protobuf_Payload_Metric& a_rMetric, bool a_bIsBirth) = 0;
 
+	/** function to tell whether metric is a real-time point*/
+	virtual bool isRealTime() const
+	{
+		return false;
+	}
+
 	/** function to create CJSON object for this metric */
 	// change the prototype here
 	virtual bool assignToCJSON(cJSON *a_cjMetric, bool a_bIsRealDevice) = 0;
@@ -483,6 +508,9 @@ public:
 	/** function to create Sparkplug object for this metric if it is of type Modbus */
 	bool addModbusMetric(org_eclipse_tahu_protobuf_Payload_Metric& a_rMetric, bool a_bIsBirth) override;
 
+	/** function to tell whether this Modbus metric is polled in real-time */
+	bool isRealTime() const override;
+
 	/** function to create this metric from CJSON object for this metric */
 	bool processMetric(cJSON *a_cjArrayElemMetric) override;
 
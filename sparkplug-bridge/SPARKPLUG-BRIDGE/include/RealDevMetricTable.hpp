@@ -0,0 +1,110 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/** RealDevMetricTable.hpp holds metrics of a real device in flat arrays addressed by index*/
+
+#ifndef REALDEVMETRICTABLE_HPP_
+#define REALDEVMETRICTABLE_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Metric.hpp"
+
+/** index returned when metric is not present in table*/
+#define REAL_DEV_METRIC_INVALID_INDEX	UINT32_MAX
+
+/** Value of a metric of real device at the time it changed*/
+struct stRealDevMetricSample
+{
+	uint32_t m_uiIndex; /** index of metric in table of device*/
+	uint64_t m_ui64Timestamp; /** timestamp of value*/
+	CValObj m_oValue; /** changed value*/
+};
+
+/** Class holding metrics of a real (Modbus) device as struct of arrays. Metric set of a
+ * real device is fixed once device is added, so a metric is addressed by a dense index
+ * resolved once from its data point id.*/
+class CRealDevMetricTable
+{
+	std::vector<std::string> m_vecNames; /** sparkplug name of metric*/
+	std::vector<uint32_t> m_vecDataTypes; /** sparkplug datatype of metric*/
+	std::vector<uint64_t> m_vecValues; /** value bits; index in m_vecStrings for string metrics*/
+	std::vector<uint64_t> m_vecTimestamps; /** timestamp of value*/
+	std::vector<const network_info::CUniqueDataPoint*> m_vecPoints; /** data point of metric, if any*/
+	std::vector<std::string> m_vecStrings; /** values of string metrics*/
+	std::unordered_map<std::string, uint32_t> m_mapIndex; /** index of metric by name*/
+	uint64_t m_ui64Version = 0; /** changed when a metric is added or value of a metric changes*/
+
+	static bool toBits(const CValObj &a_oValue, uint64_t &a_ui64Bits);
+	static CValObj fromBits(uint32_t a_uiDataType, uint64_t a_ui64Bits);
+
+public:
+	uint32_t add(const std::string &a_sName, const CValObj &a_oValue,
+			const network_info::CUniqueDataPoint *a_pPoint);
+	uint32_t findIndex(const std::string &a_sName) const;
+
+	/** function to get version of metric values; timestamps alone do not change it*/
+	uint64_t getVersion() const
+	{
+		return m_ui64Version;
+	}
+
+	/** function to get number of metrics*/
+	size_t size() const
+	{
+		return m_vecNames.size();
+	}
+
+	/** function to get sparkplug name of metric*/
+	const std::string& getName(uint32_t a_uiIndex) const
+	{
+		return m_vecNames.at(a_uiIndex);
+	}
+
+	/** function to get sparkplug datatype of metric*/
+	uint32_t getDataType(uint32_t a_uiIndex) const
+	{
+		return m_vecDataTypes.at(a_uiIndex);
+	}
+
+	/** function to get timestamp of metric value*/
+	uint64_t getTimestamp(uint32_t a_uiIndex) const
+	{
+		return m_vecTimestamps.at(a_uiIndex);
+	}
+
+	/** function to set timestamp of metric value*/
+	void setTimestamp(uint32_t a_uiIndex, uint64_t a_ui64Timestamp)
+	{
+		m_vecTimestamps.at(a_uiIndex) = a_ui64Timestamp;
+	}
+
+	CValObj getValue(uint32_t a_uiIndex) const;
+	uint8_t compareValue(uint32_t a_uiIndex, const CValObj &a_oValue) const;
+	bool setValue(uint32_t a_uiIndex, const CValObj &a_oValue);
+	bool isRealTime(uint32_t a_uiIndex) const;
+	bool addModbusMetric(uint32_t a_uiIndex, const CValObj &a_oValue,
+			org_eclipse_tahu_protobuf_Payload_Metric &a_rMetric, bool a_bIsBirth) const;
+};
+
+#endif
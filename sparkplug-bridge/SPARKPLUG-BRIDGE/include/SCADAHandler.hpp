@@ -26,6 +26,7 @@
 #define SCADAHANDLER_HPP_
 
 #include <mqtt/async_client.h>
+#include <thread>
 #include <vector>
 #include <semaphore.h>
 #include "MQTTPubSubClient.hpp"
@@ -39,11 +40,17 @@
 #include <inttypes.h>
 
 #include "QueueMgr.hpp"
+#include "DDataAggregator.hpp"
+#include "SparkplugPublisher.hpp"
+#include "FlapDamper.hpp"
 extern "C"
 {
 #include <tahu.h>
 }
 
+/** default number of threads encoding DBIRTH messages of all devices */
+#define SCADA_BIRTH_DEFAULT_THREADS		4
+
 /** namespace for network information*/
 using namespace network_info;
 
@@ -52,13 +59,22 @@ class CSCADAHandler : public CMQTTBaseHandler
 {
 	uint64_t m_uiBDSeq = 0; /** sequence number for birth message */
 
-	sem_t m_semSCADAConnSuccess; /** semaphore for connection success*/
+	std::mutex m_mutexScadaLink; /** mutex for state of SCADA connection*/
+	std::condition_variable m_cvScadaLink; /** signalled when SCADA connection changes*/
+	std::unique_ptr<CFlapDamper> m_pScadaDamper; /** holds back births while SCADA connection flaps*/
+	std::atomic<uint64_t> m_ui64ScadaLinkDowns{0}; /** number of SCADA connection losses*/
 	sem_t m_semIntMQTTConnLost; /** semaphore for internal mqtt connection lost*/
 	sem_t m_semIntMQTTConnEstablished; /** semaphore for internal mqtt connection established*/
 
 	std::atomic<bool> m_bIsInitDone = false; /** flag for initialization check */
 
-	std::mutex m_mutexSparkPlugMsgPub; /** mutex to control publishing */
+	int m_iMaxInflight = MQTT_DEFAULT_MAX_INFLIGHT; /** max messages in flight to SCADA master; 1 means wait for each message */
+	std::unique_ptr<CSparkplugPublisher> m_pPublisher; /** publishes messages in order of sequence numbers */
+	std::thread m_thPublisher; /** thread publishing queued messages; joined in destructor */
+	uint32_t m_uiBirthThreads = SCADA_BIRTH_DEFAULT_THREADS; /** threads encoding DBIRTH messages of all devices */
+
+	std::unique_ptr<CDDataAggregator> m_pDDataWindow; /** window to merge DDATA per device */
+	std::mutex m_mutexDDataWindow; /** mutex to keep DDATA from window in order with other messages of device */
 
 	/** Default constructor*/
 	CSCADAHandler(const std::string &strPlBusUrl, int iQOS);
@@ -71,29 +87,38 @@ class CSCADAHandler : public CMQTTBaseHandler
 	void setInitStatus(bool a_bStatus) {return m_bIsInitDone.store(a_bStatus);}
 
 	bool init();
+	void initPublishWindow();
+	void initDDataWindow();
+	void initFlapDamping();
 	void prepareNodeDeathMsg(bool a_bPublishMsg);
 	void handleSCADAConnectionSuccessThread();
 	void handleIntMQTTConnLostThread();
 	void handleIntMQTTConnEstablishThread();
-	void publish_node_birth();
+	void handleDDataWindowThread();
+	bool publish_node_birth();
 	void publishAllDevBirths(bool a_bIsNBIRTHProcess);
-	void publish_device_birth(string a_deviceName, bool a_bIsNBIRTHProcess);
+	void publish_device_birth(string a_deviceName, bool a_bIsNBIRTHProcess, bool a_bIsWindowLocked = true);
 	bool publishMsgDDEATH(const stRefForSparkPlugAction& a_stRefAction);
 	bool publishMsgDDEATH(const std::string &a_sDevName);
 	bool publishMsgDDATA(const stRefForSparkPlugAction& a_stRefAction);
+	void publishDDataList(std::vector<stRefForSparkPlugAction>& a_vecDData);
+	void flushDDataWindow(const std::string &a_sDevName);
+	void discardDDataWindow(const std::string &a_sDevName);
 
 	void subscribeTopics();
 	void connected(const std::string &a_sCause) override;
 	void disconnected(const std::string &a_sCause) override;
 	void msgRcvd(mqtt::const_message_ptr a_pMsg) override;
 
-	bool publishSparkplugMsg(org_eclipse_tahu_protobuf_Payload& a_payload, string a_topic, bool a_bIsNBirth);
+	bool publishSparkplugMsg(org_eclipse_tahu_protobuf_Payload& a_payload, string a_topic, bool a_bIsNBirth,
+			size_t *a_pEncodedLen = nullptr);
 
 	void defaultPayload(org_eclipse_tahu_protobuf_Payload& a_payload);
 
 	bool addModbusTemplateDefToNbirth(org_eclipse_tahu_protobuf_Payload& a_rTahuPayload);
 
 	bool publishNewUDTs();
+	void requestRebirth();
 
 public:
 	/** Destructor*/
@@ -36,6 +36,7 @@
 #include <map>
 #include <functional>
 #include "SparkPlugDevices.hpp"
+#include "SparkPlugDevRegistry.hpp"
 #include "NetworkInfo.hpp"
 
 extern "C"
@@ -46,9 +47,8 @@ extern "C"
 /** Class to maintain spark plug device operations*/
 class CSparkPlugDevManager
 {
-	devSparkplugMap_t m_mapSparkPlugDev; /** reference of devSparkplugMap_t*/
+	CSparkPlugDevRegistry m_oDevRegistry; /** sparkplug devices, locked per stripe*/
 	CVendorAppList m_objVendorAppList; /** object of class CVendorAppList*/
-	std::mutex m_mutexDevList; /** mutext for device list*/
 
 	/** default constructor*/
 	CSparkPlugDevManager()
@@ -57,6 +57,7 @@ class CSparkPlugDevManager
 
 	metricMapIf_t parseVendorAppBirthDataMessage(std::string a_sPayLoad, bool a_bIsBirthMsg);
 	bool processDCMDMetric(CSparkPlugDev& a_SPDev, CIfMetric &a_oIfMetric, org_eclipse_tahu_protobuf_Payload_Metric& a_sparkplugMetric);
+	bool resolveDCMDMetricAlias(CSparkPlugDev& a_SPDev, org_eclipse_tahu_protobuf_Payload_Metric& a_sparkplugMetric);
 
 	uint64_t parseVendorAppDeathMessage(std::string& a_sPayLoad);
 
@@ -94,6 +95,7 @@ public:
 	bool addRealDevices();
 
 	bool prepareDBirthMessage(org_eclipse_tahu_protobuf_Payload& a_rTahuPayload, std::string a_sDevName, bool a_bIsNBIRTHProcess);
+	bool encodeDBirthMessage(std::string &a_sEncoded, const std::string &a_sDevName, bool a_bIsNBIRTHProcess);
 	bool setMsgPublishedStatus(eDevStatus a_enStatus, std::string a_sDevName);
 
 	std::vector<std::string> getDeviceList();
@@ -111,6 +113,7 @@ public:
 	}
 #ifdef UNIT_TEST
 	friend class Metric_ut;
+	friend class SparkPlugDevMgr_ut;
 #endif
 };
 
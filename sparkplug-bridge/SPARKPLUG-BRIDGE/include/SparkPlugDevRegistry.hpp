@@ -0,0 +1,74 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/** SparkPlugDevRegistry.hpp holds sparkplug devices in lock striped maps*/
+
+#ifndef SPARKPLUG_DEV_REGISTRY_HPP_
+#define SPARKPLUG_DEV_REGISTRY_HPP_
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "SparkPlugDevices.hpp"
+
+/** default number of stripes of device registry*/
+#define SPARKPLUG_DEV_REGISTRY_STRIPES	64
+
+/** One stripe of device registry; kept on its own cache line*/
+struct alignas(64) stDevStripe
+{
+	std::mutex m_mutex; /** mutex for devices of this stripe*/
+	devSparkplugMap_t m_mapDev; /** devices of this stripe*/
+};
+
+/** Class holding sparkplug devices. A device name is hashed to one of the stripes and only
+ * that stripe is locked, and only for lookup or insertion. Devices are never removed, so a
+ * device reference stays valid after stripe lock is released; per-device state is protected
+ * by locks of the device itself.*/
+class CSparkPlugDevRegistry
+{
+	std::vector<stDevStripe> m_vecStripes; /** stripes of registry*/
+
+	/** delete copy constructor and assign operator*/
+	CSparkPlugDevRegistry(const CSparkPlugDevRegistry&) = delete;
+	CSparkPlugDevRegistry& operator=(const CSparkPlugDevRegistry&) = delete;
+
+public:
+	explicit CSparkPlugDevRegistry(uint32_t a_uiStripes = SPARKPLUG_DEV_REGISTRY_STRIPES);
+
+	/** function to get number of stripes*/
+	uint32_t getStripeCount() const
+	{
+		return (uint32_t)m_vecStripes.size();
+	}
+
+	uint32_t getStripe(const std::string &a_sName) const;
+	CSparkPlugDev* find(const std::string &a_sName);
+	CSparkPlugDev& findOrAdd(const std::string &a_sName,
+			const std::function<CSparkPlugDev()> &a_fnCreate,
+			const std::function<void(CSparkPlugDev&)> &a_fnOnAdd, bool &a_bIsNew);
+	std::vector<std::string> getNames();
+	size_t size();
+};
+
+#endif
@@ -35,8 +35,10 @@
 #include <map>
 #include <functional>
 #include <mutex>
+#include <atomic>
 
 #include "Metric.hpp"
+#include "RealDevMetricTable.hpp"
 #include "NetworkInfo.hpp"
 #include "Common.hpp"
 
@@ -69,6 +71,20 @@ enum eYMlDataType
 
 struct stRefForSparkPlugAction;
 
+/** Fields of update message of a real device, read in a single pass over the message*/
+struct stRealDevUpdate
+{
+	std::string m_sMetric; /** value of "metric" key*/
+	std::string m_sValue; /** value of "value" key*/
+	std::string m_sStatus; /** value of "status" key*/
+	uint64_t m_usec = 0; /** "usec" in msec; current time if not present*/
+	uint64_t m_lastGoodUsec = 0; /** "lastGoodUsec" in msec; 0 if not present*/
+	uint32_t m_error_code = 0; /** value of "error_code" key; 0 if not present*/
+	int m_iScaledType = cJSON_Invalid; /** cJSON type of "scaledValue"; cJSON_Invalid if not present*/
+	double m_dScaledValue = 0; /** "scaledValue" if it is a number*/
+	std::string m_sScaledValue; /** "scaledValue" if it is a string*/
+};
+
 /** class holding spark plug device information*/
 class CSparkPlugDev
 {
@@ -76,28 +92,76 @@ class CSparkPlugDev
 	std::string m_sSparkPlugName;/**spark plug name*/
 	bool m_bIsVendorApp;/** vendor app or not(true or false)*/
 	metricMapIf_t m_mapMetrics; /** reference for metricMapIf_t*/
+	CRealDevMetricTable m_oMetricTable; /** metrics of real device*/
 	std::atomic<eDevStatus> m_enLastStatetPublishedToSCADA;/** last state published to scada*/
 	std::atomic<eDevStatus> m_enLastKnownStateFromDev; /** last state known from device*/
 	uint64_t m_deathTimestamp; /** value for death timestamp*/
 	var_dev_ref_t m_rDirectDevRef; /** direct device reference*/
 	std::mutex m_mutexMetricList; /** mutex for metric list*/
+	std::map<std::string, uint64_t> m_mapAliases; /** alias of metric given in birth message; kept across rebirths*/
+	std::map<uint64_t, std::string> m_mapAliasNames; /** metric name of alias, to resolve alias in DCMD*/
+	std::mutex m_mutexAliases; /** mutex for aliases*/
+	static std::atomic<uint64_t> m_ui64NextAlias; /** next alias; aliases are unique across edge node*/
+	uint64_t m_ui64MetricMapVersion = 0; /** changed when a metric of vendor app is added or changed*/
+	std::string m_sDBirthCache; /** encoded DBIRTH without payload timestamp and sequence number*/
+	uint64_t m_ui64DBirthCacheVersion = 0; /** version of metrics when DBIRTH was encoded*/
+	bool m_bIsDBirthCached = false; /** true if m_sDBirthCache holds an encoded DBIRTH*/
 
 	CSparkPlugDev& operator=(const CSparkPlugDev&) = delete;	/// assignmnet operator
 
-	bool parseRealDeviceUpdateMsg(const std::string &a_sPayLoad, 
-		std::string &a_sMetric, std::string &a_sValue, std::string &a_sStatus,
-		uint64_t &a_usec, uint64_t &a_lastGoodUsec, uint32_t &a_error_code);
+	static bool parseRealDeviceUpdateMsg(const std::string &a_sPayLoad, stRealDevUpdate &a_stUpdate);
 
-	bool parseScaledValueRealDevices(const std::string &a_sPayLoad, std::string &a_sMetric,
+	static bool getScaledValue(const stRealDevUpdate &a_stUpdate, uint32_t a_uiDataType,
 			 CValObj &a_rValobj);
 
-	bool validateRealDeviceUpdateData(
-		const std::string &a_sValue, std::string a_sStatus,
-		uint32_t a_error_code,
+	static bool validateRealDeviceUpdateData(const stRealDevUpdate &a_stUpdate,
 		bool &a_bIsGood, bool &a_bIsDeathCode);
 
+	bool addRealDevMetric(const std::string &a_sName, const CValObj &a_oValue,
+		const network_info::CUniqueDataPoint *a_pPoint);
+
 	bool prepareModbusMessage(org_eclipse_tahu_protobuf_Payload& a_rTahuPayload, 
-		const metricMapIf_t &a_mapMetrics, bool a_bIsBirth);
+		const std::vector<stRealDevMetricSample> *a_pvecSamples, bool a_bIsBirth);
+
+	uint64_t assignAlias(const std::string &a_sName);
+
+	bool isDBirthNeeded(bool a_bIsNBIRTHProcess);
+	void addDBirthMetrics(org_eclipse_tahu_protobuf_Payload& a_rTahuPayload);
+
+	/** function to check if datatype of received metric can be written to metric of given datatype*/
+	static bool isDataTypeCompatible(uint32_t a_uiMyDataType, uint32_t a_uiRcvdDataType)
+	{
+		switch(a_uiMyDataType)
+		{
+		case METRIC_DATA_TYPE_INT8:
+		case METRIC_DATA_TYPE_INT16:
+		case METRIC_DATA_TYPE_INT32:
+		case METRIC_DATA_TYPE_INT64:
+		case METRIC_DATA_TYPE_BOOLEAN:
+		case METRIC_DATA_TYPE_FLOAT:
+		case METRIC_DATA_TYPE_DOUBLE:
+		case METRIC_DATA_TYPE_STRING:
+			return (a_uiMyDataType == a_uiRcvdDataType);
+
+		// Unsigned datatypes are sometimes just treated as integers
+		// Accordingly a datatype is received
+		case METRIC_DATA_TYPE_UINT8:
+		case METRIC_DATA_TYPE_UINT16:
+		case METRIC_DATA_TYPE_UINT32:
+		case METRIC_DATA_TYPE_UINT64:
+			return (
+				(METRIC_DATA_TYPE_UINT8 == a_uiRcvdDataType) ||
+				(METRIC_DATA_TYPE_UINT16 == a_uiRcvdDataType) ||
+				(METRIC_DATA_TYPE_INT8 == a_uiRcvdDataType) ||
+				(METRIC_DATA_TYPE_INT16 == a_uiRcvdDataType) ||
+				(METRIC_DATA_TYPE_INT32 == a_uiRcvdDataType) ||
+				(METRIC_DATA_TYPE_UINT32 == a_uiRcvdDataType) ||
+				(METRIC_DATA_TYPE_UINT64 == a_uiRcvdDataType) ||
+				(METRIC_DATA_TYPE_INT64 == a_uiRcvdDataType)
+			);
+		}
+		return false;
+	}
 public:
 	/** constructor*/
 	CSparkPlugDev(std::string a_sSubDev, std::string a_sSparkPluName,
@@ -123,10 +187,13 @@ public:
 	CSparkPlugDev(const CSparkPlugDev &a_refObj) :
 			m_sSubDev{ a_refObj.m_sSubDev }, m_sSparkPlugName{ a_refObj.m_sSparkPlugName },
 			m_bIsVendorApp{ a_refObj.m_bIsVendorApp }, m_mapMetrics{a_refObj.m_mapMetrics},
+			m_oMetricTable{a_refObj.m_oMetricTable},
 			m_enLastStatetPublishedToSCADA{enDEVSTATUS_NONE},
 			m_enLastKnownStateFromDev{enDEVSTATUS_NONE},
 			m_deathTimestamp {0}, 
-			m_rDirectDevRef{a_refObj.m_rDirectDevRef}, m_mutexMetricList{}
+			m_rDirectDevRef{a_refObj.m_rDirectDevRef}, m_mutexMetricList{},
+			m_mapAliases{a_refObj.m_mapAliases}, m_mapAliasNames{a_refObj.m_mapAliasNames},
+			m_mutexAliases{}
 	{
 	}
 
@@ -166,6 +233,17 @@ public:
 			if(NULL != a_sparkplugMetric.name)
 			{
 				std::string sName{a_sparkplugMetric.name};
+				// Metrics of a real device are in metric table
+				uint32_t uiIndex = m_oMetricTable.findIndex(sName);
+				if(REAL_DEV_METRIC_INVALID_INDEX != uiIndex)
+				{
+					flag = isDataTypeCompatible(m_oMetricTable.getDataType(uiIndex), a_sparkplugMetric.datatype);
+					if(false == flag)
+					{
+						DO_LOG_ERROR("Datatypes do not match for given metric: " + sName);
+					}
+					return flag;
+				}
 				auto itr = m_mapMetrics.find(sName);
 				if(m_mapMetrics.end() != itr)
 				{
@@ -175,44 +253,8 @@ public:
 						return false;
 					}
 					// metric name is found
-					// Check if datatypes match				
-					switch(((itr->second)->getValue()).getDataType())
-					{
-					case METRIC_DATA_TYPE_INT8:
-					case METRIC_DATA_TYPE_INT16:
-					case METRIC_DATA_TYPE_INT32:
-					case METRIC_DATA_TYPE_INT64:
-					case METRIC_DATA_TYPE_BOOLEAN:
-					case METRIC_DATA_TYPE_FLOAT:
-					case METRIC_DATA_TYPE_DOUBLE:
-					case METRIC_DATA_TYPE_STRING:					
-						if(((itr->second)->getValue()).getDataType() == a_sparkplugMetric.datatype)
-						{
-							flag = true;
-						}
-						break;
-
-					// Unsigned datatypes are sometimes just treated as integers
-					// Accordingly a datatype is received
-					case METRIC_DATA_TYPE_UINT8:
-					case METRIC_DATA_TYPE_UINT16:
-					case METRIC_DATA_TYPE_UINT32:
-					case METRIC_DATA_TYPE_UINT64:
-						if(
-							(METRIC_DATA_TYPE_UINT8 == a_sparkplugMetric.datatype) ||
-							(METRIC_DATA_TYPE_UINT16 == a_sparkplugMetric.datatype) ||
-							(METRIC_DATA_TYPE_INT8 == a_sparkplugMetric.datatype) ||
-							(METRIC_DATA_TYPE_INT16 == a_sparkplugMetric.datatype) ||
-							(METRIC_DATA_TYPE_INT32 == a_sparkplugMetric.datatype) ||
-							(METRIC_DATA_TYPE_UINT32 == a_sparkplugMetric.datatype) ||
-							(METRIC_DATA_TYPE_UINT64 == a_sparkplugMetric.datatype) ||
-							(METRIC_DATA_TYPE_INT64 == a_sparkplugMetric.datatype)
-						)
-						{
-							flag = true;
-						}
-						break;
-					}
+					// Check if datatypes match
+					flag = isDataTypeCompatible(((itr->second)->getValue()).getDataType(), a_sparkplugMetric.datatype);
 
 					/*
 					*  Check for template datatype. Here it calls getDataType() method of CUDT class for
@@ -294,6 +336,9 @@ public:
 	}
 	
 	bool prepareDBirthMessage(org_eclipse_tahu_protobuf_Payload& a_rTahuPayload, bool a_bIsNBIRTHProcess);
+	bool encodeDBirthMessage(std::string &a_sEncoded, bool a_bIsNBIRTHProcess);
+	uint64_t findAlias(const std::string &a_sName);
+	bool resolveAlias(uint64_t a_ui64Alias, std::string &a_sName);
 	bool processRealDeviceUpdateMsg(const std::string a_sPayLoad, std::vector<stRefForSparkPlugAction> &a_stRefActionVec);
 
 	void print()
@@ -309,6 +354,18 @@ public:
 	bool getCMDMsg(std::string& a_sTopic, metricMapIf_t& m_metrics, cJSON *metricArray);
 
 	bool prepareDdataMsg(org_eclipse_tahu_protobuf_Payload &a_payload, const metricMapIf_t &a_mapChangedMetrics);
+	bool prepareDdataMsg(org_eclipse_tahu_protobuf_Payload &a_payload, const std::vector<stRealDevMetricSample> &a_vecChangedSamples);
+
+	/** function to check if metric of real device at given index is a real-time point*/
+	bool isRealTimeMetric(uint32_t a_uiIndex) const
+	{
+		return m_oMetricTable.isRealTime(a_uiIndex);
+	}
+
+#ifdef UNIT_TEST
+	friend class SparkPlugDevices_ut;
+	friend class SparkPlugDevicesBenchmark_ut;
+#endif
 };
 
 
@@ -418,11 +475,13 @@ struct stRefForSparkPlugAction
 	std::reference_wrapper<CSparkPlugDev> m_refSparkPlugDev; /** wrapper for sparkplug device*/
 	eMsgAction m_enAction; /** Action to be taken*/
 	metricMapIf_t m_mapChangedMetrics; /** metrics to be used for taking action*/
+	std::vector<stRealDevMetricSample> m_vecChangedSamples; /** changed metrics of real device, by index in its metric table*/
 
 	stRefForSparkPlugAction(std::reference_wrapper<CSparkPlugDev> a_ref,
-			eMsgAction a_enAction, metricMapIf_t a_mapMetrics) :
+			eMsgAction a_enAction, metricMapIf_t a_mapMetrics,
+			std::vector<stRealDevMetricSample> a_vecSamples = {}) :
 			m_refSparkPlugDev{a_ref}, m_enAction{a_enAction}
-			, m_mapChangedMetrics{a_mapMetrics}
+			, m_mapChangedMetrics{a_mapMetrics}, m_vecChangedSamples{std::move(a_vecSamples)}
 	{
 	}
 
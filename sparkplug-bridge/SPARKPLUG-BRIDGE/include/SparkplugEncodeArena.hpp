@@ -0,0 +1,66 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/** SparkplugEncodeArena.hpp encodes Sparkplug payloads into buffers handed over to MQTT messages*/
+
+#ifndef SPARKPLUGENCODEARENA_HPP_
+#define SPARKPLUGENCODEARENA_HPP_
+
+#include <string>
+#include <tahu.pb.h>
+#include <pb_encode.h>
+
+/** size reserved for first payload encoded by a thread */
+#define SPARKPLUG_ENCODE_INITIAL_SIZE		1024
+
+/** Class to encode Sparkplug payloads of a thread in a single pass into strings sized by recent payloads*/
+class CSparkplugEncodeArena
+{
+	size_t m_uiHighWaterMark; /** size reserved for next payload*/
+	size_t m_uiInitialSize; /** high water mark does not decay below this size*/
+	uint64_t m_ui64GrowCount = 0; /** number of payloads larger than high water mark*/
+
+	/** delete copy and move constructors and assign operators*/
+	CSparkplugEncodeArena(const CSparkplugEncodeArena&) = delete;
+	CSparkplugEncodeArena& operator=(const CSparkplugEncodeArena&) = delete;
+
+public:
+	explicit CSparkplugEncodeArena(size_t a_uiInitialSize = SPARKPLUG_ENCODE_INITIAL_SIZE);
+
+	bool encode(const org_eclipse_tahu_protobuf_Payload &a_payload, std::string &a_sBuffer);
+
+	/** function to get size reserved for next payload*/
+	size_t getHighWaterMark() const
+	{
+		return m_uiHighWaterMark;
+	}
+
+	/** function to get number of payloads larger than high water mark*/
+	uint64_t getGrowCount() const
+	{
+		return m_ui64GrowCount;
+	}
+
+	static CSparkplugEncodeArena& getThreadArena();
+};
+
+#endif
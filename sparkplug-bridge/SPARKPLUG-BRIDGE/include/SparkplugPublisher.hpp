@@ -0,0 +1,126 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/** SparkplugPublisher.hpp is ordered publisher stage for messages to SCADA master*/
+
+#ifndef SPARKPLUGPUBLISHER_HPP_
+#define SPARKPLUGPUBLISHER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <mqtt/async_client.h>
+#include <tahu.pb.h>
+
+/** default number of messages which can wait for publishing */
+#define SPARKPLUG_PUBLISH_DEFAULT_QUEUE_SIZE	1000
+/** first wait before publishing a message again */
+#define SPARKPLUG_PUBLISH_RETRY_MIN_MS			10
+/** max wait before publishing a message again */
+#define SPARKPLUG_PUBLISH_RETRY_MAX_MS			1000
+
+/** Function handing a message to MQTT client; returns false if message is not taken */
+typedef std::function<bool(mqtt::message_ptr &a_pMsg)> sparkplug_publish_fn;
+
+/** Class to publish Sparkplug messages in order of their sequence numbers. Sequence number
+ * is assigned when message is queued; a separate thread hands messages to MQTT client,
+ * which keeps them in order up to its in-flight window. */
+class CSparkplugPublisher
+{
+	sparkplug_publish_fn m_fnPublish; /** function to hand message to MQTT client*/
+	size_t m_uiMaxQueued; /** producers are blocked when these many messages are queued*/
+	int m_iQOS; /** QOS of published messages*/
+
+	std::mutex m_mutexEnqueue; /** keeps sequence numbers in queue order*/
+	uint8_t m_uiSeq = 0; /** sequence number of last queued message*/
+
+	std::mutex m_mutexQueue; /** mutex for queue*/
+	std::condition_variable m_cvNotEmpty; /** signalled when a message is queued*/
+	std::condition_variable m_cvNotFull; /** signalled when a message leaves queue*/
+	std::deque<mqtt::message_ptr> m_qMsgs; /** messages waiting to be published*/
+	bool m_bIsSuspended = false; /** true from session loss till next NBIRTH*/
+	uint64_t m_ui64Session = 0; /** generation of session; incremented on session loss*/
+	std::mutex m_mutexHandOver; /** keeps reset() from running while a message is handed to client*/
+
+	std::atomic<bool> m_bStop{false}; /** stops publisher thread and releases producers*/
+	std::atomic<uint64_t> m_ui64Published{0}; /** messages handed to MQTT client*/
+	std::atomic<uint64_t> m_ui64Retries{0}; /** publish attempts to be retried*/
+	std::atomic<uint64_t> m_ui64Dropped{0}; /** messages dropped due to session loss*/
+
+	/** delete copy and move constructors and assign operators*/
+	CSparkplugPublisher(const CSparkplugPublisher&) = delete;
+	CSparkplugPublisher& operator=(const CSparkplugPublisher&) = delete;
+
+	bool waitForSpace(bool a_bIsNBirth, const std::string &a_sTopic);
+	bool pushMsg(const mqtt::message_ptr &a_pMsg, bool a_bIsNBirth, uint8_t a_uiSeq);
+
+public:
+	CSparkplugPublisher(const sparkplug_publish_fn &a_fnPublish, size_t a_uiMaxQueued, int a_iQOS);
+
+	bool enqueue(org_eclipse_tahu_protobuf_Payload &a_payload, const std::string &a_sTopic,
+			bool a_bIsNBirth, size_t *a_pEncodedLen = nullptr);
+	bool enqueueEncoded(std::string &a_sEncoded, const std::string &a_sTopic,
+			size_t *a_pEncodedLen = nullptr);
+	static bool appendTimestampAndSeq(std::string &a_sEncoded, uint64_t a_ui64Timestamp, uint64_t a_ui64Seq);
+	bool publishNext(uint32_t &a_uiRetryMs);
+	void run();
+	void reset();
+	void stop();
+	size_t getQueuedCount();
+
+	/** function to get sequence number of last queued message*/
+	uint8_t getLastSeq()
+	{
+		std::lock_guard<std::mutex> lck(m_mutexEnqueue);
+		return m_uiSeq;
+	}
+
+	/** function to get number of messages handed to MQTT client*/
+	uint64_t getPublishedCount() const
+	{
+		return m_ui64Published.load();
+	}
+
+	/** function to get number of publish attempts which were retried*/
+	uint64_t getRetryCount() const
+	{
+		return m_ui64Retries.load();
+	}
+
+	/** function to get generation of current session*/
+	uint64_t getSession()
+	{
+		std::lock_guard<std::mutex> lck(m_mutexQueue);
+		return m_ui64Session;
+	}
+
+	/** function to get number of messages dropped due to session loss*/
+	uint64_t getDroppedCount() const
+	{
+		return m_ui64Dropped.load();
+	}
+};
+
+#endif
@@ -21,6 +21,7 @@
 *********************************************************************************/
 
 #include "Common.hpp"
+#include "TimeFormatter.hpp"
 #include <iterator>
 #include <iostream>
 #include <fstream>
@@ -33,10 +34,16 @@
  */
 CCommon::CCommon() :
 m_strExtMqttURL{""}, m_nQos{1}, m_strNodeConfPath{""},
-m_strGroupId{""}, m_strNodeName{""}, m_bIsScadaTLS{true}
+m_strGroupId{""}, m_strNodeName{""}, m_bIsScadaTLS{true}, m_bIsMetricAliases{false}
 {
 	setScadaRTUIds();
 
+	const char *pcMetricAliases = std::getenv("SCADA_METRIC_ALIASES");
+	if(NULL != pcMetricAliases)
+	{
+		m_bIsMetricAliases = (std::string("true") == pcMetricAliases);
+	}
+
 	if(false == EnvironmentInfo::getInstance().readCommonEnvVariables(m_vecEnv))
 	{
 		DO_LOG_ERROR("Error while reading the common environment variables");
@@ -228,7 +235,7 @@ void CCommon::set_timestamp()
 {
 	struct timespec tsSPMsgReceived={0};;
 	timespec_get(&tsSPMsgReceived, TIME_UTC);	
-	TS_ExtMqttTOSp = std::to_string(CCommon::get_micros(tsSPMsgReceived)); 
+	TS_ExtMqttTOSp = CTimeFormatter::microsToString(tsSPMsgReceived);
 }
 /**
  * To get the time stamp of the msg received from external MQTT 
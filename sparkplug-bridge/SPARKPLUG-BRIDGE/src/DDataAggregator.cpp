@@ -0,0 +1,309 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include "DDataAggregator.hpp"
+
+/**
+ * Constructor
+ * @param a_uiWindowMs :[in] time for which changed metrics of a device are merged; 0 disables merging
+ * @param a_uiMaxMetrics :[in] number of pending metrics of a device after which window is closed
+ * @param a_bRTBypass :[in] true to publish updates of real-time metrics without waiting
+ * @return None
+ */
+CDDataAggregator::CDDataAggregator(uint32_t a_uiWindowMs, uint32_t a_uiMaxMetrics, bool a_bRTBypass)
+	: m_uiWindowMs{a_uiWindowMs}, m_uiMaxMetrics{a_uiMaxMetrics}, m_bRTBypass{a_bRTBypass}
+{
+	if(0 == m_uiMaxMetrics)
+	{
+		m_uiMaxMetrics = 1;
+	}
+	m_ui64StatsStartMs.store(getMonotonicMs());
+}
+
+/**
+ * Gets current time of a monotonic clock in msec
+ * @return current time in msec
+ */
+uint64_t CDDataAggregator::getMonotonicMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Checks if any of given metrics is a real-time point
+ * @param a_mapMetrics :[in] metrics to check
+ * @return true if at least one metric is real-time, false otherwise
+ */
+bool CDDataAggregator::hasRealTimeMetric(const metricMapIf_t &a_mapMetrics)
+{
+	for(auto &itr : a_mapMetrics)
+	{
+		if((nullptr != itr.second) && (true == itr.second->isRealTime()))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Checks if any of given metrics of a real device is a real-time point
+ * @param a_oDev :[in] device to which metrics belong
+ * @param a_vecSamples :[in] metrics to check, by index in metric table of device
+ * @return true if at least one metric is real-time, false otherwise
+ */
+bool CDDataAggregator::hasRealTimeMetric(const CSparkPlugDev &a_oDev, const std::vector<stRealDevMetricSample> &a_vecSamples)
+{
+	for(auto &stSample : a_vecSamples)
+	{
+		if(true == a_oDev.isRealTimeMetric(stSample.m_uiIndex))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Moves pending DDATA of a device to the list of DDATA ready to be published
+ * and removes the device from pending map
+ * @param a_itr :[in] iterator of device in pending map
+ * @param a_vecReady :[out] list of DDATA ready to be published
+ * @return None
+ */
+void CDDataAggregator::moveToReady(std::map<std::string, stPendingDData>::iterator a_itr,
+		std::vector<stRefForSparkPlugAction> &a_vecReady)
+{
+	a_vecReady.emplace_back(a_itr->second.m_refSparkPlugDev, enMSG_DATA, std::move(a_itr->second.m_mapMetrics),
+			std::move(a_itr->second.m_vecSamples));
+	m_mapPending.erase(a_itr);
+}
+
+/**
+ * Adds changed metrics of a DDATA action to the window of its device. A later value of a metric
+ * replaces the pending one. Modbus metrics are copied since device keeps updating its own metric
+ * objects; the copy keeps value and timestamp of this update. Metrics of real devices already
+ * carry value and timestamp of the update and are merged by their index in metric table.
+ * @param a_stRefAction :[in] DDATA action
+ * @param a_ui64NowMs :[in] current monotonic time in msec
+ * @param a_vecReady :[out] DDATA which are to be published now: the action itself if it is not
+ * aggregated, or the merged DDATA of the device if size bound is reached
+ * @return true if action was taken into window, false if it is to be published as is
+ */
+bool CDDataAggregator::add(const stRefForSparkPlugAction &a_stRefAction, uint64_t a_ui64NowMs,
+		std::vector<stRefForSparkPlugAction> &a_vecReady)
+{
+	if(enMSG_DATA != a_stRefAction.m_enAction)
+	{
+		return false;
+	}
+	std::string sDevName{a_stRefAction.m_refSparkPlugDev.get().getSparkPlugName()};
+
+	std::lock_guard<std::mutex> lck(m_mutexPending);
+	auto itr = m_mapPending.find(sDevName);
+	if((false == isEnabled()) || ((true == m_bRTBypass) &&
+			((true == hasRealTimeMetric(a_stRefAction.m_mapChangedMetrics)) ||
+			(true == hasRealTimeMetric(a_stRefAction.m_refSparkPlugDev.get(), a_stRefAction.m_vecChangedSamples)))))
+	{
+		// Values in this action are newer than pending ones, if any
+		if(m_mapPending.end() != itr)
+		{
+			for(auto &itrMetric : a_stRefAction.m_mapChangedMetrics)
+			{
+				itr->second.m_mapMetrics.erase(itrMetric.first);
+			}
+			auto &vecPending = itr->second.m_vecSamples;
+			for(auto &stSample : a_stRefAction.m_vecChangedSamples)
+			{
+				vecPending.erase(std::remove_if(vecPending.begin(), vecPending.end(),
+					[&stSample](const stRealDevMetricSample &a_stPending) { return a_stPending.m_uiIndex == stSample.m_uiIndex; }),
+					vecPending.end());
+			}
+			if((true == itr->second.m_mapMetrics.empty()) && (true == vecPending.empty()))
+			{
+				m_mapPending.erase(itr);
+			}
+		}
+		a_vecReady.push_back(a_stRefAction);
+		return false;
+	}
+
+	if(m_mapPending.end() == itr)
+	{
+		itr = m_mapPending.emplace(sDevName,
+				stPendingDData{a_stRefAction.m_refSparkPlugDev, metricMapIf_t{}, {}, a_ui64NowMs}).first;
+	}
+	for(auto &itrMetric : a_stRefAction.m_mapChangedMetrics)
+	{
+		std::shared_ptr<CIfMetric> pMetric = itrMetric.second;
+		CMetric *pModbusMetric = dynamic_cast<CMetric*>(itrMetric.second.get());
+		if(nullptr != pModbusMetric)
+		{
+			pMetric = std::make_shared<CMetric>(*pModbusMetric);
+		}
+		itr->second.m_mapMetrics[itrMetric.first] = pMetric;
+	}
+	auto &vecPending = itr->second.m_vecSamples;
+	for(auto &stSample : a_stRefAction.m_vecChangedSamples)
+	{
+		auto itrSample = std::find_if(vecPending.begin(), vecPending.end(),
+			[&stSample](const stRealDevMetricSample &a_stPending) { return a_stPending.m_uiIndex == stSample.m_uiIndex; });
+		if(vecPending.end() == itrSample)
+		{
+			vecPending.push_back(stSample);
+		}
+		else
+		{
+			*itrSample = stSample;
+		}
+	}
+
+	if(itr->second.m_mapMetrics.size() + vecPending.size() >= m_uiMaxMetrics)
+	{
+		moveToReady(itr, a_vecReady);
+	}
+	return true;
+}
+
+/**
+ * Takes DDATA of devices whose window has elapsed
+ * @param a_ui64NowMs :[in] current monotonic time in msec
+ * @param a_vecReady :[out] list of DDATA ready to be published
+ * @return None
+ */
+void CDDataAggregator::takeExpired(uint64_t a_ui64NowMs, std::vector<stRefForSparkPlugAction> &a_vecReady)
+{
+	std::lock_guard<std::mutex> lck(m_mutexPending);
+	for(auto itr = m_mapPending.begin(); itr != m_mapPending.end(); )
+	{
+		auto itrCur = itr++;
+		if(a_ui64NowMs >= itrCur->second.m_ui64WindowStartMs + m_uiWindowMs)
+		{
+			moveToReady(itrCur, a_vecReady);
+		}
+	}
+}
+
+/**
+ * Takes pending DDATA of a device irrespective of its window, e.g. before DBIRTH or DDEATH
+ * of the device is published
+ * @param a_sDevName :[in] sparkplug name of device
+ * @param a_vecReady :[out] list of DDATA ready to be published
+ * @return true if device had pending DDATA, false otherwise
+ */
+bool CDDataAggregator::take(const std::string &a_sDevName, std::vector<stRefForSparkPlugAction> &a_vecReady)
+{
+	std::lock_guard<std::mutex> lck(m_mutexPending);
+	auto itr = m_mapPending.find(a_sDevName);
+	if(m_mapPending.end() == itr)
+	{
+		return false;
+	}
+	moveToReady(itr, a_vecReady);
+	return true;
+}
+
+/**
+ * Takes pending DDATA of all devices
+ * @param a_vecReady :[out] list of DDATA ready to be published
+ * @return None
+ */
+void CDDataAggregator::takeAll(std::vector<stRefForSparkPlugAction> &a_vecReady)
+{
+	std::lock_guard<std::mutex> lck(m_mutexPending);
+	while(false == m_mapPending.empty())
+	{
+		moveToReady(m_mapPending.begin(), a_vecReady);
+	}
+}
+
+/**
+ * Discards pending DDATA of all devices. Used when SCADA session is lost; DBIRTH
+ * sent on reconnection carries latest values.
+ * @return number of metrics discarded
+ */
+size_t CDDataAggregator::discardAll()
+{
+	std::lock_guard<std::mutex> lck(m_mutexPending);
+	size_t uiCount = 0;
+	for(auto &itr : m_mapPending)
+	{
+		uiCount += itr.second.m_mapMetrics.size() + itr.second.m_vecSamples.size();
+	}
+	m_mapPending.clear();
+	return uiCount;
+}
+
+/**
+ * Gets number of metrics waiting in windows of all devices
+ * @return number of pending metrics
+ */
+size_t CDDataAggregator::getPendingMetricCount()
+{
+	std::lock_guard<std::mutex> lck(m_mutexPending);
+	size_t uiCount = 0;
+	for(auto &itr : m_mapPending)
+	{
+		uiCount += itr.second.m_mapMetrics.size() + itr.second.m_vecSamples.size();
+	}
+	return uiCount;
+}
+
+/**
+ * Records a published DDATA packet for statistics
+ * @param a_uiMetrics :[in] number of metrics in packet
+ * @param a_uiBytes :[in] encoded size of packet
+ * @return None
+ */
+void CDDataAggregator::recordPacket(size_t a_uiMetrics, size_t a_uiBytes)
+{
+	m_ui64Packets.fetch_add(1);
+	m_ui64Metrics.fetch_add(a_uiMetrics);
+	m_ui64Bytes.fetch_add(a_uiBytes);
+}
+
+/**
+ * Gets DDATA statistics of interval since last call and starts a new interval
+ * @param a_ui64NowMs :[in] current monotonic time in msec
+ * @param a_dPacketsPerSec :[out] DDATA packets published per second
+ * @param a_dBytesPerMetric :[out] encoded bytes per published metric
+ * @return true if statistics are available, false if interval is empty
+ */
+bool CDDataAggregator::getStats(uint64_t a_ui64NowMs, double &a_dPacketsPerSec, double &a_dBytesPerMetric)
+{
+	uint64_t ui64StartMs = m_ui64StatsStartMs.exchange(a_ui64NowMs);
+	uint64_t ui64Packets = m_ui64Packets.exchange(0);
+	uint64_t ui64Metrics = m_ui64Metrics.exchange(0);
+	uint64_t ui64Bytes = m_ui64Bytes.exchange(0);
+	if((a_ui64NowMs <= ui64StartMs) || (0 == ui64Metrics))
+	{
+		a_dPacketsPerSec = 0;
+		a_dBytesPerMetric = 0;
+		return false;
+	}
+	a_dPacketsPerSec = (ui64Packets * 1000.0) / (a_ui64NowMs - ui64StartMs);
+	a_dBytesPerMetric = (double)ui64Bytes / ui64Metrics;
+	return true;
+}
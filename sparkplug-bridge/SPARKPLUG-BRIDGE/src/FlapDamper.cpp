@@ -0,0 +1,115 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <algorithm>
+#include "FlapDamper.hpp"
+
+/**
+ * Constructor
+ * @param a_uiHoldDownMs :[in] hold-down after first flap; 0 announces each up at once
+ * @param a_uiMaxHoldDownMs :[in] max hold-down
+ * @param a_uiStableMs :[in] link which stays up this long is not flapping
+ * @return None
+ */
+CFlapDamper::CFlapDamper(uint32_t a_uiHoldDownMs, uint32_t a_uiMaxHoldDownMs, uint32_t a_uiStableMs)
+	: m_uiHoldDownMs{a_uiHoldDownMs}, m_uiMaxHoldDownMs{std::max(a_uiHoldDownMs, a_uiMaxHoldDownMs)},
+	  m_uiStableMs{a_uiStableMs}
+{
+}
+
+/**
+ * Records that link is up. Announcement is due after current hold-down.
+ * Up of a link which is already up is ignored.
+ * @param a_ui64NowMs :[in] current time in msec
+ * @return None
+ */
+void CFlapDamper::linkUp(uint64_t a_ui64NowMs)
+{
+	if(enFLAP_DOWN != m_enState)
+	{
+		return;
+	}
+	m_ui64UpAtMs = a_ui64NowMs;
+	m_ui64AnnounceAtMs = a_ui64NowMs + m_uiCurHoldDownMs;
+	m_enState = enFLAP_HOLD;
+}
+
+/**
+ * Records that link is down. If link did not stay up for stable period, hold-down
+ * of next up is doubled; otherwise next up is announced at once.
+ * Down of a link which is already down is ignored.
+ * @param a_ui64NowMs :[in] current time in msec
+ * @return None
+ */
+void CFlapDamper::linkDown(uint64_t a_ui64NowMs)
+{
+	if(enFLAP_DOWN == m_enState)
+	{
+		return;
+	}
+	if(enFLAP_HOLD == m_enState)
+	{
+		++m_ui64Suppressed;
+	}
+	if((a_ui64NowMs - m_ui64UpAtMs) < m_uiStableMs)
+	{
+		m_uiCurHoldDownMs = (0 == m_uiCurHoldDownMs) ? m_uiHoldDownMs :
+				(uint32_t)std::min<uint64_t>((uint64_t)m_uiCurHoldDownMs * 2, m_uiMaxHoldDownMs);
+	}
+	else
+	{
+		m_uiCurHoldDownMs = 0;
+	}
+	m_enState = enFLAP_DOWN;
+}
+
+/**
+ * Checks whether held back announcement is due. If it is, link is marked as announced
+ * and caller is to announce it.
+ * @param a_ui64NowMs :[in] current time in msec
+ * @return true if link is to be announced now, false otherwise
+ */
+bool CFlapDamper::takeAnnouncement(uint64_t a_ui64NowMs)
+{
+	if((enFLAP_HOLD != m_enState) || (a_ui64NowMs < m_ui64AnnounceAtMs))
+	{
+		return false;
+	}
+	m_enState = enFLAP_ANNOUNCED;
+	return true;
+}
+
+/**
+ * Requests that a link which is announced is announced again, e.g. when its peer asks
+ * for it. Announcement is due at once. Link which is down or held back is not affected.
+ * @param a_ui64NowMs :[in] current time in msec
+ * @return None
+ */
+void CFlapDamper::reannounce(uint64_t a_ui64NowMs)
+{
+	if(enFLAP_ANNOUNCED != m_enState)
+	{
+		return;
+	}
+	m_ui64AnnounceAtMs = a_ui64NowMs;
+	m_enState = enFLAP_HOLD;
+}
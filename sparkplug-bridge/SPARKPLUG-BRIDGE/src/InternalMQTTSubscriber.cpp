@@ -44,7 +44,7 @@ std::atomic<bool> *loop;
 CIntMqttHandler::CIntMqttHandler(const std::string &strPlBusUrl, int iQOS):
 	CMQTTBaseHandler(strPlBusUrl, SUBSCRIBER_ID, iQOS, (false == CcommonEnvManager::Instance().getDevMode()),
 	"/run/secrets/rootca/cacert.pem", "/run/secrets/mymqttcerts/mymqttcerts_client_certificate.pem",
-	"/run/secrets/mymqttcerts/mymqttcerts_client_key.pem", "InternalMQTTListener"),
+	"/run/secrets/mymqttcerts/mymqttcerts_client_key.pem", "InternalMQTTListener", CMQTTPubSubClient::readV5Config()),
 	m_enLastConStatus{enCON_NONE}, m_bIsInTimeoutState{false}
 {
 	try
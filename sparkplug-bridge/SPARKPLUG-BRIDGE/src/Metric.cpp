@@ -25,6 +25,18 @@
 #include "SCADAHandler.hpp"
 #include "SparkPlugUDTMgr.hpp"
 
+/**
+ * Assigns datatype and value of other value object
+ * @param a_obj :[in] value object to copy
+ * @return reference of this value object
+ */
+CValObj& CValObj::operator=(const CValObj &a_obj)
+{
+	m_uiDataType = a_obj.m_uiDataType;
+	m_objVal = a_obj.m_objVal;
+	return *this;
+}
+
 /**
  * Assign values to sparkplug metric data-structure according to the sparkplug specification
  * @param a_metric :[out] metric in which to assign value in sparkplug format
@@ -581,7 +593,8 @@ bool CValObj::setValObj(org_eclipse_tahu_protobuf_Payload_Metric& a_metric)
 }
 
 /**
- * Add name value to a metric to be published on SCADA system
+ * Add name value to a metric to be published on SCADA system. If an alias is assigned to
+ * the metric in birth message, only alias is added instead of name.
  * @param a_rMetric :[out] reference of sparkplug object in which to store data
  * @return true/false depending on the success/failure
  */
@@ -589,17 +602,22 @@ bool CMetric::addMetricNameValue(org_eclipse_tahu_protobuf_Payload_Metric& a_rMe
 {
 	try
 	{
+		if(0 != m_ui64Alias)
+		{
+			a_rMetric.has_alias = true;
+			a_rMetric.alias = m_ui64Alias;
+		}
+		else
 		{
 			a_rMetric.name = strndup(m_sSparkPlugName.c_str(), m_sSparkPlugName.length());
 			if(a_rMetric.name == NULL)
 			{
 				DO_LOG_ERROR("Failed to allocate new memory");
 				return false;
-			};
-
-			m_objVal.assignToSparkPlug(a_rMetric);
-			a_rMetric.is_null = false;
+			}
 		}
+		m_objVal.assignToSparkPlug(a_rMetric);
+		a_rMetric.is_null = false;
 	}
 	catch(std::exception &ex)
 	{
@@ -676,6 +694,21 @@ bool CMetric::addMetricForBirth(org_eclipse_tahu_protobuf_Payload_Metric& a_rMet
 					return false;
 				}
 			}
+			// Birth message maps alias to name, later messages carry only alias
+			if(0 != m_ui64Alias)
+			{
+				if(a_rMetric.name == NULL)
+				{
+					a_rMetric.name = strndup(m_sSparkPlugName.c_str(), m_sSparkPlugName.length());
+					if(a_rMetric.name == NULL)
+					{
+						DO_LOG_ERROR("Failed to allocate new memory");
+						return false;
+					}
+				}
+				a_rMetric.has_alias = true;
+				a_rMetric.alias = m_ui64Alias;
+			}
 		}
 	}
 	catch(std::exception &ex)
@@ -714,6 +747,20 @@ bool CMetric::addModbusMetric(org_eclipse_tahu_protobuf_Payload_Metric& a_rMetri
 	return true;
 }
 
+/**
+ * Tells whether this metric is polled as a real-time point of a Modbus device
+ * @return true if metric is a real-time Modbus point, false otherwise
+ */
+bool CMetric::isRealTime() const
+{
+	if (true == std::holds_alternative<std::reference_wrapper<const network_info::CUniqueDataPoint>>(m_rDirectProp))
+	{
+		auto &orUniqueDataPoint = std::get<std::reference_wrapper<const network_info::CUniqueDataPoint>>(m_rDirectProp);
+		return orUniqueDataPoint.get().getDataPoint().getPollingConfig().m_bIsRealTime;
+	}
+	return false;
+}
+
 /**
  * Processes metric to parse its data-type and value; sets in CValueObj corresponding to the metric
  * @param a_cjArrayElemMetric :[in] cJSON array element containing details about the metric
@@ -1192,7 +1239,7 @@ bool CUDT::addMetricForBirth(org_eclipse_tahu_protobuf_Payload_Metric& a_rMetric
 
 		// Create the root UDT definition and add the UDT definition value which includes the UDT members and parameters
 		a_rMetric = org_eclipse_tahu_protobuf_Payload_Metric_init_default;
-		init_metric(&a_rMetric, getSparkPlugName().c_str(), false, 0, METRIC_DATA_TYPE_TEMPLATE, false, false, &udt_template, sizeof(udt_template));
+		init_metric(&a_rMetric, getSparkPlugName().c_str(), (0 != m_ui64Alias), m_ui64Alias, METRIC_DATA_TYPE_TEMPLATE, false, false, &udt_template, sizeof(udt_template));
 		a_rMetric.timestamp = get_current_timestamp();
 		a_rMetric.has_timestamp = true;
 	}
@@ -1352,7 +1399,9 @@ bool CUDT::addMetricNameValue(org_eclipse_tahu_protobuf_Payload_Metric& a_rMetri
 
 		// Create the root UDT definition and add the UDT definition value which includes the UDT members and parameters
 		a_rMetric = org_eclipse_tahu_protobuf_Payload_Metric_init_default;
-		init_metric(&a_rMetric, getSparkPlugName().c_str(), false, 0, METRIC_DATA_TYPE_TEMPLATE, false, false, &udt_template, sizeof(udt_template));
+		// Metric with an alias assigned in birth message is sent only with alias
+		init_metric(&a_rMetric, (0 != m_ui64Alias) ? NULL : getSparkPlugName().c_str(), (0 != m_ui64Alias), m_ui64Alias,
+				METRIC_DATA_TYPE_TEMPLATE, false, false, &udt_template, sizeof(udt_template));
 		a_rMetric.timestamp = get_current_timestamp();
 		a_rMetric.has_timestamp = true;
 	}
@@ -0,0 +1,284 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <cstring>
+#include "RealDevMetricTable.hpp"
+#include "SCADAHandler.hpp"
+
+/**
+ * Converts value to its 64 bit representation stored in table. Signed values are
+ * sign extended; float and double values are copied bitwise.
+ * @param a_oValue :[in] value to convert
+ * @param a_ui64Bits :[out] 64 bit representation of value
+ * @return true if value is numeric or boolean, false otherwise
+ */
+bool CRealDevMetricTable::toBits(const CValObj &a_oValue, uint64_t &a_ui64Bits)
+{
+	bool bRet = true;
+	a_ui64Bits = 0;
+	std::visit([&](auto &&arg)
+	{
+		using T = std::decay_t<decltype(arg)>;
+		if constexpr (std::is_same_v<T, float>)
+		{
+			uint32_t uiBits = 0;
+			std::memcpy(&uiBits, &arg, sizeof(uiBits));
+			a_ui64Bits = uiBits;
+		}
+		else if constexpr (std::is_same_v<T, double>)
+		{
+			std::memcpy(&a_ui64Bits, &arg, sizeof(a_ui64Bits));
+		}
+		else if constexpr (std::is_integral_v<T>)
+		{
+			if constexpr (std::is_signed_v<T>)
+			{
+				a_ui64Bits = static_cast<uint64_t>(static_cast<int64_t>(arg));
+			}
+			else
+			{
+				a_ui64Bits = static_cast<uint64_t>(arg);
+			}
+		}
+		else
+		{
+			bRet = false;
+		}
+	}, a_oValue.getValue());
+	return bRet;
+}
+
+/**
+ * Converts 64 bit representation stored in table to value of given datatype
+ * @param a_uiDataType :[in] sparkplug datatype of value
+ * @param a_ui64Bits :[in] 64 bit representation of value
+ * @return value; value with monostate for a datatype which is not numeric or boolean
+ */
+CValObj CRealDevMetricTable::fromBits(uint32_t a_uiDataType, uint64_t a_ui64Bits)
+{
+	switch(a_uiDataType)
+	{
+		case METRIC_DATA_TYPE_BOOLEAN:
+			return CValObj(a_uiDataType, (0 != a_ui64Bits));
+		case METRIC_DATA_TYPE_UINT8:
+			return CValObj(a_uiDataType, (uint8_t)a_ui64Bits);
+		case METRIC_DATA_TYPE_UINT16:
+			return CValObj(a_uiDataType, (uint16_t)a_ui64Bits);
+		case METRIC_DATA_TYPE_UINT32:
+			return CValObj(a_uiDataType, (uint32_t)a_ui64Bits);
+		case METRIC_DATA_TYPE_UINT64:
+			return CValObj(a_uiDataType, (uint64_t)a_ui64Bits);
+		case METRIC_DATA_TYPE_INT8:
+			return CValObj(a_uiDataType, (int8_t)a_ui64Bits);
+		case METRIC_DATA_TYPE_INT16:
+			return CValObj(a_uiDataType, (int16_t)a_ui64Bits);
+		case METRIC_DATA_TYPE_INT32:
+			return CValObj(a_uiDataType, (int32_t)a_ui64Bits);
+		case METRIC_DATA_TYPE_INT64:
+			return CValObj(a_uiDataType, (int64_t)a_ui64Bits);
+		case METRIC_DATA_TYPE_FLOAT:
+		{
+			float fValue = 0;
+			uint32_t uiBits = (uint32_t)a_ui64Bits;
+			std::memcpy(&fValue, &uiBits, sizeof(fValue));
+			return CValObj(a_uiDataType, fValue);
+		}
+		case METRIC_DATA_TYPE_DOUBLE:
+		{
+			double dValue = 0;
+			std::memcpy(&dValue, &a_ui64Bits, sizeof(dValue));
+			return CValObj(a_uiDataType, dValue);
+		}
+		default:
+			break;
+	}
+	return CValObj(a_uiDataType, var_t{});
+}
+
+/**
+ * Adds a metric to table
+ * @param a_sName :[in] sparkplug name of metric
+ * @param a_oValue :[in] initial value; its datatype is datatype of metric
+ * @param a_pPoint :[in] data point of metric; may be NULL
+ * @return index of metric; REAL_DEV_METRIC_INVALID_INDEX if metric is already present
+ */
+uint32_t CRealDevMetricTable::add(const std::string &a_sName, const CValObj &a_oValue,
+		const network_info::CUniqueDataPoint *a_pPoint)
+{
+	if(m_mapIndex.end() != m_mapIndex.find(a_sName))
+	{
+		return REAL_DEV_METRIC_INVALID_INDEX;
+	}
+	uint32_t uiIndex = (uint32_t)m_vecNames.size();
+	uint64_t ui64Bits = 0;
+	if(METRIC_DATA_TYPE_STRING == a_oValue.getDataType())
+	{
+		const var_t &objVal = a_oValue.getValue();
+		ui64Bits = m_vecStrings.size();
+		m_vecStrings.push_back(std::holds_alternative<std::string>(objVal) ? std::get<std::string>(objVal) : "");
+	}
+	else
+	{
+		toBits(a_oValue, ui64Bits);
+	}
+	m_vecNames.push_back(a_sName);
+	m_vecDataTypes.push_back(a_oValue.getDataType());
+	m_vecValues.push_back(ui64Bits);
+	m_vecTimestamps.push_back(get_current_timestamp());
+	m_vecPoints.push_back(a_pPoint);
+	m_mapIndex.emplace(a_sName, uiIndex);
+	++m_ui64Version;
+	return uiIndex;
+}
+
+/**
+ * Finds index of a metric
+ * @param a_sName :[in] sparkplug name of metric
+ * @return index of metric; REAL_DEV_METRIC_INVALID_INDEX if metric is not present
+ */
+uint32_t CRealDevMetricTable::findIndex(const std::string &a_sName) const
+{
+	auto itr = m_mapIndex.find(a_sName);
+	if(m_mapIndex.end() == itr)
+	{
+		return REAL_DEV_METRIC_INVALID_INDEX;
+	}
+	return itr->second;
+}
+
+/**
+ * Gets current value of a metric
+ * @param a_uiIndex :[in] index of metric
+ * @return value of metric
+ */
+CValObj CRealDevMetricTable::getValue(uint32_t a_uiIndex) const
+{
+	uint32_t uiDataType = m_vecDataTypes.at(a_uiIndex);
+	if(METRIC_DATA_TYPE_STRING == uiDataType)
+	{
+		return CValObj(uiDataType, m_vecStrings.at(m_vecValues[a_uiIndex]));
+	}
+	return fromBits(uiDataType, m_vecValues[a_uiIndex]);
+}
+
+/**
+ * Compares current value of a metric with given value
+ * @param a_uiIndex :[in] index of metric
+ * @param a_oValue :[in] value to compare
+ * @return SAMEVALUE_OR_DTATYPE, DATATYPE_DIFFERENT or VALUES_DIFFERENT as per CValObj::compareValue()
+ */
+uint8_t CRealDevMetricTable::compareValue(uint32_t a_uiIndex, const CValObj &a_oValue) const
+{
+	return getValue(a_uiIndex).compareValue(a_oValue);
+}
+
+/**
+ * Sets value of a metric. Value is set only if its datatype is that of metric.
+ * Version of table changes only if value is different from current value.
+ * @param a_uiIndex :[in] index of metric
+ * @param a_oValue :[in] new value
+ * @return true if value is set, false otherwise
+ */
+bool CRealDevMetricTable::setValue(uint32_t a_uiIndex, const CValObj &a_oValue)
+{
+	if((a_uiIndex >= m_vecDataTypes.size()) || (a_oValue.getDataType() != m_vecDataTypes[a_uiIndex]))
+	{
+		return false;
+	}
+	const var_t &objVal = a_oValue.getValue();
+	if(METRIC_DATA_TYPE_STRING == m_vecDataTypes[a_uiIndex])
+	{
+		if(false == std::holds_alternative<std::string>(objVal))
+		{
+			return false;
+		}
+		std::string &sValue = m_vecStrings[m_vecValues[a_uiIndex]];
+		if(sValue != std::get<std::string>(objVal))
+		{
+			sValue = std::get<std::string>(objVal);
+			++m_ui64Version;
+		}
+		return true;
+	}
+	uint64_t ui64Bits = 0;
+	if(false == toBits(a_oValue, ui64Bits))
+	{
+		return false;
+	}
+	if(ui64Bits != m_vecValues[a_uiIndex])
+	{
+		m_vecValues[a_uiIndex] = ui64Bits;
+		++m_ui64Version;
+	}
+	return true;
+}
+
+/**
+ * Tells whether a metric is polled as a real-time point
+ * @param a_uiIndex :[in] index of metric
+ * @return true if metric is a real-time point, false otherwise
+ */
+bool CRealDevMetricTable::isRealTime(uint32_t a_uiIndex) const
+{
+	if((a_uiIndex >= m_vecPoints.size()) || (NULL == m_vecPoints[a_uiIndex]))
+	{
+		return false;
+	}
+	return m_vecPoints[a_uiIndex]->getDataPoint().getPollingConfig().m_bIsRealTime;
+}
+
+/**
+ * Prepare sparkplug formatted metric for a metric of table
+ * @param a_uiIndex :[in] index of metric
+ * @param a_oValue :[in] value to publish, i.e. current value or value of a DDATA sample
+ * @param a_rMetric :[out] reference of sparkplug metric to store data
+ * @param a_bIsBirth :[in] indicates whether it is a birth message
+ * @return true/false depending on the success/failure
+ */
+bool CRealDevMetricTable::addModbusMetric(uint32_t a_uiIndex, const CValObj &a_oValue,
+		org_eclipse_tahu_protobuf_Payload_Metric &a_rMetric, bool a_bIsBirth) const
+{
+	try
+	{
+		if(a_uiIndex >= m_vecNames.size())
+		{
+			DO_LOG_ERROR("Invalid metric index: " + std::to_string(a_uiIndex));
+			return false;
+		}
+		const network_info::CUniqueDataPoint *pPoint = m_vecPoints[a_uiIndex];
+		if(NULL == pPoint)
+		{
+			DO_LOG_ERROR(m_vecNames[a_uiIndex] + ": Data point is not available");
+			return false;
+		}
+		CValObj oValue{a_oValue};
+		return CSCADAHandler::instance().addModbusMetric(a_rMetric, m_vecNames[a_uiIndex], oValue,
+				a_bIsBirth, pPoint->getDataPoint().getPollingConfig().m_uiPollFreq,
+				pPoint->getDataPoint().getPollingConfig().m_bIsRealTime,
+				pPoint->getDataPoint().getAddress().m_dScaleFactor);
+	}
+	catch(std::exception &ex)
+	{
+		DO_LOG_FATAL(ex.what());
+		return false;
+	}
+}
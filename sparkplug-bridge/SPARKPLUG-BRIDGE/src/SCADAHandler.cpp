@@ -21,17 +21,32 @@
 *********************************************************************************/
 
 #include <thread>
+#include <algorithm>
 #include "SCADAHandler.hpp"
 #include "InternalMQTTSubscriber.hpp"
 #include "SparkPlugUDTMgr.hpp"
 #include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <thread>
 #include "ZmqHandler.hpp"
 extern std::atomic<bool> g_shouldStop;
-std::string real_time;
-std::string device_name;
+// Device births are prepared by several threads, so name of device being prepared is per thread
+thread_local std::string real_time;
+thread_local std::string device_name;
 std::map<std::string,std::string> RT_NRT;
 // Declarations used for MQTT
 #define SCADASUBSCRIBERID								"SCADA_SUBSCRIBER_"
+// Default bound on metrics merged in a DDATA window
+#define DDATA_WINDOW_DEFAULT_MAX_METRICS				500
+// Default hold-down of births after first flap of SCADA connection
+#define SCADA_REBIRTH_DEFAULT_HOLDDOWN_MS				2000
+// Default max hold-down of births of a flapping SCADA connection
+#define SCADA_REBIRTH_DEFAULT_MAX_HOLDDOWN_MS			60000
+// Default time for which SCADA connection is to stay up to be stable
+#define SCADA_LINK_DEFAULT_STABLE_MS					30000
+// Max wait of SCADA connection thread before checking for stop
+#define SCADA_LINK_POLL_MS								1000
 
 /**
  * constructor Initializes MQTT m_subscriber
@@ -48,6 +63,12 @@ CSCADAHandler::CSCADAHandler(const std::string &strMqttURL, int iQOS) :
 {
 	try
 	{
+		initPublishWindow();
+
+		initDDataWindow();
+
+		initFlapDamping();
+
 		prepareNodeDeathMsg(false);
 
 		init();
@@ -60,6 +81,96 @@ CSCADAHandler::CSCADAHandler(const std::string &strMqttURL, int iQOS) :
 	}
 }
 
+/**
+ * Sets number of messages which can be in flight to SCADA master. It is read from
+ * environment variable SCADA_MAX_INFLIGHT. Value 1 publishes each message only after
+ * previous one is completed. Number of messages which can wait to be published is read
+ * from SCADA_PUBLISH_QUEUE_SIZE; producers are blocked once it is reached.
+ * @param None
+ * @return None
+ */
+void CSCADAHandler::initPublishWindow()
+{
+	m_iMaxInflight = (int)EnvironmentInfo::getEnvNum("SCADA_MAX_INFLIGHT", m_iMaxInflight, 1, INT_MAX);
+	m_MQTTClient.setMaxInflight(m_iMaxInflight);
+	DO_LOG_INFO("Max messages in flight to SCADA master: " + std::to_string(m_iMaxInflight));
+
+	size_t uiMaxQueued = (size_t)EnvironmentInfo::getEnvNum("SCADA_PUBLISH_QUEUE_SIZE",
+			SPARKPLUG_PUBLISH_DEFAULT_QUEUE_SIZE, 1);
+	m_pPublisher.reset(new CSparkplugPublisher([this](mqtt::message_ptr &a_pMsg)
+	{
+		// window of 1 waits for completion of previous message before handing this one
+		return m_MQTTClient.publishMsgPipelined(a_pMsg, [this](mqtt::const_message_ptr a_pDoneMsg, bool a_bIsSuccess)
+		{
+			if(true == a_bIsSuccess)
+			{
+				return;
+			}
+			DO_LOG_ERROR_RATELIMITED("SCADA publish failed", 10, 1000,
+					"Message could not be delivered to SCADA master: " + a_pDoneMsg->get_topic());
+			// SCADA master sees a gap in sequence numbers, so births are published again. If connection
+			// is lost, births follow on next connection anyway.
+			if((true == m_MQTTClient.isConnected()) && (true == getInitStatus()))
+			{
+				setInitStatus(false);
+				requestRebirth();
+			}
+		}, SPARKPLUG_PUBLISH_RETRY_MAX_MS);
+	}, uiMaxQueued, m_QOS));
+	DO_LOG_INFO("Max messages queued for SCADA master: " + std::to_string(uiMaxQueued));
+
+	m_uiBirthThreads = (uint32_t)EnvironmentInfo::getEnvNum("SCADA_BIRTH_THREADS", m_uiBirthThreads, 1, UINT32_MAX);
+	DO_LOG_INFO("Threads encoding device births: " + std::to_string(m_uiBirthThreads));
+}
+
+/**
+ * Sets window in which changed metrics of a device are merged into a single DDATA. It is read
+ * from environment variables SCADA_DDATA_WINDOW_MS (0 publishes each update as it arrives),
+ * SCADA_DDATA_WINDOW_MAX_METRICS (window closes early once these many metrics are pending)
+ * and SCADA_DDATA_RT_BYPASS ("true" publishes updates of real-time metrics without waiting).
+ * @param None
+ * @return None
+ */
+void CSCADAHandler::initDDataWindow()
+{
+	uint32_t uiWindowMs = (uint32_t)EnvironmentInfo::getEnvNum("SCADA_DDATA_WINDOW_MS", 0, 0, UINT32_MAX);
+	uint32_t uiMaxMetrics = (uint32_t)EnvironmentInfo::getEnvNum("SCADA_DDATA_WINDOW_MAX_METRICS",
+			DDATA_WINDOW_DEFAULT_MAX_METRICS, 1, UINT32_MAX);
+	bool bRTBypass = true;
+
+	const char *pcRTBypass = std::getenv("SCADA_DDATA_RT_BYPASS");
+	if(NULL != pcRTBypass)
+	{
+		bRTBypass = (std::string("false") != pcRTBypass);
+	}
+
+	m_pDDataWindow.reset(new CDDataAggregator(uiWindowMs, uiMaxMetrics, bRTBypass));
+	DO_LOG_INFO("DDATA window: " + std::to_string(uiWindowMs) + " ms, max metrics: " +
+			std::to_string(uiMaxMetrics) + ", RT bypass: " + std::to_string(bRTBypass));
+}
+
+/**
+ * Sets damping of births of a flapping SCADA connection. A connection which is lost before it
+ * stays up for SCADA_LINK_STABLE_MS is flapping; NBIRTH and DBIRTHs on its next connection are
+ * held back for SCADA_REBIRTH_HOLDDOWN_MS, which doubles with each such loss up to
+ * SCADA_REBIRTH_HOLDDOWN_MAX_MS. SCADA_REBIRTH_HOLDDOWN_MS of 0 publishes births on each connection.
+ * @param None
+ * @return None
+ */
+void CSCADAHandler::initFlapDamping()
+{
+	uint32_t uiHoldDownMs = (uint32_t)EnvironmentInfo::getEnvNum("SCADA_REBIRTH_HOLDDOWN_MS",
+			SCADA_REBIRTH_DEFAULT_HOLDDOWN_MS, 0, UINT32_MAX);
+	uint32_t uiMaxHoldDownMs = (uint32_t)EnvironmentInfo::getEnvNum("SCADA_REBIRTH_HOLDDOWN_MAX_MS",
+			SCADA_REBIRTH_DEFAULT_MAX_HOLDDOWN_MS, 0, UINT32_MAX);
+	uint32_t uiStableMs = (uint32_t)EnvironmentInfo::getEnvNum("SCADA_LINK_STABLE_MS",
+			SCADA_LINK_DEFAULT_STABLE_MS, 0, UINT32_MAX);
+
+	m_pScadaDamper.reset(new CFlapDamper(uiHoldDownMs, uiMaxHoldDownMs, uiStableMs));
+	DO_LOG_INFO("SCADA rebirth hold-down: " + std::to_string(uiHoldDownMs) + " ms, max: " +
+			std::to_string(uiMaxHoldDownMs) + " ms, stable connection: " + std::to_string(uiStableMs) + " ms");
+}
+
 /**
  * This is a singleton class. Used to handle communication with SCADA master
  * through external MQTT.
@@ -70,17 +181,10 @@ CSCADAHandler::CSCADAHandler(const std::string &strMqttURL, int iQOS) :
  */
 bool CSCADAHandler::init()
 {
-	// Initiate semaphore for requests
-	int retVal = sem_init(&m_semSCADAConnSuccess, 0, 0 /* Initial value of zero*/);
-	if (retVal == -1)
-	{
-		DO_LOG_FATAL("Could not create unnamed semaphore for SCADA success connection " + std::to_string(errno) + " " + strerror(errno));
-		return false;
-	}
 	std::thread{ std::bind(&CSCADAHandler::handleSCADAConnectionSuccessThread,
 			std::ref(*this)) }.detach();
 
-	retVal = sem_init(&m_semIntMQTTConnLost, 0, 0 /* Initial value of zero*/);
+	int retVal = sem_init(&m_semIntMQTTConnLost, 0, 0 /* Initial value of zero*/);
 	if (retVal == -1)
 	{
 		DO_LOG_FATAL("Could not create unnamed semaphore for Internal MQTT connection lost " + std::to_string(errno) + " " + strerror(errno));
@@ -99,49 +203,73 @@ bool CSCADAHandler::init()
 	std::thread{ std::bind(&CSCADAHandler::handleIntMQTTConnEstablishThread,
 		std::ref(*this)) }.detach();
 
+	// close DDATA windows and report DDATA statistics
+	std::thread{ std::bind(&CSCADAHandler::handleDDataWindowThread,
+		std::ref(*this)) }.detach();
+
+	// publish queued messages in order of sequence numbers
+	m_thPublisher = std::thread(&CSparkplugPublisher::run, m_pPublisher.get());
 
 	return true;
 }
 
 /**
  * Thread function to handle SCADA connection success scenario.
- * It listens on a semaphore to know the connection status.
+ * Births are published once per connection when its hold-down ends. Connections
+ * and losses which happen meanwhile are coalesced, so only latest connection is announced.
  * @return none
  */
 void CSCADAHandler::handleSCADAConnectionSuccessThread()
 {
+	std::unique_lock<std::mutex> lck(m_mutexScadaLink);
 	while(false == g_shouldStop.load())
 	{
 		try
 		{
-			do
+			uint64_t ui64NowMs = CDDataAggregator::getMonotonicMs();
+			if(false == m_pScadaDamper->takeAnnouncement(ui64NowMs))
 			{
-				if((sem_wait(&m_semSCADAConnSuccess)) == -1 && errno == EINTR)
-				{
-					// Continue if interrupted by handler
-					continue;
-				}
-				if(true == g_shouldStop.load())
+				uint64_t ui64WaitMs = SCADA_LINK_POLL_MS;
+				if(enFLAP_HOLD == m_pScadaDamper->getState())
 				{
-					break;
+					ui64WaitMs = std::min(ui64WaitMs, m_pScadaDamper->getAnnounceAtMs() - ui64NowMs);
 				}
+				m_cvScadaLink.wait_for(lck, std::chrono::milliseconds(ui64WaitMs));
+				continue;
+			}
+			if(0 != m_pScadaDamper->getHoldDownMs())
+			{
+				DO_LOG_INFO("SCADA connection is flapping. Births were held back for " +
+						std::to_string(m_pScadaDamper->getHoldDownMs()) + " ms, suppressed rebirths: " +
+						std::to_string(m_pScadaDamper->getSuppressedCount()));
+			}
+			uint64_t ui64LinkDowns = m_ui64ScadaLinkDowns.load();
+			lck.unlock();
 
-				// As a process first subscribe to topics
-				subscribeTopics();
-
-				// Publish the NBIRTH
-				publish_node_birth();
+			// As a process first subscribe to topics
+			subscribeTopics();
 
-				// Publish the DBIRTH for all devices
+			// Publish the NBIRTH and then the DBIRTH for all devices
+			bool bIsNBirthQueued = publish_node_birth();
+			if(true == bIsNBirthQueued)
+			{
 				publishAllDevBirths(true);
+			}
 
+			lck.lock();
+			// if connection is lost meanwhile, births are published on next connection
+			if((true == bIsNBirthQueued) && (ui64LinkDowns == m_ui64ScadaLinkDowns.load()))
+			{
 				setInitStatus(true);
-			} while(0);
-
+			}
 		}
 		catch (std::exception &e)
 		{
 			DO_LOG_ERROR("failed to send birth messages :: " + std::string(e.what()));
+			if(false == lck.owns_lock())
+			{
+				lck.lock();
+			}
 		}
 	}
 }
@@ -168,6 +296,10 @@ void CSCADAHandler::handleIntMQTTConnLostThread()
 				{
 					break;
 				}
+				// signals of earlier losses are served by this pass
+				while(0 == sem_trywait(&m_semIntMQTTConnLost))
+				{
+				}
 				DO_LOG_ERROR("Internal MQTT connection lost. DDEATH to be sent");
 
 				// Publish DDEATH for each device
@@ -188,8 +320,12 @@ void CSCADAHandler::handleIntMQTTConnLostThread()
 						break;
 					}
 					DO_LOG_INFO("Sending DDEATH for : " + itrDevice);
-					publishMsgDDEATH(itrDevice);
-					CSparkPlugDevManager::getInstance().setMsgPublishedStatus(enDEVSTATUS_DOWN, itrDevice);
+					std::lock_guard<std::mutex> lck(m_mutexDDataWindow);
+					flushDDataWindow(itrDevice);
+					if(true == publishMsgDDEATH(itrDevice))
+					{
+						CSparkPlugDevManager::getInstance().setMsgPublishedStatus(enDEVSTATUS_DOWN, itrDevice);
+					}
 				}
 			} while(0);
 		}
@@ -222,11 +358,20 @@ void CSCADAHandler::handleIntMQTTConnEstablishThread()
 				{
 					break;
 				}
+				// signals of earlier connections are served by this pass
+				while(0 == sem_trywait(&m_semIntMQTTConnEstablished))
+				{
+				}
 				if(false == getInitStatus())
 				{
 					DO_LOG_INFO("Node init is not done. SparkPlug DBIRTH message publish is not attempted on internal MQTT connection establishment.");
 					break;
 				}
+				if(false == CIntMqttHandler::instance().isConnected())
+				{
+					DO_LOG_INFO("Internal MQTT connection is lost again. DBIRTH message publish is not attempted.");
+					break;
+				}
 				DO_LOG_INFO("INFO: Internal MQTT connection established. DBIRTH to be attempted.");
 
 				// Publish the DBIRTH for all devices
@@ -241,6 +386,65 @@ void CSCADAHandler::handleIntMQTTConnEstablishThread()
 	}
 }
 
+/**
+ * Thread function to publish DDATA of devices whose aggregation window has elapsed.
+ * Pending DDATA is dropped while SCADA session is down since DBIRTH sent on
+ * reconnection carries latest values. DDATA statistics are logged periodically.
+ * @return none
+ */
+void CSCADAHandler::handleDDataWindowThread()
+{
+	uint32_t uiSleepMs = 1000;
+	if(true == m_pDDataWindow->isEnabled())
+	{
+		uiSleepMs = std::max<uint32_t>(1, std::min<uint32_t>(uiSleepMs, m_pDDataWindow->getWindowMs() / 4));
+	}
+	uint64_t ui64LastStatsMs = CDDataAggregator::getMonotonicMs();
+
+	while(false == g_shouldStop.load())
+	{
+		try
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(uiSleepMs));
+			uint64_t ui64NowMs = CDDataAggregator::getMonotonicMs();
+
+			if(true == m_pDDataWindow->isEnabled())
+			{
+				std::lock_guard<std::mutex> lck(m_mutexDDataWindow);
+				if(true == getInitStatus())
+				{
+					std::vector<stRefForSparkPlugAction> vecReady;
+					m_pDDataWindow->takeExpired(ui64NowMs, vecReady);
+					publishDDataList(vecReady);
+				}
+				else
+				{
+					size_t uiDiscarded = m_pDDataWindow->discardAll();
+					if(0 != uiDiscarded)
+					{
+						DO_LOG_INFO("SCADA session is down. Discarded pending DDATA metrics: " + std::to_string(uiDiscarded));
+					}
+				}
+			}
+
+			if(ui64NowMs - ui64LastStatsMs >= DDATA_STATS_LOG_INTERVAL_MS)
+			{
+				ui64LastStatsMs = ui64NowMs;
+				double dPacketsPerSec = 0, dBytesPerMetric = 0;
+				if(true == m_pDDataWindow->getStats(ui64NowMs, dPacketsPerSec, dBytesPerMetric))
+				{
+					DO_LOG_INFO("DDATA packets/s: " + std::to_string(dPacketsPerSec) +
+							", bytes/metric: " + std::to_string(dBytesPerMetric));
+				}
+			}
+		}
+		catch (std::exception &e)
+		{
+			DO_LOG_ERROR("ERROR :: " + std::string(e.what()));
+		}
+	}
+}
+
 /**
  * Signals that internal MQTT connection is lost
  * @return none
@@ -278,65 +482,17 @@ void CSCADAHandler::defaultPayload(org_eclipse_tahu_protobuf_Payload& a_payload)
  * @param a_ddata_payload :[in] spark plug message to publish
  * @param a_topic :[in] topic on which to publish message
  * @param a_bIsNBirth: [in] tells whether message is NBIRTH
+ * @param a_pEncodedLen: [out] if not null, set to size of encoded message
  * @return true/false based on success/failure
  */
-bool CSCADAHandler::publishSparkplugMsg(org_eclipse_tahu_protobuf_Payload& a_payload, string a_topic, bool a_bIsNBirth = false)
+bool CSCADAHandler::publishSparkplugMsg(org_eclipse_tahu_protobuf_Payload& a_payload, string a_topic, bool a_bIsNBirth = false,
+		size_t *a_pEncodedLen)
 {
-	std::lock_guard<std::mutex> lck(m_mutexSparkPlugMsgPub);
-	static uint8_t payload_sequence = 0;
 	try
 	{
-		// Encode the payload into a binary format so it can be published in the MQTT message.
-		size_t buffer_length = 0;
-
-		uint8_t next_payload_sequence = payload_sequence + 1;
-		if(true == a_bIsNBirth)
-		{
-			next_payload_sequence = 0;
-		}
-
-		// Set sequence number for this payload
-		a_payload.has_seq = true;
-		a_payload.seq = next_payload_sequence;
-
-		bool encode_passed = pb_get_encoded_size(&buffer_length, org_eclipse_tahu_protobuf_Payload_fields, &a_payload);
-		if(encode_passed == false)
-		{
-			DO_LOG_ERROR("Failed to calculate the payload length");
-			return false;
-		}
-
-		uint8_t *binary_buffer = (uint8_t *)malloc(buffer_length * sizeof(uint8_t));
-		if(binary_buffer == NULL)
-		{
-			DO_LOG_ERROR("Failed to allocate new memory");
-			return false;
-		}
-		size_t message_length = encode_payload(binary_buffer, buffer_length, &a_payload);
-		if(message_length == 0)
-		{
-			DO_LOG_ERROR("Failed to encode payload");
-
-			if(binary_buffer != NULL)
-			{
-				free(binary_buffer);
-			}
-			return false;
-		}
-		
-		// Publish the DDATA on the appropriate topic
-		mqtt::message_ptr pubmsg = mqtt::make_message(a_topic, (void*)binary_buffer, message_length, m_QOS, false);
-
-		// SCADA master expects messages to be in order. Publish messages in order. Hence, Wait for completion.
-                m_MQTTClient.publishMsg(pubmsg, true);
-		payload_sequence = next_payload_sequence;
-
-		// Free the memory
-		if(binary_buffer != NULL)
-		{
-			free(binary_buffer);
-		}
-		return true;
+		// Sequence number is assigned when message is queued; publisher thread keeps
+		// messages in that order while they are in flight.
+		return m_pPublisher->enqueue(a_payload, a_topic, a_bIsNBirth, a_pEncodedLen);
 	}
 	catch(std::exception& ex)
 	{
@@ -403,8 +559,13 @@ void CSCADAHandler::prepareNodeDeathMsg(bool a_bPublishMsg)
 }
 
 /**
- * Publish device birth message on SCADA for all devices
- * @param a_deviceName : [in] device for which to publish birth message
+ * Publish device birth message on SCADA for all devices.
+ * Births are encoded by SCADA_BIRTH_THREADS threads, calling thread being one of them, and
+ * are queued to publisher as soon as they are ready. Publisher keeps several messages in
+ * flight, so rebirth of all devices is not bound by one round trip per device.
+ * Order of DBIRTHs of different devices is not fixed; each has next sequence number when queued.
+ * DDATA pending in window of a device is discarded when its DBIRTH is queued.
+ * @param a_bIsNBIRTHProcess: [in] indicates whether DBIRTH is needed as a part of NBIRTH process
  * @return none
  */
 void CSCADAHandler::publishAllDevBirths(bool a_bIsNBIRTHProcess)
@@ -412,11 +573,30 @@ void CSCADAHandler::publishAllDevBirths(bool a_bIsNBIRTHProcess)
 	try
 	{
 		auto vDevList = CSparkPlugDevManager::getInstance().getDeviceList();
-		for(auto &itrDevice : vDevList)
+		std::atomic<size_t> uiNextDev{0};
+		// births of a lost connection are not published; they are published again on next connection
+		uint64_t ui64LinkDowns = m_ui64ScadaLinkDowns.load();
+		auto fnPublishBirths = [&]()
+		{
+			for(size_t uiDev = uiNextDev.fetch_add(1);
+					(uiDev < vDevList.size()) && (ui64LinkDowns == m_ui64ScadaLinkDowns.load());
+					uiDev = uiNextDev.fetch_add(1))
+			{
+				DO_LOG_DEBUG("Device : " + vDevList[uiDev]);
+				publish_device_birth(vDevList[uiDev], a_bIsNBIRTHProcess, false);
+			}
+		};
+
+		size_t uiThreads = std::min((size_t)m_uiBirthThreads, vDevList.size());
+		std::vector<std::thread> vecWorkers;
+		for(size_t uiThread = 1; uiThread < uiThreads; ++uiThread)
+		{
+			vecWorkers.emplace_back(fnPublishBirths);
+		}
+		fnPublishBirths();
+		for(auto &itrWorker : vecWorkers)
 		{
-			device_name = itrDevice;
-			DO_LOG_DEBUG("Device : " + itrDevice);
-			publish_device_birth(itrDevice, a_bIsNBIRTHProcess);
+			itrWorker.join();
 		}
 	}
 	catch(std::exception &ex)
@@ -429,29 +609,39 @@ void CSCADAHandler::publishAllDevBirths(bool a_bIsNBIRTHProcess)
  * Publish device birth message on SCADA
  * @param a_deviceName : [in] device for which to publish birth message
  * @param a_bIsNBIRTHProcess: [in] indicates whether DBIRTH is needed as a part of NBIRTH process
+ * @param a_bIsWindowLocked: [in] true if caller holds m_mutexDDataWindow and has handled DDATA
+ * pending for device; otherwise pending DDATA is discarded, under the mutex, as DBIRTH carries
+ * latest values and DDATA of device must not reach SCADA master before its DBIRTH
  * @return none
  */
-void CSCADAHandler::publish_device_birth(string a_deviceName, bool a_bIsNBIRTHProcess)
+void CSCADAHandler::publish_device_birth(string a_deviceName, bool a_bIsNBIRTHProcess, bool a_bIsWindowLocked)
 {
-	// Create the DBIRTH payload
-	org_eclipse_tahu_protobuf_Payload dbirth_payload;
-	//get_next_payload(&dbirth_payload);
-	defaultPayload(dbirth_payload);
 	try
 	{
-		if(true == CSparkPlugDevManager::getInstance().prepareDBirthMessage(dbirth_payload, a_deviceName, a_bIsNBIRTHProcess))
+		device_name = a_deviceName;
+		// DBIRTH is encoded once per change of device metrics; only timestamp and
+		// sequence number are added while queuing it
+		std::string sEncoded;
+		if(true == CSparkPlugDevManager::getInstance().encodeDBirthMessage(sEncoded, a_deviceName, a_bIsNBIRTHProcess))
 		{
-			string strDBirthTopic = CCommon::getInstance().getDBirthTopic() + "/" + a_deviceName;	
-			publishSparkplugMsg(dbirth_payload, strDBirthTopic);
-			CSparkPlugDevManager::getInstance().setMsgPublishedStatus(enDEVSTATUS_UP, a_deviceName);
+			string strDBirthTopic = CCommon::getInstance().getDBirthTopic() + "/" + a_deviceName;
+			// birth is encoded without lock, so that births of devices are encoded in parallel
+			std::unique_lock<std::mutex> lck(m_mutexDDataWindow, std::defer_lock);
+			if(false == a_bIsWindowLocked)
+			{
+				lck.lock();
+				discardDDataWindow(a_deviceName);
+			}
+			if(true == m_pPublisher->enqueueEncoded(sEncoded, strDBirthTopic))
+			{
+				CSparkPlugDevManager::getInstance().setMsgPublishedStatus(enDEVSTATUS_UP, a_deviceName);
+			}
 		}
 	}
 	catch(std::exception &ex)
 	{
 		DO_LOG_ERROR(ex.what());
 	}
-	// Free the memory
-	free_payload(&dbirth_payload);
 }
 
 /**
@@ -490,7 +680,14 @@ CSCADAHandler& CSCADAHandler::instance()
  */
 CSCADAHandler::~CSCADAHandler()
 {
-	sem_destroy(&m_semSCADAConnSuccess);
+	if(nullptr != m_pPublisher)
+	{
+		m_pPublisher->stop();
+	}
+	if(true == m_thPublisher.joinable())
+	{
+		m_thPublisher.join();
+	}
 	sem_destroy(&m_semIntMQTTConnLost);
 	sem_destroy(&m_semIntMQTTConnEstablished);
 }
@@ -498,10 +695,11 @@ CSCADAHandler::~CSCADAHandler()
 /**
  * Publish node birth message on SCADA
  * @param none
- * @return none
+ * @return true if NBIRTH is queued for publishing, false otherwise
  */
-void CSCADAHandler::publish_node_birth()
+bool CSCADAHandler::publish_node_birth()
 {
+	bool bRet = false;
 	org_eclipse_tahu_protobuf_Payload nbirth_payload;
 	//get_next_payload(&nbirth_payload);
 	defaultPayload(nbirth_payload);
@@ -512,7 +710,7 @@ void CSCADAHandler::publish_node_birth()
 		if(strAppName.empty())
 		{
 			DO_LOG_ERROR("App name is empty");
-			return;
+			return false;
 		}
 
 		nbirth_payload.uuid = (char*) strAppName.c_str();
@@ -534,7 +732,11 @@ void CSCADAHandler::publish_node_birth()
 		CSparkPlugUDTManager::getInstance().addUDTDefsToNbirth(nbirth_payload);
 
 		DO_LOG_INFO("Publishing nbirth message ...");
-		publishSparkplugMsg(nbirth_payload, CCommon::getInstance().getNBirthTopic(), true);
+		bRet = publishSparkplugMsg(nbirth_payload, CCommon::getInstance().getNBirthTopic(), true);
+		if(false == bRet)
+		{
+			DO_LOG_ERROR("NBIRTH could not be queued. Births are published on next connection.");
+		}
 
 		nbirth_payload.uuid = NULL;
 	}
@@ -543,6 +745,7 @@ void CSCADAHandler::publish_node_birth()
 		DO_LOG_ERROR(ex.what());
 	}
 	free_payload(&nbirth_payload);
+	return bRet;
 }
 
 /**
@@ -576,7 +779,11 @@ void CSCADAHandler::connected(const std::string &a_sCause)
 	{
 		DO_LOG_INFO("INFO: Connected: " + a_sCause);
 		// Publish the NBIRTH and DBIRTH Sparkplug messages
-		sem_post(&m_semSCADAConnSuccess);
+		{
+			std::lock_guard<std::mutex> lck(m_mutexScadaLink);
+			m_pScadaDamper->linkUp(CDDataAggregator::getMonotonicMs());
+		}
+		m_cvScadaLink.notify_one();
 	}
 	catch(std::exception &ex)
 	{
@@ -595,7 +802,15 @@ void CSCADAHandler::disconnected(const std::string &a_sCause)
 	{
 		DO_LOG_ERROR("INFO: Disconnected: " + a_sCause);
 		++m_uiBDSeq;
-		setInitStatus(false);
+		{
+			std::lock_guard<std::mutex> lck(m_mutexScadaLink);
+			m_pScadaDamper->linkDown(CDDataAggregator::getMonotonicMs());
+			m_ui64ScadaLinkDowns.fetch_add(1);
+			setInitStatus(false);
+		}
+		m_cvScadaLink.notify_one();
+		// queued messages belong to lost session; next NBIRTH starts new sequence
+		m_pPublisher->reset();
 		prepareNodeDeathMsg(false);
 	}
 	catch(std::exception &ex)
@@ -631,6 +846,7 @@ void CSCADAHandler::msgRcvd(mqtt::const_message_ptr a_pMsg)
  */
 bool CSCADAHandler::publishMsgDDATA(const stRefForSparkPlugAction& a_stRefAction)
 {
+	bool bRet = true;
 	//prepare and publish one sparkplug msg for this device
 	org_eclipse_tahu_protobuf_Payload sparkplug_payload;
 	defaultPayload(sparkplug_payload);
@@ -651,21 +867,73 @@ bool CSCADAHandler::publishMsgDDATA(const stRefForSparkPlugAction& a_stRefAction
 
 		string strMsgTopic = CCommon::getInstance().getDDataTopic() + "/" + strDeviceName;
 
-		if(true == a_stRefAction.m_refSparkPlugDev.get().prepareDdataMsg(sparkplug_payload, a_stRefAction.m_mapChangedMetrics))
+		// Changed metrics of a real device are given by index in its metric table
+		bool bIsPrepared = (false == a_stRefAction.m_vecChangedSamples.empty()) ?
+			a_stRefAction.m_refSparkPlugDev.get().prepareDdataMsg(sparkplug_payload, a_stRefAction.m_vecChangedSamples) :
+			a_stRefAction.m_refSparkPlugDev.get().prepareDdataMsg(sparkplug_payload, a_stRefAction.m_mapChangedMetrics);
+		if(true == bIsPrepared)
 		{
 			//publish sparkplug message
-			publishSparkplugMsg(sparkplug_payload, strMsgTopic);
-			a_stRefAction.m_refSparkPlugDev.get().setPublishedStatus(enDEVSTATUS_UP);
-			
+			size_t uiEncodedLen = 0;
+			bRet = publishSparkplugMsg(sparkplug_payload, strMsgTopic, false, &uiEncodedLen);
+			if(true == bRet)
+			{
+				m_pDDataWindow->recordPacket(a_stRefAction.m_mapChangedMetrics.size() +
+					a_stRefAction.m_vecChangedSamples.size(), uiEncodedLen);
+				a_stRefAction.m_refSparkPlugDev.get().setPublishedStatus(enDEVSTATUS_UP);
+			}
 		}
 	}
 	catch(std::exception &ex)
 	{
 		DO_LOG_ERROR(ex.what());
-		return false;
+		bRet = false;
 	}
 	free_payload(&sparkplug_payload);
-	return true;
+	return bRet;
+}
+
+/**
+ * Publishes DDATA messages in given order
+ * @param a_vecDData :[in] DDATA actions to publish
+ * @return None
+ */
+void CSCADAHandler::publishDDataList(std::vector<stRefForSparkPlugAction>& a_vecDData)
+{
+	for(auto &itr : a_vecDData)
+	{
+		publishMsgDDATA(itr);
+	}
+}
+
+/**
+ * Publishes pending DDATA of a device so that it reaches SCADA master before
+ * next DBIRTH or DDEATH of the device. Caller holds m_mutexDDataWindow.
+ * @param a_sDevName :[in] sparkplug name of device
+ * @return None
+ */
+void CSCADAHandler::flushDDataWindow(const std::string &a_sDevName)
+{
+	std::vector<stRefForSparkPlugAction> vecReady;
+	if(true == m_pDDataWindow->take(a_sDevName, vecReady))
+	{
+		publishDDataList(vecReady);
+	}
+}
+
+/**
+ * Drops pending DDATA of a device whose DBIRTH is about to be published, as DBIRTH
+ * carries latest values. Caller holds m_mutexDDataWindow.
+ * @param a_sDevName :[in] sparkplug name of device
+ * @return None
+ */
+void CSCADAHandler::discardDDataWindow(const std::string &a_sDevName)
+{
+	std::vector<stRefForSparkPlugAction> vecPending;
+	if(true == m_pDDataWindow->take(a_sDevName, vecPending))
+	{
+		DO_LOG_DEBUG(a_sDevName + ": pending DDATA is replaced by DBIRTH");
+	}
 }
 
 /**
@@ -676,6 +944,7 @@ bool CSCADAHandler::publishMsgDDATA(const stRefForSparkPlugAction& a_stRefAction
  */
 bool CSCADAHandler::publishMsgDDEATH(const stRefForSparkPlugAction& a_stRefAction)
 {
+	bool bRet = false;
 	//prepare and publish one sparkplug msg for this device
 	org_eclipse_tahu_protobuf_Payload sparkplug_payload;
 	//get_next_payload(&sparkplug_payload);
@@ -702,16 +971,19 @@ bool CSCADAHandler::publishMsgDDEATH(const stRefForSparkPlugAction& a_stRefActio
 		sparkplug_payload.timestamp = a_stRefAction.m_refSparkPlugDev.get().getDeathTime();
 
 		//publish sparkplug message
-		publishSparkplugMsg(sparkplug_payload, strMsgTopic);
-		a_stRefAction.m_refSparkPlugDev.get().setPublishedStatus(enDEVSTATUS_DOWN);
+		bRet = publishSparkplugMsg(sparkplug_payload, strMsgTopic);
+		if(true == bRet)
+		{
+			a_stRefAction.m_refSparkPlugDev.get().setPublishedStatus(enDEVSTATUS_DOWN);
+		}
 	}
 	catch(std::exception &ex)
 	{
 		DO_LOG_ERROR(ex.what());
-		return false;
+		bRet = false;
 	}
 	free_payload(&sparkplug_payload);
-	return true;
+	return bRet;
 }
 
 /**
@@ -735,7 +1007,7 @@ bool CSCADAHandler::publishNewUDTs()
 		// As per discussion - there is no need to publish NDEATH message.
 		//prepareNodeDeathMsg(true);
 		setInitStatus(false);
-		connected("Dummy start");
+		requestRebirth();
 	}
 	catch(std::exception &ex)
 	{
@@ -745,6 +1017,21 @@ bool CSCADAHandler::publishNewUDTs()
 	return true;
 }
 
+/**
+ * Publishes NBIRTH and DBIRTHs again on current SCADA connection. Births are published
+ * by connection thread; if connection is held back or down, they follow on its announcement.
+ * @param none
+ * @return none
+ */
+void CSCADAHandler::requestRebirth()
+{
+	{
+		std::lock_guard<std::mutex> lck(m_mutexScadaLink);
+		m_pScadaDamper->reannounce(CDDataAggregator::getMonotonicMs());
+	}
+	m_cvScadaLink.notify_one();
+}
+
 /**
  * Prepare a MQTT message with sparkplug format for devices mentioned in a_stRefActionVec
  * @param a_stRefActionVec :[in] devices and respective data-points which need to be
@@ -760,6 +1047,8 @@ bool CSCADAHandler::prepareSparkPlugMsg(std::vector<stRefForSparkPlugAction>& a_
 			DO_LOG_ERROR("Node init is not done. SparkPlug message publish is not done");
 			return false;
 		}
+		// DDATA merged in window of a device is published before any other message of that device
+		std::lock_guard<std::mutex> lck(m_mutexDDataWindow);
 		//for loop having all the devices for which to publish sparkplug message
 		for (auto &itr : a_stRefActionVec)
 		{
@@ -767,17 +1056,29 @@ bool CSCADAHandler::prepareSparkPlugMsg(std::vector<stRefForSparkPlugAction>& a_
 			switch (itr.m_enAction)
 			{
 			case enMSG_BIRTH:
+				flushDDataWindow(itr.m_refSparkPlugDev.get().getSparkPlugName());
   				publish_device_birth(itr.m_refSparkPlugDev.get().getSparkPlugName(), false);
 				break;
 			case enMSG_DEATH:
+				flushDDataWindow(itr.m_refSparkPlugDev.get().getSparkPlugName());
 				publishMsgDDEATH(itr);
 				break;
 			case enMSG_DATA:
-				publishMsgDDATA(itr);
+			{
+				// action is either merged in window or returned to be published now
+				std::vector<stRefForSparkPlugAction> vecReady;
+				m_pDDataWindow->add(itr, CDDataAggregator::getMonotonicMs(), vecReady);
+				publishDDataList(vecReady);
 				break;
+			}
 			case enMSG_UDTDEF_TO_SCADA:
+			{
+				std::vector<stRefForSparkPlugAction> vecReady;
+				m_pDDataWindow->takeAll(vecReady);
+				publishDDataList(vecReady);
 				publishNewUDTs();
 				break;
+			}
 			default:
 				DO_LOG_ERROR("Invalid message type received");
 				return false;
@@ -799,6 +1100,7 @@ bool CSCADAHandler::prepareSparkPlugMsg(std::vector<stRefForSparkPlugAction>& a_
  */
 bool CSCADAHandler::publishMsgDDEATH(const std::string &a_sDevName)
 {
+	bool bRet = false;
 	//prepare and publish one sparkplug msg for this device
 	org_eclipse_tahu_protobuf_Payload sparkplug_payload;
 	//get_next_payload(&sparkplug_payload);
@@ -817,15 +1119,15 @@ bool CSCADAHandler::publishMsgDDEATH(const std::string &a_sDevName)
 		sparkplug_payload.timestamp = get_current_timestamp();
 
 		//publish sparkplug message
-		publishSparkplugMsg(sparkplug_payload, strMsgTopic);
+		bRet = publishSparkplugMsg(sparkplug_payload, strMsgTopic);
 	}
 	catch(std::exception &ex)
 	{
 		DO_LOG_ERROR(ex.what());
-		return false;
+		bRet = false;
 	}
 	free_payload(&sparkplug_payload);
-	return true;
+	return bRet;
 }
 
 /**
@@ -95,20 +95,8 @@ bool CSparkPlugDevManager::processExternalMQTTMsg(std::string a_sTopic,
 		//device-site
 		string strDevName = vSplitTopic[4];
 		getTopicParts(strDevName, mDevName, "-");
-		bool bIsFound = false;
-		auto itr = [&] () mutable -> devSparkplugMap_t::iterator
-		{
-			bIsFound = false;
-			std::lock_guard<std::mutex> lck(m_mutexDevList);
-			auto i = m_mapSparkPlugDev.find(strDevName);
-			if (m_mapSparkPlugDev.end() != i)
-			{
-				bIsFound = true;
-			}
-			return i;
-		}();
-
-		if(false == bIsFound)
+		CSparkPlugDev *pDev = m_oDevRegistry.find(strDevName);
+		if(NULL == pDev)
 		{
 			DO_LOG_ERROR("Device is not present in list : " + strDevName);
 			return false;
@@ -116,13 +104,13 @@ bool CSparkPlugDevManager::processExternalMQTTMsg(std::string a_sTopic,
 
 		for (pb_size_t i = 0; i < a_payload.metrics_count; i++)
 		{
-			if(NULL == a_payload.metrics[i].name)
+			if(false == resolveDCMDMetricAlias(*pDev, a_payload.metrics[i]))
 			{
 				DO_LOG_DEBUG("Metric name is not present in DCMD message. Ignored.");
 				return false;
 			}
 			
-			if((false == itr->second.isVendorApp()) &&
+			if((false == pDev->isVendorApp()) &&
 				(METRIC_DATA_TYPE_TEMPLATE == a_payload.metrics[i].datatype))
 			{
 				org_eclipse_tahu_protobuf_Payload_Template &udt_template = a_payload.metrics[i].value.template_value;
@@ -139,7 +127,7 @@ bool CSparkPlugDevManager::processExternalMQTTMsg(std::string a_sTopic,
 						DO_LOG_ERROR("Unable to build metric. Not processing this message.");
 						return false;
 					}
-					if (false == processDCMDMetric(itr->second, *ptrCIfMetric, udt_template.metrics[iLoop]))
+					if (false == processDCMDMetric(*pDev, *ptrCIfMetric, udt_template.metrics[iLoop]))
 					{
 						DO_LOG_DEBUG("Could not process metric");
 						return false;
@@ -158,7 +146,7 @@ bool CSparkPlugDevManager::processExternalMQTTMsg(std::string a_sTopic,
 					DO_LOG_ERROR("Unable to build metric. Not processing this message.");
 					return false;
 				}
-				if (false == processDCMDMetric(itr->second, *ptrCIfMetric, a_payload.metrics[i]))
+				if (false == processDCMDMetric(*pDev, *ptrCIfMetric, a_payload.metrics[i]))
 				{
 					DO_LOG_DEBUG("Could not process metric");
 					return false;
@@ -170,9 +158,8 @@ bool CSparkPlugDevManager::processExternalMQTTMsg(std::string a_sTopic,
 			}
 		}
 
-		auto &mapSparkPlugDev = itr->second;
 		stRefForSparkPlugAction stCMDAction
-		{ std::ref(mapSparkPlugDev), enMSG_DCMD_WRITE, oMetricMap };
+		{ std::ref(*pDev), enMSG_DCMD_WRITE, oMetricMap };
 		a_stRefActionVec.push_back(stCMDAction);
 	}
 	catch (std::exception &e)
@@ -308,6 +295,37 @@ bool CSparkPlugDevManager::processInternalMQTTMsg(std::string a_sTopic,
 	return bRet;
 }
 
+/**
+ * Sets name of DCMD metric which is sent only with alias given to the metric in DBIRTH message
+ * @param a_SPDev :[in] device to which DCMD message is sent
+ * @param a_sparkplugMetric :[in/out] input Sparkplug DCMD metric
+ * @return true if metric has a name, false otherwise
+ */
+bool CSparkPlugDevManager::resolveDCMDMetricAlias(CSparkPlugDev& a_SPDev, org_eclipse_tahu_protobuf_Payload_Metric& a_sparkplugMetric)
+{
+	if(NULL != a_sparkplugMetric.name)
+	{
+		return true;
+	}
+	if(false == a_sparkplugMetric.has_alias)
+	{
+		return false;
+	}
+	std::string sName{""};
+	if(false == a_SPDev.resolveAlias(a_sparkplugMetric.alias, sName))
+	{
+		DO_LOG_ERROR("Alias " + std::to_string(a_sparkplugMetric.alias) + " is not known for device: " + a_SPDev.getSparkPlugName());
+		return false;
+	}
+	a_sparkplugMetric.name = strndup(sName.c_str(), sName.length());
+	if(NULL == a_sparkplugMetric.name)
+	{
+		DO_LOG_ERROR("Failed to allocate new memory");
+		return false;
+	}
+	return true;
+}
+
 /**
  * Processes metric to parse its data-type and value; sets in CValueObj corresponding to the metric
  * @param a_SPDev :[in] device to be used for checking for metric presence
@@ -686,11 +704,7 @@ void CSparkPlugDevManager::processDeathMsg(std::string a_sAppName,
 				break;
 			}
 
-			CVendorApp *pVendorApp = NULL;
-			{
-				std::lock_guard<std::mutex> lck(m_mutexDevList);
-				pVendorApp = m_objVendorAppList.getVendorApp(a_sAppName);
-			}
+			CVendorApp *pVendorApp = m_objVendorAppList.getVendorApp(a_sAppName);
 			if (NULL == pVendorApp)
 			{
 				DO_LOG_ERROR(
@@ -768,23 +782,14 @@ void CSparkPlugDevManager::processBirthMsg(std::string a_sAppName,
 			// Find the device in list
 			bool bIsNew = false;
 
-			auto& oDev = [&] () mutable -> CSparkPlugDev&
-					{
-				std::lock_guard<std::mutex> lck(m_mutexDevList);
-				auto itr = m_mapSparkPlugDev.find(sDevName);
-				if (m_mapSparkPlugDev.end() == itr)
+			// Only stripe of this device is locked while it is added
+			auto& oDev = m_oDevRegistry.findOrAdd(sDevName,
+				[&]() { return CSparkPlugDev{ a_sSubDev, sDevName, true }; },
+				[&](CSparkPlugDev &a_oNewDev)
 				{
-					bIsNew = true;
 					DO_LOG_INFO("New device found: " + sDevName);
-					CSparkPlugDev oDev{ a_sSubDev, sDevName, true };
-					m_mapSparkPlugDev.emplace(sDevName, oDev);
-					itr = m_mapSparkPlugDev.find(sDevName);
-
-					m_objVendorAppList.addDevice(a_sAppName, itr->second);
-				}
-
-				return itr->second;
-					}();
+					m_objVendorAppList.addDevice(a_sAppName, a_oNewDev);
+				}, bIsNew);
 					bool bIsOnlyValChange = false;
 			metricMapIf_t mapChangedMetricsFromBirth = oDev.processNewBirthData(
 							mapMetricsInMsg, bIsOnlyValChange);
@@ -873,26 +878,14 @@ void CSparkPlugDevManager::processUpdateMsg(std::string a_sDeviceName,
 			DO_LOG_DEBUG(sDevName + ":Device. Received message: " + a_sPayLoad);
 
 			// Find the device in list
-			bool bIsFound = false;			
-			auto itr = [&] () mutable -> devSparkplugMap_t::iterator
-			{
-				bIsFound = false;
-				std::lock_guard<std::mutex> lck(m_mutexDevList);
-				auto i = m_mapSparkPlugDev.find(sDevName);
-				if (m_mapSparkPlugDev.end() != i)
-				{
-					bIsFound = true;
-				}
-				return i;
-			}();
-
-			if (false == bIsFound)
+			CSparkPlugDev *pDev = m_oDevRegistry.find(sDevName);
+			if (NULL == pDev)
 			{
 				DO_LOG_ERROR("Invalid real device. Ignoring.");
 				break;
 			}
 
-			auto &oDev = itr->second;
+			auto &oDev = *pDev;
 
 			// Parse message and get metric info
 			bool bRet = oDev.processRealDeviceUpdateMsg(a_sPayLoad, a_stRefActionVec);
@@ -939,21 +932,10 @@ void CSparkPlugDevManager::processDataMsg(std::string a_sAppName,
 			DO_LOG_INFO("Device name is: " + sDevName);
 
 			// Find the device in list
-			bool bIsFound = false;
-			auto itr = [&] () mutable -> devSparkplugMap_t::iterator
+			CSparkPlugDev *pDev = m_oDevRegistry.find(sDevName);
+					if (NULL == pDev)
 					{
-				bIsFound = false;
-				std::lock_guard<std::mutex> lck(m_mutexDevList);
-				auto i = m_mapSparkPlugDev.find(sDevName);
-				if (m_mapSparkPlugDev.end() != i)
-				{
-					bIsFound = true;
-				}
-				return i;
-					}();
-					if (false == bIsFound)
-					{
-				DO_LOG_ERROR(sDevName
+				DO_LOG_ERROR_RATELIMITED("Device not found", 10, 1000, sDevName
 								+ ": Not found in dev-ist. Ignoring DATA message: "
 								+ a_sPayLoad);
 					}
@@ -965,7 +947,7 @@ void CSparkPlugDevManager::processDataMsg(std::string a_sAppName,
 
 						if (mapMetricsInMsg.size() > 0)
 						{
-							auto &oDev = itr->second;
+							auto &oDev = *pDev;
 					metricMapIf_t mapChangedMetricsFromData = oDev.processNewData(
 									mapMetricsInMsg);
 
@@ -1007,30 +989,27 @@ bool CSparkPlugDevManager::addRealDevices()
 		{
 			using network_info::CUniqueDataPoint;
 
-			std::lock_guard<std::mutex> lck(m_mutexDevList);
 			auto &mapUniqueDevice =	network_info::getUniqueDeviceList();
 			for (auto &rUniqueDev : mapUniqueDevice)
 			{
 				std::string sUniqueDev{rUniqueDev.second.getWellSiteDev().getID() + SUBDEV_SEPARATOR_CHAR + 
 					rUniqueDev.second.getWellSite().getID()};
 
-				auto itr = m_mapSparkPlugDev.find(sUniqueDev);
 				// Create a new device, if not present
-				if (m_mapSparkPlugDev.end() == itr)
-				{
-					DO_LOG_INFO("New device found: " + sUniqueDev);
-					CSparkPlugDev oDev{ rUniqueDev.second, sUniqueDev };
-					m_mapSparkPlugDev.emplace(sUniqueDev, oDev);
-
-					// Now add datapoints to SparkPlug device as a metric
-					auto& rSparkPlugDev = m_mapSparkPlugDev.at(sUniqueDev);
-					auto& rPointList = rUniqueDev.second.getPoints();
-					for (auto &rPoint : rPointList)
+				bool bIsNew = false;
+				m_oDevRegistry.findOrAdd(sUniqueDev,
+					[&]() { return CSparkPlugDev{ rUniqueDev.second, sUniqueDev }; },
+					[&](CSparkPlugDev &a_rSparkPlugDev)
 					{
-						rSparkPlugDev.addMetric(rPoint.get());
-					}
-				}
-				else
+						DO_LOG_INFO("New device found: " + sUniqueDev);
+						// Now add datapoints to SparkPlug device as a metric
+						auto& rPointList = rUniqueDev.second.getPoints();
+						for (auto &rPoint : rPointList)
+						{
+							a_rSparkPlugDev.addMetric(rPoint.get());
+						}
+					}, bIsNew);
+				if (false == bIsNew)
 				{
 					DO_LOG_ERROR(sUniqueDev + ": Repeat device found. Ignoring recent instance.");
 				}
@@ -1055,12 +1034,37 @@ bool CSparkPlugDevManager::prepareDBirthMessage(org_eclipse_tahu_protobuf_Payloa
 {
 	try
 	{
-		std::lock_guard<std::mutex> lck(m_mutexDevList);
-		auto itr = m_mapSparkPlugDev.find(a_sDevName);
+		// Registry is not locked while message is prepared; device locks its own metrics
+		CSparkPlugDev *pDev = m_oDevRegistry.find(a_sDevName);
 		// Check if device is found
-		if (m_mapSparkPlugDev.end() != itr)
+		if (NULL != pDev)
+		{
+			return pDev->prepareDBirthMessage(a_rTahuPayload, a_bIsNBIRTHProcess);
+		}
+	}
+	catch(std::exception &ex)
+	{
+		DO_LOG_FATAL(ex.what());
+		return false;
+	}
+	return false;
+}
+
+/**
+ * Gives encoded device birth message, without payload timestamp and sequence number
+ * @param a_sEncoded :[out] encoded birth message
+ * @param a_sDevName:[in] device name for which birth message to be generated
+ * @param a_bIsNBIRTHProcess: [in] indicates whether DBIRTH is needed as a part of NBIRTH process
+ * @return true/false depending on the success/failure
+ */
+bool CSparkPlugDevManager::encodeDBirthMessage(std::string &a_sEncoded, const std::string &a_sDevName, bool a_bIsNBIRTHProcess)
+{
+	try
+	{
+		CSparkPlugDev *pDev = m_oDevRegistry.find(a_sDevName);
+		if (NULL != pDev)
 		{
-			return itr->second.prepareDBirthMessage(a_rTahuPayload, a_bIsNBIRTHProcess);
+			return pDev->encodeDBirthMessage(a_sEncoded, a_bIsNBIRTHProcess);
 		}
 	}
 	catch(std::exception &ex)
@@ -1080,11 +1084,7 @@ std::vector<std::string> CSparkPlugDevManager::getDeviceList()
 	std::vector<std::string> sDevNameVector;
 	try
 	{
-		std::lock_guard<std::mutex> lck(m_mutexDevList);
-		for (auto const& itr : m_mapSparkPlugDev) 
-		{
-			sDevNameVector.push_back(itr.first);
-		}
+		sDevNameVector = m_oDevRegistry.getNames();
 	}
 	catch(std::exception &ex)
 	{
@@ -1103,12 +1103,11 @@ bool CSparkPlugDevManager::setMsgPublishedStatus(eDevStatus a_enStatus, std::str
 {
 	try
 	{
-		std::lock_guard<std::mutex> lck(m_mutexDevList);
-		auto itr = m_mapSparkPlugDev.find(a_sDevName);
+		CSparkPlugDev *pDev = m_oDevRegistry.find(a_sDevName);
 		// Check if device is found
-		if (m_mapSparkPlugDev.end() != itr)
+		if (NULL != pDev)
 		{
-			itr->second.setPublishedStatus(a_enStatus);
+			pDev->setPublishedStatus(a_enStatus);
 		}
 	}
 	catch(std::exception &ex)
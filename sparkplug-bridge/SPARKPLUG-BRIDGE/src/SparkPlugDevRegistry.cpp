@@ -0,0 +1,125 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <algorithm>
+#include "SparkPlugDevRegistry.hpp"
+
+/**
+ * Constructor
+ * @param a_uiStripes :[in] number of stripes; 0 is treated as 1
+ * @return None
+ */
+CSparkPlugDevRegistry::CSparkPlugDevRegistry(uint32_t a_uiStripes)
+	: m_vecStripes((0 == a_uiStripes) ? 1 : a_uiStripes)
+{
+}
+
+/**
+ * Gets stripe to which a device name belongs
+ * @param a_sName :[in] sparkplug name of device
+ * @return index of stripe
+ */
+uint32_t CSparkPlugDevRegistry::getStripe(const std::string &a_sName) const
+{
+	return (uint32_t)(std::hash<std::string>{}(a_sName) % m_vecStripes.size());
+}
+
+/**
+ * Finds a device
+ * @param a_sName :[in] sparkplug name of device
+ * @return pointer to device; NULL if device is not present
+ */
+CSparkPlugDev* CSparkPlugDevRegistry::find(const std::string &a_sName)
+{
+	stDevStripe &stStripe = m_vecStripes[getStripe(a_sName)];
+	std::lock_guard<std::mutex> lck(stStripe.m_mutex);
+	auto itr = stStripe.m_mapDev.find(a_sName);
+	if(stStripe.m_mapDev.end() == itr)
+	{
+		return NULL;
+	}
+	return &(itr->second);
+}
+
+/**
+ * Finds a device and adds it if it is not present. Creation of device and a_fnOnAdd run
+ * under lock of stripe of the device, so a device is added only once even if
+ * it is found new by more than one thread at the same time.
+ * @param a_sName :[in] sparkplug name of device
+ * @param a_fnCreate :[in] creates device if it is not present
+ * @param a_fnOnAdd :[in] called for newly added device, e.g. to add its metrics; may be empty
+ * @param a_bIsNew :[out] true if device is added by this call
+ * @return reference of device
+ */
+CSparkPlugDev& CSparkPlugDevRegistry::findOrAdd(const std::string &a_sName,
+		const std::function<CSparkPlugDev()> &a_fnCreate,
+		const std::function<void(CSparkPlugDev&)> &a_fnOnAdd, bool &a_bIsNew)
+{
+	stDevStripe &stStripe = m_vecStripes[getStripe(a_sName)];
+	std::lock_guard<std::mutex> lck(stStripe.m_mutex);
+	a_bIsNew = false;
+	auto itr = stStripe.m_mapDev.find(a_sName);
+	if(stStripe.m_mapDev.end() == itr)
+	{
+		itr = stStripe.m_mapDev.emplace(a_sName, a_fnCreate()).first;
+		a_bIsNew = true;
+		if(a_fnOnAdd)
+		{
+			a_fnOnAdd(itr->second);
+		}
+	}
+	return itr->second;
+}
+
+/**
+ * Returns list of device names in sorted order
+ * @return List of device names
+ */
+std::vector<std::string> CSparkPlugDevRegistry::getNames()
+{
+	std::vector<std::string> vecNames;
+	for(auto &stStripe : m_vecStripes)
+	{
+		std::lock_guard<std::mutex> lck(stStripe.m_mutex);
+		for(auto &itr : stStripe.m_mapDev)
+		{
+			vecNames.push_back(itr.first);
+		}
+	}
+	std::sort(vecNames.begin(), vecNames.end());
+	return vecNames;
+}
+
+/**
+ * Gets number of devices
+ * @return number of devices
+ */
+size_t CSparkPlugDevRegistry::size()
+{
+	size_t uiCount = 0;
+	for(auto &stStripe : m_vecStripes)
+	{
+		std::lock_guard<std::mutex> lck(stStripe.m_mutex);
+		uiCount += stStripe.m_mapDev.size();
+	}
+	return uiCount;
+}
@@ -20,12 +20,16 @@
 * SOFTWARE.
 *********************************************************************************/
 #include <string.h>
+#include <strings.h>
 #include <chrono>
 #include "SparkPlugDevices.hpp"
 #include "SCADAHandler.hpp"
+#include "SparkplugEncodeArena.hpp"
 
 #include <ctime>
 
+std::atomic<uint64_t> CSparkPlugDev::m_ui64NextAlias{1};
+
 /**
  * Process new device birth message from vendor app and extract all the information about metric
  * @param a_MetricList :[in] list of metrics present in a message payload received on internal MQTT broker
@@ -64,6 +68,7 @@ metricMapIf_t CSparkPlugDev::processNewBirthData(metricMapIf_t &a_MetricList, bo
 							itrInputMetric.second);
 					oMetricMap.emplace(itrInputMetric.first,
 							itrInputMetric.second);
+					++m_ui64MetricMapVersion;
 				}
 				else
 				{
@@ -85,6 +90,7 @@ metricMapIf_t CSparkPlugDev::processNewBirthData(metricMapIf_t &a_MetricList, bo
 						// Add data to a separate metric map for maintaining data
 						oMetricMapData.emplace(itrInputMetric.first,
 								itrInputMetric.second);
+						++m_ui64MetricMapVersion;
 						break;
 
 					case DATATYPE_DIFFERENT:
@@ -93,6 +99,7 @@ metricMapIf_t CSparkPlugDev::processNewBirthData(metricMapIf_t &a_MetricList, bo
 						// Add data to a separate metric map for maintaining changes in BIRTH
 						oMetricMap.emplace(itrInputMetric.first,
 								itrInputMetric.second);
+						++m_ui64MetricMapVersion;
 						break;
 					}
 				}
@@ -166,6 +173,7 @@ metricMapIf_t CSparkPlugDev::processNewData(metricMapIf_t &a_MetricList)
 						(itrMyMetric->second)->assignNewValue(*(itrInputMetric.second));
 						oMetricMap.emplace(itrInputMetric.first,
 								itrInputMetric.second);
+						++m_ui64MetricMapVersion;
 						break;
 
 					case DATATYPE_DIFFERENT:
@@ -193,7 +201,8 @@ metricMapIf_t CSparkPlugDev::processNewData(metricMapIf_t &a_MetricList)
 }
 
 /**
- * Add metric to SprakPlugDev for Modbus device
+ * Add metric to SprakPlugDev for Modbus device. Metric is kept in metric table of
+ * device with default value of its datatype.
  * @param a_rUniqueDataPoint :[in] reference of unique data point
  * @return none
  */
@@ -204,9 +213,9 @@ void CSparkPlugDev::addMetric(const network_info::CUniqueDataPoint &a_rUniqueDat
 		try
 		{
 			std::lock_guard<std::mutex> lck(m_mutexMetricList);
-			auto itrMyMetric = m_mapMetrics.find(a_rUniqueDataPoint.getID());
+			const std::string &sMetricName = a_rUniqueDataPoint.getDataPoint().getID();
 
-			if (m_mapMetrics.end() == itrMyMetric)
+			if (REAL_DEV_METRIC_INVALID_INDEX == m_oMetricTable.findIndex(sMetricName))
 			{
 				/** data type of datapoint specified in yml files*/
 				std::string ymlDataType =  a_rUniqueDataPoint.getDataPoint().getAddress().m_sDataType;
@@ -265,18 +274,12 @@ void CSparkPlugDev::addMetric(const network_info::CUniqueDataPoint &a_rUniqueDat
 				float defaultFloatVal = 0.0;
 				double defaultDoubleVal = 0.0;
 				std::string defaultStringVal =  "";
-				std::shared_ptr<CIfMetric> ptrIfMetric = std::make_shared<CMetric>(a_rUniqueDataPoint);			
-				if(nullptr == ptrIfMetric)
-				{
-					DO_LOG_ERROR(a_rUniqueDataPoint.getID() + ": Unable to create shared metric.");
-					return;
-				}
-				
+				CValObj objMetricVal;
+
 				if (enSTRING == oYMlDataType)
 				{
 					metricDataType = METRIC_DATA_TYPE_STRING;
-					CValObj objVal(metricDataType, defaultStringVal);
-					ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);					
+					objMetricVal = CValObj(metricDataType, defaultStringVal);
 				}
 				else 
 				{
@@ -287,20 +290,17 @@ void CSparkPlugDev::addMetric(const network_info::CUniqueDataPoint &a_rUniqueDat
 						if (enINT == oYMlDataType)
 						{							 
 							metricDataType = METRIC_DATA_TYPE_INT16;
-							CValObj objVal(metricDataType, (int16_t)defaultIntVal);
-							ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);								 				 
+							objMetricVal = CValObj(metricDataType, (int16_t)defaultIntVal);
 						}
 						else if (enUINT == oYMlDataType)
 						{
 							metricDataType = METRIC_DATA_TYPE_UINT16;
-							CValObj objVal(metricDataType, (uint16_t)defaultIntVal);
-							ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);
+							objMetricVal = CValObj(metricDataType, (uint16_t)defaultIntVal);
 						}
 						else if (enBOOLEAN == oYMlDataType)
 						{
 							metricDataType = METRIC_DATA_TYPE_BOOLEAN;
-							CValObj objVal(metricDataType, true);
-							ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);
+							objMetricVal = CValObj(metricDataType, true);
 						}
 						else
 						{
@@ -315,20 +315,17 @@ void CSparkPlugDev::addMetric(const network_info::CUniqueDataPoint &a_rUniqueDat
 						if (enINT == oYMlDataType)
 						{
 							metricDataType = METRIC_DATA_TYPE_INT32;
-							CValObj objVal(metricDataType, (int32_t)defaultIntVal);
-							ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);								 
+							objMetricVal = CValObj(metricDataType, (int32_t)defaultIntVal);
 						}
 						else if (enUINT == oYMlDataType)
 						{
 							metricDataType = METRIC_DATA_TYPE_UINT32;
-							CValObj objVal(metricDataType, (uint32_t)defaultIntVal);
-							ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);
+							objMetricVal = CValObj(metricDataType, (uint32_t)defaultIntVal);
 						}
 						else if (enFLOAT == oYMlDataType)
 						{
 							metricDataType = METRIC_DATA_TYPE_FLOAT;
-							CValObj objVal(metricDataType, (float)defaultFloatVal);
-							ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);
+							objMetricVal = CValObj(metricDataType, (float)defaultFloatVal);
 						}
 						else
 						{
@@ -342,20 +339,17 @@ void CSparkPlugDev::addMetric(const network_info::CUniqueDataPoint &a_rUniqueDat
 						if (enINT == oYMlDataType)
 						{
 							metricDataType = METRIC_DATA_TYPE_INT64;
-							CValObj objVal(metricDataType, (int64_t)defaultIntVal);
-							ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);
+							objMetricVal = CValObj(metricDataType, (int64_t)defaultIntVal);
 						}
 						else if (enUINT == oYMlDataType)
 						{
 							metricDataType = METRIC_DATA_TYPE_UINT64;
-							CValObj objVal(metricDataType, (uint64_t)defaultIntVal);
-							ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);
+							objMetricVal = CValObj(metricDataType, (uint64_t)defaultIntVal);
 						}
 						else if (enDOUBLE == oYMlDataType)
 						{
 							metricDataType = METRIC_DATA_TYPE_DOUBLE;
-							CValObj objVal(metricDataType, (double)defaultDoubleVal);
-							ptrIfMetric->getValue().assignNewDataTypeValue(metricDataType, objVal);
+							objMetricVal = CValObj(metricDataType, (double)defaultDoubleVal);
 						}						
 						else
 						{
@@ -371,7 +365,7 @@ void CSparkPlugDev::addMetric(const network_info::CUniqueDataPoint &a_rUniqueDat
 
 				};				
              }	
-				m_mapMetrics.emplace(ptrIfMetric->getSparkPlugName(), ptrIfMetric);				
+				addRealDevMetric(sMetricName, objMetricVal, &a_rUniqueDataPoint);
 			}
 			else
 			{
@@ -387,14 +381,28 @@ void CSparkPlugDev::addMetric(const network_info::CUniqueDataPoint &a_rUniqueDat
 }
 
 /**
- * Prepare device birth messages to be published on SCADA system
+ * Adds metric to metric table of real device. Caller holds m_mutexMetricList.
+ * @param a_sName :[in] sparkplug name of metric
+ * @param a_oValue :[in] initial value; its datatype is datatype of metric
+ * @param a_pPoint :[in] data point of metric
+ * @return true if metric is added, false if it is already present
+ */
+bool CSparkPlugDev::addRealDevMetric(const std::string &a_sName, const CValObj &a_oValue,
+		const network_info::CUniqueDataPoint *a_pPoint)
+{
+	return (REAL_DEV_METRIC_INVALID_INDEX != m_oMetricTable.add(a_sName, a_oValue, a_pPoint));
+}
+
+/**
+ * Prepare device birth or data message of a Modbus device to be published on SCADA system
  * @param a_rTahuPayload :[out] reference of spark plug message payload in which to store birth messages
- * @param a_mapMetrics: [in] list of metrics to be added in message
+ * @param a_pvecSamples: [in] changed metrics to be added in message; NULL to add all metrics
+ * of device with their current values
  * @param a_bIsBirth: [in] indicates whether DBIRTH is needed as a part of NBIRTH process
  * @return true/false depending on the success/failure
  */
 bool CSparkPlugDev::prepareModbusMessage(org_eclipse_tahu_protobuf_Payload& a_rTahuPayload, 
-		const metricMapIf_t &a_mapMetrics, bool a_bIsBirth)
+		const std::vector<stRealDevMetricSample> *a_pvecSamples, bool a_bIsBirth)
 {
 	try
 	{
@@ -409,8 +417,9 @@ bool CSparkPlugDev::prepareModbusMessage(org_eclipse_tahu_protobuf_Payload& a_rT
 		
 		org_eclipse_tahu_protobuf_Payload_Template udt_template = org_eclipse_tahu_protobuf_Payload_Template_init_default;
 		udt_template.version = strndup(rDev.getDataPointsRef().getVersion().c_str(), rDev.getDataPointsRef().getVersion().length());
-		udt_template.metrics_count = a_mapMetrics.size();
-		udt_template.metrics = (org_eclipse_tahu_protobuf_Payload_Metric *) calloc(a_mapMetrics.size(), sizeof(org_eclipse_tahu_protobuf_Payload_Metric));
+		size_t uiCount = (NULL == a_pvecSamples) ? m_oMetricTable.size() : a_pvecSamples->size();
+		udt_template.metrics_count = uiCount;
+		udt_template.metrics = (org_eclipse_tahu_protobuf_Payload_Metric *) calloc(uiCount, sizeof(org_eclipse_tahu_protobuf_Payload_Metric));
 		std::string sYMLFilename{rDev.getDataPointsRef().getYMLFileName()};
 		{
 			std::size_t found = rDev.getDataPointsRef().getYMLFileName().rfind(".");
@@ -422,22 +431,30 @@ bool CSparkPlugDev::prepareModbusMessage(org_eclipse_tahu_protobuf_Payload& a_rT
 		udt_template.template_ref = strndup(sYMLFilename.c_str(), sYMLFilename.length());
 		udt_template.has_is_definition = true;
 		udt_template.is_definition = false;
-		int iLoop = 0;
-
 		if(udt_template.metrics != NULL)
 		{
-			for(auto &itr: a_mapMetrics)
+			for(size_t iLoop = 0; iLoop < uiCount; ++iLoop)
 			{
-				if(itr.second)
+				uint32_t uiIndex = (uint32_t)iLoop;
+				uint64_t ui64Timestamp = 0;
+				CValObj oValue;
+				if(NULL == a_pvecSamples)
 				{
-					if(true !=  (itr.second)->addModbusMetric(udt_template.metrics[iLoop], a_bIsBirth))
-					{
-						DO_LOG_ERROR((itr.second)->getSparkPlugName() + ":Could not add metric to device. Trying to add other metrics.");
+					oValue = m_oMetricTable.getValue(uiIndex);
+					ui64Timestamp = m_oMetricTable.getTimestamp(uiIndex);
 				}
-					udt_template.metrics[iLoop].timestamp = (itr.second)->getTimestamp();
-				udt_template.metrics[iLoop].has_timestamp = true;
+				else
+				{
+					uiIndex = (*a_pvecSamples)[iLoop].m_uiIndex;
+					oValue = (*a_pvecSamples)[iLoop].m_oValue;
+					ui64Timestamp = (*a_pvecSamples)[iLoop].m_ui64Timestamp;
 				}
-				++iLoop;
+				if(true != m_oMetricTable.addModbusMetric(uiIndex, oValue, udt_template.metrics[iLoop], a_bIsBirth))
+				{
+					DO_LOG_ERROR(m_oMetricTable.getName(uiIndex) + ":Could not add metric to device. Trying to add other metrics.");
+				}
+				udt_template.metrics[iLoop].timestamp = ui64Timestamp;
+				udt_template.metrics[iLoop].has_timestamp = true;
 			}
 		}
 		if(true == a_bIsBirth)
@@ -460,9 +477,26 @@ bool CSparkPlugDev::prepareModbusMessage(org_eclipse_tahu_protobuf_Payload& a_rT
 			CSCADAHandler::instance().addModbusPropForBirth(udt_template, sProtocol);
 		}
 
+		// Members of template are identified by names, only root metric is given an alias.
+		// Birth message carries both name and alias, data message carries only alias.
+		const std::string &sDevID = orUniqueDev.get().getWellSiteDev().getID();
+		uint64_t ui64Alias = 0;
+		if(true == a_bIsBirth)
+		{
+			if(true == CCommon::getInstance().isMetricAliases())
+			{
+				ui64Alias = assignAlias(sDevID);
+			}
+		}
+		else
+		{
+			ui64Alias = findAlias(sDevID);
+		}
+
 		// Create the root UDT definition and add the UDT definition value which includes the UDT members and parameters
 		org_eclipse_tahu_protobuf_Payload_Metric metric = org_eclipse_tahu_protobuf_Payload_Metric_init_default;
-		init_metric(&metric, orUniqueDev.get().getWellSiteDev().getID().c_str(), false, 0, METRIC_DATA_TYPE_TEMPLATE, false, false, &udt_template, sizeof(udt_template));
+		init_metric(&metric, ((true == a_bIsBirth) || (0 == ui64Alias)) ? sDevID.c_str() : NULL, (0 != ui64Alias), ui64Alias,
+				METRIC_DATA_TYPE_TEMPLATE, false, false, &udt_template, sizeof(udt_template));
 		metric.timestamp = get_current_timestamp();
 		metric.has_timestamp = true;
 
@@ -477,6 +511,88 @@ bool CSparkPlugDev::prepareModbusMessage(org_eclipse_tahu_protobuf_Payload& a_rT
 	return true;
 }
 
+/**
+ * Checks whether device birth message is to be published. Caller holds lock of metric list.
+ * @param a_bIsNBIRTHProcess: [in] indicates whether DBIRTH is needed as a part of NBIRTH process
+ * @return true if birth message is to be published, false otherwise
+ */
+bool CSparkPlugDev::isDBirthNeeded(bool a_bIsNBIRTHProcess)
+{
+	// Check if last known status of device is DOWN or not
+	if(enDEVSTATUS_DOWN == getLastKnownDevStatus())
+	{
+		DO_LOG_INFO(m_sSparkPlugName + ": Last known dev status is DOWN. DBIRTH message is not prepared.");
+		// Last know status is DOWN. Do NOT prepare a birth message
+		return false;
+	}
+	// Check whether this is node (re)birth scenario
+	if(false == a_bIsNBIRTHProcess)
+	{
+		// Following check should be done when DBIRTH is done as a part of device status and
+		// and not when node (re)birth is happening
+		// Check if last published status of device is UP or not
+		if(enDEVSTATUS_UP == getLastPublishedDevStatus())
+		{
+			DO_LOG_INFO(m_sSparkPlugName + ": Last published dev status is UP. DBIRTH message is not prepared.");
+			// Last know status is not UP. Do NOT prepare a birth message
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Adds all metrics of device to birth message. Caller holds lock of metric list.
+ * @param a_rTahuPayload :[out] reference of spark plug message payload in which to store birth messages
+ * @return None
+ */
+void CSparkPlugDev::addDBirthMetrics(org_eclipse_tahu_protobuf_Payload& a_rTahuPayload)
+{
+	if (true == std::holds_alternative<std::reference_wrapper<const network_info::CUniqueDataDevice>>(m_rDirectDevRef))
+	{
+		// For Modbus device
+		prepareModbusMessage(a_rTahuPayload, NULL, true);
+	}
+	else // For vendor app 
+	{
+		for(auto &itr: m_mapMetrics)
+		{
+			if(nullptr == itr.second)
+			{
+				continue;
+			}
+			uint64_t current_time = (itr.second)->getTimestamp();
+
+			// org_eclipse_tahu_protobuf_Payload_Metric : Fields
+			// char *name: NULL, 
+			// bool has_alias: false, uint64_t alias: 0
+			// bool has_timestamp: true, uint64_t timestamp: current_time
+			// bool has_datatype: true, uint32_t datatype: itr.second.getDataType()
+			// bool has_is_historical: false, bool is_historical: 0
+			// bool has_is_transient: false, bool is_transient: 0
+			// bool has_is_null: true, bool is_null: false
+			// bool has_metadata: false, org_eclipse_tahu_protobuf_Payload_MetaData metadata: default
+			// bool has_properties: false, org_eclipse_tahu_protobuf_Payload_PropertySet properties: default
+			// pb_size_t which_value: 0, value: {0}
+			org_eclipse_tahu_protobuf_Payload_Metric metric = {NULL, false, 0, true, current_time , true,
+					(itr.second)->getDataType(), false, 0, false, 0, false, true, false,
+					org_eclipse_tahu_protobuf_Payload_MetaData_init_default,
+					false, org_eclipse_tahu_protobuf_Payload_PropertySet_init_default, 0, {0}};
+
+			// Alias of metric is kept across rebirths
+			(itr.second)->setAlias((true == CCommon::getInstance().isMetricAliases()) ? assignAlias(itr.first) : 0);
+			if(true == (itr.second)->addMetricForBirth(metric))
+			{
+				add_metric_to_payload(&a_rTahuPayload, &metric);
+			}
+			else
+			{
+				DO_LOG_ERROR((itr.second)->getSparkPlugName() + ":Could not add metric to device. Trying to add other metrics.");
+			}
+		}
+	}
+}
+
 /**
  * Prepare device birth messages to be published on SCADA system
  * @param a_rTahuPayload :[out] reference of spark plug message payload in which to store birth messages
@@ -488,68 +604,61 @@ bool CSparkPlugDev::prepareDBirthMessage(org_eclipse_tahu_protobuf_Payload& a_rT
 	try
 	{
 		std::lock_guard<std::mutex> lck(m_mutexMetricList);
-		
-		// Check if last known status of device is DOWN or not
-		if(enDEVSTATUS_DOWN == getLastKnownDevStatus())
+		if(false == isDBirthNeeded(a_bIsNBIRTHProcess))
 		{
-			DO_LOG_INFO(m_sSparkPlugName + ": Last known dev status is DOWN. DBIRTH message is not prepared.");
-			// Last know status is DOWN. Do NOT prepare a birth message
 			return false;
 		}
-		// Check whether this is node (re)birth scenario
-		if(false == a_bIsNBIRTHProcess)
+		addDBirthMetrics(a_rTahuPayload);
+	}
+	catch(std::exception &ex)
+	{
+		DO_LOG_FATAL(ex.what());
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Gives encoded device birth message without payload timestamp and sequence number, which
+ * are added when message is queued for publishing. Encoded message is cached and encoded
+ * again only when a metric is added or value of a metric changes; DBIRTH carries current
+ * values of metrics.
+ * @param a_sEncoded :[out] encoded birth message
+ * @param a_bIsNBIRTHProcess: [in] indicates whether DBIRTH is needed as a part of NBIRTH process
+ * @return true/false depending on the success/failure
+ */
+bool CSparkPlugDev::encodeDBirthMessage(std::string &a_sEncoded, bool a_bIsNBIRTHProcess)
+{
+	try
+	{
+		std::lock_guard<std::mutex> lck(m_mutexMetricList);
+		if(false == isDBirthNeeded(a_bIsNBIRTHProcess))
 		{
-			// Following check should be done when DBIRTH is done as a part of device status and
-			// and not when node (re)birth is happening
-			// Check if last published status of device is UP or not
-			if(enDEVSTATUS_UP == getLastPublishedDevStatus())
-			{
-				DO_LOG_INFO(m_sSparkPlugName + ": Last published dev status is UP. DBIRTH message is not prepared.");
-				// Last know status is not UP. Do NOT prepare a birth message
-				return false;
-			}
+			return false;
 		}
-		if (true == std::holds_alternative<std::reference_wrapper<const network_info::CUniqueDataDevice>>(m_rDirectDevRef))
+
+		uint64_t ui64Version = m_oMetricTable.getVersion() + m_ui64MetricMapVersion;
+		if((true == m_bIsDBirthCached) && (ui64Version == m_ui64DBirthCacheVersion))
 		{
-			// For Modbus device
-			prepareModbusMessage(a_rTahuPayload, m_mapMetrics, true);
+			a_sEncoded = m_sDBirthCache;
+			return true;
 		}
-		else // For vendor app 
+
+		org_eclipse_tahu_protobuf_Payload oPayload = org_eclipse_tahu_protobuf_Payload_init_default;
+		addDBirthMetrics(oPayload);
+		bool bRet = CSparkplugEncodeArena::getThreadArena().encode(oPayload, m_sDBirthCache);
+		free_payload(&oPayload);
+		if(false == bRet)
 		{
-			for(auto &itr: m_mapMetrics)
-			{
-				if(nullptr == itr.second)
-				{
-					continue;
-				}
-				uint64_t current_time = (itr.second)->getTimestamp();
-
-				// org_eclipse_tahu_protobuf_Payload_Metric : Fields
-				// char *name: NULL, 
-				// bool has_alias: false, uint64_t alias: 0
-				// bool has_timestamp: true, uint64_t timestamp: current_time
-				// bool has_datatype: true, uint32_t datatype: itr.second.getDataType()
-				// bool has_is_historical: false, bool is_historical: 0
-				// bool has_is_transient: false, bool is_transient: 0
-				// bool has_is_null: true, bool is_null: false
-				// bool has_metadata: false, org_eclipse_tahu_protobuf_Payload_MetaData metadata: default
-				// bool has_properties: false, org_eclipse_tahu_protobuf_Payload_PropertySet properties: default
-				// pb_size_t which_value: 0, value: {0}
-				org_eclipse_tahu_protobuf_Payload_Metric metric = {NULL, false, 0, true, current_time , true,
-						(itr.second)->getDataType(), false, 0, false, 0, false, true, false,
-						org_eclipse_tahu_protobuf_Payload_MetaData_init_default,
-						false, org_eclipse_tahu_protobuf_Payload_PropertySet_init_default, 0, {0}};
-
-				if(true == (itr.second)->addMetricForBirth(metric))
-				{
-					add_metric_to_payload(&a_rTahuPayload, &metric);
-				}
-				else
-				{
-					DO_LOG_ERROR((itr.second)->getSparkPlugName() + ":Could not add metric to device. Trying to add other metrics.");
-				}
-			}
+			m_bIsDBirthCached = false;
+			DO_LOG_ERROR(m_sSparkPlugName + ": Failed to encode DBIRTH message");
+			return false;
 		}
+		// encode buffer is sized for largest message of thread; cache keeps only what it needs
+		m_sDBirthCache.shrink_to_fit();
+		m_bIsDBirthCached = true;
+		m_ui64DBirthCacheVersion = ui64Version;
+		a_sEncoded = m_sDBirthCache;
 	}
 	catch(std::exception &ex)
 	{
@@ -560,285 +669,273 @@ bool CSparkPlugDev::prepareDBirthMessage(org_eclipse_tahu_protobuf_Payload& a_rT
 }
 
 /**
- * Parses real device update message and stores metrics and corresponding values
- * @param a_sPayLoad :[in] payload containing metrics
- * @param a_sMetric :[out] stores value of "metric" key
- * @param a_sValue :[out] stores value of "value" key
- * @param a_sStatus :[out] stores value of "status" key
- * @param a_usec :[out] stores value of "usec" key
- * @param a_lastGoodUsec :[out] stores value of "lastGoodUsec" key
- * @param a_error_code :[out] stores value of "error_code" key
+ * Assigns sparkplug alias to a metric of device for birth message. A metric keeps the alias
+ * once assigned, so aliases do not change across rebirths. New alias is unique across edge node.
+ * @param a_sName :[in] metric name
+ * @return alias of metric
+ */
+uint64_t CSparkPlugDev::assignAlias(const std::string &a_sName)
+{
+	std::lock_guard<std::mutex> lck(m_mutexAliases);
+	auto itr = m_mapAliases.find(a_sName);
+	if(m_mapAliases.end() != itr)
+	{
+		return itr->second;
+	}
+	uint64_t ui64Alias = m_ui64NextAlias.fetch_add(1);
+	m_mapAliases.emplace(a_sName, ui64Alias);
+	m_mapAliasNames.emplace(ui64Alias, a_sName);
+	return ui64Alias;
+}
+
+/**
+ * Finds sparkplug alias of a metric of device, assigned in birth message
+ * @param a_sName :[in] metric name
+ * @return alias of metric; 0 if alias is not assigned
+ */
+uint64_t CSparkPlugDev::findAlias(const std::string &a_sName)
+{
+	std::lock_guard<std::mutex> lck(m_mutexAliases);
+	auto itr = m_mapAliases.find(a_sName);
+	if(m_mapAliases.end() != itr)
+	{
+		return itr->second;
+	}
+	return 0;
+}
+
+/**
+ * Resolves sparkplug alias of a metric of device to metric name
+ * @param a_ui64Alias :[in] alias of metric
+ * @param a_sName :[out] metric name
+ * @return true if alias is assigned to a metric of device, false otherwise
+ */
+bool CSparkPlugDev::resolveAlias(uint64_t a_ui64Alias, std::string &a_sName)
+{
+	std::lock_guard<std::mutex> lck(m_mutexAliases);
+	auto itr = m_mapAliasNames.find(a_ui64Alias);
+	if(m_mapAliasNames.end() != itr)
+	{
+		a_sName = itr->second;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Parses real device update message. Message is parsed once and its fields are read
+ * in a single pass over it, including scaled value which is converted later as per
+ * data type of metric.
+ * @param a_sPayLoad :[in] payload containing metric
+ * @param a_stUpdate :[out] fields read from payload
  * @return true or false based on success
  */
-bool CSparkPlugDev::parseRealDeviceUpdateMsg(const std::string &a_sPayLoad, 
-		std::string &a_sMetric, std::string &a_sValue, std::string &a_sStatus,
-		uint64_t &a_usec, uint64_t &a_lastGoodUsec, uint32_t &a_error_code)
+bool CSparkPlugDev::parseRealDeviceUpdateMsg(const std::string &a_sPayLoad, stRealDevUpdate &a_stUpdate)
 {
-	cJSON *pjRoot = NULL;
+	// Fields read from message
+	enum eField
+	{
+		enFIELD_METRIC = 0, enFIELD_STATUS, enFIELD_VALUE, enFIELD_USEC,
+		enFIELD_LASTGOODUSEC, enFIELD_ERRORCODE, enFIELD_SCALEDVALUE, enFIELD_MAX
+	};
+	static const char *arrFieldNames[enFIELD_MAX] = {"metric", "status", "value", "usec",
+			"lastGoodUsec", "error_code", "scaledValue"};
+
+	a_stUpdate = stRealDevUpdate{};
+
+	cJSON *pjRoot = cJSON_Parse(a_sPayLoad.c_str());
+	if (NULL == pjRoot)
+	{
+		DO_LOG_ERROR("Message received from MQTT could not be parsed in json format");
+		return false;
+	}
+
+	bool bRet = true;
 	try
 	{
-		// Set initial values
-		a_sMetric.clear();
-		a_sValue.clear();
-		a_sStatus.clear();
-		a_usec = a_lastGoodUsec = a_error_code = 0;
-
-		// Parse JSON file
-		pjRoot = cJSON_Parse(a_sPayLoad.c_str());
-		if (NULL == pjRoot)
+		// Single pass over fields of message; first occurrence of a field is used
+		cJSON *arrFields[enFIELD_MAX] = {NULL};
+		for(cJSON *pjItem = pjRoot->child; NULL != pjItem; pjItem = pjItem->next)
 		{
-			DO_LOG_ERROR("Message received from MQTT could not be parsed in json format");
-			return false;
+			if(NULL == pjItem->string)
+			{
+				continue;
+			}
+			for(int iField = 0; iField < enFIELD_MAX; ++iField)
+			{
+				if((NULL == arrFields[iField]) && (0 == strcasecmp(pjItem->string, arrFieldNames[iField])))
+				{
+					arrFields[iField] = pjItem;
+					break;
+				}
+			}
 		}
 
-		// Lambda to read a parameter from JSON
-		auto readFieldFromJSON = [](std::string &a_sFieldValue, std::string a_sFieldName, cJSON *a_cjRoot) -> bool
+		// Lambda to read a string field; false if field is missing or is not a string
+		auto readString = [&arrFields](eField a_eField, std::string &a_sFieldValue) -> bool
 		{
-			a_sFieldValue.clear();
-			if(NULL != a_cjRoot)
+			if(NULL == arrFields[a_eField])
 			{
-				cJSON *cjValue = cJSON_GetObjectItem(a_cjRoot, a_sFieldName.c_str());
-				if(cjValue == NULL)
-				{
-					DO_LOG_DEBUG(a_sFieldName + ": Field not found in input JSON");
-					return false;
-				}
-				else
-				{
-					char *pcValue = cJSON_GetStringValue(cjValue);
-					if (pcValue == NULL)
-					{
-						DO_LOG_ERROR("Invalid payload: No value found for field: " + a_sFieldName);
-						return false;
-					}
-					a_sFieldValue.assign(pcValue);
-				}
+				DO_LOG_DEBUG(std::string(arrFieldNames[a_eField]) + ": Field not found in input JSON");
+				return false;
+			}
+			char *pcValue = cJSON_GetStringValue(arrFields[a_eField]);
+			if (NULL == pcValue)
+			{
+				DO_LOG_ERROR("Invalid payload: No value found for field: " + std::string(arrFieldNames[a_eField]));
+				return false;
 			}
+			a_sFieldValue.assign(pcValue);
 			return true;
 		};
 
-		// Read metric
-		if(false == readFieldFromJSON(a_sMetric, "metric", pjRoot))
-		{
-			DO_LOG_ERROR("metric key not found in message: " + a_sPayLoad);
-			return false;
-		}
-
-		// Read status
-		if(false == readFieldFromJSON(a_sStatus, "status", pjRoot))
-		{
-			DO_LOG_ERROR("status key not found in message" + a_sPayLoad);
-			return false;
-		}
-	
-		// Read value
-		if(false == readFieldFromJSON(a_sValue, "value", pjRoot))
+		// Lambda to convert time in microseconds to milliseconds
+		auto usecToMsec = [](const std::string &a_sUsec) -> uint64_t
 		{
-			DO_LOG_ERROR("value key not found in message" + a_sPayLoad);
-			return false;
-		}
+			std::chrono::microseconds dur_micro(std::stoul(a_sUsec));
+			return std::chrono::duration_cast<std::chrono::milliseconds>(dur_micro).count();
+		};
 
-		std::string sTemp{""};
-		//timestamp is optional parameter
-		if(false == readFieldFromJSON(sTemp, "usec", pjRoot))
+		if((false == readString(enFIELD_METRIC, a_stUpdate.m_sMetric))
+				|| (false == readString(enFIELD_STATUS, a_stUpdate.m_sStatus))
+				|| (false == readString(enFIELD_VALUE, a_stUpdate.m_sValue)))
 		{
-			a_usec = get_current_timestamp();
+			DO_LOG_ERROR("metric, status or value key not found in message: " + a_sPayLoad);
+			bRet = false;
 		}
 		else
 		{
-			if(false == sTemp.empty())
+			std::string sTemp{""};
+			//timestamp is optional parameter
+			if((true == readString(enFIELD_USEC, sTemp)) && (false == sTemp.empty()))
 			{
-				std::chrono::microseconds dur_micro(std::stoul(sTemp));
-				std::chrono::milliseconds dur_milli = std::chrono::duration_cast<std::chrono::milliseconds>(dur_micro);
-				a_usec = dur_milli.count();
+				a_stUpdate.m_usec = usecToMsec(sTemp);
 			}
 			else
 			{
-				a_usec = get_current_timestamp();
+				a_stUpdate.m_usec = get_current_timestamp();
 			}
-		}
 
-		//lastGoodUsec is optional parameter
-		if(true == readFieldFromJSON(sTemp, "lastGoodUsec", pjRoot))
-		{
-			if(false == sTemp.empty())
+			//lastGoodUsec is optional parameter
+			if((true == readString(enFIELD_LASTGOODUSEC, sTemp)) && (false == sTemp.empty()))
 			{
-				std::chrono::microseconds dur_micro(std::stoul(sTemp));
-				std::chrono::milliseconds dur_milli = std::chrono::duration_cast<std::chrono::milliseconds>(dur_micro);
-				a_lastGoodUsec = dur_milli.count();
-			}			
-		}
+				a_stUpdate.m_lastGoodUsec = usecToMsec(sTemp);
+			}
 
-		//error_code is optional parameter
-		if(true == readFieldFromJSON(sTemp, "error_code", pjRoot))
-		{
-			if(false == sTemp.empty())
+			//error_code is optional parameter
+			if((true == readString(enFIELD_ERRORCODE, sTemp)) && (false == sTemp.empty()))
 			{
-				a_error_code = std::stoul(sTemp);
+				a_stUpdate.m_error_code = std::stoul(sTemp);
+			}
+
+			// scaledValue is converted as per data type of metric when metric is found
+			cJSON *pjScaled = arrFields[enFIELD_SCALEDVALUE];
+			if(NULL != pjScaled)
+			{
+				a_stUpdate.m_iScaledType = pjScaled->type & 0xFF;
+				if(1 == cJSON_IsNumber(pjScaled))
+				{
+					a_stUpdate.m_dScaledValue = pjScaled->valuedouble;
+				}
+				else if(1 == cJSON_IsString(pjScaled))
+				{
+					char *pcValue = cJSON_GetStringValue(pjScaled);
+					if(NULL != pcValue)
+					{
+						a_stUpdate.m_sScaledValue.assign(pcValue);
+					}
+				}
 			}
 		}
 	}
 	catch (std::exception &ex)
 	{
-		DO_LOG_FATAL(ex.what());
-	}
-
-	if (NULL != pjRoot)
-	{
-		cJSON_Delete(pjRoot);
+		DO_LOG_ERROR("Invalid field in message: " + std::string(ex.what()));
+		bRet = false;
 	}
 
-	return true;
+	cJSON_Delete(pjRoot);
+	return bRet;
 }
 
 /**
- * parseScaledValueRealDevices function will first parse scaled value field from JSON payload and compare the datatype of the scaledValue 
- * before assigning it to CValObj instance. This datatype and scaled value that is stored in CValObj instance is 
+ * getScaledValue function compares the datatype of the scaledValue read from payload with datatype
+ * of metric before assigning it to CValObj instance. This datatype and scaled value that is stored in CValObj instance is 
  * later used when metric parameters of tahu payload is initialized. Therafter, tahu payload is published to external mqtt.
- * @param a_sPayLoad :[in]  payload containing metrics
- * @param a_sMetric  :[in]  std::string &a_sMetric
+ * @param a_stUpdate :[in]  fields read from payload
+ * @param a_uiDataType :[in]  data type of metric
  * @param a_rValobj  :[out] CValObj &a_rValobj
  * @return true or false based on success
  */
-bool CSparkPlugDev::parseScaledValueRealDevices(const std::string &a_sPayLoad, std::string &a_sMetric, CValObj &a_rValobj)
+bool CSparkPlugDev::getScaledValue(const stRealDevUpdate &a_stUpdate, uint32_t a_uiDataType, CValObj &a_rValobj)
 {
-	cJSON *pjRoot = NULL;
-	//getDatatype of the datapoint
-	pjRoot = cJSON_Parse(a_sPayLoad.c_str());
-
-	// Below retVal flag is used to identify success/failure scenarios.
 	bool retVal = false;
-	if (NULL == pjRoot)
-	{
-		DO_LOG_ERROR("Message received from MQTT could not be parsed in json format");
-		return retVal;
-	}
+	bool bIsBool = ((cJSON_True == a_stUpdate.m_iScaledType) || (cJSON_False == a_stUpdate.m_iScaledType));
+	bool bIsNumber = (cJSON_Number == a_stUpdate.m_iScaledType);
+	double dValue = a_stUpdate.m_dScaledValue;
 
-	auto iter = m_mapMetrics.find(a_sMetric);
-	uint32_t tempYmlDataType = METRIC_DATA_TYPE_UNKNOWN;
-
-	if (m_mapMetrics.end() != iter)
+	if ((METRIC_DATA_TYPE_BOOLEAN == a_uiDataType) && (true == bIsBool))
 	{
-		if(nullptr == (iter->second))
-		{
-			DO_LOG_ERROR("Null value in Metric Data: " + a_sMetric);
-			retVal = false;
-		}
-		else 
-		{
-			tempYmlDataType = (iter->second)->getValue().getDataType();
-			retVal = true;
-		}
-	}
-	else
-	{
-		DO_LOG_ERROR("Metric Not found : " + a_sMetric);
-		retVal = false;
-	}
-        
-	// Check if metric data is null then delete allocated pjRoot and return.
-	// If metric data is not null then proceed for further actions.
-	if (retVal == false)
-	{
-		if (NULL != pjRoot)
-		{
-			cJSON_Delete(pjRoot);
-		}
-		
-		return retVal;
-	}
-
-	//readScaledValueFieldFromJSON
-	cJSON *cjValue = cJSON_GetObjectItem(pjRoot, "scaledValue");
-	if (NULL == cjValue)
-	{
-		DO_LOG_ERROR("scaledValue field not found in input json");
-		retVal = false;
-	}
-
-	// Check if scaledValue is missing in received json then delete allocated pjRoot and return.
-	// If scaledValue is present then proceed for further actions.
-	if (retVal == false)
-	{
-		if (NULL != pjRoot)
-		{
-			cJSON_Delete(pjRoot);
-		}
-		
-		return retVal;
-	}
-     
-	if ((METRIC_DATA_TYPE_BOOLEAN == tempYmlDataType) && (1 == cJSON_IsBool(cjValue)))
-	{
-		if (cJSON_IsTrue(cjValue))
-		{
-			CValObj oValtemp(METRIC_DATA_TYPE_BOOLEAN, true);
-			a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_BOOLEAN, oValtemp);
-		}
-		else
-		{
-			CValObj oValtemp(METRIC_DATA_TYPE_BOOLEAN, false);
-			a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_BOOLEAN, oValtemp);
-		}
+		CValObj oValtemp(METRIC_DATA_TYPE_BOOLEAN, (cJSON_True == a_stUpdate.m_iScaledType));
+		a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_BOOLEAN, oValtemp);
 		retVal = true;
 	}
-	else if (tempYmlDataType == METRIC_DATA_TYPE_UINT16 && (1 == cJSON_IsNumber(cjValue)))
+	else if (a_uiDataType == METRIC_DATA_TYPE_UINT16 && (true == bIsNumber))
 	{
-		if (cjValue->valuedouble < 0.0) {
+		if (dValue < 0.0) {
 			DO_LOG_ERROR("Negative value received for unsigned datatype uint16");
 			retVal = false;
 		}	
 		else
 		{
-		
-			CValObj oValtemp(METRIC_DATA_TYPE_UINT16, (uint16_t)cjValue->valuedouble);
+			CValObj oValtemp(METRIC_DATA_TYPE_UINT16, (uint16_t)dValue);
 			a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_UINT16, oValtemp);
 			retVal = true;
 		}
 	}
-	else if (tempYmlDataType == METRIC_DATA_TYPE_UINT32 && (1 == cJSON_IsNumber(cjValue)))
+	else if (a_uiDataType == METRIC_DATA_TYPE_UINT32 && (true == bIsNumber))
 	{
-		if (cjValue->valuedouble < 0.0) {
+		if (dValue < 0.0) {
 			DO_LOG_ERROR("Negative value received for unsigned datatype uint32");
 			retVal = false;
 		}
 		else 
 		{
-			CValObj oValtemp(METRIC_DATA_TYPE_UINT32, (uint32_t)cjValue->valuedouble);
+			CValObj oValtemp(METRIC_DATA_TYPE_UINT32, (uint32_t)dValue);
 			a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_UINT32, oValtemp);
 			retVal = true;
 		}
 	}
-	else if (tempYmlDataType == METRIC_DATA_TYPE_UINT64 && (1 == cJSON_IsNumber(cjValue)))
+	else if (a_uiDataType == METRIC_DATA_TYPE_UINT64 && (true == bIsNumber))
 	{
-		if (cjValue->valuedouble < 0.0) {
+		if (dValue < 0.0) {
 			DO_LOG_ERROR("Negative value received for unsigned datatype uint64");
 			retVal = false;
 		}
 		else
 		{
-			CValObj oValtemp(METRIC_DATA_TYPE_UINT64, (uint64_t)cjValue->valuedouble);
+			CValObj oValtemp(METRIC_DATA_TYPE_UINT64, (uint64_t)dValue);
 			a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_UINT64, oValtemp);
 			retVal = true;
 		}
 	}
-	else if (tempYmlDataType == METRIC_DATA_TYPE_INT16 && (1 == cJSON_IsNumber(cjValue)))
+	else if (a_uiDataType == METRIC_DATA_TYPE_INT16 && (true == bIsNumber))
 	{
-		CValObj oValtemp(METRIC_DATA_TYPE_INT16, (int16_t)cjValue->valuedouble);
+		CValObj oValtemp(METRIC_DATA_TYPE_INT16, (int16_t)dValue);
 		a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_INT16, oValtemp);
 		retVal = true;
 	}
-	else if (tempYmlDataType == METRIC_DATA_TYPE_INT32 && (1 == cJSON_IsNumber(cjValue)))
+	else if (a_uiDataType == METRIC_DATA_TYPE_INT32 && (true == bIsNumber))
 	{
-		CValObj oValtemp(METRIC_DATA_TYPE_INT32, (int32_t)cjValue->valuedouble);
+		CValObj oValtemp(METRIC_DATA_TYPE_INT32, (int32_t)dValue);
 		a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_INT32, oValtemp);
 		retVal = true;
 	}
-	else if (tempYmlDataType == METRIC_DATA_TYPE_INT64 && (1 == cJSON_IsNumber(cjValue)))
+	else if (a_uiDataType == METRIC_DATA_TYPE_INT64 && (true == bIsNumber))
 	{
-		int64_t i64 = static_cast<std::int64_t>(cjValue->valuedouble);
+		int64_t i64 = static_cast<std::int64_t>(dValue);
 		// Handle corner scenario of max value
-		if((i64 < 0) && (cjValue->valuedouble > 0.0))
+		if((i64 < 0) && (dValue > 0.0))
 		{
 			i64 = std::numeric_limits<int64_t>::max();
 		}
@@ -846,32 +943,22 @@ bool CSparkPlugDev::parseScaledValueRealDevices(const std::string &a_sPayLoad, s
 		a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_INT64, oValtemp);
 		retVal = true;
 	}
-	else if (tempYmlDataType == METRIC_DATA_TYPE_STRING && (1 == cJSON_IsString(cjValue)))
+	else if (a_uiDataType == METRIC_DATA_TYPE_STRING && (cJSON_String == a_stUpdate.m_iScaledType))
 	{
-		char *val = cJSON_GetStringValue(cjValue);
-		if (NULL == val) {
-			DO_LOG_ERROR("Cannot get String value from Json payload");
-			retVal = false;
-		}
-		else
-		{
-			std::string sTemp(val);
-			CValObj oValtemp(METRIC_DATA_TYPE_STRING, sTemp);
-			a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_STRING, oValtemp);
-			retVal = true;
-		}
+		CValObj oValtemp(METRIC_DATA_TYPE_STRING, a_stUpdate.m_sScaledValue);
+		a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_STRING, oValtemp);
+		retVal = true;
 	}
-	else if (tempYmlDataType == METRIC_DATA_TYPE_FLOAT && (1 == cJSON_IsNumber(cjValue)))
+	else if (a_uiDataType == METRIC_DATA_TYPE_FLOAT && (true == bIsNumber))
 	{
-		float fval = static_cast<float>(cjValue->valuedouble);
+		float fval = static_cast<float>(dValue);
 		CValObj oValtemp(METRIC_DATA_TYPE_FLOAT, fval);
 		a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_FLOAT, oValtemp);
 		retVal = true;
 	}
-	else if (tempYmlDataType == METRIC_DATA_TYPE_DOUBLE && (1 == cJSON_IsNumber(cjValue)))
+	else if (a_uiDataType == METRIC_DATA_TYPE_DOUBLE && (true == bIsNumber))
 	{
-		double dval = static_cast<double>(cjValue->valuedouble);
-		CValObj oValtemp(METRIC_DATA_TYPE_DOUBLE, dval);
+		CValObj oValtemp(METRIC_DATA_TYPE_DOUBLE, dValue);
 		a_rValobj.assignNewDataTypeValue(METRIC_DATA_TYPE_DOUBLE, oValtemp);
 		retVal = true;
 	}
@@ -879,32 +966,22 @@ bool CSparkPlugDev::parseScaledValueRealDevices(const std::string &a_sPayLoad, s
 	{
 		DO_LOG_ERROR(
 				"Invalid data type or mismatch found. Mentioned type in Yml file : "
-						+ std::to_string(tempYmlDataType) + ", Value datatype :"
-						+ std::to_string(cjValue->type));
+						+ std::to_string(a_uiDataType) + ", Value datatype :"
+						+ std::to_string(a_stUpdate.m_iScaledType));
 		retVal = false;
 	}
 
-	// Deallocate pjRoot
-	if (NULL != pjRoot)
-	{
-		cJSON_Delete(pjRoot);
-	}
-
 	return retVal;
 }
 
 /**
  * Validates data parsed from update message of a real device
- * @param a_sValue :[in] value of "value" key
- * @param a_sStatus :[in] value of "status" key
- * @param a_error_code :[in] value of "error_code" key
+ * @param a_stUpdate :[in] fields read from update message
  * @param a_bIsGood :[out] Indicates whether the status is good or bad
  * @param a_bIsDeathCode :[out] Indicates error code is for a device being unreachable
  * @return true or false based on success
  */
-bool CSparkPlugDev::validateRealDeviceUpdateData(
-		const std::string &a_sValue, std::string a_sStatus,
-		uint32_t a_error_code,
+bool CSparkPlugDev::validateRealDeviceUpdateData(const stRealDevUpdate &a_stUpdate,
 		bool &a_bIsGood, bool &a_bIsDeathCode)
 {
 	try
@@ -912,16 +989,15 @@ bool CSparkPlugDev::validateRealDeviceUpdateData(
 		// Check status
 		a_bIsGood = true;
 		a_bIsDeathCode = false;
-		std::transform(a_sStatus.begin(), a_sStatus.end(), a_sStatus.begin(), ::tolower);
-		if("good" != a_sStatus)
+		if(0 != strcasecmp("good", a_stUpdate.m_sStatus.c_str()))
 		{
-			if("bad" != a_sStatus)
+			if(0 != strcasecmp("bad", a_stUpdate.m_sStatus.c_str()))
 			{
 				DO_LOG_ERROR("Unknown status. Ignoring the message");
 				return false;
 			}
 			// Read error_code
-			if(0 == a_error_code)
+			if(0 == a_stUpdate.m_error_code)
 			{
 				DO_LOG_ERROR("Either error_code key not found or value is 0 in message with bad status. Ignoring the message");
 				return false;
@@ -939,7 +1015,7 @@ bool CSparkPlugDev::validateRealDeviceUpdateData(
 			// 2004	STACK_ERROR_SEND_FAILED
 			// 2005	STACK_ERROR_RECV_FAILED
 			// 2006	STACK_ERROR_RECV_TIMEOUT => This does not necessarily mean that device is not reachable.
-			switch(a_error_code)
+			switch(a_stUpdate.m_error_code)
 			{
 				case 2002:
 				case 2003:
@@ -955,12 +1031,19 @@ bool CSparkPlugDev::validateRealDeviceUpdateData(
 		else 
 		{
 			// Check if value is present. 
-			if(a_sValue.empty())
+			if(a_stUpdate.m_sValue.empty())
 			{
 				DO_LOG_ERROR("Value in string format is not present. Ignoring the message");
 				return false;
 			}
 		}
+
+		// scaled value is needed in all cases to compare with last known value
+		if(cJSON_Invalid == a_stUpdate.m_iScaledType)
+		{
+			DO_LOG_ERROR("scaledValue field not found in input json");
+			return false;
+		}
 	}
 	catch (std::exception &ex)
 	{
@@ -972,7 +1055,9 @@ bool CSparkPlugDev::validateRealDeviceUpdateData(
 }
 
 /**
- * Parses real device update message and stores metrics and corresponding values
+ * Parses real device update message and stores metrics and corresponding values.
+ * Message is parsed and validated before metric list is locked; only lookup of
+ * metric and update of its value are done under lock.
  * @param a_sPayLoad :[in] payload containing metrics
  * @param a_stRefActionVec :[out] action vector
  * @return map containing metric and corresponding values
@@ -981,12 +1066,9 @@ bool CSparkPlugDev::processRealDeviceUpdateMsg(const std::string a_sPayLoad, std
 {
 	try
 	{
-		std::string sMetric{""}, sValue{""}, sStatus{""};
-		uint64_t usec{0}, lastGoodUsec{0};
-		uint32_t error_code{0};
+		stRealDevUpdate stUpdate;
 		CValObj oValObj;
-		bool bRet = parseRealDeviceUpdateMsg(a_sPayLoad, 
-			sMetric, sValue, sStatus, usec, lastGoodUsec, error_code);
+		bool bRet = parseRealDeviceUpdateMsg(a_sPayLoad, stUpdate);
 		if(false == bRet)
 		{
 			DO_LOG_ERROR("Unable to parse message: " + a_sPayLoad);
@@ -998,33 +1080,26 @@ bool CSparkPlugDev::processRealDeviceUpdateMsg(const std::string a_sPayLoad, std
 		// Now validate these fields values
 
 		bool bIsGood = true, bDeathErrorCode = false;
-		bRet = validateRealDeviceUpdateData(sValue, sStatus, error_code, bIsGood, bDeathErrorCode);
+		bRet = validateRealDeviceUpdateData(stUpdate, bIsGood, bDeathErrorCode);
 		if(false == bRet)
 		{
-			DO_LOG_ERROR("Message validation failed: " + a_sPayLoad);
+			DO_LOG_ERROR_SAMPLED("Message validation failed", 100, "Message validation failed: " + a_sPayLoad);
 			return false;
 		}
 		
 		std::lock_guard<std::mutex> lck(m_mutexMetricList);
 		// Check if metric is a part of this device
-		auto itrMyMetric = m_mapMetrics.find(sMetric);
-		if (m_mapMetrics.end() == itrMyMetric)
-		{
-			DO_LOG_ERROR(sMetric + ": Metric not found in device: "
-						+ m_sSparkPlugName + ". Ignoring this metric data");
-			return false;
-		}
-		CMetric *pOtherMetric = dynamic_cast<CMetric*>(itrMyMetric->second.get());
-		if(nullptr == pOtherMetric)
+		const std::string &sMetric = stUpdate.m_sMetric;
+		uint32_t uiIndex = m_oMetricTable.findIndex(sMetric);
+		if (REAL_DEV_METRIC_INVALID_INDEX == uiIndex)
 		{
-			DO_LOG_ERROR(sMetric + ": Metric types do not match! : "
+			DO_LOG_ERROR_RATELIMITED("Metric not found", 10, 1000, sMetric + ": Metric not found in device: "
 						+ m_sSparkPlugName + ". Ignoring this metric data");
 			return false;
 		}
-		CMetric &refMyMetric = *pOtherMetric;
-		if ( false == parseScaledValueRealDevices(a_sPayLoad, sMetric, oValObj))
+		if ( false == getScaledValue(stUpdate, m_oMetricTable.getDataType(uiIndex), oValObj))
 		{
-			DO_LOG_ERROR("Error in parseScaledValueRealDevices. ");
+			DO_LOG_ERROR("Error in getScaledValue. ");
 			return false;
 		}
 
@@ -1046,26 +1121,24 @@ bool CSparkPlugDev::processRealDeviceUpdateMsg(const std::string a_sPayLoad, std
 		//		1. Now Good status => DBIRTH
 		//		2. Now Bad status => NO action
 		
-		auto uiValCompareResult = refMyMetric.getValue().compareValue(oValObj);
+		auto uiValCompareResult = m_oMetricTable.compareValue(uiIndex, oValObj);
 
 		// Lambda to read a parameter from JSON
 		auto addToActionVector = [&](eMsgAction a_eMsgAction) -> bool
 		{
-			metricMapIf_t mapChangedMetricsFromUpdate;
+			std::vector<stRealDevMetricSample> vecChangedSamples;
 			if((enMSG_DATA == a_eMsgAction) || (enMSG_BIRTH == a_eMsgAction))
 			{
-				refMyMetric.setValue(oValObj);
-				refMyMetric.setTimestamp(usec);
+				m_oMetricTable.setValue(uiIndex, oValObj);
+				m_oMetricTable.setTimestamp(uiIndex, stUpdate.m_usec);
 
 				if(enMSG_DATA == a_eMsgAction)
 				{
-					mapChangedMetricsFromUpdate.emplace((itrMyMetric->second)->getSparkPlugName(), (itrMyMetric->second));
+					vecChangedSamples.push_back(stRealDevMetricSample{uiIndex, stUpdate.m_usec, oValObj});
 				}
 			}
 			
-			stRefForSparkPlugAction stDummyAction
-				{ std::ref(*this), a_eMsgAction, mapChangedMetricsFromUpdate};
-				a_stRefActionVec.push_back(stDummyAction);
+			a_stRefActionVec.emplace_back(std::ref(*this), a_eMsgAction, metricMapIf_t{}, std::move(vecChangedSamples));
 			return true;
 		};
 		
@@ -1089,11 +1162,11 @@ bool CSparkPlugDev::processRealDeviceUpdateMsg(const std::string a_sPayLoad, std
 				// All other cases are ignored. No action
 
 				// Check lastgoodsec and value. Set it to be used for next DBIRTH message
-				if((0 != lastGoodUsec) && (VALUES_DIFFERENT == uiValCompareResult)
-						&& (false == sValue.empty()))
+				if((0 != stUpdate.m_lastGoodUsec) && (VALUES_DIFFERENT == uiValCompareResult)
+						&& (false == stUpdate.m_sValue.empty()))
 				{
-					refMyMetric.setTimestamp(lastGoodUsec);
-					refMyMetric.setValue(oValObj);
+					m_oMetricTable.setTimestamp(uiIndex, stUpdate.m_lastGoodUsec);
+					m_oMetricTable.setValue(uiIndex, oValObj);
 				}
 			}
 			
@@ -1103,7 +1176,7 @@ bool CSparkPlugDev::processRealDeviceUpdateMsg(const std::string a_sPayLoad, std
 			// Last report was: device is up
 			if(true == bIsGood)
 			{
-				refMyMetric.setTimestamp(usec);
+				m_oMetricTable.setTimestamp(uiIndex, stUpdate.m_usec);
 
 				if(VALUES_DIFFERENT == uiValCompareResult)
 				{
@@ -1114,13 +1187,13 @@ bool CSparkPlugDev::processRealDeviceUpdateMsg(const std::string a_sPayLoad, std
 			else if((false == bIsGood) && (true == bDeathErrorCode))
 			{
 				// Check lastgoodsec and value. 
-				if((0 != lastGoodUsec) && (VALUES_DIFFERENT == uiValCompareResult)
-					&& (false == sValue.empty()))
+				if((0 != stUpdate.m_lastGoodUsec) && (VALUES_DIFFERENT == uiValCompareResult)
+					&& (false == stUpdate.m_sValue.empty()))
 				{
 					// This case means there is some value which we did not have earlier.
 					// Set it to be used for next DBIRTH message
-					refMyMetric.setTimestamp(lastGoodUsec);
-					refMyMetric.setValue(oValObj);
+					m_oMetricTable.setTimestamp(uiIndex, stUpdate.m_lastGoodUsec);
+					m_oMetricTable.setValue(uiIndex, oValObj);
 				}
 				addToActionVector(enMSG_DEATH);
 				setKnownDevStatus(enDEVSTATUS_DOWN);
@@ -1129,8 +1202,8 @@ bool CSparkPlugDev::processRealDeviceUpdateMsg(const std::string a_sPayLoad, std
 			{
 				// All other cases are ignored. No action
 				// Check lastgoodsec and value. 
-				if((0 != lastGoodUsec) && (VALUES_DIFFERENT == uiValCompareResult)
-					&& (false == sValue.empty()))
+				if((0 != stUpdate.m_lastGoodUsec) && (VALUES_DIFFERENT == uiValCompareResult)
+					&& (false == stUpdate.m_sValue.empty()))
 				{
 					addToActionVector(enMSG_DATA);
 					setKnownDevStatus(enDEVSTATUS_UP);
@@ -1322,8 +1395,9 @@ bool CSparkPlugDev::prepareDdataMsg(org_eclipse_tahu_protobuf_Payload &a_payload
 
 		if (true == std::holds_alternative<std::reference_wrapper<const network_info::CUniqueDataDevice>>(m_rDirectDevRef))
 		{
-			// For Modbus device
-			bRet = prepareModbusMessage(a_payload, a_mapChangedMetrics, false);
+			// Changed metrics of Modbus device are given by index in metric table
+			DO_LOG_ERROR(m_sSparkPlugName + ": Metrics of Modbus device are not kept in metric map");
+			return false;
 		}
 		else // For vendor app 
 		{
@@ -1336,6 +1410,8 @@ bool CSparkPlugDev::prepareDdataMsg(org_eclipse_tahu_protobuf_Payload &a_payload
 				}
 				uint64_t timestamp = (itrMetric.second)->getTimestamp();
 				string strMetricName = (itrMetric.second)->getName();
+				// Metric given an alias in birth message is sent only with alias
+				(itrMetric.second)->setAlias(findAlias(itrMetric.first));
 
 				org_eclipse_tahu_protobuf_Payload_Metric metric =
 					{ NULL, false, 0, true, timestamp, true,
@@ -1363,3 +1439,26 @@ bool CSparkPlugDev::prepareDdataMsg(org_eclipse_tahu_protobuf_Payload &a_payload
 	}
 	return bRet;
 }
+
+/**
+ * Prepare a DDATA message in sparkplug format for a Modbus device
+ * @param a_payload :[out] sparkplug payload being created
+ * @param a_vecChangedSamples :[in] changed metrics, by index in metric table, for which ddata message to be created
+ * @return true/false based on success/failure
+ */
+bool CSparkPlugDev::prepareDdataMsg(org_eclipse_tahu_protobuf_Payload &a_payload, const std::vector<stRealDevMetricSample> &a_vecChangedSamples)
+{
+	try
+	{
+		if(true == a_vecChangedSamples.empty())
+		{
+			return false;
+		}
+		return prepareModbusMessage(a_payload, &a_vecChangedSamples, false);
+	}
+	catch(std::exception &ex)
+	{
+		DO_LOG_FATAL(ex.what());
+	}
+	return false;
+}
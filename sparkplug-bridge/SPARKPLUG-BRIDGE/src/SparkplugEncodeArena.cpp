@@ -0,0 +1,107 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <algorithm>
+#include <stdint.h>
+#include "SparkplugEncodeArena.hpp"
+#include "Logger.hpp"
+
+/**
+ * Constructor
+ * @param a_uiInitialSize :[in] size of first encode buffer
+ * @return None
+ */
+CSparkplugEncodeArena::CSparkplugEncodeArena(size_t a_uiInitialSize)
+	: m_uiHighWaterMark{a_uiInitialSize}, m_uiInitialSize{a_uiInitialSize}
+{
+	if(0 == m_uiInitialSize)
+	{
+		m_uiInitialSize = m_uiHighWaterMark = SPARKPLUG_ENCODE_INITIAL_SIZE;
+	}
+}
+
+/**
+ * Gets encode arena of calling thread
+ * @return reference of arena of calling thread
+ */
+CSparkplugEncodeArena& CSparkplugEncodeArena::getThreadArena()
+{
+	thread_local CSparkplugEncodeArena oArena;
+	return oArena;
+}
+
+/**
+ * Output stream callback which appends encoded bytes to a string
+ * @param a_pStream :[in] stream whose state is the string
+ * @param a_pBuf :[in] encoded bytes
+ * @param a_uiCount :[in] number of bytes
+ * @return true
+ */
+static bool appendToString(pb_ostream_t *a_pStream, const pb_byte_t *a_pBuf, size_t a_uiCount)
+{
+	static_cast<std::string *>(a_pStream->state)->append((const char *)a_pBuf, a_uiCount);
+	return true;
+}
+
+/**
+ * Encodes payload directly into string which is handed over to MQTT message. String is
+ * reserved at high water mark of this thread, so payload is encoded in a single pass,
+ * without sizing pass, zero fill or copy. Only a payload larger than high water mark
+ * makes string grow while encoding. High water mark decays when payloads get much smaller,
+ * e.g. after a large DBIRTH. A payload using less than a quarter of its string is shrunk
+ * to size, so small DDATA do not keep large buffers in flight.
+ * @param a_payload :[in] payload to encode
+ * @param a_sBuffer :[out] encoded payload
+ * @return true/false based on success/failure
+ */
+bool CSparkplugEncodeArena::encode(const org_eclipse_tahu_protobuf_Payload &a_payload, std::string &a_sBuffer)
+{
+	std::string sEncoded;
+	sEncoded.reserve(m_uiHighWaterMark);
+	pb_ostream_t stream = pb_ostream_from_buffer(NULL, 0);
+	stream.callback = &appendToString;
+	stream.state = &sEncoded;
+	stream.max_size = SIZE_MAX;
+	if(false == pb_encode(&stream, org_eclipse_tahu_protobuf_Payload_fields, &a_payload))
+	{
+		DO_LOG_ERROR(std::string("Failed to encode payload: ") + PB_GET_ERROR(&stream));
+		a_sBuffer.clear();
+		return false;
+	}
+
+	size_t uiSize = sEncoded.size();
+	if(uiSize > m_uiHighWaterMark)
+	{
+		++m_ui64GrowCount;
+		m_uiHighWaterMark = uiSize;
+	}
+	else if((uiSize * 4 < m_uiHighWaterMark) && (m_uiHighWaterMark > m_uiInitialSize))
+	{
+		m_uiHighWaterMark = std::max(m_uiHighWaterMark / 2, m_uiInitialSize);
+	}
+	if(uiSize * 4 < sEncoded.capacity())
+	{
+		sEncoded.shrink_to_fit();
+	}
+	a_sBuffer.swap(sEncoded);
+	return true;
+}
@@ -0,0 +1,330 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "SparkplugPublisher.hpp"
+#include "SparkplugEncodeArena.hpp"
+#include "Logger.hpp"
+extern "C"
+{
+#include <tahu.h>
+}
+
+/**
+ * Constructor
+ * @param a_fnPublish :[in] function to hand a message to MQTT client
+ * @param a_uiMaxQueued :[in] number of queued messages after which producers are blocked
+ * @param a_iQOS :[in] QOS of published messages
+ * @return None
+ */
+CSparkplugPublisher::CSparkplugPublisher(const sparkplug_publish_fn &a_fnPublish, size_t a_uiMaxQueued, int a_iQOS)
+	: m_fnPublish{a_fnPublish}, m_uiMaxQueued{a_uiMaxQueued}, m_iQOS{a_iQOS}
+{
+	if(0 == m_uiMaxQueued)
+	{
+		m_uiMaxQueued = 1;
+	}
+}
+
+/**
+ * Waits till there is space in queue. Caller holds enqueue lock.
+ * After session loss, messages other than NBIRTH are dropped till next NBIRTH.
+ * @param a_bIsNBirth :[in] tells whether message is NBIRTH
+ * @param a_sTopic :[in] topic of message
+ * @return true if message can be queued, false if it is dropped
+ */
+bool CSparkplugPublisher::waitForSpace(bool a_bIsNBirth, const std::string &a_sTopic)
+{
+	std::unique_lock<std::mutex> lck(m_mutexQueue);
+	m_cvNotFull.wait(lck, [&]() {
+		return (m_qMsgs.size() < m_uiMaxQueued) || (true == m_bStop.load())
+				|| ((false == a_bIsNBirth) && (true == m_bIsSuspended));
+	});
+	if((true == m_bStop.load()) || ((false == a_bIsNBirth) && (true == m_bIsSuspended)))
+	{
+		m_ui64Dropped.fetch_add(1);
+		DO_LOG_DEBUG("SCADA session is not established. Message is dropped: " + a_sTopic);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Queues a message which carries given sequence number. Caller holds enqueue lock.
+ * @param a_pMsg :[in] message to queue
+ * @param a_bIsNBirth :[in] tells whether message is NBIRTH
+ * @param a_uiSeq :[in] sequence number of message
+ * @return true if message is queued, false if session is lost meanwhile
+ */
+bool CSparkplugPublisher::pushMsg(const mqtt::message_ptr &a_pMsg, bool a_bIsNBirth, uint8_t a_uiSeq)
+{
+	{
+		std::lock_guard<std::mutex> lck(m_mutexQueue);
+		if(true == a_bIsNBirth)
+		{
+			m_bIsSuspended = false;
+		}
+		else if(true == m_bIsSuspended)
+		{
+			// session is lost while message was being encoded
+			m_ui64Dropped.fetch_add(1);
+			return false;
+		}
+		m_qMsgs.push_back(a_pMsg);
+		m_uiSeq = a_uiSeq;
+	}
+	m_cvNotEmpty.notify_one();
+	return true;
+}
+
+/**
+ * Assigns next sequence number to payload, encodes it and queues it for publishing.
+ * NBIRTH resets sequence number to 0; as sequence numbers are assigned and messages are
+ * queued under one lock, no message can be queued between NBIRTH and its reset.
+ * Caller is blocked while queue is full, which pushes back on processing of device data.
+ * After session loss, messages other than NBIRTH are dropped till next NBIRTH.
+ * @param a_payload :[in] payload to publish; its sequence number is set
+ * @param a_sTopic :[in] topic on which to publish
+ * @param a_bIsNBirth :[in] tells whether message is NBIRTH
+ * @param a_pEncodedLen :[out] if not null, set to size of encoded message
+ * @return true if message is queued, false otherwise
+ */
+bool CSparkplugPublisher::enqueue(org_eclipse_tahu_protobuf_Payload &a_payload, const std::string &a_sTopic,
+		bool a_bIsNBirth, size_t *a_pEncodedLen)
+{
+	std::lock_guard<std::mutex> lckEnqueue(m_mutexEnqueue);
+	if(false == waitForSpace(a_bIsNBirth, a_sTopic))
+	{
+		return false;
+	}
+
+	uint8_t uiSeq = (true == a_bIsNBirth) ? 0 : (uint8_t)(m_uiSeq + 1);
+	a_payload.has_seq = true;
+	a_payload.seq = uiSeq;
+
+	// Buffer is moved into the message; payload is not copied again.
+	std::string sEncodedMsg;
+	if(false == CSparkplugEncodeArena::getThreadArena().encode(a_payload, sEncodedMsg))
+	{
+		DO_LOG_ERROR("Failed to encode payload");
+		return false;
+	}
+	if(NULL != a_pEncodedLen)
+	{
+		*a_pEncodedLen = sEncodedMsg.size();
+	}
+	mqtt::message_ptr pMsg = mqtt::make_message(a_sTopic, std::move(sEncodedMsg), m_iQOS, false);
+	return pushMsg(pMsg, a_bIsNBirth, uiSeq);
+}
+
+/**
+ * Queues a payload which is already encoded without timestamp and sequence number, e.g. a
+ * cached DBIRTH. Such payloads are encoded by callers in parallel; only appending of current
+ * timestamp and next sequence number is done under enqueue lock. It is not used for NBIRTH.
+ * @param a_sEncoded :[in] encoded payload; moved into message
+ * @param a_sTopic :[in] topic on which to publish
+ * @param a_pEncodedLen :[out] if not null, set to size of encoded message
+ * @return true if message is queued, false otherwise
+ */
+bool CSparkplugPublisher::enqueueEncoded(std::string &a_sEncoded, const std::string &a_sTopic,
+		size_t *a_pEncodedLen)
+{
+	std::lock_guard<std::mutex> lckEnqueue(m_mutexEnqueue);
+	if(false == waitForSpace(false, a_sTopic))
+	{
+		return false;
+	}
+
+	uint8_t uiSeq = (uint8_t)(m_uiSeq + 1);
+	if(false == appendTimestampAndSeq(a_sEncoded, get_current_timestamp(), uiSeq))
+	{
+		DO_LOG_ERROR("Failed to encode payload");
+		return false;
+	}
+	if(NULL != a_pEncodedLen)
+	{
+		*a_pEncodedLen = a_sEncoded.size();
+	}
+	mqtt::message_ptr pMsg = mqtt::make_message(a_sTopic, std::move(a_sEncoded), m_iQOS, false);
+	return pushMsg(pMsg, false, uiSeq);
+}
+
+/**
+ * Appends timestamp and sequence number fields to an encoded payload which has none of them.
+ * Protobuf fields may come in any order, so encoded metrics are kept as they are.
+ * @param a_sEncoded :[in,out] encoded payload
+ * @param a_ui64Timestamp :[in] payload timestamp
+ * @param a_ui64Seq :[in] sequence number
+ * @return true/false based on success/failure
+ */
+bool CSparkplugPublisher::appendTimestampAndSeq(std::string &a_sEncoded, uint64_t a_ui64Timestamp, uint64_t a_ui64Seq)
+{
+	// a tag and a varint of up to 10 bytes for each field
+	pb_byte_t aBuffer[22];
+	pb_ostream_t stream = pb_ostream_from_buffer(aBuffer, sizeof(aBuffer));
+	if((false == pb_encode_tag(&stream, PB_WT_VARINT, org_eclipse_tahu_protobuf_Payload_timestamp_tag))
+			|| (false == pb_encode_varint(&stream, a_ui64Timestamp))
+			|| (false == pb_encode_tag(&stream, PB_WT_VARINT, org_eclipse_tahu_protobuf_Payload_seq_tag))
+			|| (false == pb_encode_varint(&stream, a_ui64Seq)))
+	{
+		return false;
+	}
+	a_sEncoded.append((const char *)aBuffer, stream.bytes_written);
+	return true;
+}
+
+/**
+ * Hands message at head of queue to MQTT client. Message leaves queue only after client
+ * has taken it, so a failed attempt is retried with the same message and later messages
+ * are never sent ahead of it. reset() waits till a message being handed is handed, so a
+ * message of lost session is never handed to client once reset() returns. Message is taken
+ * with generation of its session and leaves queue only if session is still same.
+ * @param a_uiRetryMs :[in,out] wait before next attempt; doubled on failure, 0 otherwise
+ * @return true if a message is published, false if queue is empty or attempt failed
+ */
+bool CSparkplugPublisher::publishNext(uint32_t &a_uiRetryMs)
+{
+	std::unique_lock<std::mutex> lckHandOver(m_mutexHandOver);
+	mqtt::message_ptr pMsg;
+	uint64_t ui64Session = 0;
+	{
+		std::lock_guard<std::mutex> lck(m_mutexQueue);
+		if(true == m_qMsgs.empty())
+		{
+			a_uiRetryMs = 0;
+			return false;
+		}
+		pMsg = m_qMsgs.front();
+		ui64Session = m_ui64Session;
+	}
+
+	bool bIsPublished = false;
+	try
+	{
+		bIsPublished = m_fnPublish(pMsg);
+	}
+	catch (const std::exception &e)
+	{
+		DO_LOG_ERROR(e.what());
+	}
+	lckHandOver.unlock();
+	if(false == bIsPublished)
+	{
+		m_ui64Retries.fetch_add(1);
+		a_uiRetryMs = (0 == a_uiRetryMs) ? SPARKPLUG_PUBLISH_RETRY_MIN_MS
+				: std::min<uint32_t>(a_uiRetryMs * 2, SPARKPLUG_PUBLISH_RETRY_MAX_MS);
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lck(m_mutexQueue);
+		// session may have been reset after message was handed
+		if((ui64Session == m_ui64Session) && (false == m_qMsgs.empty()) && (m_qMsgs.front() == pMsg))
+		{
+			m_qMsgs.pop_front();
+		}
+	}
+	m_cvNotFull.notify_one();
+	m_ui64Published.fetch_add(1);
+	a_uiRetryMs = 0;
+	return true;
+}
+
+/**
+ * Thread function to publish queued messages in order till stop() is called
+ * @return None
+ */
+void CSparkplugPublisher::run()
+{
+	uint32_t uiRetryMs = 0;
+	while(false == m_bStop.load())
+	{
+		try
+		{
+			{
+				std::unique_lock<std::mutex> lck(m_mutexQueue);
+				m_cvNotEmpty.wait_for(lck, std::chrono::milliseconds(SPARKPLUG_PUBLISH_RETRY_MAX_MS), [this]() {
+					return (false == m_qMsgs.empty()) || (true == m_bStop.load());
+				});
+			}
+			if((false == publishNext(uiRetryMs)) && (0 != uiRetryMs))
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(uiRetryMs));
+			}
+		}
+		catch (const std::exception &e)
+		{
+			DO_LOG_ERROR(e.what());
+		}
+	}
+}
+
+/**
+ * Drops queued messages when session with SCADA master is lost. Their sequence numbers
+ * belong to lost session; next NBIRTH starts a new sequence. Waits for a message being
+ * handed to client, which is bounded by wait of publish function.
+ * @return None
+ */
+void CSparkplugPublisher::reset()
+{
+	std::lock_guard<std::mutex> lckHandOver(m_mutexHandOver);
+	size_t uiDropped = 0;
+	{
+		std::lock_guard<std::mutex> lck(m_mutexQueue);
+		uiDropped = m_qMsgs.size();
+		m_qMsgs.clear();
+		m_bIsSuspended = true;
+		++m_ui64Session;
+	}
+	m_ui64Dropped.fetch_add(uiDropped);
+	m_cvNotFull.notify_all();
+	if(0 != uiDropped)
+	{
+		DO_LOG_INFO("SCADA session lost. Dropped queued messages: " + std::to_string(uiDropped));
+	}
+}
+
+/**
+ * Stops publisher thread and releases blocked producers
+ * @return None
+ */
+void CSparkplugPublisher::stop()
+{
+	{
+		std::lock_guard<std::mutex> lck(m_mutexQueue);
+		m_bStop.store(true);
+	}
+	m_cvNotEmpty.notify_all();
+	m_cvNotFull.notify_all();
+}
+
+/**
+ * Gets number of messages waiting to be published
+ * @return number of queued messages
+ */
+size_t CSparkplugPublisher::getQueuedCount()
+{
+	std::lock_guard<std::mutex> lck(m_mutexQueue);
+	return m_qMsgs.size();
+}
@@ -20,33 +20,54 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../Test/Src/AsyncLogWriter_ut.cpp \
 ../Test/Src/CConfigManager_ut.cpp \
 ../Test/Src/CommonDataShare_ut.cpp \
 ../Test/Src/EnvironmentVarHandler_ut.cpp \
 ../Test/Src/Logger_ut.cpp \
+../Test/Src/LogRateLimiter_ut.cpp \
 ../Test/Src/MQTTPubSubClient_ut.cpp \
 ../Test/Src/NetworkInfo_ut.cpp \
+../Test/Src/PayloadCodec_ut.cpp \
+../Test/Src/PersistentOutbox_ut.cpp \
 ../Test/Src/QueueHandler_ut.cpp \
+../Test/Src/RequestTTL_ut.cpp \
+../Test/Src/TimestampCarrier_ut.cpp \
+../Test/Src/TimeFormatter_ut.cpp \
 ../Test/Src/ZmqHandler_ut.cpp 
 
 OBJS += \
+./Test/Src/AsyncLogWriter_ut.o \
 ./Test/Src/CConfigManager_ut.o \
 ./Test/Src/CommonDataShare_ut.o \
 ./Test/Src/EnvironmentVarHandler_ut.o \
 ./Test/Src/Logger_ut.o \
+./Test/Src/LogRateLimiter_ut.o \
 ./Test/Src/MQTTPubSubClient_ut.o \
 ./Test/Src/NetworkInfo_ut.o \
+./Test/Src/PayloadCodec_ut.o \
+./Test/Src/PersistentOutbox_ut.o \
 ./Test/Src/QueueHandler_ut.o \
+./Test/Src/RequestTTL_ut.o \
+./Test/Src/TimestampCarrier_ut.o \
+./Test/Src/TimeFormatter_ut.o \
 ./Test/Src/ZmqHandler_ut.o 
 
 CPP_DEPS += \
+./Test/Src/AsyncLogWriter_ut.d \
 ./Test/Src/CConfigManager_ut.d \
 ./Test/Src/CommonDataShare_ut.d \
 ./Test/Src/EnvironmentVarHandler_ut.d \
 ./Test/Src/Logger_ut.d \
+./Test/Src/LogRateLimiter_ut.d \
 ./Test/Src/MQTTPubSubClient_ut.d \
 ./Test/Src/NetworkInfo_ut.d \
+./Test/Src/PayloadCodec_ut.d \
+./Test/Src/PersistentOutbox_ut.d \
 ./Test/Src/QueueHandler_ut.d \
+./Test/Src/RequestTTL_ut.d \
+./Test/Src/TimestampCarrier_ut.d \
+./Test/Src/TimeFormatter_ut.d \
 ./Test/Src/ZmqHandler_ut.d 
 
 
@@ -21,5 +21,5 @@
 
 USER_OBJS :=
 
-LIBS := -lgtest_main -lyaml-cpp -lgtest -llog4cpp -leiiconfigmanager -leiimsgenv -leiiutils -leiimsgbus -lyaml-cpp -lsafestring -lpaho-mqtt3a -lpaho-mqttpp3 -lpaho-mqtt3c -lpthread -lcjson -lrt
+LIBS := -lgtest_main -lyaml-cpp -lgtest -llog4cpp -leiiconfigmanager -leiimsgenv -leiiutils -leiimsgbus -lyaml-cpp -lsafestring -lpaho-mqtt3a -lpaho-mqttpp3 -lpaho-mqtt3c -lpthread -lcjson -lzstd -lrt
 
@@ -20,5 +20,5 @@
 
 USER_OBJS :=
 
-LIBS := -lcjson -lssl -lcrypto -llog4cpp -lyaml-cpp -lpaho-mqttpp3 -lpthread -leiiconfigmanager -leiimsgenv -leiimsgbus -leiiutils -lpaho-mqtt3as
+LIBS := -lcjson -lssl -lcrypto -llog4cpp -lyaml-cpp -lpaho-mqttpp3 -lpthread -leiiconfigmanager -leiimsgenv -leiimsgbus -leiiutils -lpaho-mqtt3as -lzstd
 
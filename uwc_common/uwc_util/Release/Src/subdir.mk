@@ -21,35 +21,56 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../Src/AsyncLogWriter.cpp \
 ../Src/CommonDataShare.cpp \
 ../Src/ConfigManager.cpp \
 ../Src/EnvironmentVarHandler.cpp \
 ../Src/Logger.cpp \
+../Src/LogRateLimiter.cpp \
 ../Src/MQTTPubSubClient.cpp \
 ../Src/NetworkInfo.cpp \
+../Src/PayloadCodec.cpp \
+../Src/PersistentOutbox.cpp \
 ../Src/QueueHandler.cpp \
+../Src/RequestTTL.cpp \
+../Src/TimestampCarrier.cpp \
+../Src/TimeFormatter.cpp \
 ../Src/YamlUtil.cpp \
 ../Src/ZmqHandler.cpp 
 
 OBJS += \
+./Src/AsyncLogWriter.o \
 ./Src/CommonDataShare.o \
 ./Src/ConfigManager.o \
 ./Src/EnvironmentVarHandler.o \
 ./Src/Logger.o \
+./Src/LogRateLimiter.o \
 ./Src/MQTTPubSubClient.o \
 ./Src/NetworkInfo.o \
+./Src/PayloadCodec.o \
+./Src/PersistentOutbox.o \
 ./Src/QueueHandler.o \
+./Src/RequestTTL.o \
+./Src/TimestampCarrier.o \
+./Src/TimeFormatter.o \
 ./Src/YamlUtil.o \
 ./Src/ZmqHandler.o 
 
 CPP_DEPS += \
+./Src/AsyncLogWriter.d \
 ./Src/CommonDataShare.d \
 ./Src/ConfigManager.d \
 ./Src/EnvironmentVarHandler.d \
 ./Src/Logger.d \
+./Src/LogRateLimiter.d \
 ./Src/MQTTPubSubClient.d \
 ./Src/NetworkInfo.d \
+./Src/PayloadCodec.d \
+./Src/PersistentOutbox.d \
 ./Src/QueueHandler.d \
+./Src/RequestTTL.d \
+./Src/TimestampCarrier.d \
+./Src/TimeFormatter.d \
 ./Src/YamlUtil.d \
 ./Src/ZmqHandler.d 
 
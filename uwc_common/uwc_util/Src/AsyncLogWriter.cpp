@@ -0,0 +1,584 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "AsyncLogWriter.hpp"
+#include "LogRateLimiter.hpp"
+#include <log4cpp/Category.hh>
+#include <log4cpp/LoggingEvent.hh>
+#include <log4cpp/TimeStamp.hh>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <iostream>
+
+/** Records are stored in multiples of this unit; header occupies the first unit */
+static const size_t LOG_RECORD_UNIT = 32;
+static_assert(sizeof(stLogRecordHdr) <= LOG_RECORD_UNIT, "log record header does not fit in record unit");
+
+/** Minimum size of ring buffer in bytes */
+static const size_t LOG_RING_MIN_SIZE = 4096;
+
+/** Signals on which pending log records are written before process terminates */
+static const int g_aiCrashSignals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGILL, SIGFPE};
+
+/** Ring buffers read by crash handler; registered without lock so that handler needs none */
+static std::atomic<CLogRing*> g_apCrashRings[ASYNC_LOG_MAX_CRASH_RINGS];
+/** File descriptor opened when crash handler is installed, to which handler writes */
+static std::atomic<int> g_iCrashFd{-1};
+
+/**
+ * Signal handler to write pending log records before process terminates. It is
+ * async-signal-safe: records are written with write(2) only, without taking locks
+ * or allocating. Handler is reset to default on entry, so signal is raised again after writing.
+ * @param a_iSignal :[in] signal number
+ * @return None
+ */
+static void asyncLogCrashHandler(int a_iSignal)
+{
+	int iFd = g_iCrashFd.load();
+	if(-1 != iFd)
+	{
+		for(auto &pRingSlot : g_apCrashRings)
+		{
+			CLogRing *pRing = pRingSlot.load();
+			if(NULL != pRing)
+			{
+				pRing->writeToFd(iFd);
+			}
+		}
+	}
+	raise(a_iSignal);
+}
+
+/**
+ * Writes a decimal number with write(2); used where snprintf() is not allowed
+ * @param a_iFd :[in] file descriptor
+ * @param a_ui64Val :[in] number
+ * @return None
+ */
+static void writeNumber(int a_iFd, uint64_t a_ui64Val)
+{
+	char acDigits[24];
+	size_t uiPos = sizeof(acDigits);
+	do
+	{
+		acDigits[--uiPos] = static_cast<char>('0' + (a_ui64Val % 10));
+		a_ui64Val /= 10;
+	} while(0 != a_ui64Val);
+	ssize_t iRet = write(a_iFd, acDigits + uiPos, sizeof(acDigits) - uiPos);
+	(void)iRet;
+}
+
+/**
+ * Writes a string with write(2)
+ * @param a_iFd :[in] file descriptor
+ * @param a_pcStr :[in] string
+ * @param a_uiLen :[in] length of string
+ * @return None
+ */
+static void writeString(int a_iFd, const char *a_pcStr, size_t a_uiLen)
+{
+	ssize_t iRet = write(a_iFd, a_pcStr, a_uiLen);
+	(void)iRet;
+}
+
+/**
+ * Constructor: allocates ring buffer
+ * @param a_uiCapacity :[in] requested size in bytes; rounded up to power of 2
+ */
+CLogRing::CLogRing(size_t a_uiCapacity)
+	: m_uiHead{0}, m_uiTail{0}, m_bIsOwnerAlive{true}
+{
+	m_uiCapacity = LOG_RING_MIN_SIZE;
+	while(m_uiCapacity < a_uiCapacity)
+	{
+		m_uiCapacity <<= 1;
+	}
+	m_uiMask = m_uiCapacity - 1;
+	// keep a single record well below buffer size so that other records still fit
+	m_uiMaxMsgLen = (m_uiCapacity / 4) - LOG_RECORD_UNIT;
+	m_pcBuffer.reset(new char[m_uiCapacity]);
+}
+
+/**
+ * Get number of bytes a record occupies in buffer
+ * @param a_uiMsgLen :[in] message length
+ * @return record size in bytes
+ */
+size_t CLogRing::recordSize(size_t a_uiMsgLen) const
+{
+	return ((LOG_RECORD_UNIT + a_uiMsgLen + LOG_RECORD_UNIT - 1) / LOG_RECORD_UNIT) * LOG_RECORD_UNIT;
+}
+
+/**
+ * Copies a log record in ring buffer. Called only from owner thread of this ring.
+ * @param a_stSite :[in] call site of log statement
+ * @param a_stTs :[in] time of log statement
+ * @param a_pcMsg :[in] message text
+ * @param a_uiLen :[in] message length
+ * @return true if record is stored, false if buffer is full
+ */
+bool CLogRing::push(const stLogSite &a_stSite, const struct timespec &a_stTs,
+		const char *a_pcMsg, size_t a_uiLen)
+{
+	uint32_t uiIsTruncated = 0;
+	if(a_uiLen > m_uiMaxMsgLen)
+	{
+		a_uiLen = m_uiMaxMsgLen;
+		uiIsTruncated = 1;
+	}
+
+	const size_t uiRecSize = recordSize(a_uiLen);
+	size_t uiHead = m_uiHead.load(std::memory_order_relaxed);
+	const size_t uiTail = m_uiTail.load(std::memory_order_acquire);
+	size_t uiOffset = uiHead & m_uiMask;
+	const size_t uiContig = m_uiCapacity - uiOffset;
+
+	// record is never split; remaining bytes at end of buffer are skipped
+	const size_t uiPad = (uiContig < uiRecSize) ? uiContig : 0;
+	if((m_uiCapacity - (uiHead - uiTail)) < (uiPad + uiRecSize))
+	{
+		return false;
+	}
+
+	if(0 != uiPad)
+	{
+		stLogRecordHdr stPad;
+		memset(&stPad, 0, sizeof(stPad));
+		stPad.m_pSite = NULL;
+		stPad.m_uiLen = static_cast<uint32_t>(uiPad);
+		memcpy(m_pcBuffer.get() + uiOffset, &stPad, sizeof(stPad));
+		uiHead += uiPad;
+		uiOffset = 0;
+	}
+
+	stLogRecordHdr stHdr;
+	stHdr.m_pSite = &a_stSite;
+	stHdr.m_stTs = a_stTs;
+	stHdr.m_uiLen = static_cast<uint32_t>(a_uiLen);
+	stHdr.m_uiIsTruncated = uiIsTruncated;
+	memcpy(m_pcBuffer.get() + uiOffset, &stHdr, sizeof(stHdr));
+	memcpy(m_pcBuffer.get() + uiOffset + LOG_RECORD_UNIT, a_pcMsg, a_uiLen);
+
+	m_uiHead.store(uiHead + uiRecSize, std::memory_order_release);
+	return true;
+}
+
+/**
+ * Reads all available records from ring buffer. Called only by one consumer at a time.
+ * @param a_fcbRecord :[in] function to be called for each record
+ * @return number of records read
+ */
+size_t CLogRing::drain(const std::function<void(const stLogRecordHdr&, const char*)> &a_fcbRecord)
+{
+	size_t uiCount = 0;
+	size_t uiTail = m_uiTail.load(std::memory_order_relaxed);
+	const size_t uiHead = m_uiHead.load(std::memory_order_acquire);
+
+	while(uiTail != uiHead)
+	{
+		const char *pcRecord = m_pcBuffer.get() + (uiTail & m_uiMask);
+		stLogRecordHdr stHdr;
+		memcpy(&stHdr, pcRecord, sizeof(stHdr));
+		if(NULL == stHdr.m_pSite)
+		{
+			// padding at end of buffer
+			uiTail += stHdr.m_uiLen;
+			continue;
+		}
+		a_fcbRecord(stHdr, pcRecord + LOG_RECORD_UNIT);
+		uiTail += recordSize(stHdr.m_uiLen);
+		m_uiTail.store(uiTail, std::memory_order_release);
+		++uiCount;
+	}
+	m_uiTail.store(uiTail, std::memory_order_release);
+	return uiCount;
+}
+
+/**
+ * Writes records not yet drained to a file descriptor without consuming them. Used by
+ * crash handler: it only calls write(2), does not allocate and does not update read position.
+ * @param a_iFd :[in] file descriptor
+ * @return None
+ */
+void CLogRing::writeToFd(int a_iFd) const
+{
+	size_t uiTail = m_uiTail.load(std::memory_order_acquire);
+	const size_t uiHead = m_uiHead.load(std::memory_order_acquire);
+
+	while(uiTail != uiHead)
+	{
+		const char *pcRecord = m_pcBuffer.get() + (uiTail & m_uiMask);
+		stLogRecordHdr stHdr;
+		memcpy(&stHdr, pcRecord, sizeof(stHdr));
+		if(NULL == stHdr.m_pSite)
+		{
+			uiTail += stHdr.m_uiLen;
+			continue;
+		}
+		const stLogSite &stSite = *stHdr.m_pSite;
+		writeNumber(a_iFd, static_cast<uint64_t>(stHdr.m_stTs.tv_sec));
+		writeString(a_iFd, " [ ", 3);
+		writeString(a_iFd, stSite.m_pcFile, strlen(stSite.m_pcFile));
+		writeString(a_iFd, " ", 1);
+		writeString(a_iFd, stSite.m_pcFunc, strlen(stSite.m_pcFunc));
+		writeString(a_iFd, " ", 1);
+		writeNumber(a_iFd, static_cast<uint64_t>(stSite.m_iLine));
+		writeString(a_iFd, "] ", 2);
+		writeString(a_iFd, pcRecord + LOG_RECORD_UNIT, stHdr.m_uiLen);
+		writeString(a_iFd, "\n", 1);
+		uiTail += recordSize(stHdr.m_uiLen);
+	}
+}
+
+/**
+ * Constructor Initializes common variables
+ * @param None
+ * @return None
+ */
+CAsyncLogWriter::CAsyncLogWriter()
+	: m_pLogger{NULL}, m_uiBufferSize{ASYNC_LOG_DEFAULT_BUFFER_SIZE}, m_bIsRunning{false},
+	  m_bStop{false}, m_uiOverflowCount{0}, m_uiReportedOverflow{0}
+{
+}
+
+/**
+ * Destructor: writes pending records and stops writer thread
+ */
+CAsyncLogWriter::~CAsyncLogWriter()
+{
+	stop();
+}
+
+/**
+ * Function for singleton instance.
+ * @param None
+ * @return singleton instance of async log writer
+ */
+CAsyncLogWriter& CAsyncLogWriter::getInstance()
+{
+	static CAsyncLogWriter _self;
+	return _self;
+}
+
+/**
+ * Starts writer thread
+ * @param a_pLogger :[in] log4cpp category to write records to
+ * @param a_uiBufferSize :[in] size of ring buffer for each logging thread
+ * @return true on success, false if already running or category is not set
+ */
+bool CAsyncLogWriter::start(log4cpp::Category *a_pLogger, size_t a_uiBufferSize)
+{
+	if((NULL == a_pLogger) || (true == m_bIsRunning.load()))
+	{
+		return false;
+	}
+	m_pLogger = a_pLogger;
+	m_uiBufferSize = a_uiBufferSize;
+	m_bStop.store(false);
+	try
+	{
+		m_thWriter = std::thread(&CAsyncLogWriter::writerThread, this);
+	}
+	catch(std::exception &ex)
+	{
+		std::cout << "Could not start async log writer: " << ex.what() << std::endl;
+		return false;
+	}
+	m_bIsRunning.store(true, std::memory_order_release);
+	return true;
+}
+
+/**
+ * Stops writer thread after writing all pending records and counts of suppressed statements.
+ * Statements logged after this are written synchronously by CLogger.
+ * @param None
+ * @return None
+ */
+void CAsyncLogWriter::stop()
+{
+	if(false == m_bIsRunning.exchange(false))
+	{
+		return;
+	}
+	m_bStop.store(true);
+	m_cvWait.notify_one();
+	if(m_thWriter.joinable())
+	{
+		m_thWriter.join();
+	}
+	flush();
+	reportSuppressed();
+}
+
+/**
+ * Get ring buffer of calling thread. Ring is created and registered on first use.
+ * @param None
+ * @return ring buffer of calling thread
+ */
+CLogRing* CAsyncLogWriter::getThreadRing()
+{
+	/** marks ring as orphaned when thread exits so that writer can release it */
+	struct stRingHolder
+	{
+		std::shared_ptr<CLogRing> m_pRing;
+		~stRingHolder()
+		{
+			if(m_pRing)
+			{
+				m_pRing->setOwnerExited();
+			}
+		}
+	};
+	static thread_local stRingHolder t_stHolder;
+
+	if(!t_stHolder.m_pRing)
+	{
+		std::shared_ptr<CLogRing> pRing = std::make_shared<CLogRing>(m_uiBufferSize);
+		{
+			std::lock_guard<std::mutex> lock(m_mutexRings);
+			m_vRings.push_back(pRing);
+		}
+		// crash handler reads rings from a fixed table; rings beyond its size are not written on crash
+		for(auto &pRingSlot : g_apCrashRings)
+		{
+			CLogRing *pEmpty = NULL;
+			if(pRingSlot.compare_exchange_strong(pEmpty, pRing.get()))
+			{
+				break;
+			}
+		}
+		t_stHolder.m_pRing = pRing;
+	}
+	return t_stHolder.m_pRing.get();
+}
+
+/**
+ * Posts a log statement to writer thread. Does not block and does not do any I/O.
+ * @param a_stSite :[in] call site of log statement
+ * @param a_sMsg :[in] message text
+ * @return true if statement is handled (stored or counted as overflow),
+ * 			false if writer is not running and caller should log synchronously
+ */
+bool CAsyncLogWriter::post(const stLogSite &a_stSite, const std::string &a_sMsg)
+{
+	if(false == isRunning())
+	{
+		return false;
+	}
+	struct timespec stTs;
+	clock_gettime(CLOCK_REALTIME, &stTs);
+
+	CLogRing *pRing = getThreadRing();
+	if(false == pRing->push(a_stSite, stTs, a_sMsg.data(), a_sMsg.size()))
+	{
+		m_uiOverflowCount.fetch_add(1, std::memory_order_relaxed);
+		m_cvWait.notify_one();
+		return true;
+	}
+	if(true == pRing->isHalfFull())
+	{
+		m_cvWait.notify_one();
+	}
+	return true;
+}
+
+/**
+ * Formats a record and writes it to log4cpp appenders with time at which it was logged
+ * @param a_stHdr :[in] record header
+ * @param a_pcMsg :[in] message text
+ * @return None
+ */
+void CAsyncLogWriter::writeRecord(const stLogRecordHdr &a_stHdr, const char *a_pcMsg)
+{
+	const stLogSite &stSite = *a_stHdr.m_pSite;
+	std::string sMsg;
+	sMsg.reserve(a_stHdr.m_uiLen + 128);
+	sMsg.append("[ ").append(stSite.m_pcFile).append(" ").append(stSite.m_pcFunc)
+		.append(" ").append(std::to_string(stSite.m_iLine)).append("] ")
+		.append(a_pcMsg, a_stHdr.m_uiLen);
+	if(0 != a_stHdr.m_uiIsTruncated)
+	{
+		sMsg.append(" ...(truncated)");
+	}
+
+	log4cpp::LoggingEvent event(m_pLogger->getName(), sMsg, "", stSite.m_iPriority);
+	event.timeStamp = log4cpp::TimeStamp(static_cast<unsigned int>(a_stHdr.m_stTs.tv_sec),
+			static_cast<unsigned int>(a_stHdr.m_stTs.tv_nsec / 1000));
+	m_pLogger->callAppenders(event);
+}
+
+/**
+ * Logs number of records dropped since last report
+ * @param None
+ * @return None
+ */
+void CAsyncLogWriter::reportOverflow()
+{
+	uint64_t uiCount = m_uiOverflowCount.load(std::memory_order_relaxed);
+	if(uiCount != m_uiReportedOverflow)
+	{
+		m_pLogger->warn("Async logger dropped " + std::to_string(uiCount - m_uiReportedOverflow) +
+				" log messages as buffer was full. Total dropped: " + std::to_string(uiCount));
+		m_uiReportedOverflow = uiCount;
+	}
+}
+
+/**
+ * Logs count of statements suppressed by rate limited and sampled log statements which
+ * is not yet reported, so that it is logged even if call site is not reached again
+ * @param None
+ * @return None
+ */
+void CAsyncLogWriter::reportSuppressed()
+{
+	CLogSuppressedCount::reportPending([this](const stLogSite &a_stSite, const char *a_pcKey, uint64_t a_uiCount)
+	{
+		std::string sMsg = std::string(a_pcKey) + ": suppressed " + std::to_string(a_uiCount) + " similar messages";
+		stLogRecordHdr stHdr;
+		stHdr.m_pSite = &a_stSite;
+		clock_gettime(CLOCK_REALTIME, &stHdr.m_stTs);
+		stHdr.m_uiLen = static_cast<uint32_t>(sMsg.size());
+		stHdr.m_uiIsTruncated = 0;
+		writeRecord(stHdr, sMsg.c_str());
+	});
+}
+
+/**
+ * Writes all pending records of all threads
+ * @param None
+ * @return true if records are written, false if writer is not configured
+ */
+bool CAsyncLogWriter::flush()
+{
+	if(NULL == m_pLogger)
+	{
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lockDrain(m_mutexDrain);
+	std::unique_lock<std::mutex> lockRings(m_mutexRings);
+	std::vector<std::shared_ptr<CLogRing>> vRings(m_vRings);
+	lockRings.unlock();
+
+	bool bIsAnyOrphan = false;
+	for(auto &pRing : vRings)
+	{
+		try
+		{
+			pRing->drain(std::bind(&CAsyncLogWriter::writeRecord, this,
+					std::placeholders::_1, std::placeholders::_2));
+		}
+		catch(std::exception &ex)
+		{
+			std::cout << "Exception in async log writer: " << ex.what() << std::endl;
+		}
+		if(false == pRing->isOwnerAlive())
+		{
+			bIsAnyOrphan = true;
+		}
+	}
+	reportOverflow();
+
+	if(bIsAnyOrphan)
+	{
+		// release rings of exited threads once they are drained
+		lockRings.lock();
+		for(auto itr = m_vRings.begin(); itr != m_vRings.end();)
+		{
+			if((false == (*itr)->isOwnerAlive()) && (*itr)->isEmpty())
+			{
+				for(auto &pRingSlot : g_apCrashRings)
+				{
+					CLogRing *pRing = itr->get();
+					if(pRingSlot.compare_exchange_strong(pRing, NULL))
+					{
+						break;
+					}
+				}
+				itr = m_vRings.erase(itr);
+			}
+			else
+			{
+				++itr;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Thread function which periodically writes pending records and counts of suppressed statements
+ * @param None
+ * @return None
+ */
+void CAsyncLogWriter::writerThread()
+{
+	auto tsLastReport = std::chrono::steady_clock::now();
+	while(false == m_bStop.load())
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutexWait);
+			m_cvWait.wait_for(lock, std::chrono::milliseconds(ASYNC_LOG_FLUSH_INTERVAL_MS));
+		}
+		flush();
+
+		auto tsNow = std::chrono::steady_clock::now();
+		if(tsNow - tsLastReport >= std::chrono::milliseconds(ASYNC_LOG_SUPPRESSED_REPORT_INTERVAL_MS))
+		{
+			tsLastReport = tsNow;
+			reportSuppressed();
+		}
+	}
+}
+
+/**
+ * Installs handler for fatal signals so that pending records are written before process terminates.
+ * Handler cannot use log4cpp appenders safely, so records are written to a file descriptor
+ * opened here.
+ * @param a_iFd :[in] file descriptor to write pending records to on crash; -1 (default) uses
+ * a duplicate of standard error
+ * @return None
+ */
+void CAsyncLogWriter::installCrashHandler(int a_iFd)
+{
+	if(-1 == a_iFd)
+	{
+		a_iFd = dup(STDERR_FILENO);
+	}
+	g_iCrashFd.store(a_iFd);
+
+	struct sigaction stAction;
+	memset(&stAction, 0, sizeof(stAction));
+	stAction.sa_handler = asyncLogCrashHandler;
+	sigemptyset(&stAction.sa_mask);
+	// restore default action on entry so that raise() in handler terminates the process
+	stAction.sa_flags = SA_RESETHAND;
+	for(int iSignal : g_aiCrashSignals)
+	{
+		if(0 != sigaction(iSignal, &stAction, NULL))
+		{
+			std::cout << "Could not install log flush handler for signal " << iSignal << std::endl;
+		}
+	}
+}
@@ -20,6 +20,7 @@
 * SOFTWARE.
 *********************************************************************************/
 #include "CommonDataShare.hpp"
+#include "TimeFormatter.hpp"
 #include <chrono>
 
 /** Constructor
@@ -65,25 +66,9 @@ void CcommonEnvManager::splitString(const std::string &str, char delim)
  */
 void CcommonEnvManager::getTimeParams(std::string &a_sTimeStamp, std::string &a_sUsec)
 {
-	a_sTimeStamp.clear();
-	a_sUsec.clear();
-
-	const auto p1 = std::chrono::system_clock::now();
-
-	std::time_t rawtime = std::chrono::system_clock::to_time_t(p1);
-	std::tm* timeinfo = std::gmtime(&rawtime);
-	if(NULL == timeinfo)
-	{
-		return;
-	}
-	char buffer [80];
-
-	std::strftime(buffer,80,"%Y-%m-%d %H:%M:%S",timeinfo);
-	a_sTimeStamp.insert(0, buffer);
-
-	{
-		std::stringstream ss;
-		ss << std::chrono::duration_cast<std::chrono::microseconds>(p1.time_since_epoch()).count();
-		a_sUsec.insert(0, ss.str());
-	}
+	char acTimeStamp[TIME_FMT_BUFFER_SIZE];
+	char acUsec[TIME_FMT_BUFFER_SIZE];
+	CTimeFormatter::getInstance().getTimeParams(acTimeStamp, acUsec);
+	a_sTimeStamp.assign(acTimeStamp);
+	a_sUsec.assign(acUsec);
 }
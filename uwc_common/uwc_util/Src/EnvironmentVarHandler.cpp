@@ -22,6 +22,8 @@
 #include "Logger.hpp"
 #include "ConfigManager.hpp"
 #include "EnvironmentVarHandler.hpp"
+#include <errno.h>
+#include <string.h>
 
 /**
  * function to read environment variables
@@ -101,3 +103,35 @@ std::string EnvironmentInfo::getDataFromEnvMap(std::string strKey)
 }
 
 
+
+/**
+ * function to read a numeric environment variable. Default value is used if variable
+ * is not set; it is also used, with an error log, if value is not a decimal number or
+ * is outside given range.
+ * @param a_pcName :[in] environment variable name
+ * @param a_ulDefault :[in] default value
+ * @param a_ulMin :[in] minimum valid value
+ * @param a_ulMax :[in] maximum valid value
+ * @return : value of environment variable or default value
+ */
+unsigned long EnvironmentInfo::getEnvNum(const char *a_pcName, unsigned long a_ulDefault,
+		unsigned long a_ulMin, unsigned long a_ulMax)
+{
+	const char *pcVal = getenv(a_pcName);
+	if((NULL == pcVal) || ('\0' == pcVal[0]))
+	{
+		return a_ulDefault;
+	}
+
+	char *pcEnd = NULL;
+	errno = 0;
+	unsigned long ulVal = strtoul(pcVal, &pcEnd, 10);
+	if((0 != errno) || ('\0' != *pcEnd) || (NULL != strchr(pcVal, '-')) ||
+			(ulVal < a_ulMin) || (ulVal > a_ulMax))
+	{
+		DO_LOG_ERROR(std::string(a_pcName) + " has invalid value " + pcVal + ", using default value " +
+				std::to_string(a_ulDefault));
+		return a_ulDefault;
+	}
+	return ulVal;
+}
@@ -0,0 +1,167 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "LogRateLimiter.hpp"
+#include <chrono>
+
+/** Number of low bits of state word used for token count */
+#define LOG_LIMITER_TOKEN_BITS 20
+#define LOG_LIMITER_TOKEN_MASK ((1ULL << LOG_LIMITER_TOKEN_BITS) - 1)
+
+std::atomic<CLogSuppressedCount*> CLogSuppressedCount::m_pHead{nullptr};
+
+/**
+ * Counts a suppressed statement. Count having a call site is linked in list of
+ * pending counts when first statement is suppressed.
+ * @param None
+ * @return None
+ */
+void CLogSuppressedCount::add()
+{
+	m_uiSuppressed.fetch_add(1, std::memory_order_relaxed);
+	if((nullptr == m_pSite) || (true == m_bIsListed.load(std::memory_order_relaxed)) ||
+			(true == m_bIsListed.exchange(true, std::memory_order_relaxed)))
+	{
+		return;
+	}
+	CLogSuppressedCount *pHead = m_pHead.load(std::memory_order_relaxed);
+	do
+	{
+		m_pNext = pHead;
+	} while(false == m_pHead.compare_exchange_weak(pHead, this,
+			std::memory_order_release, std::memory_order_relaxed));
+}
+
+/**
+ * Reports and resets pending counts of all call sites, so that counts are not lost when
+ * suppression ends and call site is not reached again. A count taken here is not reported
+ * again with next allowed statement.
+ * @param a_fcbReport :[in] called with call site, key and count of each site having pending count
+ * @return None
+ */
+void CLogSuppressedCount::reportPending(const std::function<void(const stLogSite&, const char*, uint64_t)> &a_fcbReport)
+{
+	for(CLogSuppressedCount *pCount = m_pHead.load(std::memory_order_acquire);
+			nullptr != pCount; pCount = pCount->m_pNext)
+	{
+		uint64_t uiSuppressed = pCount->take();
+		if(0 != uiSuppressed)
+		{
+			a_fcbReport(*pCount->m_pSite, pCount->m_pcKey, uiSuppressed);
+		}
+	}
+}
+
+/**
+ * Checks if a statement can be logged now
+ * @param a_uiSuppressed :[out] number of statements suppressed since last allowed one;
+ * 					valid only when true is returned
+ * @return true if statement can be logged, false if it is to be suppressed
+ */
+bool CLogRateLimiter::isAllowed(uint64_t &a_uiSuppressed)
+{
+	uint64_t uiNowMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	return isAllowedAt(uiNowMs, a_uiSuppressed);
+}
+
+/**
+ * Checks if a statement can be logged at given time. Tokens are refilled at rate of
+ * burst per period and refill time is advanced only by time of whole tokens added.
+ * @param a_uiNowMs :[in] current time in milliseconds from a monotonic clock
+ * @param a_uiSuppressed :[out] number of statements suppressed since last allowed one;
+ * 					valid only when true is returned
+ * @return true if statement can be logged, false if it is to be suppressed
+ */
+bool CLogRateLimiter::isAllowedAt(uint64_t a_uiNowMs, uint64_t &a_uiSuppressed)
+{
+	const uint64_t uiBurst = (m_uiBurst > LOG_LIMITER_TOKEN_MASK) ? LOG_LIMITER_TOKEN_MASK : m_uiBurst;
+	uint64_t uiOld = m_uiState.load(std::memory_order_relaxed);
+	bool bIsAllowed = false;
+
+	while(true)
+	{
+		// time is stored with offset of 1 so that state 0 means uninitialized
+		uint64_t uiLastMs = (uiOld >> LOG_LIMITER_TOKEN_BITS) - 1;
+		uint64_t uiTokens = uiOld & LOG_LIMITER_TOKEN_MASK;
+		if(0 == uiOld)
+		{
+			// first statement from this call site
+			uiLastMs = a_uiNowMs;
+			uiTokens = uiBurst;
+		}
+		else if(a_uiNowMs > uiLastMs)
+		{
+			uint64_t uiAdd = ((a_uiNowMs - uiLastMs) * uiBurst) / m_uiPeriodMs;
+			if(0 != uiAdd)
+			{
+				uiTokens += uiAdd;
+				if(uiTokens >= uiBurst)
+				{
+					uiTokens = uiBurst;
+					uiLastMs = a_uiNowMs;
+				}
+				else
+				{
+					uiLastMs += (uiAdd * m_uiPeriodMs) / uiBurst;
+				}
+			}
+		}
+
+		bIsAllowed = (0 != uiTokens);
+		if(bIsAllowed)
+		{
+			--uiTokens;
+		}
+		uint64_t uiNew = ((uiLastMs + 1) << LOG_LIMITER_TOKEN_BITS) | uiTokens;
+		if(m_uiState.compare_exchange_weak(uiOld, uiNew, std::memory_order_relaxed))
+		{
+			break;
+		}
+	}
+
+	if(false == bIsAllowed)
+	{
+		m_oSuppressed.add();
+		return false;
+	}
+	a_uiSuppressed = m_oSuppressed.take();
+	return true;
+}
+
+/**
+ * Checks if this statement is sampled for logging
+ * @param a_uiSuppressed :[out] number of statements suppressed since last sampled one;
+ * 					valid only when true is returned
+ * @return true if statement can be logged, false if it is to be suppressed
+ */
+bool CLogSampler::isSampled(uint64_t &a_uiSuppressed)
+{
+	uint64_t uiCount = m_uiCount.fetch_add(1, std::memory_order_relaxed);
+	if(0 != (uiCount % m_uiEvery))
+	{
+		m_oSuppressed.add();
+		return false;
+	}
+	a_uiSuppressed = m_oSuppressed.take();
+	return true;
+}
@@ -21,6 +21,8 @@
 *********************************************************************************/
 
 #include "Logger.hpp"
+#include <stdlib.h>
+#include <strings.h>
 
 /**
  * Constructor Initializes common variables
@@ -30,6 +32,7 @@
 CLogger::CLogger()
 {
 	m_bIsExternal = false;
+	m_bIsAsync = false;
 	logger = NULL;
 }
 
@@ -65,6 +68,7 @@ bool CLogger::configLogger(const char* a_pcLogPropsFilePath)
 
 			logger = &root;
 			m_bIsExternal = false;
+			configAsyncWriter();
 			DO_LOG_INFO("Log level is set to ..." + log4cpp::Priority::getPriorityName(root.getPriority()));
 			return true;
 		}
@@ -80,6 +84,35 @@ bool CLogger::configLogger(const char* a_pcLogPropsFilePath)
 	return false;
 }
 
+/**
+ * Starts background writer thread if ASYNC_LOGGING environment variable is set to true.
+ * Size of per-thread buffer can be set in KB using ASYNC_LOG_BUFFER_KB.
+ * @param None
+ * @return None
+ */
+void CLogger::configAsyncWriter()
+{
+	const char *pcAsync = std::getenv("ASYNC_LOGGING");
+	if((NULL == pcAsync) || (0 != strcasecmp(pcAsync, "true")))
+	{
+		return;
+	}
+
+	size_t uiBufferSize = ASYNC_LOG_DEFAULT_BUFFER_SIZE;
+	const char *pcBufferKb = std::getenv("ASYNC_LOG_BUFFER_KB");
+	if((NULL != pcBufferKb) && (atoi(pcBufferKb) > 0))
+	{
+		uiBufferSize = static_cast<size_t>(atoi(pcBufferKb)) * 1024;
+	}
+
+	if(true == CAsyncLogWriter::getInstance().start(logger, uiBufferSize))
+	{
+		CAsyncLogWriter::getInstance().installCrashHandler();
+		m_bIsAsync = true;
+		std::cout << "Asynchronous logging is enabled\n";
+	}
+}
+
 /**
  * Destructor remove all the appenders and shut down logger
  */
@@ -150,3 +183,24 @@ void CLogger::LogFatal(std::string msg)
 		logger->fatal(msg);
 	}
 }
+
+/**
+ * Write statement logged using DO_LOG_* macros. Statement is handed over to
+ * background writer when asynchronous logging is enabled, otherwise written directly.
+ * @param a_stSite :[in] file, function, line and level of statement
+ * @param a_sMsg :[in] statement to log
+ * @return None
+ */
+void CLogger::Log(const stLogSite &a_stSite, const std::string &a_sMsg)
+{
+	if(NULL == logger)
+	{
+		return;
+	}
+	if(m_bIsAsync && (true == CAsyncLogWriter::getInstance().post(a_stSite, a_sMsg)))
+	{
+		return;
+	}
+	logger->log(a_stSite.m_iPriority, "[ " + std::string(a_stSite.m_pcFile) + " " + a_stSite.m_pcFunc + " " +
+			std::to_string(a_stSite.m_iLine) + "] " + a_sMsg);
+}
@@ -21,6 +21,11 @@
 *********************************************************************************/
 #include "MQTTPubSubClient.hpp"
 #include "Logger.hpp"
+#include "EnvironmentVarHandler.hpp"
+#include "PayloadCodec.hpp"
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
 
 /**
  * This is a callback function to inform action failure related to mqtt
@@ -60,6 +65,353 @@ void action_listener::on_success(const mqtt::token& tok)
 	}
 }
 
+/**
+ * Constructor
+ * @param a_uiMaxInflight :[in] max number of messages in flight
+ */
+CPublishWindow::CPublishWindow(size_t a_uiMaxInflight)
+	: m_uiMaxInflight{(0 == a_uiMaxInflight) ? 1 : a_uiMaxInflight}, m_ui64NextId{1},
+	  m_uiDelivered{0}, m_uiFailed{0}
+{
+}
+
+/**
+ * Sets max number of messages in flight. Waiting publishers are re-evaluated.
+ * @param a_uiMaxInflight :[in] max number of messages in flight; 0 is treated as 1
+ * @return None
+ */
+void CPublishWindow::setMaxInflight(size_t a_uiMaxInflight)
+{
+	{
+		std::lock_guard<std::mutex> lck(m_mutexWindow);
+		m_uiMaxInflight = (0 == a_uiMaxInflight) ? 1 : a_uiMaxInflight;
+	}
+	m_cvWindow.notify_all();
+}
+
+/**
+ * Reserves a slot in window for a message. Caller is blocked while window is full.
+ * @param a_pMsg :[in] message to be published
+ * @param a_fcbDone :[in] callback to be called on completion, can be empty
+ * @param a_iTimeoutMs :[in] max time to wait for a free slot; negative value waits forever
+ * @return context to be passed with publish, NULL if no slot got free within timeout
+ */
+void* CPublishWindow::acquire(mqtt::const_message_ptr a_pMsg, const publish_completion_handler &a_fcbDone, int a_iTimeoutMs)
+{
+	std::unique_lock<std::mutex> lck(m_mutexWindow);
+	auto isSlotFree = [this]() { return m_mapInflight.size() < m_uiMaxInflight; };
+	if(a_iTimeoutMs < 0)
+	{
+		m_cvWindow.wait(lck, isSlotFree);
+	}
+	else if(false == m_cvWindow.wait_for(lck, std::chrono::milliseconds(a_iTimeoutMs), isSlotFree))
+	{
+		return NULL;
+	}
+	uint64_t ui64Id = m_ui64NextId++;
+	m_mapInflight.emplace(ui64Id, stPendingPublish{a_pMsg, a_fcbDone});
+	return reinterpret_cast<void*>(static_cast<uintptr_t>(ui64Id));
+}
+
+/**
+ * Waits till a slot in window is free, without reserving it
+ * @param a_iTimeoutMs :[in] max time to wait; negative value waits forever
+ * @return true if a slot is free
+ */
+bool CPublishWindow::waitForSlot(int a_iTimeoutMs)
+{
+	std::unique_lock<std::mutex> lck(m_mutexWindow);
+	auto isSlotFree = [this]() { return m_mapInflight.size() < m_uiMaxInflight; };
+	if(a_iTimeoutMs < 0)
+	{
+		m_cvWindow.wait(lck, isSlotFree);
+		return true;
+	}
+	return m_cvWindow.wait_for(lck, std::chrono::milliseconds(a_iTimeoutMs), isSlotFree);
+}
+
+/**
+ * Removes a message from window and releases its slot
+ * @param a_pContext :[in] context returned by acquire()
+ * @param a_stPending :[out] removed message
+ * @return true if message is removed, false if it is not in window, e.g. after reset()
+ */
+bool CPublishWindow::take(void *a_pContext, stPendingPublish &a_stPending)
+{
+	uint64_t ui64Id = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(a_pContext));
+	{
+		std::lock_guard<std::mutex> lck(m_mutexWindow);
+		auto itr = m_mapInflight.find(ui64Id);
+		if(m_mapInflight.end() == itr)
+		{
+			return false;
+		}
+		a_stPending = std::move(itr->second);
+		m_mapInflight.erase(itr);
+	}
+	m_cvWindow.notify_one();
+	return true;
+}
+
+/**
+ * Releases slot reserved by acquire() when publish could not be initiated.
+ * Completion callback is not called.
+ * @param a_pContext :[in] context returned by acquire()
+ * @return None
+ */
+void CPublishWindow::cancel(void *a_pContext)
+{
+	stPendingPublish stPending;
+	take(a_pContext, stPending);
+}
+
+/**
+ * Empties window. Used when connection is lost, as tokens of messages which were
+ * in flight may not complete. Such messages are completed as failed in publish order;
+ * their tokens completing later are ignored.
+ * @param None
+ * @return None
+ */
+void CPublishWindow::reset()
+{
+	std::map<uint64_t, stPendingPublish> mapInflight;
+	{
+		std::lock_guard<std::mutex> lck(m_mutexWindow);
+		mapInflight.swap(m_mapInflight);
+	}
+	m_cvWindow.notify_all();
+
+	for(auto &itr : mapInflight)
+	{
+		m_uiFailed.fetch_add(1, std::memory_order_relaxed);
+		try
+		{
+			if(itr.second.m_fcbDone)
+			{
+				itr.second.m_fcbDone(itr.second.m_pMsg, false);
+			}
+		}
+		catch (const std::exception &e)
+		{
+			DO_LOG_ERROR(e.what());
+		}
+	}
+}
+
+/**
+ * Returns number of messages in flight
+ * @param None
+ * @return number of messages in flight
+ */
+size_t CPublishWindow::getInflightCount()
+{
+	std::lock_guard<std::mutex> lck(m_mutexWindow);
+	return m_mapInflight.size();
+}
+
+/**
+ * Releases slot of a completed message and calls its completion callback
+ * @param a_tok :[in] token of completed publish
+ * @param a_bIsSuccess :[in] true if message is delivered
+ * @return None
+ */
+void CPublishWindow::complete(const mqtt::token& a_tok, bool a_bIsSuccess)
+{
+	stPendingPublish stPending;
+	if(false == take(a_tok.get_user_context(), stPending))
+	{
+		// already completed by reset()
+		return;
+	}
+
+	if(a_bIsSuccess)
+	{
+		m_uiDelivered.fetch_add(1, std::memory_order_relaxed);
+	}
+	else
+	{
+		m_uiFailed.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	try
+	{
+		if(stPending.m_fcbDone)
+		{
+			stPending.m_fcbDone(stPending.m_pMsg, a_bIsSuccess);
+		}
+	}
+	catch (const std::exception &e)
+	{
+		DO_LOG_ERROR(e.what());
+	}
+}
+
+/**
+ * This is a callback function to inform that a pipelined publish is completed
+ * @param tok :[in] mqtt token
+ * @return None
+ */
+void CPublishWindow::on_success(const mqtt::token& tok)
+{
+	complete(tok, true);
+}
+
+/**
+ * This is a callback function to inform that a pipelined publish has failed
+ * @param tok :[in] mqtt token
+ * @return None
+ */
+void CPublishWindow::on_failure(const mqtt::token& tok)
+{
+	DO_LOG_ERROR_RATELIMITED("Pipelined publish failed", 10, 1000,
+			"Pipelined publish failed, return code: " + std::to_string(tok.get_return_code()));
+	complete(tok, false);
+}
+
+/**
+ * Constructor
+ * @param a_uiMax :[in] max number of aliases; 0 disables aliases
+ */
+CTopicAliasMap::CTopicAliasMap(uint16_t a_uiMax)
+	: m_uiMax{a_uiMax}, m_uiNext{1}
+{
+}
+
+/**
+ * Sets max number of aliases. Aliases allocated earlier are discarded.
+ * @param a_uiMax :[in] max number of aliases; 0 disables aliases
+ * @return None
+ */
+void CTopicAliasMap::setMax(uint16_t a_uiMax)
+{
+	std::lock_guard<std::mutex> lck(m_mutexAlias);
+	m_uiMax = a_uiMax;
+	m_uiNext = 1;
+	m_mapAlias.clear();
+}
+
+/**
+ * Gets alias to be used for publishing on a topic. When a_bIsNew is set, message must carry
+ * topic along with alias and setMapped() must be called once it is handed to client.
+ * Otherwise message can be sent with alias only.
+ * @param a_sTopic :[in] topic
+ * @param a_bIsNew :[out] true if topic is to be mapped to alias by this message
+ * @return alias, 0 if topic is to be published without alias
+ */
+uint16_t CTopicAliasMap::getAlias(const std::string &a_sTopic, bool &a_bIsNew)
+{
+	a_bIsNew = false;
+	if(a_sTopic.empty())
+	{
+		return 0;
+	}
+	std::lock_guard<std::mutex> lck(m_mutexAlias);
+	auto itr = m_mapAlias.find(a_sTopic);
+	if(m_mapAlias.end() != itr)
+	{
+		if(true == itr->second.m_bIsMapped)
+		{
+			return itr->second.m_uiAlias;
+		}
+		if(true == itr->second.m_bIsPending)
+		{
+			// another publisher is mapping this topic; alias cannot be used till then
+			return 0;
+		}
+		itr->second.m_bIsPending = true;
+		a_bIsNew = true;
+		return itr->second.m_uiAlias;
+	}
+	if((0 == m_uiMax) || (m_uiNext > m_uiMax))
+	{
+		return 0;
+	}
+	stTopicAlias stAlias;
+	stAlias.m_uiAlias = m_uiNext++;
+	stAlias.m_bIsMapped = false;
+	stAlias.m_bIsPending = true;
+	m_mapAlias.emplace(a_sTopic, stAlias);
+	a_bIsNew = true;
+	return stAlias.m_uiAlias;
+}
+
+/**
+ * Records result of handing message which maps topic to alias to client
+ * @param a_sTopic :[in] topic
+ * @param a_bIsMapped :[in] true if message is handed to client; false if it failed,
+ * 			in which case next message on topic maps it again
+ * @return None
+ */
+void CTopicAliasMap::setMapped(const std::string &a_sTopic, bool a_bIsMapped)
+{
+	std::lock_guard<std::mutex> lck(m_mutexAlias);
+	auto itr = m_mapAlias.find(a_sTopic);
+	if(m_mapAlias.end() != itr)
+	{
+		itr->second.m_bIsPending = false;
+		itr->second.m_bIsMapped = a_bIsMapped;
+	}
+}
+
+/**
+ * Discards all aliases. To be called when connection changes, as aliases are valid
+ * only for the connection on which they are mapped.
+ * @param None
+ * @return None
+ */
+void CTopicAliasMap::reset()
+{
+	std::lock_guard<std::mutex> lck(m_mutexAlias);
+	m_uiNext = 1;
+	m_mapAlias.clear();
+}
+
+/**
+ * Constructor
+ * @param a_uiMinMs :[in] wait before first attempt
+ * @param a_uiMaxMs :[in] max wait between attempts
+ * @param a_uiSeed :[in] seed of jitter
+ */
+CReconnectBackoff::CReconnectBackoff(uint32_t a_uiMinMs, uint32_t a_uiMaxMs, uint32_t a_uiSeed)
+	: m_uiMinMs{1}, m_uiMaxMs{1}, m_uiAttempts{0}, m_oRandom{a_uiSeed}
+{
+	setRange(a_uiMinMs, a_uiMaxMs);
+}
+
+/**
+ * Sets range of waits. Min of 0 is treated as 1 and max less than min is treated as min.
+ * @param a_uiMinMs :[in] wait before first attempt
+ * @param a_uiMaxMs :[in] max wait between attempts
+ * @return None
+ */
+void CReconnectBackoff::setRange(uint32_t a_uiMinMs, uint32_t a_uiMaxMs)
+{
+	m_uiMinMs = std::max<uint32_t>(1, a_uiMinMs);
+	m_uiMaxMs = std::max(m_uiMinMs, a_uiMaxMs);
+}
+
+/**
+ * Gives wait before next attempt and counts the attempt. Wait is between half and
+ * whole of min wait doubled once per earlier attempt, capped at max wait.
+ * @param None
+ * @return wait in msec
+ */
+uint32_t CReconnectBackoff::nextDelayMs()
+{
+	uint64_t ui64CeilMs = m_uiMinMs;
+	for(uint32_t uiLoop = 0; (uiLoop < m_uiAttempts) && (ui64CeilMs < m_uiMaxMs); ++uiLoop)
+	{
+		ui64CeilMs *= 2;
+	}
+	ui64CeilMs = std::min<uint64_t>(ui64CeilMs, m_uiMaxMs);
+	if(m_uiAttempts < UINT32_MAX)
+	{
+		++m_uiAttempts;
+	}
+	std::uniform_int_distribution<uint64_t> oJitter(0, ui64CeilMs / 2);
+	return static_cast<uint32_t>(ui64CeilMs - oJitter(m_oRandom));
+}
+
 /**
  * Constructor: Sets all parameters needed to set a connection with MQTT broker
  * @param a_sBrokerURL :[in] MQTT broker URL
@@ -70,13 +422,17 @@ void action_listener::on_success(const mqtt::token& tok)
  * @param a_sClientCertSecret :[in] MQTT client certificate, needed when TLS = true
  * @param a_sClientPvtKeySecret :[in] MQTT client private key, needed when TLS = true
  * @param a_sListener :[in] Action listener name to be used
+ * @param a_stV5Config :[in] MQTT v5 settings; client connects with MQTT 3.1.1 if v5 is not enabled
  */
 CMQTTPubSubClient::CMQTTPubSubClient(const std::string &a_sBrokerURL, std::string a_sClientID, 
 	int a_iQOS, //mqtt::message_ptr &a_willMsg,
 	bool a_bIsTLS, std::string a_sCATrustStoreSecret, 
 	std::string a_sClientCertSecret, std::string a_sClientPvtKeySecret, 
-	std::string a_sListener)
-	: m_iQOS{a_iQOS}, m_sClientID{a_sClientID}, m_Client{a_sBrokerURL, a_sClientID}, m_Listener{a_sListener}
+	std::string a_sListener, const stMQTTv5Config &a_stV5Config)
+	: m_iQOS{a_iQOS}, m_stV5Config{a_stV5Config}, m_sClientID{getClientID(a_sClientID, a_stV5Config)},
+	  m_Client{a_sBrokerURL, m_sClientID,
+		mqtt::create_options(a_stV5Config.m_bIsEnabled ? MQTTVERSION_5 : MQTTVERSION_DEFAULT), nullptr},
+	  m_Listener{a_sListener}, m_bStopDrain{false}
 {
 	try
 	{
@@ -89,8 +445,48 @@ CMQTTPubSubClient::CMQTTPubSubClient(const std::string &a_sBrokerURL, std::strin
 		//
 		//connect options for sync publisher/client
 		m_ConOptions.set_keep_alive_interval(60);
-		m_ConOptions.set_clean_session(true);
-		m_ConOptions.set_automatic_reconnect(1, 10);
+		// reconnection is done by reconnect thread with jittered backoff
+		m_ConOptions.set_automatic_reconnect(false);
+		uint32_t uiReconnectMinMs = static_cast<uint32_t>(EnvironmentInfo::getEnvNum("MQTT_RECONNECT_MIN_MS",
+				MQTT_RECONNECT_DEFAULT_MIN_MS, 0, UINT32_MAX));
+		uint32_t uiReconnectMaxMs = static_cast<uint32_t>(EnvironmentInfo::getEnvNum("MQTT_RECONNECT_MAX_MS",
+				MQTT_RECONNECT_DEFAULT_MAX_MS, 0, UINT32_MAX));
+		m_Backoff.setRange(uiReconnectMinMs, uiReconnectMaxMs);
+		if(true == m_stV5Config.m_bIsEnabled)
+		{
+			m_ConOptions.set_clean_session(false);
+			m_ConOptions.set_mqtt_version(MQTTVERSION_5);
+			// session is resumed on reconnection only if it outlives the connection
+			m_ConOptions.set_clean_start(0 == m_stV5Config.m_uiSessionExpirySec);
+			mqtt::properties props;
+			if(0 != m_stV5Config.m_uiSessionExpirySec)
+			{
+				props.add(mqtt::property(mqtt::property::SESSION_EXPIRY_INTERVAL,
+						static_cast<int>(m_stV5Config.m_uiSessionExpirySec)));
+			}
+			if(0 != m_stV5Config.m_uiReceiveMax)
+			{
+				props.add(mqtt::property(mqtt::property::RECEIVE_MAXIMUM, m_stV5Config.m_uiReceiveMax));
+			}
+			m_ConOptions.set_properties(props);
+
+			// in-flight messages of a resumed session are re-sent on a new connection,
+			// where aliases they carry are not valid
+			if((0 != m_stV5Config.m_uiSessionExpirySec) && (0 != m_stV5Config.m_uiTopicAliasMax))
+			{
+				DO_LOG_WARN(m_sClientID + ": Topic aliases are disabled as session expiry is set");
+				m_stV5Config.m_uiTopicAliasMax = 0;
+			}
+			m_TopicAliases.setMax(m_stV5Config.m_uiTopicAliasMax);
+			DO_LOG_INFO(m_sClientID + ": Using MQTT v5, session expiry: " + std::to_string(m_stV5Config.m_uiSessionExpirySec)
+					+ " sec, receive maximum: " + std::to_string(m_stV5Config.m_uiReceiveMax)
+					+ ", topic aliases: " + std::to_string(m_stV5Config.m_uiTopicAliasMax)
+					+ ", share group: " + m_stV5Config.m_sShareGroup);
+		}
+		else
+		{
+			m_ConOptions.set_clean_session(true);
+		}
 
 		// set the certificates if dev mode is false
 		if(true == a_bIsTLS)
@@ -117,6 +513,83 @@ CMQTTPubSubClient::CMQTTPubSubClient(const std::string &a_sBrokerURL, std::strin
 	}
 }
 
+/**
+ * Destructor
+ */
+CMQTTPubSubClient::~CMQTTPubSubClient()
+{
+	stopReconnect();
+	stopOutboxDrain();
+}
+
+/**
+ * Reads MQTT v5 settings from environment variables MQTT_V5 ("true" or "false"),
+ * MQTT_SESSION_EXPIRY_SEC, MQTT_RECEIVE_MAX, MQTT_TOPIC_ALIAS_MAX and MQTT_SHARE_GROUP
+ * @return MQTT v5 settings
+ */
+stMQTTv5Config CMQTTPubSubClient::readV5Config()
+{
+	stMQTTv5Config stConfig;
+	auto getEnv = [](const char *a_pcName) -> std::string
+	{
+		const char *pcVal = std::getenv(a_pcName);
+		return (NULL == pcVal) ? "" : pcVal;
+	};
+
+	stConfig.m_bIsEnabled = (getEnv("MQTT_V5") == "true");
+	stConfig.m_uiSessionExpirySec = static_cast<uint32_t>(EnvironmentInfo::getEnvNum("MQTT_SESSION_EXPIRY_SEC",
+			stConfig.m_uiSessionExpirySec, 0, UINT32_MAX));
+	// values above 65535 are limited to protocol maximum
+	stConfig.m_uiReceiveMax = static_cast<uint16_t>(std::min(EnvironmentInfo::getEnvNum("MQTT_RECEIVE_MAX",
+			stConfig.m_uiReceiveMax), 65535UL));
+	stConfig.m_uiTopicAliasMax = static_cast<uint16_t>(std::min(EnvironmentInfo::getEnvNum("MQTT_TOPIC_ALIAS_MAX",
+			stConfig.m_uiTopicAliasMax), 65535UL));
+	stConfig.m_sShareGroup = getEnv("MQTT_SHARE_GROUP");
+	if(std::string::npos != stConfig.m_sShareGroup.find_first_of("/+#"))
+	{
+		DO_LOG_ERROR("MQTT_SHARE_GROUP cannot have '/', '+' or '#', shared subscription is disabled: " + stConfig.m_sShareGroup);
+		stConfig.m_sShareGroup.clear();
+	}
+	return stConfig;
+}
+
+/**
+ * Gets client id to be used for connection. Clients of a shared subscription group run
+ * as several instances, so host name is appended to make client id unique.
+ * @param a_sClientID :[in] configured client id
+ * @param a_stV5Config :[in] MQTT v5 settings
+ * @return client id
+ */
+std::string CMQTTPubSubClient::getClientID(const std::string &a_sClientID, const stMQTTv5Config &a_stV5Config)
+{
+	if((false == a_stV5Config.m_bIsEnabled) || (true == a_stV5Config.m_sShareGroup.empty()))
+	{
+		return a_sClientID;
+	}
+	char acHost[256] = {0};
+	if((0 != gethostname(acHost, sizeof(acHost) - 1)) || ('\0' == acHost[0]))
+	{
+		return a_sClientID;
+	}
+	return a_sClientID + "_" + acHost;
+}
+
+/**
+ * Gets topic filter to be subscribed for a topic. Shared subscription is used if share group
+ * is set, in which case each message is given to only one client of the group.
+ * @param a_sTopic :[in] topic filter
+ * @param a_stV5Config :[in] MQTT v5 settings
+ * @return topic filter to be subscribed
+ */
+std::string CMQTTPubSubClient::getSubscribeTopic(const std::string &a_sTopic, const stMQTTv5Config &a_stV5Config)
+{
+	if((false == a_stV5Config.m_bIsEnabled) || (true == a_stV5Config.m_sShareGroup.empty()))
+	{
+		return a_sTopic;
+	}
+	return MQTT_SHARED_SUB_PREFIX + a_stV5Config.m_sShareGroup + "/" + a_sTopic;
+}
+
 /**
  * This function tries to establish a connection with MQTT broker
  * @return true/false status based on success/failure
@@ -125,6 +598,14 @@ bool CMQTTPubSubClient::connect()
 {
 	try
 	{
+		{
+			std::lock_guard<std::mutex> lck(m_mutexReconnect);
+			m_bIsReconnectEnabled = true;
+			if(false == m_thReconnect.joinable())
+			{
+				m_thReconnect = std::thread(&CMQTTPubSubClient::reconnectLoop, this);
+			}
+		}
 		if(false == m_Client.is_connected())
 		{
 			m_Client.connect(m_ConOptions, nullptr, *this);
@@ -146,6 +627,7 @@ bool CMQTTPubSubClient::disconnect()
 {
 	try
 	{
+		stopReconnect();
 		if(true == m_Client.is_connected())
 		{
 			m_Client.disconnect();
@@ -160,7 +642,8 @@ bool CMQTTPubSubClient::disconnect()
 }
 
 /**
- * This function subscribes to a topic on MQTT broker
+ * This function subscribes to a topic on MQTT broker. Topic having compression suffix
+ * is also subscribed if configured. Shared subscription is used if share group is set.
  * @param a_sTopic :[in] topic to be published
  * @return none
  */
@@ -168,7 +651,10 @@ void CMQTTPubSubClient::subscribe(const std::string &a_sTopic)
 {
 	try
 	{
-		m_Client.subscribe(a_sTopic, m_iQOS, nullptr, m_Listener);
+		for(const auto &sTopic : CPayloadCodec::getInstance().getSubscribeTopics(a_sTopic))
+		{
+			m_Client.subscribe(getSubscribeTopic(sTopic, m_stV5Config), m_iQOS, nullptr, m_Listener);
+		}
 	}
 	catch (const std::exception &e)
 	{
@@ -189,7 +675,7 @@ bool CMQTTPubSubClient::publishMsg(mqtt::message_ptr &a_pubMsg, bool a_bIsWaitFo
 		if(true == m_Client.is_connected())
 		{
 			a_pubMsg->set_qos(m_iQOS);
-			auto pubtoken = m_Client.publish(a_pubMsg, nullptr, m_Listener);
+			auto pubtoken = publishToBroker(a_pubMsg, nullptr, m_Listener);
 			if(a_bIsWaitForCompletion)
 			{
 				pubtoken->wait();
@@ -204,6 +690,536 @@ bool CMQTTPubSubClient::publishMsg(mqtt::message_ptr &a_pubMsg, bool a_bIsWaitFo
 	return true;
 }
 
+/**
+ * This function publishes a message on MQTT broker without waiting for its completion.
+ * Up to max-inflight messages are kept in flight; they are sent and delivered in the
+ * order of calls. Caller is blocked while window is full.
+ * @param a_pubMsg :[in] pointer to message to be published
+ * @param a_fcbDone :[in] callback to be called when message is delivered or has failed
+ * @param a_iWaitTimeoutMs :[in] max time to wait for a free slot in window; negative value waits forever
+ * @return true if publish is initiated; false if client is not connected, window
+ * 			stayed full or on error. Callback is not called when false is returned.
+ * 			When outbox is enabled, see publishWithOutbox().
+ */
+bool CMQTTPubSubClient::publishMsgPipelined(mqtt::message_ptr &a_pubMsg,
+		const publish_completion_handler &a_fcbDone, int a_iWaitTimeoutMs)
+{
+	try
+	{
+		if(nullptr != m_pOutbox)
+		{
+			return publishWithOutbox(a_pubMsg, a_fcbDone, a_iWaitTimeoutMs);
+		}
+		if(false == m_Client.is_connected())
+		{
+			return false;
+		}
+		a_pubMsg->set_qos(m_iQOS);
+		void *pContext = m_PublishWindow.acquire(a_pubMsg, a_fcbDone, a_iWaitTimeoutMs);
+		if(NULL == pContext)
+		{
+			DO_LOG_ERROR_RATELIMITED("Publish window full", 10, 1000,
+					m_sClientID + ": Publish window is full, message not published: " + a_pubMsg->get_topic());
+			return false;
+		}
+		try
+		{
+			publishToBroker(a_pubMsg, pContext, m_PublishWindow);
+		}
+		catch (const std::exception &e)
+		{
+			m_PublishWindow.cancel(pContext);
+			throw;
+		}
+	}
+	catch (const std::exception &e)
+	{
+		DO_LOG_ERROR(e.what());
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Hands a message to client for publishing. If topic aliases are enabled, message carries
+ * alias of its topic, and topic is left out once alias is mapped on the connection.
+ * Message given to caller's callbacks keeps its topic.
+ * @param a_pMsg :[in] message to be published
+ * @param a_pContext :[in] user context of delivery token
+ * @param a_Listener :[in] listener to be notified of completion
+ * @return delivery token
+ */
+mqtt::delivery_token_ptr CMQTTPubSubClient::publishToBroker(mqtt::const_message_ptr a_pMsg, void *a_pContext,
+		mqtt::iaction_listener &a_Listener)
+{
+	bool bIsNew = false;
+	uint16_t uiAlias = m_TopicAliases.getAlias(a_pMsg->get_topic(), bIsNew);
+	if(0 == uiAlias)
+	{
+		return m_Client.publish(a_pMsg, a_pContext, a_Listener);
+	}
+
+	mqtt::message_ptr pAliasMsg = std::make_shared<mqtt::message>(*a_pMsg);
+	mqtt::properties props = a_pMsg->get_properties();
+	props.add(mqtt::property(mqtt::property::TOPIC_ALIAS, uiAlias));
+	pAliasMsg->set_properties(props);
+	if(false == bIsNew)
+	{
+		pAliasMsg->set_topic("");
+		return m_Client.publish(pAliasMsg, a_pContext, a_Listener);
+	}
+	try
+	{
+		auto pToken = m_Client.publish(pAliasMsg, a_pContext, a_Listener);
+		m_TopicAliases.setMapped(a_pMsg->get_topic(), true);
+		return pToken;
+	}
+	catch (const std::exception &e)
+	{
+		m_TopicAliases.setMapped(a_pMsg->get_topic(), false);
+		throw;
+	}
+}
+
+/**
+ * Publishes a message when outbox is enabled. Outbox is used only while client is disconnected.
+ * While client is connected, caller is blocked till messages stored in outbox are forwarded and
+ * a slot in window is free, which pushes back on callers instead of filling outbox. Live messages
+ * which are not delivered when connection is lost are stored in outbox in publish order,
+ * ahead of messages published after them.
+ * @param a_pubMsg :[in] pointer to message to be published
+ * @param a_fcbDone :[in] callback to be called when directly published message is delivered
+ * 			or has failed; it is not called for messages forwarded from outbox
+ * @param a_iWaitTimeoutMs :[in] max time to wait while client is connected; negative value waits forever
+ * @return true if message is published or stored in outbox, false if wait timed out or on error
+ */
+bool CMQTTPubSubClient::publishWithOutbox(mqtt::message_ptr &a_pubMsg,
+		const publish_completion_handler &a_fcbDone, int a_iWaitTimeoutMs)
+{
+	a_pubMsg->set_qos(m_iQOS);
+	const auto tpDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(a_iWaitTimeoutMs, 0));
+	while(true)
+	{
+		int iWaitMs = MQTT_OUTBOX_WAIT_SLICE_MS;
+		if(a_iWaitTimeoutMs >= 0)
+		{
+			auto leftMs = std::chrono::duration_cast<std::chrono::milliseconds>(tpDeadline - std::chrono::steady_clock::now());
+			iWaitMs = (int)std::max<int64_t>(0, std::min<int64_t>(iWaitMs, leftMs.count()));
+		}
+		// window is not waited for under order lock, so that drain thread and completions are not blocked
+		bool bIsSlotFree = m_PublishWindow.waitForSlot(iWaitMs);
+		bool bIsBacklog = false;
+		{
+			std::lock_guard<std::mutex> lck(m_mutexPublishOrder);
+			if(false == m_Client.is_connected())
+			{
+				// live messages still in flight are not delivered; they are stored ahead of this one
+				storeLiveInflight();
+				return storeInOutbox(a_pubMsg);
+			}
+			bIsBacklog = m_pOutbox->hasUnread();
+			if((true == bIsSlotFree) && (false == bIsBacklog))
+			{
+				uint64_t ui64Seq = ++m_ui64LiveSeq;
+				auto fcbLiveDone = [this, ui64Seq, a_fcbDone](mqtt::const_message_ptr a_pMsg, bool a_bIsSuccess)
+				{
+					completeLive(ui64Seq, a_pMsg, a_bIsSuccess, a_fcbDone);
+				};
+				void *pContext = m_PublishWindow.acquire(a_pubMsg, fcbLiveDone, 0);
+				if(NULL != pContext)
+				{
+					m_mapLiveInflight.emplace(ui64Seq, a_pubMsg);
+					try
+					{
+						publishToBroker(a_pubMsg, pContext, m_PublishWindow);
+						return true;
+					}
+					catch (const std::exception &e)
+					{
+						m_mapLiveInflight.erase(ui64Seq);
+						m_PublishWindow.cancel(pContext);
+						DO_LOG_ERROR(e.what());
+						if(false == m_Client.is_connected())
+						{
+							// messages in flight are not delivered either; they are stored ahead of this one
+							storeLiveInflight();
+						}
+						return storeInOutbox(a_pubMsg);
+					}
+				}
+			}
+		}
+		if((a_iWaitTimeoutMs >= 0) && (std::chrono::steady_clock::now() >= tpDeadline))
+		{
+			DO_LOG_ERROR_RATELIMITED("Outbox publish wait timeout", 10, 1000,
+					m_sClientID + ": Publishing is blocked, message not published: " + a_pubMsg->get_topic());
+			return false;
+		}
+		if((true == bIsSlotFree) && (true == bIsBacklog))
+		{
+			// messages stored in outbox are forwarded first
+			std::this_thread::sleep_for(std::chrono::milliseconds(MQTT_OUTBOX_WAIT_SLICE_MS));
+		}
+	}
+}
+
+/**
+ * Stores a message in outbox to be forwarded later
+ * @param a_pMsg :[in] message
+ * @return true if message is stored
+ */
+bool CMQTTPubSubClient::storeInOutbox(mqtt::const_message_ptr a_pMsg)
+{
+	// user properties carry compression and timestamp information, so they are kept with record
+	outbox_user_props_t vecUserProps;
+	const mqtt::properties &props = a_pMsg->get_properties();
+	size_t uiCount = props.count(mqtt::property::USER_PROPERTY);
+	for(size_t i = 0; i < uiCount; ++i)
+	{
+		mqtt::string_pair prop = mqtt::get<mqtt::string_pair>(props.get(mqtt::property::USER_PROPERTY, i));
+		vecUserProps.emplace_back(std::get<0>(prop), std::get<1>(prop));
+	}
+	bool bIsStored = m_pOutbox->append(a_pMsg->get_topic(), a_pMsg->get_payload_str(),
+			a_pMsg->get_qos(), a_pMsg->is_retained(), vecUserProps);
+	m_cvDrain.notify_one();
+	return bIsStored;
+}
+
+/**
+ * Stores live messages which are not yet delivered in outbox, in publish order. Caller holds
+ * order lock. A message may be forwarded again if it was delivered but not acknowledged.
+ * @param None
+ * @return None
+ */
+void CMQTTPubSubClient::storeLiveInflight()
+{
+	for(auto &itr : m_mapLiveInflight)
+	{
+		storeInOutbox(itr.second);
+	}
+	m_mapLiveInflight.clear();
+}
+
+/**
+ * Stores a failed live message in outbox. While client is connected, messages published before
+ * and after it are still delivered by client, so only failed message is stored; storing them too
+ * would forward them twice. Once connection is lost, client delivers none of them, so all
+ * messages in flight are stored in publish order. Caller holds order lock.
+ * @param a_ui64Seq :[in] publish order of failed message
+ * @param a_bIsConnected :[in] true if client is connected
+ * @return None
+ */
+void CMQTTPubSubClient::storeFailedLive(uint64_t a_ui64Seq, bool a_bIsConnected)
+{
+	auto itr = m_mapLiveInflight.find(a_ui64Seq);
+	if(m_mapLiveInflight.end() == itr)
+	{
+		// already stored when connection was lost
+		return;
+	}
+	if(false == a_bIsConnected)
+	{
+		storeLiveInflight();
+		return;
+	}
+	storeInOutbox(itr->second);
+	m_mapLiveInflight.erase(itr);
+}
+
+/**
+ * Completes a live message published while outbox is enabled. If it has failed, it is stored in
+ * outbox to be forwarded later.
+ * @param a_ui64Seq :[in] publish order of message
+ * @param a_pMsg :[in] message
+ * @param a_bIsSuccess :[in] true if message is delivered
+ * @param a_fcbDone :[in] caller's completion callback, can be empty
+ * @return None
+ */
+void CMQTTPubSubClient::completeLive(uint64_t a_ui64Seq, mqtt::const_message_ptr a_pMsg, bool a_bIsSuccess,
+		const publish_completion_handler &a_fcbDone)
+{
+	{
+		std::lock_guard<std::mutex> lck(m_mutexPublishOrder);
+		if(true == a_bIsSuccess)
+		{
+			m_mapLiveInflight.erase(a_ui64Seq);
+		}
+		else
+		{
+			storeFailedLive(a_ui64Seq, m_Client.is_connected());
+		}
+	}
+	if(a_fcbDone)
+	{
+		a_fcbDone(a_pMsg, a_bIsSuccess);
+	}
+}
+
+/**
+ * Enables store-and-forward outbox. Messages published using publishMsgPipelined() are stored
+ * in outbox while client is disconnected, and are forwarded in order at
+ * configured rate once client is connected. Messages left in outbox by an earlier run are
+ * forwarded too. To be called before connecting and publishing.
+ * @param a_stConfig :[in] outbox configuration
+ * @return true if outbox is enabled
+ */
+bool CMQTTPubSubClient::enableOutbox(const stOutboxConfig &a_stConfig)
+{
+	try
+	{
+		if(nullptr != m_pOutbox)
+		{
+			return true;
+		}
+		std::unique_ptr<CPersistentOutbox> pOutbox(new CPersistentOutbox());
+		if(false == pOutbox->open(a_stConfig))
+		{
+			DO_LOG_ERROR(m_sClientID + ": Outbox could not be opened: " + a_stConfig.m_sDir);
+			return false;
+		}
+		m_pOutbox = std::move(pOutbox);
+		m_bStopDrain.store(false);
+		m_thOutboxDrain = std::thread(&CMQTTPubSubClient::drainOutbox, this);
+		DO_LOG_INFO(m_sClientID + ": Outbox enabled: " + a_stConfig.m_sDir);
+		return true;
+	}
+	catch (const std::exception &e)
+	{
+		DO_LOG_ERROR(e.what());
+	}
+	return false;
+}
+
+/**
+ * Stops drain thread of outbox
+ * @param None
+ * @return None
+ */
+void CMQTTPubSubClient::stopOutboxDrain()
+{
+	{
+		std::lock_guard<std::mutex> lck(m_mutexDrain);
+		m_bStopDrain.store(true);
+	}
+	m_cvDrain.notify_all();
+	if(m_thOutboxDrain.joinable())
+	{
+		m_thOutboxDrain.join();
+	}
+}
+
+/**
+ * Thread function which forwards messages from outbox while client is connected.
+ * A message is removed from outbox once it is delivered; on failure it is read again.
+ * @param None
+ * @return None
+ */
+void CMQTTPubSubClient::drainOutbox()
+{
+	const uint32_t uiRate = m_pOutbox->getConfig().m_uiDrainRate;
+	const std::chrono::microseconds interval((0 == uiRate) ? 0 : (1000000 / uiRate));
+	auto nextSend = std::chrono::steady_clock::now();
+	CPersistentOutbox *pOutbox = m_pOutbox.get();
+
+	while(false == m_bStopDrain.load())
+	{
+		try
+		{
+			{
+				std::unique_lock<std::mutex> lck(m_mutexDrain);
+				// wait is bounded as client connection status is not notified when it changes
+				m_cvDrain.wait_for(lck, std::chrono::seconds(1), [this, pOutbox]() {
+					return m_bStopDrain.load() || (m_Client.is_connected() && pOutbox->hasUnread());
+				});
+			}
+			if((true == m_bStopDrain.load()) || (false == m_Client.is_connected()))
+			{
+				continue;
+			}
+
+			if(0 != interval.count())
+			{
+				auto now = std::chrono::steady_clock::now();
+				// do not send a burst to catch up after idle time
+				nextSend = std::max(nextSend, now - std::chrono::seconds(1));
+				std::this_thread::sleep_until(nextSend);
+				nextSend += interval;
+			}
+
+			// window is not waited for under order lock, so that live publishers are not blocked
+			if(false == m_PublishWindow.waitForSlot(1000))
+			{
+				continue;
+			}
+			std::lock_guard<std::mutex> lck(m_mutexPublishOrder);
+			stOutboxMsg stMsg;
+			if(false == pOutbox->readNext(stMsg))
+			{
+				continue;
+			}
+			uint64_t uiId = stMsg.m_uiId;
+			mqtt::message_ptr pMsg = mqtt::make_message(stMsg.m_sTopic, stMsg.m_sPayload,
+					stMsg.m_iQos, stMsg.m_bIsRetained);
+			if(false == stMsg.m_vecUserProps.empty())
+			{
+				mqtt::properties props;
+				for(const auto &itrProp : stMsg.m_vecUserProps)
+				{
+					props.add(mqtt::property(mqtt::property::USER_PROPERTY, itrProp.first, itrProp.second));
+				}
+				pMsg->set_properties(props);
+			}
+			auto fcbDone = [pOutbox, uiId](mqtt::const_message_ptr a_pMsg, bool a_bIsSuccess)
+			{
+				if(a_bIsSuccess)
+				{
+					pOutbox->ack(uiId);
+				}
+				else
+				{
+					pOutbox->rewind(uiId);
+				}
+			};
+			void *pContext = m_PublishWindow.acquire(pMsg, fcbDone, 0);
+			if(NULL == pContext)
+			{
+				pOutbox->rewind(uiId);
+				continue;
+			}
+			try
+			{
+				publishToBroker(pMsg, pContext, m_PublishWindow);
+			}
+			catch (const std::exception &e)
+			{
+				m_PublishWindow.cancel(pContext);
+				pOutbox->rewind(uiId);
+				DO_LOG_ERROR_RATELIMITED("Outbox forward failed", 10, 1000,
+						m_sClientID + ": Outbox message could not be forwarded: " + e.what());
+			}
+		}
+		catch (const std::exception &e)
+		{
+			DO_LOG_ERROR(e.what());
+		}
+	}
+}
+
+/**
+ * Schedules next reconnection attempt after a wait given by backoff. Backoff starts
+ * again from min wait only if lost connection had stayed up for max wait; a broker
+ * which accepts connections and drops them soon after is retried with growing waits.
+ * @param a_bIsConnectionLost :[in] true if an established connection is lost,
+ * 			false if a connection attempt failed
+ * @return None
+ */
+void CMQTTPubSubClient::scheduleReconnect(bool a_bIsConnectionLost)
+{
+	uint32_t uiDelayMs = 0;
+	uint32_t uiAttempts = 0;
+	{
+		std::lock_guard<std::mutex> lck(m_mutexReconnect);
+		if(false == m_bIsReconnectEnabled)
+		{
+			return;
+		}
+		auto tpNow = std::chrono::steady_clock::now();
+		if((true == a_bIsConnectionLost) &&
+			((tpNow - m_tpConnectedAt) >= std::chrono::milliseconds(m_Backoff.getMaxMs())))
+		{
+			m_Backoff.reset();
+		}
+		uiDelayMs = m_Backoff.nextDelayMs();
+		uiAttempts = m_Backoff.getAttempts();
+		m_tpReconnectAt = tpNow + std::chrono::milliseconds(uiDelayMs);
+		m_bIsReconnectDue = true;
+	}
+	m_cvReconnect.notify_one();
+	DO_LOG_INFO(m_sClientID + ": Reconnecting in " + std::to_string(uiDelayMs) +
+			" ms, attempt " + std::to_string(uiAttempts));
+}
+
+/**
+ * Stops reconnect thread. Scheduled attempt is dropped.
+ * @param None
+ * @return None
+ */
+void CMQTTPubSubClient::stopReconnect()
+{
+	{
+		std::lock_guard<std::mutex> lck(m_mutexReconnect);
+		m_bIsReconnectEnabled = false;
+		m_bIsReconnectDue = false;
+	}
+	m_cvReconnect.notify_all();
+	if((m_thReconnect.joinable()) && (std::this_thread::get_id() != m_thReconnect.get_id()))
+	{
+		m_thReconnect.join();
+	}
+}
+
+/**
+ * Thread function which makes scheduled reconnection attempts. Result of an attempt
+ * is reported to connected() or on_failure(), which schedules next attempt.
+ * @param None
+ * @return None
+ */
+void CMQTTPubSubClient::reconnectLoop()
+{
+	std::unique_lock<std::mutex> lck(m_mutexReconnect);
+	while(true == m_bIsReconnectEnabled)
+	{
+		if(false == m_bIsReconnectDue)
+		{
+			m_cvReconnect.wait(lck);
+			continue;
+		}
+		if(std::chrono::steady_clock::now() < m_tpReconnectAt)
+		{
+			// attempt may be rescheduled or dropped meanwhile
+			m_cvReconnect.wait_until(lck, m_tpReconnectAt);
+			continue;
+		}
+		m_bIsReconnectDue = false;
+		lck.unlock();
+		bool bIsStarted = false;
+		try
+		{
+			if(false == m_Client.is_connected())
+			{
+				m_ui64ReconnectAttempts.fetch_add(1, std::memory_order_relaxed);
+				m_Client.connect(m_ConOptions, nullptr, *this);
+			}
+			bIsStarted = true;
+		}
+		catch (const std::exception &e)
+		{
+			DO_LOG_ERROR(m_sClientID + ": Reconnection could not be started: " + e.what());
+		}
+		if(false == bIsStarted)
+		{
+			scheduleReconnect(false);
+		}
+		lck.lock();
+	}
+}
+
+/**
+ * Sets max number of messages in flight for pipelined publish. It is also set as
+ * max-inflight of client, which is applied on next connection.
+ * @param a_iMaxInflight :[in] max number of messages in flight
+ * @return None
+ */
+void CMQTTPubSubClient::setMaxInflight(int a_iMaxInflight)
+{
+	if(a_iMaxInflight < 1)
+	{
+		a_iMaxInflight = 1;
+	}
+	m_ConOptions.set_max_inflight(a_iMaxInflight);
+	m_PublishWindow.setMaxInflight(static_cast<size_t>(a_iMaxInflight));
+}
+
 /**
  * This is a callback function which gets called when subscriber fails to send/receive/connect
  * @param tok :[in] failed message token
@@ -216,6 +1232,7 @@ void CMQTTPubSubClient::on_failure(const mqtt::token& tok)
 		if(mqtt::token::Type::CONNECT == tok.get_type())
 		{
 			DO_LOG_ERROR("Connection attempt failed: " + m_sClientID);
+			scheduleReconnect(false);
 			if(m_bNotifyDisConnection)
 			{
 				m_fcbDisconnected("CONNECT_FAILED");
@@ -230,12 +1247,33 @@ void CMQTTPubSubClient::on_failure(const mqtt::token& tok)
 
 /**
  * This is a callback function which gets called when subscriber succeeds in send/receive/(re)connection
- * Either this or connected() can be used for callbacks. 
+ * Either this or connected() can be used for callbacks. Topic alias maximum of broker is read
+ * from CONNACK; connect token completes before connected() is called.
  * @param tok :[in] message token
  * @return None
  */
 void CMQTTPubSubClient::on_success(const mqtt::token& tok)
 {
+	try
+	{
+		if((mqtt::token::Type::CONNECT != tok.get_type()) || (false == m_stV5Config.m_bIsEnabled))
+		{
+			return;
+		}
+		// broker which does not send topic alias maximum accepts no aliases
+		uint16_t uiBrokerAliasMax = 0;
+		mqtt::connect_response stResponse = tok.get_connect_response();
+		const mqtt::properties &props = stResponse.get_properties();
+		if(0 != props.count(mqtt::property::TOPIC_ALIAS_MAXIMUM))
+		{
+			uiBrokerAliasMax = mqtt::get<uint16_t>(props.get(mqtt::property::TOPIC_ALIAS_MAXIMUM));
+		}
+		m_uiBrokerAliasMax = uiBrokerAliasMax;
+	}
+	catch (const std::exception &e)
+	{
+		DO_LOG_ERROR(e.what());
+	}
 }
 
 /**
@@ -248,6 +1286,22 @@ void CMQTTPubSubClient::connected(const std::string& a_sCause)
 	try
 	{
 		DO_LOG_INFO(m_sClientID + " Connected: " + a_sCause);
+		{
+			std::lock_guard<std::mutex> lck(m_mutexReconnect);
+			m_bIsReconnectDue = false;
+			m_tpConnectedAt = std::chrono::steady_clock::now();
+		}
+		// aliases of earlier connection are not valid; broker may also allow fewer aliases than configured
+		uint16_t uiAliasMax = std::min(m_stV5Config.m_uiTopicAliasMax, m_uiBrokerAliasMax.load());
+		if(uiAliasMax < m_stV5Config.m_uiTopicAliasMax)
+		{
+			DO_LOG_INFO(m_sClientID + ": Broker allows " + std::to_string(uiAliasMax) + " topic aliases");
+		}
+		m_TopicAliases.setMax(uiAliasMax);
+		if(nullptr != m_pOutbox)
+		{
+			m_cvDrain.notify_one();
+		}
 		if(m_bNotifyConnection)
 		{
 			m_fcbConnected(a_sCause);
@@ -269,6 +1323,22 @@ void CMQTTPubSubClient::connection_lost(const std::string& a_sCause)
 	try
 	{
 		DO_LOG_ERROR(m_sClientID + ": Connection lost: " + a_sCause);
+		// Live messages which were in flight are stored in outbox in publish order
+		if(nullptr != m_pOutbox)
+		{
+			std::lock_guard<std::mutex> lck(m_mutexPublishOrder);
+			storeLiveInflight();
+		}
+		// Release publishers waiting for messages which were in flight
+		m_PublishWindow.reset();
+		// Aliases are mapped again on next connection
+		m_TopicAliases.reset();
+		// Messages forwarded from outbox which were in flight are forwarded again
+		if(nullptr != m_pOutbox)
+		{
+			m_pOutbox->rewindAll();
+		}
+		scheduleReconnect(true);
 
 		if(m_bNotifyDisConnection)
 		{
@@ -291,6 +1361,11 @@ void CMQTTPubSubClient::message_arrived(mqtt::const_message_ptr msg)
 	try
 	{
 		DO_LOG_DEBUG(m_sClientID + ": Message arrived: " + msg->get_topic());
+		// compressed message is given to callback with original topic and payload
+		if(false == CPayloadCodec::getInstance().decodeMsg(msg))
+		{
+			return;
+		}
 		if(m_bNotifyMsgRcvd)
 		{
 			m_fcbMsgRcvd(msg);
@@ -314,12 +1389,13 @@ void CMQTTPubSubClient::message_arrived(mqtt::const_message_ptr msg)
  * @param a_sClientCert :[in] MQTT client certificate, needed when TLS = true
  * @param a_sClientKey :[in] MQTT client private key, needed when TLS = true
  * @param a_sListener :[in] Action listener name to be used
+ * @param a_stV5Config :[in] MQTT v5 settings
  */
 CMQTTBaseHandler::CMQTTBaseHandler(const std::string &a_sBrokerURL, const std::string &a_sClientID,
 			int a_iQOS, bool a_bIsTLS, const std::string &a_sCaCert, const std::string &a_sClientCert,
-			const std::string &a_sClientKey, const std::string &a_sListener):
+			const std::string &a_sClientKey, const std::string &a_sListener, const stMQTTv5Config &a_stV5Config):
 	m_MQTTClient(a_sBrokerURL, a_sClientID, a_iQOS, a_bIsTLS, 
-	a_sCaCert, a_sClientCert, a_sClientKey, a_sListener)
+	a_sCaCert, a_sClientCert, a_sClientKey, a_sListener, a_stV5Config)
 {
 	try
 	{
@@ -430,6 +1506,19 @@ bool CMQTTBaseHandler::isConnected()
  * @return true/false based on success/failure
  */
 bool CMQTTBaseHandler::publishMsg(const std::string &a_sMsg, const std::string &a_sTopic)
+{
+	return publishMsg(a_sMsg, a_sTopic, mqtt::properties());
+}
+
+/**
+ * Publish message having MQTT v5 user properties on MQTT broker for MQTT-Export.
+ * Properties are sent only on MQTT v5 connection.
+ * @param a_sMsg :[in] message to publish
+ * @param a_sTopic :[in] topic on which to publish message
+ * @param a_props :[in] user properties to add to message
+ * @return true/false based on success/failure
+ */
+bool CMQTTBaseHandler::publishMsg(const std::string &a_sMsg, const std::string &a_sTopic, const mqtt::properties &a_props)
 {
 	try
 	{
@@ -439,8 +1528,31 @@ bool CMQTTBaseHandler::publishMsg(const std::string &a_sMsg, const std::string &
 			DO_LOG_ERROR("Blank topic. Message not posted");
 			return false;
 		}
-		mqtt::message_ptr pubmsg = mqtt::make_message(a_sTopic, a_sMsg, m_QOS, false);
-		m_MQTTClient.publishMsg(pubmsg);
+		// payload of configured topics is compressed
+		mqtt::message_ptr pubmsg = CPayloadCodec::getInstance().encodeMsg(a_sTopic, a_sMsg, m_QOS, false);
+		size_t uiCount = a_props.count(mqtt::property::USER_PROPERTY);
+		if(0 != uiCount)
+		{
+			// codec may have added its own property
+			mqtt::properties props = pubmsg->get_properties();
+			for(size_t i = 0; i < uiCount; ++i)
+			{
+				props.add(a_props.get(mqtt::property::USER_PROPERTY, i));
+			}
+			pubmsg->set_properties(props);
+		}
+		if(m_MQTTClient.isOutboxEnabled())
+		{
+			// caller is blocked while window is full; message is stored in outbox only while disconnected
+			if(false == m_MQTTClient.publishMsgPipelined(pubmsg, nullptr, -1))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			m_MQTTClient.publishMsg(pubmsg);
+		}
 
 		DO_LOG_DEBUG("Published message on Internal MQTT broker successfully with QOS:"+ std::to_string(m_QOS));
 
@@ -0,0 +1,445 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "PayloadCodec.hpp"
+#include "MQTTPubSubClient.hpp"
+#include "Logger.hpp"
+#include "EnvironmentVarHandler.hpp"
+#include <zstd.h>
+#include <zdict.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <tuple>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+	/** zstd contexts of a thread; contexts are reused for every message compressed by thread */
+	struct stZstdContexts
+	{
+		ZSTD_CCtx *m_pCCtx = NULL; /** compression context*/
+		ZSTD_DCtx *m_pDCtx = NULL; /** decompression context*/
+
+		~stZstdContexts()
+		{
+			ZSTD_freeCCtx(m_pCCtx);
+			ZSTD_freeDCtx(m_pDCtx);
+		}
+	};
+
+	thread_local stZstdContexts g_stZstdCtx;
+
+	/**
+	 * Checks if string ends with given suffix
+	 * @param a_sStr :[in] string to check
+	 * @param a_pcSuffix :[in] suffix
+	 * @return true if string ends with suffix
+	 */
+	bool endsWith(const std::string &a_sStr, const char *a_pcSuffix)
+	{
+		size_t uiLen = strlen(a_pcSuffix);
+		return (a_sStr.size() >= uiLen) && (0 == a_sStr.compare(a_sStr.size() - uiLen, uiLen, a_pcSuffix));
+	}
+}
+
+/**
+ * Constructor
+ * @param a_stConfig :[in] codec configuration
+ * @return None
+ */
+CPayloadCodec::CPayloadCodec(const stPayloadCodecConfig &a_stConfig)
+	: m_stConfig(a_stConfig), m_pCDict{NULL}, m_pDDict{NULL}, m_uiDictID{0},
+	  m_ui64RawBytes{0}, m_ui64EncodedBytes{0}
+{
+	std::stringstream ss(m_stConfig.m_sTopics);
+	std::string sFilter;
+	while(std::getline(ss, sFilter, ','))
+	{
+		size_t uiStart = sFilter.find_first_not_of(" \t");
+		size_t uiEnd = sFilter.find_last_not_of(" \t");
+		if(std::string::npos != uiStart)
+		{
+			m_vTopicFilters.push_back(sFilter.substr(uiStart, uiEnd - uiStart + 1));
+		}
+	}
+
+	if(false == m_stConfig.m_sDictFile.empty())
+	{
+		std::ifstream ifs(m_stConfig.m_sDictFile, std::ios::binary);
+		std::string sDict((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+		if(sDict.empty() || (false == loadDictionary(sDict)))
+		{
+			DO_LOG_ERROR("Could not load compression dictionary " + m_stConfig.m_sDictFile +
+					", payloads are compressed without dictionary");
+		}
+	}
+
+	if(false == m_vTopicFilters.empty())
+	{
+		DO_LOG_INFO("Payload compression is enabled for " + std::to_string(m_vTopicFilters.size()) +
+				" topic filters, dictionary id: " + std::to_string(m_uiDictID));
+	}
+}
+
+/**
+ * Destructor
+ */
+CPayloadCodec::~CPayloadCodec()
+{
+	ZSTD_freeCDict(m_pCDict);
+	ZSTD_freeDDict(m_pDDict);
+}
+
+/**
+ * Gets instance of codec configured using environment variables
+ * @return reference of codec
+ */
+CPayloadCodec& CPayloadCodec::getInstance()
+{
+	static CPayloadCodec _self(readConfig());
+	return _self;
+}
+
+/**
+ * Reads codec configuration from environment variables MQTT_COMPRESS_TOPICS,
+ * MQTT_COMPRESS_DICT_FILE, MQTT_COMPRESS_LEVEL, MQTT_COMPRESS_MIN_BYTES,
+ * MQTT_DECOMPRESS_MAX_BYTES, MQTT_COMPRESS_SIGNAL ("suffix" or "property")
+ * and MQTT_SUBSCRIBE_COMPRESSED ("true" or "false"). User property needs MQTT v5
+ * connection (MQTT_V5), otherwise suffix is used.
+ * @return configuration
+ */
+stPayloadCodecConfig CPayloadCodec::readConfig()
+{
+	stPayloadCodecConfig stConfig;
+	auto getEnv = [](const char *a_pcName) -> std::string
+	{
+		const char *pcVal = std::getenv(a_pcName);
+		return (NULL == pcVal) ? "" : pcVal;
+	};
+
+	stConfig.m_sTopics = getEnv("MQTT_COMPRESS_TOPICS");
+	stConfig.m_sDictFile = getEnv("MQTT_COMPRESS_DICT_FILE");
+	// negative (fast) zstd levels are not supported
+	stConfig.m_iLevel = (int)EnvironmentInfo::getEnvNum("MQTT_COMPRESS_LEVEL", stConfig.m_iLevel, 1,
+			(unsigned long)ZSTD_maxCLevel());
+	stConfig.m_uiMinBytes = (size_t)EnvironmentInfo::getEnvNum("MQTT_COMPRESS_MIN_BYTES", stConfig.m_uiMinBytes);
+	stConfig.m_uiMaxBytes = (size_t)EnvironmentInfo::getEnvNum("MQTT_DECOMPRESS_MAX_BYTES", stConfig.m_uiMaxBytes, 1);
+	stConfig.m_eSignal = (getEnv("MQTT_COMPRESS_SIGNAL") == "property") ? enCODEC_SIGNAL_PROPERTY : enCODEC_SIGNAL_SUFFIX;
+	if((enCODEC_SIGNAL_PROPERTY == stConfig.m_eSignal) && (false == CMQTTPubSubClient::readV5Config().m_bIsEnabled))
+	{
+		DO_LOG_WARN("MQTT_COMPRESS_SIGNAL property needs MQTT_V5, compressed messages are signalled by topic suffix");
+		stConfig.m_eSignal = enCODEC_SIGNAL_SUFFIX;
+	}
+	stConfig.m_bSubscribeSuffix = (getEnv("MQTT_SUBSCRIBE_COMPRESSED") == "true");
+	return stConfig;
+}
+
+/**
+ * Digests dictionary for compression and decompression
+ * @param a_sDict :[in] dictionary content
+ * @return true/false based on success/failure
+ */
+bool CPayloadCodec::loadDictionary(const std::string &a_sDict)
+{
+	m_pCDict = ZSTD_createCDict(a_sDict.data(), a_sDict.size(), m_stConfig.m_iLevel);
+	m_pDDict = ZSTD_createDDict(a_sDict.data(), a_sDict.size());
+	if((NULL == m_pCDict) || (NULL == m_pDDict))
+	{
+		ZSTD_freeCDict(m_pCDict);
+		ZSTD_freeDDict(m_pDDict);
+		m_pCDict = NULL;
+		m_pDDict = NULL;
+		return false;
+	}
+	m_uiDictID = ZSTD_getDictID_fromDict(a_sDict.data(), a_sDict.size());
+	return true;
+}
+
+/**
+ * Checks if topic matches an MQTT topic filter, which may have wildcards '+' and '#'
+ * @param a_sFilter :[in] topic filter
+ * @param a_sTopic :[in] topic
+ * @return true if topic matches filter
+ */
+bool CPayloadCodec::matchTopic(const std::string &a_sFilter, const std::string &a_sTopic)
+{
+	size_t uiF = 0;
+	size_t uiT = 0;
+	while(uiF < a_sFilter.size())
+	{
+		size_t uiFEnd = a_sFilter.find('/', uiF);
+		if(std::string::npos == uiFEnd)
+		{
+			uiFEnd = a_sFilter.size();
+		}
+		if((1 == uiFEnd - uiF) && ('#' == a_sFilter[uiF]))
+		{
+			// matches parent level and all levels below it
+			return true;
+		}
+		if(uiT > a_sTopic.size())
+		{
+			return false;
+		}
+		size_t uiTEnd = a_sTopic.find('/', uiT);
+		if(std::string::npos == uiTEnd)
+		{
+			uiTEnd = a_sTopic.size();
+		}
+		bool bIsWildcard = (1 == uiFEnd - uiF) && ('+' == a_sFilter[uiF]);
+		if((false == bIsWildcard) &&
+			(0 != a_sFilter.compare(uiF, uiFEnd - uiF, a_sTopic, uiT, uiTEnd - uiT)))
+		{
+			return false;
+		}
+		uiF = uiFEnd + 1;
+		uiT = uiTEnd + 1;
+	}
+	// both filter and topic are fully consumed; a trailing '/' in one of them is a level of its own
+	return (uiT == a_sTopic.size() + 1) && (uiF == a_sFilter.size() + 1);
+}
+
+/**
+ * Trains zstd dictionary from sample payloads
+ * @param a_vSamples :[in] sample payloads
+ * @param a_uiDictBytes :[in] max size of dictionary
+ * @param a_sDict :[out] dictionary
+ * @return true/false based on success/failure
+ */
+bool CPayloadCodec::trainDictionary(const std::vector<std::string> &a_vSamples, size_t a_uiDictBytes, std::string &a_sDict)
+{
+	std::string sSamples;
+	std::vector<size_t> vSizes;
+	vSizes.reserve(a_vSamples.size());
+	for(const auto &sSample : a_vSamples)
+	{
+		sSamples += sSample;
+		vSizes.push_back(sSample.size());
+	}
+	a_sDict.resize(a_uiDictBytes);
+	size_t uiRet = ZDICT_trainFromBuffer(&a_sDict[0], a_sDict.size(), sSamples.data(), vSizes.data(), (unsigned)vSizes.size());
+	if(ZDICT_isError(uiRet))
+	{
+		DO_LOG_ERROR("Could not train compression dictionary: " + std::string(ZDICT_getErrorName(uiRet)));
+		a_sDict.clear();
+		return false;
+	}
+	a_sDict.resize(uiRet);
+	return true;
+}
+
+/**
+ * Checks if payloads of topic are to be compressed
+ * @param a_sTopic :[in] topic
+ * @return true if topic matches a configured topic filter
+ */
+bool CPayloadCodec::isCompressedTopic(const std::string &a_sTopic) const
+{
+	for(const auto &sFilter : m_vTopicFilters)
+	{
+		if(true == matchTopic(sFilter, a_sTopic))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Compresses payload using dictionary, if configured. Content size is stored in frame.
+ * @param a_sIn :[in] payload
+ * @param a_sOut :[out] compressed payload
+ * @return true/false based on success/failure
+ */
+bool CPayloadCodec::compress(const std::string &a_sIn, std::string &a_sOut)
+{
+	if(NULL == g_stZstdCtx.m_pCCtx)
+	{
+		g_stZstdCtx.m_pCCtx = ZSTD_createCCtx();
+		if(NULL == g_stZstdCtx.m_pCCtx)
+		{
+			return false;
+		}
+	}
+	a_sOut.resize(ZSTD_compressBound(a_sIn.size()));
+	size_t uiRet = (NULL != m_pCDict) ?
+			ZSTD_compress_usingCDict(g_stZstdCtx.m_pCCtx, &a_sOut[0], a_sOut.size(), a_sIn.data(), a_sIn.size(), m_pCDict) :
+			ZSTD_compressCCtx(g_stZstdCtx.m_pCCtx, &a_sOut[0], a_sOut.size(), a_sIn.data(), a_sIn.size(), m_stConfig.m_iLevel);
+	if(ZSTD_isError(uiRet))
+	{
+		DO_LOG_ERROR("Payload compression failed: " + std::string(ZSTD_getErrorName(uiRet)));
+		a_sOut.clear();
+		return false;
+	}
+	a_sOut.resize(uiRet);
+	m_ui64RawBytes.fetch_add(a_sIn.size(), std::memory_order_relaxed);
+	m_ui64EncodedBytes.fetch_add(uiRet, std::memory_order_relaxed);
+	return true;
+}
+
+/**
+ * Decompresses payload. Frames needing another dictionary and payloads larger than
+ * configured max size are rejected.
+ * @param a_sIn :[in] compressed payload
+ * @param a_sOut :[out] payload
+ * @return true/false based on success/failure
+ */
+bool CPayloadCodec::decompress(const std::string &a_sIn, std::string &a_sOut)
+{
+	unsigned long long ullSize = ZSTD_getFrameContentSize(a_sIn.data(), a_sIn.size());
+	if((ZSTD_CONTENTSIZE_ERROR == ullSize) || (ZSTD_CONTENTSIZE_UNKNOWN == ullSize))
+	{
+		DO_LOG_ERROR("Compressed payload is not a zstd frame with content size");
+		return false;
+	}
+	if(ullSize > m_stConfig.m_uiMaxBytes)
+	{
+		DO_LOG_ERROR("Decompressed payload size " + std::to_string(ullSize) + " is more than allowed");
+		return false;
+	}
+	unsigned uiDictID = ZSTD_getDictID_fromFrame(a_sIn.data(), a_sIn.size());
+	if((0 != uiDictID) && (uiDictID != m_uiDictID))
+	{
+		DO_LOG_ERROR("Compressed payload needs dictionary id " + std::to_string(uiDictID) +
+				", loaded dictionary id is " + std::to_string(m_uiDictID));
+		return false;
+	}
+	if(NULL == g_stZstdCtx.m_pDCtx)
+	{
+		g_stZstdCtx.m_pDCtx = ZSTD_createDCtx();
+		if(NULL == g_stZstdCtx.m_pDCtx)
+		{
+			return false;
+		}
+	}
+
+	a_sOut.resize((size_t)ullSize);
+	size_t uiRet = (NULL != m_pDDict) ?
+			ZSTD_decompress_usingDDict(g_stZstdCtx.m_pDCtx, &a_sOut[0], a_sOut.size(), a_sIn.data(), a_sIn.size(), m_pDDict) :
+			ZSTD_decompressDCtx(g_stZstdCtx.m_pDCtx, &a_sOut[0], a_sOut.size(), a_sIn.data(), a_sIn.size());
+	if(ZSTD_isError(uiRet) || (uiRet != a_sOut.size()))
+	{
+		DO_LOG_ERROR("Payload decompression failed: " +
+				std::string(ZSTD_isError(uiRet) ? ZSTD_getErrorName(uiRet) : "size mismatch"));
+		a_sOut.clear();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Creates MQTT message to publish. Payload of configured topics is compressed and
+ * message is marked as compressed using topic suffix or user property.
+ * Payload is sent as is if it is small or if compression fails.
+ * @param a_sTopic :[in] topic
+ * @param a_sPayload :[in] payload
+ * @param a_iQOS :[in] QoS
+ * @param a_bRetained :[in] retained flag
+ * @return message to publish
+ */
+mqtt::message_ptr CPayloadCodec::encodeMsg(const std::string &a_sTopic, const std::string &a_sPayload,
+		int a_iQOS, bool a_bRetained)
+{
+	std::string sCompressed;
+	if((a_sPayload.size() < m_stConfig.m_uiMinBytes) || (false == isCompressedTopic(a_sTopic)) ||
+		(false == compress(a_sPayload, sCompressed)))
+	{
+		return mqtt::make_message(a_sTopic, a_sPayload, a_iQOS, a_bRetained);
+	}
+
+	if(enCODEC_SIGNAL_SUFFIX == m_stConfig.m_eSignal)
+	{
+		return mqtt::make_message(a_sTopic + PAYLOAD_CODEC_TOPIC_SUFFIX, sCompressed, a_iQOS, a_bRetained);
+	}
+	mqtt::message_ptr pMsg = mqtt::make_message(a_sTopic, sCompressed, a_iQOS, a_bRetained);
+	mqtt::properties props;
+	props.add(mqtt::property(mqtt::property::USER_PROPERTY,
+			std::string(PAYLOAD_CODEC_PROPERTY_NAME), std::string(PAYLOAD_CODEC_PROPERTY_VALUE)));
+	pMsg->set_properties(props);
+	return pMsg;
+}
+
+/**
+ * Replaces a message marked as compressed with decompressed message having original topic.
+ * Messages which are not marked are left as is.
+ * @param a_pMsg :[in,out] received message
+ * @return false if message is marked as compressed and could not be decompressed
+ */
+bool CPayloadCodec::decodeMsg(mqtt::const_message_ptr &a_pMsg)
+{
+	if(NULL == a_pMsg)
+	{
+		return false;
+	}
+	const std::string &sTopic = a_pMsg->get_topic();
+	bool bIsSuffix = endsWith(sTopic, PAYLOAD_CODEC_TOPIC_SUFFIX);
+	bool bIsProperty = false;
+	if(false == bIsSuffix)
+	{
+		const mqtt::properties &props = a_pMsg->get_properties();
+		size_t uiCount = props.count(mqtt::property::USER_PROPERTY);
+		for(size_t i = 0; (i < uiCount) && (false == bIsProperty); ++i)
+		{
+			mqtt::string_pair prop = mqtt::get<mqtt::string_pair>(props.get(mqtt::property::USER_PROPERTY, i));
+			bIsProperty = (std::get<0>(prop) == PAYLOAD_CODEC_PROPERTY_NAME) &&
+					(std::get<1>(prop) == PAYLOAD_CODEC_PROPERTY_VALUE);
+		}
+	}
+	if((false == bIsSuffix) && (false == bIsProperty))
+	{
+		return true;
+	}
+
+	std::string sPayload;
+	if(false == decompress(a_pMsg->get_payload(), sPayload))
+	{
+		DO_LOG_ERROR(sTopic + " : compressed message is discarded");
+		return false;
+	}
+	std::string sOrgTopic = bIsSuffix ?
+			sTopic.substr(0, sTopic.size() - strlen(PAYLOAD_CODEC_TOPIC_SUFFIX)) : sTopic;
+	mqtt::message_ptr pMsg = mqtt::make_message(sOrgTopic, sPayload, a_pMsg->get_qos(), a_pMsg->is_retained());
+	// other properties e.g. timestamps are kept
+	pMsg->set_properties(a_pMsg->get_properties());
+	a_pMsg = pMsg;
+	return true;
+}
+
+/**
+ * Gets topic filters to subscribe for a topic filter. When suffix signalling is used,
+ * compressed messages are published on topics having suffix, which are subscribed
+ * as well if MQTT_SUBSCRIBE_COMPRESSED is set.
+ * @param a_sTopic :[in] topic filter
+ * @return topic filters to subscribe
+ */
+std::vector<std::string> CPayloadCodec::getSubscribeTopics(const std::string &a_sTopic) const
+{
+	std::vector<std::string> vTopics{a_sTopic};
+	// '#' matches topics having suffix too
+	if((true == m_stConfig.m_bSubscribeSuffix) && (false == endsWith(a_sTopic, "#")))
+	{
+		vTopics.push_back(a_sTopic + PAYLOAD_CODEC_TOPIC_SUFFIX);
+	}
+	return vTopics;
+}
@@ -0,0 +1,985 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "PersistentOutbox.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Magic at start of each segment file */
+#define OUTBOX_SEGMENT_MAGIC 0x3130584F42435755ULL /* "UWCBOX01" */
+/** Size of segment header; records start after it */
+#define OUTBOX_SEGMENT_HDR_SIZE 64
+/** Magic at start of each record; written last so that a torn record is not valid */
+#define OUTBOX_RECORD_MAGIC 0x5243424FU /* "OBCR" */
+/** Magic used to validate checkpoint slots */
+#define OUTBOX_CKPT_MAGIC 0x54504B4358424F55ULL
+/** Name of checkpoint file */
+#define OUTBOX_CKPT_FILE "checkpoint"
+/** Extension of segment files */
+#define OUTBOX_SEGMENT_EXT ".seg"
+
+namespace
+{
+	/** Header of a record. Topic, payload and user properties follow it; record is padded to 8 bytes */
+	struct stOutboxRecordHdr
+	{
+		uint32_t m_uiMagic; /** OUTBOX_RECORD_MAGIC*/
+		uint32_t m_uiCrc; /** CRC32 of header fields after this one, topic, payload and user properties*/
+		uint64_t m_uiId; /** record id*/
+		uint64_t m_uiTsMs; /** time of storing, ms since epoch*/
+		uint32_t m_uiTopicLen; /** topic length*/
+		uint32_t m_uiPayloadLen; /** payload length*/
+		uint8_t m_uiQos; /** QoS*/
+		uint8_t m_uiIsRetained; /** retained flag*/
+		uint16_t m_uiReserved;
+		uint32_t m_uiPropsLen; /** length of encoded user properties; 0 in records of earlier versions*/
+	};
+
+	/** Size of header fields covered by CRC */
+	const size_t CRC_HDR_OFFSET = offsetof(stOutboxRecordHdr, m_uiId);
+
+	/**
+	 * Returns size of a record rounded up to 8 bytes
+	 * @param a_uiTopicLen :[in] topic length
+	 * @param a_uiPayloadLen :[in] payload length
+	 * @param a_uiPropsLen :[in] length of encoded user properties
+	 * @return record size
+	 */
+	inline size_t recordSize(size_t a_uiTopicLen, size_t a_uiPayloadLen, size_t a_uiPropsLen)
+	{
+		return (sizeof(stOutboxRecordHdr) + a_uiTopicLen + a_uiPayloadLen + a_uiPropsLen + 7) & ~(size_t)7;
+	}
+
+	/**
+	 * Encodes user properties as length prefixed name and value of each property
+	 * @param a_vecUserProps :[in] user properties
+	 * @return encoded properties
+	 */
+	std::string encodeUserProps(const outbox_user_props_t &a_vecUserProps)
+	{
+		std::string sEncoded;
+		for(const auto &itr : a_vecUserProps)
+		{
+			for(const std::string *psPart : {&itr.first, &itr.second})
+			{
+				uint32_t uiLen = (uint32_t)psPart->size();
+				sEncoded.append(reinterpret_cast<const char*>(&uiLen), sizeof(uiLen));
+				sEncoded.append(*psPart);
+			}
+		}
+		return sEncoded;
+	}
+
+	/**
+	 * Decodes user properties encoded by encodeUserProps()
+	 * @param a_pcData :[in] encoded properties
+	 * @param a_uiLen :[in] length of encoded properties
+	 * @param a_vecUserProps :[out] user properties
+	 * @return true if properties are decoded
+	 */
+	bool decodeUserProps(const char *a_pcData, size_t a_uiLen, outbox_user_props_t &a_vecUserProps)
+	{
+		a_vecUserProps.clear();
+		size_t uiOffset = 0;
+		while(uiOffset < a_uiLen)
+		{
+			std::string asPart[2];
+			for(std::string &sPart : asPart)
+			{
+				uint32_t uiLen = 0;
+				if(a_uiLen - uiOffset < sizeof(uiLen))
+				{
+					return false;
+				}
+				memcpy(&uiLen, a_pcData + uiOffset, sizeof(uiLen));
+				uiOffset += sizeof(uiLen);
+				if(a_uiLen - uiOffset < uiLen)
+				{
+					return false;
+				}
+				sPart.assign(a_pcData + uiOffset, uiLen);
+				uiOffset += uiLen;
+			}
+			a_vecUserProps.emplace_back(std::move(asPart[0]), std::move(asPart[1]));
+		}
+		return true;
+	}
+
+	/**
+	 * Returns current time in ms since epoch
+	 * @return time in ms
+	 */
+	inline uint64_t nowMs()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	 * Returns monotonic time in ms
+	 * @return time in ms
+	 */
+	inline uint64_t monotonicMs()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	 * Creates a directory and its parents
+	 * @param a_sDir :[in] directory path
+	 * @return true if directory exists or is created
+	 */
+	bool makeDirs(const std::string &a_sDir)
+	{
+		size_t uiPos = 0;
+		do
+		{
+			uiPos = a_sDir.find('/', uiPos + 1);
+			std::string sPart = a_sDir.substr(0, uiPos);
+			if((0 != mkdir(sPart.c_str(), 0750)) && (EEXIST != errno))
+			{
+				return false;
+			}
+		} while(std::string::npos != uiPos);
+		return true;
+	}
+}
+
+/**
+ * Constructor
+ */
+CPersistentOutbox::CPersistentOutbox() : m_bIsOpen{false}, m_uiNextId{1}, m_uiReadId{1},
+		m_stReadPos{0, OUTBOX_SEGMENT_HDR_SIZE}, m_uiAckedId{0}, m_uiCkptSeq{0}, m_uiCkptSyncMs{0},
+		m_iCkptFd{-1}, m_pCkpt{NULL}, m_uiDropped{0}, m_uiExpired{0}
+{
+}
+
+/**
+ * Destructor
+ */
+CPersistentOutbox::~CPersistentOutbox()
+{
+	close();
+}
+
+/**
+ * Calculates CRC32 (IEEE 802.3 polynomial)
+ * @param a_uiCrc :[in] CRC of preceding data; 0 for first block
+ * @param a_pData :[in] data
+ * @param a_uiLen :[in] data length
+ * @return CRC
+ */
+uint32_t CPersistentOutbox::crc32(uint32_t a_uiCrc, const void *a_pData, size_t a_uiLen)
+{
+	static uint32_t s_auiTable[256] = {0};
+	static bool s_bIsTableReady = [](uint32_t *a_puiTable) {
+		for(uint32_t i = 0; i < 256; ++i)
+		{
+			uint32_t uiVal = i;
+			for(int j = 0; j < 8; ++j)
+			{
+				uiVal = (uiVal & 1) ? (0xEDB88320U ^ (uiVal >> 1)) : (uiVal >> 1);
+			}
+			a_puiTable[i] = uiVal;
+		}
+		return true;
+	}(s_auiTable);
+	(void)s_bIsTableReady;
+
+	const uint8_t *puiData = static_cast<const uint8_t*>(a_pData);
+	uint32_t uiCrc = ~a_uiCrc;
+	for(size_t i = 0; i < a_uiLen; ++i)
+	{
+		uiCrc = s_auiTable[(uiCrc ^ puiData[i]) & 0xFF] ^ (uiCrc >> 8);
+	}
+	return ~uiCrc;
+}
+
+/**
+ * Returns path of a segment file
+ * @param a_uiSegNo :[in] segment number
+ * @return path
+ */
+std::string CPersistentOutbox::segmentPath(uint64_t a_uiSegNo) const
+{
+	char acName[32];
+	snprintf(acName, sizeof(acName), "%016llu" OUTBOX_SEGMENT_EXT, (unsigned long long)a_uiSegNo);
+	return m_stConfig.m_sDir + "/" + acName;
+}
+
+/**
+ * Opens or creates a segment file and maps it. A new segment is sized as configured;
+ * an existing one is mapped with its own size, so its records are kept if segment size
+ * is changed.
+ * @param a_uiSegNo :[in] segment number
+ * @param a_bIsNew :[in] true to create segment, false to open existing one
+ * @param a_stSeg :[out] mapped segment
+ * @return true on success
+ */
+bool CPersistentOutbox::mapSegment(uint64_t a_uiSegNo, bool a_bIsNew, stSegment &a_stSeg)
+{
+	std::string sPath = segmentPath(a_uiSegNo);
+	int iFd = ::open(sPath.c_str(), a_bIsNew ? (O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC) : (O_RDWR | O_CLOEXEC), 0640);
+	if(iFd < 0)
+	{
+		DO_LOG_ERROR("Cannot open outbox segment " + sPath + ": " + strerror(errno));
+		return false;
+	}
+	size_t uiSize = m_stConfig.m_uiSegmentSize;
+	if(a_bIsNew)
+	{
+		if(0 != ftruncate(iFd, uiSize))
+		{
+			DO_LOG_ERROR("Cannot size outbox segment " + sPath + ": " + strerror(errno));
+			::close(iFd);
+			unlink(sPath.c_str());
+			return false;
+		}
+	}
+	else
+	{
+		struct stat stFile;
+		if(0 != fstat(iFd, &stFile))
+		{
+			DO_LOG_ERROR("Cannot read size of outbox segment " + sPath + ": " + strerror(errno));
+			::close(iFd);
+			return false;
+		}
+		uiSize = (size_t)stFile.st_size;
+		if(uiSize < OUTBOX_SEGMENT_HDR_SIZE)
+		{
+			DO_LOG_ERROR("Outbox segment is incomplete: " + sPath);
+			::close(iFd);
+			return false;
+		}
+	}
+	void *pBase = mmap(NULL, uiSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+	if(MAP_FAILED == pBase)
+	{
+		DO_LOG_ERROR("Cannot map outbox segment " + sPath + ": " + strerror(errno));
+		::close(iFd);
+		return false;
+	}
+
+	a_stSeg.m_uiNumber = a_uiSegNo;
+	a_stSeg.m_iFd = iFd;
+	a_stSeg.m_pcBase = static_cast<char*>(pBase);
+	a_stSeg.m_uiSize = uiSize;
+	a_stSeg.m_uiFirstId = 0;
+	a_stSeg.m_uiLastId = 0;
+	a_stSeg.m_uiEnd = OUTBOX_SEGMENT_HDR_SIZE;
+
+	if(a_bIsNew)
+	{
+		uint64_t uiMagic = OUTBOX_SEGMENT_MAGIC;
+		memcpy(a_stSeg.m_pcBase, &uiMagic, sizeof(uiMagic));
+		memcpy(a_stSeg.m_pcBase + sizeof(uiMagic), &a_uiSegNo, sizeof(a_uiSegNo));
+	}
+	return true;
+}
+
+/**
+ * Unmaps a segment and optionally removes its file
+ * @param a_stSeg :[in] segment
+ * @param a_bIsRemove :[in] true to remove file
+ * @return None
+ */
+void CPersistentOutbox::unmapSegment(stSegment &a_stSeg, bool a_bIsRemove)
+{
+	if(NULL != a_stSeg.m_pcBase)
+	{
+		msync(a_stSeg.m_pcBase, a_stSeg.m_uiSize, MS_ASYNC);
+		munmap(a_stSeg.m_pcBase, a_stSeg.m_uiSize);
+		a_stSeg.m_pcBase = NULL;
+	}
+	if(a_stSeg.m_iFd >= 0)
+	{
+		::close(a_stSeg.m_iFd);
+		a_stSeg.m_iFd = -1;
+	}
+	if(a_bIsRemove)
+	{
+		unlink(segmentPath(a_stSeg.m_uiNumber).c_str());
+	}
+}
+
+/**
+ * Finds valid records of a segment. Scanning stops at first record which is
+ * incomplete or fails CRC check.
+ * @param a_stSeg :[in,out] segment
+ * @return None
+ */
+void CPersistentOutbox::scanSegment(stSegment &a_stSeg)
+{
+	size_t uiOffset = OUTBOX_SEGMENT_HDR_SIZE;
+	while(uiOffset + sizeof(stOutboxRecordHdr) <= a_stSeg.m_uiSize)
+	{
+		stOutboxRecordHdr stHdr;
+		memcpy(&stHdr, a_stSeg.m_pcBase + uiOffset, sizeof(stHdr));
+		if(OUTBOX_RECORD_MAGIC != stHdr.m_uiMagic)
+		{
+			break;
+		}
+		size_t uiSize = recordSize(stHdr.m_uiTopicLen, stHdr.m_uiPayloadLen, stHdr.m_uiPropsLen);
+		if((uiOffset + uiSize > a_stSeg.m_uiSize) ||
+				((0 != a_stSeg.m_uiLastId) && (stHdr.m_uiId != a_stSeg.m_uiLastId + 1)))
+		{
+			DO_LOG_ERROR("Invalid record in outbox segment " + std::to_string(a_stSeg.m_uiNumber) +
+					" at offset " + std::to_string(uiOffset));
+			break;
+		}
+		uint32_t uiCrc = crc32(0, a_stSeg.m_pcBase + uiOffset + CRC_HDR_OFFSET,
+				sizeof(stOutboxRecordHdr) - CRC_HDR_OFFSET + stHdr.m_uiTopicLen + stHdr.m_uiPayloadLen +
+				stHdr.m_uiPropsLen);
+		if(uiCrc != stHdr.m_uiCrc)
+		{
+			DO_LOG_ERROR("CRC mismatch in outbox segment " + std::to_string(a_stSeg.m_uiNumber) +
+					" at offset " + std::to_string(uiOffset));
+			break;
+		}
+		if(0 == a_stSeg.m_uiFirstId)
+		{
+			a_stSeg.m_uiFirstId = stHdr.m_uiId;
+		}
+		a_stSeg.m_uiLastId = stHdr.m_uiId;
+		uiOffset += uiSize;
+	}
+	a_stSeg.m_uiEnd = uiOffset;
+}
+
+/**
+ * Opens checkpoint file and reads id of last forwarded record
+ * @param None
+ * @return true on success
+ */
+bool CPersistentOutbox::openCheckpoint()
+{
+	std::string sPath = m_stConfig.m_sDir + "/" OUTBOX_CKPT_FILE;
+	m_iCkptFd = ::open(sPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0640);
+	if(m_iCkptFd < 0)
+	{
+		DO_LOG_ERROR("Cannot open outbox checkpoint " + sPath + ": " + strerror(errno));
+		return false;
+	}
+	const size_t uiSize = 2 * sizeof(stCheckpointSlot);
+	if(0 != ftruncate(m_iCkptFd, uiSize))
+	{
+		DO_LOG_ERROR("Cannot size outbox checkpoint " + sPath + ": " + strerror(errno));
+		return false;
+	}
+	void *pBase = mmap(NULL, uiSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_iCkptFd, 0);
+	if(MAP_FAILED == pBase)
+	{
+		DO_LOG_ERROR("Cannot map outbox checkpoint " + sPath + ": " + strerror(errno));
+		return false;
+	}
+	m_pCkpt = static_cast<stCheckpointSlot*>(pBase);
+
+	// slot written last has higher sequence; a slot torn by a crash fails the check
+	m_uiAckedId = 0;
+	m_uiCkptSeq = 0;
+	for(int i = 0; i < 2; ++i)
+	{
+		const stCheckpointSlot &stSlot = m_pCkpt[i];
+		if(((stSlot.m_uiSeq ^ stSlot.m_uiAckedId ^ OUTBOX_CKPT_MAGIC) == stSlot.m_uiCheck) &&
+				(stSlot.m_uiSeq >= m_uiCkptSeq) && (0 != stSlot.m_uiSeq))
+		{
+			m_uiCkptSeq = stSlot.m_uiSeq;
+			m_uiAckedId = stSlot.m_uiAckedId;
+		}
+	}
+	return true;
+}
+
+/**
+ * Writes id of last forwarded record to checkpoint file. File is synced to disk if
+ * OUTBOX_CKPT_SYNC_INTERVAL_MS has passed since last sync.
+ * @param a_bIsSyncNow :[in] true to sync file to disk irrespective of interval
+ * @return None
+ */
+void CPersistentOutbox::writeCheckpoint(bool a_bIsSyncNow)
+{
+	if(NULL == m_pCkpt)
+	{
+		return;
+	}
+	++m_uiCkptSeq;
+	stCheckpointSlot &stSlot = m_pCkpt[m_uiCkptSeq % 2];
+	stSlot.m_uiSeq = m_uiCkptSeq;
+	stSlot.m_uiAckedId = m_uiAckedId;
+	__atomic_store_n(&stSlot.m_uiCheck, m_uiCkptSeq ^ m_uiAckedId ^ OUTBOX_CKPT_MAGIC, __ATOMIC_RELEASE);
+
+	uint64_t uiNowMs = monotonicMs();
+	if(a_bIsSyncNow || (uiNowMs - m_uiCkptSyncMs >= OUTBOX_CKPT_SYNC_INTERVAL_MS))
+	{
+		if(0 != msync(m_pCkpt, 2 * sizeof(stCheckpointSlot), MS_SYNC))
+		{
+			DO_LOG_ERROR("Cannot sync outbox checkpoint: " + std::string(strerror(errno)));
+		}
+		m_uiCkptSyncMs = uiNowMs;
+	}
+}
+
+/**
+ * Returns segment having given number
+ * @param a_uiSegNo :[in] segment number
+ * @return segment, NULL if not present
+ */
+CPersistentOutbox::stSegment* CPersistentOutbox::findSegment(uint64_t a_uiSegNo)
+{
+	// segment numbers are consecutive
+	if(m_dqSegments.empty() || (a_uiSegNo < m_dqSegments.front().m_uiNumber))
+	{
+		return NULL;
+	}
+	size_t uiIdx = (size_t)(a_uiSegNo - m_dqSegments.front().m_uiNumber);
+	return (uiIdx < m_dqSegments.size()) ? &m_dqSegments[uiIdx] : NULL;
+}
+
+/**
+ * Opens outbox. Existing segments are scanned and forwarding resumes after
+ * the record stored in checkpoint.
+ * @param a_stConfig :[in] configuration
+ * @return true on success
+ */
+bool CPersistentOutbox::open(const stOutboxConfig &a_stConfig)
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	try
+	{
+		if(m_bIsOpen)
+		{
+			return true;
+		}
+		m_stConfig = a_stConfig;
+		// segment size is kept a multiple of page size
+		size_t uiPage = (size_t)sysconf(_SC_PAGESIZE);
+		m_stConfig.m_uiSegmentSize = std::max(m_stConfig.m_uiSegmentSize, (size_t)(64 * 1024));
+		m_stConfig.m_uiSegmentSize = (m_stConfig.m_uiSegmentSize + uiPage - 1) / uiPage * uiPage;
+		m_stConfig.m_uiMaxBytes = std::max(m_stConfig.m_uiMaxBytes, 2 * m_stConfig.m_uiSegmentSize);
+
+		if(m_stConfig.m_sDir.empty() || (false == makeDirs(m_stConfig.m_sDir)))
+		{
+			DO_LOG_ERROR("Cannot create outbox directory: " + m_stConfig.m_sDir);
+			return false;
+		}
+		if(false == openCheckpoint())
+		{
+			return false;
+		}
+
+		// find existing segments
+		std::vector<uint64_t> vSegNos;
+		DIR *pDir = opendir(m_stConfig.m_sDir.c_str());
+		if(NULL == pDir)
+		{
+			DO_LOG_ERROR("Cannot read outbox directory: " + m_stConfig.m_sDir);
+			return false;
+		}
+		struct dirent *pEntry = NULL;
+		while(NULL != (pEntry = readdir(pDir)))
+		{
+			std::string sName(pEntry->d_name);
+			size_t uiExtLen = strlen(OUTBOX_SEGMENT_EXT);
+			if((sName.size() > uiExtLen) &&
+					(0 == sName.compare(sName.size() - uiExtLen, uiExtLen, OUTBOX_SEGMENT_EXT)))
+			{
+				vSegNos.push_back(strtoull(sName.c_str(), NULL, 10));
+			}
+		}
+		closedir(pDir);
+		std::sort(vSegNos.begin(), vSegNos.end());
+
+		// keep consecutive segments ending with newest one
+		for(size_t i = 0; i < vSegNos.size(); ++i)
+		{
+			if((i + 1 < vSegNos.size()) && (vSegNos[i] + 1 != vSegNos[i + 1]))
+			{
+				for(auto &stSeg : m_dqSegments)
+				{
+					unmapSegment(stSeg, false);
+				}
+				m_dqSegments.clear();
+				DO_LOG_ERROR("Outbox segments are not consecutive, ignoring segments up to " +
+						std::to_string(vSegNos[i]));
+				continue;
+			}
+			stSegment stSeg;
+			if(false == mapSegment(vSegNos[i], false, stSeg))
+			{
+				if(i + 1 < vSegNos.size())
+				{
+					return false;
+				}
+				// newest segment whose creation was interrupted holds no records
+				unlink(segmentPath(vSegNos[i]).c_str());
+				continue;
+			}
+			scanSegment(stSeg);
+			m_dqSegments.push_back(stSeg);
+		}
+
+		if(m_dqSegments.empty())
+		{
+			stSegment stSeg;
+			if(false == mapSegment(vSegNos.empty() ? 1 : vSegNos.back() + 1, true, stSeg))
+			{
+				return false;
+			}
+			m_dqSegments.push_back(stSeg);
+		}
+		else
+		{
+			// remove what follows last valid record, as it can be part of a torn write
+			stSegment &stLast = m_dqSegments.back();
+			memset(stLast.m_pcBase + stLast.m_uiEnd, 0, stLast.m_uiSize - stLast.m_uiEnd);
+		}
+
+		m_uiNextId = m_uiAckedId + 1;
+		for(auto itr = m_dqSegments.rbegin(); itr != m_dqSegments.rend(); ++itr)
+		{
+			if(0 != itr->m_uiLastId)
+			{
+				m_uiNextId = std::max(m_uiNextId, itr->m_uiLastId + 1);
+				break;
+			}
+		}
+		m_uiReadId = m_uiAckedId + 1;
+		m_stReadPos.m_uiSegNo = m_dqSegments.front().m_uiNumber;
+		m_stReadPos.m_uiOffset = OUTBOX_SEGMENT_HDR_SIZE;
+		m_bIsOpen = true;
+		releaseForwardedSegments();
+
+		DO_LOG_INFO("Outbox opened: " + m_stConfig.m_sDir + ", pending messages: " +
+				std::to_string(m_uiNextId - 1 - m_uiAckedId));
+		return true;
+	}
+	catch(std::exception &e)
+	{
+		DO_LOG_ERROR(e.what());
+	}
+	return false;
+}
+
+/**
+ * Closes outbox. Data is flushed to files.
+ * @param None
+ * @return None
+ */
+void CPersistentOutbox::close()
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	for(auto &stSeg : m_dqSegments)
+	{
+		unmapSegment(stSeg, false);
+	}
+	m_dqSegments.clear();
+	if(NULL != m_pCkpt)
+	{
+		msync(m_pCkpt, 2 * sizeof(stCheckpointSlot), MS_SYNC);
+		munmap(m_pCkpt, 2 * sizeof(stCheckpointSlot));
+		m_pCkpt = NULL;
+	}
+	if(m_iCkptFd >= 0)
+	{
+		::close(m_iCkptFd);
+		m_iCkptFd = -1;
+	}
+	m_dqUnacked.clear();
+	m_setAckedAhead.clear();
+	m_bIsOpen = false;
+}
+
+/**
+ * Drops oldest segment to keep outbox within size retention
+ * @param None
+ * @return None
+ */
+void CPersistentOutbox::dropOldestSegment()
+{
+	stSegment &stSeg = m_dqSegments.front();
+	if((0 != stSeg.m_uiLastId) && (stSeg.m_uiLastId > m_uiAckedId))
+	{
+		uint64_t uiFrom = std::max(stSeg.m_uiFirstId, m_uiAckedId + 1);
+		uint64_t uiCount = stSeg.m_uiLastId - uiFrom + 1;
+		m_uiDropped += uiCount;
+		DO_LOG_ERROR("Outbox is full, dropping " + std::to_string(uiCount) + " oldest messages from " +
+				m_stConfig.m_sDir);
+		m_uiAckedId = stSeg.m_uiLastId;
+		writeCheckpoint(true);
+	}
+	unmapSegment(stSeg, true);
+	m_dqSegments.pop_front();
+
+	// reading continues from next segment
+	if(m_uiReadId <= m_uiAckedId)
+	{
+		m_uiReadId = m_uiAckedId + 1;
+		m_stReadPos.m_uiSegNo = m_dqSegments.front().m_uiNumber;
+		m_stReadPos.m_uiOffset = OUTBOX_SEGMENT_HDR_SIZE;
+	}
+	while((false == m_dqUnacked.empty()) && (m_dqUnacked.front().first <= m_uiAckedId))
+	{
+		m_dqUnacked.pop_front();
+	}
+	m_setAckedAhead.erase(m_setAckedAhead.begin(), m_setAckedAhead.upper_bound(m_uiAckedId));
+}
+
+/**
+ * Adds a new segment for writing, dropping oldest ones beyond size retention
+ * @param None
+ * @return true on success
+ */
+bool CPersistentOutbox::addSegment()
+{
+	stSegment &stLast = m_dqSegments.back();
+	msync(stLast.m_pcBase, stLast.m_uiSize, MS_ASYNC);
+
+	while((m_dqSegments.size() + 1) * m_stConfig.m_uiSegmentSize > m_stConfig.m_uiMaxBytes)
+	{
+		dropOldestSegment();
+	}
+
+	stSegment stSeg;
+	if(false == mapSegment(m_dqSegments.back().m_uiNumber + 1, true, stSeg))
+	{
+		return false;
+	}
+	m_dqSegments.push_back(stSeg);
+	return true;
+}
+
+/**
+ * Removes segments whose records are all forwarded. Segment being written is kept.
+ * @param None
+ * @return None
+ */
+void CPersistentOutbox::releaseForwardedSegments()
+{
+	while((m_dqSegments.size() > 1) && (m_dqSegments.front().m_uiLastId <= m_uiAckedId) &&
+			(m_stReadPos.m_uiSegNo > m_dqSegments.front().m_uiNumber))
+	{
+		unmapSegment(m_dqSegments.front(), true);
+		m_dqSegments.pop_front();
+	}
+}
+
+/**
+ * Stores a message at end of outbox
+ * @param a_sTopic :[in] topic
+ * @param a_sPayload :[in] payload
+ * @param a_iQos :[in] QoS
+ * @param a_bIsRetained :[in] retained flag
+ * @param a_vecUserProps :[in] MQTT v5 user properties
+ * @return true if message is stored
+ */
+bool CPersistentOutbox::append(const std::string &a_sTopic, const std::string &a_sPayload, int a_iQos, bool a_bIsRetained,
+		const outbox_user_props_t &a_vecUserProps)
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	try
+	{
+		if(false == m_bIsOpen)
+		{
+			return false;
+		}
+		std::string sProps = encodeUserProps(a_vecUserProps);
+		size_t uiSize = recordSize(a_sTopic.size(), a_sPayload.size(), sProps.size());
+		if(uiSize > m_stConfig.m_uiSegmentSize - OUTBOX_SEGMENT_HDR_SIZE)
+		{
+			DO_LOG_ERROR("Message too large for outbox, topic: " + a_sTopic);
+			return false;
+		}
+		if(m_dqSegments.back().m_uiEnd + uiSize > m_dqSegments.back().m_uiSize)
+		{
+			if(false == addSegment())
+			{
+				return false;
+			}
+		}
+
+		stSegment &stSeg = m_dqSegments.back();
+		char *pcRecord = stSeg.m_pcBase + stSeg.m_uiEnd;
+
+		stOutboxRecordHdr stHdr;
+		memset(&stHdr, 0, sizeof(stHdr));
+		stHdr.m_uiId = m_uiNextId;
+		stHdr.m_uiTsMs = nowMs();
+		stHdr.m_uiTopicLen = (uint32_t)a_sTopic.size();
+		stHdr.m_uiPayloadLen = (uint32_t)a_sPayload.size();
+		stHdr.m_uiQos = (uint8_t)a_iQos;
+		stHdr.m_uiIsRetained = a_bIsRetained ? 1 : 0;
+		stHdr.m_uiPropsLen = (uint32_t)sProps.size();
+
+		memcpy(pcRecord + sizeof(stHdr), a_sTopic.data(), a_sTopic.size());
+		memcpy(pcRecord + sizeof(stHdr) + a_sTopic.size(), a_sPayload.data(), a_sPayload.size());
+		memcpy(pcRecord + sizeof(stHdr) + a_sTopic.size() + a_sPayload.size(), sProps.data(), sProps.size());
+		memcpy(pcRecord + CRC_HDR_OFFSET, reinterpret_cast<char*>(&stHdr) + CRC_HDR_OFFSET,
+				sizeof(stHdr) - CRC_HDR_OFFSET);
+		stHdr.m_uiCrc = crc32(0, pcRecord + CRC_HDR_OFFSET,
+				sizeof(stHdr) - CRC_HDR_OFFSET + a_sTopic.size() + a_sPayload.size() + sProps.size());
+		memcpy(pcRecord + offsetof(stOutboxRecordHdr, m_uiCrc), &stHdr.m_uiCrc, sizeof(stHdr.m_uiCrc));
+		__atomic_store_n(reinterpret_cast<uint32_t*>(pcRecord), OUTBOX_RECORD_MAGIC, __ATOMIC_RELEASE);
+
+		if(0 == stSeg.m_uiFirstId)
+		{
+			stSeg.m_uiFirstId = m_uiNextId;
+		}
+		stSeg.m_uiLastId = m_uiNextId;
+		stSeg.m_uiEnd += uiSize;
+		++m_uiNextId;
+		return true;
+	}
+	catch(std::exception &e)
+	{
+		DO_LOG_ERROR(e.what());
+	}
+	return false;
+}
+
+/**
+ * Reads next message to be forwarded. Messages older than time retention are skipped.
+ * Message is to be acknowledged using ack() once forwarded, or rewind() if forwarding failed.
+ * @param a_stMsg :[out] message
+ * @return true if a message is read, false if there is nothing to forward
+ */
+bool CPersistentOutbox::readNext(stOutboxMsg &a_stMsg)
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	try
+	{
+		if(false == m_bIsOpen)
+		{
+			return false;
+		}
+		uint64_t uiMinTsMs = 0;
+		if(0 != m_stConfig.m_uiMaxAgeSec)
+		{
+			uiMinTsMs = nowMs() - (uint64_t)m_stConfig.m_uiMaxAgeSec * 1000;
+		}
+
+		while(m_uiReadId < m_uiNextId)
+		{
+			stSegment *pSeg = findSegment(m_stReadPos.m_uiSegNo);
+			if(NULL == pSeg)
+			{
+				m_stReadPos.m_uiSegNo = m_dqSegments.front().m_uiNumber;
+				m_stReadPos.m_uiOffset = OUTBOX_SEGMENT_HDR_SIZE;
+				continue;
+			}
+			if(m_stReadPos.m_uiOffset >= pSeg->m_uiEnd)
+			{
+				if(pSeg == &m_dqSegments.back())
+				{
+					break;
+				}
+				++m_stReadPos.m_uiSegNo;
+				m_stReadPos.m_uiOffset = OUTBOX_SEGMENT_HDR_SIZE;
+				continue;
+			}
+
+			stOutboxRecordHdr stHdr;
+			const char *pcRecord = pSeg->m_pcBase + m_stReadPos.m_uiOffset;
+			memcpy(&stHdr, pcRecord, sizeof(stHdr));
+			stPos stRecordPos = m_stReadPos;
+			m_stReadPos.m_uiOffset += recordSize(stHdr.m_uiTopicLen, stHdr.m_uiPayloadLen, stHdr.m_uiPropsLen);
+
+			if(stHdr.m_uiId < m_uiReadId)
+			{
+				// already forwarded before restart
+				continue;
+			}
+			m_uiReadId = stHdr.m_uiId + 1;
+			if(m_setAckedAhead.end() != m_setAckedAhead.find(stHdr.m_uiId))
+			{
+				// forwarded before reading was rewound
+				continue;
+			}
+			if(stHdr.m_uiTsMs < uiMinTsMs)
+			{
+				++m_uiExpired;
+				m_dqUnacked.push_back(std::make_pair(stHdr.m_uiId, stRecordPos));
+				advanceAcked(stHdr.m_uiId);
+				continue;
+			}
+
+			a_stMsg.m_uiId = stHdr.m_uiId;
+			a_stMsg.m_uiTsMs = stHdr.m_uiTsMs;
+			a_stMsg.m_sTopic.assign(pcRecord + sizeof(stHdr), stHdr.m_uiTopicLen);
+			a_stMsg.m_sPayload.assign(pcRecord + sizeof(stHdr) + stHdr.m_uiTopicLen, stHdr.m_uiPayloadLen);
+			a_stMsg.m_iQos = stHdr.m_uiQos;
+			a_stMsg.m_bIsRetained = (0 != stHdr.m_uiIsRetained);
+			if(false == decodeUserProps(pcRecord + sizeof(stHdr) + stHdr.m_uiTopicLen + stHdr.m_uiPayloadLen,
+					stHdr.m_uiPropsLen, a_stMsg.m_vecUserProps))
+			{
+				DO_LOG_ERROR("Invalid user properties in outbox record " + std::to_string(stHdr.m_uiId));
+			}
+			m_dqUnacked.push_back(std::make_pair(stHdr.m_uiId, stRecordPos));
+			return true;
+		}
+	}
+	catch(std::exception &e)
+	{
+		DO_LOG_ERROR(e.what());
+	}
+	return false;
+}
+
+/**
+ * Marks a record as forwarded. Checkpoint advances over consecutive forwarded records.
+ * @param a_uiId :[in] record id
+ * @return None
+ */
+void CPersistentOutbox::advanceAcked(uint64_t a_uiId)
+{
+	if(a_uiId <= m_uiAckedId)
+	{
+		return;
+	}
+	if(a_uiId != m_uiAckedId + 1)
+	{
+		m_setAckedAhead.insert(a_uiId);
+		return;
+	}
+	m_uiAckedId = a_uiId;
+	auto itr = m_setAckedAhead.begin();
+	while((itr != m_setAckedAhead.end()) && (*itr == m_uiAckedId + 1))
+	{
+		m_uiAckedId = *itr;
+		itr = m_setAckedAhead.erase(itr);
+	}
+	writeCheckpoint();
+
+	while((false == m_dqUnacked.empty()) && (m_dqUnacked.front().first <= m_uiAckedId))
+	{
+		m_dqUnacked.pop_front();
+	}
+	releaseForwardedSegments();
+}
+
+/**
+ * Acknowledges that a record read using readNext() is forwarded
+ * @param a_uiId :[in] record id
+ * @return None
+ */
+void CPersistentOutbox::ack(uint64_t a_uiId)
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	if(m_bIsOpen)
+	{
+		advanceAcked(a_uiId);
+	}
+}
+
+/**
+ * Makes reading restart from given record, e.g. when it could not be forwarded.
+ * Records read after it are read again.
+ * @param a_uiId :[in] record id
+ * @return None
+ */
+void CPersistentOutbox::rewind(uint64_t a_uiId)
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	for(auto itr = m_dqUnacked.begin(); itr != m_dqUnacked.end(); ++itr)
+	{
+		if(itr->first >= a_uiId)
+		{
+			m_uiReadId = itr->first;
+			m_stReadPos = itr->second;
+			m_dqUnacked.erase(itr, m_dqUnacked.end());
+			return;
+		}
+	}
+}
+
+/**
+ * Makes reading restart from first record which is not acknowledged,
+ * e.g. when connection is lost
+ * @param None
+ * @return None
+ */
+void CPersistentOutbox::rewindAll()
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	if(false == m_dqUnacked.empty())
+	{
+		m_uiReadId = m_dqUnacked.front().first;
+		m_stReadPos = m_dqUnacked.front().second;
+		m_dqUnacked.clear();
+	}
+}
+
+/**
+ * Checks if there are records which are not yet read
+ * @param None
+ * @return true if a record is to be read
+ */
+bool CPersistentOutbox::hasUnread()
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	return m_bIsOpen && (m_uiReadId < m_uiNextId);
+}
+
+/**
+ * Returns number of records which are not yet forwarded
+ * @param None
+ * @return number of records
+ */
+uint64_t CPersistentOutbox::getPendingCount()
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	return m_uiNextId - 1 - m_uiAckedId;
+}
+
+/**
+ * Returns number of records dropped because of size retention
+ * @param None
+ * @return number of records
+ */
+uint64_t CPersistentOutbox::getDroppedCount()
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	return m_uiDropped;
+}
+
+/**
+ * Returns number of records not forwarded because of time retention
+ * @param None
+ * @return number of records
+ */
+uint64_t CPersistentOutbox::getExpiredCount()
+{
+	std::lock_guard<std::mutex> lck(m_mutexOutbox);
+	return m_uiExpired;
+}
@@ -0,0 +1,209 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "RequestTTL.hpp"
+#include "Logger.hpp"
+#include "EnvironmentVarHandler.hpp"
+#include <algorithm>
+#include <stdlib.h>
+
+/**
+ * Constructor
+ * @param a_uiDefaultTTLMs :[in] TTL in milliseconds of topics not listed in a_sTopicTTLs, 0 for none
+ * @param a_sTopicTTLs :[in] comma separated list of "topic=TTL in milliseconds"
+ */
+CRequestTTL::CRequestTTL(uint32_t a_uiDefaultTTLMs, const std::string &a_sTopicTTLs)
+	: m_uiDefaultTTLMs{a_uiDefaultTTLMs}
+{
+	for(auto &ui64Count : m_aui64Expired)
+	{
+		ui64Count = 0;
+	}
+
+	size_t uiStart = 0;
+	while(uiStart < a_sTopicTTLs.size())
+	{
+		size_t uiEnd = a_sTopicTTLs.find(',', uiStart);
+		if(std::string::npos == uiEnd)
+		{
+			uiEnd = a_sTopicTTLs.size();
+		}
+		std::string sEntry = a_sTopicTTLs.substr(uiStart, uiEnd - uiStart);
+		uiStart = uiEnd + 1;
+
+		size_t uiSep = sEntry.rfind('=');
+		if(std::string::npos == uiSep)
+		{
+			if(std::string::npos != sEntry.find_first_not_of(" \t"))
+			{
+				DO_LOG_ERROR(sEntry + " : TTL entry is not in format topic=milliseconds. Ignored.");
+			}
+			continue;
+		}
+		std::string sTopic = sEntry.substr(0, uiSep);
+		sTopic.erase(0, sTopic.find_first_not_of(" \t"));
+		sTopic.erase(sTopic.find_last_not_of(" \t") + 1);
+		char *pcEnd = NULL;
+		unsigned long ulTTLMs = strtoul(sEntry.c_str() + uiSep + 1, &pcEnd, 10);
+		if(sTopic.empty() || (pcEnd == sEntry.c_str() + uiSep + 1))
+		{
+			DO_LOG_ERROR(sEntry + " : TTL entry is not in format topic=milliseconds. Ignored.");
+			continue;
+		}
+		m_mapTopicTTLMs[sTopic] = (uint32_t)ulTTLMs;
+	}
+	DO_LOG_INFO("Request TTL in ms: " + std::to_string(m_uiDefaultTTLMs) +
+			", topics with own TTL: " + std::to_string(m_mapTopicTTLMs.size()));
+}
+
+/**
+ * Returns instance configured using environment variables REQUEST_TTL_MS and REQUEST_TTL_PER_TOPIC
+ * @param None
+ * @return reference of instance
+ */
+CRequestTTL& CRequestTTL::getInstance()
+{
+	// environment is read only when instance is created
+	static CRequestTTL _self((uint32_t)EnvironmentInfo::getEnvNum("REQUEST_TTL_MS", 0, 0, UINT32_MAX),
+			[]() -> std::string
+			{
+				const char *pcTopicTTLs = std::getenv("REQUEST_TTL_PER_TOPIC");
+				return (NULL == pcTopicTTLs) ? "" : pcTopicTTLs;
+			}());
+	return _self;
+}
+
+/**
+ * Returns TTL of a topic
+ * @param a_sTopic :[in] MQTT topic of request
+ * @return TTL in milliseconds, 0 if requests on topic do not expire
+ */
+uint32_t CRequestTTL::getTTLMs(const std::string &a_sTopic) const
+{
+	if(false == m_mapTopicTTLMs.empty())
+	{
+		auto itr = m_mapTopicTTLMs.find(a_sTopic);
+		if(m_mapTopicTTLMs.end() != itr)
+		{
+			return itr->second;
+		}
+	}
+	return m_uiDefaultTTLMs;
+}
+
+/**
+ * Checks if a request is older than TTL of its topic
+ * @param a_sTopic :[in] MQTT topic of request
+ * @param a_ui64OriginUs :[in] time at which request was created, 0 if not known
+ * @param a_ui64NowUs :[in] current time
+ * @param a_ui64AgeUs :[out] age of request
+ * @return true if request has expired, false otherwise
+ */
+bool CRequestTTL::isExpired(const std::string &a_sTopic, uint64_t a_ui64OriginUs, uint64_t a_ui64NowUs,
+		uint64_t &a_ui64AgeUs) const
+{
+	a_ui64AgeUs = ((0 != a_ui64OriginUs) && (a_ui64NowUs > a_ui64OriginUs)) ? (a_ui64NowUs - a_ui64OriginUs) : 0;
+	uint32_t uiTTLMs = getTTLMs(a_sTopic);
+	return (0 != uiTTLMs) && (a_ui64AgeUs > (uint64_t)uiTTLMs * 1000);
+}
+
+/**
+ * Counts an expired request
+ * @param a_eStage :[in] point at which request is found expired
+ * @return number of requests expired at this point so far
+ */
+uint64_t CRequestTTL::recordExpired(eReqTTLStage a_eStage)
+{
+	if(a_eStage >= enREQ_TTL_STAGE_MAX)
+	{
+		return 0;
+	}
+	return m_aui64Expired[a_eStage].fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+/**
+ * Returns number of expired requests
+ * @param a_eStage :[in] point at which requests are found expired
+ * @return number of requests
+ */
+uint64_t CRequestTTL::getExpiredCount(eReqTTLStage a_eStage) const
+{
+	if(a_eStage >= enREQ_TTL_STAGE_MAX)
+	{
+		return 0;
+	}
+	return m_aui64Expired[a_eStage].load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns time at which a request was created. Earlier of application timestamp and time at
+ * which request is received from MQTT is used, so that a clock of application running ahead
+ * does not make requests look fresh. If the two differ by more than allowed skew (normally
+ * the TTL), clock of application is taken as wrong and receive time is used, so that a clock
+ * running behind does not expire every request.
+ * @param a_sAppUsec :[in] application timestamp in micro seconds ("usec" of request), may be empty
+ * @param a_ui64RcvdUs :[in] time at which request is received from MQTT, 0 if not known
+ * @param a_uiMaxSkewMs :[in] max allowed difference between the two timestamps
+ * @return time in micro seconds, 0 if neither timestamp is known
+ */
+uint64_t CRequestTTL::getOriginUs(const std::string &a_sAppUsec, uint64_t a_ui64RcvdUs, uint32_t a_uiMaxSkewMs)
+{
+	uint64_t ui64AppUs = 0;
+	if(false == a_sAppUsec.empty())
+	{
+		ui64AppUs = strtoull(a_sAppUsec.c_str(), NULL, 10);
+	}
+	if(0 == ui64AppUs)
+	{
+		return a_ui64RcvdUs;
+	}
+	if(0 == a_ui64RcvdUs)
+	{
+		return ui64AppUs;
+	}
+	uint64_t ui64SkewUs = (ui64AppUs > a_ui64RcvdUs) ? (ui64AppUs - a_ui64RcvdUs) : (a_ui64RcvdUs - ui64AppUs);
+	if(ui64SkewUs > (uint64_t)a_uiMaxSkewMs * 1000)
+	{
+		return a_ui64RcvdUs;
+	}
+	return std::min(ui64AppUs, a_ui64RcvdUs);
+}
+
+/**
+ * Returns name of a stage to be used in logs
+ * @param a_eStage :[in] stage
+ * @return name of stage
+ */
+const char* CRequestTTL::getStageName(eReqTTLStage a_eStage)
+{
+	switch(a_eStage)
+	{
+		case enREQ_TTL_AT_ADMISSION:
+			return "admission";
+		case enREQ_TTL_AT_DISPATCH:
+			return "dispatch";
+		case enREQ_TTL_AT_EXECUTION:
+			return "execution";
+		default:
+			return "unknown";
+	}
+}
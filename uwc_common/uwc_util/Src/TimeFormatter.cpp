@@ -0,0 +1,345 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "TimeFormatter.hpp"
+#include "Logger.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define TIME_FMT_HAS_TSC 1
+#else
+#define TIME_FMT_HAS_TSC 0
+#endif
+
+/** Fixed point shift used to scale TSC ticks to nano seconds */
+#define TIME_FMT_TSC_SHIFT 24
+/** Duration in micro seconds over which TSC frequency is measured */
+#define TIME_FMT_TSC_CALIBRATION_US 20000
+
+namespace
+{
+	/** Time related data cached by each thread */
+	struct stThreadTimeCache
+	{
+		time_t m_tSec; /** second for which m_acDateTime is formatted*/
+		char m_acDateTime[TIME_FMT_BUFFER_SIZE]; /** formatted "%Y-%m-%d %H:%M:%S"*/
+		uint64_t m_uiAnchorTicks; /** TSC value at anchor; 0 if not anchored*/
+		uint64_t m_uiAnchorNs; /** wall clock time in ns at anchor*/
+	};
+
+	thread_local stThreadTimeCache g_stTimeCache = {-1, {0}, 0, 0};
+
+	/** Powers of 10 used to count digits; first entry is 0 so that 0 has one digit */
+	const uint64_t g_auiPow10[20] = {
+		0ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+		100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+		10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+		100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+	};
+
+	/** Two digit strings for 00 to 99 */
+	const char g_acDigitPairs[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+
+	/**
+	 * Counts number of decimal digits without branching
+	 * @param a_uiValue :[in] value
+	 * @return number of digits, 1 to 20
+	 */
+	inline uint32_t countDigits(uint64_t a_uiValue)
+	{
+		// log10(2) is approximated as 1233/4096
+		uint32_t uiBits = 64 - __builtin_clzll(a_uiValue | 1);
+		uint32_t uiLog10 = (uiBits * 1233) >> 12;
+		return uiLog10 + 1 - (a_uiValue < g_auiPow10[uiLog10]);
+	}
+
+	/**
+	 * Reads TSC
+	 * @return TSC value
+	 */
+	inline uint64_t readTsc()
+	{
+#if TIME_FMT_HAS_TSC
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	/**
+	 * Gets time in nano seconds from given clock
+	 * @param a_clockId :[in] clock to read
+	 * @return time in nano seconds
+	 */
+	inline uint64_t getClockNs(clockid_t a_clockId)
+	{
+		struct timespec stTs = {0};
+		clock_gettime(a_clockId, &stTs);
+		return (uint64_t)stTs.tv_sec * 1000000000ULL + (uint64_t)stTs.tv_nsec;
+	}
+}
+
+/**
+ * Constructor. Clock source is selected using environment variable TIME_CLOCK_SOURCE
+ * having value "realtime" (default), "coarse" or "tsc"
+ * @param None
+ * @return None
+ */
+CTimeFormatter::CTimeFormatter() : m_iClockSource{enCLOCK_REALTIME}, m_uiTscMult{0}, m_uiTscTicksPerSec{0}
+{
+	const char *pcSource = std::getenv("TIME_CLOCK_SOURCE");
+	if(NULL == pcSource)
+	{
+		return;
+	}
+	if(0 == strcasecmp(pcSource, "coarse"))
+	{
+		setClockSource(enCLOCK_REALTIME_COARSE);
+	}
+	else if(0 == strcasecmp(pcSource, "tsc"))
+	{
+		setClockSource(enCLOCK_TSC);
+	}
+}
+
+/**
+ * Function for singleton instance.
+ * @param None
+ * @return singleton instance of time formatter
+ */
+CTimeFormatter& CTimeFormatter::getInstance()
+{
+	static CTimeFormatter _self;
+	return _self;
+}
+
+/**
+ * Measures TSC frequency against CLOCK_MONOTONIC_RAW. TSC is used only when
+ * processor reports an invariant TSC.
+ * @param None
+ * @return true if TSC can be used, false otherwise
+ */
+bool CTimeFormatter::calibrateTsc()
+{
+#if TIME_FMT_HAS_TSC
+	unsigned int uiEax = 0, uiEbx = 0, uiEcx = 0, uiEdx = 0;
+	if((0 == __get_cpuid(0x80000007, &uiEax, &uiEbx, &uiEcx, &uiEdx)) || (0 == (uiEdx & (1u << 8))))
+	{
+		return false;
+	}
+
+	uint64_t uiStartNs = getClockNs(CLOCK_MONOTONIC_RAW);
+	uint64_t uiStartTicks = readTsc();
+	usleep(TIME_FMT_TSC_CALIBRATION_US);
+	uint64_t uiEndNs = getClockNs(CLOCK_MONOTONIC_RAW);
+	uint64_t uiEndTicks = readTsc();
+
+	if((uiEndNs <= uiStartNs) || (uiEndTicks <= uiStartTicks))
+	{
+		return false;
+	}
+	uint64_t uiTicks = uiEndTicks - uiStartTicks;
+	uint64_t uiNs = uiEndNs - uiStartNs;
+	m_uiTscMult.store((uiNs << TIME_FMT_TSC_SHIFT) / uiTicks, std::memory_order_relaxed);
+	m_uiTscTicksPerSec.store((uiTicks * 1000000000ULL) / uiNs, std::memory_order_relaxed);
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * Selects clock source used to read current time
+ * @param a_enSource :[in] clock source
+ * @return true if clock source is selected, false if it is not supported
+ * 			and CLOCK_REALTIME is used instead
+ */
+bool CTimeFormatter::setClockSource(eClockSource a_enSource)
+{
+	if((enCLOCK_TSC == a_enSource) && (false == calibrateTsc()))
+	{
+		DO_LOG_WARN("TSC cannot be used as clock source. Using CLOCK_REALTIME.");
+		m_iClockSource.store(enCLOCK_REALTIME, std::memory_order_relaxed);
+		return false;
+	}
+	m_iClockSource.store(a_enSource, std::memory_order_relaxed);
+	return true;
+}
+
+/**
+ * Gets wall clock time from TSC. Each thread anchors TSC to CLOCK_REALTIME and
+ * re-anchors every second or if TSC goes backwards, e.g. after CPU migration.
+ * @param a_stTs :[out] current time
+ * @return None
+ */
+void CTimeFormatter::getTscTime(struct timespec &a_stTs)
+{
+	uint64_t uiTicks = readTsc();
+	uint64_t uiDelta = uiTicks - g_stTimeCache.m_uiAnchorTicks;
+	if((0 == g_stTimeCache.m_uiAnchorTicks) ||
+			(uiDelta > m_uiTscTicksPerSec.load(std::memory_order_relaxed)))
+	{
+		clock_gettime(CLOCK_REALTIME, &a_stTs);
+		g_stTimeCache.m_uiAnchorTicks = uiTicks;
+		g_stTimeCache.m_uiAnchorNs = (uint64_t)a_stTs.tv_sec * 1000000000ULL + (uint64_t)a_stTs.tv_nsec;
+		return;
+	}
+	uint64_t uiNs = g_stTimeCache.m_uiAnchorNs +
+			((uiDelta * m_uiTscMult.load(std::memory_order_relaxed)) >> TIME_FMT_TSC_SHIFT);
+	a_stTs.tv_sec = (time_t)(uiNs / 1000000000ULL);
+	a_stTs.tv_nsec = (long)(uiNs % 1000000000ULL);
+}
+
+/**
+ * Reads current wall clock time from selected clock source
+ * @param a_stTs :[out] current time
+ * @return None
+ */
+void CTimeFormatter::now(struct timespec &a_stTs)
+{
+	switch(m_iClockSource.load(std::memory_order_relaxed))
+	{
+	case enCLOCK_REALTIME_COARSE:
+		clock_gettime(CLOCK_REALTIME_COARSE, &a_stTs);
+		break;
+	case enCLOCK_TSC:
+		getTscTime(a_stTs);
+		break;
+	default:
+		clock_gettime(CLOCK_REALTIME, &a_stTs);
+		break;
+	}
+}
+
+/**
+ * Reads current wall clock time from selected clock source
+ * @param None
+ * @return current time in micro seconds
+ */
+uint64_t CTimeFormatter::nowMicros()
+{
+	struct timespec stTs = {0};
+	now(stTs);
+	return toMicros(stTs);
+}
+
+/**
+ * Formats time as "%Y-%m-%d %H:%M:%S" in UTC. Formatted value is cached per thread
+ * and gmtime is called only when second changes.
+ * @param a_tSec :[in] seconds since epoch
+ * @param a_pcBuf :[out] buffer of at least TIME_FMT_BUFFER_SIZE bytes; NUL terminated
+ * @return length of formatted time, 0 on error
+ */
+size_t CTimeFormatter::formatDateTime(time_t a_tSec, char *a_pcBuf)
+{
+	if(a_tSec != g_stTimeCache.m_tSec)
+	{
+		struct tm stTm;
+		if((NULL == gmtime_r(&a_tSec, &stTm)) ||
+				(TIME_FMT_DATETIME_LEN != strftime(g_stTimeCache.m_acDateTime, TIME_FMT_BUFFER_SIZE,
+						"%Y-%m-%d %H:%M:%S", &stTm)))
+		{
+			g_stTimeCache.m_tSec = -1;
+			a_pcBuf[0] = '\0';
+			return 0;
+		}
+		g_stTimeCache.m_tSec = a_tSec;
+	}
+	memcpy(a_pcBuf, g_stTimeCache.m_acDateTime, TIME_FMT_DATETIME_LEN + 1);
+	return TIME_FMT_DATETIME_LEN;
+}
+
+/**
+ * Reads current time and formats it as timestamp and micro seconds
+ * @param a_pcTimeStamp :[out] buffer of at least TIME_FMT_BUFFER_SIZE bytes for "%Y-%m-%d %H:%M:%S"
+ * @param a_pcUsec :[out] buffer of at least TIME_FMT_BUFFER_SIZE bytes for micro seconds since epoch
+ * @return None
+ */
+void CTimeFormatter::getTimeParams(char *a_pcTimeStamp, char *a_pcUsec)
+{
+	struct timespec stTs = {0};
+	now(stTs);
+	formatDateTime(stTs.tv_sec, a_pcTimeStamp);
+	formatUint(toMicros(stTs), a_pcUsec);
+}
+
+/**
+ * Formats unsigned integer as decimal string. Digits are written two at a time
+ * from the end after counting them.
+ * @param a_uiValue :[in] value to format
+ * @param a_pcBuf :[out] buffer of at least TIME_FMT_BUFFER_SIZE bytes; NUL terminated
+ * @return number of digits written
+ */
+size_t CTimeFormatter::formatUint(uint64_t a_uiValue, char *a_pcBuf)
+{
+	uint32_t uiLen = countDigits(a_uiValue);
+	char *pcPos = a_pcBuf + uiLen;
+	*pcPos = '\0';
+	while(a_uiValue >= 100)
+	{
+		uint32_t uiIdx = (uint32_t)(a_uiValue % 100) * 2;
+		a_uiValue /= 100;
+		pcPos -= 2;
+		memcpy(pcPos, g_acDigitPairs + uiIdx, 2);
+	}
+	if(a_uiValue >= 10)
+	{
+		memcpy(pcPos - 2, g_acDigitPairs + a_uiValue * 2, 2);
+	}
+	else
+	{
+		*(pcPos - 1) = (char)('0' + a_uiValue);
+	}
+	return uiLen;
+}
+
+/**
+ * Formats time as micro seconds since epoch
+ * @param a_stTs :[in] time to format
+ * @param a_pcBuf :[out] buffer of at least TIME_FMT_BUFFER_SIZE bytes
+ * @return a_pcBuf
+ */
+const char* CTimeFormatter::microsToStr(const struct timespec &a_stTs, char *a_pcBuf)
+{
+	formatUint(toMicros(a_stTs), a_pcBuf);
+	return a_pcBuf;
+}
+
+/**
+ * Formats time as micro seconds since epoch
+ * @param a_stTs :[in] time to format
+ * @return micro seconds since epoch as string
+ */
+std::string CTimeFormatter::microsToString(const struct timespec &a_stTs)
+{
+	char acBuf[TIME_FMT_BUFFER_SIZE];
+	size_t uiLen = formatUint(toMicros(a_stTs), acBuf);
+	return std::string(acBuf, uiLen);
+}
@@ -0,0 +1,158 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "TimestampCarrier.hpp"
+#include "TimeFormatter.hpp"
+#include <tuple>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Reads timestamp carrier mode from environment variable MQTT_TIMESTAMP_MODE
+ * ("slot" or "property"). Default is slot.
+ * @return carrier mode
+ */
+eTsCarrierMode CTimestampCarrier::readMode()
+{
+	const char *pcVal = std::getenv("MQTT_TIMESTAMP_MODE");
+	if((NULL != pcVal) && (0 == strcmp(pcVal, "property")))
+	{
+		return enTS_CARRIER_PROPERTY;
+	}
+	return enTS_CARRIER_SLOT;
+}
+
+/**
+ * Finds position of value of a reserved timestamp slot i.e. a string field
+ * having TS_SLOT_PLACEHOLDER as value
+ * @param a_sJson :[in] JSON payload
+ * @param a_sKey :[in] key of timestamp field
+ * @return position of first digit of placeholder, std::string::npos if slot is not found
+ */
+size_t CTimestampCarrier::findSlot(const std::string &a_sJson, const std::string &a_sKey)
+{
+	std::string sKey = "\"" + a_sKey + "\"";
+	size_t uiPos = a_sJson.find(sKey);
+	while(std::string::npos != uiPos)
+	{
+		size_t uiVal = a_sJson.find_first_not_of(" \t", uiPos + sKey.size());
+		if((std::string::npos != uiVal) && (':' == a_sJson[uiVal]))
+		{
+			uiVal = a_sJson.find_first_not_of(" \t", uiVal + 1);
+			if((std::string::npos != uiVal) && ('"' == a_sJson[uiVal]) &&
+				(0 == a_sJson.compare(uiVal + 1, TS_SLOT_WIDTH, TS_SLOT_PLACEHOLDER)) &&
+				(uiVal + 1 + TS_SLOT_WIDTH < a_sJson.size()) && ('"' == a_sJson[uiVal + 1 + TS_SLOT_WIDTH]))
+			{
+				return uiVal + 1;
+			}
+		}
+		uiPos = a_sJson.find(sKey, uiPos + sKey.size());
+	}
+	return std::string::npos;
+}
+
+/**
+ * Overwrites placeholder of a timestamp slot with given timestamp. Size of payload
+ * does not change, so no copy of payload is made.
+ * @param a_sJson :[in,out] JSON payload
+ * @param a_sKey :[in] key of timestamp field
+ * @param a_ui64Micros :[in] timestamp in microseconds since epoch
+ * @return true if slot is found and timestamp fits in it
+ */
+bool CTimestampCarrier::patchSlot(std::string &a_sJson, const std::string &a_sKey, uint64_t a_ui64Micros)
+{
+	size_t uiPos = findSlot(a_sJson, a_sKey);
+	if(std::string::npos == uiPos)
+	{
+		return false;
+	}
+	char acBuf[TIME_FMT_BUFFER_SIZE];
+	if(TS_SLOT_WIDTH != CTimeFormatter::formatUint(a_ui64Micros, acBuf))
+	{
+		return false;
+	}
+	a_sJson.replace(uiPos, TS_SLOT_WIDTH, acBuf, TS_SLOT_WIDTH);
+	return true;
+}
+
+/**
+ * Adds timestamp as MQTT v5 user property
+ * @param a_props :[in,out] properties of message
+ * @param a_sKey :[in] name of timestamp; shall start with TS_PROPERTY_PREFIX
+ * @param a_ui64Micros :[in] timestamp in microseconds since epoch
+ * @return None
+ */
+void CTimestampCarrier::addProperty(mqtt::properties &a_props, const std::string &a_sKey, uint64_t a_ui64Micros)
+{
+	char acBuf[TIME_FMT_BUFFER_SIZE];
+	size_t uiLen = CTimeFormatter::formatUint(a_ui64Micros, acBuf);
+	a_props.add(mqtt::property(mqtt::property::USER_PROPERTY, a_sKey, std::string(acBuf, uiLen)));
+}
+
+/**
+ * Appends timestamps carried as user properties of a message to its JSON payload,
+ * so that payload looks same as if timestamps were added to it by publisher.
+ * Fields already present in payload are not added again.
+ * @param a_sJson :[in,out] JSON payload of message
+ * @param a_pMsg :[in] received message
+ * @return number of fields appended
+ */
+size_t CTimestampCarrier::appendProperties(std::string &a_sJson, const mqtt::const_message_ptr &a_pMsg)
+{
+	if(NULL == a_pMsg)
+	{
+		return 0;
+	}
+	size_t uiEnd = a_sJson.find_last_of('}');
+	if(std::string::npos == uiEnd)
+	{
+		return 0;
+	}
+	const mqtt::properties &props = a_pMsg->get_properties();
+	size_t uiCount = props.count(mqtt::property::USER_PROPERTY);
+	std::string sFields;
+	size_t uiAdded = 0;
+	for(size_t i = 0; i < uiCount; ++i)
+	{
+		mqtt::string_pair prop = mqtt::get<mqtt::string_pair>(props.get(mqtt::property::USER_PROPERTY, i));
+		const std::string &sName = std::get<0>(prop);
+		if((0 != sName.compare(0, strlen(TS_PROPERTY_PREFIX), TS_PROPERTY_PREFIX)) ||
+			(std::string::npos != a_sJson.find("\"" + sName + "\"")))
+		{
+			continue;
+		}
+		sFields += ",\"" + sName + "\":\"" + std::get<1>(prop) + "\"";
+		++uiAdded;
+	}
+	if(0 == uiAdded)
+	{
+		return 0;
+	}
+	// payload having no field does not need separator
+	size_t uiLast = a_sJson.find_last_not_of(" \t\r\n", uiEnd - 1);
+	if((std::string::npos != uiLast) && ('{' == a_sJson[uiLast]))
+	{
+		sFields.erase(0, 1);
+	}
+	a_sJson.insert(uiEnd, sFields);
+	return uiAdded;
+}
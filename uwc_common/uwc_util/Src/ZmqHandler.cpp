@@ -43,6 +43,7 @@ std::mutex __SubctxMapLock;
 std::mutex __PubctxMapLock;
 std::mutex __mtxUniqueTracker;
 std::mutex __mtxMakePubThSafe;
+std::mutex __mtxRT_NRT;
 
 // Unnamed namespace to define globals
 namespace
@@ -72,7 +73,8 @@ std::function<bool(std::string, std::string)> regExFun = [](std::string a_sTopic
 	}
 };
 /**
- * function to form the topic in /flowmeter/PL0/D1 format and corresponding RT/NRT value
+ * function to form the topic in /flowmeter/PL0/D1 format and corresponding RT/NRT value.
+ * It is thread safe; map is shared by threads preparing births and reading messages.
  * @param RT_NRT_check :[in] information about device ,wellhead, data_point and Real time seprated by -
  * @return None,
  */
@@ -89,6 +91,7 @@ void zmq_handler::set_RT_NRT(std::string RT_NRT_check)
 	if((RT_NRT_check.find("default-"))!= std::string::npos){
 		next = RT_NRT_check.find("-");
 		value = RT_NRT_check.substr(next+1,size);
+		std::lock_guard<std::mutex> lck(__mtxRT_NRT);
 		RT_NRT.insert({"default",value});
 	}else{
 		// extracting topic and corresponding RT/NRT value
@@ -104,6 +107,7 @@ void zmq_handler::set_RT_NRT(std::string RT_NRT_check)
 		key = "/" + a_vsrt_nrt_values[0] + "/" + a_vsrt_nrt_values[1] + "/" +a_vsrt_nrt_values[2];
 		if(size==4){
 			value = a_vsrt_nrt_values[3];
+			std::lock_guard<std::mutex> lck(__mtxRT_NRT);
 			RT_NRT.insert({key,value});
 		}
 	}
@@ -117,6 +121,7 @@ void zmq_handler::set_RT_NRT(std::string RT_NRT_check)
 std::string zmq_handler::get_RT_NRT(std::string topic)
 {
    std::string RT_NRT_value ="";
+   std::lock_guard<std::mutex> lck(__mtxRT_NRT);
    auto RT_NRT_pointer = RT_NRT.find(topic);
    if(RT_NRT_pointer!=RT_NRT.end()){
    		RT_NRT_value = RT_NRT_pointer->second;
@@ -497,7 +502,28 @@ bool zmq_handler::publishJson(std::string &a_sUsec, msg_envelope_t* msg, const s
 	DO_LOG_DEBUG("msg to publish :: Topic :: " + a_sTopic);
 	zmq_handler::stZmqContext& msgbus_ctx = zmq_handler::getCTX(a_sTopic);
 	void* pub_ctx = zmq_handler::getPubCTX(a_sTopic).m_pContext;
-	if((NULL == msgbus_ctx.m_pContext) || (NULL == pub_ctx))
+	return publishJson(a_sUsec, msg, msgbus_ctx, pub_ctx, a_sTopic, a_sPubTimeField);
+}
+
+/**
+ * Publish json using contexts already looked up by caller, so that context maps are not locked
+ * @param a_sUsec		:[out] USEC timestamp value at which a message is published
+ * @param msg			:[in] message to publish
+ * @param a_msgbusCtx	:[in] msgbus context of topic
+ * @param a_pPubCtx		:[in] publisher context of topic
+ * @param a_sTopic		:[in] topic on which to publish
+ * @return 	true : on success,
+ * 			false : on error
+ */
+bool zmq_handler::publishJson(std::string &a_sUsec, msg_envelope_t* msg, stZmqContext &a_msgbusCtx, void *a_pPubCtx,
+		const std::string &a_sTopic, std::string a_sPubTimeField)
+{
+	if(NULL == msg)
+	{
+		DO_LOG_ERROR(": Failed to publish message - Input message is NULL");
+		return false;
+	}
+	if((NULL == a_msgbusCtx.m_pContext) || (NULL == a_pPubCtx))
 	{
 		DO_LOG_ERROR(": Failed to publish message - context is NULL: " + a_sTopic);
 		return false;
@@ -505,7 +531,7 @@ bool zmq_handler::publishJson(std::string &a_sUsec, msg_envelope_t* msg, const s
 	msgbus_ret_t ret;
 
 	{
-		std::lock_guard<std::mutex> lock(msgbus_ctx.m_mutex);
+		std::lock_guard<std::mutex> lock(a_msgbusCtx.m_mutex);
 		if(a_sPubTimeField.empty() == false)
 		{
 			auto p1 = std::chrono::system_clock::now();
@@ -517,7 +543,7 @@ bool zmq_handler::publishJson(std::string &a_sUsec, msg_envelope_t* msg, const s
 				msgbus_msg_envelope_put(msg, a_sPubTimeField.c_str(), ptUsec);
 			}
 		}
-		ret = msgbus_publisher_publish(msgbus_ctx.m_pContext, (publisher_ctx_t*)pub_ctx, msg);
+		ret = msgbus_publisher_publish(a_msgbusCtx.m_pContext, (publisher_ctx_t*)a_pPubCtx, msg);
 		if(ret == MSG_SUCCESS) {
 			DO_LOG_DEBUG("Successfully published the message on the topic " + a_sTopic);
 		}
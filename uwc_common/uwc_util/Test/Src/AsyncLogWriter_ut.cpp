@@ -0,0 +1,154 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include <unistd.h>
+#include "../include/AsyncLogWriter_ut.hpp"
+
+void AsyncLogWriter_ut::SetUp()
+{
+	clock_gettime(CLOCK_REALTIME, &m_stTs);
+	m_vDrained.clear();
+}
+
+void AsyncLogWriter_ut::TearDown()
+{
+	// TearDown code
+}
+
+size_t AsyncLogWriter_ut::drainRing(CLogRing &a_ring)
+{
+	return a_ring.drain([this](const stLogRecordHdr &a_stHdr, const char *a_pcMsg)
+	{
+		m_vDrained.push_back(std::string(a_pcMsg, a_stHdr.m_uiLen));
+	});
+}
+
+/**Test for CLogRing::push() and CLogRing::drain() keeping order of records**/
+TEST_F(AsyncLogWriter_ut, ringPushDrainOrder)
+{
+	CLogRing ring(4096);
+	std::string sMsg1 = "first message";
+	std::string sMsg2 = "second message";
+
+	EXPECT_EQ(true, ring.push(m_stSite, m_stTs, sMsg1.data(), sMsg1.size()));
+	EXPECT_EQ(true, ring.push(m_stSite, m_stTs, sMsg2.data(), sMsg2.size()));
+	EXPECT_EQ(2u, drainRing(ring));
+	ASSERT_EQ(2u, m_vDrained.size());
+	EXPECT_EQ(sMsg1, m_vDrained[0]);
+	EXPECT_EQ(sMsg2, m_vDrained[1]);
+	EXPECT_EQ(true, ring.isEmpty());
+}
+
+/**Test for CLogRing::writeToFd() writing pending records without consuming them**/
+TEST_F(AsyncLogWriter_ut, ringWriteToFd)
+{
+	CLogRing ring(4096);
+	std::string sMsg1 = "first message";
+	std::string sMsg2 = "second message";
+	ring.push(m_stSite, m_stTs, sMsg1.data(), sMsg1.size());
+	ring.push(m_stSite, m_stTs, sMsg2.data(), sMsg2.size());
+
+	int aiPipe[2];
+	ASSERT_EQ(0, pipe(aiPipe));
+	ring.writeToFd(aiPipe[1]);
+	close(aiPipe[1]);
+	std::string sOut;
+	char acBuf[256];
+	ssize_t iLen = 0;
+	while((iLen = read(aiPipe[0], acBuf, sizeof(acBuf))) > 0)
+	{
+		sOut.append(acBuf, iLen);
+	}
+	close(aiPipe[0]);
+
+	EXPECT_NE(std::string::npos, sOut.find("] first message\n"));
+	EXPECT_LT(sOut.find(sMsg1), sOut.find(sMsg2));
+	EXPECT_NE(std::string::npos, sOut.find(std::to_string(m_stSite.m_iLine)));
+	// records are still drained by writer
+	EXPECT_EQ(2u, drainRing(ring));
+}
+
+/**Test for CLogRing::push() when ring buffer is full**/
+TEST_F(AsyncLogWriter_ut, ringFull)
+{
+	CLogRing ring(4096);
+	std::string sMsg(100, 'a');
+	int iCount = 0;
+	while(ring.push(m_stSite, m_stTs, sMsg.data(), sMsg.size()))
+	{
+		++iCount;
+	}
+	EXPECT_GT(iCount, 0);
+	EXPECT_EQ(static_cast<size_t>(iCount), drainRing(ring));
+	EXPECT_EQ(true, ring.push(m_stSite, m_stTs, sMsg.data(), sMsg.size()));
+}
+
+/**Test for CLogRing when records wrap around end of buffer**/
+TEST_F(AsyncLogWriter_ut, ringWrapAround)
+{
+	CLogRing ring(4096);
+	for(int iLoop = 0; iLoop < 500; ++iLoop)
+	{
+		std::string sMsg = "message " + std::to_string(iLoop) + std::string(iLoop % 90, 'x');
+		ASSERT_EQ(true, ring.push(m_stSite, m_stTs, sMsg.data(), sMsg.size()));
+		m_vDrained.clear();
+		ASSERT_EQ(1u, drainRing(ring));
+		EXPECT_EQ(sMsg, m_vDrained[0]);
+	}
+}
+
+/**Test for CLogRing::push() truncating message longer than allowed**/
+TEST_F(AsyncLogWriter_ut, ringTruncate)
+{
+	CLogRing ring(4096);
+	std::string sMsg(5000, 'b');
+	bool bIsTruncated = false;
+
+	EXPECT_EQ(true, ring.push(m_stSite, m_stTs, sMsg.data(), sMsg.size()));
+	ring.drain([&bIsTruncated](const stLogRecordHdr &a_stHdr, const char *a_pcMsg)
+	{
+		bIsTruncated = (0 != a_stHdr.m_uiIsTruncated);
+	});
+	EXPECT_EQ(true, bIsTruncated);
+}
+
+/**Test for CAsyncLogWriter::post() when writer is not started**/
+TEST_F(AsyncLogWriter_ut, postWithoutStart)
+{
+	EXPECT_EQ(false, CAsyncLogWriter::getInstance().post(m_stSite, "not started"));
+}
+
+/**Test for CAsyncLogWriter::start(), post(), flush() and stop()**/
+TEST_F(AsyncLogWriter_ut, writerStartPostStop)
+{
+	log4cpp::Category &category = log4cpp::Category::getInstance("AsyncLogWriter_ut");
+	EXPECT_EQ(false, CAsyncLogWriter::getInstance().start(NULL));
+	EXPECT_EQ(true, CAsyncLogWriter::getInstance().start(&category));
+	EXPECT_EQ(false, CAsyncLogWriter::getInstance().start(&category));
+
+	EXPECT_EQ(true, CAsyncLogWriter::getInstance().post(m_stSite, "async message"));
+	EXPECT_EQ(true, CAsyncLogWriter::getInstance().flush());
+	EXPECT_EQ(0u, CAsyncLogWriter::getInstance().getOverflowCount());
+
+	CAsyncLogWriter::getInstance().stop();
+	EXPECT_EQ(false, CAsyncLogWriter::getInstance().isRunning());
+}
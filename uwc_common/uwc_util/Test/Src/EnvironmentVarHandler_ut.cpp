@@ -67,3 +67,27 @@ TEST_F(EnvironmentHandler_ut, getDataFromMap)
 	EXPECT_EQ(strVal, bRetVal);
 }
 
+/**Test for getEnvNum() using default value for unset and invalid values**/
+TEST_F(EnvironmentHandler_ut, getEnvNum)
+{
+	unsetenv("UT_ENV_NUM");
+	EXPECT_EQ(7u, EnvironmentInfo::getEnvNum("UT_ENV_NUM", 7));
+
+	setenv("UT_ENV_NUM", "25", 1);
+	EXPECT_EQ(25u, EnvironmentInfo::getEnvNum("UT_ENV_NUM", 7));
+
+	setenv("UT_ENV_NUM", "0", 1);
+	EXPECT_EQ(0u, EnvironmentInfo::getEnvNum("UT_ENV_NUM", 7));
+	EXPECT_EQ(7u, EnvironmentInfo::getEnvNum("UT_ENV_NUM", 7, 1));
+
+	setenv("UT_ENV_NUM", "25ms", 1);
+	EXPECT_EQ(7u, EnvironmentInfo::getEnvNum("UT_ENV_NUM", 7));
+
+	setenv("UT_ENV_NUM", "-1", 1);
+	EXPECT_EQ(7u, EnvironmentInfo::getEnvNum("UT_ENV_NUM", 7));
+
+	setenv("UT_ENV_NUM", "5000000000", 1);
+	EXPECT_EQ(7u, EnvironmentInfo::getEnvNum("UT_ENV_NUM", 7, 0, UINT32_MAX));
+
+	unsetenv("UT_ENV_NUM");
+}
@@ -0,0 +1,149 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/LogRateLimiter_ut.hpp"
+
+void LogRateLimiter_ut::SetUp()
+{
+	m_uiSuppressed = 0;
+}
+
+void LogRateLimiter_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**Test for CLogRateLimiter::isAllowedAt() allowing only burst statements in a period**/
+TEST_F(LogRateLimiter_ut, limiterAllowsBurst)
+{
+	CLogRateLimiter oLimiter(3, 1000);
+
+	EXPECT_EQ(true, oLimiter.isAllowedAt(5000, m_uiSuppressed));
+	EXPECT_EQ(0u, m_uiSuppressed);
+	EXPECT_EQ(true, oLimiter.isAllowedAt(5000, m_uiSuppressed));
+	EXPECT_EQ(true, oLimiter.isAllowedAt(5001, m_uiSuppressed));
+	EXPECT_EQ(false, oLimiter.isAllowedAt(5002, m_uiSuppressed));
+	EXPECT_EQ(false, oLimiter.isAllowedAt(5100, m_uiSuppressed));
+}
+
+/**Test for CLogRateLimiter::isAllowedAt() refilling tokens over time**/
+TEST_F(LogRateLimiter_ut, limiterRefills)
+{
+	CLogRateLimiter oLimiter(2, 1000);
+
+	EXPECT_EQ(true, oLimiter.isAllowedAt(1000, m_uiSuppressed));
+	EXPECT_EQ(true, oLimiter.isAllowedAt(1000, m_uiSuppressed));
+	EXPECT_EQ(false, oLimiter.isAllowedAt(1200, m_uiSuppressed));
+	// one token is added every 500 ms
+	EXPECT_EQ(true, oLimiter.isAllowedAt(1500, m_uiSuppressed));
+	EXPECT_EQ(false, oLimiter.isAllowedAt(1600, m_uiSuppressed));
+	// bucket does not grow beyond burst
+	EXPECT_EQ(true, oLimiter.isAllowedAt(10000, m_uiSuppressed));
+	EXPECT_EQ(true, oLimiter.isAllowedAt(10000, m_uiSuppressed));
+	EXPECT_EQ(false, oLimiter.isAllowedAt(10000, m_uiSuppressed));
+}
+
+/**Test for CLogRateLimiter::isAllowedAt() reporting suppressed statements once**/
+TEST_F(LogRateLimiter_ut, limiterReportsSuppressed)
+{
+	CLogRateLimiter oLimiter(1, 1000);
+
+	EXPECT_EQ(true, oLimiter.isAllowedAt(1000, m_uiSuppressed));
+	for(int i = 0; i < 5; ++i)
+	{
+		EXPECT_EQ(false, oLimiter.isAllowedAt(1100, m_uiSuppressed));
+	}
+	EXPECT_EQ(true, oLimiter.isAllowedAt(2000, m_uiSuppressed));
+	EXPECT_EQ(5u, m_uiSuppressed);
+	EXPECT_EQ(true, oLimiter.isAllowedAt(3000, m_uiSuppressed));
+	EXPECT_EQ(0u, m_uiSuppressed);
+}
+
+/**Test for CLogRateLimiter with zero burst and period treated as one**/
+TEST_F(LogRateLimiter_ut, limiterZeroConfig)
+{
+	CLogRateLimiter oLimiter(0, 0);
+
+	EXPECT_EQ(true, oLimiter.isAllowedAt(0, m_uiSuppressed));
+	EXPECT_EQ(false, oLimiter.isAllowedAt(0, m_uiSuppressed));
+	EXPECT_EQ(true, oLimiter.isAllowedAt(1, m_uiSuppressed));
+	EXPECT_EQ(1u, m_uiSuppressed);
+}
+
+/**Test for CLogSampler::isSampled() allowing one of every N statements**/
+TEST_F(LogRateLimiter_ut, samplerEveryN)
+{
+	CLogSampler oSampler(4);
+	int iSampled = 0;
+
+	EXPECT_EQ(true, oSampler.isSampled(m_uiSuppressed));
+	EXPECT_EQ(0u, m_uiSuppressed);
+	for(int i = 1; i < 12; ++i)
+	{
+		if(true == oSampler.isSampled(m_uiSuppressed))
+		{
+			++iSampled;
+			EXPECT_EQ(3u, m_uiSuppressed);
+		}
+	}
+	EXPECT_EQ(2, iSampled);
+}
+
+/**Test for CLogSuppressedCount::reportPending() reporting counts when suppression ends
+ * and call sites are not reached again**/
+TEST_F(LogRateLimiter_ut, reportPendingWithoutStatement)
+{
+	static const stLogSite stSite = {__FILE__, __func__, __LINE__, 0};
+	static CLogRateLimiter oLimiter(1, 1000, &stSite, "UT limiter");
+	static CLogSampler oSampler(4, &stSite, "UT sampler");
+	std::map<std::string, uint64_t> mapReported;
+	auto fcbReport = [&](const stLogSite &a_stSite, const char *a_pcKey, uint64_t a_uiCount)
+	{
+		if(&stSite == &a_stSite)
+		{
+			mapReported[a_pcKey] += a_uiCount;
+		}
+	};
+
+	EXPECT_EQ(true, oLimiter.isAllowedAt(1000, m_uiSuppressed));
+	for(int i = 0; i < 3; ++i)
+	{
+		EXPECT_EQ(false, oLimiter.isAllowedAt(1100, m_uiSuppressed));
+	}
+	// 2 of 6 statements are sampled; 3 suppressed ones are reported with second sampled statement
+	for(int i = 0; i < 6; ++i)
+	{
+		oSampler.isSampled(m_uiSuppressed);
+	}
+
+	CLogSuppressedCount::reportPending(fcbReport);
+	EXPECT_EQ(2u, mapReported.size());
+	EXPECT_EQ(3u, mapReported["UT limiter"]);
+	EXPECT_EQ(1u, mapReported["UT sampler"]);
+
+	// counts are reported once
+	mapReported.clear();
+	CLogSuppressedCount::reportPending(fcbReport);
+	EXPECT_EQ(0u, mapReported.size());
+	EXPECT_EQ(true, oLimiter.isAllowedAt(2000, m_uiSuppressed));
+	EXPECT_EQ(0u, m_uiSuppressed);
+}
@@ -21,6 +21,11 @@
 *********************************************************************************/
 
 #include "../include/MQTTPubSubClient_ut.hpp"
+#include <dirent.h>
+#include <set>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 
 void MQTTPubSubClient_ut::SetUp()
@@ -114,3 +119,487 @@ TEST_F(MQTTPubSubClient_ut, PublishMsg)
 	EXPECT_EQ(true, RetVal);
 }
 
+
+/**Test for CMQTTPubSubClient::publishMsgPipelined() when client is not connected**/
+TEST_F(MQTTPubSubClient_ut, PubMsgPipelinedNotConnected)
+{
+	std::string Topic = "TCP_WrReq";
+	std::string Msg{""};
+	int QOS = 1;
+	bool bIsCalled = false;
+	mqtt::message_ptr pubmsg = mqtt::make_message(Topic, Msg, QOS, false);
+
+	bool RetVal = CMQTTPubSubClient_obj.publishMsgPipelined(pubmsg,
+			[&bIsCalled](mqtt::const_message_ptr a_pMsg, bool a_bIsSuccess) { bIsCalled = true; }, 0);
+	EXPECT_EQ(false, RetVal);
+	EXPECT_EQ(false, bIsCalled);
+	EXPECT_EQ(0u, CMQTTPubSubClient_obj.getInflightCount());
+}
+
+/**Test for CPublishWindow::acquire() blocking when window is full**/
+TEST_F(MQTTPubSubClient_ut, PublishWindowFull)
+{
+	CPublishWindow oWindow(2);
+	mqtt::const_message_ptr pMsg = mqtt::make_message("TCP_WrReq", "", 1, false);
+
+	void *pCtx1 = oWindow.acquire(pMsg, nullptr, 0);
+	void *pCtx2 = oWindow.acquire(pMsg, nullptr, 0);
+	EXPECT_NE(nullptr, pCtx1);
+	EXPECT_NE(nullptr, pCtx2);
+	EXPECT_EQ(2u, oWindow.getInflightCount());
+	EXPECT_EQ(nullptr, oWindow.acquire(pMsg, nullptr, 10));
+
+	oWindow.cancel(pCtx1);
+	EXPECT_EQ(1u, oWindow.getInflightCount());
+	void *pCtx3 = oWindow.acquire(pMsg, nullptr, 0);
+	EXPECT_NE(nullptr, pCtx3);
+
+	oWindow.cancel(pCtx2);
+	oWindow.cancel(pCtx3);
+	EXPECT_EQ(0u, oWindow.getInflightCount());
+}
+
+/**Test for CPublishWindow::reset() releasing a waiting publisher**/
+TEST_F(MQTTPubSubClient_ut, PublishWindowReset)
+{
+	CPublishWindow oWindow(1);
+	mqtt::const_message_ptr pMsg = mqtt::make_message("TCP_WrReq", "", 1, false);
+
+	int iFailed = 0;
+	void *pCtx1 = oWindow.acquire(pMsg,
+			[&iFailed](mqtt::const_message_ptr a_pMsg, bool a_bIsSuccess) { iFailed += (a_bIsSuccess ? 0 : 1); }, 0);
+	ASSERT_NE(nullptr, pCtx1);
+
+	void *pCtx2 = nullptr;
+	std::thread thWaiter([&]() { pCtx2 = oWindow.acquire(pMsg, nullptr, -1); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	oWindow.reset();
+	thWaiter.join();
+	EXPECT_NE(nullptr, pCtx2);
+	EXPECT_EQ(1u, oWindow.getInflightCount());
+	// message in flight before reset is completed as failed
+	EXPECT_EQ(1, iFailed);
+	EXPECT_EQ(1u, oWindow.getFailedCount());
+
+	// context from before reset does not release slot of message published after it
+	oWindow.cancel(pCtx1);
+	EXPECT_EQ(1u, oWindow.getInflightCount());
+	oWindow.cancel(pCtx2);
+	EXPECT_EQ(0u, oWindow.getInflightCount());
+}
+
+/**Test for CPublishWindow::waitForSlot() not reserving a slot**/
+TEST_F(MQTTPubSubClient_ut, PublishWindowWaitForSlot)
+{
+	CPublishWindow oWindow(1);
+	mqtt::const_message_ptr pMsg = mqtt::make_message("TCP_WrReq", "", 1, false);
+
+	EXPECT_EQ(true, oWindow.waitForSlot(0));
+	EXPECT_EQ(0u, oWindow.getInflightCount());
+	void *pCtx = oWindow.acquire(pMsg, nullptr, 0);
+	ASSERT_NE(nullptr, pCtx);
+	EXPECT_EQ(false, oWindow.waitForSlot(10));
+
+	std::thread thCancel([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		oWindow.cancel(pCtx);
+	});
+	EXPECT_EQ(true, oWindow.waitForSlot(-1));
+	thCancel.join();
+}
+
+/**Test for CPublishWindow::setMaxInflight() **/
+TEST_F(MQTTPubSubClient_ut, PublishWindowSetMax)
+{
+	CPublishWindow oWindow(1);
+	oWindow.setMaxInflight(0);
+	EXPECT_EQ(1u, oWindow.getMaxInflight());
+	oWindow.setMaxInflight(128);
+	EXPECT_EQ(128u, oWindow.getMaxInflight());
+}
+
+/**Test for CMQTTPubSubClient::publishMsgPipelined() storing message in outbox when not connected **/
+TEST_F(MQTTPubSubClient_ut, PubMsgPipelinedOutbox)
+{
+	char acDir[] = "/tmp/mqtt_outbox_ut_XXXXXX";
+	stOutboxConfig stConfig;
+	stConfig.m_sDir = mkdtemp(acDir);
+	stConfig.m_uiSegmentSize = 64 * 1024;
+
+	EXPECT_EQ(false, CMQTTPubSubClient_obj.isOutboxEnabled());
+	ASSERT_EQ(true, CMQTTPubSubClient_obj.enableOutbox(stConfig));
+	EXPECT_EQ(true, CMQTTPubSubClient_obj.isOutboxEnabled());
+
+	mqtt::message_ptr pMsg = mqtt::make_message("TCP_WrReq", "{\"a\":1}", 1, false);
+	EXPECT_EQ(true, CMQTTPubSubClient_obj.publishMsgPipelined(pMsg));
+	EXPECT_EQ(true, CMQTTPubSubClient_obj.publishMsgPipelined(pMsg));
+	EXPECT_EQ(2u, CMQTTPubSubClient_obj.getOutboxPendingCount());
+
+	DIR *pDir = opendir(stConfig.m_sDir.c_str());
+	if(NULL != pDir)
+	{
+		struct dirent *pEntry = NULL;
+		while(NULL != (pEntry = readdir(pDir)))
+		{
+			std::string sName(pEntry->d_name);
+			if(("." != sName) && (".." != sName))
+			{
+				unlink((stConfig.m_sDir + "/" + sName).c_str());
+			}
+		}
+		closedir(pDir);
+	}
+	rmdir(stConfig.m_sDir.c_str());
+}
+
+/**Test for failed live message being stored in outbox alone while client is connected, and along
+ * with all messages in flight once connection is lost, so that no message is forwarded twice**/
+TEST_F(MQTTPubSubClient_ut, OutboxFailedLiveNoDuplicates)
+{
+	char acDir[] = "/tmp/mqtt_outbox_ut_XXXXXX";
+	stOutboxConfig stConfig;
+	stConfig.m_sDir = mkdtemp(acDir);
+	stConfig.m_uiSegmentSize = 64 * 1024;
+	ASSERT_EQ(true, CMQTTPubSubClient_obj.enableOutbox(stConfig));
+
+	for(uint64_t ui64Seq = 1; ui64Seq <= 5; ++ui64Seq)
+	{
+		_addLiveInflight(CMQTTPubSubClient_obj, ui64Seq,
+				mqtt::make_message("TCP_WrReq", "{\"seq\":" + std::to_string(ui64Seq) + "}", 1, false));
+	}
+
+	// one failure among several in flight while connected: only failed message is stored
+	_storeFailedLive(CMQTTPubSubClient_obj, 3, true);
+	EXPECT_EQ(1u, CMQTTPubSubClient_obj.getOutboxPendingCount());
+	EXPECT_EQ(4u, _getLiveInflightCount(CMQTTPubSubClient_obj));
+
+	// failure of a message already stored does not store it again
+	_storeFailedLive(CMQTTPubSubClient_obj, 3, true);
+	EXPECT_EQ(1u, CMQTTPubSubClient_obj.getOutboxPendingCount());
+
+	// failure after connection is lost stores remaining messages in flight once
+	_storeFailedLive(CMQTTPubSubClient_obj, 4, false);
+	EXPECT_EQ(5u, CMQTTPubSubClient_obj.getOutboxPendingCount());
+	EXPECT_EQ(0u, _getLiveInflightCount(CMQTTPubSubClient_obj));
+	_storeFailedLive(CMQTTPubSubClient_obj, 5, false);
+	EXPECT_EQ(5u, CMQTTPubSubClient_obj.getOutboxPendingCount());
+
+	DIR *pDir = opendir(stConfig.m_sDir.c_str());
+	if(NULL != pDir)
+	{
+		struct dirent *pEntry = NULL;
+		while(NULL != (pEntry = readdir(pDir)))
+		{
+			std::string sName(pEntry->d_name);
+			if(("." != sName) && (".." != sName))
+			{
+				unlink((stConfig.m_sDir + "/" + sName).c_str());
+			}
+		}
+		closedir(pDir);
+	}
+	rmdir(stConfig.m_sDir.c_str());
+}
+
+/**Test for CTopicAliasMap::getAlias() allocating aliases till max is reached**/
+TEST_F(MQTTPubSubClient_ut, TopicAliasAllocate)
+{
+	CTopicAliasMap oAliases(2);
+	bool bIsNew = false;
+
+	EXPECT_EQ(1u, oAliases.getAlias("/flowmeter/PL0/D1/update", bIsNew));
+	EXPECT_EQ(true, bIsNew);
+	// alias cannot be used till message mapping it is handed to client
+	EXPECT_EQ(0u, oAliases.getAlias("/flowmeter/PL0/D1/update", bIsNew));
+	EXPECT_EQ(false, bIsNew);
+	oAliases.setMapped("/flowmeter/PL0/D1/update", true);
+	EXPECT_EQ(1u, oAliases.getAlias("/flowmeter/PL0/D1/update", bIsNew));
+	EXPECT_EQ(false, bIsNew);
+
+	EXPECT_EQ(2u, oAliases.getAlias("/flowmeter/PL0/D2/update", bIsNew));
+	EXPECT_EQ(true, bIsNew);
+	EXPECT_EQ(0u, oAliases.getAlias("/flowmeter/PL0/D3/update", bIsNew));
+	EXPECT_EQ(false, bIsNew);
+	EXPECT_EQ(0u, oAliases.getAlias("", bIsNew));
+	EXPECT_EQ(2u, oAliases.getCount());
+}
+
+/**Test for CTopicAliasMap::setMapped() and reset() mapping topic again**/
+TEST_F(MQTTPubSubClient_ut, TopicAliasRemap)
+{
+	CTopicAliasMap oAliases(MQTT_DEFAULT_TOPIC_ALIAS_MAX);
+	bool bIsNew = false;
+
+	EXPECT_EQ(1u, oAliases.getAlias("TCP_WrReq", bIsNew));
+	oAliases.setMapped("TCP_WrReq", false);
+	// failed mapping is sent again with same alias
+	EXPECT_EQ(1u, oAliases.getAlias("TCP_WrReq", bIsNew));
+	EXPECT_EQ(true, bIsNew);
+	oAliases.setMapped("TCP_WrReq", true);
+
+	oAliases.reset();
+	EXPECT_EQ(0u, oAliases.getCount());
+	EXPECT_EQ(1u, oAliases.getAlias("TCP_RdReq", bIsNew));
+	EXPECT_EQ(true, bIsNew);
+
+	CTopicAliasMap oDisabled;
+	EXPECT_EQ(0u, oDisabled.getAlias("TCP_RdReq", bIsNew));
+	EXPECT_EQ(false, bIsNew);
+}
+
+/**Test for CMQTTPubSubClient::readV5Config() reading environment variables**/
+TEST_F(MQTTPubSubClient_ut, ReadV5Config)
+{
+	setenv("MQTT_V5", "true", 1);
+	setenv("MQTT_SESSION_EXPIRY_SEC", "300", 1);
+	setenv("MQTT_RECEIVE_MAX", "100000", 1);
+	setenv("MQTT_TOPIC_ALIAS_MAX", "5", 1);
+	setenv("MQTT_SHARE_GROUP", "bridge", 1);
+	stMQTTv5Config stConfig = CMQTTPubSubClient::readV5Config();
+	EXPECT_EQ(true, stConfig.m_bIsEnabled);
+	EXPECT_EQ(300u, stConfig.m_uiSessionExpirySec);
+	EXPECT_EQ(65535u, stConfig.m_uiReceiveMax);
+	EXPECT_EQ(5u, stConfig.m_uiTopicAliasMax);
+	EXPECT_EQ("bridge", stConfig.m_sShareGroup);
+
+	setenv("MQTT_SHARE_GROUP", "bridge/1", 1);
+	EXPECT_EQ("", CMQTTPubSubClient::readV5Config().m_sShareGroup);
+
+	// invalid values are ignored
+	setenv("MQTT_SESSION_EXPIRY_SEC", "-1", 1);
+	setenv("MQTT_TOPIC_ALIAS_MAX", "5x", 1);
+	stConfig = CMQTTPubSubClient::readV5Config();
+	EXPECT_EQ(0u, stConfig.m_uiSessionExpirySec);
+	EXPECT_EQ((uint16_t)MQTT_DEFAULT_TOPIC_ALIAS_MAX, stConfig.m_uiTopicAliasMax);
+
+	unsetenv("MQTT_V5");
+	unsetenv("MQTT_SESSION_EXPIRY_SEC");
+	unsetenv("MQTT_RECEIVE_MAX");
+	unsetenv("MQTT_TOPIC_ALIAS_MAX");
+	unsetenv("MQTT_SHARE_GROUP");
+	stConfig = CMQTTPubSubClient::readV5Config();
+	EXPECT_EQ(false, stConfig.m_bIsEnabled);
+	EXPECT_EQ((uint16_t)MQTT_DEFAULT_TOPIC_ALIAS_MAX, stConfig.m_uiTopicAliasMax);
+}
+
+/**Test for CMQTTPubSubClient::getSubscribeTopic() and getClientID() using share group**/
+TEST_F(MQTTPubSubClient_ut, SharedSubscriptionTopic)
+{
+	stMQTTv5Config stConfig;
+	stConfig.m_sShareGroup = "bridge";
+	// share group is used only with MQTT v5
+	EXPECT_EQ("/+/+/+/write", CMQTTPubSubClient::getSubscribeTopic("/+/+/+/write", stConfig));
+	EXPECT_EQ("MQTT_EXPORT_SUBSCRIBER", CMQTTPubSubClient::getClientID("MQTT_EXPORT_SUBSCRIBER", stConfig));
+
+	stConfig.m_bIsEnabled = true;
+	EXPECT_EQ("$share/bridge//+/+/+/write", CMQTTPubSubClient::getSubscribeTopic("/+/+/+/write", stConfig));
+	EXPECT_EQ(0u, CMQTTPubSubClient::getClientID("MQTT_EXPORT_SUBSCRIBER", stConfig).find("MQTT_EXPORT_SUBSCRIBER_"));
+
+	stConfig.m_sShareGroup = "";
+	EXPECT_EQ("/+/+/+/write", CMQTTPubSubClient::getSubscribeTopic("/+/+/+/write", stConfig));
+}
+
+/**Test for MQTT v5 topic aliases and shared subscription against broker started with
+ * MQTT/mosquitto_dev.conf. Runs only if MQTT_V5_TEST_URL is set, e.g. "tcp://localhost:11883"**/
+TEST_F(MQTTPubSubClient_ut, V5SharedSubscriptionBroker)
+{
+	const char *pcURL = std::getenv("MQTT_V5_TEST_URL");
+	if((NULL == pcURL) || ('\0' == pcURL[0]))
+	{
+		return;
+	}
+	const int iMsgCount = 100;
+	stMQTTv5Config stSubConfig;
+	stSubConfig.m_bIsEnabled = true;
+	stSubConfig.m_uiSessionExpirySec = 60;
+	stSubConfig.m_uiReceiveMax = 4;
+	stSubConfig.m_sShareGroup = "ut_group";
+	stMQTTv5Config stPubConfig;
+	stPubConfig.m_bIsEnabled = true;
+	// above topic alias maximum of mosquitto (10), so that limit of broker is used
+	stPubConfig.m_uiTopicAliasMax = 1000;
+
+	std::mutex mutexRcvd;
+	std::vector<std::string> vTopics;
+	int aiRcvd[2] = {0, 0};
+	CMQTTPubSubClient oSub1{pcURL, "ut_v5_sub1", 1, false, "", "", "", "MQTTSubListener", stSubConfig};
+	CMQTTPubSubClient oSub2{pcURL, "ut_v5_sub2", 1, false, "", "", "", "MQTTSubListener", stSubConfig};
+	CMQTTPubSubClient oPub{pcURL, "ut_v5_pub", 1, false, "", "", "", "MQTTPubListener", stPubConfig};
+	auto setRcvd = [&](CMQTTPubSubClient &a_oSub, int a_iIndex)
+	{
+		a_oSub.setNotificationMsgRcvd([&, a_iIndex](mqtt::const_message_ptr a_pMsg)
+		{
+			std::lock_guard<std::mutex> lck(mutexRcvd);
+			vTopics.push_back(a_pMsg->get_topic());
+			++aiRcvd[a_iIndex];
+		});
+	};
+	setRcvd(oSub1, 0);
+	setRcvd(oSub2, 1);
+
+	auto waitFor = [](std::function<bool()> a_fcbDone)
+	{
+		for(int i = 0; (i < 500) && (false == a_fcbDone()); ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return a_fcbDone();
+	};
+	oSub1.connect();
+	oSub2.connect();
+	oPub.connect();
+	ASSERT_TRUE(waitFor([&]() { return oSub1.isConnected() && oSub2.isConnected() && oPub.isConnected(); }));
+	EXPECT_EQ(10u, oPub.getTopicAliasMax());
+	oSub1.subscribe("/ut_v5/+/update");
+	oSub2.subscribe("/ut_v5/+/update");
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+	for(int i = 0; i < iMsgCount; ++i)
+	{
+		mqtt::message_ptr pMsg = mqtt::make_message("/ut_v5/D" + std::to_string(i % 3) + "/update",
+				"{\"value\":" + std::to_string(i) + "}", 1, false);
+		EXPECT_EQ(true, oPub.publishMsg(pMsg, true));
+	}
+	EXPECT_TRUE(waitFor([&]() { std::lock_guard<std::mutex> lck(mutexRcvd); return (int)vTopics.size() >= iMsgCount; }));
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+	std::lock_guard<std::mutex> lck(mutexRcvd);
+	// each message is given to one client of group, with topic resolved from alias
+	EXPECT_EQ(iMsgCount, aiRcvd[0] + aiRcvd[1]);
+	EXPECT_LT(0, aiRcvd[0]);
+	EXPECT_LT(0, aiRcvd[1]);
+	for(const auto &sTopic : vTopics)
+	{
+		EXPECT_EQ(0u, sTopic.find("/ut_v5/D"));
+	}
+	EXPECT_EQ(3u, oPub.getTopicAliasCount());
+
+	oPub.disconnect();
+	oSub1.disconnect();
+	oSub2.disconnect();
+}
+
+/**Test for CReconnectBackoff::nextDelayMs() doubling wait up to max with jitter of up to half**/
+TEST_F(MQTTPubSubClient_ut, ReconnectBackoffJitter)
+{
+	CReconnectBackoff oBackoff(100, 1000, 7);
+	uint32_t auiCeilMs[] = {100, 200, 400, 800, 1000, 1000, 1000};
+	for(uint32_t uiCeilMs : auiCeilMs)
+	{
+		uint32_t uiDelayMs = oBackoff.nextDelayMs();
+		EXPECT_LE(uiCeilMs / 2, uiDelayMs);
+		EXPECT_GE(uiCeilMs, uiDelayMs);
+	}
+	EXPECT_EQ(7u, oBackoff.getAttempts());
+
+	oBackoff.reset();
+	uint32_t uiDelayMs = oBackoff.nextDelayMs();
+	EXPECT_LE(50u, uiDelayMs);
+	EXPECT_GE(100u, uiDelayMs);
+
+	// clients with different seeds do not retry together
+	std::set<uint32_t> setFirstDelays;
+	for(uint32_t uiSeed = 1; uiSeed <= 20; ++uiSeed)
+	{
+		CReconnectBackoff oClient(1000, 10000, uiSeed);
+		setFirstDelays.insert(oClient.nextDelayMs());
+	}
+	EXPECT_LT(1u, setFirstDelays.size());
+}
+
+/**Test for CReconnectBackoff::setRange() with invalid range**/
+TEST_F(MQTTPubSubClient_ut, ReconnectBackoffRange)
+{
+	CReconnectBackoff oBackoff(0, 0, 1);
+	EXPECT_EQ(1u, oBackoff.getMaxMs());
+	EXPECT_GE(1u, oBackoff.nextDelayMs());
+
+	oBackoff.setRange(500, 100);
+	EXPECT_EQ(500u, oBackoff.getMaxMs());
+}
+
+/**Fault injection test driving a local mosquitto through connect/disconnect cycles. Broker is killed
+ * and started again; client reconnects each time with backoff and stops reconnecting on disconnect().
+ * Runs only if MQTT_FLAP_TEST_BROKER is set to mosquitto executable, e.g. "/usr/sbin/mosquitto".
+ * Broker listens on MQTT_FLAP_TEST_PORT, 11884 by default**/
+TEST_F(MQTTPubSubClient_ut, ReconnectFlappingBroker)
+{
+	const char *pcBroker = std::getenv("MQTT_FLAP_TEST_BROKER");
+	if((NULL == pcBroker) || ('\0' == pcBroker[0]))
+	{
+		return;
+	}
+	const char *pcPort = std::getenv("MQTT_FLAP_TEST_PORT");
+	std::string sPort = ((NULL == pcPort) || ('\0' == pcPort[0])) ? "11884" : pcPort;
+	const int iCycles = 5;
+
+	auto startBroker = [&]() -> pid_t
+	{
+		pid_t pid = fork();
+		if(0 == pid)
+		{
+			execl(pcBroker, pcBroker, "-p", sPort.c_str(), (char *)NULL);
+			_exit(127);
+		}
+		// let broker open its listener
+		std::this_thread::sleep_for(std::chrono::milliseconds(300));
+		return pid;
+	};
+	auto stopBroker = [](pid_t a_pid)
+	{
+		kill(a_pid, SIGKILL);
+		waitpid(a_pid, NULL, 0);
+	};
+	auto waitFor = [](std::function<bool()> a_fcbDone)
+	{
+		for(int i = 0; (i < 500) && (false == a_fcbDone()); ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return a_fcbDone();
+	};
+
+	setenv("MQTT_RECONNECT_MIN_MS", "50", 1);
+	setenv("MQTT_RECONNECT_MAX_MS", "400", 1);
+	CMQTTPubSubClient oClient{"tcp://localhost:" + sPort, "ut_flap_client", 1, false, "", "", "", "MQTTFlapListener"};
+	unsetenv("MQTT_RECONNECT_MIN_MS");
+	unsetenv("MQTT_RECONNECT_MAX_MS");
+	std::atomic<int> iConnected{0};
+	std::atomic<int> iLost{0};
+	oClient.setNotificationConnect([&](const std::string &) { ++iConnected; });
+	oClient.setNotificationDisConnect([&](const std::string &a_sCause)
+	{
+		if("CONNECT_LOST" == a_sCause)
+		{
+			++iLost;
+		}
+	});
+
+	pid_t pidBroker = startBroker();
+	ASSERT_LT(0, pidBroker);
+	oClient.connect();
+	ASSERT_TRUE(waitFor([&]() { return oClient.isConnected(); }));
+
+	for(int iCycle = 1; iCycle <= iCycles; ++iCycle)
+	{
+		stopBroker(pidBroker);
+		EXPECT_TRUE(waitFor([&]() { return iLost.load() >= iCycle; }));
+		// attempts fail while broker is down
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		EXPECT_FALSE(oClient.isConnected());
+		pidBroker = startBroker();
+		EXPECT_TRUE(waitFor([&]() { return oClient.isConnected(); }));
+	}
+	EXPECT_EQ(iCycles + 1, iConnected.load());
+	// waits grow while broker is down, so attempts in 500 ms stay few
+	EXPECT_LE((uint64_t)iCycles, oClient.getReconnectAttempts());
+	EXPECT_GE((uint64_t)(iCycles * 10), oClient.getReconnectAttempts());
+
+	// no reconnection after disconnect
+	oClient.disconnect();
+	uint64_t ui64Attempts = oClient.getReconnectAttempts();
+	stopBroker(pidBroker);
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	EXPECT_EQ(ui64Attempts, oClient.getReconnectAttempts());
+	EXPECT_EQ(iCycles + 1, iConnected.load());
+}
@@ -0,0 +1,205 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/PayloadCodec_ut.hpp"
+#include <fstream>
+#include <stdio.h>
+
+void PayloadCodec_ut::SetUp()
+{
+	for(int i = 0; i < 500; ++i)
+	{
+		m_vSamples.push_back(createPolledData(i % 50, i));
+	}
+	std::string sDict;
+	ASSERT_TRUE(CPayloadCodec::trainDictionary(m_vSamples, 4096, sDict));
+	m_sDictFile = "/tmp/PayloadCodec_ut.dict";
+	std::ofstream ofs(m_sDictFile, std::ios::binary);
+	ofs << sDict;
+}
+
+void PayloadCodec_ut::TearDown()
+{
+	remove(m_sDictFile.c_str());
+}
+
+/**
+ * Creates polled data payload as published by mqtt-bridge
+ * @param a_iDevice :[in] device number
+ * @param a_iSeq :[in] sequence number
+ * @return payload
+ */
+std::string PayloadCodec_ut::createPolledData(int a_iDevice, int a_iSeq)
+{
+	std::string sSeq = std::to_string(a_iSeq);
+	return "{\"driver_seq\":\"" + std::to_string(1000000 + a_iSeq) + "\",\"topic\":\"/flowmeter/PL0/D" +
+			std::to_string(a_iDevice) + "/update\",\"metric\":\"Flow\",\"value\":\"0x" + std::to_string(a_iSeq % 10) +
+			"0\",\"lastGoodValue\":\"0x00\",\"status\":\"Good\",\"version\":\"2.0\",\"realtime\":\"0\","
+			"\"timestamp\":\"2021-02-23 07:00:0" + std::to_string(a_iSeq % 10) + "\",\"usec\":\"161406360000" + sSeq +
+			"\",\"tsPollingTime\":\"161406360000" + sSeq + "\",\"tsMsgRcvdForProcessing\":\"161406360001" + sSeq +
+			"\",\"tsMsgReadyForPublish\":\"161406360002" + sSeq + "\"}";
+}
+
+/**Test for CPayloadCodec::matchTopic() with MQTT wildcards**/
+TEST_F(PayloadCodec_ut, matchTopic)
+{
+	EXPECT_TRUE(CPayloadCodec::matchTopic("/flowmeter/PL0/D1/update", "/flowmeter/PL0/D1/update"));
+	EXPECT_TRUE(CPayloadCodec::matchTopic("/+/+/+/update", "/flowmeter/PL0/D1/update"));
+	EXPECT_TRUE(CPayloadCodec::matchTopic("/flowmeter/#", "/flowmeter/PL0/D1/update"));
+	EXPECT_TRUE(CPayloadCodec::matchTopic("/flowmeter/#", "/flowmeter"));
+	EXPECT_FALSE(CPayloadCodec::matchTopic("/+/+/+/update", "/flowmeter/PL0/D1/read"));
+	EXPECT_FALSE(CPayloadCodec::matchTopic("/+/+/update", "/flowmeter/PL0/D1/update"));
+	EXPECT_FALSE(CPayloadCodec::matchTopic("/+/+/+/update", "/flowmeter/PL0/D1/update/zstd"));
+	EXPECT_FALSE(CPayloadCodec::matchTopic("/flowmeter/PL0", "/flowmeter/PL0/"));
+}
+
+/**Test for CPayloadCodec::compress() and decompress() using trained dictionary**/
+TEST_F(PayloadCodec_ut, compress_WithDictionary)
+{
+	stPayloadCodecConfig stConfig;
+	stConfig.m_sDictFile = m_sDictFile;
+	CPayloadCodec oCodec(stConfig);
+	ASSERT_NE(0u, oCodec.getDictID());
+
+	std::string sPayload = createPolledData(7, 12345);
+	std::string sCompressed;
+	std::string sDecompressed;
+	ASSERT_TRUE(oCodec.compress(sPayload, sCompressed));
+	ASSERT_TRUE(oCodec.decompress(sCompressed, sDecompressed));
+	EXPECT_EQ(sPayload, sDecompressed);
+
+	// dictionary removes most of the repeated keys
+	EXPECT_LT(sCompressed.size() * 3, sPayload.size());
+	EXPECT_EQ(sPayload.size(), oCodec.getRawBytes());
+	EXPECT_EQ(sCompressed.size(), oCodec.getEncodedBytes());
+
+	// payload compressed with dictionary cannot be decompressed without it
+	CPayloadCodec oNoDict{stPayloadCodecConfig()};
+	EXPECT_FALSE(oNoDict.decompress(sCompressed, sDecompressed));
+	EXPECT_FALSE(oNoDict.decompress(sPayload, sDecompressed));
+}
+
+/**Test for CPayloadCodec::decompress() rejecting payload larger than configured max size**/
+TEST_F(PayloadCodec_ut, decompress_MaxBytes)
+{
+	stPayloadCodecConfig stConfig;
+	stConfig.m_uiMaxBytes = 1024;
+	CPayloadCodec oCodec(stConfig);
+
+	std::string sCompressed;
+	std::string sDecompressed;
+	ASSERT_TRUE(oCodec.compress(std::string(1025, 'a'), sCompressed));
+	EXPECT_FALSE(oCodec.decompress(sCompressed, sDecompressed));
+	ASSERT_TRUE(oCodec.compress(std::string(1024, 'a'), sCompressed));
+	EXPECT_TRUE(oCodec.decompress(sCompressed, sDecompressed));
+}
+
+/**Test for CPayloadCodec::encodeMsg() and decodeMsg() using topic suffix**/
+TEST_F(PayloadCodec_ut, encodeMsg_Suffix)
+{
+	stPayloadCodecConfig stConfig;
+	stConfig.m_sTopics = "/+/+/+/update, /kpi/#";
+	stConfig.m_sDictFile = m_sDictFile;
+	CPayloadCodec oCodec(stConfig);
+	std::string sPayload = createPolledData(1, 1);
+
+	mqtt::const_message_ptr pMsg = oCodec.encodeMsg("/flowmeter/PL0/D1/update", sPayload, 1, false);
+	EXPECT_EQ("/flowmeter/PL0/D1/update/zstd", pMsg->get_topic());
+	EXPECT_NE(sPayload, pMsg->get_payload());
+	ASSERT_TRUE(oCodec.decodeMsg(pMsg));
+	EXPECT_EQ("/flowmeter/PL0/D1/update", pMsg->get_topic());
+	EXPECT_EQ(sPayload, pMsg->get_payload());
+	EXPECT_EQ(1, pMsg->get_qos());
+
+	// other topics and small payloads are sent as is
+	pMsg = oCodec.encodeMsg("/flowmeter/PL0/D1/readResponse", sPayload, 1, false);
+	EXPECT_EQ("/flowmeter/PL0/D1/readResponse", pMsg->get_topic());
+	EXPECT_EQ(sPayload, pMsg->get_payload());
+	ASSERT_TRUE(oCodec.decodeMsg(pMsg));
+	EXPECT_EQ(sPayload, pMsg->get_payload());
+	pMsg = oCodec.encodeMsg("/kpi/a", "{}", 1, false);
+	EXPECT_EQ("/kpi/a", pMsg->get_topic());
+
+	// corrupt payload marked as compressed is rejected
+	pMsg = mqtt::make_message("/flowmeter/PL0/D1/update/zstd", sPayload, 1, false);
+	EXPECT_FALSE(oCodec.decodeMsg(pMsg));
+}
+
+/**Test for CPayloadCodec::encodeMsg() and decodeMsg() using MQTT v5 user property**/
+TEST_F(PayloadCodec_ut, encodeMsg_Property)
+{
+	stPayloadCodecConfig stConfig;
+	stConfig.m_sTopics = "/+/+/+/update";
+	stConfig.m_eSignal = enCODEC_SIGNAL_PROPERTY;
+	CPayloadCodec oCodec(stConfig);
+	std::string sPayload = createPolledData(2, 2);
+
+	mqtt::const_message_ptr pMsg = oCodec.encodeMsg("/flowmeter/PL0/D2/update", sPayload, 0, false);
+	EXPECT_EQ("/flowmeter/PL0/D2/update", pMsg->get_topic());
+	EXPECT_EQ(1u, pMsg->get_properties().count(mqtt::property::USER_PROPERTY));
+	EXPECT_GT(sPayload.size(), pMsg->get_payload().size());
+	ASSERT_TRUE(oCodec.decodeMsg(pMsg));
+	EXPECT_EQ("/flowmeter/PL0/D2/update", pMsg->get_topic());
+	EXPECT_EQ(sPayload, pMsg->get_payload());
+}
+
+/**Test for CPayloadCodec::readConfig() using suffix when property signalling is set without MQTT v5**/
+TEST_F(PayloadCodec_ut, readConfig_PropertyNeedsV5)
+{
+	setenv("MQTT_COMPRESS_SIGNAL", "property", 1);
+	unsetenv("MQTT_V5");
+	EXPECT_EQ(enCODEC_SIGNAL_SUFFIX, CPayloadCodec::readConfig().m_eSignal);
+	setenv("MQTT_V5", "true", 1);
+	EXPECT_EQ(enCODEC_SIGNAL_PROPERTY, CPayloadCodec::readConfig().m_eSignal);
+	unsetenv("MQTT_V5");
+	unsetenv("MQTT_COMPRESS_SIGNAL");
+}
+
+/**Test for CPayloadCodec::readConfig() reading numbers and ignoring invalid values**/
+TEST_F(PayloadCodec_ut, readConfig_Numbers)
+{
+	setenv("MQTT_COMPRESS_LEVEL", "-5", 1);
+	setenv("MQTT_COMPRESS_MIN_BYTES", "128", 1);
+	setenv("MQTT_DECOMPRESS_MAX_BYTES", "1MB", 1);
+	stPayloadCodecConfig stConfig = CPayloadCodec::readConfig();
+	EXPECT_EQ(PAYLOAD_CODEC_DEFAULT_LEVEL, stConfig.m_iLevel);
+	EXPECT_EQ(128u, stConfig.m_uiMinBytes);
+	EXPECT_EQ((size_t)PAYLOAD_CODEC_DEFAULT_MAX_BYTES, stConfig.m_uiMaxBytes);
+
+	setenv("MQTT_COMPRESS_LEVEL", "9", 1);
+	EXPECT_EQ(9, CPayloadCodec::readConfig().m_iLevel);
+	unsetenv("MQTT_COMPRESS_LEVEL");
+	unsetenv("MQTT_COMPRESS_MIN_BYTES");
+	unsetenv("MQTT_DECOMPRESS_MAX_BYTES");
+}
+
+/**Test for CPayloadCodec::getSubscribeTopics() adding topic with suffix when configured**/
+TEST_F(PayloadCodec_ut, getSubscribeTopics)
+{
+	stPayloadCodecConfig stConfig;
+	EXPECT_EQ(std::vector<std::string>({"/+/+/+/update"}), CPayloadCodec(stConfig).getSubscribeTopics("/+/+/+/update"));
+
+	stConfig.m_bSubscribeSuffix = true;
+	CPayloadCodec oCodec(stConfig);
+	EXPECT_EQ(std::vector<std::string>({"/+/+/+/update", "/+/+/+/update/zstd"}), oCodec.getSubscribeTopics("/+/+/+/update"));
+	EXPECT_EQ(std::vector<std::string>({"/flowmeter/#"}), oCodec.getSubscribeTopics("/flowmeter/#"));
+}
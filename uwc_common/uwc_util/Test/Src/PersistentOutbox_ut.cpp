@@ -0,0 +1,286 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/PersistentOutbox_ut.hpp"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void PersistentOutbox_ut::SetUp()
+{
+	char acDir[] = "/tmp/outbox_ut_XXXXXX";
+	m_stConfig.m_sDir = mkdtemp(acDir);
+	m_stConfig.m_uiSegmentSize = 64 * 1024;
+	m_stConfig.m_uiMaxBytes = 4 * 64 * 1024;
+	m_stConfig.m_uiMaxAgeSec = 0;
+}
+
+void PersistentOutbox_ut::TearDown()
+{
+	DIR *pDir = opendir(m_stConfig.m_sDir.c_str());
+	if(NULL != pDir)
+	{
+		struct dirent *pEntry = NULL;
+		while(NULL != (pEntry = readdir(pDir)))
+		{
+			std::string sName(pEntry->d_name);
+			if(("." != sName) && (".." != sName))
+			{
+				unlink((m_stConfig.m_sDir + "/" + sName).c_str());
+			}
+		}
+		closedir(pDir);
+	}
+	rmdir(m_stConfig.m_sDir.c_str());
+}
+
+/**Test for CPersistentOutbox::crc32() with known check value**/
+TEST_F(PersistentOutbox_ut, crc32CheckValue)
+{
+	EXPECT_EQ(0xCBF43926U, CPersistentOutbox::crc32(0, "123456789", 9));
+	// CRC can be calculated in parts
+	uint32_t uiCrc = CPersistentOutbox::crc32(0, "1234", 4);
+	EXPECT_EQ(0xCBF43926U, CPersistentOutbox::crc32(uiCrc, "56789", 5));
+}
+
+/**Test for CPersistentOutbox::readNext() returning messages in order**/
+TEST_F(PersistentOutbox_ut, readInOrder)
+{
+	CPersistentOutbox oOutbox;
+	ASSERT_EQ(true, oOutbox.open(m_stConfig));
+	EXPECT_EQ(false, oOutbox.hasUnread());
+
+	EXPECT_EQ(true, oOutbox.append("topic/a", "msg1", 1, false));
+	EXPECT_EQ(true, oOutbox.append("topic/b", "msg2", 0, true));
+	EXPECT_EQ(2u, oOutbox.getPendingCount());
+
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(1u, m_stMsg.m_uiId);
+	EXPECT_EQ("topic/a", m_stMsg.m_sTopic);
+	EXPECT_EQ("msg1", m_stMsg.m_sPayload);
+	EXPECT_EQ(1, m_stMsg.m_iQos);
+	EXPECT_EQ(false, m_stMsg.m_bIsRetained);
+
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(2u, m_stMsg.m_uiId);
+	EXPECT_EQ("topic/b", m_stMsg.m_sTopic);
+	EXPECT_EQ(true, m_stMsg.m_bIsRetained);
+
+	EXPECT_EQ(false, oOutbox.readNext(m_stMsg));
+}
+
+/**Test for CPersistentOutbox checkpoint: acknowledged messages are not read again after restart**/
+TEST_F(PersistentOutbox_ut, noDuplicateAfterRestart)
+{
+	{
+		CPersistentOutbox oOutbox;
+		ASSERT_EQ(true, oOutbox.open(m_stConfig));
+		for(int i = 1; i <= 5; ++i)
+		{
+			EXPECT_EQ(true, oOutbox.append("topic", "msg" + std::to_string(i), 1, false));
+		}
+		ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+		ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+		ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+		// acknowledgement out of order does not move checkpoint beyond message 1
+		oOutbox.ack(1);
+		oOutbox.ack(3);
+		EXPECT_EQ(4u, oOutbox.getPendingCount());
+	}
+
+	CPersistentOutbox oOutbox;
+	ASSERT_EQ(true, oOutbox.open(m_stConfig));
+	EXPECT_EQ(4u, oOutbox.getPendingCount());
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(2u, m_stMsg.m_uiId);
+	EXPECT_EQ("msg2", m_stMsg.m_sPayload);
+
+	// ids continue after restart
+	EXPECT_EQ(true, oOutbox.append("topic", "msg6", 1, false));
+	uint64_t uiLastId = 0;
+	while(oOutbox.readNext(m_stMsg))
+	{
+		uiLastId = m_stMsg.m_uiId;
+	}
+	EXPECT_EQ(6u, uiLastId);
+}
+
+/**Test for CPersistentOutbox recovery from a torn record**/
+TEST_F(PersistentOutbox_ut, tornRecordIsDiscarded)
+{
+	{
+		CPersistentOutbox oOutbox;
+		ASSERT_EQ(true, oOutbox.open(m_stConfig));
+		EXPECT_EQ(true, oOutbox.append("topic", "msg1", 1, false));
+		EXPECT_EQ(true, oOutbox.append("topic", "msg2", 1, false));
+	}
+
+	// corrupt payload of second record
+	std::string sPath = m_stConfig.m_sDir + "/0000000000000001.seg";
+	int iFd = open(sPath.c_str(), O_RDWR);
+	ASSERT_GE(iFd, 0);
+	char acBuf[4096];
+	ASSERT_EQ((ssize_t)sizeof(acBuf), pread(iFd, acBuf, sizeof(acBuf), 0));
+	std::string sData(acBuf, sizeof(acBuf));
+	size_t uiPos = sData.find("msg2");
+	ASSERT_NE(std::string::npos, uiPos);
+	ASSERT_EQ(1, pwrite(iFd, "X", 1, uiPos));
+	close(iFd);
+
+	CPersistentOutbox oOutbox;
+	ASSERT_EQ(true, oOutbox.open(m_stConfig));
+	EXPECT_EQ(1u, oOutbox.getPendingCount());
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ("msg1", m_stMsg.m_sPayload);
+	EXPECT_EQ(false, oOutbox.readNext(m_stMsg));
+
+	// torn record is overwritten by next message
+	EXPECT_EQ(true, oOutbox.append("topic", "msg3", 1, false));
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(2u, m_stMsg.m_uiId);
+	EXPECT_EQ("msg3", m_stMsg.m_sPayload);
+}
+
+/**Test for CPersistentOutbox size retention dropping oldest messages**/
+TEST_F(PersistentOutbox_ut, sizeRetentionDropsOldest)
+{
+	CPersistentOutbox oOutbox;
+	ASSERT_EQ(true, oOutbox.open(m_stConfig));
+	std::string sPayload(1000, 'a');
+	const int iCount = 1000;
+	for(int i = 0; i < iCount; ++i)
+	{
+		EXPECT_EQ(true, oOutbox.append("topic", sPayload, 1, false));
+	}
+	EXPECT_GT(oOutbox.getDroppedCount(), 0u);
+	EXPECT_EQ((uint64_t)iCount, oOutbox.getPendingCount() + oOutbox.getDroppedCount());
+
+	// newest message is kept and reading starts after dropped ones
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(oOutbox.getDroppedCount() + 1, m_stMsg.m_uiId);
+
+	// message larger than a segment is rejected
+	EXPECT_EQ(false, oOutbox.append("topic", std::string(m_stConfig.m_uiSegmentSize, 'b'), 1, false));
+}
+
+/**Test for CPersistentOutbox::rewind() and rewindAll() reading messages again**/
+TEST_F(PersistentOutbox_ut, rewindReadsAgain)
+{
+	CPersistentOutbox oOutbox;
+	ASSERT_EQ(true, oOutbox.open(m_stConfig));
+	for(int i = 1; i <= 4; ++i)
+	{
+		EXPECT_EQ(true, oOutbox.append("topic", "msg" + std::to_string(i), 1, false));
+	}
+	for(int i = 1; i <= 4; ++i)
+	{
+		ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	}
+	oOutbox.ack(1);
+	oOutbox.rewind(3);
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(3u, m_stMsg.m_uiId);
+
+	oOutbox.rewindAll();
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(2u, m_stMsg.m_uiId);
+}
+
+/**Test for CPersistentOutbox::rewindAll() not reading messages acknowledged out of order**/
+TEST_F(PersistentOutbox_ut, rewindAllSkipsAcked)
+{
+	CPersistentOutbox oOutbox;
+	ASSERT_EQ(true, oOutbox.open(m_stConfig));
+	for(int i = 1; i <= 4; ++i)
+	{
+		EXPECT_EQ(true, oOutbox.append("topic", "msg" + std::to_string(i), 1, false));
+		ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	}
+	oOutbox.ack(3);
+	oOutbox.rewindAll();
+
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(1u, m_stMsg.m_uiId);
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(2u, m_stMsg.m_uiId);
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ(4u, m_stMsg.m_uiId);
+	EXPECT_EQ(false, oOutbox.readNext(m_stMsg));
+}
+
+/**Test for CPersistentOutbox time retention skipping old messages**/
+TEST_F(PersistentOutbox_ut, timeRetentionSkipsOld)
+{
+	m_stConfig.m_uiMaxAgeSec = 1;
+	CPersistentOutbox oOutbox;
+	ASSERT_EQ(true, oOutbox.open(m_stConfig));
+	EXPECT_EQ(true, oOutbox.append("topic", "old", 1, false));
+	sleep(2);
+	EXPECT_EQ(true, oOutbox.append("topic", "new", 1, false));
+
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ("new", m_stMsg.m_sPayload);
+	EXPECT_EQ(1u, oOutbox.getExpiredCount());
+}
+
+/**Test for CPersistentOutbox keeping user properties of a message across restart**/
+TEST_F(PersistentOutbox_ut, userPropsKeptAfterRestart)
+{
+	outbox_user_props_t vecUserProps = {{"uwc-enc", "gz"}, {"uwc-ts", ""}};
+	{
+		CPersistentOutbox oOutbox;
+		ASSERT_EQ(true, oOutbox.open(m_stConfig));
+		EXPECT_EQ(true, oOutbox.append("topic", "msg1", 1, false, vecUserProps));
+		EXPECT_EQ(true, oOutbox.append("topic", "msg2", 1, false));
+	}
+
+	CPersistentOutbox oOutbox;
+	ASSERT_EQ(true, oOutbox.open(m_stConfig));
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ("msg1", m_stMsg.m_sPayload);
+	EXPECT_EQ(vecUserProps, m_stMsg.m_vecUserProps);
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ("msg2", m_stMsg.m_sPayload);
+	EXPECT_EQ(true, m_stMsg.m_vecUserProps.empty());
+}
+
+/**Test for CPersistentOutbox keeping size of existing segment when segment size is changed**/
+TEST_F(PersistentOutbox_ut, segmentSizeChangeKeepsRecords)
+{
+	{
+		CPersistentOutbox oOutbox;
+		ASSERT_EQ(true, oOutbox.open(m_stConfig));
+		EXPECT_EQ(true, oOutbox.append("topic", "msg1", 1, false));
+	}
+
+	std::string sPath = m_stConfig.m_sDir + "/0000000000000001.seg";
+	struct stat stFile;
+	m_stConfig.m_uiSegmentSize = 128 * 1024;
+	CPersistentOutbox oOutbox;
+	ASSERT_EQ(true, oOutbox.open(m_stConfig));
+	ASSERT_EQ(0, stat(sPath.c_str(), &stFile));
+	EXPECT_EQ(64 * 1024, stFile.st_size);
+	ASSERT_EQ(true, oOutbox.readNext(m_stMsg));
+	EXPECT_EQ("msg1", m_stMsg.m_sPayload);
+}
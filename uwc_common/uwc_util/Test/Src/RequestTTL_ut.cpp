@@ -0,0 +1,92 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/RequestTTL_ut.hpp"
+
+void RequestTTL_ut::SetUp()
+{
+	// Setup code
+}
+
+void RequestTTL_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**Test for CRequestTTL::getTTLMs() using per topic TTL and default TTL**/
+TEST_F(RequestTTL_ut, getTTLMs_PerTopic)
+{
+	CRequestTTL oTTL(2000, " /flowmeter/PL0/D1/write = 500,/flowmeter/PL0/D2/read=0,invalid, =10");
+	EXPECT_EQ(500u, oTTL.getTTLMs("/flowmeter/PL0/D1/write"));
+	EXPECT_EQ(0u, oTTL.getTTLMs("/flowmeter/PL0/D2/read"));
+	EXPECT_EQ(2000u, oTTL.getTTLMs("/flowmeter/PL0/D3/read"));
+}
+
+/**Test for CRequestTTL::isExpired() comparing age of request with TTL of its topic**/
+TEST_F(RequestTTL_ut, isExpired)
+{
+	CRequestTTL oTTL(1000, "/flowmeter/PL0/D2/read=0");
+	uint64_t ui64AgeUs = 0;
+
+	EXPECT_FALSE(oTTL.isExpired("/flowmeter/PL0/D1/read", m_ui64NowUs - 1000000, m_ui64NowUs, ui64AgeUs));
+	EXPECT_EQ(1000000u, ui64AgeUs);
+	EXPECT_TRUE(oTTL.isExpired("/flowmeter/PL0/D1/read", m_ui64NowUs - 1000001, m_ui64NowUs, ui64AgeUs));
+
+	// TTL 0 means request on topic never expires
+	EXPECT_FALSE(oTTL.isExpired("/flowmeter/PL0/D2/read", m_ui64NowUs - 60000000, m_ui64NowUs, ui64AgeUs));
+
+	// unknown or future origin is not treated as expired
+	EXPECT_FALSE(oTTL.isExpired("/flowmeter/PL0/D1/read", 0, m_ui64NowUs, ui64AgeUs));
+	EXPECT_FALSE(oTTL.isExpired("/flowmeter/PL0/D1/read", m_ui64NowUs + 5000000, m_ui64NowUs, ui64AgeUs));
+	EXPECT_EQ(0u, ui64AgeUs);
+}
+
+/**Test for CRequestTTL::getOriginUs() using earlier of application and MQTT receive timestamps**/
+TEST_F(RequestTTL_ut, getOriginUs)
+{
+	EXPECT_EQ(m_ui64NowUs - 10, CRequestTTL::getOriginUs(std::to_string(m_ui64NowUs - 10), m_ui64NowUs, 500));
+	EXPECT_EQ(m_ui64NowUs, CRequestTTL::getOriginUs(std::to_string(m_ui64NowUs + 10), m_ui64NowUs, 500));
+	EXPECT_EQ(m_ui64NowUs, CRequestTTL::getOriginUs("", m_ui64NowUs, 500));
+	EXPECT_EQ(m_ui64NowUs, CRequestTTL::getOriginUs("abc", m_ui64NowUs, 500));
+	EXPECT_EQ(m_ui64NowUs, CRequestTTL::getOriginUs(std::to_string(m_ui64NowUs), 0, 500));
+}
+
+/**Test for CRequestTTL::getOriginUs() using MQTT receive time when application clock is skewed beyond TTL**/
+TEST_F(RequestTTL_ut, getOriginUsSkewedAppClock)
+{
+	// application clock one hour behind does not expire request
+	EXPECT_EQ(m_ui64NowUs, CRequestTTL::getOriginUs(std::to_string(m_ui64NowUs - 3600000000ULL), m_ui64NowUs, 500));
+	// difference within TTL is kept
+	EXPECT_EQ(m_ui64NowUs - 400000, CRequestTTL::getOriginUs(std::to_string(m_ui64NowUs - 400000), m_ui64NowUs, 500));
+	EXPECT_EQ(m_ui64NowUs, CRequestTTL::getOriginUs(std::to_string(m_ui64NowUs - 600000), m_ui64NowUs, 500));
+}
+
+/**Test for CRequestTTL::recordExpired() counting expired requests per stage**/
+TEST_F(RequestTTL_ut, recordExpired)
+{
+	CRequestTTL oTTL(0, "");
+	EXPECT_EQ(1u, oTTL.recordExpired(enREQ_TTL_AT_DISPATCH));
+	EXPECT_EQ(2u, oTTL.recordExpired(enREQ_TTL_AT_DISPATCH));
+	EXPECT_EQ(2u, oTTL.getExpiredCount(enREQ_TTL_AT_DISPATCH));
+	EXPECT_EQ(0u, oTTL.getExpiredCount(enREQ_TTL_AT_ADMISSION));
+	EXPECT_EQ(0u, oTTL.recordExpired(enREQ_TTL_STAGE_MAX));
+}
@@ -0,0 +1,109 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/TimeFormatter_ut.hpp"
+#include <thread>
+
+void TimeFormatter_ut::SetUp()
+{
+	memset(m_acBuf, 'x', sizeof(m_acBuf));
+}
+
+void TimeFormatter_ut::TearDown()
+{
+	CTimeFormatter::getInstance().setClockSource(enCLOCK_REALTIME);
+}
+
+/**Test for CTimeFormatter::formatUint() matching std::to_string()**/
+TEST_F(TimeFormatter_ut, formatUint)
+{
+	uint64_t auiValues[] = {0, 1, 9, 10, 99, 100, 101, 999, 1000, 123456789,
+			1614063600123456ULL, 9999999999999999999ULL, 10000000000000000000ULL, UINT64_MAX};
+
+	for(uint64_t uiValue : auiValues)
+	{
+		std::string sExpected = std::to_string(uiValue);
+		EXPECT_EQ(sExpected.size(), CTimeFormatter::formatUint(uiValue, m_acBuf));
+		EXPECT_EQ(sExpected, std::string(m_acBuf));
+	}
+	for(uint64_t uiValue = 1; uiValue < UINT64_MAX / 10; uiValue *= 10)
+	{
+		CTimeFormatter::formatUint(uiValue - 1, m_acBuf);
+		EXPECT_EQ(std::to_string(uiValue - 1), std::string(m_acBuf));
+		CTimeFormatter::formatUint(uiValue, m_acBuf);
+		EXPECT_EQ(std::to_string(uiValue), std::string(m_acBuf));
+	}
+}
+
+/**Test for CTimeFormatter::formatDateTime() across a change of second**/
+TEST_F(TimeFormatter_ut, formatDateTime)
+{
+	EXPECT_EQ(19u, CTimeFormatter::getInstance().formatDateTime(1614063599, m_acBuf));
+	EXPECT_EQ(std::string("2021-02-23 06:59:59"), std::string(m_acBuf));
+	EXPECT_EQ(19u, CTimeFormatter::getInstance().formatDateTime(1614063599, m_acBuf));
+	EXPECT_EQ(std::string("2021-02-23 06:59:59"), std::string(m_acBuf));
+	EXPECT_EQ(19u, CTimeFormatter::getInstance().formatDateTime(1614063600, m_acBuf));
+	EXPECT_EQ(std::string("2021-02-23 07:00:00"), std::string(m_acBuf));
+}
+
+/**Test for CTimeFormatter::microsToString()**/
+TEST_F(TimeFormatter_ut, microsToString)
+{
+	struct timespec stTs;
+	stTs.tv_sec = 1614063600;
+	stTs.tv_nsec = 123456789;
+	EXPECT_EQ(std::string("1614063600123456"), CTimeFormatter::microsToString(stTs));
+	EXPECT_EQ(std::string("1614063600123456"), std::string(CTimeFormatter::microsToStr(stTs, m_acBuf)));
+}
+
+/**Test for CTimeFormatter::getTimeParams() returning consistent timestamp and usec**/
+TEST_F(TimeFormatter_ut, getTimeParams)
+{
+	char acUsec[TIME_FMT_BUFFER_SIZE];
+	CTimeFormatter::getInstance().getTimeParams(m_acBuf, acUsec);
+
+	uint64_t uiUsec = std::stoull(acUsec);
+	char acExpected[TIME_FMT_BUFFER_SIZE];
+	CTimeFormatter::getInstance().formatDateTime((time_t)(uiUsec / 1000000), acExpected);
+	EXPECT_EQ(std::string(acExpected), std::string(m_acBuf));
+}
+
+/**Test for CTimeFormatter::now() with each clock source being close to CLOCK_REALTIME**/
+TEST_F(TimeFormatter_ut, clockSources)
+{
+	eClockSource aenSources[] = {enCLOCK_REALTIME, enCLOCK_REALTIME_COARSE, enCLOCK_TSC};
+	for(eClockSource enSource : aenSources)
+	{
+		bool bIsSet = CTimeFormatter::getInstance().setClockSource(enSource);
+		EXPECT_EQ(bIsSet ? enSource : enCLOCK_REALTIME, CTimeFormatter::getInstance().getClockSource());
+		for(int i = 0; i < 3; ++i)
+		{
+			struct timespec stRef;
+			clock_gettime(CLOCK_REALTIME, &stRef);
+			uint64_t uiNow = CTimeFormatter::getInstance().nowMicros();
+			uint64_t uiRef = CTimeFormatter::toMicros(stRef);
+			uint64_t uiDiff = (uiNow > uiRef) ? (uiNow - uiRef) : (uiRef - uiNow);
+			EXPECT_LT(uiDiff, 50000u);
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+}
@@ -0,0 +1,109 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+#include "../include/TimestampCarrier_ut.hpp"
+
+void TimestampCarrier_ut::SetUp()
+{
+	// Setup code
+}
+
+void TimestampCarrier_ut::TearDown()
+{
+	// TearDown code
+}
+
+/**Test for CTimestampCarrier::patchSlot() overwriting placeholder without changing payload size**/
+TEST_F(TimestampCarrier_ut, patchSlot_InPlace)
+{
+	std::string sMsg = "{\"value\":\"0x00\",\"tsMsgReadyForPublish\":\"" TS_SLOT_PLACEHOLDER "\",\"usec\":\"1\"}";
+	size_t uiSize = sMsg.size();
+
+	EXPECT_TRUE(CTimestampCarrier::patchSlot(sMsg, "tsMsgReadyForPublish", m_ui64NowUs));
+	EXPECT_EQ(uiSize, sMsg.size());
+	EXPECT_EQ("{\"value\":\"0x00\",\"tsMsgReadyForPublish\":\"1614063600123456\",\"usec\":\"1\"}", sMsg);
+
+	// slot is used only once
+	EXPECT_FALSE(CTimestampCarrier::patchSlot(sMsg, "tsMsgReadyForPublish", m_ui64NowUs));
+}
+
+/**Test for CTimestampCarrier::patchSlot() with missing slot and timestamp not fitting in slot**/
+TEST_F(TimestampCarrier_ut, patchSlot_NoSlot)
+{
+	std::string sMsg = "{\"tsMsgReadyForPublish\" : \"" TS_SLOT_PLACEHOLDER "\"}";
+	EXPECT_FALSE(CTimestampCarrier::patchSlot(sMsg, "tsMsgRcvdForProcessing", m_ui64NowUs));
+	EXPECT_FALSE(CTimestampCarrier::patchSlot(sMsg, "tsMsgReadyForPublish", 12345));
+	EXPECT_NE(std::string::npos, CTimestampCarrier::findSlot(sMsg, "tsMsgReadyForPublish"));
+
+	// value having different width is not a slot
+	std::string sShort = "{\"tsMsgReadyForPublish\":\"000\"}";
+	EXPECT_EQ(std::string::npos, CTimestampCarrier::findSlot(sShort, "tsMsgReadyForPublish"));
+}
+
+/**Test for CTimestampCarrier::appendProperties() adding timestamp properties as JSON fields**/
+TEST_F(TimestampCarrier_ut, appendProperties)
+{
+	mqtt::properties props;
+	CTimestampCarrier::addProperty(props, "tsMsgRcvdForProcessing", m_ui64NowUs);
+	CTimestampCarrier::addProperty(props, "tsMsgReadyForPublish", m_ui64NowUs + 1);
+	props.add(mqtt::property(mqtt::property::USER_PROPERTY, std::string("content-encoding"), std::string("zstd")));
+	mqtt::message_ptr pMsg = mqtt::make_message("/flowmeter/PL0/D1/update", "{\"value\":\"0x00\"}");
+	pMsg->set_properties(props);
+
+	std::string sMsg = pMsg->get_payload_str();
+	EXPECT_EQ(2u, CTimestampCarrier::appendProperties(sMsg, pMsg));
+	EXPECT_EQ("{\"value\":\"0x00\",\"tsMsgRcvdForProcessing\":\"1614063600123456\","
+			"\"tsMsgReadyForPublish\":\"1614063600123457\"}", sMsg);
+
+	// fields already present are not added again
+	EXPECT_EQ(0u, CTimestampCarrier::appendProperties(sMsg, pMsg));
+}
+
+/**Test for CTimestampCarrier::appendProperties() with empty payload and message without properties**/
+TEST_F(TimestampCarrier_ut, appendProperties_Empty)
+{
+	mqtt::properties props;
+	CTimestampCarrier::addProperty(props, "tsMsgReadyForPublish", m_ui64NowUs);
+	mqtt::message_ptr pMsg = mqtt::make_message("/flowmeter/PL0/D1/update", "{}");
+	pMsg->set_properties(props);
+
+	std::string sMsg = "{ }";
+	EXPECT_EQ(1u, CTimestampCarrier::appendProperties(sMsg, pMsg));
+	EXPECT_EQ("{ \"tsMsgReadyForPublish\":\"1614063600123456\"}", sMsg);
+
+	std::string sNoProps = "{\"value\":\"0x00\"}";
+	EXPECT_EQ(0u, CTimestampCarrier::appendProperties(sNoProps, mqtt::make_message("/t", "{}")));
+	EXPECT_EQ(0u, CTimestampCarrier::appendProperties(sNoProps, nullptr));
+	EXPECT_EQ("{\"value\":\"0x00\"}", sNoProps);
+}
+
+/**Test for CTimestampCarrier::readMode() reading MQTT_TIMESTAMP_MODE**/
+TEST_F(TimestampCarrier_ut, readMode)
+{
+	unsetenv("MQTT_TIMESTAMP_MODE");
+	EXPECT_EQ(enTS_CARRIER_SLOT, CTimestampCarrier::readMode());
+	setenv("MQTT_TIMESTAMP_MODE", "property", 1);
+	EXPECT_EQ(enTS_CARRIER_PROPERTY, CTimestampCarrier::readMode());
+	setenv("MQTT_TIMESTAMP_MODE", "invalid", 1);
+	EXPECT_EQ(enTS_CARRIER_SLOT, CTimestampCarrier::readMode());
+	unsetenv("MQTT_TIMESTAMP_MODE");
+}
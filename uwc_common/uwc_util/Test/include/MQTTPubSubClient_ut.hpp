@@ -28,6 +28,7 @@
 #include "Logger.hpp"
 #include "CommonDataShare.hpp"
 #include "EnvironmentVarHandler.hpp"
+#include <thread>
 #define SUBSCRIBER_ID "_KPI_SUBSCRIBER"
 
 class MQTTPubSubClient_ut : public::testing::Test
@@ -56,6 +57,27 @@ public:
 						true, "/run/secrets/rootca/cacert.pem",
 						"/run/secrets/mymqttcerts/mymqttcerts_client_certificate.pem", "/run/secrets/mymqttcerts/mymqttcerts_client_key.pem","MQTTSubListener"};
 
+		/** Adds a live message in flight to client, as done when it is published with outbox enabled*/
+		void _addLiveInflight(CMQTTPubSubClient &a_oClient, uint64_t a_ui64Seq, mqtt::const_message_ptr a_pMsg)
+		{
+			std::lock_guard<std::mutex> lck(a_oClient.m_mutexPublishOrder);
+			a_oClient.m_mapLiveInflight.emplace(a_ui64Seq, a_pMsg);
+		}
+
+		/** Stores a failed live message as done on its completion*/
+		void _storeFailedLive(CMQTTPubSubClient &a_oClient, uint64_t a_ui64Seq, bool a_bIsConnected)
+		{
+			std::lock_guard<std::mutex> lck(a_oClient.m_mutexPublishOrder);
+			a_oClient.storeFailedLive(a_ui64Seq, a_bIsConnected);
+		}
+
+		/** Gives number of live messages in flight*/
+		size_t _getLiveInflightCount(CMQTTPubSubClient &a_oClient)
+		{
+			std::lock_guard<std::mutex> lck(a_oClient.m_mutexPublishOrder);
+			return a_oClient.m_mapLiveInflight.size();
+		}
+
 
 
 };
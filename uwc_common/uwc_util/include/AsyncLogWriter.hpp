@@ -0,0 +1,175 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/*** AsyncLogWriter.hpp is used to hand over log statements to a background writer thread
+ * through per-thread lock-free ring buffers */
+
+#ifndef INCLUDE_ASYNCLOGWRITER_HPP_
+#define INCLUDE_ASYNCLOGWRITER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#include <time.h>
+
+/** Default size in bytes of ring buffer allocated for each logging thread */
+#define ASYNC_LOG_DEFAULT_BUFFER_SIZE (64 * 1024)
+/** Interval in milliseconds after which writer thread drains ring buffers */
+#define ASYNC_LOG_FLUSH_INTERVAL_MS 20
+/** Interval in milliseconds after which writer thread logs pending counts of suppressed statements */
+#define ASYNC_LOG_SUPPRESSED_REPORT_INTERVAL_MS 1000
+/** Max number of ring buffers whose pending records are written by crash handler */
+#define ASYNC_LOG_MAX_CRASH_RINGS 256
+
+namespace log4cpp
+{
+class Category;
+}
+
+/** Static information of a logging call site. One constant instance exists per DO_LOG_* statement */
+struct stLogSite
+{
+	const char *m_pcFile; /** source file name*/
+	const char *m_pcFunc; /** function name*/
+	int m_iLine; /** line number*/
+	int m_iPriority; /** log4cpp priority*/
+};
+
+/** Header of a record stored in ring buffer. Message text follows the header */
+struct stLogRecordHdr
+{
+	const stLogSite *m_pSite; /** call site; NULL for padding record at end of buffer*/
+	struct timespec m_stTs; /** time at which statement was logged*/
+	uint32_t m_uiLen; /** message length; for padding record number of bytes to skip*/
+	uint32_t m_uiIsTruncated; /** 1 if message is truncated to fit in buffer*/
+};
+
+/** Single producer single consumer ring buffer of variable length log records */
+class CLogRing
+{
+	std::unique_ptr<char[]> m_pcBuffer; /** storage for records*/
+	size_t m_uiCapacity; /** size of buffer in bytes, power of 2*/
+	size_t m_uiMask; /** mask to map position to offset in buffer*/
+	size_t m_uiMaxMsgLen; /** longer messages are truncated to this length*/
+	std::atomic<size_t> m_uiHead; /** next write position, updated by producer only*/
+	std::atomic<size_t> m_uiTail; /** next read position, updated by consumer only*/
+	std::atomic<bool> m_bIsOwnerAlive; /** false once producer thread has exited*/
+
+	CLogRing(const CLogRing&) = delete;
+	CLogRing& operator=(const CLogRing&) = delete;
+
+	size_t recordSize(size_t a_uiMsgLen) const;
+
+public:
+	explicit CLogRing(size_t a_uiCapacity);
+
+	bool push(const stLogSite &a_stSite, const struct timespec &a_stTs,
+			const char *a_pcMsg, size_t a_uiLen);
+	size_t drain(const std::function<void(const stLogRecordHdr&, const char*)> &a_fcbRecord);
+	void writeToFd(int a_iFd) const;
+
+	/** Returns true if more than half of buffer is in use */
+	bool isHalfFull() const
+	{
+		return (m_uiHead.load(std::memory_order_relaxed) -
+				m_uiTail.load(std::memory_order_relaxed)) > (m_uiCapacity / 2);
+	}
+
+	/** Returns true if there is no record to read */
+	bool isEmpty() const
+	{
+		return m_uiHead.load(std::memory_order_acquire) == m_uiTail.load(std::memory_order_relaxed);
+	}
+
+	/** Marks that producer thread of this ring has exited */
+	void setOwnerExited()
+	{
+		m_bIsOwnerAlive.store(false, std::memory_order_release);
+	}
+
+	/** Returns false once producer thread of this ring has exited */
+	bool isOwnerAlive() const
+	{
+		return m_bIsOwnerAlive.load(std::memory_order_acquire);
+	}
+};
+
+/** class holds background writer which formats and writes records posted by logging threads*/
+class CAsyncLogWriter
+{
+	log4cpp::Category *m_pLogger; /** category to write to*/
+	size_t m_uiBufferSize; /** ring buffer size for each logging thread*/
+	std::atomic<bool> m_bIsRunning; /** true once writer thread is started*/
+	std::atomic<bool> m_bStop; /** signals writer thread to stop*/
+	std::thread m_thWriter; /** writer thread*/
+
+	std::mutex m_mutexRings; /** protects list of registered ring buffers*/
+	std::vector<std::shared_ptr<CLogRing>> m_vRings; /** ring buffers of all logging threads*/
+
+	std::mutex m_mutexDrain; /** only one consumer drains ring buffers at a time*/
+	std::mutex m_mutexWait; /** used with condition variable to wake up writer*/
+	std::condition_variable m_cvWait;
+
+	std::atomic<uint64_t> m_uiOverflowCount; /** number of records dropped as buffer was full*/
+	uint64_t m_uiReportedOverflow; /** overflow count already reported in log*/
+
+	CAsyncLogWriter();
+	CAsyncLogWriter(const CAsyncLogWriter&) = delete;
+	CAsyncLogWriter& operator=(const CAsyncLogWriter&) = delete;
+
+	CLogRing* getThreadRing();
+	void writerThread();
+	void writeRecord(const stLogRecordHdr &a_stHdr, const char *a_pcMsg);
+	void reportOverflow();
+	void reportSuppressed();
+
+public:
+	~CAsyncLogWriter();
+
+	static CAsyncLogWriter& getInstance();
+
+	bool start(log4cpp::Category *a_pLogger, size_t a_uiBufferSize = ASYNC_LOG_DEFAULT_BUFFER_SIZE);
+	void stop();
+	bool post(const stLogSite &a_stSite, const std::string &a_sMsg);
+	bool flush();
+	void installCrashHandler(int a_iFd = -1);
+
+	/** Returns true if writer thread is running and records can be posted */
+	bool isRunning() const
+	{
+		return m_bIsRunning.load(std::memory_order_acquire);
+	}
+
+	/** Returns number of records dropped because ring buffer was full */
+	uint64_t getOverflowCount() const
+	{
+		return m_uiOverflowCount.load(std::memory_order_relaxed);
+	}
+};
+
+#endif /* INCLUDE_ASYNCLOGWRITER_HPP_ */
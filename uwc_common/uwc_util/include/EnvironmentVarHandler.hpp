@@ -29,6 +29,7 @@
 #include <vector>
 #include <mutex>
 #include <string>
+#include <climits>
 
 /** class holds the information about the environment*/
 class EnvironmentInfo
@@ -57,6 +58,10 @@ public:
 	/** Function to get environment variable data from Map based on key */
 	std::string getDataFromEnvMap(std::string);
 
+	/** Function to read a numeric environment variable, checking its value */
+	static unsigned long getEnvNum(const char *a_pcName, unsigned long a_ulDefault,
+			unsigned long a_ulMin = 0, unsigned long a_ulMax = ULONG_MAX);
+
 	/** Returns instance of EnvironmentInfo class
 	 *
 	 * @param : Nothing
@@ -0,0 +1,112 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/*** LogRateLimiter.hpp is used to limit number of statements logged from one call site */
+
+#ifndef INCLUDE_LOGRATELIMITER_HPP_
+#define INCLUDE_LOGRATELIMITER_HPP_
+
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+
+struct stLogSite;
+
+/** Count of statements suppressed at a call site. A count having a call site is linked in a
+ * lock-free list on first suppression, so that it can be reported on a timer even if call
+ * site is not reached again. Such counts are never unlinked, so they must be static. */
+class CLogSuppressedCount
+{
+	const stLogSite *m_pSite; /** call site; NULL if count is reported only with next allowed statement*/
+	const char *m_pcKey; /** prefix of report*/
+	std::atomic<uint64_t> m_uiSuppressed; /** statements suppressed since last report*/
+	std::atomic<bool> m_bIsListed; /** true once linked in list of pending counts*/
+	CLogSuppressedCount *m_pNext; /** next count in list; set once before linking*/
+
+	static std::atomic<CLogSuppressedCount*> m_pHead; /** list of counts having a call site*/
+
+	CLogSuppressedCount(const CLogSuppressedCount&) = delete;
+	CLogSuppressedCount& operator=(const CLogSuppressedCount&) = delete;
+
+public:
+	constexpr CLogSuppressedCount(const stLogSite *a_pSite, const char *a_pcKey)
+		: m_pSite{a_pSite}, m_pcKey{a_pcKey}, m_uiSuppressed{0}, m_bIsListed{false}, m_pNext{nullptr}
+	{
+	}
+
+	void add();
+
+	/** Returns number of suppressed statements and resets it */
+	uint64_t take()
+	{
+		return m_uiSuppressed.exchange(0, std::memory_order_relaxed);
+	}
+
+	static void reportPending(const std::function<void(const stLogSite&, const char*, uint64_t)> &a_fcbReport);
+};
+
+/** Token bucket which allows a burst of statements per period from one call site.
+ * Constructor is constexpr so that static instances are initialized at compile time
+ * and checked without any lock. */
+class CLogRateLimiter
+{
+	const uint32_t m_uiBurst; /** number of statements allowed per period*/
+	const uint32_t m_uiPeriodMs; /** period in milliseconds*/
+	std::atomic<uint64_t> m_uiState; /** time of last refill in ms (plus 1) and available tokens packed in one word*/
+	CLogSuppressedCount m_oSuppressed; /** statements suppressed since last report*/
+
+	CLogRateLimiter(const CLogRateLimiter&) = delete;
+	CLogRateLimiter& operator=(const CLogRateLimiter&) = delete;
+
+public:
+	constexpr CLogRateLimiter(uint32_t a_uiBurst, uint32_t a_uiPeriodMs,
+			const stLogSite *a_pSite = nullptr, const char *a_pcKey = "")
+		: m_uiBurst{(0 == a_uiBurst) ? 1u : a_uiBurst},
+		  m_uiPeriodMs{(0 == a_uiPeriodMs) ? 1u : a_uiPeriodMs},
+		  m_uiState{0}, m_oSuppressed{a_pSite, a_pcKey}
+	{
+	}
+
+	bool isAllowed(uint64_t &a_uiSuppressed);
+	bool isAllowedAt(uint64_t a_uiNowMs, uint64_t &a_uiSuppressed);
+};
+
+/** Sampler which allows one of every N statements from one call site */
+class CLogSampler
+{
+	const uint32_t m_uiEvery; /** one statement is allowed from these many*/
+	std::atomic<uint64_t> m_uiCount; /** number of statements seen*/
+	CLogSuppressedCount m_oSuppressed; /** statements suppressed since last report*/
+
+	CLogSampler(const CLogSampler&) = delete;
+	CLogSampler& operator=(const CLogSampler&) = delete;
+
+public:
+	constexpr CLogSampler(uint32_t a_uiEvery, const stLogSite *a_pSite = nullptr, const char *a_pcKey = "")
+		: m_uiEvery{(0 == a_uiEvery) ? 1u : a_uiEvery}, m_uiCount{0}, m_oSuppressed{a_pSite, a_pcKey}
+	{
+	}
+
+	bool isSampled(uint64_t &a_uiSuppressed);
+};
+
+#endif /* INCLUDE_LOGRATELIMITER_HPP_ */
@@ -27,58 +27,114 @@
 
 #include <log4cpp/Category.hh>
 #include <log4cpp/PropertyConfigurator.hh>
+#include "AsyncLogWriter.hpp"
+#include "LogRateLimiter.hpp"
 
 #include <string>
 #include <iostream>
 
 #define LOGDETAILS(msg) "[ " + std::string(__FILE__) + " " + __func__ + " " + std::to_string(__LINE__) + "] " + std::string(msg)
 
-#define DO_LOG_INFO(msg) { \
-	if(CLogger::getInstance().isLevelSupported(log4cpp::Priority::INFO)) \
+/** File, function and line of a statement are kept in a static call site object,
+ * so that they are not formatted in calling thread */
+#define DO_LOG_AT_LEVEL(level, msg) { \
+	if(CLogger::getInstance().isLevelSupported(level)) \
 	{ \
-		CLogger::getInstance().LogInfo(LOGDETAILS(msg)); \
+		static const stLogSite stLogSite_ = {__FILE__, __func__, __LINE__, level}; \
+		CLogger::getInstance().Log(stLogSite_, msg); \
 	} \
 }
 
-#define DO_LOG_DEBUG(msg) { \
-	if(CLogger::getInstance().isLevelSupported(log4cpp::Priority::DEBUG)) \
-	{ \
-		CLogger::getInstance().LogDebug(LOGDETAILS(msg)); \
-	} \
-}
+#define DO_LOG_INFO(msg) DO_LOG_AT_LEVEL(log4cpp::Priority::INFO, msg)
 
-#define DO_LOG_WARN(msg) { \
-	if(CLogger::getInstance().isLevelSupported(log4cpp::Priority::WARN)) \
-	{ \
-		CLogger::getInstance().LogWarn(LOGDETAILS(msg)); \
-	} \
-}
+#define DO_LOG_DEBUG(msg) DO_LOG_AT_LEVEL(log4cpp::Priority::DEBUG, msg)
+
+#define DO_LOG_WARN(msg) DO_LOG_AT_LEVEL(log4cpp::Priority::WARN, msg)
+
+#define DO_LOG_ERROR(msg) DO_LOG_AT_LEVEL(log4cpp::Priority::ERROR, msg)
+
+#define DO_LOG_FATAL(msg) DO_LOG_AT_LEVEL(log4cpp::Priority::FATAL, msg)
 
-#define DO_LOG_ERROR(msg) { \
-	if(CLogger::getInstance().isLevelSupported(log4cpp::Priority::ERROR)) \
+/** Logs at most a_uiBurst statements per a_uiPeriodMs milliseconds from a call site.
+ * Message expression is not evaluated for suppressed statements. Count of suppressed
+ * statements is logged with next allowed statement, prefixed with key (a string literal).
+ * With asynchronous logging, writer thread also logs pending counts every
+ * ASYNC_LOG_SUPPRESSED_REPORT_INTERVAL_MS, so counts are not lost when suppression ends. */
+#define DO_LOG_AT_LEVEL_RATELIMITED(level, key, a_uiBurst, a_uiPeriodMs, msg) { \
+	if(CLogger::getInstance().isLevelSupported(level)) \
 	{ \
-		CLogger::getInstance().LogError(LOGDETAILS(msg)); \
+		static const stLogSite stLogSite_ = {__FILE__, __func__, __LINE__, level}; \
+		static CLogRateLimiter oLogLimiter_(a_uiBurst, a_uiPeriodMs, &stLogSite_, key); \
+		uint64_t uiLogSuppressed_ = 0; \
+		if(true == oLogLimiter_.isAllowed(uiLogSuppressed_)) \
+		{ \
+			if(0 != uiLogSuppressed_) \
+			{ \
+				CLogger::getInstance().Log(stLogSite_, std::string(key) + ": suppressed " + \
+						std::to_string(uiLogSuppressed_) + " similar messages"); \
+			} \
+			CLogger::getInstance().Log(stLogSite_, msg); \
+		} \
 	} \
 }
 
-#define DO_LOG_FATAL(msg) { \
-	if(CLogger::getInstance().isLevelSupported(log4cpp::Priority::FATAL)) \
+/** Logs one of every a_uiEvery statements from a call site. Suppressed statements are
+ * counted and reported as by DO_LOG_AT_LEVEL_RATELIMITED */
+#define DO_LOG_AT_LEVEL_SAMPLED(level, key, a_uiEvery, msg) { \
+	if(CLogger::getInstance().isLevelSupported(level)) \
 	{ \
-		CLogger::getInstance().LogFatal(LOGDETAILS(msg)); \
+		static const stLogSite stLogSite_ = {__FILE__, __func__, __LINE__, level}; \
+		static CLogSampler oLogSampler_(a_uiEvery, &stLogSite_, key); \
+		uint64_t uiLogSuppressed_ = 0; \
+		if(true == oLogSampler_.isSampled(uiLogSuppressed_)) \
+		{ \
+			if(0 != uiLogSuppressed_) \
+			{ \
+				CLogger::getInstance().Log(stLogSite_, std::string(key) + ": suppressed " + \
+						std::to_string(uiLogSuppressed_) + " similar messages"); \
+			} \
+			CLogger::getInstance().Log(stLogSite_, msg); \
+		} \
 	} \
 }
 
+#define DO_LOG_INFO_RATELIMITED(key, a_uiBurst, a_uiPeriodMs, msg) \
+	DO_LOG_AT_LEVEL_RATELIMITED(log4cpp::Priority::INFO, key, a_uiBurst, a_uiPeriodMs, msg)
+
+#define DO_LOG_DEBUG_RATELIMITED(key, a_uiBurst, a_uiPeriodMs, msg) \
+	DO_LOG_AT_LEVEL_RATELIMITED(log4cpp::Priority::DEBUG, key, a_uiBurst, a_uiPeriodMs, msg)
+
+#define DO_LOG_WARN_RATELIMITED(key, a_uiBurst, a_uiPeriodMs, msg) \
+	DO_LOG_AT_LEVEL_RATELIMITED(log4cpp::Priority::WARN, key, a_uiBurst, a_uiPeriodMs, msg)
+
+#define DO_LOG_ERROR_RATELIMITED(key, a_uiBurst, a_uiPeriodMs, msg) \
+	DO_LOG_AT_LEVEL_RATELIMITED(log4cpp::Priority::ERROR, key, a_uiBurst, a_uiPeriodMs, msg)
+
+#define DO_LOG_INFO_SAMPLED(key, a_uiEvery, msg) \
+	DO_LOG_AT_LEVEL_SAMPLED(log4cpp::Priority::INFO, key, a_uiEvery, msg)
+
+#define DO_LOG_DEBUG_SAMPLED(key, a_uiEvery, msg) \
+	DO_LOG_AT_LEVEL_SAMPLED(log4cpp::Priority::DEBUG, key, a_uiEvery, msg)
+
+#define DO_LOG_WARN_SAMPLED(key, a_uiEvery, msg) \
+	DO_LOG_AT_LEVEL_SAMPLED(log4cpp::Priority::WARN, key, a_uiEvery, msg)
+
+#define DO_LOG_ERROR_SAMPLED(key, a_uiEvery, msg) \
+	DO_LOG_AT_LEVEL_SAMPLED(log4cpp::Priority::ERROR, key, a_uiEvery, msg)
+
 /** class holds information of logger and log levels*/
 class CLogger {
 private:
 	log4cpp::Category *logger; /** reference to the log4cpp*/
 	bool m_bIsExternal; /** Is external or not(true or false)*/
+	bool m_bIsAsync; /** statements are written by background writer thread (true or false)*/
 
 	/** Private constructor so that no objects can be created.*/
 	CLogger();
-	CLogger(const CLogger & obj){logger = NULL;}
+	CLogger(const CLogger & obj){logger = NULL; m_bIsAsync = false;}
 	CLogger& operator=(CLogger const&);
 	bool configLogger(const char* a_pcLogPropsFilePath);
+	void configAsyncWriter();
 
 public:
 	~CLogger();
@@ -115,6 +171,7 @@ public:
 	void LogWarn(std::string msg);
 	void LogError(std::string msg);
 	void LogFatal(std::string msg);
+	void Log(const stLogSite &a_stSite, const std::string &a_sMsg);
 
 	/** function to check level supported or not */
 	bool isLevelSupported(int priority)
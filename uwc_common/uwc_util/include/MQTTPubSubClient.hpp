@@ -27,7 +27,54 @@
 
 #include "mqtt/async_client.h"
 #include "mqtt/will_options.h"
+#include "PersistentOutbox.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+/** Default number of messages which can be in flight in pipelined publish mode */
+#define MQTT_DEFAULT_MAX_INFLIGHT 64
+
+/** Default max number of topic aliases used on a MQTT v5 connection, same as mosquitto's limit */
+#define MQTT_DEFAULT_TOPIC_ALIAS_MAX 10
+
+/** Prefix of shared subscription topic filter */
+#define MQTT_SHARED_SUB_PREFIX "$share/"
+
+/** Default wait before first reconnection attempt */
+#define MQTT_RECONNECT_DEFAULT_MIN_MS 1000
+
+/** Default max wait between reconnection attempts */
+#define MQTT_RECONNECT_DEFAULT_MAX_MS 10000
+
+/** Interval at which a publisher blocked by a connected client with outbox re-checks connection and outbox */
+#define MQTT_OUTBOX_WAIT_SLICE_MS 10
+
+/** MQTT v5 settings of a client. v5 is used only if enabled, otherwise client connects with MQTT 3.1.1 */
+struct stMQTTv5Config
+{
+	bool m_bIsEnabled; /** connect using MQTT v5*/
+	uint32_t m_uiSessionExpirySec; /** session expiry interval; 0 starts a clean session on every connection*/
+	uint16_t m_uiReceiveMax; /** max QoS 1 and 2 messages broker sends without acknowledgement; 0 uses broker default*/
+	uint16_t m_uiTopicAliasMax; /** max topic aliases allocated for published topics; 0 disables topic aliases*/
+	std::string m_sShareGroup; /** group of shared subscriptions; empty for normal subscriptions*/
+
+	stMQTTv5Config()
+		: m_bIsEnabled{false}, m_uiSessionExpirySec{0}, m_uiReceiveMax{0},
+		  m_uiTopicAliasMax{MQTT_DEFAULT_TOPIC_ALIAS_MAX}, m_sShareGroup{""}
+	{
+	}
+};
+
+/** Callback to notify completion of a pipelined publish. a_bIsSuccess is false if message is not delivered */
+typedef std::function<void(mqtt::const_message_ptr a_pMsg, bool a_bIsSuccess)> publish_completion_handler;
 
 /** class is for action failure or success related to mqtt*/
 class action_listener : public virtual mqtt::iaction_listener
@@ -41,17 +88,154 @@ public:
 	action_listener(const std::string& name) : name_(name) {}
 };
 
+/** class tracks pipelined publishes which are in flight. Publisher is blocked when window is full
+ * and is released as delivery tokens complete */
+class CPublishWindow : public virtual mqtt::iaction_listener
+{
+	/** Message in flight; id of its entry is passed as context with publish and returned in token */
+	struct stPendingPublish
+	{
+		mqtt::const_message_ptr m_pMsg; /** published message*/
+		publish_completion_handler m_fcbDone; /** completion callback, can be empty*/
+	};
+
+	size_t m_uiMaxInflight; /** max number of messages in flight*/
+	uint64_t m_ui64NextId; /** id of next message in flight; ids are not reused*/
+	std::map<uint64_t, stPendingPublish> m_mapInflight; /** messages in flight by id, in publish order*/
+	std::mutex m_mutexWindow; /** protects window counters*/
+	std::condition_variable m_cvWindow; /** signalled when a message completes*/
+	std::atomic<uint64_t> m_uiDelivered; /** number of messages delivered*/
+	std::atomic<uint64_t> m_uiFailed; /** number of messages failed*/
+
+	void on_failure(const mqtt::token& tok) override;
+	void on_success(const mqtt::token& tok) override;
+	void complete(const mqtt::token& a_tok, bool a_bIsSuccess);
+	bool take(void *a_pContext, stPendingPublish &a_stPending);
+
+public:
+	explicit CPublishWindow(size_t a_uiMaxInflight = MQTT_DEFAULT_MAX_INFLIGHT);
+
+	void setMaxInflight(size_t a_uiMaxInflight);
+	void* acquire(mqtt::const_message_ptr a_pMsg, const publish_completion_handler &a_fcbDone, int a_iTimeoutMs);
+	bool waitForSlot(int a_iTimeoutMs);
+	void cancel(void *a_pContext);
+	void reset();
+	size_t getInflightCount();
+
+	/** Returns max number of messages in flight */
+	size_t getMaxInflight()
+	{
+		std::lock_guard<std::mutex> lck(m_mutexWindow);
+		return m_uiMaxInflight;
+	}
+
+	/** Returns number of pipelined messages delivered */
+	uint64_t getDeliveredCount() const
+	{
+		return m_uiDelivered.load(std::memory_order_relaxed);
+	}
+
+	/** Returns number of pipelined messages failed */
+	uint64_t getFailedCount() const
+	{
+		return m_uiFailed.load(std::memory_order_relaxed);
+	}
+};
+
+/** class allocates MQTT v5 topic aliases to published topics of a connection. Aliases are given to topics
+ * in order of first publish till max is reached. Alias of a topic is used without topic only after message
+ * which maps topic to alias is handed to client */
+class CTopicAliasMap
+{
+	/** Alias of a topic and whether message mapping it is handed to client*/
+	struct stTopicAlias
+	{
+		uint16_t m_uiAlias;
+		bool m_bIsMapped; /** message mapping topic is handed to client*/
+		bool m_bIsPending; /** message mapping topic is being handed to client*/
+	};
+
+	uint16_t m_uiMax; /** max number of aliases*/
+	uint16_t m_uiNext; /** next free alias*/
+	std::unordered_map<std::string, stTopicAlias> m_mapAlias; /** alias of each topic*/
+	std::mutex m_mutexAlias; /** protects map*/
+
+public:
+	explicit CTopicAliasMap(uint16_t a_uiMax = 0);
+
+	void setMax(uint16_t a_uiMax);
+	uint16_t getAlias(const std::string &a_sTopic, bool &a_bIsNew);
+	void setMapped(const std::string &a_sTopic, bool a_bIsMapped);
+	void reset();
+
+	/** Returns number of allocated aliases */
+	size_t getCount()
+	{
+		std::lock_guard<std::mutex> lck(m_mutexAlias);
+		return m_mapAlias.size();
+	}
+
+	/** Returns max number of aliases */
+	uint16_t getMax()
+	{
+		std::lock_guard<std::mutex> lck(m_mutexAlias);
+		return m_uiMax;
+	}
+};
+
+/** class gives waits between reconnection attempts. Wait doubles with each attempt till max is reached and
+ * a random part of up to half of it is taken off, so that clients which lose a broker together do not
+ * reconnect together */
+class CReconnectBackoff
+{
+	uint32_t m_uiMinMs; /** wait before first attempt*/
+	uint32_t m_uiMaxMs; /** max wait between attempts*/
+	uint32_t m_uiAttempts; /** attempts since last reset*/
+	std::mt19937 m_oRandom; /** source of jitter*/
+
+public:
+	CReconnectBackoff(uint32_t a_uiMinMs, uint32_t a_uiMaxMs, uint32_t a_uiSeed = std::random_device{}());
+
+	void setRange(uint32_t a_uiMinMs, uint32_t a_uiMaxMs);
+	uint32_t nextDelayMs();
+
+	/** Starts again from min wait */
+	void reset()
+	{
+		m_uiAttempts = 0;
+	}
+
+	/** Returns number of attempts since last reset */
+	uint32_t getAttempts() const
+	{
+		return m_uiAttempts;
+	}
+
+	/** Returns max wait between attempts */
+	uint32_t getMaxMs() const
+	{
+		return m_uiMaxMs;
+	}
+};
+
 /** class holds information regarding mqtt connection on success and on connection failure, message received or not*/
 class CMQTTPubSubClient : public virtual mqtt::callback,
 					public virtual mqtt::iaction_listener
 
 {
 	int m_iQOS; /** QoS value to be used for publishing*/
+	stMQTTv5Config m_stV5Config; /** MQTT v5 settings*/
 	std::string m_sClientID; /** client id to be used for mqtt connection*/
 	mqtt::async_client m_Client; /** mqtt async client*/
 	mqtt::connect_options m_ConOptions; /** mqtt async client connection options*/
 	/** An action listener to display the result of actions.*/
 	action_listener m_Listener;
+	/** Tracks messages published in pipelined mode*/
+	CPublishWindow m_PublishWindow;
+	/** Topic aliases of current connection*/
+	CTopicAliasMap m_TopicAliases;
+	/** Topic alias maximum sent by broker in CONNACK of current connection*/
+	std::atomic<uint16_t> m_uiBrokerAliasMax{0};
 
 	/** Callback functions for various operations*/
 	bool m_bNotifyConnection = false; 
@@ -63,6 +247,45 @@ class CMQTTPubSubClient : public virtual mqtt::callback,
 	bool m_bNotifyMsgRcvd = false;
 	mqtt::async_client::message_handler m_fcbMsgRcvd;
 
+	/** Outbox storing messages which cannot be published; NULL if not enabled*/
+	std::unique_ptr<CPersistentOutbox> m_pOutbox;
+	/** Keeps order between live messages and messages forwarded from outbox*/
+	std::mutex m_mutexPublishOrder;
+	/** Live messages published while outbox is enabled which are not yet delivered, in publish order.
+	 * Protected by m_mutexPublishOrder*/
+	std::map<uint64_t, mqtt::const_message_ptr> m_mapLiveInflight;
+	uint64_t m_ui64LiveSeq = 0; /** publish order of last live message*/
+	std::thread m_thOutboxDrain; /** forwards messages from outbox*/
+	std::atomic<bool> m_bStopDrain; /** signals drain thread to stop*/
+	std::mutex m_mutexDrain; /** used with condition variable to wake up drain thread*/
+	std::condition_variable m_cvDrain;
+
+	/** Reconnection is done by this client instead of MQTT library, with jittered backoff*/
+	CReconnectBackoff m_Backoff{MQTT_RECONNECT_DEFAULT_MIN_MS, MQTT_RECONNECT_DEFAULT_MAX_MS};
+	std::thread m_thReconnect; /** makes reconnection attempts*/
+	std::mutex m_mutexReconnect; /** protects reconnection state*/
+	std::condition_variable m_cvReconnect; /** wakes up reconnect thread*/
+	bool m_bIsReconnectEnabled = false; /** set by connect() and cleared by disconnect()*/
+	bool m_bIsReconnectDue = false; /** a reconnection attempt is scheduled*/
+	std::chrono::steady_clock::time_point m_tpReconnectAt; /** time of scheduled attempt*/
+	std::chrono::steady_clock::time_point m_tpConnectedAt; /** time of last successful connection*/
+	std::atomic<uint64_t> m_ui64ReconnectAttempts{0}; /** reconnection attempts made*/
+
+	mqtt::delivery_token_ptr publishToBroker(mqtt::const_message_ptr a_pMsg, void *a_pContext,
+		mqtt::iaction_listener &a_Listener);
+	bool publishWithOutbox(mqtt::message_ptr &a_pubMsg,
+		const publish_completion_handler &a_fcbDone, int a_iWaitTimeoutMs);
+	bool storeInOutbox(mqtt::const_message_ptr a_pMsg);
+	void storeLiveInflight();
+	void storeFailedLive(uint64_t a_ui64Seq, bool a_bIsConnected);
+	void completeLive(uint64_t a_ui64Seq, mqtt::const_message_ptr a_pMsg, bool a_bIsSuccess,
+		const publish_completion_handler &a_fcbDone);
+	void drainOutbox();
+	void stopOutboxDrain();
+	void reconnectLoop();
+	void scheduleReconnect(bool a_bIsConnectionLost);
+	void stopReconnect();
+
 	/** Re-connection failure */
 	void on_failure(const mqtt::token& tok) override;
 
@@ -82,15 +305,69 @@ class CMQTTPubSubClient : public virtual mqtt::callback,
 
 	void delivery_complete(mqtt::delivery_token_ptr token) override {}
 
+	friend class MQTTPubSubClient_ut;
+
 public:
 	/** constructor*/
 	CMQTTPubSubClient(const std::string &a_sBrokerURL, std::string a_sClientID, 
 		int a_iQOS, 
 		bool a_bIsTLS, std::string a_sCATrustStoreSecret, 
 		std::string a_sClientPvtKeySecret, std::string a_sClientCertSecret, 
-		std::string a_sListener = "Subscription");
+		std::string a_sListener = "Subscription",
+		const stMQTTv5Config &a_stV5Config = stMQTTv5Config());
+	virtual ~CMQTTPubSubClient();
+
+	static stMQTTv5Config readV5Config();
+	static std::string getClientID(const std::string &a_sClientID, const stMQTTv5Config &a_stV5Config);
+	static std::string getSubscribeTopic(const std::string &a_sTopic, const stMQTTv5Config &a_stV5Config);
 
 	bool publishMsg(mqtt::message_ptr &a_pubMsg, bool a_bIsWaitForCompletion = false);
+	bool publishMsgPipelined(mqtt::message_ptr &a_pubMsg,
+		const publish_completion_handler &a_fcbDone = nullptr, int a_iWaitTimeoutMs = -1);
+	void setMaxInflight(int a_iMaxInflight);
+	bool enableOutbox(const stOutboxConfig &a_stConfig);
+
+	/** Returns true if outbox is enabled */
+	bool isOutboxEnabled() const
+	{
+		return (nullptr != m_pOutbox);
+	}
+
+	/** Returns number of messages in outbox which are not yet forwarded */
+	uint64_t getOutboxPendingCount()
+	{
+		return (nullptr != m_pOutbox) ? m_pOutbox->getPendingCount() : 0;
+	}
+
+	/** Returns number of pipelined messages which are not yet completed */
+	size_t getInflightCount()
+	{
+		return m_PublishWindow.getInflightCount();
+	}
+
+	/** Returns number of topic aliases allocated on current connection */
+	size_t getTopicAliasCount()
+	{
+		return m_TopicAliases.getCount();
+	}
+
+	/** Returns max number of topic aliases of current connection */
+	uint16_t getTopicAliasMax()
+	{
+		return m_TopicAliases.getMax();
+	}
+
+	/** Returns number of reconnection attempts made */
+	uint64_t getReconnectAttempts() const
+	{
+		return m_ui64ReconnectAttempts.load(std::memory_order_relaxed);
+	}
+
+	/** Returns client id used for connection */
+	const std::string& getClientID() const
+	{
+		return m_sClientID;
+	}
 
 	bool setWillMsg(const mqtt::will_options & will)
 	{
@@ -144,7 +421,8 @@ protected:
 public:
 	CMQTTBaseHandler(const std::string &a_sBrokerURL, const std::string &a_sClientID,
 		int a_iQOS, bool a_bIsTLS, const std::string &a_sCaCert, const std::string &a_sClientCert,
-		const std::string &a_sClientKey, const std::string &a_sListener);
+		const std::string &a_sClientKey, const std::string &a_sListener,
+		const stMQTTv5Config &a_stV5Config = stMQTTv5Config());
 	virtual ~CMQTTBaseHandler();
 
 	virtual void connected(const std::string &a_sCause);
@@ -156,6 +434,7 @@ public:
 	void disconnect();
 
 	bool publishMsg(const std::string &a_sMsg, const std::string &a_sTopic);
+	bool publishMsg(const std::string &a_sMsg, const std::string &a_sTopic, const mqtt::properties &a_props);
 };
 
 #endif
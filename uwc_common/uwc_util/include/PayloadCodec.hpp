@@ -0,0 +1,125 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/*** PayloadCodec.hpp is used to compress MQTT payloads of configured topics using zstd
+ * with an optional shared dictionary, and to decompress them on the subscribing side */
+
+#ifndef INCLUDE_PAYLOADCODEC_HPP_
+#define INCLUDE_PAYLOADCODEC_HPP_
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "mqtt/async_client.h"
+
+/** Suffix added to topic of a compressed message when suffix signalling is used */
+#define PAYLOAD_CODEC_TOPIC_SUFFIX "/zstd"
+/** MQTT v5 user property marking a compressed message when property signalling is used */
+#define PAYLOAD_CODEC_PROPERTY_NAME "content-encoding"
+#define PAYLOAD_CODEC_PROPERTY_VALUE "zstd"
+/** Default zstd compression level */
+#define PAYLOAD_CODEC_DEFAULT_LEVEL 3
+/** Payloads smaller than this are sent as is */
+#define PAYLOAD_CODEC_DEFAULT_MIN_BYTES 64
+/** Max size of a decompressed payload; larger payloads are rejected */
+#define PAYLOAD_CODEC_DEFAULT_MAX_BYTES (1024 * 1024)
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+/** How a compressed message is marked for subscribers */
+enum eCodecSignal
+{
+	enCODEC_SIGNAL_SUFFIX = 0, /** PAYLOAD_CODEC_TOPIC_SUFFIX is added to topic*/
+	enCODEC_SIGNAL_PROPERTY /** user property is added; needs MQTT v5 connection*/
+};
+
+/** Codec configuration */
+struct stPayloadCodecConfig
+{
+	std::string m_sTopics; /** comma separated topic filters whose payloads are compressed*/
+	std::string m_sDictFile; /** file having zstd dictionary; empty means no dictionary*/
+	int m_iLevel = PAYLOAD_CODEC_DEFAULT_LEVEL; /** compression level*/
+	size_t m_uiMinBytes = PAYLOAD_CODEC_DEFAULT_MIN_BYTES; /** smaller payloads are not compressed*/
+	size_t m_uiMaxBytes = PAYLOAD_CODEC_DEFAULT_MAX_BYTES; /** max size of decompressed payload*/
+	eCodecSignal m_eSignal = enCODEC_SIGNAL_SUFFIX; /** how compressed messages are marked*/
+	bool m_bSubscribeSuffix = false; /** subscriptions also cover topics having suffix*/
+};
+
+/**
+ * Class to compress and decompress MQTT payloads. Compression is applied only to
+ * configured topics. Decompression is applied to every message marked as compressed,
+ * so subscribers need not know which topics are compressed.
+ */
+class CPayloadCodec
+{
+	stPayloadCodecConfig m_stConfig; /** configuration*/
+	std::vector<std::string> m_vTopicFilters; /** topic filters to compress*/
+	ZSTD_CDict_s *m_pCDict; /** digested dictionary for compression, NULL if no dictionary*/
+	ZSTD_DDict_s *m_pDDict; /** digested dictionary for decompression, NULL if no dictionary*/
+	unsigned m_uiDictID; /** id of dictionary, 0 if no dictionary*/
+	std::atomic<uint64_t> m_ui64RawBytes; /** bytes given for compression*/
+	std::atomic<uint64_t> m_ui64EncodedBytes; /** bytes after compression*/
+
+	CPayloadCodec(const CPayloadCodec&) = delete;
+	CPayloadCodec& operator=(const CPayloadCodec&) = delete;
+
+	bool loadDictionary(const std::string &a_sDict);
+
+public:
+	explicit CPayloadCodec(const stPayloadCodecConfig &a_stConfig);
+	~CPayloadCodec();
+
+	static CPayloadCodec& getInstance();
+	static stPayloadCodecConfig readConfig();
+	static bool matchTopic(const std::string &a_sFilter, const std::string &a_sTopic);
+	static bool trainDictionary(const std::vector<std::string> &a_vSamples, size_t a_uiDictBytes, std::string &a_sDict);
+
+	bool isCompressedTopic(const std::string &a_sTopic) const;
+	bool compress(const std::string &a_sIn, std::string &a_sOut);
+	bool decompress(const std::string &a_sIn, std::string &a_sOut);
+
+	mqtt::message_ptr encodeMsg(const std::string &a_sTopic, const std::string &a_sPayload, int a_iQOS, bool a_bRetained);
+	bool decodeMsg(mqtt::const_message_ptr &a_pMsg);
+	std::vector<std::string> getSubscribeTopics(const std::string &a_sTopic) const;
+
+	/** Returns dictionary id, 0 if no dictionary is used */
+	unsigned getDictID() const
+	{
+		return m_uiDictID;
+	}
+
+	/** Returns number of payload bytes given for compression */
+	uint64_t getRawBytes() const
+	{
+		return m_ui64RawBytes.load(std::memory_order_relaxed);
+	}
+
+	/** Returns number of payload bytes after compression */
+	uint64_t getEncodedBytes() const
+	{
+		return m_ui64EncodedBytes.load(std::memory_order_relaxed);
+	}
+};
+
+#endif /* INCLUDE_PAYLOADCODEC_HPP_ */
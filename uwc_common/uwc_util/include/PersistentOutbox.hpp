@@ -0,0 +1,165 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/*** PersistentOutbox.hpp is used to store messages on disk while they cannot be published
+ * and to forward them in order once publishing is possible again */
+
+#ifndef INCLUDE_PERSISTENTOUTBOX_HPP_
+#define INCLUDE_PERSISTENTOUTBOX_HPP_
+
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+/** Default size of one segment file */
+#define OUTBOX_DEFAULT_SEGMENT_SIZE (4 * 1024 * 1024)
+/** Default max disk space used by outbox */
+#define OUTBOX_DEFAULT_MAX_BYTES (256 * 1024 * 1024)
+/** Default number of messages forwarded per second after reconnection */
+#define OUTBOX_DEFAULT_DRAIN_RATE 500
+/** Min interval between synchronous writes of checkpoint to disk */
+#define OUTBOX_CKPT_SYNC_INTERVAL_MS 100
+
+/** MQTT v5 user properties of a stored message, as name and value pairs */
+typedef std::vector<std::pair<std::string, std::string>> outbox_user_props_t;
+
+/** Outbox configuration */
+struct stOutboxConfig
+{
+	std::string m_sDir; /** directory to store segment files; created if not present*/
+	size_t m_uiSegmentSize = OUTBOX_DEFAULT_SEGMENT_SIZE; /** size of one segment file*/
+	size_t m_uiMaxBytes = OUTBOX_DEFAULT_MAX_BYTES; /** oldest segments are dropped beyond this size*/
+	uint32_t m_uiMaxAgeSec = 0; /** messages older than this are not forwarded; 0 means no limit*/
+	uint32_t m_uiDrainRate = OUTBOX_DEFAULT_DRAIN_RATE; /** messages per second forwarded; 0 means no limit*/
+};
+
+/** Message read from outbox */
+struct stOutboxMsg
+{
+	uint64_t m_uiId; /** record id, increases by one for every stored message*/
+	uint64_t m_uiTsMs; /** time at which message was stored, ms since epoch*/
+	std::string m_sTopic; /** topic*/
+	std::string m_sPayload; /** payload*/
+	int m_iQos; /** QoS*/
+	bool m_bIsRetained; /** retained flag*/
+	outbox_user_props_t m_vecUserProps; /** user properties*/
+};
+
+/** Append-only outbox made of memory mapped segment files. Each record carries a CRC so
+ * that a record torn by a crash is detected on restart. Id of last forwarded record is kept in
+ * a memory mapped checkpoint file, so messages are neither lost nor forwarded again on restart.
+ * Checkpoint is synced to disk at most every OUTBOX_CKPT_SYNC_INTERVAL_MS, so after a crash of
+ * host, messages forwarded within that interval may be forwarded again. */
+class CPersistentOutbox
+{
+	/** Position of a record */
+	struct stPos
+	{
+		uint64_t m_uiSegNo; /** segment number*/
+		size_t m_uiOffset; /** offset in segment*/
+	};
+
+	/** Mapped segment file */
+	struct stSegment
+	{
+		uint64_t m_uiNumber; /** segment number, part of file name*/
+		int m_iFd; /** file descriptor*/
+		char *m_pcBase; /** mapped address*/
+		size_t m_uiSize; /** file size; segments written before a change of segment size keep their size*/
+		uint64_t m_uiFirstId; /** id of first record; 0 if segment is empty*/
+		uint64_t m_uiLastId; /** id of last record; 0 if segment is empty*/
+		size_t m_uiEnd; /** offset after last valid record*/
+	};
+
+	/** Checkpoint slot; two slots are written alternately */
+	struct stCheckpointSlot
+	{
+		uint64_t m_uiSeq; /** write sequence*/
+		uint64_t m_uiAckedId; /** id of last forwarded record*/
+		uint64_t m_uiCheck; /** m_uiSeq ^ m_uiAckedId ^ magic*/
+	};
+
+	stOutboxConfig m_stConfig; /** configuration*/
+	std::mutex m_mutexOutbox; /** protects all members below*/
+	bool m_bIsOpen; /** true once outbox is opened*/
+	std::deque<stSegment> m_dqSegments; /** segments, oldest first; last one is written*/
+	uint64_t m_uiNextId; /** id to be given to next stored record*/
+	uint64_t m_uiReadId; /** id of next record to be read*/
+	stPos m_stReadPos; /** position of next record to be read*/
+	std::deque<std::pair<uint64_t, stPos>> m_dqUnacked; /** records read but not yet acknowledged*/
+	std::set<uint64_t> m_setAckedAhead; /** ids acknowledged out of order*/
+	uint64_t m_uiAckedId; /** all records up to this id are forwarded*/
+	uint64_t m_uiCkptSeq; /** write sequence of checkpoint*/
+	uint64_t m_uiCkptSyncMs; /** time at which checkpoint was last written to disk*/
+	int m_iCkptFd; /** checkpoint file descriptor*/
+	stCheckpointSlot *m_pCkpt; /** mapped checkpoint slots*/
+	uint64_t m_uiDropped; /** records dropped because of size retention*/
+	uint64_t m_uiExpired; /** records not forwarded because of time retention*/
+
+	CPersistentOutbox(const CPersistentOutbox&) = delete;
+	CPersistentOutbox& operator=(const CPersistentOutbox&) = delete;
+
+	std::string segmentPath(uint64_t a_uiSegNo) const;
+	bool mapSegment(uint64_t a_uiSegNo, bool a_bIsNew, stSegment &a_stSeg);
+	void unmapSegment(stSegment &a_stSeg, bool a_bIsRemove);
+	void scanSegment(stSegment &a_stSeg);
+	bool openCheckpoint();
+	void writeCheckpoint(bool a_bIsSyncNow = false);
+	bool addSegment();
+	void dropOldestSegment();
+	void releaseForwardedSegments();
+	void advanceAcked(uint64_t a_uiId);
+	stSegment* findSegment(uint64_t a_uiSegNo);
+
+public:
+	CPersistentOutbox();
+	~CPersistentOutbox();
+
+	bool open(const stOutboxConfig &a_stConfig);
+	void close();
+
+	bool append(const std::string &a_sTopic, const std::string &a_sPayload, int a_iQos, bool a_bIsRetained,
+			const outbox_user_props_t &a_vecUserProps = outbox_user_props_t());
+	bool readNext(stOutboxMsg &a_stMsg);
+	void ack(uint64_t a_uiId);
+	void rewind(uint64_t a_uiId);
+	void rewindAll();
+
+	bool hasUnread();
+	uint64_t getPendingCount();
+	uint64_t getDroppedCount();
+	uint64_t getExpiredCount();
+
+	/** Returns configuration in use */
+	const stOutboxConfig& getConfig() const
+	{
+		return m_stConfig;
+	}
+
+	static uint32_t crc32(uint32_t a_uiCrc, const void *a_pData, size_t a_uiLen);
+};
+
+#endif /* INCLUDE_PERSISTENTOUTBOX_HPP_ */
@@ -0,0 +1,72 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/*** RequestTTL.hpp is used to decide if an on-demand request is too old to be executed */
+
+#ifndef INCLUDE_REQUESTTTL_HPP_
+#define INCLUDE_REQUESTTTL_HPP_
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+
+/** Error code reported in response of an expired request; same as APP_ERROR_REQUEST_EXPIRED of modbus-master */
+#define REQUEST_TTL_ERROR_CODE 111
+
+/** Points at which age of a request is checked */
+enum eReqTTLStage
+{
+	enREQ_TTL_AT_ADMISSION = 0, /** request received from MQTT*/
+	enREQ_TTL_AT_DISPATCH, /** request about to be sent on EII*/
+	enREQ_TTL_AT_EXECUTION, /** request about to be sent to device*/
+	enREQ_TTL_STAGE_MAX
+};
+
+/** Class holds time-to-live of on-demand requests and counts expired requests.
+ * Age of a request is measured from its earliest timestamp, i.e. time at which application
+ * sent it or time at which it was received from MQTT. */
+class CRequestTTL
+{
+	uint32_t m_uiDefaultTTLMs; /** TTL of topics not configured separately, 0 for none*/
+	std::unordered_map<std::string, uint32_t> m_mapTopicTTLMs; /** TTL per MQTT topic*/
+	std::atomic<uint64_t> m_aui64Expired[enREQ_TTL_STAGE_MAX]; /** expired requests per stage*/
+
+	CRequestTTL(const CRequestTTL&) = delete;
+	CRequestTTL& operator=(const CRequestTTL&) = delete;
+
+public:
+	CRequestTTL(uint32_t a_uiDefaultTTLMs, const std::string &a_sTopicTTLs);
+
+	static CRequestTTL& getInstance();
+
+	uint32_t getTTLMs(const std::string &a_sTopic) const;
+	bool isExpired(const std::string &a_sTopic, uint64_t a_ui64OriginUs, uint64_t a_ui64NowUs,
+			uint64_t &a_ui64AgeUs) const;
+	uint64_t recordExpired(eReqTTLStage a_eStage);
+	uint64_t getExpiredCount(eReqTTLStage a_eStage) const;
+
+	static uint64_t getOriginUs(const std::string &a_sAppUsec, uint64_t a_ui64RcvdUs, uint32_t a_uiMaxSkewMs);
+	static const char* getStageName(eReqTTLStage a_eStage);
+};
+
+#endif /* INCLUDE_REQUESTTTL_HPP_ */
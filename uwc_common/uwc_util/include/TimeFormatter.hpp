@@ -0,0 +1,93 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/*** TimeFormatter.hpp is used to read current time from a configurable clock source
+ * and to format timestamps without heap allocation */
+
+#ifndef INCLUDE_TIMEFORMATTER_HPP_
+#define INCLUDE_TIMEFORMATTER_HPP_
+
+#include <atomic>
+#include <string>
+#include <stdint.h>
+#include <time.h>
+
+/** Length of "%Y-%m-%d %H:%M:%S" timestamp */
+#define TIME_FMT_DATETIME_LEN 19
+/** Size of buffer to be provided by caller for any formatted value, including terminating NUL */
+#define TIME_FMT_BUFFER_SIZE 32
+
+/** Clock sources which can be used to read current time */
+enum eClockSource
+{
+	enCLOCK_REALTIME = 0, /** clock_gettime(CLOCK_REALTIME), served from vDSO*/
+	enCLOCK_REALTIME_COARSE, /** clock_gettime(CLOCK_REALTIME_COARSE), vDSO; resolution is one tick*/
+	enCLOCK_TSC /** time stamp counter scaled to wall clock; re-anchored to CLOCK_REALTIME every second*/
+};
+
+/** Class to read current time and to format it. Formatted date-time is cached per thread
+ * and is recomputed only when second changes */
+class CTimeFormatter
+{
+	std::atomic<int> m_iClockSource; /** clock source in use, one of eClockSource*/
+	std::atomic<uint64_t> m_uiTscMult; /** ns = (ticks * m_uiTscMult) >> TIME_FMT_TSC_SHIFT*/
+	std::atomic<uint64_t> m_uiTscTicksPerSec; /** TSC frequency; anchor is refreshed after these many ticks*/
+
+	CTimeFormatter();
+	CTimeFormatter(const CTimeFormatter&) = delete;
+	CTimeFormatter& operator=(const CTimeFormatter&) = delete;
+
+	bool calibrateTsc();
+	void getTscTime(struct timespec &a_stTs);
+
+public:
+	static CTimeFormatter& getInstance();
+
+	bool setClockSource(eClockSource a_enSource);
+
+	/** Returns clock source in use */
+	eClockSource getClockSource() const
+	{
+		return static_cast<eClockSource>(m_iClockSource.load(std::memory_order_relaxed));
+	}
+
+	void now(struct timespec &a_stTs);
+	uint64_t nowMicros();
+	size_t formatDateTime(time_t a_tSec, char *a_pcBuf);
+	void getTimeParams(char *a_pcTimeStamp, char *a_pcUsec);
+
+	/**
+	 * Converts time to micro seconds
+	 * @param a_stTs :[in] time to convert
+	 * @return time in micro seconds
+	 */
+	static uint64_t toMicros(const struct timespec &a_stTs)
+	{
+		return (uint64_t)a_stTs.tv_sec * 1000000ULL + (uint64_t)a_stTs.tv_nsec / 1000;
+	}
+
+	static size_t formatUint(uint64_t a_uiValue, char *a_pcBuf);
+	static const char* microsToStr(const struct timespec &a_stTs, char *a_pcBuf);
+	static std::string microsToString(const struct timespec &a_stTs);
+};
+
+#endif /* INCLUDE_TIMEFORMATTER_HPP_ */
@@ -0,0 +1,63 @@
+/********************************************************************************
+* Copyright (c) 2021 Intel Corporation.
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*********************************************************************************/
+
+/*** TimestampCarrier.hpp is used to carry latency timestamps of a message without
+ * re-building its JSON payload, either in a fixed-width slot patched in place or as
+ * MQTT v5 user properties */
+
+#ifndef INCLUDE_TIMESTAMPCARRIER_HPP_
+#define INCLUDE_TIMESTAMPCARRIER_HPP_
+
+#include <string>
+#include <stdint.h>
+#include "mqtt/async_client.h"
+
+/** Width of a timestamp slot; microseconds since epoch have 16 digits */
+#define TS_SLOT_WIDTH 16
+/** Value reserving a timestamp slot in a JSON payload */
+#define TS_SLOT_PLACEHOLDER "0000000000000000"
+/** Only user properties having this prefix are treated as timestamps */
+#define TS_PROPERTY_PREFIX "ts"
+
+/** How timestamps are carried with a message */
+enum eTsCarrierMode
+{
+	enTS_CARRIER_SLOT = 0, /** placeholder field in payload is overwritten in place*/
+	enTS_CARRIER_PROPERTY /** user property is added; needs MQTT v5 connection*/
+};
+
+/** Class having helper functions to add timestamps to a message and to read them back */
+class CTimestampCarrier
+{
+	CTimestampCarrier() = delete;
+
+public:
+	static eTsCarrierMode readMode();
+
+	static size_t findSlot(const std::string &a_sJson, const std::string &a_sKey);
+	static bool patchSlot(std::string &a_sJson, const std::string &a_sKey, uint64_t a_ui64Micros);
+
+	static void addProperty(mqtt::properties &a_props, const std::string &a_sKey, uint64_t a_ui64Micros);
+	static size_t appendProperties(std::string &a_sJson, const mqtt::const_message_ptr &a_pMsg);
+};
+
+#endif /* INCLUDE_TIMESTAMPCARRIER_HPP_ */
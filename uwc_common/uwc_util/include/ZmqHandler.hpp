@@ -131,6 +131,9 @@ namespace zmq_handler
         std::vector<std::string> getTopics();
 	/** function to publish json data on ZMQ*/
 	bool publishJson(std::string &a_sUsec, msg_envelope_t* msg, const std::string &a_sTopic, std::string a_sPubTimeField);
+	/** function to publish json data on ZMQ using contexts looked up by caller*/
+	bool publishJson(std::string &a_sUsec, msg_envelope_t* msg, stZmqContext &a_msgbusCtx, void *a_pPubCtx,
+			const std::string &a_sTopic, std::string a_sPubTimeField);
 
 	/**
 	 *  function to return all pub/sub topics